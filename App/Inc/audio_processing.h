@@ -41,6 +41,10 @@ typedef struct {
     float limiterActivity[4];     /* Limiter activity (gain reduction) in dB for each band */
     uint32_t clippingCount;       /* Number of samples that would have clipped without limiter */
     uint32_t processingTime;      /* Time in microseconds to process last block */
+    uint32_t crossfadePeakTime;   /* Longest block time during the last crossfade (both chains) */
+    uint32_t deadlineMisses;      /* Blocks that took longer than the DSP budget */
+    uint32_t qualityLevel;        /* DSP_QUALITY_* in effect (see dsp_watchdog.h) */
+    uint32_t qualityDrops;        /* Times the quality was lowered after overruns */
 } AudioProcessingStats_t;
 
 /* Exported constants --------------------------------------------------------*/
@@ -56,6 +60,9 @@ typedef struct {
 #define CHANNEL_RIGHT  1
 #define NUM_CHANNELS   2
 
+/* Default preset crossfade time in ms */
+#define AUDIO_CROSSFADE_DEFAULT_MS  50
+
 /* Maximum sample value for int16_t */
 #define MAX_SAMPLE_VALUE 32767
 #define MIN_SAMPLE_VALUE -32768
@@ -81,6 +88,24 @@ void AudioProcessing_Process(
     SystemSettings_t *pSettings
 );
 
+/**
+  * @brief  Switch to new settings by crossfading from the current ones
+  * @note   The new crossover state is built in the standby instance and both
+  *         run only while fading. The settings passed to
+  *         AudioProcessing_Process() are replaced when the fade completes.
+  *         A request made during a fade starts when that fade ends.
+  * @param  pTarget Settings to switch to (copied)
+  * @param  fadeMs  Crossfade time in milliseconds (0 = one audio block)
+  * @retval None
+  */
+void AudioProcessing_StartCrossfade(const SystemSettings_t *pTarget, uint16_t fadeMs);
+
+/**
+  * @brief  Check whether a preset crossfade is in progress
+  * @retval 1 if crossfading, 0 otherwise
+  */
+uint8_t AudioProcessing_IsCrossfading(void);
+
 /**
   * @brief  Get current audio processing statistics
   * @param  pStats Pointer to statistics structure to fill
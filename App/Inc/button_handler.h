@@ -55,6 +55,7 @@ typedef enum {
 
 /**
   * @brief  Button event type
+  * @note   Built by the main loop from INPUT_SOURCE_BUTTON input queue events
   */
 typedef struct {
   ButtonID_t    button;    // Which button triggered the event
@@ -66,16 +67,13 @@ typedef struct {
 #define BUTTON_DEBOUNCE_TIME          20    // Debounce time in milliseconds
 #define BUTTON_HOLD_TIME              1000  // Time in ms to consider a button as held
 #define BUTTON_DOUBLE_CLICK_TIME      300   // Max time between clicks for double click detection
-#define BUTTON_QUEUE_SIZE             8     // Size of the button event queue
 
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
 void ButtonHandler_Init(void);
 void ButtonHandler_Sample(void);
-uint8_t ButtonHandler_GetEvent(ButtonEvent_t* event);
 uint8_t ButtonHandler_IsPressed(ButtonID_t button);
 uint8_t ButtonHandler_IsHeld(ButtonID_t button);
-void ButtonHandler_ClearEvents(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,73 @@
+ /**
+  ******************************************************************************
+  * @file           : crc32.h
+  * @brief          : Header for crc32.c file.
+  *                   CRC32 (IEEE 802.3) service for stored presets and
+  *                   communication frames.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRC32_H
+#define __CRC32_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Starting value of a running CRC (see Crc32_Update) */
+#define CRC32_INIT_VALUE           0xFFFFFFFFUL
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the CRC service
+  * @note   Enables the CRC unit clock on target builds and builds the lookup
+  *         tables on host builds. Call before any other Crc32 function.
+  * @retval None
+  */
+void Crc32_Init(void);
+
+/**
+  * @brief  Compute the CRC32 of a block of data
+  * @note   Uses the CRC unit when the device has one, so it must only be
+  *         called from the main loop, never from an interrupt
+  * @param  data   Data
+  * @param  length Data length in bytes
+  * @retval CRC value
+  */
+uint32_t Crc32_Compute(const void* data, uint32_t length);
+
+/**
+  * @brief  Add a block of data to a running CRC
+  * @note   Start from CRC32_INIT_VALUE and invert the result when done; the
+  *         result then equals Crc32_Compute() over all blocks. Table driven,
+  *         safe to call from any context.
+  * @param  crc    Running CRC value
+  * @param  data   Data to add
+  * @param  length Data length in bytes
+  * @retval Updated running CRC value
+  */
+uint32_t Crc32_Update(uint32_t crc, const void* data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC32_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -78,6 +78,15 @@ typedef struct {
 #define DEFAULT_MID_GAIN      0.0f
 #define DEFAULT_HIGH_GAIN     0.0f
 
+/* Crossover points (each cutoff is shared by the bands on either side) */
+#define CROSSOVER_POINT_LOW      0  /* Sub-Low */
+#define CROSSOVER_POINT_MID      1  /* Low-Mid */
+#define CROSSOVER_POINT_HIGH     2  /* Mid-High */
+#define CROSSOVER_NUM_POINTS     3
+
+/* Filter bank instances (active + one for crossfading to the next preset) */
+#define CROSSOVER_NUM_INSTANCES  2
+
 /* Default filter settings */
 #define DEFAULT_FILTER_TYPE   FILTER_TYPE_LINKWITZ_RILEY
 #define DEFAULT_FILTER_ORDER  FILTER_ORDER_24DB
@@ -117,6 +126,15 @@ void Crossover_Process(
   */
 void Crossover_SetSettings(const struct CrossoverSettings_t *settings);
 
+/**
+  * @brief  Update cutoffs, gains and mutes without clearing filter history
+  * @note   Meant for small steps while audio is running (preset morphing).
+  *         A change of filter type or order resets the filters.
+  * @param  settings: Pointer to crossover settings
+  * @retval None
+  */
+void Crossover_UpdateCoefficients(struct CrossoverSettings_t *settings);
+
 /**
   * @brief  Get current crossover settings
   * @param  settings: Pointer to store the current settings
@@ -126,6 +144,8 @@ void Crossover_GetSettings(struct CrossoverSettings_t *settings);
 
 /**
   * @brief  Set the cutoff frequency for the specific crossover point
+  * @note   Recomputes only the two filter chains at this point and keeps the
+  *         filter history, so it is cheap enough to follow a turning knob
   * @param  point: Crossover point (0: low, 1: mid, 2: high)
   * @param  frequency: Cutoff frequency in Hz
   * @retval None
@@ -134,6 +154,7 @@ void Crossover_SetCutoff(uint8_t point, float frequency);
 
 /**
   * @brief  Set the gain for a specific frequency band
+  * @note   No filter coefficients are recomputed
   * @param  band: Band index (0: sub, 1: low, 2: mid, 3: high)
   * @param  gainDB: Gain value in dB
   * @retval None
@@ -142,6 +163,7 @@ void Crossover_SetGain(uint8_t band, float gainDB);
 
 /**
   * @brief  Set mute state for a specific frequency band
+  * @note   No filter coefficients are recomputed
   * @param  band: Band index (0: sub, 1: low, 2: mid, 3: high)
   * @param  mute: Mute state (1: muted, 0: active)
   * @retval None
@@ -162,12 +184,38 @@ void Crossover_SetFilterType(uint8_t type);
   */
 void Crossover_SetFilterOrder(uint8_t order);
 
+/**
+  * @brief  Limit the filter order of all instances (DSP load shedding)
+  * @note   The settings keep the requested order and Crossover_GetSettings()
+  *         still reports it; filters of a higher order run at the limit
+  *         until it is raised again. A change resets the filter history of
+  *         the instances it affects.
+  * @param  maxOrder: Highest order to run (FILTER_ORDER_48DB: no limit)
+  * @retval None
+  */
+void Crossover_SetOrderLimit(uint8_t maxOrder);
+
 /**
   * @brief  Reset all filter states (clear history)
   * @retval None
   */
 void Crossover_Reset(void);
 
+/**
+  * @brief  Select the filter bank instance used by all other crossover calls
+  * @note   Each instance has its own settings and filter history, so a new
+  *         preset can be prepared and run next to the active one
+  * @param  instance: Instance index (0 to CROSSOVER_NUM_INSTANCES-1)
+  * @retval None
+  */
+void Crossover_SelectInstance(uint8_t instance);
+
+/**
+  * @brief  Get the selected filter bank instance
+  * @retval Instance index
+  */
+uint8_t Crossover_GetInstance(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -63,7 +63,7 @@ typedef struct DelaySettings_t {
   * @brief  Delay instance structure
   */
 typedef struct {
-    int16_t buffer[DELAY_NUM_CHANNELS][DELAY_BUFFER_SIZE];  /* Delay buffers for each channel */
+    int16_t *buffer[DELAY_NUM_CHANNELS];                   /* Delay lines (arena memory) */
     uint16_t writeIndex;                                   /* Current write position */
     uint16_t readIndex[DELAY_NUM_CHANNELS];                /* Read positions for each channel */
     uint8_t phaseInvert[DELAY_NUM_CHANNELS];               /* Phase inversion flags */
@@ -0,0 +1,126 @@
+ /**
+  ******************************************************************************
+  * @file           : dsp_watchdog.h
+  * @brief          : Header for dsp_watchdog.c file.
+  *                   Audio block deadline monitor that steps the processing
+  *                   quality down on overruns and back up with headroom.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DSP_WATCHDOG_H
+#define __DSP_WATCHDOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Share of the block period the DSP chain may take (%); the rest is left for
+   the buffer copies and the control-rate updates of the same block */
+#ifndef DSP_WATCHDOG_BUDGET_PERCENT
+#define DSP_WATCHDOG_BUDGET_PERCENT    90
+#endif
+
+/* Overruns that step the quality down one level */
+#ifndef DSP_WATCHDOG_MISS_LIMIT
+#define DSP_WATCHDOG_MISS_LIMIT        3
+#endif
+
+/* Blocks without an overrun after which the count starts again (~1 s) */
+#define DSP_WATCHDOG_FORGIVE_BLOCKS    375
+
+/* The quality goes back up one level after this many blocks in a row below
+   DSP_WATCHDOG_RESTORE_PERCENT of the budget (~2 s). The wait doubles, up to
+   DSP_WATCHDOG_MAX_BACKOFF times, each time a restored level fails again
+   within the wait. */
+#define DSP_WATCHDOG_RESTORE_BLOCKS    750
+#define DSP_WATCHDOG_RESTORE_PERCENT   50
+#define DSP_WATCHDOG_MAX_BACKOFF       32
+
+/* Longest artificial load for overload tests (us) */
+#define DSP_WATCHDOG_MAX_TEST_LOAD_US  10000
+
+/* Quality levels */
+#define DSP_QUALITY_FULL               0   /* As set by the preset */
+#define DSP_QUALITY_REDUCED            1   /* Crossover at most 24 dB/oct */
+#define DSP_QUALITY_MINIMAL            2   /* Also no crossfade bank, band meters every 4th block */
+#define DSP_QUALITY_LOWEST             DSP_QUALITY_MINIMAL
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Deadline statistics (32-bit fields only)
+  */
+typedef struct {
+    uint32_t overruns;       /* Blocks over the budget */
+    uint32_t worstUs;        /* Longest block */
+    uint32_t stepDowns;      /* Times the quality was lowered */
+    uint32_t restores;       /* Times the quality was raised again */
+    uint32_t level;          /* DSP_QUALITY_* in effect */
+    uint32_t testLoadUs;     /* Artificial load per block */
+} DspWatchdogStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the monitor at full quality and clear the statistics
+  * @param  blockPeriodUs Audio block period in us
+  * @retval None
+  */
+void DspWatchdog_Init(uint32_t blockPeriodUs);
+
+/**
+  * @brief  Account for a processed block
+  * @param  blockUs Processing time of the block in us
+  * @retval DSP_QUALITY_* to use from the next block on
+  */
+uint8_t DspWatchdog_BlockDone(uint32_t blockUs);
+
+/**
+  * @brief  Get the quality level in effect
+  * @retval DSP_QUALITY_*
+  */
+uint8_t DspWatchdog_GetLevel(void);
+
+/**
+  * @brief  Set an artificial load added to every block (overload tests)
+  * @param  loadUs Busy time per block in us, 0 to stop
+  *         (limited to DSP_WATCHDOG_MAX_TEST_LOAD_US)
+  * @retval Load in effect
+  */
+uint32_t DspWatchdog_SetTestLoad(uint32_t loadUs);
+
+/**
+  * @brief  Spend the artificial load, if any
+  * @note   Call inside the timed part of the block
+  * @retval None
+  */
+void DspWatchdog_ApplyTestLoad(void);
+
+/**
+  * @brief  Get the deadline statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void DspWatchdog_GetStats(DspWatchdogStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_WATCHDOG_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,125 @@
+ /**
+  ******************************************************************************
+  * @file           : event_loop.h
+  * @brief          : Header for event_loop.c file.
+  *                   Event flags posted by interrupts, sleep until one is
+  *                   pending, and idle time accounting for the main loop.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EVENT_LOOP_H
+#define __EVENT_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Sleep with WFI while nothing is pending. Set to 0 for debug probes that
+   lose the core in sleep; the loop then spins, still counted as idle. */
+#ifndef EVENT_LOOP_USE_WFI
+#define EVENT_LOOP_USE_WFI         1
+#endif
+
+/* Idle accounting window in ms */
+#define EVENT_LOOP_WINDOW_MS       1000
+
+/* Events (the tasks they trigger are listed in main.c) */
+#define EVENT_AUDIO                0x01   /* I2S block received */
+#define EVENT_TICK                 0x02   /* 1 ms timer: host protocol, telemetry, storage */
+#define EVENT_INPUT                0x04   /* Encoder or button event queued */
+#define EVENT_UI                   0x08   /* UI refresh period */
+#define EVENT_CONTROL              0x10   /* Audio block processed: control-rate updates */
+#define EVENT_COUNT                5      /* Event flags in use (bits 0 to EVENT_COUNT-1) */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Main loop load statistics
+  */
+typedef struct {
+    uint32_t wakeups;          /* Times the core slept and woke up */
+    uint32_t idleCycles;       /* Cycles asleep in the last window */
+    uint32_t windowCycles;     /* Length of the last window in cycles */
+    uint16_t idlePermille;     /* Idle share of the last window (1000: no load) */
+    uint16_t minIdlePermille;  /* Lowest idle share of any window (least headroom) */
+} EventLoopStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Clear pending events and statistics, start the idle accounting
+  * @note   The DWT cycle counter must be running (main() starts it)
+  * @retval None
+  */
+void EventLoop_Init(void);
+
+/**
+  * @brief  Post events
+  * @note   Safe from interrupts and from the main loop
+  * @param  events EVENT_* flags
+  * @retval None
+  */
+void EventLoop_Post(uint32_t events);
+
+/**
+  * @brief  Get the time an event was posted
+  * @note   For a pending or just taken event: the cycle count of its first
+  *         post since it was last taken (later posts join it)
+  * @param  event One EVENT_* flag
+  * @retval DWT cycle count
+  */
+uint32_t EventLoop_PostTime(uint32_t event);
+
+/**
+  * @brief  Take pending events
+  * @note   Main loop only
+  * @param  mask EVENT_* flags to take
+  * @retval The flags of mask that were pending (now cleared)
+  */
+uint32_t EventLoop_Take(uint32_t mask);
+
+/**
+  * @brief  Check for pending events without taking them
+  * @param  mask EVENT_* flags
+  * @retval The flags of mask that are pending
+  */
+uint32_t EventLoop_Pending(uint32_t mask);
+
+/**
+  * @brief  Sleep until an event is posted
+  * @note   Returns at once if an event is pending. An interrupt that posts
+  *         between the check and the WFI still wakes the core: the check
+  *         and the WFI run with interrupts masked, and the interrupt is
+  *         taken after the wake-up.
+  * @retval None
+  */
+void EventLoop_Sleep(void);
+
+/**
+  * @brief  Get main loop load statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void EventLoop_GetStats(EventLoopStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENT_LOOP_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,90 @@
+ /**
+  ******************************************************************************
+  * @file           : fixed_format.h
+  * @brief          : Header for fixed_format.c file.
+  *                   Integer-only formatting of scaled values (dB x10, Hz,
+  *                   ms x100, ...) into fixed-width display fields.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FIXED_FORMAT_H
+#define __FIXED_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Most decimals a format may have */
+#define FIXED_FORMAT_MAX_DECIMALS  3
+
+/* Character filling a field that is too narrow for the value */
+#define FIXED_FORMAT_OVERFLOW      '*'
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  How a scaled integer is shown (keep these const, they live in flash)
+  */
+typedef struct {
+    const char* unit;        /* Appended after the number (NULL: none) */
+    const char* kiloUnit;    /* From 1000 units up: one decimal in thousands (NULL: never) */
+    uint8_t decimals;        /* The value is in units of 10^-decimals (0 to 3) */
+    uint8_t width;           /* Field width, right aligned (0: as long as needed) */
+} FixedFormat_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Format a scaled integer, e.g. -35 with one decimal and " dB" as "-3.5 dB"
+  * @note   No floating point and no printf. A value that does not fit the
+  *         field (or the buffer) fills it with FIXED_FORMAT_OVERFLOW rather
+  *         than showing wrong digits.
+  * @param  buffer Output string (always terminated)
+  * @param  size   Buffer size in bytes, terminator included
+  * @param  value  Value in units of 10^-decimals
+  * @param  format Format description
+  * @retval Length of the text written
+  */
+uint8_t FixedFormat_Print(char* buffer, uint8_t size, int32_t value, const FixedFormat_t* format);
+
+/**
+  * @brief  Format a plain integer ("%ld")
+  * @param  buffer Output string (always terminated)
+  * @param  size   Buffer size in bytes, terminator included
+  * @param  value  Value
+  * @retval Length of the text written
+  */
+uint8_t FixedFormat_Int(char* buffer, uint8_t size, int32_t value);
+
+/**
+  * @brief  Format a label followed by a number, e.g. "User preset 3"
+  * @note   The label is cut short if the number would not fit otherwise
+  * @param  buffer Output string (always terminated)
+  * @param  size   Buffer size in bytes, terminator included
+  * @param  label  Text before the number
+  * @param  number Number
+  * @retval Length of the text written
+  */
+uint8_t FixedFormat_Label(char* buffer, uint8_t size, const char* label, int32_t number);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FIXED_FORMAT_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
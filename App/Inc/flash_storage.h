@@ -0,0 +1,152 @@
+ /**
+  ******************************************************************************
+  * @file           : flash_storage.h
+  * @brief          : Header for flash_storage.c file.
+  *                   Block-device layer for internal flash and external
+  *                   SPI-NOR flash behind a single address space.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_STORAGE_H
+#define __FLASH_STORAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Keep presets on the external SPI-NOR flash (W25Qxx on SPI1) instead of
+   internal flash sectors. Set to 1 on boards fitted with the chip. */
+#ifndef FLASH_USE_EXTERNAL
+#define FLASH_USE_EXTERNAL         0
+#endif
+
+/* Host builds: define FLASH_STORAGE_FILE as a file name to back the external
+   device with a file instead of the SPI chip (requires FLASH_USE_EXTERNAL) */
+#if defined(FLASH_STORAGE_FILE) && !FLASH_USE_EXTERNAL
+#error "The file backend replaces the external device; set FLASH_USE_EXTERNAL to 1"
+#endif
+
+/* Address map. Internal flash keeps its bus address; the external device is
+   given a window of its own so callers address both the same way. */
+#define FLASH_INTERNAL_BASE        0x08000000
+#define FLASH_INTERNAL_SIZE        0x80000      /* 512KB */
+#define FLASH_EXTERNAL_BASE        0x90000000
+#define FLASH_EXTERNAL_MAX_SIZE    0x1000000    /* 16MB, 24-bit addressing */
+
+/* External device geometry (W25Qxx) */
+#define FLASH_EXTERNAL_PAGE_SIZE   256          /* Program operations stay within a page */
+#define FLASH_EXTERNAL_BLOCK_SIZE  0x10000      /* Erase unit (64KB block erase) */
+
+/* Read cache for the external device */
+#define FLASH_CACHE_LINES          4
+#define FLASH_CACHE_LINE_SIZE      128
+
+/* SPI-NOR chip select */
+#define FLASH_CS_Pin               GPIO_PIN_4
+#define FLASH_CS_GPIO_Port         GPIOA
+
+/* Flash status codes */
+#define FLASH_STATUS_OK            0
+#define FLASH_STATUS_ERROR         1
+#define FLASH_STATUS_INVALID       2   /* Address range not on a device */
+#define FLASH_STATUS_TIMEOUT       3
+#define FLASH_STATUS_NO_DEVICE     4   /* External device missing or not identified */
+#define FLASH_STATUS_BUSY          5   /* Erase still in progress */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Flash access statistics
+  */
+typedef struct {
+    uint32_t externalSize;     /* Detected external device size, 0 if none */
+    uint32_t reads;            /* Read requests */
+    uint32_t cacheHits;        /* External reads served from the cache */
+    uint32_t cacheMisses;      /* External cache line fills */
+    uint32_t pagePrograms;     /* Program operations issued to the devices */
+    uint32_t erases;           /* Erase operations issued to the devices */
+} FlashStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the flash devices (safe to call more than once)
+  * @note   The external device is identified by its JEDEC ID; if it does not
+  *         answer, accesses to its window fail with FLASH_STATUS_NO_DEVICE
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_Init(void);
+
+/**
+  * @brief  Read from flash
+  * @param  address Start address (internal or external window)
+  * @param  data    Buffer to fill
+  * @param  length  Number of bytes
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_Read(uint32_t address, uint8_t* data, uint32_t length);
+
+/**
+  * @brief  Program flash (bits can only be cleared; erase first)
+  * @note   Split into program operations that never cross a device page
+  * @param  address Start address
+  * @param  data    Data to program
+  * @param  length  Number of bytes
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_Write(uint32_t address, const uint8_t* data, uint32_t length);
+
+/**
+  * @brief  Erase the erase unit containing an address
+  * @note   Internal flash: the whole sector (16KB to 128KB).
+  *         External flash: one FLASH_EXTERNAL_BLOCK_SIZE block.
+  * @param  address Any address inside the unit
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_EraseSector(uint32_t address);
+
+/**
+  * @brief  Start erasing the erase unit containing an address
+  * @note   Returns once the erase is issued; poll with Flash_PollErase().
+  *         One erase runs at a time: starting another, or reading or writing
+  *         the device being erased, first waits for the running one.
+  * @param  address Any address inside the unit
+  * @retval FLASH_STATUS_OK if started, or error code
+  */
+uint8_t Flash_BeginErase(uint32_t address);
+
+/**
+  * @brief  Check on the erase started by Flash_BeginErase()
+  * @retval FLASH_STATUS_BUSY while it runs, then its result (FLASH_STATUS_OK
+  *         or error code)
+  */
+uint8_t Flash_PollErase(void);
+
+/**
+  * @brief  Get flash access statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void Flash_GetStats(FlashStats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASH_STORAGE_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
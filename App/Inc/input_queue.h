@@ -0,0 +1,120 @@
+ /**
+  ******************************************************************************
+  * @file           : input_queue.h
+  * @brief          : Header for input_queue.c file.
+  *                   Single queue of timestamped encoder and button events
+  *                   from the sampling interrupt to the main loop.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __INPUT_QUEUE_H
+#define __INPUT_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Number of queued events (power of two) */
+#define INPUT_QUEUE_SIZE           32
+
+/* Event sources */
+#define INPUT_SOURCE_ENCODER       0    /* value: signed steps (clockwise positive) */
+#define INPUT_SOURCE_BUTTON        1    /* code: ButtonID_t, state: ButtonState_t,
+                                           value: hold time in ms */
+#define INPUT_SOURCE_COUNT         2
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Input event
+  */
+typedef struct {
+    uint32_t time;           /* HAL_GetTick() when the event was queued */
+    int32_t value;           /* Source specific, see INPUT_SOURCE_* */
+    uint8_t source;          /* INPUT_SOURCE_* */
+    uint8_t code;            /* Source specific (button ID) */
+    uint8_t state;           /* Source specific (button state) */
+} InputEvent_t;
+
+/**
+  * @brief  Input queue statistics
+  */
+typedef struct {
+    uint32_t queued[INPUT_SOURCE_COUNT];    /* Events queued per source */
+    uint32_t dropped[INPUT_SOURCE_COUNT];   /* Events refused because the queue was full */
+    uint8_t maxDepth;                       /* Most events waiting at once */
+} InputQueueStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the queue (empty) and clear the statistics
+  * @note   Call before the sampling interrupt is started
+  * @retval None
+  */
+void InputQueue_Init(void);
+
+/**
+  * @brief  Queue an event
+  * @note   Producer side: only the input sampling interrupt (TIM3) may call
+  *         this, or code that masks interrupts around the call (see
+  *         UiProbe_Inject). Never blocks; a full queue refuses the event
+  *         and counts it.
+  * @param  source INPUT_SOURCE_*
+  * @param  code Source specific code
+  * @param  state Source specific state
+  * @param  value Source specific value
+  * @retval 1 if queued, 0 if the queue was full
+  */
+uint8_t InputQueue_Push(uint8_t source, uint8_t code, uint8_t state, int32_t value);
+
+/**
+  * @brief  Take the oldest event
+  * @note   Consumer side: main loop only
+  * @param  event Pointer to event structure to fill
+  * @retval 1 if an event was taken, 0 if the queue is empty
+  */
+uint8_t InputQueue_Pop(InputEvent_t *event);
+
+/**
+  * @brief  Check whether events are waiting
+  * @note   Either side; the answer may be stale by the time it is used
+  * @retval 1 if the queue is empty
+  */
+uint8_t InputQueue_IsEmpty(void);
+
+/**
+  * @brief  Discard all waiting events
+  * @note   Consumer side: main loop only
+  * @retval None
+  */
+void InputQueue_Flush(void);
+
+/**
+  * @brief  Get queue statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void InputQueue_GetStats(InputQueueStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INPUT_QUEUE_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -58,6 +58,17 @@ typedef struct {
   uint16_t D7_Pin;           // Data 7 GPIO pin (direct mode)
 } LCD_ConfigTypeDef;
 
+/* Frame buffer flush statistics */
+typedef struct {
+  uint32_t Flushes;          // Flushes that sent anything
+  uint32_t CellsWritten;     // Characters sent (changed cells and bridged gaps)
+  uint32_t AddressCommands;  // Cursor moves between runs of changed cells
+  uint32_t BusWrites;        // Bytes written to the PCF8574 (counted by the mock too)
+  uint32_t LastFlushWrites;  // Bus bytes queued by the last flush that sent anything
+  uint32_t Transfers;        // I2C interrupt transfers started
+  uint32_t BusErrors;        // Failed transfers (each forces a reset and redraw)
+} LCD_StatsTypeDef;
+
 /* Exported constants --------------------------------------------------------*/
 /* PCF8574 pin mappings for I2C LCD modules */
 #define LCD_PIN_RS    (1 << 0)
@@ -111,6 +122,34 @@ typedef struct {
 /* Custom character definition */
 #define LCD_MAX_CUSTOM_CHARS    8
 
+/* Characters on the screen (16x2), see LCD_GetScreen */
+#define LCD_SCREEN_SIZE         32
+
+/* Host builds: define LCD_MOCK_BACKEND to hand the transfers to the host
+   program instead of the I2C peripheral. The bytes are counted as on the
+   board (see LCD_GetStats); the host plays the bus and its interrupt. */
+#ifdef LCD_MOCK_BACKEND
+/**
+  * @brief  Start a transfer on the host bus
+  * @note   Provided by the host program, called with interrupts masked. The
+  *         host calls LCD_TransferComplete() once the bytes are sent, never
+  *         from inside this call; the data stays valid until then.
+  * @param  data PCF8574 bytes
+  * @param  length Number of bytes
+  * @retval None
+  */
+void LCD_MockTransmit(const uint8_t* data, uint16_t length);
+
+/**
+  * @brief  Let the host bus make progress while the transport queue is full
+  * @note   Provided by the host program. Where the board waits for the
+  *         transfer interrupt or the end of a pause, the host must complete
+  *         the transfer in flight or let the pause pass.
+  * @retval None
+  */
+void LCD_MockWait(void);
+#endif
+
 /* Exported functions prototypes ---------------------------------------------*/
 /**
   * @brief  Initialize the LCD
@@ -121,6 +160,8 @@ void LCD_Init(void);
 
 /**
   * @brief  Send command to LCD
+  * @note   Queued and sent by I2C interrupts; returns at once unless the
+  *         queue is full
   * @param  cmd Command to send
   * @retval None
   */
@@ -128,6 +169,7 @@ void LCD_SendCommand(uint8_t cmd);
 
 /**
   * @brief  Send data to LCD
+  * @note   Queued like LCD_SendCommand()
   * @param  data Data to send
   * @retval None
   */
@@ -205,6 +247,8 @@ void LCD_BacklightOff(void);
 
 /**
   * @brief  Set the cursor position
+  * @note   Clear, cursor and print functions only update the frame buffer;
+  *         nothing reaches the display until LCD_Flush() is called
   * @param  col Column position (0-15)
   * @param  row Row position (0-1)
   * @retval None
@@ -213,11 +257,19 @@ void LCD_SetCursor(uint8_t col, uint8_t row);
 
 /**
   * @brief  Print a string on the LCD
+  * @note   Characters past the last column are dropped
   * @param  str String to print
   * @retval None
   */
 void LCD_Print(const char* str);
 
+/**
+  * @brief  Print a single character on the LCD
+  * @param  c Character to print
+  * @retval None
+  */
+void LCD_PrintChar(char c);
+
 /**
   * @brief  Print a number on the LCD
   * @param  num Number to print
@@ -227,12 +279,22 @@ void LCD_PrintNumber(int32_t num);
 
 /**
   * @brief  Print a floating point number on the LCD
+  * @note   Formatted without printf; prefer LCD_PrintFixed() for values
+  *         that are already scaled integers
   * @param  num Number to print
-  * @param  precision Number of decimal places
+  * @param  precision Number of decimal places (0 to 3)
   * @retval None
   */
 void LCD_PrintFloat(float num, uint8_t precision);
 
+/**
+  * @brief  Print a scaled integer on the LCD (e.g. dB x10 with one decimal)
+  * @param  value Value in units of 10^-decimals
+  * @param  decimals Number of decimal places (0 to 3)
+  * @retval None
+  */
+void LCD_PrintFixed(int32_t value, uint8_t decimals);
+
 /**
   * @brief  Create a custom character in CGRAM
   * @param  location Character location (0-7)
@@ -248,6 +310,74 @@ void LCD_CreateCustomChar(uint8_t location, const uint8_t charmap[]);
   */
 void LCD_PrintCustomChar(uint8_t location);
 
+/**
+  * @brief  Send the changed parts of the frame buffer to the display
+  * @note   Only cells that differ from what the display shows are written,
+  *         with a cursor move only where a run of changed cells starts away
+  *         from the current display address. The writes are queued and
+  *         sent in the background; cells that do not fit in the queue stay
+  *         dirty for the next flush. Call from the main loop.
+  * @param  None
+  * @retval Number of characters queued
+  */
+uint8_t LCD_Flush(void);
+
+/**
+  * @brief  Redraw the whole screen on the next flush
+  * @note   Use after talking to the controller through LCD_SendCommand() or
+  *         LCD_SendData(), which bypass the frame buffer
+  * @param  None
+  * @retval None
+  */
+void LCD_Invalidate(void);
+
+/**
+  * @brief  I2C transfer complete handler
+  * @note   Call from HAL_I2C_MasterTxCpltCallback for the LCD bus
+  * @param  None
+  * @retval None
+  */
+void LCD_TransferComplete(void);
+
+/**
+  * @brief  I2C transfer error handler
+  * @note   Call from HAL_I2C_ErrorCallback for the LCD bus
+  * @param  None
+  * @retval None
+  */
+void LCD_TransferError(void);
+
+/**
+  * @brief  Resume the transport once a pause after a slow command has elapsed
+  * @note   Call from a periodic timer interrupt
+  * @param  None
+  * @retval None
+  */
+void LCD_TimerTick(void);
+
+/**
+  * @brief  Get frame buffer flush statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void LCD_GetStats(LCD_StatsTypeDef* stats);
+
+/**
+  * @brief  Copy the characters sent to the display
+  * @note   Custom characters appear as their location (0-7)
+  * @param  text Buffer of LCD_SCREEN_SIZE bytes (row 0, then row 1)
+  * @retval None
+  */
+void LCD_GetScreen(uint8_t* text);
+
+/**
+  * @brief  Check whether the display has caught up with the frame buffer
+  * @param  None
+  * @retval 1 if no cell is dirty, no write is queued or being sent, and no
+  *         failed transfer is waiting for the next flush to redraw
+  */
+uint8_t LCD_IsIdle(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,79 @@
+ /**
+  ******************************************************************************
+  * @file           : level_meter.h
+  * @brief          : Header for level_meter.c file.
+  *                   Bar-graph meters for the band levels and the gain
+  *                   reduction, drawn with custom LCD characters.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LEVEL_METER_H
+#define __LEVEL_METER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Meter update period in ms (25 Hz) */
+#define LEVEL_METER_PERIOD_MS      40
+
+/* Meter pages */
+#define LEVEL_METER_PAGE_LEVELS    0   /* Peak level per band, -60 to 0 dBFS */
+#define LEVEL_METER_PAGE_REDUCTION 1   /* Compressor + limiter gain reduction per band, 0 to 24 dB */
+#define LEVEL_METER_NUM_PAGES      2
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Show a meter page
+  * @note   Loads the bar characters into the LCD character RAM, shows the
+  *         page title for a moment, then the meters. Also used to redraw
+  *         the page after something else was drawn over it.
+  * @param  page LEVEL_METER_PAGE_*
+  * @retval None
+  */
+void LevelMeter_Start(uint8_t page);
+
+/**
+  * @brief  Show the next (direction > 0) or previous meter page
+  * @param  direction Step direction
+  * @retval None
+  */
+void LevelMeter_ChangePage(int8_t direction);
+
+/**
+  * @brief  Get the page shown
+  * @retval LEVEL_METER_PAGE_*
+  */
+uint8_t LevelMeter_GetPage(void);
+
+/**
+  * @brief  Update the meters (call from the UI task while they are shown)
+  * @note   Does the work at most once per LEVEL_METER_PERIOD_MS. Only bars
+  *         whose length changed are written to the frame buffer.
+  * @retval None
+  */
+void LevelMeter_Task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LEVEL_METER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
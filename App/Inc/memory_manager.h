@@ -1 +1,144 @@
- 
+ /**
+  ******************************************************************************
+  * @file           : memory_manager.h
+  * @brief          : Header for memory_manager.c file.
+  *                   This file contains the declarations for the static arena
+  *                   allocator that provides state and scratch memory to the
+  *                   DSP modules of the Audio Crossover system.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MEMORY_MANAGER_H
+#define __MEMORY_MANAGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Total size of the static arena in bytes (can be overridden by the build) */
+#ifndef MEM_ARENA_SIZE
+#define MEM_ARENA_SIZE             (56 * 1024)
+#endif
+
+/* Alignment used for DSP buffers (one cache line / two DMA bursts) */
+#define MEM_DSP_ALIGNMENT          32
+
+/* Default alignment for plain state structures */
+#define MEM_DEFAULT_ALIGNMENT      4
+
+/* Maximum number of allocations tracked for the usage report */
+#define MEM_MAX_ALLOCATIONS        32
+
+/* Maximum length of an owner name (without terminator) */
+#define MEM_OWNER_NAME_LENGTH      15
+
+/* Memory manager status codes */
+#define MEM_STATUS_OK              0
+#define MEM_STATUS_NO_SPACE        1
+#define MEM_STATUS_TABLE_FULL      2
+#define MEM_STATUS_LOCKED          3
+#define MEM_STATUS_INVALID         4
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Record of a single arena allocation
+  */
+typedef struct {
+    char owner[MEM_OWNER_NAME_LENGTH + 1];  /* Module/buffer that owns the block */
+    uint32_t offset;                        /* Offset of the block inside the arena */
+    uint32_t size;                          /* Requested size in bytes */
+    uint32_t padding;                       /* Bytes lost to alignment before the block */
+} MemoryAllocation_t;
+
+/**
+  * @brief  Arena usage summary
+  */
+typedef struct {
+    uint32_t arenaSize;        /* Total arena size in bytes */
+    uint32_t usedBytes;        /* Bytes handed out including alignment padding */
+    uint32_t freeBytes;        /* Bytes still available */
+    uint32_t paddingBytes;     /* Bytes lost to alignment */
+    uint8_t allocationCount;   /* Number of live allocations */
+    uint8_t failedCount;       /* Number of allocation requests that failed */
+    uint8_t locked;            /* 1 if the arena no longer accepts allocations */
+    uint8_t lastStatus;        /* Status of the most recent allocation request */
+} MemoryUsage_t;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the memory manager and clear the arena
+  * @note   Must be called before any DSP module is initialized
+  * @retval None
+  */
+void MemoryManager_Init(void);
+
+/**
+  * @brief  Allocate a zeroed block from the static arena
+  * @param  owner     Name of the owning module/buffer (shown in the usage report)
+  * @param  size      Size of the block in bytes
+  * @param  alignment Required alignment in bytes (power of two)
+  * @retval Pointer to the block, or NULL if the request cannot be satisfied
+  */
+void* MemoryManager_Alloc(const char* owner, uint32_t size, uint32_t alignment);
+
+/**
+  * @brief  Allocate a zeroed DSP buffer aligned to MEM_DSP_ALIGNMENT
+  * @param  owner Name of the owning module/buffer
+  * @param  size  Size of the buffer in bytes
+  * @retval Pointer to the buffer, or NULL if the request cannot be satisfied
+  */
+void* MemoryManager_AllocDSP(const char* owner, uint32_t size);
+
+/**
+  * @brief  Lock the arena so that no further allocations are accepted
+  * @note   Called once all modules are initialized; allocations after boot
+  *         would make the memory layout depend on user interaction
+  * @retval None
+  */
+void MemoryManager_Lock(void);
+
+/**
+  * @brief  Get the arena usage summary
+  * @param  usage Pointer to structure to fill
+  * @retval None
+  */
+void MemoryManager_GetUsage(MemoryUsage_t* usage);
+
+/**
+  * @brief  Get the record of a single allocation
+  * @param  index    Allocation index (0 to allocationCount-1)
+  * @param  record   Pointer to structure to fill
+  * @retval MEM_STATUS_OK if the record exists, MEM_STATUS_INVALID otherwise
+  */
+uint8_t MemoryManager_GetAllocation(uint8_t index, MemoryAllocation_t* record);
+
+/**
+  * @brief  Print the arena usage report (owner, offset, size) to the debug output
+  * @retval None
+  */
+void MemoryManager_PrintReport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEMORY_MANAGER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
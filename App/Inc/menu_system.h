@@ -121,8 +121,6 @@ typedef struct {
 #define PRESET_DANGDUT               3
 #define PRESET_POP                   4
 #define NUM_FACTORY_PRESETS          5
-#define MAX_USER_PRESETS             5
-#define MAX_PRESETS                  (NUM_FACTORY_PRESETS + MAX_USER_PRESETS)
 
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
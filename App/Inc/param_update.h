@@ -0,0 +1,115 @@
+ /**
+  ******************************************************************************
+  * @file           : param_update.h
+  * @brief          : Header for param_update.c file.
+  *                   Coalesces live parameter edits and applies them to the
+  *                   DSP modules at most once per control period.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PARAM_UPDATE_H
+#define __PARAM_UPDATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Shortest time between two control updates in ms */
+#define PARAM_UPDATE_PERIOD_MS     20
+
+/* Dirty flags: one per piece of work a control update can do on its own */
+#define PARAM_DIRTY_CUTOFF_LOW     0x0001  /* Sub-Low crossover point */
+#define PARAM_DIRTY_CUTOFF_MID     0x0002  /* Low-Mid crossover point */
+#define PARAM_DIRTY_CUTOFF_HIGH    0x0004  /* Mid-High crossover point */
+#define PARAM_DIRTY_BAND_LEVELS    0x0008  /* Crossover band gains and mutes */
+#define PARAM_DIRTY_FILTER         0x0010  /* Filter type or order (all chains) */
+#define PARAM_DIRTY_COMPRESSOR     0x0020
+#define PARAM_DIRTY_LIMITER        0x0040
+#define PARAM_DIRTY_DELAY          0x0080  /* Delays and phase inversion */
+
+#define PARAM_DIRTY_CUTOFFS        (PARAM_DIRTY_CUTOFF_LOW | PARAM_DIRTY_CUTOFF_MID | \
+                                    PARAM_DIRTY_CUTOFF_HIGH)
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Update statistics (cycle counts from the DWT cycle counter)
+  */
+typedef struct {
+    uint32_t changes;        /* Edits marked (each one used to be applied at once) */
+    uint32_t updates;        /* Control updates that applied edits */
+    uint32_t totalCycles;    /* Cycles spent in all control updates */
+    uint32_t worstCycles;    /* Longest control update */
+} ParamUpdateStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the update pipeline
+  * @param  pSettings Settings used by the processing chain; edits are written
+  *                   here and the modules pick them up from here
+  * @retval None
+  */
+void ParamUpdate_Init(SystemSettings_t *pSettings);
+
+/**
+  * @brief  Get the settings that edits are written to
+  * @retval Pointer to the live settings
+  */
+SystemSettings_t *ParamUpdate_GetSettings(void);
+
+/**
+  * @brief  Mark settings as changed
+  * @note   Call after writing the new values. Nothing is recomputed here;
+  *         repeated edits of the same parameter before the next control
+  *         update cost one recomputation with the latest value.
+  * @param  dirty PARAM_DIRTY_* flags
+  * @retval None
+  */
+void ParamUpdate_Mark(uint16_t dirty);
+
+/**
+  * @brief  Apply marked changes (call once per processed audio block)
+  * @note   Runs at most once per PARAM_UPDATE_PERIOD_MS and only for the
+  *         modules that changed. Held while a preset morph or crossfade owns
+  *         the settings.
+  * @param  frames Number of frames in the block just processed
+  * @retval None
+  */
+void ParamUpdate_Tick(uint16_t frames);
+
+/**
+  * @brief  Apply marked changes now, regardless of the control period
+  * @note   For readers of the module state, e.g. before saving a preset
+  * @retval None
+  */
+void ParamUpdate_Flush(void);
+
+/**
+  * @brief  Get the update statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void ParamUpdate_GetStats(ParamUpdateStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PARAM_UPDATE_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
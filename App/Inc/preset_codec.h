@@ -0,0 +1,107 @@
+ /**
+  ******************************************************************************
+  * @file           : preset_codec.h
+  * @brief          : Header for preset_codec.c file.
+  *                   Compact, versioned binary encoding of presets for flash
+  *                   storage.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PRESET_CODEC_H
+#define __PRESET_CODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "preset_manager.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Format identification ("PC" little-endian) and current version */
+#define PRESET_CODEC_MAGIC         0x4350
+#define PRESET_FORMAT_VERSION      1
+
+/* Largest encoded preset in bytes (all groups, full-length name) */
+#define PRESET_CODEC_MAX_SIZE      128
+
+/* Leading bytes that hold the header, name and timestamp */
+#define PRESET_CODEC_PREFIX_SIZE   32
+
+/* Codec status codes */
+#define PRESET_CODEC_OK            0
+#define PRESET_CODEC_INVALID       1   /* Not an encoded preset or malformed */
+#define PRESET_CODEC_CRC           2   /* CRC mismatch */
+#define PRESET_CODEC_VERSION       3   /* Written by a newer format version */
+#define PRESET_CODEC_NO_SPACE      4   /* Output buffer too small */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Encode a preset
+  * @param  settings  Settings to encode
+  * @param  metadata  Name and timestamp to store; checksum receives the record
+  *                   CRC (presetId is not stored, the journal key carries it)
+  * @param  buffer    Output buffer
+  * @param  size      Output buffer size (PRESET_CODEC_MAX_SIZE is always enough)
+  * @param  length    Receives the encoded length
+  * @retval PRESET_CODEC_OK or error code
+  */
+uint8_t PresetCodec_Encode(const PresetSettings_t* settings, PresetMetadata_t* metadata,
+                           uint8_t* buffer, uint16_t size, uint16_t* length);
+
+/**
+  * @brief  Decode a preset
+  * @note   Fields missing from the record (older versions) keep the values
+  *         already in settings, so pass in defaults. Unknown fields and
+  *         groups (newer minor additions) are skipped.
+  * @param  buffer    Encoded preset
+  * @param  length    Encoded length
+  * @param  settings  Settings to update (may be NULL)
+  * @param  metadata  Receives name, timestamp and CRC as checksum (may be NULL)
+  * @retval PRESET_CODEC_OK or error code
+  */
+uint8_t PresetCodec_Decode(const uint8_t* buffer, uint16_t length,
+                           PresetSettings_t* settings, PresetMetadata_t* metadata);
+
+/**
+  * @brief  Decode the name and timestamp from the start of a record
+  * @note   The CRC is not checked, so use only on records verified by other
+  *         means (the journal checks every record when it is mounted).
+  *         metadata->checksum is not touched.
+  * @param  buffer   First bytes of the record (PRESET_CODEC_PREFIX_SIZE is enough)
+  * @param  length   Number of bytes in buffer
+  * @param  metadata Receives name and timestamp
+  * @param  version  Receives the record format version (may be NULL)
+  * @retval PRESET_CODEC_OK or error code
+  */
+uint8_t PresetCodec_DecodePrefix(const uint8_t* buffer, uint16_t length,
+                                 PresetMetadata_t* metadata, uint8_t* version);
+
+/**
+  * @brief  Check whether a buffer starts with an encoded preset header
+  * @param  buffer Data to check
+  * @param  length Data length
+  * @retval 1 if the header is present, 0 otherwise (e.g. legacy raw layout)
+  */
+uint8_t PresetCodec_IsEncoded(const uint8_t* buffer, uint16_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PRESET_CODEC_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
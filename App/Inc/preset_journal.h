@@ -0,0 +1,217 @@
+ /**
+  ******************************************************************************
+  * @file           : preset_journal.h
+  * @brief          : Header for preset_journal.c file.
+  *                   Append-only, wear-leveled record store for presets on two
+  *                   internal flash sectors.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PRESET_JOURNAL_H
+#define __PRESET_JOURNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "flash_storage.h"
+
+/* Exported constants --------------------------------------------------------*/
+#if FLASH_USE_EXTERNAL
+/* Storage location. The first two 64KB blocks of the external flash; each
+   holds the live set of all keys (about 140 bytes per preset). */
+#define JOURNAL_BASE_ADDR          FLASH_EXTERNAL_BASE
+#define JOURNAL_SECTOR_SIZE        FLASH_EXTERNAL_BLOCK_SIZE
+#define JOURNAL_NUM_SECTORS        2
+
+/* Number of distinct record keys (preset IDs) tracked by the index */
+#define JOURNAL_MAX_KEYS           208
+#else
+/* Storage location. Sector 3 (16KB) and the first 16KB of sector 4 (64KB);
+   the linker script must keep both out of the code region. */
+#define JOURNAL_BASE_ADDR          0x0800C000
+#define JOURNAL_SECTOR_SIZE        0x4000
+#define JOURNAL_NUM_SECTORS        2
+
+/* Number of distinct record keys (preset IDs) tracked by the index */
+#define JOURNAL_MAX_KEYS           16
+#endif
+
+/* Largest payload accepted for a single record */
+#define JOURNAL_MAX_PAYLOAD        1024
+
+/* Journal status codes */
+#define JOURNAL_STATUS_OK          0
+#define JOURNAL_STATUS_NOT_FOUND   1
+#define JOURNAL_STATUS_INVALID     2
+#define JOURNAL_STATUS_FULL        3
+#define JOURNAL_STATUS_CORRUPT     4
+#define JOURNAL_STATUS_ERROR       5
+#define JOURNAL_STATUS_BUSY        6
+#define JOURNAL_STATUS_UNFORMATTED 7   /* No journal on the storage; nothing was erased */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Journal statistics
+  */
+typedef struct {
+    uint8_t activeSector;                      /* Sector currently appended to */
+    uint32_t generation;                       /* Generation of the active sector */
+    uint32_t usedBytes;                        /* Bytes used in the active sector */
+    uint32_t freeBytes;                        /* Bytes left before compaction */
+    uint8_t liveRecords;                       /* Keys with a live (not deleted) record */
+    uint32_t compactions;                      /* Compactions since boot */
+    uint32_t eraseCount[JOURNAL_NUM_SECTORS];  /* Lifetime erase count per sector */
+    uint8_t recovered;                         /* 1 if an interrupted write was found at boot */
+} JournalStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Mount the journal: select the active sector and rebuild the index
+  * @note   Interrupted writes and compactions are detected and discarded,
+  *         so the store is always mounted at the last completed operation.
+  *         Storage without a journal is left as it is: it may still hold
+  *         presets of an older layout. Start a journal on it with
+  *         PresetJournal_BeginFormat().
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_UNFORMATTED or error code
+  */
+uint8_t PresetJournal_Init(void);
+
+/**
+  * @brief  Start a new, empty journal on unformatted storage (blocking)
+  * @note   The journal is started in a sector clear of the range to keep.
+  *         Records written before PresetJournal_EndFormat() go into it, but
+  *         it only becomes valid there, so a format cut short by a power
+  *         loss leaves the storage unformatted and the kept range intact.
+  * @param  keepAddress Start of a range that must not be erased yet
+  * @param  keepLength  Length of the range in bytes, 0 for none
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_BeginFormat(uint32_t keepAddress, uint32_t keepLength);
+
+/**
+  * @brief  Activate the journal started by PresetJournal_BeginFormat() (blocking)
+  * @note   Erases the other sector, with the kept range if it was there
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_EndFormat(void);
+
+/**
+  * @brief  Append a new version of a record (blocking)
+  * @param  key    Record key (0 to JOURNAL_MAX_KEYS-1)
+  * @param  data   Payload to store
+  * @param  length Payload length in bytes (at most JOURNAL_MAX_PAYLOAD)
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_Write(uint8_t key, const void* data, uint16_t length);
+
+/**
+  * @brief  Start appending a new version of a record without blocking
+  * @note   The job is advanced by PresetJournal_Step(); the payload buffer
+  *         must stay valid and unchanged until the job completes
+  * @param  key    Record key (0 to JOURNAL_MAX_KEYS-1)
+  * @param  data   Payload to store
+  * @param  length Payload length in bytes (at most JOURNAL_MAX_PAYLOAD)
+  * @retval JOURNAL_STATUS_OK if the job was started, JOURNAL_STATUS_BUSY if
+  *         another job is in progress, or error code
+  */
+uint8_t PresetJournal_BeginWrite(uint8_t key, const void* data, uint16_t length);
+
+/**
+  * @brief  Advance the current write job by one bounded step
+  * @note   Each step programs at most a few words, or starts or checks on a
+  *         sector erase, so it can be called from the main loop between audio
+  *         blocks
+  * @retval JOURNAL_STATUS_BUSY while the job runs, JOURNAL_STATUS_OK when it
+  *         has completed (or no job is active), or error code
+  */
+uint8_t PresetJournal_Step(void);
+
+/**
+  * @brief  Check whether a write job is in progress
+  * @retval 1 if busy, 0 otherwise
+  */
+uint8_t PresetJournal_IsBusy(void);
+
+/**
+  * @brief  Read the latest version of a record
+  * @param  key    Record key
+  * @param  data   Buffer to fill
+  * @param  length Number of bytes to read from the start of the payload
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_NOT_FOUND or error code
+  */
+uint8_t PresetJournal_Read(uint8_t key, void* data, uint16_t length);
+
+/**
+  * @brief  Read part of the latest version of a record without re-verifying it
+  * @note   Records are verified when the journal is mounted; use this for
+  *         small lookups (names, trailers) where reading and checking the
+  *         whole payload would dominate
+  * @param  key    Record key
+  * @param  offset Offset into the payload
+  * @param  data   Buffer to fill
+  * @param  length Number of bytes to read
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_NOT_FOUND or error code
+  */
+uint8_t PresetJournal_ReadRange(uint8_t key, uint16_t offset, void* data, uint16_t length);
+
+/**
+  * @brief  Get the payload length of the latest version of a record
+  * @param  key    Record key
+  * @param  length Receives the payload length in bytes
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_NOT_FOUND or error code
+  */
+uint8_t PresetJournal_GetLength(uint8_t key, uint16_t* length);
+
+/**
+  * @brief  Delete a record by appending a tombstone (blocking)
+  * @param  key Record key
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_Delete(uint8_t key);
+
+/**
+  * @brief  Start appending a tombstone without blocking
+  * @note   The job is advanced by PresetJournal_Step(); no job is started if
+  *         the key holds no live record
+  * @param  key Record key
+  * @retval JOURNAL_STATUS_OK if started (or nothing to delete),
+  *         JOURNAL_STATUS_BUSY if another job is in progress, or error code
+  */
+uint8_t PresetJournal_BeginDelete(uint8_t key);
+
+/**
+  * @brief  Check whether a live record exists for a key
+  * @param  key Record key
+  * @retval 1 if the record exists, 0 otherwise
+  */
+uint8_t PresetJournal_Exists(uint8_t key);
+
+/**
+  * @brief  Get journal statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void PresetJournal_GetStats(JournalStats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PRESET_JOURNAL_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
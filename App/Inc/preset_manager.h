@@ -65,9 +65,21 @@ typedef struct {
     PresetSettings_t settings;
 } Preset_t;
 
+/**
+  * @brief  Completion callback for background saves, deletes and renames
+  * @param  presetId ID of the preset that was saved
+  * @param  status   PRESET_STATUS_OK or error code
+  */
+typedef void (*PresetSaveCallback_t)(uint8_t presetId, uint8_t status);
+
 /* Exported constants --------------------------------------------------------*/
-/* Maximum number of user presets that can be stored */
+/* Maximum number of user presets that can be stored (IDs stay below
+   PRESET_ID_CURRENT, so the external flash is limited to 200) */
+#if FLASH_USE_EXTERNAL
+#define MAX_USER_PRESETS              200
+#else
 #define MAX_USER_PRESETS              10
+#endif
 /* Starting preset ID for user presets (after factory presets) */
 #define USER_PRESET_START_ID          5
 /* Total number of presets (factory + user) */
@@ -82,18 +94,30 @@ typedef struct {
 #define PRESET_STATUS_EMPTY           1
 #define PRESET_STATUS_INVALID         2
 #define PRESET_STATUS_ERROR           3
+#define PRESET_STATUS_BUSY            4
 
 /* Exported macro ------------------------------------------------------------*/
 
 /* Exported functions prototypes ---------------------------------------------*/
 void PresetManager_Init(void);
 uint8_t PresetManager_SavePreset(uint8_t presetId, const PresetSettings_t* settings);
+uint8_t PresetManager_SavePresetAsync(uint8_t presetId, const PresetSettings_t* settings,
+                                      PresetSaveCallback_t callback);
+void PresetManager_Task(void);
+uint8_t PresetManager_IsBusy(void);
+uint8_t PresetManager_ImportPresetAsync(uint8_t presetId, const uint8_t* record, uint16_t length,
+                                        PresetSaveCallback_t callback);
+uint8_t PresetManager_ExportPreset(uint8_t presetId, uint8_t* buffer, uint16_t size, uint16_t* length);
 uint8_t PresetManager_LoadPreset(uint8_t presetId, PresetSettings_t* settings);
 uint8_t PresetManager_DeletePreset(uint8_t presetId);
+uint8_t PresetManager_DeletePresetAsync(uint8_t presetId, PresetSaveCallback_t callback);
 uint8_t PresetManager_GetPresetInfo(uint8_t presetId, PresetMetadata_t* metadata);
 uint8_t PresetManager_RenamePreset(uint8_t presetId, const char* newName);
+uint8_t PresetManager_RenamePresetAsync(uint8_t presetId, const char* newName,
+                                        PresetSaveCallback_t callback);
 uint8_t PresetManager_GetPresetCount(void);
 uint8_t PresetManager_GetNextEmptySlot(void);
+uint8_t PresetManager_FindPreset(const char* name);
 void PresetManager_SetCurrentPreset(uint8_t presetId);
 uint8_t PresetManager_GetCurrentPreset(void);
 
@@ -0,0 +1,108 @@
+ /**
+  ******************************************************************************
+  * @file           : preset_morph.h
+  * @brief          : Header for preset_morph.c file.
+  *                   Gradual morphing between two presets with parameters
+  *                   interpolated at a bounded control rate.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PRESET_MORPH_H
+#define __PRESET_MORPH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Audio blocks per control update. Each update is split into this many
+   stages, one per block, so no block carries more than one stage. */
+#define MORPH_CONTROL_BLOCKS       4
+
+/* Default morph time in ms */
+#define MORPH_DEFAULT_TIME_MS      5000
+
+/* Gain a muted band fades to (or from) while morphing, in dB */
+#define MORPH_MUTE_GAIN_DB         -60.0f
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Morph statistics (cycle counts from the DWT cycle counter)
+  */
+typedef struct {
+    uint32_t controlUpdates;                         /* Completed control updates */
+    uint32_t worstStageCycles[MORPH_CONTROL_BLOCKS]; /* Longest run of each stage */
+    uint32_t worstCycles;                            /* Longest stage overall */
+} MorphStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Start morphing from one set of settings to another
+  * @note   Gains and thresholds are interpolated in dB, cutoffs and time
+  *         constants on a log scale, delays linearly. Switches (filter type
+  *         and order, enables, phase) change at the midpoint; muted bands
+  *         fade to MORPH_MUTE_GAIN_DB before the mute is applied.
+  * @param  from       Settings at the start of the morph (copied)
+  * @param  to         Settings at the end of the morph (copied)
+  * @param  durationMs Morph time in milliseconds
+  * @retval None
+  */
+void PresetMorph_Start(const SystemSettings_t *from, const SystemSettings_t *to, uint32_t durationMs);
+
+/**
+  * @brief  Stop the morph, leaving the current intermediate settings in place
+  * @retval None
+  */
+void PresetMorph_Stop(void);
+
+/**
+  * @brief  Advance the morph (call once per processed audio block)
+  * @note   Runs at most one control stage: interpolation, crossover
+  *         coefficients, dynamics or delay
+  * @param  pSettings Settings used by the processing chain (updated)
+  * @param  frames    Number of frames in the block just processed
+  * @retval None
+  */
+void PresetMorph_Tick(SystemSettings_t *pSettings, uint16_t frames);
+
+/**
+  * @brief  Check whether a morph is in progress
+  * @retval 1 if morphing, 0 otherwise
+  */
+uint8_t PresetMorph_IsActive(void);
+
+/**
+  * @brief  Get the morph position
+  * @retval Progress from 0 to 100 percent
+  */
+uint8_t PresetMorph_GetProgress(void);
+
+/**
+  * @brief  Get the morph statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void PresetMorph_GetStats(MorphStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PRESET_MORPH_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -28,24 +28,47 @@ extern "C" {
 /* Exported types ------------------------------------------------------------*/
 /**
   * @brief  Rotary Encoder Event Structure
+  * @note   Built by the main loop from the encoder steps in the input queue
+  *         (consecutive ones are combined); the push button is reported by
+  *         the button handler as BUTTON_ENCODER.
   */
 typedef struct {
     int8_t direction;        /* 1: Clockwise, -1: Counter-clockwise, 0: No movement */
-    uint8_t buttonPressed;   /* 1: Button pressed, 0: Button not pressed */
-    uint8_t buttonReleased;  /* 1: Button released, 0: Button not released */
-    uint8_t buttonHeld;      /* 1: Button held for long press, 0: Not held */
+    uint8_t steps;           /* Steps to apply in that direction (accelerated), 0 if no movement */
 } RotaryEvent_t;
 
 /**
   * @brief  Rotary Encoder Mode Enumeration
   */
 typedef enum {
-    ROTARY_MODE_NORMAL,      /* Standard sensitivity */
-    ROTARY_MODE_FINE,        /* Fine adjustment (higher resolution) */
-    ROTARY_MODE_COARSE       /* Coarse adjustment (lower resolution) */
+    ROTARY_MODE_NORMAL,      /* One step per detent, accelerated on fast turns */
+    ROTARY_MODE_FINE,        /* One step per detent, never accelerated */
+    ROTARY_MODE_COARSE       /* Five steps per detent, accelerated on fast turns */
 } RotaryMode_t;
 
 /* Exported constants --------------------------------------------------------*/
+#define ROTARY_CW                1
+#define ROTARY_CCW               (-1)
+
+/* Count the encoder with TIM4 in encoder mode (channels on PB6/PB7) instead of
+   sampling the pins from the TIM3 interrupt. The timer counts every edge of
+   both channels in hardware, so no steps are lost on fast turns. Set to 1 on
+   boards with the encoder wired to PB6/PB7; the LCD I2C1 bus then moves to
+   PB8/PB9. */
+#ifndef ROTARY_USE_TIMER
+#define ROTARY_USE_TIMER         0
+#endif
+
+/* Rate of the TIM3 input interrupt. The polled decoder must see the pins
+   between two edges, which are well under 1 ms apart on a fast turn; the
+   timer backend counts edges in hardware and needs only the 1 ms tick.
+   Must be a multiple of 1000. */
+#if ROTARY_USE_TIMER
+#define ROTARY_SAMPLE_HZ         1000
+#else
+#define ROTARY_SAMPLE_HZ         8000
+#endif
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
 
@@ -56,18 +79,23 @@ typedef enum {
 void RotaryEncoder_Init(void);
 
 /**
-  * @brief  Sample the rotary encoder pins for state changes
-  * @note   This should be called from a timer ISR or similar
+  * @brief  Read the encoder pins and count their edges (polled backend)
+  * @note   Call from the TIM3 ISR at ROTARY_SAMPLE_HZ. Does nothing with the
+  *         timer backend.
   * @retval None
   */
-void RotaryEncoder_Sample(void);
+void RotaryEncoder_SamplePins(void);
 
 /**
-  * @brief  Get the latest rotary encoder event if available
-  * @param  event Pointer to event structure to fill
-  * @retval 1 if event available, 0 if no event
+  * @brief  Sample the rotary encoder and queue the rotation
+  * @note   This should be called from the TIM3 ISR every 1 ms (the input queue
+  *         producer).
+  *         Turned detents are queued as INPUT_SOURCE_ENCODER events whose
+  *         value is the signed step count; in normal and coarse mode the
+  *         steps grow with the turning speed.
+  * @retval None
   */
-uint8_t RotaryEncoder_GetEvent(RotaryEvent_t* event);
+void RotaryEncoder_Sample(void);
 
 /**
   * @brief  Set the rotary encoder sensitivity mode
@@ -0,0 +1,119 @@
+ /**
+  ******************************************************************************
+  * @file           : scheduler.h
+  * @brief          : Header for scheduler.c file.
+  *                   Cooperative task scheduler with static priorities and
+  *                   per-task runtime and deadline accounting.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "event_loop.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SCHEDULER_MAX_TASKS        8
+
+/* Task function results */
+#define SCHEDULER_DONE             0   /* Nothing left until the task is triggered again */
+#define SCHEDULER_YIELD            1   /* More work left: run again after higher priorities */
+
+/* Cycle clock used for the accounting. It must be the counter the event
+   loop stamps posts with (DWT->CYCCNT); the host tests advance it by hand. */
+#ifndef SCHEDULER_CYCLES
+#define SCHEDULER_CYCLES()         (DWT->CYCCNT)
+#endif
+#ifndef SCHEDULER_CYCLES_PER_US
+#define SCHEDULER_CYCLES_PER_US    (SystemCoreClock / 1000000U)
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Task description (tables are ordered by priority, highest first)
+  */
+typedef struct {
+    const char* name;
+    uint8_t (*run)(void);       /* Returns SCHEDULER_DONE or SCHEDULER_YIELD */
+    uint32_t events;            /* EVENT_* flags that make the task ready */
+    uint32_t deadlineUs;        /* Longest time from ready to done, 0 for none */
+} SchedulerTask_t;
+
+/**
+  * @brief  Per-task statistics (32-bit fields only, sent as they are)
+  */
+typedef struct {
+    uint32_t runs;              /* Calls of the task function */
+    uint32_t yields;            /* Calls that returned SCHEDULER_YIELD */
+    uint32_t lastRunUs;         /* Length of the last call */
+    uint32_t worstRunUs;        /* Longest single call */
+    uint32_t totalRunUs;        /* Sum of all calls (wraps) */
+    uint32_t lastResponseUs;    /* Ready to done, for the last completed job */
+    uint32_t worstResponseUs;
+    uint32_t deadlineMisses;    /* Jobs that took longer than deadlineUs */
+} SchedulerTaskStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Set the task table and clear the statistics
+  * @note   The table is used in place and must stay valid. Tasks past
+  *         SCHEDULER_MAX_TASKS are ignored.
+  * @param  tasks Task table, highest priority first
+  * @param  count Number of tasks
+  * @retval None
+  */
+void Scheduler_Init(const SchedulerTask_t *tasks, uint8_t count);
+
+/**
+  * @brief  Run the highest priority ready task once, or sleep if none is ready
+  * @note   Call from the main loop only
+  * @retval None
+  */
+void Scheduler_RunNext(void);
+
+/**
+  * @brief  Get the number of tasks
+  * @retval Task count
+  */
+uint8_t Scheduler_GetTaskCount(void);
+
+/**
+  * @brief  Get a task name
+  * @param  index Task index (priority order)
+  * @retval Name, or NULL if there is no such task
+  */
+const char* Scheduler_GetTaskName(uint8_t index);
+
+/**
+  * @brief  Get the statistics of a task
+  * @param  index Task index (priority order)
+  * @param  stats Pointer to structure to fill
+  * @retval 1 if filled, 0 if there is no such task
+  */
+uint8_t Scheduler_GetTaskStats(uint8_t index, SchedulerTaskStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCHEDULER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
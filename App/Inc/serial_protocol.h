@@ -0,0 +1,144 @@
+ /**
+  ******************************************************************************
+  * @file           : serial_protocol.h
+  * @brief          : Header for serial_protocol.c file.
+  *                   Framed binary protocol on USART1 for preset transfer,
+  *                   live parameters and processing statistics.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SERIAL_PROTOCOL_H
+#define __SERIAL_PROTOCOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Frame layout (little-endian):
+     SOF (1) | length (2) | type (1) | sequence (1) | payload (length) | CRC32 (4)
+   The CRC covers everything from the length field to the end of the payload.
+   Every request is answered with one frame of type (request | SERIAL_MSG_RESPONSE)
+   and the same sequence number; its payload starts with a SERIAL_STATUS code.
+   Frames with a bad CRC are dropped without an answer, the host retries. */
+#define SERIAL_PROTOCOL_VERSION    1
+#define SERIAL_FRAME_SOF           0xA5
+#define SERIAL_HEADER_SIZE         5
+#define SERIAL_CRC_SIZE            4
+#define SERIAL_MAX_PAYLOAD         192
+#define SERIAL_MAX_FRAME           (SERIAL_HEADER_SIZE + SERIAL_MAX_PAYLOAD + SERIAL_CRC_SIZE)
+
+/* Circular DMA receive buffer; must hold the bytes arriving during the
+   longest main loop iteration (44ms at 115200 baud) */
+#define SERIAL_RX_BUFFER_SIZE      512
+
+/* A frame whose bytes stop arriving for this long is dropped. Without it a
+   damaged length field would hold the parser until that many bytes came in,
+   swallowing the host's retries. Longer than the longest main loop
+   iteration, shorter than the host's response timeout. */
+#define SERIAL_FRAME_TIMEOUT_MS    100
+
+/* Message types (requests from the host) */
+#define SERIAL_MSG_PING            0x01   /* -> version, max payload, firmware string */
+#define SERIAL_MSG_GET_STATS       0x02   /* -> AudioProcessingStats_t */
+#define SERIAL_MSG_TASK_STATS      0x03   /* task index -> index, task count, SchedulerTaskStats_t, name */
+#define SERIAL_MSG_TEST_LOAD       0x04   /* load us (4) -> load in effect (4); DSP overload test */
+#define SERIAL_MSG_PARAM_GET       0x10   /* id -> id, type, value, min, max, name */
+#define SERIAL_MSG_PARAM_SET       0x11   /* id, value -> id, value as applied */
+#define SERIAL_MSG_PRESET_LIST     0x20   /* first id -> next id, (id, name) entries */
+#define SERIAL_MSG_PRESET_READ     0x21   /* id -> id, encoded preset */
+#define SERIAL_MSG_PRESET_WRITE    0x22   /* id, encoded preset -> id (queued) */
+#define SERIAL_MSG_PRESET_DELETE   0x23   /* id -> id (BUSY until written; repeat for the result) */
+#define SERIAL_MSG_TELEMETRY_RATE  0x30   /* rate Hz (2) -> rate in effect (2) */
+#define SERIAL_MSG_UI_INPUT        0x40   /* source, code, state, value (4) -> (queued) */
+#define SERIAL_MSG_UI_SCREEN       0x41   /* -> screen (LCD_SCREEN_SIZE), UiProbeStats_t */
+#define SERIAL_MSG_RESPONSE        0x80
+
+/* Unsolicited frames from the device; the sequence number counts frames */
+#define SERIAL_MSG_TELEMETRY       0xC0   /* See telemetry.h */
+
+/* Status codes (first payload byte of every response) */
+#define SERIAL_STATUS_OK           0
+#define SERIAL_STATUS_UNKNOWN      1   /* Unknown message type */
+#define SERIAL_STATUS_LENGTH       2   /* Payload length wrong for the message */
+#define SERIAL_STATUS_INVALID      3   /* Bad ID, value or preset record */
+#define SERIAL_STATUS_BUSY         4   /* Try again later */
+#define SERIAL_STATUS_EMPTY        5   /* No preset stored under that ID */
+#define SERIAL_STATUS_ERROR        6   /* Storage failure */
+
+/* Parameter value types */
+#define SERIAL_PARAM_FLOAT         0
+#define SERIAL_PARAM_BOOL          1
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Protocol link statistics
+  */
+typedef struct {
+    uint32_t framesReceived;   /* Frames with a good CRC */
+    uint32_t framesSent;       /* Responses and unsolicited frames sent */
+    uint32_t crcErrors;        /* Frames dropped for a bad CRC */
+    uint32_t framingErrors;    /* Bytes skipped while looking for a frame,
+                                  and frames dropped for a timeout */
+    uint32_t rxRestarts;       /* Reception restarted after a UART error */
+} SerialProtocolStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the protocol and start DMA reception on USART1
+  * @param  pSettings Settings used by the processing chain (live parameters)
+  * @retval None
+  */
+void SerialProtocol_Init(SystemSettings_t *pSettings);
+
+/**
+  * @brief  Parse received bytes and answer at most one request
+  * @note   Call from the main loop after audio processing. Nothing here
+  *         waits on the UART: reception and transmission run by DMA.
+  * @retval None
+  */
+void SerialProtocol_Task(void);
+
+/**
+  * @brief  Send a frame that was not requested by the host
+  * @note   The caller builds the payload at frame + SERIAL_HEADER_SIZE and
+  *         leaves SERIAL_CRC_SIZE bytes after it; header and CRC are filled
+  *         in here. The buffer is read by DMA and must not change until the
+  *         next successful call.
+  * @param  type     Message type
+  * @param  sequence Sequence number
+  * @param  frame    Frame buffer (SERIAL_MAX_FRAME bytes)
+  * @param  length   Payload length
+  * @retval SERIAL_STATUS_OK if sent, SERIAL_STATUS_BUSY if the UART is busy
+  */
+uint8_t SerialProtocol_SendFrame(uint8_t type, uint8_t sequence, uint8_t *frame, uint16_t length);
+
+/**
+  * @brief  Get protocol link statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void SerialProtocol_GetStats(SerialProtocolStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SERIAL_PROTOCOL_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,101 @@
+ /**
+  ******************************************************************************
+  * @file           : stack_monitor.h
+  * @brief          : Header for stack_monitor.c file.
+  *                   Runtime stack watermark (stack painting) for the main
+  *                   loop and interrupt contexts.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STACK_MONITOR_H
+#define __STACK_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Pattern written to unused stack words */
+#define STACK_PAINT_PATTERN        0xC5C5C5C5UL
+
+/* Words left unpainted directly below the caller's frame in StackMonitor_Init */
+#define STACK_PAINT_MARGIN_WORDS   16
+
+/* Consecutive painted words required to consider the stack untouched below */
+#define STACK_SCAN_GUARD_WORDS     4
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Stack usage summary (all sizes in bytes)
+  */
+typedef struct {
+    uint32_t stackSize;      /* Reserved stack size (_Min_Stack_Size) */
+    uint32_t peakUsage;      /* Deepest point reached, measured from _estack */
+    uint32_t mainPeak;       /* Deepest point reached while in the main loop */
+    uint32_t isrPeak;        /* Largest stack used by a callback on top of the
+                                interrupted frame */
+    uint8_t overflow;        /* 1 if the bottom of the reserved stack was reached */
+} StackUsage_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Paint the unused part of the stack and reset the watermarks
+  * @note   Call as early as possible in main(), before interrupts are enabled
+  * @retval None
+  */
+void StackMonitor_Init(void);
+
+/**
+  * @brief  Mark entry into an interrupt callback
+  * @note   Must be paired with StackMonitor_ExitISR() in the same callback
+  * @retval None
+  */
+void StackMonitor_EnterISR(void);
+
+/**
+  * @brief  Mark exit from an interrupt callback and update the ISR watermark
+  * @retval None
+  */
+void StackMonitor_ExitISR(void);
+
+/**
+  * @brief  Update the main loop watermark (call once per main loop iteration)
+  * @retval None
+  */
+void StackMonitor_Checkpoint(void);
+
+/**
+  * @brief  Get the stack usage summary
+  * @param  usage Pointer to structure to fill
+  * @retval None
+  */
+void StackMonitor_GetUsage(StackUsage_t* usage);
+
+/**
+  * @brief  Print the stack usage summary to the debug output
+  * @retval None
+  */
+void StackMonitor_PrintReport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STACK_MONITOR_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,124 @@
+ /**
+  ******************************************************************************
+  * @file           : telemetry.h
+  * @brief          : Header for telemetry.c file.
+  *                   Streams meters and DSP load to the host over USART1.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Telemetry frames are serial protocol frames of type SERIAL_MSG_TELEMETRY.
+   Payload (little-endian):
+     format (1) | first sample number (2) | interval ms (2) | block period us (2)
+     | field count (1) | sample count (1) | samples
+   Each sample is one value per field, each coded as the zigzag varint of its
+   difference to the same field in the previous sample of the frame (the first
+   sample of a frame is coded against zero, so frames decode on their own). */
+#define TELEMETRY_FORMAT_VERSION   1
+#define TELEMETRY_HEADER_SIZE      9
+
+/* Highest sample rate in Hz */
+#define TELEMETRY_MAX_RATE_HZ      100
+
+/* A frame is sent when full or when its first sample is this old */
+#define TELEMETRY_MAX_LATENCY_MS   100
+
+/* Fields of a sample, in order. Levels are in 0.1 dB (peaks in dBFS, floored
+   at TELEMETRY_LEVEL_FLOOR_DB), times in microseconds. */
+#define TELEMETRY_FIELD_INPUT_PEAK     0    /* L, R */
+#define TELEMETRY_FIELD_OUTPUT_PEAK    2    /* L, R */
+#define TELEMETRY_FIELD_BAND_PEAK      4    /* sub L, sub R, low L ... high R */
+#define TELEMETRY_FIELD_COMPRESSION    12   /* sub, low, mid, high */
+#define TELEMETRY_FIELD_LIMITER        16   /* sub, low, mid, high */
+#define TELEMETRY_FIELD_CLIPPING       20   /* Total clipped samples */
+#define TELEMETRY_FIELD_BLOCK_TIME     21   /* Last block processing time */
+#define TELEMETRY_FIELD_WORST_TIME     22   /* Longest block since the previous sample */
+#define TELEMETRY_FIELD_CROSSFADE_TIME 23   /* Longest block during the last crossfade */
+#define TELEMETRY_FIELD_IDLE           24   /* Main loop idle share in 0.1 % (last window) */
+#define TELEMETRY_FIELD_COUNT          25
+
+#define TELEMETRY_LEVEL_FLOOR_DB   -100.0f
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Telemetry statistics
+  */
+typedef struct {
+    uint32_t samples;          /* Samples taken */
+    uint32_t framesSent;       /* Frames handed to the UART */
+    uint32_t samplesDropped;   /* Samples lost because the UART was busy */
+    uint32_t snapshotRetries;  /* Snapshot reads repeated after a concurrent write */
+} TelemetryStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize telemetry (stopped)
+  * @retval None
+  */
+void Telemetry_Init(void);
+
+/**
+  * @brief  Set the sample rate
+  * @param  newRateHz Samples per second, 0 to stop (limited to TELEMETRY_MAX_RATE_HZ)
+  * @retval Rate in effect
+  */
+uint16_t Telemetry_SetRate(uint16_t newRateHz);
+
+/**
+  * @brief  Get the sample rate
+  * @retval Samples per second, 0 if stopped
+  */
+uint16_t Telemetry_GetRate(void);
+
+/**
+  * @brief  Publish the statistics of the block just processed
+  * @note   Called from the audio path after each block. Only copies the
+  *         statistics into a snapshot (sequence counter, no lock) and does
+  *         nothing while telemetry is stopped.
+  * @retval None
+  */
+void Telemetry_Snapshot(void);
+
+/**
+  * @brief  Take samples, pack frames and send them when the UART is free
+  * @note   Call from the main loop
+  * @retval None
+  */
+void Telemetry_Task(void);
+
+/**
+  * @brief  Get telemetry statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void Telemetry_GetStats(TelemetryStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEMETRY_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
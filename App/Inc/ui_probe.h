@@ -0,0 +1,105 @@
+ /**
+  ******************************************************************************
+  * @file           : ui_probe.h
+  * @brief          : Header for ui_probe.c file.
+  *                   Input injection and response measurement for scripted
+  *                   front panel tests over the serial protocol.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __UI_PROBE_H
+#define __UI_PROBE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "input_queue.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* An interaction that has not changed the screen after this time (ms) is
+   counted as unchanged */
+#define UI_PROBE_WINDOW_MS         500
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Response statistics (32-bit fields only, sent as they are)
+  */
+typedef struct {
+    uint32_t interactions;   /* Interactions that changed the screen */
+    uint32_t unchanged;      /* Interactions that changed nothing within the window */
+    uint32_t injected;       /* Events queued through UiProbe_Inject() */
+    uint32_t lastLatency;    /* ms from the event to the last byte on the display */
+    uint32_t worstLatency;
+    uint32_t totalLatency;
+    uint32_t lastBusBytes;   /* LCD bus bytes sent for the last interaction */
+    uint32_t worstBusBytes;
+} UiProbeStats_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Initialize the probe and clear the statistics
+  * @retval None
+  */
+void UiProbe_Init(void);
+
+/**
+  * @brief  Queue an input event as if it came from the front panel
+  * @note   Main loop only. The input queue has one producer (the TIM3
+  *         sampling interrupt), so interrupts are masked around the push.
+  * @param  source INPUT_SOURCE_*
+  * @param  code Source specific code
+  * @param  state Source specific state
+  * @param  value Source specific value
+  * @retval 1 if queued, 0 if the queue was full
+  */
+uint8_t UiProbe_Inject(uint8_t source, uint8_t code, uint8_t state, int32_t value);
+
+/**
+  * @brief  Note an input event taken by the main loop
+  * @note   Starts an interaction. Events taken in the same UI pass, or
+  *         while the screen change of the open interaction is still being
+  *         sent, belong to the open one; an open interaction that has not
+  *         changed the screen by the next pass is counted as unchanged.
+  * @param  event Event taken from the input queue
+  * @retval None
+  */
+void UiProbe_EventTaken(const InputEvent_t *event);
+
+/**
+  * @brief  Note a frame buffer flush (call right after LCD_Flush())
+  * @note   Closes the open interaction once something was drawn and the
+  *         display has caught up, or when UI_PROBE_WINDOW_MS has passed.
+  * @param  sent Characters queued by the flush
+  * @retval None
+  */
+void UiProbe_Flushed(uint8_t sent);
+
+/**
+  * @brief  Get the response statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void UiProbe_GetStats(UiProbeStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UI_PROBE_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
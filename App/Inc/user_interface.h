@@ -90,6 +90,8 @@ void UI_SetSystemState(uint8_t state);
 void UI_NotifyPresetLoaded(uint8_t presetIndex);
 void UI_NotifySettingsSaved(uint8_t presetIndex);
 void UI_ShowMessage(const char* line1, const char* line2, uint16_t timeout);
+void UI_QueueMessage(const char* line1, const char* line2, uint16_t timeout);
+void UI_ShowMeters(void);
 
 #ifdef __cplusplus
 }
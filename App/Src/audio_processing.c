@@ -24,23 +24,43 @@
 #include "compressor.h"
 #include "limiter.h"
 #include "delay.h"
+#include "memory_manager.h"
+#include "dsp_watchdog.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define AUDIO_TEMP_BUFFER_SIZE (AUDIO_BUFFER_SIZE * 4)  /* 4x for crossover bands */
+#define AUDIO_FRAME_COUNT (AUDIO_BUFFER_SIZE / 2)  /* Stereo samples -> frames */
+
+/* Band meters are updated every this many blocks at DSP_QUALITY_MINIMAL */
+#define MINIMAL_METER_BLOCKS 4
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Audio processing statistics */
 static AudioProcessingStats_t audioStats = {0};
 
-/* Temporary buffers for band-split audio processing */
-static float tempBufferL[AUDIO_TEMP_BUFFER_SIZE];
-static float tempBufferR[AUDIO_TEMP_BUFFER_SIZE];
+/* Per-channel working buffers (one block of frames), allocated from the arena */
+static float *tempBufferL = NULL;
+static float *tempBufferR = NULL;
+
+/* Band-specific processing buffers, allocated from the arena */
+static float *bandBufferL[NUM_BANDS] = {NULL};
+static float *bandBufferR[NUM_BANDS] = {NULL};
 
-/* Band-specific processing buffers */
-static float bandBufferL[NUM_BANDS][AUDIO_BUFFER_SIZE/2]; /* Stereo -> mono */
-static float bandBufferR[NUM_BANDS][AUDIO_BUFFER_SIZE/2];
+/* Band buffers of the incoming preset while crossfading, allocated from the arena */
+static float *fadeBandBufferL[NUM_BANDS] = {NULL};
+static float *fadeBandBufferR[NUM_BANDS] = {NULL};
+
+/* Crossfade state. The incoming preset runs on the standby crossover
+   instance; a second request during a fade waits in the pending slot. */
+static SystemSettings_t fadeTarget;
+static SystemSettings_t fadePending;
+static uint8_t fadeActive = 0;
+static uint8_t fadePendingValid = 0;
+static uint16_t fadePendingMs = 0;
+static uint8_t fadeInstance = 0;
+static uint32_t fadeFramesTotal = 0;
+static uint32_t fadeFramesDone = 0;
 
 /* Debug timing measurement */
 static uint32_t processingStartTime = 0;
@@ -49,6 +69,11 @@ static uint32_t processingEndTime = 0;
 /* Bypass control */
 static uint8_t bypassEnabled = 0;
 
+/* Quality level set by the deadline monitor, and blocks since the last
+   band meter update at DSP_QUALITY_MINIMAL */
+static uint8_t qualityLevel = DSP_QUALITY_FULL;
+static uint8_t meterBlocks = 0;
+
 /* Private function prototypes -----------------------------------------------*/
 static void ConvertToFloat(const int16_t *input, float *outputL, float *outputR, uint16_t length);
 static void ConvertToInt16(const float *inputL, const float *inputR, int16_t *output, uint16_t length);
@@ -57,7 +82,13 @@ static void MixBands(float *subL, float *lowL, float *midL, float *highL,
                     float *subR, float *lowR, float *midR, float *highR,
                     float *outputL, float *outputR, uint16_t length);
 static void ApplyGain(float *buffer, uint16_t length, float gainDB);
+static void GetBandGain(const SystemSettings_t *pSettings, int band, float *gainDB, uint8_t *mute);
+static void BeginCrossfade(const SystemSettings_t *pTarget, uint16_t fadeMs);
+static void CrossfadeBand(float *current, const float *next, uint16_t length,
+                          float currentGain, float nextGain);
+static void CompleteCrossfade(SystemSettings_t *pSettings);
 static void GetProcessingTime(void);
+static void UpdateQuality(void);
 
 /* External variables --------------------------------------------------------*/
 extern TIM_HandleTypeDef htim2; /* Used for timing measurement */
@@ -71,18 +102,53 @@ void AudioProcessing_Init(void)
   /* Initialize statistics */
   memset(&audioStats, 0, sizeof(AudioProcessingStats_t));
   
+  /* Allocate processing buffers on first init */
+  if (tempBufferL == NULL) {
+    static const char *bandOwnersL[NUM_BANDS] = {"ap.subL", "ap.lowL", "ap.midL", "ap.highL"};
+    static const char *bandOwnersR[NUM_BANDS] = {"ap.subR", "ap.lowR", "ap.midR", "ap.highR"};
+    
+    tempBufferL = MemoryManager_AllocDSP("ap.tempL", AUDIO_FRAME_COUNT * sizeof(float));
+    tempBufferR = MemoryManager_AllocDSP("ap.tempR", AUDIO_FRAME_COUNT * sizeof(float));
+    if (tempBufferL == NULL || tempBufferR == NULL) {
+      Error_Handler();
+    }
+    
+    static const char *fadeOwnersL[NUM_BANDS] = {"ap.fadeSubL", "ap.fadeLowL", "ap.fadeMidL", "ap.fadeHighL"};
+    static const char *fadeOwnersR[NUM_BANDS] = {"ap.fadeSubR", "ap.fadeLowR", "ap.fadeMidR", "ap.fadeHighR"};
+    
+    for (int band = 0; band < NUM_BANDS; band++) {
+      bandBufferL[band] = MemoryManager_AllocDSP(bandOwnersL[band], AUDIO_FRAME_COUNT * sizeof(float));
+      bandBufferR[band] = MemoryManager_AllocDSP(bandOwnersR[band], AUDIO_FRAME_COUNT * sizeof(float));
+      fadeBandBufferL[band] = MemoryManager_AllocDSP(fadeOwnersL[band], AUDIO_FRAME_COUNT * sizeof(float));
+      fadeBandBufferR[band] = MemoryManager_AllocDSP(fadeOwnersR[band], AUDIO_FRAME_COUNT * sizeof(float));
+      if (bandBufferL[band] == NULL || bandBufferR[band] == NULL ||
+          fadeBandBufferL[band] == NULL || fadeBandBufferR[band] == NULL) {
+        Error_Handler();
+      }
+    }
+  }
+  
   /* Initialize processing buffers */
-  memset(tempBufferL, 0, sizeof(tempBufferL));
-  memset(tempBufferR, 0, sizeof(tempBufferR));
+  memset(tempBufferL, 0, AUDIO_FRAME_COUNT * sizeof(float));
+  memset(tempBufferR, 0, AUDIO_FRAME_COUNT * sizeof(float));
   
   for (int band = 0; band < NUM_BANDS; band++) {
-    memset(bandBufferL[band], 0, sizeof(bandBufferL[band]));
-    memset(bandBufferR[band], 0, sizeof(bandBufferR[band]));
+    memset(bandBufferL[band], 0, AUDIO_FRAME_COUNT * sizeof(float));
+    memset(bandBufferR[band], 0, AUDIO_FRAME_COUNT * sizeof(float));
   }
 
   /* Initialize bypass mode */
   bypassEnabled = 0;
   
+  /* Start at full quality; overruns of the block period lower it */
+  DspWatchdog_Init(AUDIO_BLOCK_PERIOD_US);
+  qualityLevel = DSP_QUALITY_FULL;
+  meterBlocks = 0;
+  
+  /* No crossfade in progress */
+  fadeActive = 0;
+  fadePendingValid = 0;
+  
   #ifdef DEBUG
   printf("Audio processing initialized\r\n");
   #endif
@@ -100,25 +166,32 @@ void AudioProcessing_Process(
     AudioBuffer_t *pOutputBuffer,
     SystemSettings_t *pSettings)
 {
-  uint16_t monoFrames = AUDIO_BUFFER_SIZE / 2; /* Convert from stereo samples to mono frames */
+  uint16_t monoFrames = AUDIO_FRAME_COUNT; /* Convert from stereo samples to mono frames */
   
   /* Start timing measurement */
-  processingStartTime = HAL_GetTick();
+  processingStartTime = DWT->CYCCNT;
+  
+  /* Artificial load of an overload test (none normally) */
+  DspWatchdog_ApplyTestLoad();
   
   /* If bypass is enabled, just copy input to output */
   if (bypassEnabled) {
     memcpy(pOutputBuffer->data, pInputBuffer->data, AUDIO_BUFFER_SIZE * sizeof(int16_t));
     
     /* Update peak levels for display purposes */
-    float dummyPeakL, dummyPeakR;
     ConvertToFloat(pInputBuffer->data, tempBufferL, tempBufferR, monoFrames);
     UpdatePeakLevels(tempBufferL, tempBufferR, monoFrames, &audioStats.inputPeakLevel[CHANNEL_LEFT], &audioStats.inputPeakLevel[CHANNEL_RIGHT]);
     audioStats.outputPeakLevel[CHANNEL_LEFT] = audioStats.inputPeakLevel[CHANNEL_LEFT];
     audioStats.outputPeakLevel[CHANNEL_RIGHT] = audioStats.inputPeakLevel[CHANNEL_RIGHT];
     
+    /* Nothing to fade while bypassed: switch straight to the new preset */
+    if (fadeActive) {
+      CompleteCrossfade(pSettings);
+    }
+    
     /* End timing measurement */
-    processingEndTime = HAL_GetTick();
-    audioStats.processingTime = processingEndTime - processingStartTime;
+    GetProcessingTime();
+    UpdateQuality();
     
     return;
   }
@@ -131,6 +204,18 @@ void AudioProcessing_Process(
                   &audioStats.inputPeakLevel[CHANNEL_LEFT], 
                   &audioStats.inputPeakLevel[CHANNEL_RIGHT]);
   
+  /* At minimal quality only one filter bank runs: a preset switches at once */
+  while (fadeActive && qualityLevel >= DSP_QUALITY_MINIMAL) {
+    CompleteCrossfade(pSettings);
+  }
+  
+  /* Band meters are decimated at minimal quality */
+  uint8_t updateBandMeters = 1;
+  if (qualityLevel >= DSP_QUALITY_MINIMAL) {
+    updateBandMeters = (meterBlocks == 0);
+    meterBlocks = (meterBlocks + 1) % MINIMAL_METER_BLOCKS;
+  }
+  
   /* Apply crossover to split the signal into bands */
   Crossover_Process(tempBufferL, tempBufferR, monoFrames,
                    bandBufferL[BAND_SUB], bandBufferR[BAND_SUB],
@@ -139,121 +224,123 @@ void AudioProcessing_Process(
                    bandBufferL[BAND_HIGH], bandBufferR[BAND_HIGH],
                    &pSettings->crossover);
   
+  /* While crossfading, also split the input with the incoming preset */
+  SystemSettings_t *pChain = pSettings;
+  if (fadeActive) {
+    uint8_t currentInstance = Crossover_GetInstance();
+    
+    Crossover_SelectInstance(fadeInstance);
+    Crossover_Process(tempBufferL, tempBufferR, monoFrames,
+                     fadeBandBufferL[BAND_SUB], fadeBandBufferR[BAND_SUB],
+                     fadeBandBufferL[BAND_LOW], fadeBandBufferR[BAND_LOW],
+                     fadeBandBufferL[BAND_MID], fadeBandBufferR[BAND_MID],
+                     fadeBandBufferL[BAND_HIGH], fadeBandBufferR[BAND_HIGH],
+                     &fadeTarget.crossover);
+    Crossover_SelectInstance(currentInstance);
+    
+    /* Band dynamics and delay follow the incoming preset from the start */
+    pChain = &fadeTarget;
+  }
+  
   /* Apply band-specific processing for each band */
   for (int band = 0; band < NUM_BANDS; band++) {
     float *leftBuffer = bandBufferL[band];
     float *rightBuffer = bandBufferR[band];
     
-    /* Apply band-specific gain */
+    /* Get the appropriate gain and mute settings for this band */
     float bandGain = 0.0f;
     uint8_t bandMute = 0;
+    GetBandGain(pSettings, band, &bandGain, &bandMute);
     
-    /* Get the appropriate gain and mute settings for this band */
-    switch (band) {
-      case BAND_SUB:
-        bandGain = pSettings->crossover.subGain;
-        bandMute = pSettings->crossover.subMute;
-        break;
-      case BAND_LOW:
-        bandGain = pSettings->crossover.lowGain;
-        bandMute = pSettings->crossover.lowMute;
-        break;
-      case BAND_MID:
-        bandGain = pSettings->crossover.midGain;
-        bandMute = pSettings->crossover.midMute;
-        break;
-      case BAND_HIGH:
-        bandGain = pSettings->crossover.highGain;
-        bandMute = pSettings->crossover.highMute;
-        break;
-    }
-    
-    /* If band is muted, zero out the buffer and skip processing */
-    if (bandMute) {
-      memset(leftBuffer, 0, monoFrames * sizeof(float));
-      memset(rightBuffer, 0, monoFrames * sizeof(float));
-      continue;
+    if (fadeActive) {
+      /* Blend in the same band of the incoming preset, applying both gains */
+      float nextGain = 0.0f;
+      uint8_t nextMute = 0;
+      GetBandGain(&fadeTarget, band, &nextGain, &nextMute);
+      
+      float currentLinear = bandMute ? 0.0f : DB_TO_LINEAR(bandGain);
+      float nextLinear = nextMute ? 0.0f : DB_TO_LINEAR(nextGain);
+      CrossfadeBand(leftBuffer, fadeBandBufferL[band], monoFrames, currentLinear, nextLinear);
+      CrossfadeBand(rightBuffer, fadeBandBufferR[band], monoFrames, currentLinear, nextLinear);
+    } else {
+      /* If band is muted, zero out the buffer and skip processing */
+      if (bandMute) {
+        memset(leftBuffer, 0, monoFrames * sizeof(float));
+        memset(rightBuffer, 0, monoFrames * sizeof(float));
+        continue;
+      }
+      
+      /* Apply band gain */
+      ApplyGain(leftBuffer, monoFrames, bandGain);
+      ApplyGain(rightBuffer, monoFrames, bandGain);
     }
     
-    /* Apply band gain */
-    ApplyGain(leftBuffer, monoFrames, bandGain);
-    ApplyGain(rightBuffer, monoFrames, bandGain);
-    
     /* Update peak levels for this band for metering */
-    UpdatePeakLevels(leftBuffer, rightBuffer, monoFrames,
-                    &audioStats.bandPeakLevel[band][CHANNEL_LEFT],
-                    &audioStats.bandPeakLevel[band][CHANNEL_RIGHT]);
+    if (updateBandMeters) {
+      UpdatePeakLevels(leftBuffer, rightBuffer, monoFrames,
+                      &audioStats.bandPeakLevel[band][CHANNEL_LEFT],
+                      &audioStats.bandPeakLevel[band][CHANNEL_RIGHT]);
+    }
     
     /* Apply compressor for dynamic control */
     float compressionAmount = 0.0f;
-    struct CompressorSettings_t *compSettings = &pSettings->compressor;
+    struct CompressorSettings_t *compSettings = &pChain->compressor;
     
     /* Select the appropriate band compressor settings */
-    struct {
-      float threshold;
-      float ratio;
-      float attack;
-      float release;
-      float makeupGain;
-      uint8_t enabled;
-    } bandComp;
+    const struct CompressorBandSettings_t *bandComp = &compSettings->sub;
     
     switch (band) {
       case BAND_SUB:
-        bandComp = compSettings->sub;
+        bandComp = &compSettings->sub;
         break;
       case BAND_LOW:
-        bandComp = compSettings->low;
+        bandComp = &compSettings->low;
         break;
       case BAND_MID:
-        bandComp = compSettings->mid;
+        bandComp = &compSettings->mid;
         break;
       case BAND_HIGH:
-        bandComp = compSettings->high;
+        bandComp = &compSettings->high;
         break;
     }
     
     /* Apply compressor if enabled */
-    if (bandComp.enabled) {
+    if (bandComp->enabled) {
       Compressor_Process(leftBuffer, rightBuffer, monoFrames,
-                        bandComp.threshold, bandComp.ratio,
-                        bandComp.attack, bandComp.release,
-                        bandComp.makeupGain, band, &compressionAmount);
+                        bandComp->threshold, bandComp->ratio,
+                        bandComp->attack, bandComp->release,
+                        bandComp->makeupGain, band, &compressionAmount);
     }
     
     /* Store compression amount for metering */
     audioStats.compressionAmount[band] = compressionAmount;
     
     /* Apply limiter for overload protection */
-    struct LimiterSettings_t *limSettings = &pSettings->limiter;
+    struct LimiterSettings_t *limSettings = &pChain->limiter;
     float limiterGainReduction = 0.0f;
     
     /* Select the appropriate band limiter settings */
-    struct {
-      float threshold;
-      float release;
-      uint8_t enabled;
-    } bandLim;
+    const struct LimiterBandSettings_t *bandLim = &limSettings->sub;
     
     switch (band) {
       case BAND_SUB:
-        bandLim = limSettings->sub;
+        bandLim = &limSettings->sub;
         break;
       case BAND_LOW:
-        bandLim = limSettings->low;
+        bandLim = &limSettings->low;
         break;
       case BAND_MID:
-        bandLim = limSettings->mid;
+        bandLim = &limSettings->mid;
         break;
       case BAND_HIGH:
-        bandLim = limSettings->high;
+        bandLim = &limSettings->high;
         break;
     }
     
     /* Apply limiter if enabled */
-    if (bandLim.enabled) {
+    if (bandLim->enabled) {
       Limiter_Process(leftBuffer, rightBuffer, monoFrames,
-                     bandLim.threshold, bandLim.release,
+                     bandLim->threshold, bandLim->release,
                      band, &limiterGainReduction);
     }
     
@@ -261,7 +348,7 @@ void AudioProcessing_Process(
     audioStats.limiterActivity[band] = limiterGainReduction;
     
     /* Apply delay and phase adjustments */
-    struct DelaySettings_t *delaySettings = &pSettings->delay;
+    struct DelaySettings_t *delaySettings = &pChain->delay;
     float delayMs = 0.0f;
     uint8_t phaseInvert = 0;
     
@@ -305,6 +392,53 @@ void AudioProcessing_Process(
   
   /* End timing measurement */
   GetProcessingTime();
+  
+  /* Shed or restore work from the next block on */
+  UpdateQuality();
+  
+  /* Advance the crossfade; the swap happens between blocks */
+  if (fadeActive) {
+    if (audioStats.processingTime > audioStats.crossfadePeakTime) {
+      audioStats.crossfadePeakTime = audioStats.processingTime;
+    }
+    
+    fadeFramesDone += monoFrames;
+    if (fadeFramesDone >= fadeFramesTotal) {
+      CompleteCrossfade(pSettings);
+    }
+  }
+}
+
+/**
+  * @brief  Switch to new settings by crossfading from the current ones
+  * @param  pTarget Settings to switch to (copied)
+  * @param  fadeMs  Crossfade time in milliseconds
+  * @retval None
+  */
+void AudioProcessing_StartCrossfade(const SystemSettings_t *pTarget, uint16_t fadeMs)
+{
+  if (pTarget == NULL) {
+    return;
+  }
+  
+  /* Let a running fade finish; only the latest request is kept */
+  if (fadeActive) {
+    memcpy(&fadePending, pTarget, sizeof(SystemSettings_t));
+    fadePendingMs = fadeMs;
+    fadePendingValid = 1;
+    return;
+  }
+  
+  BeginCrossfade(pTarget, fadeMs);
+}
+
+/**
+  * @brief  Check whether a preset crossfade is in progress
+  * @retval 1 if crossfading, 0 otherwise
+  */
+uint8_t AudioProcessing_IsCrossfading(void)
+{
+  return (fadeActive || fadePendingValid) ? 1 : 0;
 }
 
 /**
@@ -315,8 +449,16 @@ void AudioProcessing_Process(
 void AudioProcessing_GetStats(AudioProcessingStats_t *pStats)
 {
   if (pStats != NULL) {
+    DspWatchdogStats_t watchdogStats;
+    
     /* Copy current statistics */
     memcpy(pStats, &audioStats, sizeof(AudioProcessingStats_t));
+    
+    /* Deadline monitor */
+    DspWatchdog_GetStats(&watchdogStats);
+    pStats->deadlineMisses = watchdogStats.overruns;
+    pStats->qualityLevel = watchdogStats.level;
+    pStats->qualityDrops = watchdogStats.stepDowns;
   }
 }
 
@@ -365,6 +507,111 @@ uint8_t AudioProcessing_GetBypass(void)
 
 /* Private Functions ---------------------------------------------------------*/
 
+/**
+  * @brief  Prepare the standby crossover instance and start the crossfade
+  * @param  pTarget Settings to switch to
+  * @param  fadeMs  Crossfade time in milliseconds
+  * @retval None
+  */
+static void BeginCrossfade(const SystemSettings_t *pTarget, uint16_t fadeMs)
+{
+  uint8_t currentInstance = Crossover_GetInstance();
+  
+  memcpy(&fadeTarget, pTarget, sizeof(SystemSettings_t));
+  
+  /* Build the new filter bank next to the running one (history starts
+     cleared; its settling is masked by the fade-in) */
+  fadeInstance = (currentInstance + 1) % CROSSOVER_NUM_INSTANCES;
+  Crossover_SelectInstance(fadeInstance);
+  Crossover_SetSettings(&fadeTarget.crossover);
+  Crossover_SelectInstance(currentInstance);
+  
+  /* At least one block, so even an instant switch is click-free */
+  fadeFramesTotal = ((uint32_t)fadeMs * AUDIO_SAMPLE_RATE_HZ) / 1000;
+  if (fadeFramesTotal < AUDIO_FRAME_COUNT) {
+    fadeFramesTotal = AUDIO_FRAME_COUNT;
+  }
+  fadeFramesDone = 0;
+  audioStats.crossfadePeakTime = 0;
+  fadeActive = 1;
+}
+
+/**
+  * @brief  Mix one block of a band with the incoming preset's band
+  * @note   Linear (equal-gain) ramp: both chains process the same input, so
+  *         the signals are strongly correlated and the level stays constant
+  * @param  current Band of the active preset, overwritten with the mix
+  * @param  next Band of the incoming preset
+  * @param  length Number of samples
+  * @param  currentGain Linear band gain of the active preset
+  * @param  nextGain Linear band gain of the incoming preset
+  * @retval None
+  */
+static void CrossfadeBand(float *current, const float *next, uint16_t length,
+                          float currentGain, float nextGain)
+{
+  float position = (float)fadeFramesDone / (float)fadeFramesTotal;
+  float step = 1.0f / (float)fadeFramesTotal;
+  
+  for (uint16_t i = 0; i < length; i++) {
+    float mix = MIN(position, 1.0f);
+    current[i] = current[i] * currentGain * (1.0f - mix) + next[i] * nextGain * mix;
+    position += step;
+  }
+}
+
+/**
+  * @brief  Finish the crossfade: make the incoming preset the active one
+  * @param  pSettings Settings used by the processing chain (updated)
+  * @retval None
+  */
+static void CompleteCrossfade(SystemSettings_t *pSettings)
+{
+  /* Atomic with respect to audio: runs between two blocks */
+  Crossover_SelectInstance(fadeInstance);
+  memcpy(pSettings, &fadeTarget, sizeof(SystemSettings_t));
+  fadeActive = 0;
+  
+  #ifdef DEBUG
+  printf("Crossfade complete (peak block time %lu us)\r\n", audioStats.crossfadePeakTime);
+  #endif
+  
+  if (fadePendingValid) {
+    fadePendingValid = 0;
+    BeginCrossfade(&fadePending, fadePendingMs);
+  }
+}
+
+/**
+  * @brief  Get the gain and mute settings of a band
+  * @param  pSettings Settings to read from
+  * @param  band Band index
+  * @param  gainDB Receives the band gain in dB
+  * @param  mute Receives the band mute flag
+  * @retval None
+  */
+static void GetBandGain(const SystemSettings_t *pSettings, int band, float *gainDB, uint8_t *mute)
+{
+  switch (band) {
+    case BAND_SUB:
+      *gainDB = pSettings->crossover.subGain;
+      *mute = pSettings->crossover.subMute;
+      break;
+    case BAND_LOW:
+      *gainDB = pSettings->crossover.lowGain;
+      *mute = pSettings->crossover.lowMute;
+      break;
+    case BAND_MID:
+      *gainDB = pSettings->crossover.midGain;
+      *mute = pSettings->crossover.midMute;
+      break;
+    case BAND_HIGH:
+      *gainDB = pSettings->crossover.highGain;
+      *mute = pSettings->crossover.highMute;
+      break;
+  }
+}
+
 /**
   * @brief  Convert interleaved int16_t stereo samples to separate float arrays
   * @note   Assumes input buffer has 2*length elements (left/right interleaved)
@@ -512,10 +759,30 @@ static void ApplyGain(float *buffer, uint16_t length, float gainDB)
   */
 static void GetProcessingTime(void)
 {
-  processingEndTime = HAL_GetTick();
+  processingEndTime = DWT->CYCCNT;
+  
+  /* Calculate time in microseconds (cycle counter started by main()) */
+  audioStats.processingTime = (processingEndTime - processingStartTime) / (SystemCoreClock / 1000000U);
+}
+
+/**
+  * @brief  Pass the block time to the deadline monitor and apply its quality level
+  * @note   Runs between blocks, so a change takes effect with the next one
+  * @retval None
+  */
+static void UpdateQuality(void)
+{
+  uint8_t level = DspWatchdog_BlockDone(audioStats.processingTime);
+  
+  if (level == qualityLevel) {
+    return;
+  }
+  
+  /* 48 dB/oct filters run as 24 dB/oct below full quality (half the biquads) */
+  Crossover_SetOrderLimit((level >= DSP_QUALITY_REDUCED) ? FILTER_ORDER_24DB : FILTER_ORDER_48DB);
   
-  /* Calculate time in microseconds */
-  audioStats.processingTime = (processingEndTime - processingStartTime) * 1000;
+  qualityLevel = level;
+  meterBlocks = 0;
 }
 
 /************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -18,6 +18,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "button_handler.h"
+#include "input_queue.h"
 #include "gpio.h"
 #include "tim.h"
 
@@ -34,21 +35,11 @@ typedef struct {
   uint8_t         clickCount;       // For double-click detection
 } ButtonConfig_t;
 
-typedef struct {
-  ButtonEvent_t   events[BUTTON_QUEUE_SIZE];
-  uint8_t         head;
-  uint8_t         tail;
-  uint8_t         count;
-} ButtonEventQueue_t;
-
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
-#define IS_QUEUE_EMPTY(q)      ((q).count == 0)
-#define IS_QUEUE_FULL(q)       ((q).count >= BUTTON_QUEUE_SIZE)
 
 /* Private variables ---------------------------------------------------------*/
 static ButtonConfig_t buttons[MAX_BUTTONS];
-static ButtonEventQueue_t eventQueue;
 static volatile uint32_t buttonTick = 0;
 
 /* Private function prototypes -----------------------------------------------*/
@@ -105,11 +96,6 @@ void ButtonHandler_Init(void)
     buttons[i].clickCount = 0;
   }
   
-  /* Initialize event queue */
-  eventQueue.head = 0;
-  eventQueue.tail = 0;
-  eventQueue.count = 0;
-  
   /* Initialize tick counter */
   buttonTick = 0;
 }
@@ -169,27 +155,6 @@ void ButtonHandler_Sample(void)
   }
 }
 
-/**
-  * @brief  Get next button event from the queue
-  * @param  event: Pointer to event structure to fill
-  * @retval 1 if event available, 0 if queue is empty
-  */
-uint8_t ButtonHandler_GetEvent(ButtonEvent_t* event)
-{
-  if (IS_QUEUE_EMPTY(eventQueue)) {
-    return 0;  // No events available
-  }
-  
-  /* Get event from queue */
-  *event = eventQueue.events[eventQueue.tail];
-  
-  /* Update queue tail */
-  eventQueue.tail = (eventQueue.tail + 1) % BUTTON_QUEUE_SIZE;
-  eventQueue.count--;
-  
-  return 1;
-}
-
 /**
   * @brief  Check if a specific button is currently pressed
   * @param  button: Button ID to check
@@ -223,17 +188,6 @@ uint8_t ButtonHandler_IsHeld(ButtonID_t button)
   return 0;
 }
 
-/**
-  * @brief  Clear all pending button events
-  * @retval None
-  */
-void ButtonHandler_ClearEvents(void)
-{
-  eventQueue.head = 0;
-  eventQueue.tail = 0;
-  eventQueue.count = 0;
-}
-
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -272,7 +226,7 @@ static void ProcessButtonState(ButtonID_t button)
 }
 
 /**
-  * @brief  Push a button event to the queue
+  * @brief  Push a button event to the input queue
   * @param  button: Button ID
   * @param  state: Button state
   * @param  holdTime: How long the button was held (if applicable)
@@ -280,21 +234,8 @@ static void ProcessButtonState(ButtonID_t button)
   */
 static void PushEvent(ButtonID_t button, ButtonState_t state, uint32_t holdTime)
 {
-  /* Check if queue is full */
-  if (IS_QUEUE_FULL(eventQueue)) {
-    /* Queue is full, discard oldest event */
-    eventQueue.tail = (eventQueue.tail + 1) % BUTTON_QUEUE_SIZE;
-    eventQueue.count--;
-  }
-  
-  /* Add event to queue */
-  eventQueue.events[eventQueue.head].button = button;
-  eventQueue.events[eventQueue.head].state = state;
-  eventQueue.events[eventQueue.head].holdTime = holdTime;
-  
-  /* Update queue head */
-  eventQueue.head = (eventQueue.head + 1) % BUTTON_QUEUE_SIZE;
-  eventQueue.count++;
+  /* A full queue counts the event as dropped */
+  InputQueue_Push(INPUT_SOURCE_BUTTON, button, state, holdTime);
 }
 
 /**
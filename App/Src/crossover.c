@@ -19,6 +19,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "crossover.h"
 #include "main.h"
+#include "memory_manager.h"
 #include <math.h>
 #include <string.h>
 
@@ -101,32 +102,41 @@ typedef struct {
 /* Max filter order supported */
 #define MAX_FILTER_ORDER 8
 
+/* Number of filter chains and total biquad sections in the pool */
+#define NUM_FILTER_CHAINS   6
+#define SECTIONS_PER_CHAIN  (MAX_FILTER_ORDER/2)
+#define SECTIONS_PER_INSTANCE (NUM_FILTER_CHAINS * SECTIONS_PER_CHAIN)
+
 /* Private variables ---------------------------------------------------------*/
-static CrossoverFilters_t crossoverFilters;
-static CrossoverSettings_t currentSettings;
-
-/* Buffer for each band's processed audio */
-static float subBuffer[AUDIO_BUFFER_SIZE];
-static float lowBuffer[AUDIO_BUFFER_SIZE];
-static float midBuffer[AUDIO_BUFFER_SIZE];
-static float highBuffer[AUDIO_BUFFER_SIZE];
-
-/* Biquad filter instances */
-static BiquadFilter_t subLowPassFilters[MAX_FILTER_ORDER/2];
-static BiquadFilter_t lowLowPassFilters[MAX_FILTER_ORDER/2];
-static BiquadFilter_t lowHighPassFilters[MAX_FILTER_ORDER/2];
-static BiquadFilter_t midLowPassFilters[MAX_FILTER_ORDER/2];
-static BiquadFilter_t midHighPassFilters[MAX_FILTER_ORDER/2];
-static BiquadFilter_t highHighPassFilters[MAX_FILTER_ORDER/2];
+/* Filter bank instances: the active one plus one used to build the next
+   preset while crossfading. All calls operate on the selected instance. */
+static CrossoverFilters_t crossoverBank[CROSSOVER_NUM_INSTANCES];
+static CrossoverSettings_t bankSettings[CROSSOVER_NUM_INSTANCES];
+static uint8_t selectedInstance = 0;
+static CrossoverFilters_t* xover = &crossoverBank[0];
+static CrossoverSettings_t* currentSettings = &bankSettings[0];
+
+/* Highest filter order run by any instance (lowered under DSP overload) */
+static uint8_t orderLimit = MAX_FILTER_ORDER;
+
+/* Biquad filter pool (all chains of all instances), allocated from the memory arena */
+static BiquadFilter_t* filterPool = NULL;
+
+/* Float scratch for Crossover_ProcessI16, allocated from the memory arena */
+static float* scratchInput = NULL;
+static float* scratchOutput = NULL;
 
 /* Private function prototypes -----------------------------------------------*/
-static void CalculateFilterCoefficients(void);
+static void CalculateFilterCoefficients(uint8_t resetHistory);
+static void CalculatePointCoefficients(uint8_t point);
+static void ApplySettings(const CrossoverSettings_t* settings);
 static void CalculateButterworthCoefficients(BiquadFilter_t* filter, float frequency, float q, uint8_t type);
 static void CalculateLinkwitzRileyCoefficients(BiquadFilter_t* filter, float frequency, uint8_t type);
 static float ProcessBiquad(BiquadFilter_t* filter, float input);
 static float ProcessFilterChain(FilterChain_t* chain, float input);
 static void ResetFilter(BiquadFilter_t* filter);
 static void ResetAllFilters(void);
+static void InitInstance(BiquadFilter_t* sections);
 
 /* Exported functions --------------------------------------------------------*/
 /**
@@ -136,73 +146,61 @@ static void ResetAllFilters(void);
   */
 void Crossover_Init(void)
 {
-    // Initialize filter chains
-    crossoverFilters.subLowPass.filters = subLowPassFilters;
-    crossoverFilters.lowLowPass.filters = lowLowPassFilters;
-    crossoverFilters.lowHighPass.filters = lowHighPassFilters;
-    crossoverFilters.midLowPass.filters = midLowPassFilters;
-    crossoverFilters.midHighPass.filters = midHighPassFilters;
-    crossoverFilters.highHighPass.filters = highHighPassFilters;
-    
-    // Set default values
-    crossoverFilters.lowCutoff = DEFAULT_LOW_CUTOFF;
-    crossoverFilters.midCutoff = DEFAULT_MID_CUTOFF;
-    crossoverFilters.highCutoff = DEFAULT_HIGH_CUTOFF;
-    crossoverFilters.filterType = DEFAULT_FILTER_TYPE;
-    crossoverFilters.filterOrder = DEFAULT_FILTER_ORDER;
-    crossoverFilters.sampleRate = DEFAULT_SAMPLE_RATE;
-    
-    // Set default gains to 0dB (unity gain)
-    crossoverFilters.subGain = 1.0f;
-    crossoverFilters.lowGain = 1.0f;
-    crossoverFilters.midGain = 1.0f;
-    crossoverFilters.highGain = 1.0f;
-    
-    // No bands muted by default
-    crossoverFilters.subMute = 0;
-    crossoverFilters.lowMute = 0;
-    crossoverFilters.midMute = 0;
-    crossoverFilters.highMute = 0;
-    
-    // Set filter counts based on order
-    uint8_t filterCount = crossoverFilters.filterOrder / 2;
-    crossoverFilters.subLowPass.filterCount = filterCount;
-    crossoverFilters.lowLowPass.filterCount = filterCount;
-    crossoverFilters.lowHighPass.filterCount = filterCount;
-    crossoverFilters.midLowPass.filterCount = filterCount;
-    crossoverFilters.midHighPass.filterCount = filterCount;
-    crossoverFilters.highHighPass.filterCount = filterCount;
-    
-    // Reset all filters
-    ResetAllFilters();
-    
-    // Calculate initial filter coefficients
-    CalculateFilterCoefficients();
+    // Take filter state and scratch memory from the arena (first init only)
+    if (filterPool == NULL) {
+        filterPool = MemoryManager_AllocDSP("xover.biquads",
+                        CROSSOVER_NUM_INSTANCES * SECTIONS_PER_INSTANCE * sizeof(BiquadFilter_t));
+        scratchInput = MemoryManager_AllocDSP("xover.scratchIn",
+                        AUDIO_BUFFER_SIZE * sizeof(float));
+        scratchOutput = MemoryManager_AllocDSP("xover.scratchOut",
+                        AUDIO_BUFFER_SIZE * sizeof(float));
+        
+        if (filterPool == NULL || scratchInput == NULL || scratchOutput == NULL) {
+            Error_Handler();
+        }
+    }
     
-    // Store initial settings for UI
-    currentSettings.lowCutoff = crossoverFilters.lowCutoff;
-    currentSettings.midCutoff = crossoverFilters.midCutoff;
-    currentSettings.highCutoff = crossoverFilters.highCutoff;
-    currentSettings.subGain = LINEAR_TO_DB(crossoverFilters.subGain);
-    currentSettings.lowGain = LINEAR_TO_DB(crossoverFilters.lowGain);
-    currentSettings.midGain = LINEAR_TO_DB(crossoverFilters.midGain);
-    currentSettings.highGain = LINEAR_TO_DB(crossoverFilters.highGain);
-    currentSettings.filterType = crossoverFilters.filterType;
-    currentSettings.filterOrder = crossoverFilters.filterOrder;
-    currentSettings.subMute = crossoverFilters.subMute;
-    currentSettings.lowMute = crossoverFilters.lowMute;
-    currentSettings.midMute = crossoverFilters.midMute;
-    currentSettings.highMute = crossoverFilters.highMute;
+    // Initialize every instance with the defaults, then select the first
+    for (uint8_t instance = CROSSOVER_NUM_INSTANCES; instance-- > 0; ) {
+        Crossover_SelectInstance(instance);
+        InitInstance(&filterPool[instance * SECTIONS_PER_INSTANCE]);
+    }
     
     #ifdef DEBUG
     printf("Crossover module initialized\r\n");
     printf("Frequency Points: %.1f Hz, %.1f Hz, %.1f Hz\r\n", 
-           crossoverFilters.lowCutoff,
-           crossoverFilters.midCutoff,
-           crossoverFilters.highCutoff);
+           xover->lowCutoff,
+           xover->midCutoff,
+           xover->highCutoff);
     #endif
 }
 
+/**
+  * @brief  Select the filter bank instance used by all other calls
+  * @param  instance: Instance index (0 to CROSSOVER_NUM_INSTANCES-1)
+  * @retval None
+  */
+void Crossover_SelectInstance(uint8_t instance)
+{
+    if (instance >= CROSSOVER_NUM_INSTANCES) {
+        return;
+    }
+    
+    selectedInstance = instance;
+    xover = &crossoverBank[instance];
+    currentSettings = &bankSettings[instance];
+}
+
+/**
+  * @brief  Get the selected filter bank instance
+  * @param  None
+  * @retval Instance index
+  */
+uint8_t Crossover_GetInstance(void)
+{
+    return selectedInstance;
+}
+
 /**
   * @brief  Process audio through the crossover filters
   * @param  input: Pointer to input audio buffer
@@ -221,24 +219,24 @@ void Crossover_Process(float* input, float* subOut, float* lowOut, float* midOut
         float inputSample = input[i];
         
         // Process subwoofer band (low-pass filter)
-        float subSample = ProcessFilterChain(&crossoverFilters.subLowPass, inputSample);
+        float subSample = ProcessFilterChain(&xover->subLowPass, inputSample);
         
         // Process low band (band-pass filter - low-pass after high-pass)
-        float lowSample = ProcessFilterChain(&crossoverFilters.lowLowPass, 
-                          ProcessFilterChain(&crossoverFilters.lowHighPass, inputSample));
+        float lowSample = ProcessFilterChain(&xover->lowLowPass, 
+                          ProcessFilterChain(&xover->lowHighPass, inputSample));
         
         // Process mid band (band-pass filter - low-pass after high-pass)
-        float midSample = ProcessFilterChain(&crossoverFilters.midLowPass, 
-                          ProcessFilterChain(&crossoverFilters.midHighPass, inputSample));
+        float midSample = ProcessFilterChain(&xover->midLowPass, 
+                          ProcessFilterChain(&xover->midHighPass, inputSample));
         
         // Process high band (high-pass filter)
-        float highSample = ProcessFilterChain(&crossoverFilters.highHighPass, inputSample);
+        float highSample = ProcessFilterChain(&xover->highHighPass, inputSample);
         
         // Apply gain and mute to each band
-        subSample = crossoverFilters.subMute ? 0.0f : subSample * crossoverFilters.subGain;
-        lowSample = crossoverFilters.lowMute ? 0.0f : lowSample * crossoverFilters.lowGain;
-        midSample = crossoverFilters.midMute ? 0.0f : midSample * crossoverFilters.midGain;
-        highSample = crossoverFilters.highMute ? 0.0f : highSample * crossoverFilters.highGain;
+        subSample = xover->subMute ? 0.0f : subSample * xover->subGain;
+        lowSample = xover->lowMute ? 0.0f : lowSample * xover->lowGain;
+        midSample = xover->midMute ? 0.0f : midSample * xover->midGain;
+        highSample = xover->highMute ? 0.0f : highSample * xover->highGain;
         
         // Store individual band outputs if pointers are provided
         if (subOut != NULL) subOut[i] = subSample;
@@ -250,12 +248,6 @@ void Crossover_Process(float* input, float* subOut, float* lowOut, float* midOut
         if (output != NULL) {
             output[i] = subSample + lowSample + midSample + highSample;
         }
-        
-        // Store results in internal buffers for other modules to access
-        subBuffer[i] = subSample;
-        lowBuffer[i] = lowSample;
-        midBuffer[i] = midSample;
-        highBuffer[i] = highSample;
     }
 }
 
@@ -268,8 +260,13 @@ void Crossover_Process(float* input, float* subOut, float* lowOut, float* midOut
   */
 void Crossover_ProcessI16(int16_t* input, int16_t* output, uint16_t size)
 {
-    float floatInput[AUDIO_BUFFER_SIZE];
-    float floatOutput[AUDIO_BUFFER_SIZE];
+    float* floatInput = scratchInput;
+    float* floatOutput = scratchOutput;
+    
+    // Scratch buffers hold at most one audio block
+    if (size > AUDIO_BUFFER_SIZE) {
+        size = AUDIO_BUFFER_SIZE;
+    }
     
     // Convert int16_t to float
     for (uint16_t i = 0; i < size; i++) {
@@ -291,22 +288,6 @@ void Crossover_ProcessI16(int16_t* input, int16_t* output, uint16_t size)
     }
 }
 
-/**
-  * @brief  Get band-specific output buffers
-  * @param  band: Band to get (0: Sub, 1: Low, 2: Mid, 3: High)
-  * @retval Pointer to the band's output buffer
-  */
-float* Crossover_GetBandOutput(uint8_t band)
-{
-    switch (band) {
-        case 0: return subBuffer;
-        case 1: return lowBuffer;
-        case 2: return midBuffer;
-        case 3: return highBuffer;
-        default: return NULL;
-    }
-}
-
 /**
   * @brief  Set crossover settings
   * @param  settings: Pointer to settings structure
@@ -314,45 +295,107 @@ float* Crossover_GetBandOutput(uint8_t band)
   */
 void Crossover_SetSettings(CrossoverSettings_t* settings)
 {
-    // Update current settings
-    memcpy(&currentSettings, settings, sizeof(CrossoverSettings_t));
-    
     // Apply settings to internal filter structures
-    crossoverFilters.lowCutoff = settings->lowCutoff;
-    crossoverFilters.midCutoff = settings->midCutoff;
-    crossoverFilters.highCutoff = settings->highCutoff;
-    crossoverFilters.subGain = DB_TO_LINEAR(settings->subGain);
-    crossoverFilters.lowGain = DB_TO_LINEAR(settings->lowGain);
-    crossoverFilters.midGain = DB_TO_LINEAR(settings->midGain);
-    crossoverFilters.highGain = DB_TO_LINEAR(settings->highGain);
-    crossoverFilters.filterType = settings->filterType;
-    crossoverFilters.filterOrder = settings->filterOrder;
-    crossoverFilters.subMute = settings->subMute;
-    crossoverFilters.lowMute = settings->lowMute;
-    crossoverFilters.midMute = settings->midMute;
-    crossoverFilters.highMute = settings->highMute;
-    
-    // Update filter counts based on order
-    uint8_t filterCount = crossoverFilters.filterOrder / 2;
-    crossoverFilters.subLowPass.filterCount = filterCount;
-    crossoverFilters.lowLowPass.filterCount = filterCount;
-    crossoverFilters.lowHighPass.filterCount = filterCount;
-    crossoverFilters.midLowPass.filterCount = filterCount;
-    crossoverFilters.midHighPass.filterCount = filterCount;
-    crossoverFilters.highHighPass.filterCount = filterCount;
+    ApplySettings(settings);
     
     // Recalculate filter coefficients
-    CalculateFilterCoefficients();
+    CalculateFilterCoefficients(1);
     
     #ifdef DEBUG
     printf("Crossover settings updated\r\n");
     printf("Frequency Points: %.1f Hz, %.1f Hz, %.1f Hz\r\n", 
-           crossoverFilters.lowCutoff,
-           crossoverFilters.midCutoff,
-           crossoverFilters.highCutoff);
+           xover->lowCutoff,
+           xover->midCutoff,
+           xover->highCutoff);
     #endif
 }
 
+/**
+  * @brief  Update cutoffs, gains and mutes while audio is running
+  * @note   Filter history is kept, so small steps (e.g. while morphing
+  *         between presets) do not click. A change of filter type or order
+  *         changes the filter structure and falls back to Crossover_SetSettings().
+  * @param  settings: Pointer to settings structure
+  * @retval None
+  */
+void Crossover_UpdateCoefficients(CrossoverSettings_t* settings)
+{
+    if (settings->filterType != currentSettings->filterType ||
+        settings->filterOrder != currentSettings->filterOrder) {
+        Crossover_SetSettings(settings);
+        return;
+    }
+    
+    ApplySettings(settings);
+    CalculateFilterCoefficients(0);
+}
+
+/**
+  * @brief  Set the cutoff frequency for one crossover point
+  * @note   Only the low-pass and high-pass chains at this point are
+  *         recomputed (a third of the filter bank); filter history is kept
+  * @param  point: Crossover point (0: low, 1: mid, 2: high)
+  * @param  frequency: Cutoff frequency in Hz
+  * @retval None
+  */
+void Crossover_SetCutoff(uint8_t point, float frequency)
+{
+    switch (point) {
+        case CROSSOVER_POINT_LOW:
+            xover->lowCutoff = frequency;
+            currentSettings->lowCutoff = frequency;
+            break;
+        case CROSSOVER_POINT_MID:
+            xover->midCutoff = frequency;
+            currentSettings->midCutoff = frequency;
+            break;
+        case CROSSOVER_POINT_HIGH:
+            xover->highCutoff = frequency;
+            currentSettings->highCutoff = frequency;
+            break;
+        default:
+            return;
+    }
+    
+    CalculatePointCoefficients(point);
+}
+
+/**
+  * @brief  Set the gain for a specific frequency band (no coefficient update)
+  * @param  band: Band index (0: sub, 1: low, 2: mid, 3: high)
+  * @param  gainDB: Gain value in dB
+  * @retval None
+  */
+void Crossover_SetGain(uint8_t band, float gainDB)
+{
+    float gain = DB_TO_LINEAR(gainDB);
+    
+    switch (band) {
+        case 0: xover->subGain = gain;  currentSettings->subGain = gainDB;  break;
+        case 1: xover->lowGain = gain;  currentSettings->lowGain = gainDB;  break;
+        case 2: xover->midGain = gain;  currentSettings->midGain = gainDB;  break;
+        case 3: xover->highGain = gain; currentSettings->highGain = gainDB; break;
+        default: break;
+    }
+}
+
+/**
+  * @brief  Set mute state for a specific frequency band (no coefficient update)
+  * @param  band: Band index (0: sub, 1: low, 2: mid, 3: high)
+  * @param  mute: Mute state (1: muted, 0: active)
+  * @retval None
+  */
+void Crossover_SetMute(uint8_t band, uint8_t mute)
+{
+    switch (band) {
+        case 0: xover->subMute = mute;  currentSettings->subMute = mute;  break;
+        case 1: xover->lowMute = mute;  currentSettings->lowMute = mute;  break;
+        case 2: xover->midMute = mute;  currentSettings->midMute = mute;  break;
+        case 3: xover->highMute = mute; currentSettings->highMute = mute; break;
+        default: break;
+    }
+}
+
 /**
   * @brief  Get current crossover settings
   * @param  settings: Pointer to settings structure to fill
@@ -361,7 +404,7 @@ void Crossover_SetSettings(CrossoverSettings_t* settings)
 void Crossover_GetSettings(CrossoverSettings_t* settings)
 {
     // Copy current settings to output structure
-    memcpy(settings, &currentSettings, sizeof(CrossoverSettings_t));
+    memcpy(settings, currentSettings, sizeof(CrossoverSettings_t));
 }
 
 /**
@@ -372,42 +415,209 @@ void Crossover_GetSettings(CrossoverSettings_t* settings)
 void Crossover_SetSampleRate(float sampleRate)
 {
     // Update sample rate
-    crossoverFilters.sampleRate = sampleRate;
+    xover->sampleRate = sampleRate;
     
     // Recalculate filter coefficients with new sample rate
-    CalculateFilterCoefficients();
+    CalculateFilterCoefficients(1);
     
     #ifdef DEBUG
     printf("Crossover sample rate updated to %.1f Hz\r\n", sampleRate);
     #endif
 }
 
+/**
+  * @brief  Limit the filter order of all instances
+  * @param  maxOrder: Highest order to run (FILTER_ORDER_48DB: no limit)
+  * @retval None
+  */
+void Crossover_SetOrderLimit(uint8_t maxOrder)
+{
+    uint8_t previousInstance = selectedInstance;
+    CrossoverSettings_t settings;
+    
+    orderLimit = maxOrder;
+    
+    // Rebuild only the instances whose running order changes
+    for (uint8_t instance = 0; instance < CROSSOVER_NUM_INSTANCES; instance++) {
+        Crossover_SelectInstance(instance);
+        if (xover->filterOrder == MIN(currentSettings->filterOrder, orderLimit)) {
+            continue;
+        }
+        
+        memcpy(&settings, currentSettings, sizeof(CrossoverSettings_t));
+        ApplySettings(&settings);
+        CalculateFilterCoefficients(1);
+    }
+    
+    Crossover_SelectInstance(previousInstance);
+}
+
 /* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Set up the selected instance with default settings
+  * @param  sections: Biquad sections reserved for this instance
+  * @retval None
+  */
+static void InitInstance(BiquadFilter_t* sections)
+{
+    // Initialize filter chains
+    xover->subLowPass.filters = &sections[0 * SECTIONS_PER_CHAIN];
+    xover->lowLowPass.filters = &sections[1 * SECTIONS_PER_CHAIN];
+    xover->lowHighPass.filters = &sections[2 * SECTIONS_PER_CHAIN];
+    xover->midLowPass.filters = &sections[3 * SECTIONS_PER_CHAIN];
+    xover->midHighPass.filters = &sections[4 * SECTIONS_PER_CHAIN];
+    xover->highHighPass.filters = &sections[5 * SECTIONS_PER_CHAIN];
+    
+    // Set default values
+    xover->lowCutoff = DEFAULT_LOW_CUTOFF;
+    xover->midCutoff = DEFAULT_MID_CUTOFF;
+    xover->highCutoff = DEFAULT_HIGH_CUTOFF;
+    xover->filterType = DEFAULT_FILTER_TYPE;
+    xover->filterOrder = DEFAULT_FILTER_ORDER;
+    xover->sampleRate = DEFAULT_SAMPLE_RATE;
+    
+    // Set default gains to 0dB (unity gain)
+    xover->subGain = 1.0f;
+    xover->lowGain = 1.0f;
+    xover->midGain = 1.0f;
+    xover->highGain = 1.0f;
+    
+    // No bands muted by default
+    xover->subMute = 0;
+    xover->lowMute = 0;
+    xover->midMute = 0;
+    xover->highMute = 0;
+    
+    // Set filter counts based on order
+    uint8_t filterCount = xover->filterOrder / 2;
+    xover->subLowPass.filterCount = filterCount;
+    xover->lowLowPass.filterCount = filterCount;
+    xover->lowHighPass.filterCount = filterCount;
+    xover->midLowPass.filterCount = filterCount;
+    xover->midHighPass.filterCount = filterCount;
+    xover->highHighPass.filterCount = filterCount;
+    
+    // Reset all filters
+    ResetAllFilters();
+    
+    // Calculate initial filter coefficients
+    CalculateFilterCoefficients(1);
+    
+    // Store initial settings for UI
+    currentSettings->lowCutoff = xover->lowCutoff;
+    currentSettings->midCutoff = xover->midCutoff;
+    currentSettings->highCutoff = xover->highCutoff;
+    currentSettings->subGain = LINEAR_TO_DB(xover->subGain);
+    currentSettings->lowGain = LINEAR_TO_DB(xover->lowGain);
+    currentSettings->midGain = LINEAR_TO_DB(xover->midGain);
+    currentSettings->highGain = LINEAR_TO_DB(xover->highGain);
+    currentSettings->filterType = xover->filterType;
+    currentSettings->filterOrder = xover->filterOrder;
+    currentSettings->subMute = xover->subMute;
+    currentSettings->lowMute = xover->lowMute;
+    currentSettings->midMute = xover->midMute;
+    currentSettings->highMute = xover->highMute;
+}
+
+/**
+  * @brief  Copy settings into the selected instance (no coefficient update)
+  * @param  settings: Pointer to settings structure
+  * @retval None
+  */
+static void ApplySettings(const CrossoverSettings_t* settings)
+{
+    // Update current settings
+    memcpy(currentSettings, settings, sizeof(CrossoverSettings_t));
+    
+    xover->lowCutoff = settings->lowCutoff;
+    xover->midCutoff = settings->midCutoff;
+    xover->highCutoff = settings->highCutoff;
+    xover->subGain = DB_TO_LINEAR(settings->subGain);
+    xover->lowGain = DB_TO_LINEAR(settings->lowGain);
+    xover->midGain = DB_TO_LINEAR(settings->midGain);
+    xover->highGain = DB_TO_LINEAR(settings->highGain);
+    xover->filterType = settings->filterType;
+    xover->filterOrder = MIN(settings->filterOrder, orderLimit);
+    xover->subMute = settings->subMute;
+    xover->lowMute = settings->lowMute;
+    xover->midMute = settings->midMute;
+    xover->highMute = settings->highMute;
+    
+    // Update filter counts based on order
+    uint8_t filterCount = xover->filterOrder / 2;
+    xover->subLowPass.filterCount = filterCount;
+    xover->lowLowPass.filterCount = filterCount;
+    xover->lowHighPass.filterCount = filterCount;
+    xover->midLowPass.filterCount = filterCount;
+    xover->midHighPass.filterCount = filterCount;
+    xover->highHighPass.filterCount = filterCount;
+}
+
 /**
   * @brief  Calculate coefficients for all crossover filters
-  * @param  None
+  * @param  resetHistory: 1 to clear the filter history first
   * @retval None
   */
-static void CalculateFilterCoefficients(void)
+static void CalculateFilterCoefficients(uint8_t resetHistory)
 {
-    uint8_t i;
-    float q;
+    uint8_t point;
     
     // Reset all filters before recalculating
-    ResetAllFilters();
+    if (resetHistory) {
+        ResetAllFilters();
+    }
+    
+    for (point = 0; point < CROSSOVER_NUM_POINTS; point++) {
+        CalculatePointCoefficients(point);
+    }
+}
+
+/**
+  * @brief  Calculate coefficients for the two filter chains at one crossover point
+  * @note   Each cutoff is shared by the low-pass below it and the high-pass
+  *         above it; no other chain depends on it
+  * @param  point: Crossover point (CROSSOVER_POINT_LOW, _MID or _HIGH)
+  * @retval None
+  */
+static void CalculatePointCoefficients(uint8_t point)
+{
+    FilterChain_t* lowPass;
+    FilterChain_t* highPass;
+    float frequency;
+    uint8_t i;
+    
+    switch (point) {
+        case CROSSOVER_POINT_LOW:
+            lowPass = &xover->subLowPass;
+            highPass = &xover->lowHighPass;
+            frequency = xover->lowCutoff;
+            break;
+        case CROSSOVER_POINT_MID:
+            lowPass = &xover->lowLowPass;
+            highPass = &xover->midHighPass;
+            frequency = xover->midCutoff;
+            break;
+        case CROSSOVER_POINT_HIGH:
+            lowPass = &xover->midLowPass;
+            highPass = &xover->highHighPass;
+            frequency = xover->highCutoff;
+            break;
+        default:
+            return;
+    }
     
     // For Butterworth filter cascade
-    if (crossoverFilters.filterType == 0) {
+    if (xover->filterType == 0) {
         // Q values for Butterworth filters depend on filter order
-        float qValues2[] = {0.7071f};                       // 2nd order
-        float qValues4[] = {0.5412f, 1.3066f};              // 4th order
-        float qValues8[] = {0.5098f, 0.6013f, 0.9000f, 1.7412f}; // 8th order
+        static const float qValues2[] = {0.7071f};                       // 2nd order
+        static const float qValues4[] = {0.5412f, 1.3066f};              // 4th order
+        static const float qValues8[] = {0.5098f, 0.6013f, 0.9000f, 1.7412f}; // 8th order
         
-        float* qValues;
-        uint8_t numFilters = crossoverFilters.filterOrder / 2;
+        const float* qValues;
+        uint8_t numFilters = xover->filterOrder / 2;
         
         // Select appropriate Q values based on filter order
-        switch (crossoverFilters.filterOrder) {
+        switch (xover->filterOrder) {
             case 2:  qValues = qValues2; break;
             case 4:  qValues = qValues4; break;
             case 8:  qValues = qValues8; break;
@@ -416,54 +626,18 @@ static void CalculateFilterCoefficients(void)
         
         // Calculate Butterworth filter coefficients for each stage
         for (i = 0; i < numFilters; i++) {
-            q = qValues[i];
-            
-            // Subwoofer low-pass
-            CalculateButterworthCoefficients(&crossoverFilters.subLowPass.filters[i], 
-                                           crossoverFilters.lowCutoff, q, 0);  // 0 = LP
-            
-            // Low band high-pass and low-pass
-            CalculateButterworthCoefficients(&crossoverFilters.lowHighPass.filters[i], 
-                                           crossoverFilters.lowCutoff, q, 1);  // 1 = HP
-            CalculateButterworthCoefficients(&crossoverFilters.lowLowPass.filters[i], 
-                                           crossoverFilters.midCutoff, q, 0);  // 0 = LP
-            
-            // Mid band high-pass and low-pass
-            CalculateButterworthCoefficients(&crossoverFilters.midHighPass.filters[i], 
-                                           crossoverFilters.midCutoff, q, 1);  // 1 = HP
-            CalculateButterworthCoefficients(&crossoverFilters.midLowPass.filters[i], 
-                                           crossoverFilters.highCutoff, q, 0); // 0 = LP
-            
-            // High band high-pass
-            CalculateButterworthCoefficients(&crossoverFilters.highHighPass.filters[i], 
-                                           crossoverFilters.highCutoff, q, 1); // 1 = HP
+            CalculateButterworthCoefficients(&lowPass->filters[i], frequency, qValues[i], 0);  // 0 = LP
+            CalculateButterworthCoefficients(&highPass->filters[i], frequency, qValues[i], 1); // 1 = HP
         }
     }
     // For Linkwitz-Riley filter cascade
     else {
-        uint8_t numFilters = crossoverFilters.filterOrder / 4; // LR filters are always even order
+        uint8_t numFilters = xover->filterOrder / 4; // LR filters are always even order
         
         // Each Linkwitz-Riley filter is a cascade of identical Butterworth filters
         for (i = 0; i < numFilters; i++) {
-            // Subwoofer low-pass
-            CalculateLinkwitzRileyCoefficients(&crossoverFilters.subLowPass.filters[i], 
-                                            crossoverFilters.lowCutoff, 0);  // 0 = LP
-            
-            // Low band high-pass and low-pass
-            CalculateLinkwitzRileyCoefficients(&crossoverFilters.lowHighPass.filters[i], 
-                                            crossoverFilters.lowCutoff, 1);  // 1 = HP
-            CalculateLinkwitzRileyCoefficients(&crossoverFilters.lowLowPass.filters[i], 
-                                            crossoverFilters.midCutoff, 0);  // 0 = LP
-            
-            // Mid band high-pass and low-pass
-            CalculateLinkwitzRileyCoefficients(&crossoverFilters.midHighPass.filters[i], 
-                                            crossoverFilters.midCutoff, 1);  // 1 = HP
-            CalculateLinkwitzRileyCoefficients(&crossoverFilters.midLowPass.filters[i], 
-                                            crossoverFilters.highCutoff, 0); // 0 = LP
-            
-            // High band high-pass
-            CalculateLinkwitzRileyCoefficients(&crossoverFilters.highHighPass.filters[i], 
-                                            crossoverFilters.highCutoff, 1); // 1 = HP
+            CalculateLinkwitzRileyCoefficients(&lowPass->filters[i], frequency, 0);  // 0 = LP
+            CalculateLinkwitzRileyCoefficients(&highPass->filters[i], frequency, 1); // 1 = HP
         }
     }
 }
@@ -478,7 +652,7 @@ static void CalculateFilterCoefficients(void)
   */
 static void CalculateButterworthCoefficients(BiquadFilter_t* filter, float frequency, float q, uint8_t type)
 {
-    float omega = 2.0f * PI * frequency / crossoverFilters.sampleRate;
+    float omega = 2.0f * PI * frequency / xover->sampleRate;
     float alpha = sinf(omega) / (2.0f * q);
     float cosw = cosf(omega);
     float a0, a1, a2, b0, b1, b2;
@@ -582,23 +756,12 @@ static void ResetFilter(BiquadFilter_t* filter)
 static void ResetAllFilters(void)
 {
     uint8_t i;
-    uint8_t maxFilters = MAX_FILTER_ORDER / 2;
-    
-    // Reset all filter states
-    for (i = 0; i < maxFilters; i++) {
-        ResetFilter(&subLowPassFilters[i]);
-        ResetFilter(&lowLowPassFilters[i]);
-        ResetFilter(&lowHighPassFilters[i]);
-        ResetFilter(&midLowPassFilters[i]);
-        ResetFilter(&midHighPassFilters[i]);
-        ResetFilter(&highHighPassFilters[i]);
-    }
+    BiquadFilter_t* sections = &filterPool[selectedInstance * SECTIONS_PER_INSTANCE];
     
-    // Reset all internal buffers
-    memset(subBuffer, 0, sizeof(subBuffer));
-    memset(lowBuffer, 0, sizeof(lowBuffer));
-    memset(midBuffer, 0, sizeof(midBuffer));
-    memset(highBuffer, 0, sizeof(highBuffer));
+    // Reset all filter states of the selected instance
+    for (i = 0; i < SECTIONS_PER_INSTANCE; i++) {
+        ResetFilter(&sections[i]);
+    }
 }
 
 /************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -19,6 +19,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "delay.h"
+#include "memory_manager.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -29,6 +30,9 @@
 /* Private variables ---------------------------------------------------------*/
 static Delay_t delayInstance;
 
+/* Backing storage for all delay lines, allocated from the memory arena */
+static int16_t *delayMemory = NULL;
+
 /* Private function prototypes -----------------------------------------------*/
 static void Delay_UpdateParameters(void);
 static int16_t Delay_GetSample(uint8_t channel, uint16_t index);
@@ -41,9 +45,22 @@ static int16_t Delay_GetSample(uint8_t channel, uint16_t index);
   */
 void Delay_Init(void)
 {
+  /* Allocate delay lines once; re-initialization reuses the same block */
+  if (delayMemory == NULL) {
+    delayMemory = MemoryManager_AllocDSP("delay.lines",
+                    DELAY_NUM_CHANNELS * DELAY_BUFFER_SIZE * sizeof(int16_t));
+    if (delayMemory == NULL) {
+      Error_Handler();
+    }
+  }
+  
   /* Initialize delay instance */
   memset(&delayInstance, 0, sizeof(Delay_t));
   
+  for (uint8_t ch = 0; ch < DELAY_NUM_CHANNELS; ch++) {
+    delayInstance.buffer[ch] = &delayMemory[ch * DELAY_BUFFER_SIZE];
+  }
+  
   /* Set default values */
   for (uint8_t i = 0; i < DELAY_NUM_CHANNELS; i++) {
     delayInstance.delaySamples[i] = 0.0f;
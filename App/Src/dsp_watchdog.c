@@ -0,0 +1,185 @@
+ /**
+  ******************************************************************************
+  * @file           : dsp_watchdog.c
+  * @brief          : Audio block deadline monitor with quality step-down
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * A block that is not processed within the block period is not noticed by
+  * the I2S DMA: it plays the previous output again. Every block time is
+  * compared with the budget here instead. DSP_WATCHDOG_MISS_LIMIT overruns
+  * close together lower the quality one level; the audio chain sheds the
+  * work of that level (audio_processing.c). Once blocks have run well below
+  * the budget for a while the quality goes back up one level at a time.
+  *
+  * The block times at a lowered level do not include the shed work, so the
+  * restore threshold is well below the budget. If a restored level overruns
+  * again soon, the next restore waits twice as long, so a steady overload
+  * does not toggle the quality every few seconds.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_watchdog.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static DspWatchdogStats_t watchdogStats;
+static uint32_t budgetUs = 0;
+static uint32_t missCount = 0;          /* Overruns since the count last started */
+static uint32_t cleanBlocks = 0;        /* Blocks since the last overrun */
+static uint32_t headroomBlocks = 0;     /* Blocks in a row below the restore threshold */
+static uint32_t sinceRestore = 0;       /* Blocks since the last restore */
+static uint32_t backoff = 1;            /* Restore wait multiplier */
+
+/* Private function prototypes -----------------------------------------------*/
+static void StepDown(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize the monitor at full quality and clear the statistics
+  * @param  blockPeriodUs Audio block period in us
+  * @retval None
+  */
+void DspWatchdog_Init(uint32_t blockPeriodUs)
+{
+  memset(&watchdogStats, 0, sizeof(watchdogStats));
+  watchdogStats.level = DSP_QUALITY_FULL;
+
+  budgetUs = blockPeriodUs * DSP_WATCHDOG_BUDGET_PERCENT / 100;
+  missCount = 0;
+  cleanBlocks = 0;
+  headroomBlocks = 0;
+  sinceRestore = 0;
+  backoff = 1;
+}
+
+/**
+  * @brief  Account for a processed block
+  * @param  blockUs Processing time of the block in us
+  * @retval DSP_QUALITY_* to use from the next block on
+  */
+uint8_t DspWatchdog_BlockDone(uint32_t blockUs)
+{
+  if (blockUs > watchdogStats.worstUs) {
+    watchdogStats.worstUs = blockUs;
+  }
+  if (sinceRestore < DSP_WATCHDOG_RESTORE_BLOCKS * DSP_WATCHDOG_MAX_BACKOFF) {
+    sinceRestore++;
+  }
+
+  if (blockUs > budgetUs) {
+    watchdogStats.overruns++;
+    missCount++;
+    cleanBlocks = 0;
+    headroomBlocks = 0;
+
+    if (missCount >= DSP_WATCHDOG_MISS_LIMIT && watchdogStats.level < DSP_QUALITY_LOWEST) {
+      StepDown();
+    }
+    return (uint8_t)watchdogStats.level;
+  }
+
+  /* Isolated overruns far apart do not add up */
+  if (++cleanBlocks >= DSP_WATCHDOG_FORGIVE_BLOCKS) {
+    missCount = 0;
+  }
+
+  if (blockUs < budgetUs * DSP_WATCHDOG_RESTORE_PERCENT / 100) {
+    headroomBlocks++;
+  } else {
+    headroomBlocks = 0;
+  }
+
+  if (watchdogStats.level > DSP_QUALITY_FULL &&
+      headroomBlocks >= DSP_WATCHDOG_RESTORE_BLOCKS * backoff) {
+    watchdogStats.level--;
+    watchdogStats.restores++;
+    headroomBlocks = 0;
+    sinceRestore = 0;
+    missCount = 0;
+  }
+
+  return (uint8_t)watchdogStats.level;
+}
+
+/**
+  * @brief  Get the quality level in effect
+  * @retval DSP_QUALITY_*
+  */
+uint8_t DspWatchdog_GetLevel(void)
+{
+  return (uint8_t)watchdogStats.level;
+}
+
+/**
+  * @brief  Set an artificial load added to every block
+  * @param  loadUs Busy time per block in us, 0 to stop
+  * @retval Load in effect
+  */
+uint32_t DspWatchdog_SetTestLoad(uint32_t loadUs)
+{
+  watchdogStats.testLoadUs = MIN(loadUs, DSP_WATCHDOG_MAX_TEST_LOAD_US);
+  return watchdogStats.testLoadUs;
+}
+
+/**
+  * @brief  Spend the artificial load, if any
+  * @retval None
+  */
+void DspWatchdog_ApplyTestLoad(void)
+{
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles = watchdogStats.testLoadUs * (SystemCoreClock / 1000000U);
+
+  while (DWT->CYCCNT - start < cycles) {
+  }
+}
+
+/**
+  * @brief  Get the deadline statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void DspWatchdog_GetStats(DspWatchdogStats_t *stats)
+{
+  memcpy(stats, &watchdogStats, sizeof(DspWatchdogStats_t));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Lower the quality one level
+  * @retval None
+  */
+static void StepDown(void)
+{
+  /* A restored level that fails again within its wait waits longer next time */
+  if (watchdogStats.restores > 0 && sinceRestore < DSP_WATCHDOG_RESTORE_BLOCKS * backoff) {
+    backoff = MIN(backoff * 2, DSP_WATCHDOG_MAX_BACKOFF);
+  } else {
+    backoff = 1;
+  }
+
+  watchdogStats.level++;
+  watchdogStats.stepDowns++;
+  missCount = 0;
+  headroomBlocks = 0;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
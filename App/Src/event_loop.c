@@ -0,0 +1,205 @@
+ /**
+  ******************************************************************************
+  * @file           : event_loop.c
+  * @brief          : Event flags, sleep and idle accounting for the main loop
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Interrupts post what the main loop has to do (an I2S block, the 1 ms
+  * tick, a queued input event, the UI refresh period). The scheduler
+  * (scheduler.c) takes the events and runs the tasks they trigger in
+  * priority order, so a new audio block always goes before host and UI
+  * work. With nothing pending the core sleeps in WFI until the next
+  * interrupt.
+  *
+  * The cycles spent asleep are counted per window; the idle share of the
+  * last window and the lowest share seen are the headroom left for DSP.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "event_loop.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static volatile uint32_t pendingEvents = 0;
+static volatile uint32_t postTime[EVENT_COUNT];   /* DWT->CYCCNT of the first post */
+
+static EventLoopStats_t loopStats;
+static uint32_t windowStart = 0;
+static uint32_t windowIdle = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void CloseWindow(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Clear pending events and statistics, start the idle accounting
+  * @retval None
+  */
+void EventLoop_Init(void)
+{
+  pendingEvents = 0;
+  memset(&loopStats, 0, sizeof(loopStats));
+  loopStats.idlePermille = 1000;
+  loopStats.minIdlePermille = 1000;
+  windowStart = DWT->CYCCNT;
+  windowIdle = 0;
+}
+
+/**
+  * @brief  Post events
+  * @param  events EVENT_* flags
+  * @retval None
+  */
+void EventLoop_Post(uint32_t events)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now = DWT->CYCCNT;
+  uint32_t fresh;
+  uint8_t i;
+
+  __disable_irq();
+  fresh = events & ~pendingEvents;
+  for (i = 0; fresh != 0 && i < EVENT_COUNT; i++, fresh >>= 1) {
+    if (fresh & 1U) {
+      postTime[i] = now;
+    }
+  }
+  pendingEvents |= events;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Get the time an event was posted
+  * @param  event One EVENT_* flag
+  * @retval DWT cycle count
+  */
+uint32_t EventLoop_PostTime(uint32_t event)
+{
+  uint8_t i;
+
+  for (i = 0; i < EVENT_COUNT; i++) {
+    if (event & (1U << i)) {
+      return postTime[i];
+    }
+  }
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief  Take pending events
+  * @param  mask EVENT_* flags to take
+  * @retval The flags of mask that were pending (now cleared)
+  */
+uint32_t EventLoop_Take(uint32_t mask)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t taken;
+
+  __disable_irq();
+  taken = pendingEvents & mask;
+  pendingEvents &= ~taken;
+  __set_PRIMASK(primask);
+
+  /* Also here, so a loop too busy to sleep still reports its load */
+  CloseWindow();
+
+  return taken;
+}
+
+/**
+  * @brief  Check for pending events without taking them
+  * @param  mask EVENT_* flags
+  * @retval The flags of mask that are pending
+  */
+uint32_t EventLoop_Pending(uint32_t mask)
+{
+  return pendingEvents & mask;
+}
+
+/**
+  * @brief  Sleep until an event is posted
+  * @retval None
+  */
+void EventLoop_Sleep(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if (pendingEvents == 0) {
+    uint32_t start = DWT->CYCCNT;
+
+#if EVENT_LOOP_USE_WFI
+    /* Wakes on any interrupt, even masked; it runs once the mask is lifted */
+    __DSB();
+    __WFI();
+#else
+    /* Let interrupts in until one posts */
+    __set_PRIMASK(primask);
+    while (pendingEvents == 0) {
+    }
+    __disable_irq();
+#endif
+
+    windowIdle += DWT->CYCCNT - start;
+    loopStats.wakeups++;
+  }
+  __set_PRIMASK(primask);
+
+  CloseWindow();
+}
+
+/**
+  * @brief  Get main loop load statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void EventLoop_GetStats(EventLoopStats_t *stats)
+{
+  memcpy(stats, &loopStats, sizeof(EventLoopStats_t));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Publish the idle share once the accounting window has passed
+  * @retval None
+  */
+static void CloseWindow(void)
+{
+  uint32_t elapsed = DWT->CYCCNT - windowStart;
+  uint32_t idle;
+
+  if (elapsed < (SystemCoreClock / 1000) * EVENT_LOOP_WINDOW_MS) {
+    return;
+  }
+
+  loopStats.idleCycles = windowIdle;
+  loopStats.windowCycles = elapsed;
+  idle = windowIdle / (elapsed / 1000);
+  loopStats.idlePermille = (uint16_t)MIN(idle, 1000);
+  if (loopStats.idlePermille < loopStats.minIdlePermille) {
+    loopStats.minIdlePermille = loopStats.idlePermille;
+  }
+
+  windowStart += elapsed;
+  windowIdle = 0;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,192 @@
+ /**
+  ******************************************************************************
+  * @file           : fixed_format.c
+  * @brief          : Integer-only number formatting for the display
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Parameters are kept as scaled integers (gain in dB x10, cutoff in Hz, ...),
+  * so the display never needs floating point. Formatting them here instead
+  * of with snprintf keeps printf and its float support out of the UI path:
+  * a value is a division loop and a few copies.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fixed_format.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Longest number: sign, 10 digits, point */
+#define NUMBER_MAX_LENGTH          12
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const uint16_t powersOfTen[FIXED_FORMAT_MAX_DECIMALS + 1] = {1, 10, 100, 1000};
+
+static const FixedFormat_t plainFormat = {NULL, NULL, 0, 0};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t FormatNumber(char* text, uint32_t magnitude, uint8_t negative, uint8_t decimals);
+static uint8_t Overflow(char* buffer, uint8_t length);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Format a scaled integer into a field
+  * @param  buffer Output string (always terminated)
+  * @param  size   Buffer size in bytes, terminator included
+  * @param  value  Value in units of 10^-decimals
+  * @param  format Format description
+  * @retval Length of the text written
+  */
+uint8_t FixedFormat_Print(char* buffer, uint8_t size, int32_t value, const FixedFormat_t* format)
+{
+  char number[NUMBER_MAX_LENGTH];
+  uint32_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+  uint8_t decimals = MIN(format->decimals, FIXED_FORMAT_MAX_DECIMALS);
+  const char* unit = format->unit;
+  uint8_t numberLength;
+  uint8_t unitLength;
+  uint8_t field;
+  uint8_t pad;
+
+  if (size == 0) {
+    return 0;
+  }
+
+  /* Thousands with one decimal, rounded half away from zero (1250 Hz: "1.3 kHz") */
+  if (format->kiloUnit != NULL && magnitude >= 1000u * powersOfTen[decimals]) {
+    uint32_t divisor = 100u * powersOfTen[decimals];
+    magnitude = (magnitude + divisor / 2) / divisor;
+    decimals = 1;
+    unit = format->kiloUnit;
+  }
+
+  numberLength = FormatNumber(number, magnitude, value < 0, decimals);
+  unitLength = (unit != NULL) ? strlen(unit) : 0;
+
+  field = (format->width != 0) ? format->width : numberLength + unitLength;
+  field = MIN(field, size - 1);
+  if (numberLength + unitLength > field) {
+    return Overflow(buffer, field);
+  }
+
+  /* Right aligned */
+  pad = field - numberLength - unitLength;
+  memset(buffer, ' ', pad);
+  memcpy(&buffer[pad], number, numberLength);
+  memcpy(&buffer[pad + numberLength], unit, unitLength);
+  buffer[field] = '\0';
+
+  return field;
+}
+
+/**
+  * @brief  Format a plain integer
+  * @param  buffer Output string (always terminated)
+  * @param  size   Buffer size in bytes, terminator included
+  * @param  value  Value
+  * @retval Length of the text written
+  */
+uint8_t FixedFormat_Int(char* buffer, uint8_t size, int32_t value)
+{
+  return FixedFormat_Print(buffer, size, value, &plainFormat);
+}
+
+/**
+  * @brief  Format a label followed by a number
+  * @param  buffer Output string (always terminated)
+  * @param  size   Buffer size in bytes, terminator included
+  * @param  label  Text before the number
+  * @param  number Number
+  * @retval Length of the text written
+  */
+uint8_t FixedFormat_Label(char* buffer, uint8_t size, const char* label, int32_t number)
+{
+  char text[NUMBER_MAX_LENGTH];
+  uint32_t magnitude = (number < 0) ? 0u - (uint32_t)number : (uint32_t)number;
+  uint8_t numberLength = FormatNumber(text, magnitude, number < 0, 0);
+  uint8_t labelLength = strlen(label);
+
+  if (size == 0) {
+    return 0;
+  }
+  if (numberLength > size - 1) {
+    return Overflow(buffer, size - 1);
+  }
+
+  /* The number always fits; the label gives way */
+  labelLength = MIN(labelLength, size - 1 - numberLength);
+  memcpy(buffer, label, labelLength);
+  memcpy(&buffer[labelLength], text, numberLength);
+  buffer[labelLength + numberLength] = '\0';
+
+  return labelLength + numberLength;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Write the digits of a number (not terminated)
+  * @param  text      Output, at least NUMBER_MAX_LENGTH characters
+  * @param  magnitude Absolute value in units of 10^-decimals
+  * @param  negative  1 to put a minus sign in front
+  * @param  decimals  Digits after the decimal point
+  * @retval Number of characters written
+  */
+static uint8_t FormatNumber(char* text, uint32_t magnitude, uint8_t negative, uint8_t decimals)
+{
+  char digits[NUMBER_MAX_LENGTH];
+  uint8_t count = 0;
+  uint8_t length = 0;
+
+  /* Least significant first */
+  do {
+    digits[count++] = '0' + (magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  /* At least one digit before the point ("0.5", not ".5") */
+  while (count <= decimals) {
+    digits[count++] = '0';
+  }
+
+  if (negative) {
+    text[length++] = '-';
+  }
+  while (count > 0) {
+    if (count == decimals) {
+      text[length++] = '.';
+    }
+    text[length++] = digits[--count];
+  }
+
+  return length;
+}
+
+/**
+  * @brief  Fill a field that is too narrow for its value
+  * @param  buffer Output string (terminated)
+  * @param  length Field length
+  * @retval Field length
+  */
+static uint8_t Overflow(char* buffer, uint8_t length)
+{
+  memset(buffer, FIXED_FORMAT_OVERFLOW, length);
+  buffer[length] = '\0';
+  return length;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,863 @@
+ /**
+  ******************************************************************************
+  * @file           : flash_storage.c
+  * @brief          : Block-device layer for internal and external flash
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Each device is a backend (read, program, erase) mounted at a base address.
+  * Flash_Read/Write/EraseSector find the device from the address, so callers
+  * such as the preset journal work unchanged on either device.
+  *
+  *   internal  STM32F411 flash, memory mapped, byte/word programming
+  *   external  SPI-NOR (W25Qxx) on SPI1, or a file on host builds
+  *
+  * Writes to the external device are split at page boundaries, as a page
+  * program that crosses one wraps around inside the page. Reads from it go
+  * through a small LRU line cache, since every access costs an SPI command;
+  * lines are invalidated by writes and erases that overlap them.
+  *
+  * An erase takes from tens of ms (SPI-NOR block) to seconds (128KB internal
+  * sector). Flash_BeginErase() only issues it and Flash_PollErase() checks
+  * the device once per call, so a caller such as the journal job can go on
+  * with other work in between. The SPI-NOR backend sends the erase command
+  * and then reads the WIP bit of status register 1 once per poll; the file
+  * backend on host builds stays busy for FLASH_FILE_ERASE_POLLS polls, so
+  * host tests go through the same path.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_storage.h"
+#include <string.h>
+#ifdef FLASH_STORAGE_FILE
+#include <stdio.h>
+#endif
+
+/* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Mounted flash device
+  */
+typedef struct {
+    uint32_t base;                 /* First address of the device window */
+    uint32_t size;                 /* Device size in bytes */
+    uint16_t pageSize;             /* Program operations may not cross a page (0: no limit) */
+    uint8_t cached;                /* 1 if reads go through the line cache */
+    uint8_t (*read)(uint32_t offset, uint8_t* data, uint32_t length);
+    uint8_t (*program)(uint32_t offset, const uint8_t* data, uint32_t length);
+    uint8_t (*eraseStart)(uint32_t offset);
+    uint8_t (*erasePoll)(void);    /* FLASH_STATUS_BUSY until the erase ends */
+} FlashDevice_t;
+
+/**
+  * @brief  Read cache line (external device offsets)
+  */
+typedef struct {
+    uint32_t offset;               /* Line-aligned device offset */
+    uint32_t lastUse;              /* Access stamp for LRU replacement */
+    uint8_t valid;
+    uint8_t data[FLASH_CACHE_LINE_SIZE];
+} FlashCacheLine_t;
+
+/* Private define ------------------------------------------------------------*/
+#define FLASH_MAX_DEVICES          2
+
+/* SPI-NOR commands (W25Qxx and compatibles) */
+#define SPI_NOR_CMD_READ           0x03
+#define SPI_NOR_CMD_PAGE_PROGRAM   0x02
+#define SPI_NOR_CMD_WRITE_ENABLE   0x06
+#define SPI_NOR_CMD_READ_STATUS1   0x05
+#define SPI_NOR_CMD_BLOCK_ERASE    0xD8
+#define SPI_NOR_CMD_JEDEC_ID       0x9F
+#define SPI_NOR_CMD_RELEASE_PD     0xAB
+#define SPI_NOR_STATUS_BUSY        0x01
+
+/* Timeouts in ms (datasheet maximum plus margin) */
+#define SPI_NOR_TRANSFER_TIMEOUT   10
+#define SPI_NOR_PROGRAM_TIMEOUT    5
+#define SPI_NOR_ERASE_TIMEOUT      3000
+
+/* Size of the backing file on host builds */
+#ifndef FLASH_FILE_SIZE
+#define FLASH_FILE_SIZE            0x100000
+#endif
+
+/* Polls a file backend erase stays busy for, like a chip would (at least 1) */
+#ifndef FLASH_FILE_ERASE_POLLS
+#define FLASH_FILE_ERASE_POLLS     4
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+#define SPI_NOR_SELECT()           HAL_GPIO_WritePin(FLASH_CS_GPIO_Port, FLASH_CS_Pin, GPIO_PIN_RESET)
+#define SPI_NOR_DESELECT()         HAL_GPIO_WritePin(FLASH_CS_GPIO_Port, FLASH_CS_Pin, GPIO_PIN_SET)
+
+/* Private variables ---------------------------------------------------------*/
+static FlashDevice_t devices[FLASH_MAX_DEVICES];
+static uint8_t deviceCount = 0;
+static uint8_t flashInitialized = 0;
+
+static FlashCacheLine_t cacheLines[FLASH_CACHE_LINES];
+static uint32_t cacheClock = 0;
+
+static FlashStats_t flashStats;
+
+static FlashDevice_t* eraseDevice = NULL;        /* Device with an erase in progress */
+static uint8_t eraseResult = FLASH_STATUS_OK;    /* Result of the last erase */
+
+#if FLASH_USE_EXTERNAL && !defined(FLASH_STORAGE_FILE)
+static uint32_t spiNorEraseStart = 0;            /* Tick when the erase was issued */
+#endif
+
+#ifdef FLASH_STORAGE_FILE
+static FILE* backingFile = NULL;
+static uint32_t fileEraseBlock = 0;              /* Block being erased */
+static uint32_t fileErasePolls = 0;              /* Polls left until it ends */
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static FlashDevice_t* FindDevice(uint32_t address, uint32_t length);
+static uint8_t MissingDeviceStatus(uint32_t address);
+static uint8_t CachedRead(FlashDevice_t* device, uint32_t offset, uint8_t* data, uint32_t length);
+static void InvalidateCache(uint32_t offset, uint32_t length);
+static void WaitErase(void);
+#ifndef FLASH_STORAGE_FILE
+static uint8_t Internal_Read(uint32_t offset, uint8_t* data, uint32_t length);
+static uint8_t Internal_Program(uint32_t offset, const uint8_t* data, uint32_t length);
+static uint8_t Internal_EraseStart(uint32_t offset);
+static uint8_t Internal_ErasePoll(void);
+#endif
+#if FLASH_USE_EXTERNAL && !defined(FLASH_STORAGE_FILE)
+static uint8_t SpiNor_Init(uint32_t* size);
+static uint8_t SpiNor_Read(uint32_t offset, uint8_t* data, uint32_t length);
+static uint8_t SpiNor_Program(uint32_t offset, const uint8_t* data, uint32_t length);
+static uint8_t SpiNor_EraseStart(uint32_t offset);
+static uint8_t SpiNor_ErasePoll(void);
+static uint8_t SpiNor_Command(uint8_t command, uint32_t offset, uint8_t withAddress);
+static uint8_t SpiNor_WriteEnable(void);
+static uint8_t SpiNor_ReadStatus(uint8_t* status);
+static uint8_t SpiNor_WaitReady(uint32_t timeout);
+#endif
+#ifdef FLASH_STORAGE_FILE
+static uint8_t File_Init(uint32_t* size);
+static uint8_t File_Read(uint32_t offset, uint8_t* data, uint32_t length);
+static uint8_t File_Program(uint32_t offset, const uint8_t* data, uint32_t length);
+static uint8_t File_EraseStart(uint32_t offset);
+static uint8_t File_ErasePoll(void);
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize the flash devices
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_Init(void)
+{
+  uint8_t status = FLASH_STATUS_OK;
+
+  if (flashInitialized) {
+    return FLASH_STATUS_OK;
+  }
+
+  deviceCount = 0;
+  memset(cacheLines, 0, sizeof(cacheLines));
+  memset(&flashStats, 0, sizeof(flashStats));
+
+#ifndef FLASH_STORAGE_FILE
+  devices[deviceCount].base = FLASH_INTERNAL_BASE;
+  devices[deviceCount].size = FLASH_INTERNAL_SIZE;
+  devices[deviceCount].pageSize = 0;
+  devices[deviceCount].cached = 0;
+  devices[deviceCount].read = Internal_Read;
+  devices[deviceCount].program = Internal_Program;
+  devices[deviceCount].eraseStart = Internal_EraseStart;
+  devices[deviceCount].erasePoll = Internal_ErasePoll;
+  deviceCount++;
+#endif
+
+#if FLASH_USE_EXTERNAL
+  uint32_t size = 0;
+#ifdef FLASH_STORAGE_FILE
+  status = File_Init(&size);
+#else
+  status = SpiNor_Init(&size);
+#endif
+  if (status == FLASH_STATUS_OK) {
+    devices[deviceCount].base = FLASH_EXTERNAL_BASE;
+    devices[deviceCount].size = size;
+    devices[deviceCount].pageSize = FLASH_EXTERNAL_PAGE_SIZE;
+    devices[deviceCount].cached = 1;
+#ifdef FLASH_STORAGE_FILE
+    devices[deviceCount].read = File_Read;
+    devices[deviceCount].program = File_Program;
+    devices[deviceCount].eraseStart = File_EraseStart;
+    devices[deviceCount].erasePoll = File_ErasePoll;
+#else
+    devices[deviceCount].read = SpiNor_Read;
+    devices[deviceCount].program = SpiNor_Program;
+    devices[deviceCount].eraseStart = SpiNor_EraseStart;
+    devices[deviceCount].erasePoll = SpiNor_ErasePoll;
+#endif
+    deviceCount++;
+    flashStats.externalSize = size;
+  }
+
+  #ifdef DEBUG
+  printf("External flash: %lu KB%s\r\n", size / 1024,
+         (status == FLASH_STATUS_OK) ? "" : " (not found)");
+  #endif
+#endif
+
+  flashInitialized = 1;
+  return status;
+}
+
+/**
+  * @brief  Read from flash
+  * @param  address Start address
+  * @param  data    Buffer to fill
+  * @param  length  Number of bytes
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_Read(uint32_t address, uint8_t* data, uint32_t length)
+{
+  FlashDevice_t* device = FindDevice(address, length);
+  if (device == NULL || data == NULL) {
+    return MissingDeviceStatus(address);
+  }
+
+  if (device == eraseDevice) {
+    WaitErase();
+  }
+
+  flashStats.reads++;
+
+  uint32_t offset = address - device->base;
+  if (device->cached) {
+    return CachedRead(device, offset, data, length);
+  }
+
+  return device->read(offset, data, length);
+}
+
+/**
+  * @brief  Program flash
+  * @param  address Start address
+  * @param  data    Data to program
+  * @param  length  Number of bytes
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_Write(uint32_t address, const uint8_t* data, uint32_t length)
+{
+  FlashDevice_t* device = FindDevice(address, length);
+  if (device == NULL || data == NULL) {
+    return MissingDeviceStatus(address);
+  }
+
+  if (device == eraseDevice) {
+    WaitErase();
+  }
+
+  uint32_t offset = address - device->base;
+  if (device->cached) {
+    InvalidateCache(offset, length);
+  }
+
+  while (length > 0) {
+    uint32_t chunk = length;
+    if (device->pageSize != 0) {
+      chunk = MIN(length, device->pageSize - (offset % device->pageSize));
+    }
+
+    uint8_t status = device->program(offset, data, chunk);
+    flashStats.pagePrograms++;
+    if (status != FLASH_STATUS_OK) {
+      return status;
+    }
+
+    offset += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  Erase the erase unit containing an address
+  * @param  address Any address inside the unit
+  * @retval FLASH_STATUS_OK or error code
+  */
+uint8_t Flash_EraseSector(uint32_t address)
+{
+  uint8_t status = Flash_BeginErase(address);
+  if (status != FLASH_STATUS_OK) {
+    return status;
+  }
+
+  WaitErase();
+  return eraseResult;
+}
+
+/**
+  * @brief  Start erasing the erase unit containing an address
+  * @param  address Any address inside the unit
+  * @retval FLASH_STATUS_OK if started, or error code
+  */
+uint8_t Flash_BeginErase(uint32_t address)
+{
+  FlashDevice_t* device = FindDevice(address, 1);
+  if (device == NULL) {
+    return MissingDeviceStatus(address);
+  }
+
+  WaitErase();
+
+  uint32_t offset = address - device->base;
+  if (device->cached) {
+    uint32_t blockStart = offset & ~(uint32_t)(FLASH_EXTERNAL_BLOCK_SIZE - 1);
+    InvalidateCache(blockStart, FLASH_EXTERNAL_BLOCK_SIZE);
+  }
+
+  flashStats.erases++;
+  eraseResult = device->eraseStart(offset);
+  if (eraseResult == FLASH_STATUS_OK) {
+    eraseDevice = device;
+  }
+
+  return eraseResult;
+}
+
+/**
+  * @brief  Check on the erase started by Flash_BeginErase()
+  * @retval FLASH_STATUS_BUSY while it runs, then its result
+  */
+uint8_t Flash_PollErase(void)
+{
+  if (eraseDevice != NULL) {
+    uint8_t status = eraseDevice->erasePoll();
+    if (status == FLASH_STATUS_BUSY) {
+      return FLASH_STATUS_BUSY;
+    }
+    eraseDevice = NULL;
+    eraseResult = status;
+  }
+
+  return eraseResult;
+}
+
+/**
+  * @brief  Get flash access statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void Flash_GetStats(FlashStats_t* stats)
+{
+  if (stats != NULL) {
+    memcpy(stats, &flashStats, sizeof(FlashStats_t));
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Find the device holding an address range
+  * @param  address Start address
+  * @param  length  Number of bytes
+  * @retval Device, or NULL if the range is not entirely on one device
+  */
+static FlashDevice_t* FindDevice(uint32_t address, uint32_t length)
+{
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    FlashDevice_t* device = &devices[i];
+    if (address >= device->base && address - device->base < device->size &&
+        length <= device->size - (address - device->base)) {
+      return device;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  * @brief  Status for an access that matched no device
+  * @param  address Requested address
+  * @retval FLASH_STATUS_NO_DEVICE inside the external window, else FLASH_STATUS_INVALID
+  */
+static uint8_t MissingDeviceStatus(uint32_t address)
+{
+  if (address >= FLASH_EXTERNAL_BASE && address - FLASH_EXTERNAL_BASE < FLASH_EXTERNAL_MAX_SIZE &&
+      flashStats.externalSize == 0) {
+    return FLASH_STATUS_NO_DEVICE;
+  }
+
+  return FLASH_STATUS_INVALID;
+}
+
+/**
+  * @brief  Read through the line cache
+  * @param  device Cached device
+  * @param  offset Device offset
+  * @param  data   Buffer to fill
+  * @param  length Number of bytes
+  * @retval FLASH_STATUS_OK or error code
+  */
+static uint8_t CachedRead(FlashDevice_t* device, uint32_t offset, uint8_t* data, uint32_t length)
+{
+  while (length > 0) {
+    uint32_t lineOffset = offset & ~(uint32_t)(FLASH_CACHE_LINE_SIZE - 1);
+    FlashCacheLine_t* line = NULL;
+    FlashCacheLine_t* victim = &cacheLines[0];
+
+    for (uint8_t i = 0; i < FLASH_CACHE_LINES; i++) {
+      if (cacheLines[i].valid && cacheLines[i].offset == lineOffset) {
+        line = &cacheLines[i];
+        break;
+      }
+      if (!cacheLines[i].valid ||
+          (victim->valid && cacheLines[i].lastUse < victim->lastUse)) {
+        victim = &cacheLines[i];
+      }
+    }
+
+    if (line != NULL) {
+      flashStats.cacheHits++;
+    } else {
+      /* Fill the least recently used line */
+      uint32_t fill = MIN((uint32_t)FLASH_CACHE_LINE_SIZE, device->size - lineOffset);
+      victim->valid = 0;
+      uint8_t status = device->read(lineOffset, victim->data, fill);
+      if (status != FLASH_STATUS_OK) {
+        return status;
+      }
+      victim->offset = lineOffset;
+      victim->valid = 1;
+      line = victim;
+      flashStats.cacheMisses++;
+    }
+
+    line->lastUse = ++cacheClock;
+
+    uint32_t start = offset - lineOffset;
+    uint32_t chunk = MIN(length, (uint32_t)FLASH_CACHE_LINE_SIZE - start);
+    memcpy(data, &line->data[start], chunk);
+
+    offset += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  Drop cache lines overlapping a range
+  * @param  offset Device offset
+  * @param  length Number of bytes
+  * @retval None
+  */
+static void InvalidateCache(uint32_t offset, uint32_t length)
+{
+  for (uint8_t i = 0; i < FLASH_CACHE_LINES; i++) {
+    if (cacheLines[i].valid &&
+        cacheLines[i].offset < offset + length &&
+        offset < cacheLines[i].offset + FLASH_CACHE_LINE_SIZE) {
+      cacheLines[i].valid = 0;
+    }
+  }
+}
+
+/**
+  * @brief  Wait for the erase in progress, if any (result kept in eraseResult)
+  * @retval None
+  */
+static void WaitErase(void)
+{
+  while (Flash_PollErase() == FLASH_STATUS_BUSY) {
+  }
+}
+
+#ifndef FLASH_STORAGE_FILE
+/**
+  * @brief  Internal flash: read (memory mapped)
+  */
+static uint8_t Internal_Read(uint32_t offset, uint8_t* data, uint32_t length)
+{
+  memcpy(data, (const void*)(FLASH_INTERNAL_BASE + offset), length);
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  Internal flash: program, a word at a time where aligned
+  */
+static uint8_t Internal_Program(uint32_t offset, const uint8_t* data, uint32_t length)
+{
+  uint32_t address = FLASH_INTERNAL_BASE + offset;
+  HAL_StatusTypeDef status = HAL_OK;
+
+  HAL_FLASH_Unlock();
+
+  while (length > 0 && status == HAL_OK) {
+    if ((address & 3U) == 0 && length >= 4) {
+      uint32_t word;
+      memcpy(&word, data, sizeof(word));
+      status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word);
+      address += 4;
+      data += 4;
+      length -= 4;
+    } else {
+      status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE, address, *data);
+      address++;
+      data++;
+      length--;
+    }
+  }
+
+  HAL_FLASH_Lock();
+
+  return (status == HAL_OK) ? FLASH_STATUS_OK : FLASH_STATUS_ERROR;
+}
+
+/**
+  * @brief  Internal flash: start erasing the sector holding an offset
+  * @note   STM32F411: sectors 0-3 are 16KB, sector 4 is 64KB, 5-7 are 128KB.
+  *         The F411 has a single bank, so instruction and constant fetches
+  *         from flash stall until the erase ends; only code running from RAM
+  *         and DMA keep going meanwhile.
+  */
+static uint8_t Internal_EraseStart(uint32_t offset)
+{
+  uint32_t sector;
+
+  if (offset < 0x10000) {
+    sector = offset / 0x4000;
+  } else if (offset < 0x20000) {
+    sector = 4;
+  } else {
+    sector = 5 + (offset - 0x20000) / 0x20000;
+  }
+
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                         FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+
+  /* Sets SER and the sector number, then STRT; does not wait */
+  FLASH_Erase_Sector(sector, FLASH_VOLTAGE_RANGE_3);
+
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  Internal flash: check whether the sector erase has ended
+  */
+static uint8_t Internal_ErasePoll(void)
+{
+  if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_BSY)) {
+    return FLASH_STATUS_BUSY;
+  }
+
+  uint8_t failed = __HAL_FLASH_GET_FLAG(FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR |
+                                        FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR) ? 1 : 0;
+
+  /* What HAL_FLASHEx_Erase() does after its wait */
+  CLEAR_BIT(FLASH->CR, (FLASH_CR_SER | FLASH_CR_SNB));
+  FLASH_FlushCaches();
+  HAL_FLASH_Lock();
+
+  return failed ? FLASH_STATUS_ERROR : FLASH_STATUS_OK;
+}
+#endif /* !FLASH_STORAGE_FILE */
+
+#if FLASH_USE_EXTERNAL && !defined(FLASH_STORAGE_FILE)
+/**
+  * @brief  SPI-NOR: wake the chip and identify it
+  * @param  size Receives the device size in bytes
+  * @retval FLASH_STATUS_OK or FLASH_STATUS_NO_DEVICE
+  */
+static uint8_t SpiNor_Init(uint32_t* size)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  uint8_t command = SPI_NOR_CMD_JEDEC_ID;
+  uint8_t id[3] = {0};
+
+  /* Chip select, idle high */
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  SPI_NOR_DESELECT();
+  GPIO_InitStruct.Pin = FLASH_CS_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  HAL_GPIO_Init(FLASH_CS_GPIO_Port, &GPIO_InitStruct);
+
+  /* Leave deep power-down in case the chip was put there */
+  SpiNor_Command(SPI_NOR_CMD_RELEASE_PD, 0, 0);
+  HAL_Delay(1);
+
+  SPI_NOR_SELECT();
+  uint8_t ok = (HAL_SPI_Transmit(&hspi1, &command, 1, SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK) &&
+               (HAL_SPI_Receive(&hspi1, id, sizeof(id), SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK);
+  SPI_NOR_DESELECT();
+
+  /* No chip: the bus reads all zeros or all ones */
+  if (!ok || id[0] == 0x00 || id[0] == 0xFF || id[2] < 16 || id[2] > 24) {
+    return FLASH_STATUS_NO_DEVICE;
+  }
+
+  /* Capacity code is log2 of the size in bytes */
+  *size = 1UL << id[2];
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  SPI-NOR: read
+  */
+static uint8_t SpiNor_Read(uint32_t offset, uint8_t* data, uint32_t length)
+{
+  uint8_t header[4] = {
+    SPI_NOR_CMD_READ, (uint8_t)(offset >> 16), (uint8_t)(offset >> 8), (uint8_t)offset
+  };
+  uint8_t ok;
+
+  SPI_NOR_SELECT();
+  ok = (HAL_SPI_Transmit(&hspi1, header, sizeof(header), SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK);
+  while (ok && length > 0) {
+    uint16_t chunk = (uint16_t)MIN(length, 0xFFFFUL);
+    ok = (HAL_SPI_Receive(&hspi1, data, chunk, SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK);
+    data += chunk;
+    length -= chunk;
+  }
+  SPI_NOR_DESELECT();
+
+  return ok ? FLASH_STATUS_OK : FLASH_STATUS_ERROR;
+}
+
+/**
+  * @brief  SPI-NOR: program within one page
+  */
+static uint8_t SpiNor_Program(uint32_t offset, const uint8_t* data, uint32_t length)
+{
+  uint8_t header[4] = {
+    SPI_NOR_CMD_PAGE_PROGRAM, (uint8_t)(offset >> 16), (uint8_t)(offset >> 8), (uint8_t)offset
+  };
+  uint8_t ok;
+
+  if (SpiNor_WriteEnable() != FLASH_STATUS_OK) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  SPI_NOR_SELECT();
+  ok = (HAL_SPI_Transmit(&hspi1, header, sizeof(header), SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK) &&
+       (HAL_SPI_Transmit(&hspi1, (uint8_t*)data, (uint16_t)length, SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK);
+  SPI_NOR_DESELECT();
+
+  if (!ok) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  return SpiNor_WaitReady(SPI_NOR_PROGRAM_TIMEOUT);
+}
+
+/**
+  * @brief  SPI-NOR: start erasing the 64KB block holding an offset
+  */
+static uint8_t SpiNor_EraseStart(uint32_t offset)
+{
+  if (SpiNor_WriteEnable() != FLASH_STATUS_OK ||
+      SpiNor_Command(SPI_NOR_CMD_BLOCK_ERASE, offset, 1) != FLASH_STATUS_OK) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  spiNorEraseStart = HAL_GetTick();
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  SPI-NOR: read the status once to see whether the erase has ended
+  */
+static uint8_t SpiNor_ErasePoll(void)
+{
+  uint8_t status;
+
+  if (SpiNor_ReadStatus(&status) == FLASH_STATUS_OK && !(status & SPI_NOR_STATUS_BUSY)) {
+    return FLASH_STATUS_OK;
+  }
+
+  if (HAL_GetTick() - spiNorEraseStart > SPI_NOR_ERASE_TIMEOUT) {
+    return FLASH_STATUS_TIMEOUT;
+  }
+
+  return FLASH_STATUS_BUSY;
+}
+
+/**
+  * @brief  SPI-NOR: send a command with an optional 24-bit address
+  */
+static uint8_t SpiNor_Command(uint8_t command, uint32_t offset, uint8_t withAddress)
+{
+  uint8_t header[4] = {
+    command, (uint8_t)(offset >> 16), (uint8_t)(offset >> 8), (uint8_t)offset
+  };
+
+  SPI_NOR_SELECT();
+  HAL_StatusTypeDef status = HAL_SPI_Transmit(&hspi1, header, withAddress ? 4 : 1,
+                                              SPI_NOR_TRANSFER_TIMEOUT);
+  SPI_NOR_DESELECT();
+
+  return (status == HAL_OK) ? FLASH_STATUS_OK : FLASH_STATUS_ERROR;
+}
+
+/**
+  * @brief  SPI-NOR: set the write enable latch
+  */
+static uint8_t SpiNor_WriteEnable(void)
+{
+  return SpiNor_Command(SPI_NOR_CMD_WRITE_ENABLE, 0, 0);
+}
+
+/**
+  * @brief  SPI-NOR: read status register 1
+  * @param  status Receives the register
+  * @retval FLASH_STATUS_OK or FLASH_STATUS_ERROR
+  */
+static uint8_t SpiNor_ReadStatus(uint8_t* status)
+{
+  uint8_t command = SPI_NOR_CMD_READ_STATUS1;
+  uint8_t ok;
+
+  SPI_NOR_SELECT();
+  ok = (HAL_SPI_Transmit(&hspi1, &command, 1, SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK) &&
+       (HAL_SPI_Receive(&hspi1, status, 1, SPI_NOR_TRANSFER_TIMEOUT) == HAL_OK);
+  SPI_NOR_DESELECT();
+
+  return ok ? FLASH_STATUS_OK : FLASH_STATUS_ERROR;
+}
+
+/**
+  * @brief  SPI-NOR: wait for a page program to finish
+  * @param  timeout Maximum wait in ms
+  * @retval FLASH_STATUS_OK or FLASH_STATUS_TIMEOUT
+  */
+static uint8_t SpiNor_WaitReady(uint32_t timeout)
+{
+  uint8_t status = SPI_NOR_STATUS_BUSY;
+  uint32_t start = HAL_GetTick();
+
+  while (status & SPI_NOR_STATUS_BUSY) {
+    if (HAL_GetTick() - start > timeout) {
+      return FLASH_STATUS_TIMEOUT;
+    }
+
+    if (SpiNor_ReadStatus(&status) != FLASH_STATUS_OK) {
+      status = SPI_NOR_STATUS_BUSY;
+    }
+  }
+
+  return FLASH_STATUS_OK;
+}
+#endif /* FLASH_USE_EXTERNAL && !FLASH_STORAGE_FILE */
+
+#ifdef FLASH_STORAGE_FILE
+/**
+  * @brief  File backend: open the backing file, creating an erased one if needed
+  * @param  size Receives the device size in bytes
+  * @retval FLASH_STATUS_OK or FLASH_STATUS_NO_DEVICE
+  */
+static uint8_t File_Init(uint32_t* size)
+{
+  backingFile = fopen(FLASH_STORAGE_FILE, "r+b");
+  if (backingFile == NULL) {
+    backingFile = fopen(FLASH_STORAGE_FILE, "w+b");
+    if (backingFile == NULL) {
+      return FLASH_STATUS_NO_DEVICE;
+    }
+    for (uint32_t i = 0; i < FLASH_FILE_SIZE; i++) {
+      fputc(0xFF, backingFile);
+    }
+    fflush(backingFile);
+  }
+
+  *size = FLASH_FILE_SIZE;
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  File backend: read
+  */
+static uint8_t File_Read(uint32_t offset, uint8_t* data, uint32_t length)
+{
+  if (fseek(backingFile, (long)offset, SEEK_SET) != 0 ||
+      fread(data, 1, length, backingFile) != length) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  File backend: program (clears bits only, like NOR flash)
+  */
+static uint8_t File_Program(uint32_t offset, const uint8_t* data, uint32_t length)
+{
+  uint8_t page[FLASH_EXTERNAL_PAGE_SIZE];
+
+  if (File_Read(offset, page, length) != FLASH_STATUS_OK) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  for (uint32_t i = 0; i < length; i++) {
+    page[i] &= data[i];
+  }
+
+  if (fseek(backingFile, (long)offset, SEEK_SET) != 0 ||
+      fwrite(page, 1, length, backingFile) != length) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  fflush(backingFile);
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  File backend: start erasing the 64KB block holding an offset
+  */
+static uint8_t File_EraseStart(uint32_t offset)
+{
+  fileEraseBlock = offset & ~(uint32_t)(FLASH_EXTERNAL_BLOCK_SIZE - 1);
+  fileErasePolls = FLASH_FILE_ERASE_POLLS;
+  return FLASH_STATUS_OK;
+}
+
+/**
+  * @brief  File backend: erase the block on the last of its busy polls
+  */
+static uint8_t File_ErasePoll(void)
+{
+  if (--fileErasePolls > 0) {
+    return FLASH_STATUS_BUSY;
+  }
+
+  if (fseek(backingFile, (long)fileEraseBlock, SEEK_SET) != 0) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  for (uint32_t i = 0; i < FLASH_EXTERNAL_BLOCK_SIZE; i++) {
+    fputc(0xFF, backingFile);
+  }
+
+  fflush(backingFile);
+  return FLASH_STATUS_OK;
+}
+#endif /* FLASH_STORAGE_FILE */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
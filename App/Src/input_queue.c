@@ -0,0 +1,169 @@
+ /**
+  ******************************************************************************
+  * @file           : input_queue.c
+  * @brief          : Wait-free input event queue (interrupt to main loop)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Single producer (the TIM3 sampling interrupt, which runs both the encoder
+  * and the button sampling) and single consumer (the main loop). The head
+  * index is only written by the producer and the tail index only by the
+  * consumer, so neither side ever waits for or masks the other. Indices run
+  * freely and are masked on access; head - tail is the number of waiting
+  * events. The barrier orders the event contents before the index that
+  * publishes (or releases) them.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "input_queue.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define INPUT_QUEUE_MASK           (INPUT_QUEUE_SIZE - 1)
+
+#if (INPUT_QUEUE_SIZE & INPUT_QUEUE_MASK) != 0 || INPUT_QUEUE_SIZE > 128
+#error "INPUT_QUEUE_SIZE must be a power of two no larger than 128"
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static InputEvent_t queue[INPUT_QUEUE_SIZE];
+static volatile uint8_t head = 0;            /* Written by the producer only */
+static volatile uint8_t tail = 0;            /* Written by the consumer only */
+
+/* Statistics, written by the producer only */
+static volatile uint32_t queuedCount[INPUT_SOURCE_COUNT];
+static volatile uint32_t droppedCount[INPUT_SOURCE_COUNT];
+static volatile uint8_t maxDepth = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize the queue (empty) and clear the statistics
+  * @retval None
+  */
+void InputQueue_Init(void)
+{
+  head = 0;
+  tail = 0;
+
+  for (uint8_t i = 0; i < INPUT_SOURCE_COUNT; i++) {
+    queuedCount[i] = 0;
+    droppedCount[i] = 0;
+  }
+  maxDepth = 0;
+}
+
+/**
+  * @brief  Queue an event (producer side)
+  * @param  source INPUT_SOURCE_*
+  * @param  code Source specific code
+  * @param  state Source specific state
+  * @param  value Source specific value
+  * @retval 1 if queued, 0 if the queue was full
+  */
+uint8_t InputQueue_Push(uint8_t source, uint8_t code, uint8_t state, int32_t value)
+{
+  uint8_t index = head;
+  uint8_t depth = (uint8_t)(index - tail);
+  InputEvent_t *event;
+
+  if (source >= INPUT_SOURCE_COUNT) {
+    return 0;
+  }
+
+  /* Full: refuse the new event (the oldest belongs to the consumer) */
+  if (depth >= INPUT_QUEUE_SIZE) {
+    droppedCount[source]++;
+    return 0;
+  }
+
+  event = &queue[index & INPUT_QUEUE_MASK];
+  event->time = HAL_GetTick();
+  event->value = value;
+  event->source = source;
+  event->code = code;
+  event->state = state;
+
+  /* Publish the event only once its contents are written */
+  __DMB();
+  head = index + 1;
+
+  queuedCount[source]++;
+  if (depth + 1 > maxDepth) {
+    maxDepth = depth + 1;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Take the oldest event (consumer side)
+  * @param  event Pointer to event structure to fill
+  * @retval 1 if an event was taken, 0 if the queue is empty
+  */
+uint8_t InputQueue_Pop(InputEvent_t *event)
+{
+  uint8_t index = tail;
+
+  if (index == head) {
+    return 0;
+  }
+
+  /* Read the contents after seeing the head that published them */
+  __DMB();
+  *event = queue[index & INPUT_QUEUE_MASK];
+
+  /* Release the slot only once it has been copied */
+  __DMB();
+  tail = index + 1;
+
+  return 1;
+}
+
+/**
+  * @brief  Check whether events are waiting
+  * @retval 1 if the queue is empty
+  */
+uint8_t InputQueue_IsEmpty(void)
+{
+  return head == tail;
+}
+
+/**
+  * @brief  Discard all waiting events (consumer side)
+  * @retval None
+  */
+void InputQueue_Flush(void)
+{
+  tail = head;
+}
+
+/**
+  * @brief  Get queue statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void InputQueue_GetStats(InputQueueStats_t *stats)
+{
+  for (uint8_t i = 0; i < INPUT_SOURCE_COUNT; i++) {
+    stats->queued[i] = queuedCount[i];
+    stats->dropped[i] = droppedCount[i];
+  }
+  stats->maxDepth = maxDepth;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -18,10 +18,17 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "lcd_driver.h"
+#include "fixed_format.h"
 #include <stdio.h>
 #include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
+/* Controller write waiting in the transport queue */
+typedef struct {
+  uint8_t Value;             // Command, character or nibble
+  uint8_t Flags;             // LCD_OP_* flags and gap
+} LCD_OpTypeDef;
+
 /* Private define ------------------------------------------------------------*/
 /* LCD Dimensions */
 #define LCD_COLS        16
@@ -33,22 +40,66 @@
 
 /* Timing constants */
 #define LCD_DELAY_INIT  50      // ms
-#define LCD_DELAY_CMD   2       // ms
-#define LCD_DELAY_ENABLE 1      // ms
-#define LCD_PULSE_DELAY 50      // us
+#define LCD_DELAY_CMD   2       // ms (clear and home take 1.52 ms)
+#define LCD_DELAY_RESET 5       // ms (after the first 8-bit mode nibble)
+#define LCD_DELAY_ENABLE 1      // ms (direct mode)
+
+/* Frame buffer */
+#define LCD_ADDRESS_UNKNOWN 0xFF    // Display address counter not known (after CGRAM access)
+#define LCD_ALL_CELLS   ((1U << LCD_COLS) - 1)
+#define LCD_BRIDGE_GAP  1       // Unchanged cells rewritten instead of a cursor move (same cost)
+
+/* Transport: controller writes are queued and sent by I2C interrupt transfers.
+ * Each nibble costs two PCF8574 bytes (EN high, then EN low to latch), so the
+ * bus itself spaces the writes well beyond the 37 us the controller needs;
+ * only the slow commands get a gap, timed by the tick instead of a delay. */
+#define LCD_QUEUE_SIZE  128     // Queued controller writes (power of two)
+#define LCD_QUEUE_MASK  (LCD_QUEUE_SIZE - 1)
+#define LCD_TX_SIZE     64      // PCF8574 bytes per I2C transfer
+
+/* Queued write flags */
+#define LCD_OP_DATA     0x01    // RS high: character or CGRAM data
+#define LCD_OP_NIBBLE   0x02    // Upper nibble only (reset sequence)
+#define LCD_OP_PORT     0x04    // Port byte only, no enable pulse (backlight)
+#define LCD_OP_GAP(ms)  ((uint8_t)((ms) << 4))  // Pause after the write, 0-15 ms
+#define LCD_OP_GAP_MS(flags) ((flags) >> 4)
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static LCD_ConfigTypeDef LCD_Config;
-static uint8_t LCD_Backlight = LCD_PIN_BL;  // Backlight on by default
+static volatile uint8_t LCD_Backlight = LCD_PIN_BL;  // Backlight on by default
+
+/* Frame buffer: what the screen should show, what it shows, and where they differ */
+static uint8_t frameBuffer[LCD_ROWS][LCD_COLS];
+static uint8_t displayBuffer[LCD_ROWS][LCD_COLS];
+static uint16_t dirtyCells[LCD_ROWS];         // One bit per column
+static uint8_t cursorCol = 0;
+static uint8_t cursorRow = 0;
+static uint8_t ddramAddress = LCD_ADDRESS_UNKNOWN;
+static LCD_StatsTypeDef LCD_Stats;
+
+/* Transport queue: filled by the main loop, drained from interrupts */
+static LCD_OpTypeDef opQueue[LCD_QUEUE_SIZE];
+static volatile uint16_t opHead = 0;
+static volatile uint16_t opTail = 0;
+static uint8_t txBuffer[LCD_TX_SIZE];
+static volatile uint8_t transferBusy = 0;
+static volatile uint8_t gapMs = 0;            // Pause pending after the last transfer
+static volatile uint32_t gapStart = 0;
+static volatile uint8_t resyncNeeded = 0;     // A transfer failed; controller state unknown
 
 /* Private function prototypes -----------------------------------------------*/
 static void LCD_InitHardware(void);
+static void LCD_Reset(void);
+static void LCD_QueueOp(uint8_t value, uint8_t flags);
+static uint16_t LCD_QueueFree(void);
+static void LCD_Pump(void);
+static void LCD_WriteDirect(uint8_t value, uint8_t flags);
 static void LCD_Write4Bits(uint8_t data);
-static void LCD_SendNibble(uint8_t nibble, uint8_t isData);
 static void LCD_Pulse_EN(void);
 static void LCD_SetBacklight(uint8_t state);
-static void LCD_I2C_Write(uint8_t data);
+static void LCD_PutCell(uint8_t c);
+static void LCD_SendCell(uint8_t row, uint8_t col);
 
 /* Private user code ---------------------------------------------------------*/
 
@@ -65,37 +116,11 @@ void LCD_Init(void)
   /* Power on delay */
   HAL_Delay(LCD_DELAY_INIT);
   
-  /* Initialize with 4-bit interface
-   * 
-   * According to the HD44780 datasheet, when starting in 4-bit mode
-   * we need a special initialization sequence:
-   * 1. Send 0x03 three times (8-bit mode)
-   * 2. Send 0x02 (switch to 4-bit mode)
-   */
-  
-  /* Send 0x3 three times (8-bit mode) */
-  LCD_SendNibble(0x3, 0);
-  HAL_Delay(5);
-  LCD_SendNibble(0x3, 0);
-  HAL_Delay(5);
-  LCD_SendNibble(0x3, 0);
-  HAL_Delay(1);
-  
-  /* Switch to 4-bit mode */
-  LCD_SendNibble(0x2, 0);
-  HAL_Delay(1);
-  
-  /* Initialize the LCD with 4-bit mode, 2 lines, 5x8 dots */
-  LCD_SendCommand(LCD_CMD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8DOTS);
-  
-  /* Turn the display on with cursor and blink disabled */
-  LCD_SendCommand(LCD_CMD_DISPLAY_CTRL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);
-  
-  /* Set the entry mode (cursor moves right, display does not shift) */
-  LCD_SendCommand(LCD_CMD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DEC);
-  
-  /* Clear the display */
-  LCD_Clear();
+  /* Start with an empty frame buffer; the reset clears the display to match */
+  memset(frameBuffer, ' ', sizeof(frameBuffer));
+  cursorCol = 0;
+  cursorRow = 0;
+  LCD_Reset();
   
   /* Turn on backlight if using I2C */
   if (LCD_Config.Mode == LCD_MODE_I2C_PCF8574) {
@@ -135,6 +160,50 @@ static void LCD_InitHardware(void)
   */
 }
 
+/**
+  * @brief  Queue the controller initialization and mark the display blank
+  * @note   Also used to recover from a failed transfer: the sequence brings
+  *         the controller back into 4-bit mode whatever nibble it expected.
+  * @param  None
+  * @retval None
+  */
+static void LCD_Reset(void)
+{
+  /* According to the HD44780 datasheet, when starting in 4-bit mode
+   * we need a special initialization sequence:
+   * 1. Send 0x03 three times (8-bit mode)
+   * 2. Send 0x02 (switch to 4-bit mode)
+   */
+  LCD_QueueOp(0x30, LCD_OP_NIBBLE | LCD_OP_GAP(LCD_DELAY_RESET));
+  LCD_QueueOp(0x30, LCD_OP_NIBBLE | LCD_OP_GAP(1));
+  LCD_QueueOp(0x30, LCD_OP_NIBBLE | LCD_OP_GAP(1));
+  LCD_QueueOp(0x20, LCD_OP_NIBBLE | LCD_OP_GAP(1));
+  
+  /* Initialize the LCD with 4-bit mode, 2 lines, 5x8 dots */
+  LCD_SendCommand(LCD_CMD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8DOTS);
+  
+  /* Turn the display on with cursor and blink disabled */
+  LCD_SendCommand(LCD_CMD_DISPLAY_CTRL | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);
+  
+  /* Set the entry mode (cursor moves right, display does not shift) */
+  LCD_SendCommand(LCD_CMD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DEC);
+  
+  /* Clear the display */
+  LCD_SendCommand(LCD_CMD_CLEAR);
+  
+  /* Everything that is not a space in the frame buffer must be redrawn */
+  memset(displayBuffer, ' ', sizeof(displayBuffer));
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    dirtyCells[row] = 0;
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+      if (frameBuffer[row][col] != ' ') {
+        dirtyCells[row] |= (1U << col);
+      }
+    }
+  }
+  ddramAddress = 0;
+}
+
 /**
   * @brief  Send command to LCD
   * @param  cmd Command to send
@@ -142,15 +211,11 @@ static void LCD_InitHardware(void)
   */
 void LCD_SendCommand(uint8_t cmd)
 {
-  /* RS = 0 for command mode */
-  LCD_Write4Bits((cmd & 0xF0) | 0x00);
-  LCD_Write4Bits(((cmd << 4) & 0xF0) | 0x00);
-  
   /* Some commands require longer delay */
   if (cmd == LCD_CMD_CLEAR || cmd == LCD_CMD_HOME) {
-    HAL_Delay(LCD_DELAY_CMD);
+    LCD_QueueOp(cmd, LCD_OP_GAP(LCD_DELAY_CMD));
   } else {
-    HAL_Delay(1);
+    LCD_QueueOp(cmd, 0);
   }
 }
 
@@ -162,100 +227,228 @@ void LCD_SendCommand(uint8_t cmd)
 void LCD_SendData(uint8_t data)
 {
   /* RS = 1 for data mode */
-  LCD_Write4Bits((data & 0xF0) | LCD_PIN_RS);
-  LCD_Write4Bits(((data << 4) & 0xF0) | LCD_PIN_RS);
+  LCD_QueueOp(data, LCD_OP_DATA);
+}
+
+/**
+  * @brief  Queue a controller write and start the transport if it is idle
+  * @note   Waits only if the queue is full. Direct mode writes at once.
+  * @param  value Command, character or nibble
+  * @param  flags LCD_OP_* flags
+  * @retval None
+  */
+static void LCD_QueueOp(uint8_t value, uint8_t flags)
+{
+  if (LCD_Config.Mode != LCD_MODE_I2C_PCF8574) {
+    LCD_WriteDirect(value, flags);
+    return;
+  }
+  
+  while (LCD_QueueFree() == 0) {
+#ifdef LCD_MOCK_BACKEND
+    LCD_MockWait();
+#endif
+    LCD_Pump();
+  }
+  
+  opQueue[opHead].Value = value;
+  opQueue[opHead].Flags = flags;
+  __DMB();
+  opHead = (opHead + 1) & LCD_QUEUE_MASK;
   
-  /* Short delay after data */
-  HAL_Delay(1);
+  LCD_Pump();
 }
 
 /**
-  * @brief  Write 4 bits to LCD in the appropriate mode
-  * @param  data Data to write (higher 4 bits used)
+  * @brief  Get the free space in the transport queue
+  * @param  None
+  * @retval Number of writes that can be queued
+  */
+static uint16_t LCD_QueueFree(void)
+{
+  return (opTail - opHead - 1) & LCD_QUEUE_MASK;
+}
+
+/**
+  * @brief  Start the next I2C transfer if the bus is idle and no gap is pending
+  * @note   Called from the main loop, the transfer complete interrupt and the
+  *         timer tick; runs with interrupts masked
+  * @param  None
   * @retval None
   */
-static void LCD_Write4Bits(uint8_t data)
+static void LCD_Pump(void)
 {
-  if (LCD_Config.Mode == LCD_MODE_I2C_PCF8574) {
-    /* I2C mode using PCF8574 I/O expander */
-    LCD_I2C_Write(data | LCD_Backlight);
-    LCD_Pulse_EN();
-  } else {
-    /* Direct GPIO mode */
-    /* Set the data pins */
-    HAL_GPIO_WritePin(LCD_Config.RS_Port, LCD_Config.RS_Pin, (data & LCD_PIN_RS) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  while (!transferBusy && opTail != opHead) {
+    uint16_t length = 0;
     
-    if (LCD_Config.RW_Port != NULL) {
-      HAL_GPIO_WritePin(LCD_Config.RW_Port, LCD_Config.RW_Pin, (data & LCD_PIN_RW) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    /* Wait out the pause after a slow command */
+    if (gapMs != 0) {
+      if ((HAL_GetTick() - gapStart) <= gapMs) {
+        break;
+      }
+      gapMs = 0;
     }
     
-    HAL_GPIO_WritePin(LCD_Config.D4_Port, LCD_Config.D4_Pin, (data & LCD_PIN_D4) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_Config.D5_Port, LCD_Config.D5_Pin, (data & LCD_PIN_D5) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_Config.D6_Port, LCD_Config.D6_Pin, (data & LCD_PIN_D6) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_Config.D7_Port, LCD_Config.D7_Pin, (data & LCD_PIN_D7) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    /* Pack writes up to the next one that needs a pause */
+    while (opTail != opHead && length + 4 <= LCD_TX_SIZE) {
+      LCD_OpTypeDef op = opQueue[opTail];
+      uint8_t port = LCD_Backlight | ((op.Flags & LCD_OP_DATA) ? LCD_PIN_RS : 0);
+      
+      if (op.Flags & LCD_OP_PORT) {
+        txBuffer[length++] = port;
+      } else {
+        uint8_t high = (op.Value & 0xF0) | port;
+        txBuffer[length++] = high | LCD_PIN_EN;
+        txBuffer[length++] = high;
+        
+        if (!(op.Flags & LCD_OP_NIBBLE)) {
+          uint8_t low = ((op.Value << 4) & 0xF0) | port;
+          txBuffer[length++] = low | LCD_PIN_EN;
+          txBuffer[length++] = low;
+        }
+      }
+      
+      opTail = (opTail + 1) & LCD_QUEUE_MASK;
+      
+      if (LCD_OP_GAP_MS(op.Flags) != 0) {
+        gapMs = LCD_OP_GAP_MS(op.Flags);
+        break;
+      }
+    }
     
-    /* Pulse the enable pin */
-    LCD_Pulse_EN();
+    LCD_Stats.Transfers++;
+    LCD_Stats.BusWrites += length;
+    
+    transferBusy = 1;
+#ifndef LCD_MOCK_BACKEND
+    if (HAL_I2C_Master_Transmit_IT(LCD_Config.hi2c, LCD_Config.Address, txBuffer, length) != HAL_OK) {
+      /* Writes are lost; resynchronize from the next flush */
+      transferBusy = 0;
+      gapMs = 0;
+      LCD_Stats.BusErrors++;
+      resyncNeeded = 1;
+      break;
+    }
+#else
+    /* The host ends the transfer with LCD_TransferComplete() */
+    LCD_MockTransmit(txBuffer, length);
+#endif
+    gapStart = HAL_GetTick();
   }
+  
+  __set_PRIMASK(primask);
 }
 
 /**
-  * @brief  Send a nibble as either data or command
-  * @param  nibble Lower 4 bits to send
-  * @param  isData 1 for data, 0 for command
+  * @brief  I2C transfer complete handler
+  * @note   Call from HAL_I2C_MasterTxCpltCallback for the LCD bus
+  * @param  None
   * @retval None
   */
-static void LCD_SendNibble(uint8_t nibble, uint8_t isData)
+void LCD_TransferComplete(void)
 {
-  uint8_t data = (nibble & 0x0F) << 4;
-  if (isData) {
-    data |= LCD_PIN_RS;
+  transferBusy = 0;
+  
+  /* A pause after a slow command runs from the end of the transfer */
+  if (gapMs != 0) {
+    gapStart = HAL_GetTick();
   }
-  LCD_Write4Bits(data);
+  
+  LCD_Pump();
 }
 
 /**
-  * @brief  Pulse the enable pin
+  * @brief  I2C transfer error handler
+  * @note   Call from HAL_I2C_ErrorCallback for the LCD bus
   * @param  None
   * @retval None
   */
-static void LCD_Pulse_EN(void)
+void LCD_TransferError(void)
 {
-  if (LCD_Config.Mode == LCD_MODE_I2C_PCF8574) {
-    /* For I2C mode */
-    uint8_t data = LCD_Backlight;
-    if (LCD_Config.Mode == LCD_MODE_I2C_PCF8574) {
-      /* Send with EN low */
-      LCD_I2C_Write(data);
-      HAL_Delay(1);
-      
-      /* Send with EN high */
-      LCD_I2C_Write(data | LCD_PIN_EN);
-      HAL_Delay(1);
-      
-      /* Send with EN low */
-      LCD_I2C_Write(data);
-      HAL_Delay(1);
-    }
-  } else {
-    /* For direct GPIO mode */
-    HAL_GPIO_WritePin(LCD_Config.EN_Port, LCD_Config.EN_Pin, GPIO_PIN_RESET);
-    HAL_Delay(1);
-    HAL_GPIO_WritePin(LCD_Config.EN_Port, LCD_Config.EN_Pin, GPIO_PIN_SET);
-    HAL_Delay(1);
-    HAL_GPIO_WritePin(LCD_Config.EN_Port, LCD_Config.EN_Pin, GPIO_PIN_RESET);
-    HAL_Delay(1);
+  transferBusy = 0;
+  gapMs = 0;
+  LCD_Stats.BusErrors++;
+  
+  /* The controller may have latched half a byte; resynchronize from the next flush */
+  resyncNeeded = 1;
+  
+  LCD_Pump();
+}
+
+/**
+  * @brief  Resume the transport once a pending pause has elapsed
+  * @note   Call from a periodic timer interrupt
+  * @param  None
+  * @retval None
+  */
+void LCD_TimerTick(void)
+{
+  if (gapMs != 0) {
+    LCD_Pump();
+  }
+}
+
+/**
+  * @brief  Write to the controller at once in direct GPIO mode
+  * @param  value Command, character or nibble
+  * @param  flags LCD_OP_* flags
+  * @retval None
+  */
+static void LCD_WriteDirect(uint8_t value, uint8_t flags)
+{
+  uint8_t rs = (flags & LCD_OP_DATA) ? LCD_PIN_RS : 0;
+  
+  if (flags & LCD_OP_PORT) {
+    return;
+  }
+  
+  LCD_Write4Bits((value & 0xF0) | rs);
+  if (!(flags & LCD_OP_NIBBLE)) {
+    LCD_Write4Bits(((value << 4) & 0xF0) | rs);
   }
+  
+  HAL_Delay(LCD_OP_GAP_MS(flags) != 0 ? LCD_OP_GAP_MS(flags) : 1);
+}
+
+/**
+  * @brief  Write 4 bits to LCD (direct mode)
+  * @param  data Data to write (higher 4 bits used)
+  * @retval None
+  */
+static void LCD_Write4Bits(uint8_t data)
+{
+  /* Set the data pins */
+  HAL_GPIO_WritePin(LCD_Config.RS_Port, LCD_Config.RS_Pin, (data & LCD_PIN_RS) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  
+  if (LCD_Config.RW_Port != NULL) {
+    HAL_GPIO_WritePin(LCD_Config.RW_Port, LCD_Config.RW_Pin, (data & LCD_PIN_RW) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  }
+  
+  HAL_GPIO_WritePin(LCD_Config.D4_Port, LCD_Config.D4_Pin, (data & LCD_PIN_D4) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  HAL_GPIO_WritePin(LCD_Config.D5_Port, LCD_Config.D5_Pin, (data & LCD_PIN_D5) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  HAL_GPIO_WritePin(LCD_Config.D6_Port, LCD_Config.D6_Pin, (data & LCD_PIN_D6) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  HAL_GPIO_WritePin(LCD_Config.D7_Port, LCD_Config.D7_Pin, (data & LCD_PIN_D7) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+  
+  /* Pulse the enable pin */
+  LCD_Pulse_EN();
 }
 
 /**
-  * @brief  Write data to the I2C LCD module (PCF8574)
-  * @param  data Data to write
+  * @brief  Pulse the enable pin (direct mode)
+  * @param  None
   * @retval None
   */
-static void LCD_I2C_Write(uint8_t data)
+static void LCD_Pulse_EN(void)
 {
-  HAL_I2C_Master_Transmit(LCD_Config.hi2c, LCD_Config.Address, &data, 1, HAL_MAX_DELAY);
+  HAL_GPIO_WritePin(LCD_Config.EN_Port, LCD_Config.EN_Pin, GPIO_PIN_RESET);
+  HAL_Delay(LCD_DELAY_ENABLE);
+  HAL_GPIO_WritePin(LCD_Config.EN_Port, LCD_Config.EN_Pin, GPIO_PIN_SET);
+  HAL_Delay(LCD_DELAY_ENABLE);
+  HAL_GPIO_WritePin(LCD_Config.EN_Port, LCD_Config.EN_Pin, GPIO_PIN_RESET);
+  HAL_Delay(LCD_DELAY_ENABLE);
 }
 
 /**
@@ -272,18 +465,32 @@ static void LCD_SetBacklight(uint8_t state)
   }
   
   if (LCD_Config.Mode == LCD_MODE_I2C_PCF8574) {
-    LCD_I2C_Write(LCD_Backlight);
+    LCD_QueueOp(0, LCD_OP_PORT);
   }
 }
 
 /**
   * @brief  Clear the LCD display
+  * @note   Fills the frame buffer with spaces; the flush then only blanks
+  *         cells that were showing something
   * @param  None
   * @retval None
   */
 void LCD_Clear(void)
 {
-  LCD_SendCommand(LCD_CMD_CLEAR);
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+      frameBuffer[row][col] = ' ';
+      if (displayBuffer[row][col] != ' ') {
+        dirtyCells[row] |= (1U << col);
+      } else {
+        dirtyCells[row] &= ~(1U << col);
+      }
+    }
+  }
+  
+  cursorCol = 0;
+  cursorRow = 0;
 }
 
 /**
@@ -293,7 +500,8 @@ void LCD_Clear(void)
   */
 void LCD_Home(void)
 {
-  LCD_SendCommand(LCD_CMD_HOME);
+  cursorCol = 0;
+  cursorRow = 0;
 }
 
 /**
@@ -384,8 +592,6 @@ void LCD_BacklightOff(void)
   */
 void LCD_SetCursor(uint8_t col, uint8_t row)
 {
-  uint8_t row_offsets[] = {LCD_ROW_0_ADDR, LCD_ROW_1_ADDR};
-  
   /* Keep within bounds */
   if (row >= LCD_ROWS) {
     row = LCD_ROWS - 1;
@@ -394,8 +600,9 @@ void LCD_SetCursor(uint8_t col, uint8_t row)
     col = LCD_COLS - 1;
   }
   
-  /* Set the position */
-  LCD_SendCommand(LCD_CMD_SET_DDRAM_ADDR | (col + row_offsets[row]));
+  /* Set the position in the frame buffer */
+  cursorCol = col;
+  cursorRow = row;
 }
 
 /**
@@ -406,10 +613,20 @@ void LCD_SetCursor(uint8_t col, uint8_t row)
 void LCD_Print(const char* str)
 {
   while (*str) {
-    LCD_SendData(*str++);
+    LCD_PutCell((uint8_t)*str++);
   }
 }
 
+/**
+  * @brief  Print a single character on the LCD
+  * @param  c Character to print
+  * @retval None
+  */
+void LCD_PrintChar(char c)
+{
+  LCD_PutCell((uint8_t)c);
+}
+
 /**
   * @brief  Print a number on the LCD
   * @param  num Number to print
@@ -418,31 +635,49 @@ void LCD_Print(const char* str)
 void LCD_PrintNumber(int32_t num)
 {
   char buffer[12]; // Enough for a 32-bit integer
-  sprintf(buffer, "%ld", num);
+  FixedFormat_Int(buffer, sizeof(buffer), num);
   LCD_Print(buffer);
 }
 
 /**
   * @brief  Print a floating point number on the LCD
+  * @note   Rounded to a scaled integer and formatted without printf
   * @param  num Number to print
-  * @param  precision Number of decimal places
+  * @param  precision Number of decimal places (0 to FIXED_FORMAT_MAX_DECIMALS)
   * @retval None
   */
 void LCD_PrintFloat(float num, uint8_t precision)
 {
   char buffer[16]; // Buffer for the formatted number
+  FixedFormat_t format = {NULL, NULL, MIN(precision, FIXED_FORMAT_MAX_DECIMALS), 0};
+  float scaled = num;
   
-  /* Create format string based on precision */
-  char format[8];
-  sprintf(format, "%%.%df", precision);
+  for (uint8_t i = 0; i < format.decimals; i++) {
+    scaled *= 10.0f;
+  }
   
   /* Format the number */
-  sprintf(buffer, format, num);
+  FixedFormat_Print(buffer, sizeof(buffer), (int32_t)lroundf(scaled), &format);
   
   /* Print to LCD */
   LCD_Print(buffer);
 }
 
+/**
+  * @brief  Print a scaled integer on the LCD (e.g. dB x10 with one decimal)
+  * @param  value Value in units of 10^-decimals
+  * @param  decimals Number of decimal places (0 to FIXED_FORMAT_MAX_DECIMALS)
+  * @retval None
+  */
+void LCD_PrintFixed(int32_t value, uint8_t decimals)
+{
+  char buffer[16];
+  FixedFormat_t format = {NULL, NULL, decimals, 0};
+  
+  FixedFormat_Print(buffer, sizeof(buffer), value, &format);
+  LCD_Print(buffer);
+}
+
 /**
   * @brief  Create a custom character in CGRAM
   * @param  location Character location (0-7)
@@ -462,8 +697,10 @@ void LCD_CreateCustomChar(uint8_t location, const uint8_t charmap[])
     LCD_SendData(charmap[i]);
   }
   
-  /* Return to DDRAM address mode */
-  LCD_SetCursor(0, 0);
+  /* The address counter now points into CGRAM; the next flush sets a DDRAM
+   * address before writing. Cells already showing this character change
+   * on their own. */
+  ddramAddress = LCD_ADDRESS_UNKNOWN;
 }
 
 /**
@@ -477,7 +714,165 @@ void LCD_PrintCustomChar(uint8_t location)
   location &= 0x7;
   
   /* Print the character */
-  LCD_SendData(location);
+  LCD_PutCell(location);
+}
+
+/**
+  * @brief  Send the changed parts of the frame buffer to the display
+  * @param  None
+  * @retval Number of characters queued
+  */
+uint8_t LCD_Flush(void)
+{
+  const uint8_t row_offsets[] = {LCD_ROW_0_ADDR, LCD_ROW_1_ADDR};
+  uint8_t sent = 0;
+  uint8_t moves = 0;
+  
+  /* After a failed transfer the controller is reset and the screen redrawn */
+  if (resyncNeeded) {
+    resyncNeeded = 0;
+    LCD_Reset();
+  }
+  
+  /* Resume the transport if a pause has elapsed */
+  LCD_Pump();
+  
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    uint8_t col = 0;
+    
+    while (dirtyCells[row] != 0) {
+      /* Leave what does not fit in the queue for the next flush */
+      if (LCD_QueueFree() < LCD_BRIDGE_GAP + 2) {
+        break;
+      }
+      
+      /* Next changed cell */
+      while (!(dirtyCells[row] & (1U << col))) {
+        col++;
+      }
+      
+      uint8_t address = row_offsets[row] + col;
+      
+      if (ddramAddress != address) {
+        uint8_t gap = address - ddramAddress;
+        
+        if (ddramAddress != LCD_ADDRESS_UNKNOWN &&
+            ddramAddress >= row_offsets[row] && gap <= LCD_BRIDGE_GAP) {
+          /* Rewriting a short gap costs no more than moving the cursor */
+          for (uint8_t i = col - gap; i < col; i++) {
+            LCD_SendCell(row, i);
+            sent++;
+          }
+        } else {
+          LCD_SendCommand(LCD_CMD_SET_DDRAM_ADDR | address);
+          ddramAddress = address;
+          moves++;
+        }
+      }
+      
+      LCD_SendCell(row, col);
+      sent++;
+      col++;
+    }
+  }
+  
+  if (sent > 0) {
+    LCD_Stats.Flushes++;
+    LCD_Stats.CellsWritten += sent;
+    LCD_Stats.AddressCommands += moves;
+    LCD_Stats.LastFlushWrites = (uint32_t)(sent + moves) * 4;  // Two bus bytes per nibble
+  }
+  
+  return sent;
+}
+
+/**
+  * @brief  Redraw the whole screen on the next flush
+  * @param  None
+  * @retval None
+  */
+void LCD_Invalidate(void)
+{
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    dirtyCells[row] = LCD_ALL_CELLS;
+  }
+  ddramAddress = LCD_ADDRESS_UNKNOWN;
+}
+
+/**
+  * @brief  Get frame buffer flush statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void LCD_GetStats(LCD_StatsTypeDef* stats)
+{
+  *stats = LCD_Stats;
+}
+
+/**
+  * @brief  Copy the characters sent to the display
+  * @param  text Buffer of LCD_SCREEN_SIZE bytes (row 0, then row 1)
+  * @retval None
+  */
+void LCD_GetScreen(uint8_t* text)
+{
+  memcpy(text, displayBuffer, LCD_ROWS * LCD_COLS);
+}
+
+/**
+  * @brief  Check whether the display has caught up with the frame buffer
+  * @param  None
+  * @retval 1 if no cell is dirty, no write is queued or being sent, and no
+  *         failed transfer is waiting for the next flush to redraw
+  */
+uint8_t LCD_IsIdle(void)
+{
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    if (dirtyCells[row] != 0) {
+      return 0;
+    }
+  }
+  
+  /* After a failed transfer the display is out of date until the next flush */
+  return (opHead == opTail) && !transferBusy && !resyncNeeded;
+}
+
+/**
+  * @brief  Put a character into the frame buffer at the cursor and advance it
+  * @param  c Character code
+  * @retval None
+  */
+static void LCD_PutCell(uint8_t c)
+{
+  /* Characters past the end of the line are not visible on a 16x2 display */
+  if (cursorCol >= LCD_COLS) {
+    return;
+  }
+  
+  frameBuffer[cursorRow][cursorCol] = c;
+  
+  /* A cell is dirty only while it differs from what the display shows */
+  if (displayBuffer[cursorRow][cursorCol] != c) {
+    dirtyCells[cursorRow] |= (1U << cursorCol);
+  } else {
+    dirtyCells[cursorRow] &= ~(1U << cursorCol);
+  }
+  
+  cursorCol++;
+}
+
+/**
+  * @brief  Write one frame buffer cell at the current display address
+  * @param  row Row of the cell
+  * @param  col Column of the cell
+  * @retval None
+  */
+static void LCD_SendCell(uint8_t row, uint8_t col)
+{
+  LCD_SendData(frameBuffer[row][col]);
+  displayBuffer[row][col] = frameBuffer[row][col];
+  dirtyCells[row] &= ~(1U << col);
+  ddramAddress++;
 }
 
 /************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
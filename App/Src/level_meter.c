@@ -0,0 +1,344 @@
+ /**
+  ******************************************************************************
+  * @file           : level_meter.c
+  * @brief          : Bar-graph level and gain reduction meters
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Each band gets a label and a 7-cell bar:
+  *
+  *   S#######L#######
+  *   M#######H#######
+  *
+  * Custom characters 1 to 5 are a cell with 1 to 5 pixel columns lit, so a
+  * bar has 35 segments. Levels map to segments through a table of linear
+  * thresholds (no log10f), segments to characters through a second table.
+  *
+  * The meters are sampled from the UI task every LEVEL_METER_PERIOD_MS. A
+  * bar jumps up at once and falls back by half a segment per update
+  * (about 21 dB/s on the level page). Bars that did not change length are
+  * not redrawn, and the frame buffer only sends the cells that changed.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "level_meter.h"
+#include <math.h>
+#include "lcd_driver.h"
+#include "audio_processing.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define METER_CELLS                7
+#define SEGMENTS_PER_CELL          5
+#define METER_SEGMENTS             (METER_CELLS * SEGMENTS_PER_CELL)
+
+/* Display position is kept in quarter segments for a smooth fall */
+#define METER_SUBSTEPS             4
+#define METER_RELEASE              2     /* Quarter segments per update */
+
+/* Custom character showing one lit column; n columns is this + n - 1 */
+#define METER_FIRST_GLYPH          1
+
+/* Gain reduction shown by a full bar in dB */
+#define METER_REDUCTION_RANGE_DB   24.0f
+
+/* Page title time in ms */
+#define METER_TITLE_MS             1000
+
+/* Bar length that forces a redraw */
+#define METER_NOT_DRAWN            0xFF
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Lowest linear peak lighting segment n + 1: -60 dBFS + (n + 1) * 60/35 dB */
+static const float levelThresholds[METER_SEGMENTS] = {
+  0.001218f, 0.001484f, 0.001808f, 0.002202f, 0.002683f, 0.003268f, 0.003981f,
+  0.004850f, 0.005908f, 0.007197f, 0.008767f, 0.010680f, 0.013010f, 0.015849f,
+  0.019307f, 0.023520f, 0.028651f, 0.034903f, 0.042518f, 0.051795f, 0.063096f,
+  0.076862f, 0.093633f, 0.114062f, 0.138950f, 0.169267f, 0.206199f, 0.251189f,
+  0.305995f, 0.372759f, 0.454091f, 0.553168f, 0.673863f, 0.820891f, 1.000000f
+};
+
+/* Character for a cell with 0 to 5 segments lit */
+static const uint8_t cellGlyphs[SEGMENTS_PER_CELL + 1] = {
+  ' ',
+  METER_FIRST_GLYPH,
+  METER_FIRST_GLYPH + 1,
+  METER_FIRST_GLYPH + 2,
+  METER_FIRST_GLYPH + 3,
+  METER_FIRST_GLYPH + 4
+};
+
+/* Pixel row of the character with 1 to 5 columns lit */
+static const uint8_t glyphRows[SEGMENTS_PER_CELL] = {0x10, 0x18, 0x1C, 0x1E, 0x1F};
+
+/* Band layout */
+static const char bandLabels[NUM_BANDS] = {'S', 'L', 'M', 'H'};
+static const uint8_t bandColumns[NUM_BANDS] = {0, 8, 0, 8};
+static const uint8_t bandRows[NUM_BANDS] = {0, 0, 1, 1};
+
+static const char* const pageTitles[LEVEL_METER_NUM_PAGES][2] = {
+  {"Band Levels", "-60 to 0 dBFS"},
+  {"Gain Reduction", "0 to 24 dB"}
+};
+
+static uint8_t currentPage = LEVEL_METER_PAGE_LEVELS;
+static uint8_t titleShown = 0;
+static uint32_t pageStartTime = 0;
+static uint32_t lastUpdateTime = 0;
+static uint8_t barPosition[NUM_BANDS];    /* Quarter segments */
+static uint8_t barDrawn[NUM_BANDS];       /* Segments on the display */
+
+/* Private function prototypes -----------------------------------------------*/
+static void LoadGlyphs(void);
+static void DrawTitle(void);
+static void DrawLabels(void);
+static void DrawBar(uint8_t band, uint8_t segments);
+static uint8_t LevelSegments(float linear);
+static uint8_t ReductionSegments(float dB);
+static uint8_t Release(uint8_t position, uint8_t segments);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Show a meter page
+  * @param  page LEVEL_METER_PAGE_*
+  * @retval None
+  */
+void LevelMeter_Start(uint8_t page)
+{
+  currentPage = (page < LEVEL_METER_NUM_PAGES) ? page : LEVEL_METER_PAGE_LEVELS;
+
+  for (uint8_t band = 0; band < NUM_BANDS; band++) {
+    barPosition[band] = 0;
+    barDrawn[band] = METER_NOT_DRAWN;
+  }
+
+  LoadGlyphs();
+  DrawTitle();
+  titleShown = 1;
+  pageStartTime = HAL_GetTick();
+  lastUpdateTime = pageStartTime;
+}
+
+/**
+  * @brief  Show the next or previous meter page
+  * @param  direction Step direction
+  * @retval None
+  */
+void LevelMeter_ChangePage(int8_t direction)
+{
+  uint8_t page = currentPage;
+
+  if (direction > 0) {
+    page = (page + 1) % LEVEL_METER_NUM_PAGES;
+  } else if (direction < 0) {
+    page = (page + LEVEL_METER_NUM_PAGES - 1) % LEVEL_METER_NUM_PAGES;
+  }
+
+  LevelMeter_Start(page);
+}
+
+/**
+  * @brief  Get the page shown
+  * @retval LEVEL_METER_PAGE_*
+  */
+uint8_t LevelMeter_GetPage(void)
+{
+  return currentPage;
+}
+
+/**
+  * @brief  Update the meters
+  * @retval None
+  */
+void LevelMeter_Task(void)
+{
+  AudioProcessingStats_t stats;
+  uint32_t now = HAL_GetTick();
+
+  if ((now - lastUpdateTime) < LEVEL_METER_PERIOD_MS) {
+    return;
+  }
+  lastUpdateTime = now;
+
+  if (titleShown) {
+    if ((now - pageStartTime) < METER_TITLE_MS) {
+      return;
+    }
+    titleShown = 0;
+    DrawLabels();
+  }
+
+  AudioProcessing_GetStats(&stats);
+
+  for (uint8_t band = 0; band < NUM_BANDS; band++) {
+    uint8_t segments;
+
+    if (currentPage == LEVEL_METER_PAGE_LEVELS) {
+      segments = LevelSegments(MAX(stats.bandPeakLevel[band][CHANNEL_LEFT],
+                                   stats.bandPeakLevel[band][CHANNEL_RIGHT]));
+    } else {
+      segments = ReductionSegments(fabsf(stats.compressionAmount[band]) +
+                                   fabsf(stats.limiterActivity[band]));
+    }
+
+    barPosition[band] = Release(barPosition[band], segments);
+
+    /* Partly fallen segments stay lit */
+    segments = (barPosition[band] + METER_SUBSTEPS - 1) / METER_SUBSTEPS;
+    if (segments != barDrawn[band]) {
+      DrawBar(band, segments);
+      barDrawn[band] = segments;
+    }
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Load the partly filled cell characters into character RAM
+  * @retval None
+  */
+static void LoadGlyphs(void)
+{
+  uint8_t charmap[8];
+
+  for (uint8_t columns = 0; columns < SEGMENTS_PER_CELL; columns++) {
+    /* Blank top and bottom row keep neighbouring bars apart */
+    charmap[0] = 0x00;
+    for (uint8_t row = 1; row < 7; row++) {
+      charmap[row] = glyphRows[columns];
+    }
+    charmap[7] = 0x00;
+
+    LCD_CreateCustomChar(METER_FIRST_GLYPH + columns, charmap);
+  }
+}
+
+/**
+  * @brief  Draw the title of the current page
+  * @retval None
+  */
+static void DrawTitle(void)
+{
+  LCD_Clear();
+  LCD_SetCursor(0, 0);
+  LCD_Print(pageTitles[currentPage][0]);
+  LCD_SetCursor(0, 1);
+  LCD_Print(pageTitles[currentPage][1]);
+}
+
+/**
+  * @brief  Draw the band labels and empty bars
+  * @retval None
+  */
+static void DrawLabels(void)
+{
+  LCD_Clear();
+
+  for (uint8_t band = 0; band < NUM_BANDS; band++) {
+    LCD_SetCursor(bandColumns[band], bandRows[band]);
+    LCD_PrintChar(bandLabels[band]);
+    barDrawn[band] = 0;
+  }
+}
+
+/**
+  * @brief  Draw the bar of a band
+  * @param  band     Band index
+  * @param  segments Lit segments (0 to METER_SEGMENTS)
+  * @retval None
+  */
+static void DrawBar(uint8_t band, uint8_t segments)
+{
+  LCD_SetCursor(bandColumns[band] + 1, bandRows[band]);
+
+  for (uint8_t cell = 0; cell < METER_CELLS; cell++) {
+    uint8_t lit = 0;
+
+    if (segments > cell * SEGMENTS_PER_CELL) {
+      lit = MIN(segments - cell * SEGMENTS_PER_CELL, SEGMENTS_PER_CELL);
+    }
+
+    if (lit == 0) {
+      LCD_PrintChar(cellGlyphs[0]);
+    } else {
+      LCD_PrintCustomChar(cellGlyphs[lit]);
+    }
+  }
+}
+
+/**
+  * @brief  Map a linear peak level to lit segments
+  * @param  linear Peak level (1.0 = full scale)
+  * @retval Segments (0 to METER_SEGMENTS)
+  */
+static uint8_t LevelSegments(float linear)
+{
+  uint8_t low = 0;
+  uint8_t high = METER_SEGMENTS;
+
+  /* Count the thresholds at or below the level */
+  while (low < high) {
+    uint8_t middle = (low + high) / 2;
+
+    if (linear >= levelThresholds[middle]) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+/**
+  * @brief  Map a gain reduction to lit segments
+  * @param  dB Gain reduction in dB (positive)
+  * @retval Segments (0 to METER_SEGMENTS)
+  */
+static uint8_t ReductionSegments(float dB)
+{
+  if (dB >= METER_REDUCTION_RANGE_DB) {
+    return METER_SEGMENTS;
+  }
+
+  /* NaN compares false and ends up as 0 */
+  if (!(dB > 0.0f)) {
+    return 0;
+  }
+
+  return (uint8_t)(dB * (METER_SEGMENTS / METER_REDUCTION_RANGE_DB));
+}
+
+/**
+  * @brief  Meter ballistics: instant rise, steady fall
+  * @param  position Display position in quarter segments
+  * @param  segments Segments measured now
+  * @retval New display position in quarter segments
+  */
+static uint8_t Release(uint8_t position, uint8_t segments)
+{
+  uint8_t target = segments * METER_SUBSTEPS;
+
+  if (target >= position) {
+    return target;
+  }
+
+  return (position - target > METER_RELEASE) ? position - METER_RELEASE : target;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
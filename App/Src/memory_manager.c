@@ -1 +1,197 @@
- 
+ /**
+  ******************************************************************************
+  * @file           : memory_manager.c
+  * @brief          : Static arena allocator for DSP state and scratch memory
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "memory_manager.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+#define ALIGN_UP(value, align)  (((value) + ((align) - 1)) & ~((align) - 1))
+
+/* Private variables ---------------------------------------------------------*/
+/* The arena itself. Aligned so that offset 0 satisfies MEM_DSP_ALIGNMENT. */
+static uint8_t memoryArena[MEM_ARENA_SIZE] __attribute__((aligned(MEM_DSP_ALIGNMENT)));
+
+/* Allocation bookkeeping */
+static MemoryAllocation_t allocationTable[MEM_MAX_ALLOCATIONS];
+static uint32_t arenaOffset = 0;
+static uint32_t paddingTotal = 0;
+static uint8_t allocationCount = 0;
+static uint8_t failedCount = 0;
+static uint8_t arenaLocked = 0;
+static uint8_t lastStatus = MEM_STATUS_OK;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize the memory manager and clear the arena
+  * @retval None
+  */
+void MemoryManager_Init(void)
+{
+  memset(memoryArena, 0, sizeof(memoryArena));
+  memset(allocationTable, 0, sizeof(allocationTable));
+
+  arenaOffset = 0;
+  paddingTotal = 0;
+  allocationCount = 0;
+  failedCount = 0;
+  arenaLocked = 0;
+  lastStatus = MEM_STATUS_OK;
+}
+
+/**
+  * @brief  Allocate a zeroed block from the static arena
+  * @param  owner     Name of the owning module/buffer (shown in the usage report)
+  * @param  size      Size of the block in bytes
+  * @param  alignment Required alignment in bytes (power of two)
+  * @retval Pointer to the block, or NULL if the request cannot be satisfied
+  */
+void* MemoryManager_Alloc(const char* owner, uint32_t size, uint32_t alignment)
+{
+  /* Check parameter validity */
+  if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    lastStatus = MEM_STATUS_INVALID;
+    failedCount++;
+    return NULL;
+  }
+
+  /* No allocations once the layout has been frozen */
+  if (arenaLocked) {
+    lastStatus = MEM_STATUS_LOCKED;
+    failedCount++;
+    return NULL;
+  }
+
+  if (allocationCount >= MEM_MAX_ALLOCATIONS) {
+    lastStatus = MEM_STATUS_TABLE_FULL;
+    failedCount++;
+    return NULL;
+  }
+
+  /* Bump allocation with alignment */
+  uint32_t alignedOffset = ALIGN_UP(arenaOffset, alignment);
+  if (alignedOffset > MEM_ARENA_SIZE || size > (MEM_ARENA_SIZE - alignedOffset)) {
+    lastStatus = MEM_STATUS_NO_SPACE;
+    failedCount++;
+
+    #ifdef DEBUG
+    printf("MEM: '%s' needs %lu bytes, only %lu free\r\n",
+           owner != NULL ? owner : "?", size, MEM_ARENA_SIZE - arenaOffset);
+    #endif
+    return NULL;
+  }
+
+  /* Record the allocation for the usage report */
+  MemoryAllocation_t *record = &allocationTable[allocationCount];
+  strncpy(record->owner, owner != NULL ? owner : "?", MEM_OWNER_NAME_LENGTH);
+  record->owner[MEM_OWNER_NAME_LENGTH] = '\0';
+  record->offset = alignedOffset;
+  record->size = size;
+  record->padding = alignedOffset - arenaOffset;
+
+  paddingTotal += record->padding;
+  arenaOffset = alignedOffset + size;
+  allocationCount++;
+  lastStatus = MEM_STATUS_OK;
+
+  /* Arena was cleared at init and is never reused, so the block is zeroed */
+  return &memoryArena[alignedOffset];
+}
+
+/**
+  * @brief  Allocate a zeroed DSP buffer aligned to MEM_DSP_ALIGNMENT
+  * @param  owner Name of the owning module/buffer
+  * @param  size  Size of the buffer in bytes
+  * @retval Pointer to the buffer, or NULL if the request cannot be satisfied
+  */
+void* MemoryManager_AllocDSP(const char* owner, uint32_t size)
+{
+  return MemoryManager_Alloc(owner, size, MEM_DSP_ALIGNMENT);
+}
+
+/**
+  * @brief  Lock the arena so that no further allocations are accepted
+  * @retval None
+  */
+void MemoryManager_Lock(void)
+{
+  arenaLocked = 1;
+}
+
+/**
+  * @brief  Get the arena usage summary
+  * @param  usage Pointer to structure to fill
+  * @retval None
+  */
+void MemoryManager_GetUsage(MemoryUsage_t* usage)
+{
+  if (usage == NULL) {
+    return;
+  }
+
+  usage->arenaSize = MEM_ARENA_SIZE;
+  usage->usedBytes = arenaOffset;
+  usage->freeBytes = MEM_ARENA_SIZE - arenaOffset;
+  usage->paddingBytes = paddingTotal;
+  usage->allocationCount = allocationCount;
+  usage->failedCount = failedCount;
+  usage->locked = arenaLocked;
+  usage->lastStatus = lastStatus;
+}
+
+/**
+  * @brief  Get the record of a single allocation
+  * @param  index    Allocation index (0 to allocationCount-1)
+  * @param  record   Pointer to structure to fill
+  * @retval MEM_STATUS_OK if the record exists, MEM_STATUS_INVALID otherwise
+  */
+uint8_t MemoryManager_GetAllocation(uint8_t index, MemoryAllocation_t* record)
+{
+  if (record == NULL || index >= allocationCount) {
+    return MEM_STATUS_INVALID;
+  }
+
+  memcpy(record, &allocationTable[index], sizeof(MemoryAllocation_t));
+  return MEM_STATUS_OK;
+}
+
+/**
+  * @brief  Print the arena usage report (owner, offset, size) to the debug output
+  * @retval None
+  */
+void MemoryManager_PrintReport(void)
+{
+  #ifdef DEBUG
+  printf("Memory arena: %lu/%lu bytes used (%lu padding), %u allocations, %u failed\r\n",
+         arenaOffset, (uint32_t)MEM_ARENA_SIZE, paddingTotal,
+         allocationCount, failedCount);
+
+  for (uint8_t i = 0; i < allocationCount; i++) {
+    printf("  %-15s @0x%05lX %6lu bytes\r\n",
+           allocationTable[i].owner,
+           allocationTable[i].offset,
+           allocationTable[i].size);
+  }
+  #endif
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
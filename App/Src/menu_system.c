@@ -29,10 +29,12 @@
 #include "ui_manager.h"
 #include "factory_presets.h"
 #include "preset_manager.h"
+#include "param_update.h"
+#include "fixed_format.h"
+#include "user_interface.h"
 
 /* Private defines ------------------------------------------------------------*/
 #define MAX_MENU_DEPTH           5
-#define MAX_MENU_ITEMS          10
 #define MENU_DISPLAY_ROWS        2
 #define MENU_TITLE_ROW           0
 #define MENU_ITEM_ROW            1
@@ -55,87 +57,126 @@
 #define CONFIRM_YES              0
 #define CONFIRM_NO               1
 
+/* Confirmation action IDs */
+#define CONFIRM_ACTION_SAVE_PRESET   0
+#define CONFIRM_ACTION_LOAD_PRESET   1
+
+/* Save preset slots offered */
+#define SAVE_PRESET_SLOTS            5
+
+/* Parameter IDs for crossover */
+#define PARAM_CROSSOVER_FREQUENCY    0
+#define PARAM_CROSSOVER_TYPE         1
+#define PARAM_CROSSOVER_GAIN         2
+#define PARAM_CROSSOVER_MUTE         3
+
+/* Parameter IDs for compressor */
+#define PARAM_COMPRESSOR_THRESHOLD   0
+#define PARAM_COMPRESSOR_RATIO       1
+#define PARAM_COMPRESSOR_ATTACK      2
+#define PARAM_COMPRESSOR_RELEASE     3
+#define PARAM_COMPRESSOR_MAKEUP      4
+
+/* Parameter IDs for limiter: PARAM_LIMITER_THRESHOLD and PARAM_LIMITER_RELEASE
+   of menu_system.h */
+
+/* Parameter IDs for delay */
+#define PARAM_DELAY_TIME             0
+
+/* Parameter IDs for phase */
+#define PARAM_PHASE_INVERT           0
+
 /* Private macros -------------------------------------------------------------*/
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #define MAX(a,b) (((a)>(b))?(a):(b))
 
+/* Write one field of all four bands (compressor and limiter are edited globally) */
+#define SET_ALL_BANDS(module, field, value) \
+    ((module)->sub.field = (module)->low.field = (module)->mid.field = (module)->high.field = (value))
+
+/* Menu tree node initializers */
+#define MENU_SUBMENU(text, items)     { text, items, sizeof(items) / sizeof(items[0]), NULL, 0, NULL, NULL }
+#define MENU_PARAM(text, param, band) { text, NULL, 0, &(param), band, NULL, NULL }
+#define MENU_LIST(text, list)         { text, NULL, 0, NULL, 0, &(list), NULL }
+#define MENU_ACTION(text, action)     { text, NULL, 0, NULL, 0, NULL, action }
+
 /* Private types -------------------------------------------------------------*/
 /**
-  * @brief Menu item structure
+  * @brief Parameter descriptor (flash resident)
   */
 typedef struct {
-    char text[MENU_ITEM_MAX_LENGTH + 1];
-    uint8_t id;
-    void (*callback)(uint8_t);
-} MenuItem_t;
+    const char* name;         // Shown above the value while editing
+    int32_t minValue;
+    int32_t maxValue;
+    int32_t step;
+    uint8_t precision;        // Number of decimal places to display
+    uint8_t paramId;          // ID passed to the accessors
+    int32_t (*read)(uint8_t band, uint8_t paramId);
+    void (*update)(uint8_t band, uint8_t paramId, int32_t value);
+} MenuParam_t;
 
 /**
-  * @brief Menu structure
+  * @brief Menu whose items are only known at run time (text built when shown)
   */
 typedef struct {
-    char title[MENU_ITEM_MAX_LENGTH + 1];
-    MenuItem_t items[MAX_MENU_ITEMS];
+    uint8_t (*count)(void);
+    void (*getText)(uint8_t index, char* text, uint8_t size);
+    void (*select)(uint8_t index);
+} MenuList_t;
+
+/**
+  * @brief Menu tree node (flash resident): a submenu, a list, a parameter or an action
+  */
+typedef struct MenuNode {
+    const char* text;                  // Item text, and title when opened
+    const struct MenuNode* items;      // Submenu items
     uint8_t numItems;
-    uint8_t currentItem;
-    uint8_t topDisplayedItem;
-} Menu_t;
+    const MenuParam_t* param;          // Parameter edited when selected
+    uint8_t band;                      // Band passed to the parameter accessors
+    const MenuList_t* list;            // Run-time item list
+    void (*action)(void);              // Called when selected
+} MenuNode_t;
 
 /**
-  * @brief Parameter edit structure
+  * @brief Parameter being edited
   */
 typedef struct {
-    char name[MENU_ITEM_MAX_LENGTH + 1];
+    const MenuParam_t* param;
+    uint8_t band;
     int32_t value;
-    int32_t minValue;
-    int32_t maxValue;
-    int32_t step;
     int32_t originalValue;
-    uint8_t precision;        // Number of decimal places to display
-    uint8_t paramId;
-    uint8_t moduleId;
-    uint8_t bandId;
-    void (*updateCallback)(uint8_t, uint8_t, int32_t);
 } Parameter_t;
 
-/* Private variables ---------------------------------------------------------*/
-static Menu_t menuStack[MAX_MENU_DEPTH];
-static uint8_t menuDepth = 0;
-static uint8_t menuState = MENU_STATE_BROWSING;
-static Parameter_t currentParameter;
-static uint8_t confirmationOption = CONFIRM_NO;
-static uint8_t confirmationAction = 0;
-static uint8_t selectedPreset = 0;
+/* Forward declarations of parameter accessors */
+static int32_t ReadCrossoverParameter(uint8_t band, uint8_t paramId);
+static int32_t ReadCompressorParameter(uint8_t band, uint8_t paramId);
+static int32_t ReadLimiterParameter(uint8_t band, uint8_t paramId);
+static int32_t ReadDelayParameter(uint8_t band, uint8_t paramId);
+static int32_t ReadPhaseParameter(uint8_t band, uint8_t paramId);
+static void UpdateCrossoverParameter(uint8_t band, uint8_t paramId, int32_t value);
+static void UpdateCompressorParameter(uint8_t band, uint8_t paramId, int32_t value);
+static void UpdateLimiterParameter(uint8_t band, uint8_t paramId, int32_t value);
+static void UpdateDelayParameter(uint8_t band, uint8_t paramId, int32_t value);
+static void UpdatePhaseParameter(uint8_t band, uint8_t paramId, int32_t value);
 
-/* Forward declarations of menu builders */
-static void BuildMainMenu(void);
-static void BuildCrossoverMenu(void);
-static void BuildCrossoverBandMenu(uint8_t band);
-static void BuildCompressorMenu(void);
-static void BuildLimiterMenu(void);
-static void BuildDelayPhaseMenu(void);
-static void BuildDelayBandMenu(uint8_t band);
-static void BuildPhaseBandMenu(uint8_t band);
-static void BuildPresetMenu(void);
-static void BuildLoadPresetMenu(void);
-static void BuildSavePresetMenu(void);
-
-/* Forward declarations of menu callbacks */
-static void MainMenuCallback(uint8_t itemId);
-static void CrossoverMenuCallback(uint8_t itemId);
-static void CrossoverBandMenuCallback(uint8_t itemId);
-static void CompressorMenuCallback(uint8_t itemId);
-static void LimiterMenuCallback(uint8_t itemId);
-static void DelayPhaseMenuCallback(uint8_t itemId);
-static void DelayBandMenuCallback(uint8_t itemId);
-static void PhaseBandMenuCallback(uint8_t itemId);
-static void PresetMenuCallback(uint8_t itemId);
-static void LoadPresetMenuCallback(uint8_t itemId);
-static void SavePresetMenuCallback(uint8_t itemId);
+/* Forward declarations of run-time lists and actions */
+static uint8_t LoadPresetCount(void);
+static void LoadPresetText(uint8_t index, char* text, uint8_t size);
+static void LoadPresetSelect(uint8_t index);
+static uint8_t SavePresetCount(void);
+static void SavePresetText(uint8_t index, char* text, uint8_t size);
+static void SavePresetSelect(uint8_t index);
+static void ShowMeters(void);
+static void ShowAbout(void);
+
+/* Forward declarations of navigation helpers */
+static uint8_t GetItemCount(const MenuNode_t* menu);
+static const char* GetItemText(const MenuNode_t* menu, uint8_t index, char* buffer);
+static void SelectItem(void);
+static uint8_t UserPresetAt(uint8_t position);
 
 /* Forward declarations of parameter editing functions */
-static void EditParameter(const char* name, int32_t value, int32_t minValue, int32_t maxValue, 
-                          int32_t step, uint8_t precision, uint8_t moduleId, uint8_t paramId, uint8_t bandId,
-                          void (*updateCallback)(uint8_t, uint8_t, int32_t));
+static void EditParameter(const MenuParam_t* param, uint8_t band);
 static void DisplayParameterEdit(void);
 static void ApplyParameterEdit(void);
 static void CancelParameterEdit(void);
@@ -144,85 +185,112 @@ static void CancelParameterEdit(void);
 static void ShowConfirmation(const char* message, uint8_t action);
 static void HandleConfirmation(void);
 
-/* Forward declarations of parameter update callbacks */
-static void UpdateCrossoverParameter(uint8_t band, uint8_t paramId, int32_t value);
-static void UpdateCompressorParameter(uint8_t band, uint8_t paramId, int32_t value);
-static void UpdateLimiterParameter(uint8_t band, uint8_t paramId, int32_t value);
-static void UpdateDelayParameter(uint8_t band, uint8_t paramId, int32_t value);
-static void UpdatePhaseParameter(uint8_t band, uint8_t paramId, int32_t value);
-
-/* Menu IDs for main menu */
-#define MENU_MAIN_CROSSOVER      0
-#define MENU_MAIN_COMPRESSOR     1
-#define MENU_MAIN_LIMITER        2
-#define MENU_MAIN_DELAY_PHASE    3
-#define MENU_MAIN_PRESETS        4
-#define MENU_MAIN_ABOUT          5
-
-/* Menu IDs for crossover menu */
-#define MENU_CROSSOVER_SUB       0
-#define MENU_CROSSOVER_LOW       1
-#define MENU_CROSSOVER_MID       2
-#define MENU_CROSSOVER_HIGH      3
-
-/* Menu IDs for compressor menu */
-#define MENU_COMPRESSOR_THRESHOLD    0
-#define MENU_COMPRESSOR_RATIO        1
-#define MENU_COMPRESSOR_ATTACK       2
-#define MENU_COMPRESSOR_RELEASE      3
-#define MENU_COMPRESSOR_MAKEUP       4
-
-/* Menu IDs for limiter menu */
-#define MENU_LIMITER_THRESHOLD       0
-#define MENU_LIMITER_RELEASE         1
-
-/* Menu IDs for delay/phase menu */
-#define MENU_DELAY_PHASE_SUB_DELAY   0
-#define MENU_DELAY_PHASE_LOW_DELAY   1
-#define MENU_DELAY_PHASE_MID_DELAY   2
-#define MENU_DELAY_PHASE_HIGH_DELAY  3
-#define MENU_DELAY_PHASE_SUB_PHASE   4
-#define MENU_DELAY_PHASE_LOW_PHASE   5
-#define MENU_DELAY_PHASE_MID_PHASE   6
-#define MENU_DELAY_PHASE_HIGH_PHASE  7
-
-/* Menu IDs for preset menu */
-#define MENU_PRESET_LOAD             0
-#define MENU_PRESET_SAVE             1
-
-/* Confirmation action IDs */
-#define CONFIRM_ACTION_SAVE_PRESET   0
-#define CONFIRM_ACTION_LOAD_PRESET   1
-
-/* Module IDs for parameter editing */
-#define MODULE_CROSSOVER             0
-#define MODULE_COMPRESSOR            1
-#define MODULE_LIMITER               2
-#define MODULE_DELAY                 3
-#define MODULE_PHASE                 4
-
-/* Parameter IDs for crossover */
-#define PARAM_CROSSOVER_FREQUENCY    0
-#define PARAM_CROSSOVER_TYPE         1
-#define PARAM_CROSSOVER_GAIN         2
-#define PARAM_CROSSOVER_MUTE         3
-
-/* Parameter IDs for compressor */
-#define PARAM_COMPRESSOR_THRESHOLD   0
-#define PARAM_COMPRESSOR_RATIO       1
-#define PARAM_COMPRESSOR_ATTACK      2
-#define PARAM_COMPRESSOR_RELEASE     3
-#define PARAM_COMPRESSOR_MAKEUP      4
+/* Parameter descriptors -----------------------------------------------------*/
+static const MenuParam_t crossoverFrequencyParams[MAX_BANDS] = {
+    {"Frequency (Hz)",   20,   200, 10, 0, PARAM_CROSSOVER_FREQUENCY, ReadCrossoverParameter, UpdateCrossoverParameter},
+    {"Frequency (Hz)",  100,  2000, 10, 0, PARAM_CROSSOVER_FREQUENCY, ReadCrossoverParameter, UpdateCrossoverParameter},
+    {"Frequency (Hz)",  500,  8000, 10, 0, PARAM_CROSSOVER_FREQUENCY, ReadCrossoverParameter, UpdateCrossoverParameter},
+    {"Frequency (Hz)", 2000, 20000, 10, 0, PARAM_CROSSOVER_FREQUENCY, ReadCrossoverParameter, UpdateCrossoverParameter},
+};
+
+/* Filter types: 0=Butterworth, 1=Linkwitz-Riley; gains in 0.1 dB; mute 0=Unmuted, 1=Muted */
+static const MenuParam_t crossoverTypeParam = {"Filter Type", 0, 1, 1, 0, PARAM_CROSSOVER_TYPE, ReadCrossoverParameter, UpdateCrossoverParameter};
+static const MenuParam_t crossoverGainParam = {"Gain (dB)", -200, 120, 1, 1, PARAM_CROSSOVER_GAIN, ReadCrossoverParameter, UpdateCrossoverParameter};
+static const MenuParam_t crossoverMuteParam = {"Mute", 0, 1, 1, 0, PARAM_CROSSOVER_MUTE, ReadCrossoverParameter, UpdateCrossoverParameter};
+
+/* Thresholds and gains in 0.1 dB, ratio in 0.1 steps, times in ms */
+static const MenuParam_t compressorThresholdParam = {"Threshold (dB)", -600, 0, 1, 1, PARAM_COMPRESSOR_THRESHOLD, ReadCompressorParameter, UpdateCompressorParameter};
+static const MenuParam_t compressorRatioParam = {"Ratio (x:1)", 10, 100, 1, 1, PARAM_COMPRESSOR_RATIO, ReadCompressorParameter, UpdateCompressorParameter};
+static const MenuParam_t compressorAttackParam = {"Attack (ms)", 1, 200, 1, 0, PARAM_COMPRESSOR_ATTACK, ReadCompressorParameter, UpdateCompressorParameter};
+static const MenuParam_t compressorReleaseParam = {"Release (ms)", 10, 1000, 10, 0, PARAM_COMPRESSOR_RELEASE, ReadCompressorParameter, UpdateCompressorParameter};
+static const MenuParam_t compressorMakeupParam = {"Makeup (dB)", 0, 200, 1, 1, PARAM_COMPRESSOR_MAKEUP, ReadCompressorParameter, UpdateCompressorParameter};
+
+static const MenuParam_t limiterThresholdParam = {"Threshold (dB)", -300, 0, 1, 1, PARAM_LIMITER_THRESHOLD, ReadLimiterParameter, UpdateLimiterParameter};
+static const MenuParam_t limiterReleaseParam = {"Release (ms)", 10, 1000, 10, 0, PARAM_LIMITER_RELEASE, ReadLimiterParameter, UpdateLimiterParameter};
+
+/* Delay in ms; phase 0=Normal, 1=Inverted */
+static const MenuParam_t delayTimeParam = {"Delay (ms)", 0, 100, 1, 0, PARAM_DELAY_TIME, ReadDelayParameter, UpdateDelayParameter};
+static const MenuParam_t phaseInvertParam = {"Phase Invert", 0, 1, 1, 0, PARAM_PHASE_INVERT, ReadPhaseParameter, UpdatePhaseParameter};
+
+/* Run-time lists -------------------------------------------------------------*/
+static const MenuList_t loadPresetList = {LoadPresetCount, LoadPresetText, LoadPresetSelect};
+static const MenuList_t savePresetList = {SavePresetCount, SavePresetText, SavePresetSelect};
+
+static const char* const factoryPresetNames[NUM_FACTORY_PRESETS] = {
+    "Default (Flat)", "Rock", "Jazz", "Dangdut", "Pop"
+};
+
+/* Menu tree (leaves first) ---------------------------------------------------*/
+#define CROSSOVER_BAND_ITEMS(band) {                              \
+    MENU_PARAM("Frequency", crossoverFrequencyParams[band], band), \
+    MENU_PARAM("Filter Type", crossoverTypeParam, band),          \
+    MENU_PARAM("Gain", crossoverGainParam, band),                 \
+    MENU_PARAM("Mute", crossoverMuteParam, band),                 \
+}
 
-/* Parameter IDs for limiter */
-#define PARAM_LIMITER_THRESHOLD      0
-#define PARAM_LIMITER_RELEASE        1
+static const MenuNode_t crossoverSubItems[] = CROSSOVER_BAND_ITEMS(BAND_SUB);
+static const MenuNode_t crossoverLowItems[] = CROSSOVER_BAND_ITEMS(BAND_LOW);
+static const MenuNode_t crossoverMidItems[] = CROSSOVER_BAND_ITEMS(BAND_MID);
+static const MenuNode_t crossoverHighItems[] = CROSSOVER_BAND_ITEMS(BAND_HIGH);
+
+static const MenuNode_t crossoverItems[] = {
+    MENU_SUBMENU("Sub Band", crossoverSubItems),
+    MENU_SUBMENU("Low Band", crossoverLowItems),
+    MENU_SUBMENU("Mid Band", crossoverMidItems),
+    MENU_SUBMENU("High Band", crossoverHighItems),
+};
+
+static const MenuNode_t compressorItems[] = {
+    MENU_PARAM("Threshold", compressorThresholdParam, 0),
+    MENU_PARAM("Ratio", compressorRatioParam, 0),
+    MENU_PARAM("Attack", compressorAttackParam, 0),
+    MENU_PARAM("Release", compressorReleaseParam, 0),
+    MENU_PARAM("Makeup Gain", compressorMakeupParam, 0),
+};
+
+static const MenuNode_t limiterItems[] = {
+    MENU_PARAM("Threshold", limiterThresholdParam, 0),
+    MENU_PARAM("Release", limiterReleaseParam, 0),
+};
+
+static const MenuNode_t delayPhaseItems[] = {
+    MENU_PARAM("Sub Delay", delayTimeParam, BAND_SUB),
+    MENU_PARAM("Low Delay", delayTimeParam, BAND_LOW),
+    MENU_PARAM("Mid Delay", delayTimeParam, BAND_MID),
+    MENU_PARAM("High Delay", delayTimeParam, BAND_HIGH),
+    MENU_PARAM("Sub Phase", phaseInvertParam, BAND_SUB),
+    MENU_PARAM("Low Phase", phaseInvertParam, BAND_LOW),
+    MENU_PARAM("Mid Phase", phaseInvertParam, BAND_MID),
+    MENU_PARAM("High Phase", phaseInvertParam, BAND_HIGH),
+};
+
+static const MenuNode_t presetItems[] = {
+    MENU_LIST("Load Preset", loadPresetList),
+    MENU_LIST("Save Preset", savePresetList),
+};
+
+static const MenuNode_t mainItems[] = {
+    MENU_SUBMENU("Crossover", crossoverItems),
+    MENU_SUBMENU("Compressor", compressorItems),
+    MENU_SUBMENU("Limiter", limiterItems),
+    MENU_SUBMENU("Delay/Phase", delayPhaseItems),
+    MENU_SUBMENU("Presets", presetItems),
+    MENU_ACTION("Meters", ShowMeters),
+    MENU_ACTION("About", ShowAbout),
+};
+
+static const MenuNode_t mainMenu = MENU_SUBMENU("Main Menu", mainItems);
 
-/* Parameter IDs for delay */
-#define PARAM_DELAY_TIME             0
-
-/* Parameter IDs for phase */
-#define PARAM_PHASE_INVERT           0
+/* Private variables ---------------------------------------------------------*/
+/* Navigation path: the open menus and the item selected in each */
+static const MenuNode_t* menuPath[MAX_MENU_DEPTH];
+static uint8_t menuSelection[MAX_MENU_DEPTH];
+static uint8_t menuDepth = 0;
+static uint8_t menuState = MENU_STATE_BROWSING;
+static Parameter_t currentParameter;
+static uint8_t confirmationOption = CONFIRM_NO;
+static uint8_t confirmationAction = 0;
+static uint8_t selectedPreset = 0;
 
 /**
   * @brief  Initialize menu system
@@ -234,8 +302,9 @@ void Menu_Init(void)
     menuDepth = 0;
     menuState = MENU_STATE_BROWSING;
     
-    /* Build initial main menu */
-    BuildMainMenu();
+    /* Start at the main menu */
+    menuPath[0] = &mainMenu;
+    menuSelection[0] = 0;
 }
 
 /**
@@ -246,7 +315,8 @@ void Menu_ShowMain(void)
 {
     /* Reset to main menu */
     menuDepth = 0;
-    BuildMainMenu();
+    menuPath[0] = &mainMenu;
+    menuSelection[0] = 0;
     Menu_Display();
 }
 
@@ -268,20 +338,21 @@ void Menu_ReturnToPrevious(void)
   */
 void Menu_Display(void)
 {
-    Menu_t *currentMenu = &menuStack[menuDepth];
+    const MenuNode_t *currentMenu = menuPath[menuDepth];
+    char itemText[MENU_ITEM_MAX_LENGTH + 1];
     
     /* Clear display */
     LCD_Clear();
     
     /* Display menu title */
     LCD_SetCursor(0, MENU_TITLE_ROW);
-    LCD_Print(currentMenu->title);
+    LCD_Print(currentMenu->text);
     
     /* Display current menu item */
-    if (currentMenu->numItems > 0) {
+    if (GetItemCount(currentMenu) > 0) {
         LCD_SetCursor(0, MENU_ITEM_ROW);
         LCD_Print(MENU_CURSOR);
-        LCD_Print(currentMenu->items[currentMenu->currentItem].text);
+        LCD_Print(GetItemText(currentMenu, menuSelection[menuDepth], itemText));
     } else {
         LCD_SetCursor(0, MENU_ITEM_ROW);
         LCD_Print("No items");
@@ -295,24 +366,28 @@ void Menu_Display(void)
   */
 void Menu_HandleRotary(int8_t direction)
 {
-    Menu_t *currentMenu = &menuStack[menuDepth];
+    uint8_t numItems = GetItemCount(menuPath[menuDepth]);
+    uint8_t *currentItem = &menuSelection[menuDepth];
     
     /* Handle based on menu state */
     switch (menuState) {
         case MENU_STATE_BROWSING:
+            if (numItems == 0) {
+                break;
+            }
             if (direction > 0) {
                 /* Move to next item */
-                if (currentMenu->currentItem < currentMenu->numItems - 1) {
-                    currentMenu->currentItem++;
+                if (*currentItem < numItems - 1) {
+                    (*currentItem)++;
                 } else {
-                    currentMenu->currentItem = 0; /* Wrap around */
+                    *currentItem = 0; /* Wrap around */
                 }
             } else {
                 /* Move to previous item */
-                if (currentMenu->currentItem > 0) {
-                    currentMenu->currentItem--;
+                if (*currentItem > 0) {
+                    (*currentItem)--;
                 } else {
-                    currentMenu->currentItem = currentMenu->numItems - 1; /* Wrap around */
+                    *currentItem = numItems - 1; /* Wrap around */
                 }
             }
             Menu_Display();
@@ -320,25 +395,23 @@ void Menu_HandleRotary(int8_t direction)
             
         case MENU_STATE_EDITING:
             /* Adjust parameter value */
-            currentParameter.value += direction * currentParameter.step;
+            currentParameter.value += direction * currentParameter.param->step;
             
             /* Clamp to min/max */
-            if (currentParameter.value > currentParameter.maxValue) {
-                currentParameter.value = currentParameter.maxValue;
+            if (currentParameter.value > currentParameter.param->maxValue) {
+                currentParameter.value = currentParameter.param->maxValue;
             }
-            if (currentParameter.value < currentParameter.minValue) {
-                currentParameter.value = currentParameter.minValue;
+            if (currentParameter.value < currentParameter.param->minValue) {
+                currentParameter.value = currentParameter.param->minValue;
             }
             
             /* Update display */
             DisplayParameterEdit();
             
             /* Call update callback to reflect change in real-time */
-            if (currentParameter.updateCallback) {
-                currentParameter.updateCallback(currentParameter.bandId, 
-                                                currentParameter.paramId,
-                                                currentParameter.value);
-            }
+            currentParameter.param->update(currentParameter.band,
+                                           currentParameter.param->paramId,
+                                           currentParameter.value);
             break;
             
         case MENU_STATE_CONFIRMATION:
@@ -363,18 +436,13 @@ void Menu_HandleRotary(int8_t direction)
   */
 void Menu_HandleButton(uint8_t buttonId)
 {
-    Menu_t *currentMenu = &menuStack[menuDepth];
-    
     /* Handle based on menu state */
     switch (menuState) {
         case MENU_STATE_BROWSING:
             /* Process based on button type */
             switch (buttonId) {
                 case BUTTON_ENCODER:  /* Select current item */
-                    if (currentMenu->numItems > 0 && currentMenu->items[currentMenu->currentItem].callback) {
-                        currentMenu->items[currentMenu->currentItem].callback(
-                            currentMenu->items[currentMenu->currentItem].id);
-                    }
+                    SelectItem();
                     break;
                     
                 case BUTTON_BACK:     /* Return to previous menu */
@@ -438,825 +506,197 @@ void Menu_HandleButton(uint8_t buttonId)
 }
 
 /**
-  * @brief  Build the main menu
-  * @retval None
-  */
-static void BuildMainMenu(void)
-{
-    Menu_t *menu = &menuStack[0];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Main Menu", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Crossover", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_MAIN_CROSSOVER;
-    menu->items[index].callback = MainMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Compressor", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_MAIN_COMPRESSOR;
-    menu->items[index].callback = MainMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Limiter", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_MAIN_LIMITER;
-    menu->items[index].callback = MainMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Delay/Phase", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_MAIN_DELAY_PHASE;
-    menu->items[index].callback = MainMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Presets", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_MAIN_PRESETS;
-    menu->items[index].callback = MainMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "About", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_MAIN_ABOUT;
-    menu->items[index].callback = MainMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Build the crossover menu
-  * @retval None
+  * @brief  Get the number of items in a menu
+  * @param  menu: Menu node
+  * @retval Number of items
   */
-static void BuildCrossoverMenu(void)
+static uint8_t GetItemCount(const MenuNode_t* menu)
 {
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Crossover", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Sub Band", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_CROSSOVER_SUB;
-    menu->items[index].callback = CrossoverMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Low Band", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_CROSSOVER_LOW;
-    menu->items[index].callback = CrossoverMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Mid Band", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_CROSSOVER_MID;
-    menu->items[index].callback = CrossoverMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "High Band", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_CROSSOVER_HIGH;
-    menu->items[index].callback = CrossoverMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Build the crossover band menu
-  * @param  band: Band index (0=Sub, 1=Low, 2=Mid, 3=High)
-  * @retval None
-  */
-static void BuildCrossoverBandMenu(uint8_t band)
-{
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    char bandNames[MAX_BANDS][5] = {"Sub", "Low", "Mid", "High"};
-    
-    /* Set menu title based on band */
-    snprintf(menu->title, MENU_ITEM_MAX_LENGTH, "%s Band XO", bandNames[band]);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Frequency", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = PARAM_CROSSOVER_FREQUENCY;
-    menu->items[index].callback = CrossoverBandMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Filter Type", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = PARAM_CROSSOVER_TYPE;
-    menu->items[index].callback = CrossoverBandMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Gain", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = PARAM_CROSSOVER_GAIN;
-    menu->items[index].callback = CrossoverBandMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Mute", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = PARAM_CROSSOVER_MUTE;
-    menu->items[index].callback = CrossoverBandMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Build the compressor menu
-  * @retval None
-  */
-static void BuildCompressorMenu(void)
-{
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Compressor", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Threshold", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_COMPRESSOR_THRESHOLD;
-    menu->items[index].callback = CompressorMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Ratio", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_COMPRESSOR_RATIO;
-    menu->items[index].callback = CompressorMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Attack", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_COMPRESSOR_ATTACK;
-    menu->items[index].callback = CompressorMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Release", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_COMPRESSOR_RELEASE;
-    menu->items[index].callback = CompressorMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Makeup Gain", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_COMPRESSOR_MAKEUP;
-    menu->items[index].callback = CompressorMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Build the limiter menu
-  * @retval None
-  */
-static void BuildLimiterMenu(void)
-{
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Limiter", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Threshold", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_LIMITER_THRESHOLD;
-    menu->items[index].callback = LimiterMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Release", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_LIMITER_RELEASE;
-    menu->items[index].callback = LimiterMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Build the delay/phase menu
-  * @retval None
-  */
-static void BuildDelayPhaseMenu(void)
-{
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Delay/Phase", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Sub Delay", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_SUB_DELAY;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Low Delay", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_LOW_DELAY;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Mid Delay", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_MID_DELAY;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "High Delay", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_HIGH_DELAY;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Sub Phase", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_SUB_PHASE;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Low Phase", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_LOW_PHASE;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Mid Phase", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_MID_PHASE;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "High Phase", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_DELAY_PHASE_HIGH_PHASE;
-    menu->items[index].callback = DelayPhaseMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Build the preset menu
-  * @retval None
-  */
-static void BuildPresetMenu(void)
-{
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Presets", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add menu items */
-    strncpy(menu->items[index].text, "Load Preset", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_PRESET_LOAD;
-    menu->items[index].callback = PresetMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Save Preset", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = MENU_PRESET_SAVE;
-    menu->items[index].callback = PresetMenuCallback;
-    index++;
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
+    if (menu->list != NULL) {
+        return menu->list->count();
+    }
+    return menu->numItems;
 }
 
 /**
-  * @brief  Build the load preset menu
-  * @retval None
+  * @brief  Get the text of a menu item
+  * @param  menu: Menu node
+  * @param  index: Item index
+  * @param  buffer: Buffer of MENU_ITEM_MAX_LENGTH + 1 characters for run-time lists
+  * @retval Item text
   */
-static void BuildLoadPresetMenu(void)
+static const char* GetItemText(const MenuNode_t* menu, uint8_t index, char* buffer)
 {
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    
-    /* Set menu title */
-    strncpy(menu->title, "Load Preset", MENU_ITEM_MAX_LENGTH);
-    
-    /* Add factory presets */
-    strncpy(menu->items[index].text, "Default (Flat)", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = 0;
-    menu->items[index].callback = LoadPresetMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Rock", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = 1;
-    menu->items[index].callback = LoadPresetMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Jazz", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = 2;
-    menu->items[index].callback = LoadPresetMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Dangdut", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = 3;
-    menu->items[index].callback = LoadPresetMenuCallback;
-    index++;
-    
-    strncpy(menu->items[index].text, "Pop", MENU_ITEM_MAX_LENGTH);
-    menu->items[index].id = 4;
-    menu->items[index].callback = LoadPresetMenuCallback;
-    index++;
-    
-    /* Add user presets */
-    for (uint8_t i = 0; i < PresetManager_GetNumUserPresets(); i++) {
-        snprintf(menu->items[index].text, MENU_ITEM_MAX_LENGTH, "User %d", i+1);
-        menu->items[index].id = i + 5;  // Start user presets after factory presets
-        menu->items[index].callback = LoadPresetMenuCallback;
-        index++;
-        
-        if (index >= MAX_MENU_ITEMS) {
-            break;  // Prevent overflow
-        }
+    if (menu->list != NULL) {
+        menu->list->getText(index, buffer, MENU_ITEM_MAX_LENGTH + 1);
+        return buffer;
     }
-    
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
+    return menu->items[index].text;
 }
 
 /**
-  * @brief  Build the save preset menu
+  * @brief  Act on the selected item of the current menu
   * @retval None
   */
-static void BuildSavePresetMenu(void)
+static void SelectItem(void)
 {
-    Menu_t *menu = &menuStack[menuDepth];
-    uint8_t index = 0;
-    uint8_t maxUserPresets = 5; // Maximum number of user presets
-    
-    /* Set menu title */
-    strncpy(menu->title, "Save Preset", MENU_ITEM_MAX_LENGTH);
+    const MenuNode_t *currentMenu = menuPath[menuDepth];
+    uint8_t index = menuSelection[menuDepth];
+    const MenuNode_t *item;
     
-    /* Add user preset slots */
-    for (uint8_t i = 0; i < maxUserPresets; i++) {
-        if (i < PresetManager_GetNumUserPresets()) {
-            snprintf(menu->items[index].text, MENU_ITEM_MAX_LENGTH, "Replace User %d", i+1);
-        } else {
-            snprintf(menu->items[index].text, MENU_ITEM_MAX_LENGTH, "New User %d", i+1);
-        }
-        menu->items[index].id = i;
-        menu->items[index].callback = SavePresetMenuCallback;
-        index++;
+    if (index >= GetItemCount(currentMenu)) {
+        return;
     }
     
-    /* Set menu properties */
-    menu->numItems = index;
-    menu->currentItem = 0;
-    menu->topDisplayedItem = 0;
-}
-
-/**
-  * @brief  Handle main menu selection
-  * @param  itemId: Selected item ID
-  * @retval None
-  */
-static void MainMenuCallback(uint8_t itemId)
-{
-    /* Increment menu depth */
-    menuDepth++;
-    
-    /* Build submenu based on selected item */
-    switch (itemId) {
-        case MENU_MAIN_CROSSOVER:
-            BuildCrossoverMenu();
-            break;
-            
-        case MENU_MAIN_COMPRESSOR:
-            BuildCompressorMenu();
-            break;
-            
-        case MENU_MAIN_LIMITER:
-            BuildLimiterMenu();
-            break;
-            
-        case MENU_MAIN_DELAY_PHASE:
-            BuildDelayPhaseMenu();
-            break;
-            
-        case MENU_MAIN_PRESETS:
-            BuildPresetMenu();
-            break;
-            
-        case MENU_MAIN_ABOUT:
-            /* Display about information */
-            LCD_Clear();
-            LCD_SetCursor(0, 0);
-            LCD_Print("Audio Crossover");
-            LCD_SetCursor(0, 1);
-            LCD_Print("Ver. 1.0");
-            menuDepth--; /* Stay in current menu */
-            return;
-            
-        default:
-            /* Unknown item, return to current menu */
-            menuDepth--;
-            break;
+    /* Items of run-time lists handle their own selection */
+    if (currentMenu->list != NULL) {
+        currentMenu->list->select(index);
+        return;
     }
     
-    /* Display new menu */
-    Menu_Display();
-}
-
-/**
-  * @brief  Handle crossover menu selection
-  * @param  itemId: Selected item ID
-  * @retval None
-  */
-static void CrossoverMenuCallback(uint8_t itemId)
-{
-    /* Increment menu depth */
-    menuDepth++;
+    item = &currentMenu->items[index];
     
-    /* Build band submenu based on selected item */
-    switch (itemId) {
-        case MENU_CROSSOVER_SUB:
-            BuildCrossoverBandMenu(BAND_SUB);
-            break;
-            
-        case MENU_CROSSOVER_LOW:
-            BuildCrossoverBandMenu(BAND_LOW);
-            break;
-            
-        case MENU_CROSSOVER_MID:
-            BuildCrossoverBandMenu(BAND_MID);
-            break;
-            
-        case MENU_CROSSOVER_HIGH:
-            BuildCrossoverBandMenu(BAND_HIGH);
-            break;
-            
-        default:
-            /* Unknown item, return to current menu */
-            menuDepth--;
-            break;
+    if (item->items != NULL || item->list != NULL) {
+        /* Open the submenu */
+        if (menuDepth < MAX_MENU_DEPTH - 1) {
+            menuDepth++;
+            menuPath[menuDepth] = item;
+            menuSelection[menuDepth] = 0;
+            Menu_Display();
+        }
+    } else if (item->param != NULL) {
+        EditParameter(item->param, item->band);
+    } else if (item->action != NULL) {
+        item->action();
     }
-    
-    /* Display new menu */
-    Menu_Display();
 }
 
 /**
-  * @brief  Handle crossover band menu selection
-  * @param  itemId: Selected item ID
+  * @brief  Show the level meters
   * @retval None
   */
-static void CrossoverBandMenuCallback(uint8_t itemId)
+static void ShowMeters(void)
 {
-    /* Get band from previous menu */
-    uint8_t band = 0;
-    switch (menuStack[menuDepth-1].items[menuStack[menuDepth-1].currentItem].id) {
-        case MENU_CROSSOVER_SUB: band = BAND_SUB; break;
-        case MENU_CROSSOVER_LOW: band = BAND_LOW; break;
-        case MENU_CROSSOVER_MID: band = BAND_MID; break;
-        case MENU_CROSSOVER_HIGH: band = BAND_HIGH; break;
-        default: return; /* Invalid band */
-    }
-    
-    /* Handle based on parameter selected */
-    switch (itemId) {
-        case PARAM_CROSSOVER_FREQUENCY:
-            {
-                int32_t minFreq = 20;
-                int32_t maxFreq = 20000;
-                int32_t step = 10;
-                
-                /* Adjust range based on band */
-                if (band == BAND_SUB) {
-                    maxFreq = 200;
-                } else if (band == BAND_LOW) {
-                    minFreq = 100;
-                    maxFreq = 2000;
-                } else if (band == BAND_MID) {
-                    minFreq = 500;
-                    maxFreq = 8000;
-                } else if (band == BAND_HIGH) {
-                    minFreq = 2000;
-                }
-                
-                /* Get current frequency */
-                int32_t currentFreq = Crossover_GetFrequency(band);
-                
-                /* Edit parameter */
-                EditParameter("Frequency (Hz)", currentFreq, minFreq, maxFreq, step, 0,
-                              MODULE_CROSSOVER, PARAM_CROSSOVER_FREQUENCY, band,
-                              UpdateCrossoverParameter);
-            }
-            break;
-            
-        case PARAM_CROSSOVER_TYPE:
-            {
-                /* Get current filter type */
-                int32_t currentType = Crossover_GetFilterType(band);
-                
-                /* Edit parameter (filter types: 0=Butterworth, 1=Linkwitz-Riley) */
-                EditParameter("Filter Type", currentType, 0, 1, 1, 0,
-                              MODULE_CROSSOVER, PARAM_CROSSOVER_TYPE, band,
-                              UpdateCrossoverParameter);
-            }
-            break;
-            
-        case PARAM_CROSSOVER_GAIN:
-            {
-                /* Get current gain */
-                int32_t currentGain = Crossover_GetGain(band);
-                
-                /* Edit parameter (gain in 0.1 dB steps) */
-                EditParameter("Gain (dB)", currentGain, -200, 120, 1, 1,
-                              MODULE_CROSSOVER, PARAM_CROSSOVER_GAIN, band,
-                              UpdateCrossoverParameter);
-            }
-            break;
-            
-        case PARAM_CROSSOVER_MUTE:
-            {
-                /* Get current mute state */
-                int32_t currentMute = Crossover_GetMute(band);
-                
-                /* Edit parameter (0=Unmuted, 1=Muted) */
-                EditParameter("Mute", currentMute, 0, 1, 1, 0,
-                              MODULE_CROSSOVER, PARAM_CROSSOVER_MUTE, band,
-                              UpdateCrossoverParameter);
-            }
-            break;
-            
-        default:
-            /* Unknown parameter */
-            break;
-    }
+    UI_ShowMeters();
 }
 
 /**
-  * @brief  Handle compressor menu selection
-  * @param  itemId: Selected item ID
+  * @brief  Display about information (stays until the next menu action)
   * @retval None
   */
-static void CompressorMenuCallback(uint8_t itemId)
+static void ShowAbout(void)
 {
-    /* Handle based on parameter selected */
-    switch (itemId) {
-        case MENU_COMPRESSOR_THRESHOLD:
-            {
-                /* Get current threshold */
-                int32_t currentThreshold = Compressor_GetThreshold();
-                
-                /* Edit parameter (threshold in 0.1 dB steps) */
-                EditParameter("Threshold (dB)", currentThreshold, -600, 0, 1, 1,
-                              MODULE_COMPRESSOR, PARAM_COMPRESSOR_THRESHOLD, 0,
-                              UpdateCompressorParameter);
-            }
-            break;
-            
-        case MENU_COMPRESSOR_RATIO:
-            {
-                /* Get current ratio */
-                int32_t currentRatio = Compressor_GetRatio();
-                
-                /* Edit parameter (ratio in 0.1 steps) */
-                EditParameter("Ratio (x:1)", currentRatio, 10, 100, 1, 1,
-                              MODULE_COMPRESSOR, PARAM_COMPRESSOR_RATIO, 0,
-                              UpdateCompressorParameter);
-            }
-            break;
-            
-        case MENU_COMPRESSOR_ATTACK:
-            {
-                /* Get current attack time */
-                int32_t currentAttack = Compressor_GetAttack();
-                
-                /* Edit parameter (attack in ms) */
-                EditParameter("Attack (ms)", currentAttack, 1, 200, 1, 0,
-                              MODULE_COMPRESSOR, PARAM_COMPRESSOR_ATTACK, 0,
-                              UpdateCompressorParameter);
-            }
-            break;
-            
-        case MENU_COMPRESSOR_RELEASE:
-            {
-                /* Get current release time */
-                int32_t currentRelease = Compressor_GetRelease();
-                
-                /* Edit parameter (release in ms) */
-                EditParameter("Release (ms)", currentRelease, 10, 1000, 10, 0,
-                              MODULE_COMPRESSOR, PARAM_COMPRESSOR_RELEASE, 0,
-                              UpdateCompressorParameter);
-            }
-            break;
-            
-        case MENU_COMPRESSOR_MAKEUP:
-            {
-                /* Get current makeup gain */
-                int32_t currentMakeup = Compressor_GetMakeupGain();
-                
-                /* Edit parameter (makeup gain in 0.1 dB steps) */
-                EditParameter("Makeup (dB)", currentMakeup, 0, 200, 1, 1,
-                              MODULE_COMPRESSOR, PARAM_COMPRESSOR_MAKEUP, 0,
-                              UpdateCompressorParameter);
-            }
-            break;
-            
-        default:
-            /* Unknown parameter */
-            break;
-    }
+    LCD_Clear();
+    LCD_SetCursor(0, 0);
+    LCD_Print("Audio Crossover");
+    LCD_SetCursor(0, 1);
+    LCD_Print("Ver. 1.0");
 }
 
 /**
-  * @brief  Handle limiter menu selection
-  * @param  itemId: Selected item ID
-  * @retval None
+  * @brief  Find a stored user preset by its position among the stored ones
+  * @param  position: Position (0 = first stored user preset)
+  * @retval Preset ID, or 0 if there are not that many
   */
-static void LimiterMenuCallback(uint8_t itemId)
+static uint8_t UserPresetAt(uint8_t position)
 {
-    /* Handle based on parameter selected */
-    switch (itemId) {
-        case MENU_LIMITER_THRESHOLD:
-            {
-                /* Get current threshold */
-                int32_t currentThreshold = Limiter_GetThreshold();
-                
-                /* Edit parameter (threshold in 0.1 dB steps) */
-                EditParameter("Threshold (dB)", currentThreshold, -300, 0, 1, 1,
-                              MODULE_LIMITER, PARAM_LIMITER_THRESHOLD, 0,
-                              UpdateLimiterParameter);
-            }
-            break;
-            
-        case MENU_LIMITER_RELEASE:
-            {
-                /* Get current release time */
-                int32_t currentRelease = Limiter_GetRelease();
-                
-                /* Edit parameter (release in ms) */
-                EditParameter("Release (ms)", currentRelease, 10, 1000, 10, 0,
-                              MODULE_LIMITER, PARAM_LIMITER_RELEASE, 0,
-                              UpdateLimiterParameter);
-            }
-            break;
-            
-        default:
-            /* Unknown parameter */
-            break;
+    /* The preset index is in RAM; only names are read */
+    for (uint8_t presetId = USER_PRESET_START_ID; presetId < TOTAL_PRESET_COUNT; presetId++) {
+        PresetMetadata_t info;
+        if (PresetManager_GetPresetInfo(presetId, &info) != PRESET_STATUS_OK) {
+            continue;
+        }
+        if (position == 0) {
+            return presetId;
+        }
+        position--;
     }
+    return 0;
 }
 
 /**
-  * @brief  Handle delay/phase menu selection
-  * @param  itemId: Selected item ID
-  * @retval None
+  * @brief  Number of presets in the load preset menu (factory, then stored user presets)
+  * @retval Number of items
   */
-static void DelayPhaseMenuCallback(uint8_t itemId)
+static uint8_t LoadPresetCount(void)
 {
-    /* Increment menu depth */
-    menuDepth++;
+    uint8_t count = NUM_FACTORY_PRESETS;
     
-    /* Build submenu based on selected item */
-    switch (itemId) {
-        case MENU_DELAY_PHASE_SUB_DELAY:
-            BuildDelayBandMenu(BAND_SUB);
-            break;
-            
-        case MENU_DELAY_PHASE_LOW_DELAY:
-            BuildDelayBandMenu(BAND_LOW);
-            break;
-            
-        case MENU_DELAY_PHASE_MID_DELAY:
-            BuildDelayBandMenu(BAND_MID);
-            break;
-            
-        case MENU_DELAY_PHASE_HIGH_DELAY:
-            BuildDelayBandMenu(BAND_HIGH);
-            break;
-            
-        case MENU_DELAY_PHASE_SUB_PHASE:
-            BuildPhaseBandMenu(BAND_SUB);
-            break;
-            
-        case MENU_DELAY_PHASE_LOW_PHASE:
-            BuildPhaseBandMenu(BAND_LOW);
-            break;
-            
-        case MENU_DELAY_PHASE_MID_PHASE:
-            BuildPhaseBandMenu(BAND_MID);
-            break;
-            
-        case MENU_DELAY_PHASE_HIGH_PHASE:
-            BuildPhaseBandMenu(BAND_HIGH);
-            break;
-            
-        default:
-            /* Unknown item, return to current menu */
-            menuDepth--;
-            break;
+    while (UserPresetAt(count - NUM_FACTORY_PRESETS) != 0) {
+        count++;
     }
-    
-    /* Display new menu */
-    Menu_Display();
+    return count;
 }
 
 /**
-  * @brief  Build the delay band menu
-  * @param  band: Band index (0=Sub, 1=Low, 2=Mid, 3=High)
+  * @brief  Text of a load preset menu item
+  * @param  index: Item index
+  * @param  text: Buffer to fill
+  * @param  size: Buffer size
   * @retval None
   */
-static void BuildDelayBandMenu(uint8_t band)
+static void LoadPresetText(uint8_t index, char* text, uint8_t size)
 {
-    char bandNames[MAX_BANDS][5] = {"Sub", "Low", "Mid", "High"};
-    
-    /* Get current delay */
-    int32_t currentDelay = Delay_GetTime(band);
+    PresetMetadata_t info;
     
-    /* Edit parameter directly (delay in ms) */
-    EditParameter("Delay (ms)", currentDelay, 0, 100, 1, 0,
-                  MODULE_DELAY, PARAM_DELAY_TIME, band,
-                  UpdateDelayParameter);
-    
-    /* Decrement menu depth since we're not actually building a menu */
-    menuDepth--;
+    if (index < NUM_FACTORY_PRESETS) {
+        strncpy(text, factoryPresetNames[index], size - 1);
+    } else if (PresetManager_GetPresetInfo(UserPresetAt(index - NUM_FACTORY_PRESETS), &info) == PRESET_STATUS_OK) {
+        strncpy(text, info.name, size - 1);
+    } else {
+        strncpy(text, "?", size - 1);
+    }
+    text[size - 1] = '\0';
 }
 
 /**
-  * @brief  Build the phase band menu
-  * @param  band: Band index (0=Sub, 1=Low, 2=Mid, 3=High)
+  * @brief  Handle load preset menu selection
+  * @param  index: Selected item index
   * @retval None
   */
-static void BuildPhaseBandMenu(uint8_t band)
+static void LoadPresetSelect(uint8_t index)
 {
-    char bandNames[MAX_BANDS][5] = {"Sub", "Low", "Mid", "High"};
-    
-    /* Get current phase */
-    int32_t currentPhase = Delay_GetPhaseInvert(band);
-    
-    /* Edit parameter directly (0=Normal, 1=Inverted) */
-    EditParameter("Phase Invert", currentPhase, 0, 1, 1, 0,
-                  MODULE_PHASE, PARAM_PHASE_INVERT, band,
-                  UpdatePhaseParameter);
+    /* Store selected preset */
+    selectedPreset = (index < NUM_FACTORY_PRESETS) ? index : UserPresetAt(index - NUM_FACTORY_PRESETS);
     
-    /* Decrement menu depth since we're not actually building a menu */
-    menuDepth--;
+    /* Show confirmation dialog */
+    ShowConfirmation("Load preset?", CONFIRM_ACTION_LOAD_PRESET);
 }
 
 /**
-  * @brief  Handle preset menu selection
-  * @param  itemId: Selected item ID
-  * @retval None
+  * @brief  Number of slots in the save preset menu
+  * @retval Number of items
   */
-static void PresetMenuCallback(uint8_t itemId)
+static uint8_t SavePresetCount(void)
 {
-    /* Increment menu depth */
-    menuDepth++;
-    
-    /* Build submenu based on selected item */
-    switch (itemId) {
-        case MENU_PRESET_LOAD:
-            BuildLoadPresetMenu();
-            break;
-            
-        case MENU_PRESET_SAVE:
-            BuildSavePresetMenu();
-            break;
-            
-        default:
-            /* Unknown item, return to current menu */
-            menuDepth--;
-            break;
-    }
-    
-    /* Display new menu */
-    Menu_Display();
+    return SAVE_PRESET_SLOTS;
 }
 
 /**
-  * @brief  Handle load preset menu selection
-  * @param  itemId: Selected item ID
+  * @brief  Text of a save preset menu item
+  * @param  index: Item index
+  * @param  text: Buffer to fill
+  * @param  size: Buffer size
   * @retval None
   */
-static void LoadPresetMenuCallback(uint8_t itemId)
+static void SavePresetText(uint8_t index, char* text, uint8_t size)
 {
-    /* Store selected preset */
-    selectedPreset = itemId;
-    
-    /* Show confirmation dialog */
-    ShowConfirmation("Load preset?", CONFIRM_ACTION_LOAD_PRESET);
+    if (index < PresetManager_GetNumUserPresets()) {
+        FixedFormat_Label(text, size, "Replace User ", index + 1);
+    } else {
+        FixedFormat_Label(text, size, "New User ", index + 1);
+    }
 }
 
 /**
   * @brief  Handle save preset menu selection
-  * @param  itemId: Selected item ID
+  * @param  index: Selected item index
   * @retval None
   */
-static void SavePresetMenuCallback(uint8_t itemId)
+static void SavePresetSelect(uint8_t index)
 {
     /* Store selected preset */
-    selectedPreset = itemId;
+    selectedPreset = index;
     
     /* Show confirmation dialog */
     ShowConfirmation("Save preset?", CONFIRM_ACTION_SAVE_PRESET);
@@ -1264,34 +704,17 @@ static void SavePresetMenuCallback(uint8_t itemId)
 
 /**
   * @brief  Edit a parameter
-  * @param  name: Parameter name
-  * @param  value: Current value
-  * @param  minValue: Minimum value
-  * @param  maxValue: Maximum value
-  * @param  step: Step value for adjustment
-  * @param  precision: Number of decimal places to display
-  * @param  moduleId: ID of module (crossover, compressor, etc.)
-  * @param  paramId: ID of parameter within module
-  * @param  bandId: Band ID (for band-specific parameters)
-  * @param  updateCallback: Callback to update parameter value
+  * @param  param: Parameter descriptor
+  * @param  band: Band ID (for band-specific parameters)
   * @retval None
   */
-static void EditParameter(const char* name, int32_t value, int32_t minValue, int32_t maxValue, 
-                          int32_t step, uint8_t precision, uint8_t moduleId, uint8_t paramId, uint8_t bandId,
-                          void (*updateCallback)(uint8_t, uint8_t, int32_t))
+static void EditParameter(const MenuParam_t* param, uint8_t band)
 {
     /* Save parameter information */
-    strncpy(currentParameter.name, name, MENU_ITEM_MAX_LENGTH);
-    currentParameter.value = value;
-    currentParameter.minValue = minValue;
-    currentParameter.maxValue = maxValue;
-    currentParameter.step = step;
-    currentParameter.originalValue = value;
-    currentParameter.precision = precision;
-    currentParameter.moduleId = moduleId;
-    currentParameter.paramId = paramId;
-    currentParameter.bandId = bandId;
-    currentParameter.updateCallback = updateCallback;
+    currentParameter.param = param;
+    currentParameter.band = band;
+    currentParameter.value = param->read(band, param->paramId);
+    currentParameter.originalValue = currentParameter.value;
     
     /* Switch to editing state */
     menuState = MENU_STATE_EDITING;
@@ -1307,29 +730,17 @@ static void EditParameter(const char* name, int32_t value, int32_t minValue, int
 static void DisplayParameterEdit(void)
 {
     char valueStr[16];
+    FixedFormat_t format = {NULL, NULL, currentParameter.param->precision, 0};
     
     /* Clear display */
     LCD_Clear();
     
     /* Display parameter name */
     LCD_SetCursor(0, 0);
-    LCD_Print(currentParameter.name);
+    LCD_Print(currentParameter.param->name);
     
-    /* Format value string based on precision */
-    if (currentParameter.precision == 0) {
-        /* Integer value */
-        snprintf(valueStr, sizeof(valueStr), "%ld", currentParameter.value);
-    } else if (currentParameter.precision == 1) {
-        /* One decimal place */
-        snprintf(valueStr, sizeof(valueStr), "%ld.%01ld", 
-                 currentParameter.value / 10,
-                 abs(currentParameter.value) % 10);
-    } else {
-        /* Two decimal places */
-        snprintf(valueStr, sizeof(valueStr), "%ld.%02ld", 
-                 currentParameter.value / 100,
-                 abs(currentParameter.value) % 100);
-    }
+    /* Format value string based on precision (value is scaled by 10^precision) */
+    FixedFormat_Print(valueStr, sizeof(valueStr), currentParameter.value, &format);
     
     /* Display value */
     LCD_SetCursor(0, 1);
@@ -1343,11 +754,9 @@ static void DisplayParameterEdit(void)
 static void ApplyParameterEdit(void)
 {
     /* Call update callback with final value */
-    if (currentParameter.updateCallback) {
-        currentParameter.updateCallback(currentParameter.bandId, 
-                                        currentParameter.paramId,
-                                        currentParameter.value);
-    }
+    currentParameter.param->update(currentParameter.band,
+                                   currentParameter.param->paramId,
+                                   currentParameter.value);
 }
 
 /**
@@ -1357,11 +766,9 @@ static void ApplyParameterEdit(void)
 static void CancelParameterEdit(void)
 {
     /* Call update callback with original value to revert */
-    if (currentParameter.updateCallback) {
-        currentParameter.updateCallback(currentParameter.bandId, 
-                                        currentParameter.paramId,
-                                        currentParameter.originalValue);
-    }
+    currentParameter.param->update(currentParameter.band,
+                                   currentParameter.param->paramId,
+                                   currentParameter.originalValue);
 }
 
 /**
@@ -1420,6 +827,147 @@ static void HandleConfirmation(void)
     }
 }
 
+/**
+  * @brief  Read crossover parameter
+  * @param  band: Band index
+  * @param  paramId: Parameter ID
+  * @retval Current parameter value
+  */
+static int32_t ReadCrossoverParameter(uint8_t band, uint8_t paramId)
+{
+    const struct CrossoverSettings_t* xo = &ParamUpdate_GetSettings()->crossover;
+    float value;
+    
+    /* Read parameter based on ID */
+    switch (paramId) {
+        case PARAM_CROSSOVER_FREQUENCY:
+            /* Each band edits the crossover point at its upper edge (high band: lower edge) */
+            value = (band == BAND_SUB) ? xo->lowCutoff :
+                    (band == BAND_LOW) ? xo->midCutoff : xo->highCutoff;
+            return (int32_t)lroundf(value);
+            
+        case PARAM_CROSSOVER_TYPE:
+            return xo->filterType;
+            
+        case PARAM_CROSSOVER_GAIN:
+            value = (band == BAND_SUB) ? xo->subGain :
+                    (band == BAND_LOW) ? xo->lowGain :
+                    (band == BAND_MID) ? xo->midGain : xo->highGain;
+            return (int32_t)lroundf(value * 10.0f);
+            
+        case PARAM_CROSSOVER_MUTE:
+            return (band == BAND_SUB) ? xo->subMute :
+                   (band == BAND_LOW) ? xo->lowMute :
+                   (band == BAND_MID) ? xo->midMute : xo->highMute;
+            
+        default:
+            /* Unknown parameter */
+            return 0;
+    }
+}
+
+/**
+  * @brief  Read compressor parameter
+  * @param  band: Not used for compressor (global, read from the sub band)
+  * @param  paramId: Parameter ID
+  * @retval Current parameter value
+  */
+static int32_t ReadCompressorParameter(uint8_t band, uint8_t paramId)
+{
+    const struct CompressorSettings_t* comp = &ParamUpdate_GetSettings()->compressor;
+    
+    /* Read parameter based on ID */
+    switch (paramId) {
+        case PARAM_COMPRESSOR_THRESHOLD:
+            return (int32_t)lroundf(comp->sub.threshold * 10.0f);
+            
+        case PARAM_COMPRESSOR_RATIO:
+            return (int32_t)lroundf(comp->sub.ratio * 10.0f);
+            
+        case PARAM_COMPRESSOR_ATTACK:
+            return (int32_t)lroundf(comp->sub.attack);
+            
+        case PARAM_COMPRESSOR_RELEASE:
+            return (int32_t)lroundf(comp->sub.release);
+            
+        case PARAM_COMPRESSOR_MAKEUP:
+            return (int32_t)lroundf(comp->sub.makeupGain * 10.0f);
+            
+        default:
+            /* Unknown parameter */
+            return 0;
+    }
+}
+
+/**
+  * @brief  Read limiter parameter
+  * @param  band: Not used for limiter (global, read from the sub band)
+  * @param  paramId: Parameter ID
+  * @retval Current parameter value
+  */
+static int32_t ReadLimiterParameter(uint8_t band, uint8_t paramId)
+{
+    const struct LimiterSettings_t* lim = &ParamUpdate_GetSettings()->limiter;
+    
+    /* Read parameter based on ID */
+    switch (paramId) {
+        case PARAM_LIMITER_THRESHOLD:
+            return (int32_t)lroundf(lim->sub.threshold * 10.0f);
+            
+        case PARAM_LIMITER_RELEASE:
+            return (int32_t)lroundf(lim->sub.release);
+            
+        default:
+            /* Unknown parameter */
+            return 0;
+    }
+}
+
+/**
+  * @brief  Read delay parameter
+  * @param  band: Band index
+  * @param  paramId: Parameter ID
+  * @retval Current parameter value
+  */
+static int32_t ReadDelayParameter(uint8_t band, uint8_t paramId)
+{
+    const struct DelaySettings_t* dly = &ParamUpdate_GetSettings()->delay;
+    float value;
+    
+    if (paramId != PARAM_DELAY_TIME) {
+        return 0;
+    }
+    value = (band == BAND_SUB) ? dly->subDelay :
+            (band == BAND_LOW) ? dly->lowDelay :
+            (band == BAND_MID) ? dly->midDelay : dly->highDelay;
+    return (int32_t)lroundf(value);
+}
+
+/**
+  * @brief  Read phase parameter
+  * @param  band: Band index
+  * @param  paramId: Parameter ID
+  * @retval Current parameter value
+  */
+static int32_t ReadPhaseParameter(uint8_t band, uint8_t paramId)
+{
+    const struct DelaySettings_t* dly = &ParamUpdate_GetSettings()->delay;
+    
+    if (paramId != PARAM_PHASE_INVERT) {
+        return 0;
+    }
+    return (band == BAND_SUB) ? dly->subPhaseInvert :
+           (band == BAND_LOW) ? dly->lowPhaseInvert :
+           (band == BAND_MID) ? dly->midPhaseInvert : dly->highPhaseInvert;
+}
+
+/*
+ * The update accessors run on every encoder step while a value is edited.
+ * They only write the live settings and mark what changed; the DSP modules
+ * are recomputed by the next control update (see param_update.h), once for
+ * any number of steps.
+ */
+
 /**
   * @brief  Update crossover parameter
   * @param  band: Band index
@@ -1429,22 +977,46 @@ static void HandleConfirmation(void)
   */
 static void UpdateCrossoverParameter(uint8_t band, uint8_t paramId, int32_t value)
 {
+    struct CrossoverSettings_t* xo = &ParamUpdate_GetSettings()->crossover;
+    
     /* Update parameter based on ID */
     switch (paramId) {
         case PARAM_CROSSOVER_FREQUENCY:
-            Crossover_SetFrequency(band, value);
+            if (band == BAND_SUB) {
+                xo->lowCutoff = (float)value;
+                ParamUpdate_Mark(PARAM_DIRTY_CUTOFF_LOW);
+            } else if (band == BAND_LOW) {
+                xo->midCutoff = (float)value;
+                ParamUpdate_Mark(PARAM_DIRTY_CUTOFF_MID);
+            } else {
+                xo->highCutoff = (float)value;
+                ParamUpdate_Mark(PARAM_DIRTY_CUTOFF_HIGH);
+            }
             break;
             
         case PARAM_CROSSOVER_TYPE:
-            Crossover_SetFilterType(band, value);
+            xo->filterType = (uint8_t)value;
+            ParamUpdate_Mark(PARAM_DIRTY_FILTER);
             break;
             
         case PARAM_CROSSOVER_GAIN:
-            Crossover_SetGain(band, value);
+            switch (band) {
+                case BAND_SUB: xo->subGain = value / 10.0f;  break;
+                case BAND_LOW: xo->lowGain = value / 10.0f;  break;
+                case BAND_MID: xo->midGain = value / 10.0f;  break;
+                default:       xo->highGain = value / 10.0f; break;
+            }
+            ParamUpdate_Mark(PARAM_DIRTY_BAND_LEVELS);
             break;
             
         case PARAM_CROSSOVER_MUTE:
-            Crossover_SetMute(band, value);
+            switch (band) {
+                case BAND_SUB: xo->subMute = (uint8_t)value;  break;
+                case BAND_LOW: xo->lowMute = (uint8_t)value;  break;
+                case BAND_MID: xo->midMute = (uint8_t)value;  break;
+                default:       xo->highMute = (uint8_t)value; break;
+            }
+            ParamUpdate_Mark(PARAM_DIRTY_BAND_LEVELS);
             break;
             
         default:
@@ -1455,64 +1027,70 @@ static void UpdateCrossoverParameter(uint8_t band, uint8_t paramId, int32_t valu
 
 /**
   * @brief  Update compressor parameter
-  * @param  band: Not used for compressor (global)
+  * @param  band: Not used for compressor (global, written to all bands)
   * @param  paramId: Parameter ID
   * @param  value: New parameter value
   * @retval None
   */
 static void UpdateCompressorParameter(uint8_t band, uint8_t paramId, int32_t value)
 {
+    struct CompressorSettings_t* comp = &ParamUpdate_GetSettings()->compressor;
+    
     /* Update parameter based on ID */
     switch (paramId) {
         case PARAM_COMPRESSOR_THRESHOLD:
-            Compressor_SetThreshold(value);
+            SET_ALL_BANDS(comp, threshold, value / 10.0f);
             break;
             
         case PARAM_COMPRESSOR_RATIO:
-            Compressor_SetRatio(value);
+            SET_ALL_BANDS(comp, ratio, value / 10.0f);
             break;
             
         case PARAM_COMPRESSOR_ATTACK:
-            Compressor_SetAttack(value);
+            SET_ALL_BANDS(comp, attack, (float)value);
             break;
             
         case PARAM_COMPRESSOR_RELEASE:
-            Compressor_SetRelease(value);
+            SET_ALL_BANDS(comp, release, (float)value);
             break;
             
         case PARAM_COMPRESSOR_MAKEUP:
-            Compressor_SetMakeupGain(value);
+            SET_ALL_BANDS(comp, makeupGain, value / 10.0f);
             break;
             
         default:
             /* Unknown parameter */
-            break;
+            return;
     }
+    ParamUpdate_Mark(PARAM_DIRTY_COMPRESSOR);
 }
 
 /**
   * @brief  Update limiter parameter
-  * @param  band: Not used for limiter (global)
+  * @param  band: Not used for limiter (global, written to all bands)
   * @param  paramId: Parameter ID
   * @param  value: New parameter value
   * @retval None
   */
 static void UpdateLimiterParameter(uint8_t band, uint8_t paramId, int32_t value)
 {
+    struct LimiterSettings_t* lim = &ParamUpdate_GetSettings()->limiter;
+    
     /* Update parameter based on ID */
     switch (paramId) {
         case PARAM_LIMITER_THRESHOLD:
-            Limiter_SetThreshold(value);
+            SET_ALL_BANDS(lim, threshold, value / 10.0f);
             break;
             
         case PARAM_LIMITER_RELEASE:
-            Limiter_SetRelease(value);
+            SET_ALL_BANDS(lim, release, (float)value);
             break;
             
         default:
             /* Unknown parameter */
-            break;
+            return;
     }
+    ParamUpdate_Mark(PARAM_DIRTY_LIMITER);
 }
 
 /**
@@ -1524,16 +1102,18 @@ static void UpdateLimiterParameter(uint8_t band, uint8_t paramId, int32_t value)
   */
 static void UpdateDelayParameter(uint8_t band, uint8_t paramId, int32_t value)
 {
-    /* Update parameter based on ID */
-    switch (paramId) {
-        case PARAM_DELAY_TIME:
-            Delay_SetTime(band, value);
-            break;
-            
-        default:
-            /* Unknown parameter */
-            break;
+    struct DelaySettings_t* dly = &ParamUpdate_GetSettings()->delay;
+    
+    if (paramId != PARAM_DELAY_TIME) {
+        return;
     }
+    switch (band) {
+        case BAND_SUB: dly->subDelay = (float)value;  break;
+        case BAND_LOW: dly->lowDelay = (float)value;  break;
+        case BAND_MID: dly->midDelay = (float)value;  break;
+        default:       dly->highDelay = (float)value; break;
+    }
+    ParamUpdate_Mark(PARAM_DIRTY_DELAY);
 }
 
 /**
@@ -1545,16 +1125,18 @@ static void UpdateDelayParameter(uint8_t band, uint8_t paramId, int32_t value)
   */
 static void UpdatePhaseParameter(uint8_t band, uint8_t paramId, int32_t value)
 {
-    /* Update parameter based on ID */
-    switch (paramId) {
-        case PARAM_PHASE_INVERT:
-            Delay_SetPhaseInvert(band, value);
-            break;
-            
-        default:
-            /* Unknown parameter */
-            break;
+    struct DelaySettings_t* dly = &ParamUpdate_GetSettings()->delay;
+    
+    if (paramId != PARAM_PHASE_INVERT) {
+        return;
+    }
+    switch (band) {
+        case BAND_SUB: dly->subPhaseInvert = (uint8_t)value;  break;
+        case BAND_LOW: dly->lowPhaseInvert = (uint8_t)value;  break;
+        case BAND_MID: dly->midPhaseInvert = (uint8_t)value;  break;
+        default:       dly->highPhaseInvert = (uint8_t)value; break;
     }
+    ParamUpdate_Mark(PARAM_DIRTY_DELAY);
 }
 
 /* End of file */
\ No newline at end of file
@@ -0,0 +1,202 @@
+ /**
+  ******************************************************************************
+  * @file           : param_update.c
+  * @brief          : Coalesced live parameter updates
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Editors (menu, front panel, serial protocol) write new values straight into
+  * the live settings and only mark what changed. After an audio block, if the
+  * control period has passed, each marked piece of work runs once with the
+  * latest values:
+  *
+  *   one cutoff      the two filter chains at that crossover point
+  *   gains, mutes    no coefficients at all
+  *   filter type     all chains (Crossover_UpdateCoefficients)
+  *   dynamics/delay  the module's own settings call
+  *
+  * A fast knob spin therefore costs one recomputation per control period
+  * instead of one per detent. The first edit after a quiet period is applied
+  * after the next block, so single steps still respond at once.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "param_update.h"
+#include "preset_morph.h"
+#include "audio_processing.h"
+#include "crossover.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "delay.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define PARAM_UPDATE_FRAMES          ((PARAM_UPDATE_PERIOD_MS * AUDIO_SAMPLE_RATE_HZ) / 1000)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static SystemSettings_t *settings = NULL;
+static uint16_t dirtyFlags = 0;
+static uint32_t framesSinceUpdate = PARAM_UPDATE_FRAMES;
+
+static ParamUpdateStats_t updateStats;
+
+/* Private function prototypes -----------------------------------------------*/
+static void ApplyChanges(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize the update pipeline
+  * @param  pSettings Settings used by the processing chain
+  * @retval None
+  */
+void ParamUpdate_Init(SystemSettings_t *pSettings)
+{
+  settings = pSettings;
+  dirtyFlags = 0;
+  framesSinceUpdate = PARAM_UPDATE_FRAMES;
+
+  memset(&updateStats, 0, sizeof(ParamUpdateStats_t));
+}
+
+/**
+  * @brief  Get the settings that edits are written to
+  * @retval Pointer to the live settings
+  */
+SystemSettings_t *ParamUpdate_GetSettings(void)
+{
+  return settings;
+}
+
+/**
+  * @brief  Mark settings as changed
+  * @param  dirty PARAM_DIRTY_* flags
+  * @retval None
+  */
+void ParamUpdate_Mark(uint16_t dirty)
+{
+  dirtyFlags |= dirty;
+  updateStats.changes++;
+}
+
+/**
+  * @brief  Apply marked changes (call once per processed audio block)
+  * @param  frames Number of frames in the block just processed
+  * @retval None
+  */
+void ParamUpdate_Tick(uint16_t frames)
+{
+  if (framesSinceUpdate < PARAM_UPDATE_FRAMES) {
+    framesSinceUpdate += frames;
+  }
+
+  if (dirtyFlags == 0 || framesSinceUpdate < PARAM_UPDATE_FRAMES) {
+    return;
+  }
+
+  /* A morph or crossfade applies the settings itself; keep the marks */
+  if (PresetMorph_IsActive() || AudioProcessing_IsCrossfading()) {
+    return;
+  }
+
+  ApplyChanges();
+}
+
+/**
+  * @brief  Apply marked changes now, regardless of the control period
+  * @retval None
+  */
+void ParamUpdate_Flush(void)
+{
+  if (dirtyFlags != 0) {
+    ApplyChanges();
+  }
+}
+
+/**
+  * @brief  Get the update statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void ParamUpdate_GetStats(ParamUpdateStats_t *stats)
+{
+  memcpy(stats, &updateStats, sizeof(ParamUpdateStats_t));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Run each marked piece of work once with the current settings
+  * @retval None
+  */
+static void ApplyChanges(void)
+{
+  uint16_t dirty = dirtyFlags;
+  uint32_t start = DWT->CYCCNT;
+
+  dirtyFlags = 0;
+  framesSinceUpdate = 0;
+
+  if (settings == NULL) {
+    return;
+  }
+
+  /* A new filter structure recomputes every chain, cutoffs included */
+  if (dirty & PARAM_DIRTY_FILTER) {
+    Crossover_UpdateCoefficients(&settings->crossover);
+    dirty &= ~(PARAM_DIRTY_CUTOFFS | PARAM_DIRTY_BAND_LEVELS);
+  }
+
+  if (dirty & PARAM_DIRTY_CUTOFF_LOW) {
+    Crossover_SetCutoff(CROSSOVER_POINT_LOW, settings->crossover.lowCutoff);
+  }
+  if (dirty & PARAM_DIRTY_CUTOFF_MID) {
+    Crossover_SetCutoff(CROSSOVER_POINT_MID, settings->crossover.midCutoff);
+  }
+  if (dirty & PARAM_DIRTY_CUTOFF_HIGH) {
+    Crossover_SetCutoff(CROSSOVER_POINT_HIGH, settings->crossover.highCutoff);
+  }
+
+  if (dirty & PARAM_DIRTY_BAND_LEVELS) {
+    Crossover_SetGain(0, settings->crossover.subGain);
+    Crossover_SetGain(1, settings->crossover.lowGain);
+    Crossover_SetGain(2, settings->crossover.midGain);
+    Crossover_SetGain(3, settings->crossover.highGain);
+    Crossover_SetMute(0, settings->crossover.subMute);
+    Crossover_SetMute(1, settings->crossover.lowMute);
+    Crossover_SetMute(2, settings->crossover.midMute);
+    Crossover_SetMute(3, settings->crossover.highMute);
+  }
+
+  if (dirty & PARAM_DIRTY_COMPRESSOR) {
+    Compressor_SetSettings(&settings->compressor);
+  }
+  if (dirty & PARAM_DIRTY_LIMITER) {
+    Limiter_SetSettings(&settings->limiter);
+  }
+  if (dirty & PARAM_DIRTY_DELAY) {
+    Delay_SetSettings(&settings->delay);
+  }
+
+  uint32_t cycles = DWT->CYCCNT - start;
+  updateStats.updates++;
+  updateStats.totalCycles += cycles;
+  if (cycles > updateStats.worstCycles) {
+    updateStats.worstCycles = cycles;
+  }
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,659 @@
+ /**
+  ******************************************************************************
+  * @file           : preset_codec.c
+  * @brief          : Compact, versioned binary encoding of presets
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Record layout (all fields little-endian):
+  *
+  *   header   magic u16, version u8, flags u8, payload length u16
+  *   payload  groups of: tag u8, length u8, fields
+  *   trailer  CRC32 (IEEE 802.3) over header and payload
+  *
+  * Fields are quantized: gains and thresholds in 0.1 dB (int16), cutoffs in
+  * Hz (uint16), time constants and delays in 0.01 ms or 0.1 ms (uint16),
+  * switches packed into per-band bit masks (bit 0 sub ... bit 3 high).
+  *
+  * Groups only ever grow by appending fields. The decoder reads the fields a
+  * group actually contains and leaves the rest of the caller's settings
+  * untouched, and it skips groups it does not know, so records written by an
+  * older layout load with defaults for whatever they lack.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "preset_codec.h"
+#include "crc32.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Output cursor (writes past the end are counted but not stored)
+  */
+typedef struct {
+    uint8_t* buffer;
+    uint16_t size;
+    uint16_t position;
+} CodecWriter_t;
+
+/**
+  * @brief  Input cursor over one group or the whole payload
+  */
+typedef struct {
+    const uint8_t* data;
+    uint16_t remaining;
+} CodecReader_t;
+
+/* Private define ------------------------------------------------------------*/
+#define CODEC_HEADER_SIZE          6
+#define CODEC_CRC_SIZE             4
+
+/* Group tags */
+#define CODEC_TAG_NAME             0x01
+#define CODEC_TAG_TIMESTAMP        0x02
+#define CODEC_TAG_CROSSOVER        0x10
+#define CODEC_TAG_COMPRESSOR       0x20
+#define CODEC_TAG_LIMITER          0x30
+#define CODEC_TAG_DELAY            0x40
+
+/* Quantization steps (units per stored count) */
+#define CODEC_SCALE_DB             10.0f    /* 0.1 dB */
+#define CODEC_SCALE_RATIO          10.0f    /* 0.1 */
+#define CODEC_SCALE_ATTACK_MS      100.0f   /* 0.01 ms */
+#define CODEC_SCALE_RELEASE_MS     10.0f    /* 0.1 ms */
+#define CODEC_SCALE_DELAY_MS       100.0f   /* 0.01 ms */
+
+/* Longest name stored (without terminator) */
+#define CODEC_NAME_MAX             15
+
+/* Private macro -------------------------------------------------------------*/
+#define DEQUANTIZE(value, scale)   ((float)(value) / (scale))
+
+/* Pack four per-band switches into a bit mask */
+#define BAND_MASK(sub, low, mid, high) \
+  (uint8_t)(((sub) ? 0x01 : 0) | ((low) ? 0x02 : 0) | ((mid) ? 0x04 : 0) | ((high) ? 0x08 : 0))
+
+/* Encode and decode one band of the compressor and limiter settings */
+#define ENCODE_COMPRESSOR_BAND(w, c, band)                                                \
+  do {                                                                                    \
+    PutU16((w), (uint16_t)QuantizeSigned((c)->band.threshold, CODEC_SCALE_DB));           \
+    PutU8((w), (uint8_t)QuantizeUnsigned((c)->band.ratio, CODEC_SCALE_RATIO, 0xFF));      \
+    PutU16((w), QuantizeUnsigned((c)->band.attack, CODEC_SCALE_ATTACK_MS, 0xFFFF));       \
+    PutU16((w), QuantizeUnsigned((c)->band.release, CODEC_SCALE_RELEASE_MS, 0xFFFF));     \
+    PutU16((w), (uint16_t)QuantizeSigned((c)->band.makeupGain, CODEC_SCALE_DB));          \
+  } while (0)
+
+#define DECODE_COMPRESSOR_BAND(r, c, band)                                                \
+  do {                                                                                    \
+    uint16_t u16;                                                                         \
+    uint8_t u8;                                                                           \
+    if (GetU16((r), &u16)) (c)->band.threshold = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);\
+    if (GetU8((r), &u8)) (c)->band.ratio = DEQUANTIZE(u8, CODEC_SCALE_RATIO);             \
+    if (GetU16((r), &u16)) (c)->band.attack = DEQUANTIZE(u16, CODEC_SCALE_ATTACK_MS);     \
+    if (GetU16((r), &u16)) (c)->band.release = DEQUANTIZE(u16, CODEC_SCALE_RELEASE_MS);   \
+    if (GetU16((r), &u16)) (c)->band.makeupGain = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);\
+  } while (0)
+
+#define ENCODE_LIMITER_BAND(w, l, band)                                                   \
+  do {                                                                                    \
+    PutU16((w), (uint16_t)QuantizeSigned((l)->band.threshold, CODEC_SCALE_DB));           \
+    PutU16((w), QuantizeUnsigned((l)->band.release, CODEC_SCALE_RELEASE_MS, 0xFFFF));     \
+  } while (0)
+
+#define DECODE_LIMITER_BAND(r, l, band)                                                   \
+  do {                                                                                    \
+    uint16_t u16;                                                                         \
+    if (GetU16((r), &u16)) (l)->band.threshold = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);\
+    if (GetU16((r), &u16)) (l)->band.release = DEQUANTIZE(u16, CODEC_SCALE_RELEASE_MS);   \
+  } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void EncodeCrossover(CodecWriter_t* w, const PresetSettings_t* settings);
+static void EncodeCompressor(CodecWriter_t* w, const PresetSettings_t* settings);
+static void EncodeLimiter(CodecWriter_t* w, const PresetSettings_t* settings);
+static void EncodeDelay(CodecWriter_t* w, const PresetSettings_t* settings);
+static void DecodeGroup(uint8_t tag, CodecReader_t* r, PresetSettings_t* settings,
+                        PresetMetadata_t* metadata);
+static uint16_t BeginGroup(CodecWriter_t* w, uint8_t tag);
+static void EndGroup(CodecWriter_t* w, uint16_t lengthPosition);
+static void PutU8(CodecWriter_t* w, uint8_t value);
+static void PutU16(CodecWriter_t* w, uint16_t value);
+static void PutU32(CodecWriter_t* w, uint32_t value);
+static uint8_t GetU8(CodecReader_t* r, uint8_t* value);
+static uint8_t GetU16(CodecReader_t* r, uint16_t* value);
+static uint8_t GetU32(CodecReader_t* r, uint32_t* value);
+static int16_t QuantizeSigned(float value, float scale);
+static uint16_t QuantizeUnsigned(float value, float scale, uint16_t max);
+static uint32_t ReadU32(const uint8_t* data);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Encode a preset
+  * @param  settings  Settings to encode
+  * @param  metadata  Name and timestamp to store; checksum receives the record CRC
+  * @param  buffer    Output buffer
+  * @param  size      Output buffer size
+  * @param  length    Receives the encoded length
+  * @retval PRESET_CODEC_OK or error code
+  */
+uint8_t PresetCodec_Encode(const PresetSettings_t* settings, PresetMetadata_t* metadata,
+                           uint8_t* buffer, uint16_t size, uint16_t* length)
+{
+  CodecWriter_t w;
+  uint16_t group;
+
+  if (settings == NULL || metadata == NULL || buffer == NULL || length == NULL) {
+    return PRESET_CODEC_INVALID;
+  }
+
+  w.buffer = buffer;
+  w.size = size;
+  w.position = 0;
+
+  /* Header; the payload length is filled in at the end */
+  PutU16(&w, PRESET_CODEC_MAGIC);
+  PutU8(&w, PRESET_FORMAT_VERSION);
+  PutU8(&w, 0);
+  PutU16(&w, 0);
+
+  group = BeginGroup(&w, CODEC_TAG_NAME);
+  for (uint8_t i = 0; i < CODEC_NAME_MAX && metadata->name[i] != '\0'; i++) {
+    PutU8(&w, (uint8_t)metadata->name[i]);
+  }
+  EndGroup(&w, group);
+
+  group = BeginGroup(&w, CODEC_TAG_TIMESTAMP);
+  PutU32(&w, metadata->timestamp);
+  EndGroup(&w, group);
+
+  EncodeCrossover(&w, settings);
+  EncodeCompressor(&w, settings);
+  EncodeLimiter(&w, settings);
+  EncodeDelay(&w, settings);
+
+  if ((uint32_t)w.position + CODEC_CRC_SIZE > size) {
+    return PRESET_CODEC_NO_SPACE;
+  }
+
+  uint16_t payloadLength = w.position - CODEC_HEADER_SIZE;
+  buffer[4] = (uint8_t)payloadLength;
+  buffer[5] = (uint8_t)(payloadLength >> 8);
+
+  uint32_t crc = Crc32_Compute(buffer, w.position);
+  PutU32(&w, crc);
+
+  metadata->checksum = crc;
+  *length = w.position;
+
+  return PRESET_CODEC_OK;
+}
+
+/**
+  * @brief  Decode a preset
+  * @param  buffer    Encoded preset
+  * @param  length    Encoded length
+  * @param  settings  Settings to update (may be NULL)
+  * @param  metadata  Receives name, timestamp and CRC as checksum (may be NULL)
+  * @retval PRESET_CODEC_OK or error code
+  */
+uint8_t PresetCodec_Decode(const uint8_t* buffer, uint16_t length,
+                           PresetSettings_t* settings, PresetMetadata_t* metadata)
+{
+  if (!PresetCodec_IsEncoded(buffer, length)) {
+    return PRESET_CODEC_INVALID;
+  }
+
+  uint8_t version = buffer[2];
+  if (version == 0) {
+    return PRESET_CODEC_INVALID;
+  }
+  if (version > PRESET_FORMAT_VERSION) {
+    return PRESET_CODEC_VERSION;
+  }
+
+  uint16_t payloadLength = (uint16_t)(buffer[4] | (buffer[5] << 8));
+  uint32_t crcOffset = (uint32_t)CODEC_HEADER_SIZE + payloadLength;
+  if (crcOffset + CODEC_CRC_SIZE > length) {
+    return PRESET_CODEC_INVALID;
+  }
+
+  uint32_t crc = Crc32_Compute(buffer, crcOffset);
+  if (crc != ReadU32(&buffer[crcOffset])) {
+    return PRESET_CODEC_CRC;
+  }
+
+  if (metadata != NULL) {
+    memset(metadata->name, 0, sizeof(metadata->name));
+    metadata->timestamp = 0;
+    metadata->checksum = crc;
+  }
+
+  /* Walk the groups */
+  CodecReader_t payload;
+  payload.data = &buffer[CODEC_HEADER_SIZE];
+  payload.remaining = payloadLength;
+
+  while (payload.remaining > 0) {
+    uint8_t tag;
+    uint8_t groupLength;
+
+    if (!GetU8(&payload, &tag) || !GetU8(&payload, &groupLength) ||
+        groupLength > payload.remaining) {
+      return PRESET_CODEC_INVALID;
+    }
+
+    CodecReader_t group;
+    group.data = payload.data;
+    group.remaining = groupLength;
+    DecodeGroup(tag, &group, settings, metadata);
+
+    payload.data += groupLength;
+    payload.remaining -= groupLength;
+  }
+
+  return PRESET_CODEC_OK;
+}
+
+/**
+  * @brief  Decode the name and timestamp from the start of a record
+  * @param  buffer   First bytes of the record
+  * @param  length   Number of bytes in buffer
+  * @param  metadata Receives name and timestamp
+  * @param  version  Receives the record format version (may be NULL)
+  * @retval PRESET_CODEC_OK or error code
+  */
+uint8_t PresetCodec_DecodePrefix(const uint8_t* buffer, uint16_t length,
+                                 PresetMetadata_t* metadata, uint8_t* version)
+{
+  if (metadata == NULL || !PresetCodec_IsEncoded(buffer, length)) {
+    return PRESET_CODEC_INVALID;
+  }
+
+  if (buffer[2] == 0) {
+    return PRESET_CODEC_INVALID;
+  }
+  if (buffer[2] > PRESET_FORMAT_VERSION) {
+    return PRESET_CODEC_VERSION;
+  }
+  if (version != NULL) {
+    *version = buffer[2];
+  }
+
+  memset(metadata->name, 0, sizeof(metadata->name));
+  metadata->timestamp = 0;
+
+  /* Walk the groups that are complete within the buffer */
+  uint16_t payloadLength = (uint16_t)(buffer[4] | (buffer[5] << 8));
+  CodecReader_t payload;
+  payload.data = &buffer[CODEC_HEADER_SIZE];
+  payload.remaining = MIN(payloadLength, (uint16_t)(length - CODEC_HEADER_SIZE));
+
+  while (payload.remaining >= 2) {
+    uint8_t tag = payload.data[0];
+    uint8_t groupLength = payload.data[1];
+    if (groupLength > payload.remaining - 2) {
+      break;
+    }
+
+    CodecReader_t group;
+    group.data = &payload.data[2];
+    group.remaining = groupLength;
+    DecodeGroup(tag, &group, NULL, metadata);
+
+    payload.data += 2 + groupLength;
+    payload.remaining -= 2 + groupLength;
+  }
+
+  return PRESET_CODEC_OK;
+}
+
+/**
+  * @brief  Check whether a buffer starts with an encoded preset header
+  * @param  buffer Data to check
+  * @param  length Data length
+  * @retval 1 if the header is present, 0 otherwise
+  */
+uint8_t PresetCodec_IsEncoded(const uint8_t* buffer, uint16_t length)
+{
+  if (buffer == NULL || length < CODEC_HEADER_SIZE + CODEC_CRC_SIZE) {
+    return 0;
+  }
+
+  return ((buffer[0] | (buffer[1] << 8)) == PRESET_CODEC_MAGIC) ? 1 : 0;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Encode the crossover group
+  * @param  w        Output cursor
+  * @param  settings Settings to encode
+  * @retval None
+  */
+static void EncodeCrossover(CodecWriter_t* w, const PresetSettings_t* settings)
+{
+  const CrossoverSettings_t* x = &settings->crossover;
+  uint16_t group = BeginGroup(w, CODEC_TAG_CROSSOVER);
+
+  PutU16(w, QuantizeUnsigned(x->lowCutoff, 1.0f, 0xFFFF));
+  PutU16(w, QuantizeUnsigned(x->midCutoff, 1.0f, 0xFFFF));
+  PutU16(w, QuantizeUnsigned(x->highCutoff, 1.0f, 0xFFFF));
+  PutU16(w, (uint16_t)QuantizeSigned(x->subGain, CODEC_SCALE_DB));
+  PutU16(w, (uint16_t)QuantizeSigned(x->lowGain, CODEC_SCALE_DB));
+  PutU16(w, (uint16_t)QuantizeSigned(x->midGain, CODEC_SCALE_DB));
+  PutU16(w, (uint16_t)QuantizeSigned(x->highGain, CODEC_SCALE_DB));
+  PutU8(w, (uint8_t)((x->filterType << 4) | (x->filterOrder & 0x0F)));
+  PutU8(w, BAND_MASK(x->subMute, x->lowMute, x->midMute, x->highMute));
+
+  EndGroup(w, group);
+}
+
+/**
+  * @brief  Encode the compressor group
+  * @param  w        Output cursor
+  * @param  settings Settings to encode
+  * @retval None
+  */
+static void EncodeCompressor(CodecWriter_t* w, const PresetSettings_t* settings)
+{
+  const CompressorSettings_t* c = &settings->compressor;
+  uint16_t group = BeginGroup(w, CODEC_TAG_COMPRESSOR);
+
+  ENCODE_COMPRESSOR_BAND(w, c, sub);
+  ENCODE_COMPRESSOR_BAND(w, c, low);
+  ENCODE_COMPRESSOR_BAND(w, c, mid);
+  ENCODE_COMPRESSOR_BAND(w, c, high);
+  PutU8(w, BAND_MASK(c->sub.enabled, c->low.enabled, c->mid.enabled, c->high.enabled));
+
+  EndGroup(w, group);
+}
+
+/**
+  * @brief  Encode the limiter group
+  * @param  w        Output cursor
+  * @param  settings Settings to encode
+  * @retval None
+  */
+static void EncodeLimiter(CodecWriter_t* w, const PresetSettings_t* settings)
+{
+  const LimiterSettings_t* l = &settings->limiter;
+  uint16_t group = BeginGroup(w, CODEC_TAG_LIMITER);
+
+  ENCODE_LIMITER_BAND(w, l, sub);
+  ENCODE_LIMITER_BAND(w, l, low);
+  ENCODE_LIMITER_BAND(w, l, mid);
+  ENCODE_LIMITER_BAND(w, l, high);
+  PutU8(w, BAND_MASK(l->sub.enabled, l->low.enabled, l->mid.enabled, l->high.enabled));
+
+  EndGroup(w, group);
+}
+
+/**
+  * @brief  Encode the delay group
+  * @param  w        Output cursor
+  * @param  settings Settings to encode
+  * @retval None
+  */
+static void EncodeDelay(CodecWriter_t* w, const PresetSettings_t* settings)
+{
+  const DelaySettings_t* d = &settings->delay;
+  uint16_t group = BeginGroup(w, CODEC_TAG_DELAY);
+
+  PutU16(w, QuantizeUnsigned(d->subDelay, CODEC_SCALE_DELAY_MS, 0xFFFF));
+  PutU16(w, QuantizeUnsigned(d->lowDelay, CODEC_SCALE_DELAY_MS, 0xFFFF));
+  PutU16(w, QuantizeUnsigned(d->midDelay, CODEC_SCALE_DELAY_MS, 0xFFFF));
+  PutU16(w, QuantizeUnsigned(d->highDelay, CODEC_SCALE_DELAY_MS, 0xFFFF));
+  PutU8(w, BAND_MASK(d->subPhaseInvert, d->lowPhaseInvert, d->midPhaseInvert, d->highPhaseInvert));
+
+  EndGroup(w, group);
+}
+
+/**
+  * @brief  Decode one group into the settings and metadata
+  * @note   Fields past the end of the group are left unchanged and unknown
+  *         tags are ignored
+  * @param  tag      Group tag
+  * @param  r        Cursor over the group fields
+  * @param  settings Settings to update (may be NULL)
+  * @param  metadata Metadata to update (may be NULL)
+  * @retval None
+  */
+static void DecodeGroup(uint8_t tag, CodecReader_t* r, PresetSettings_t* settings,
+                        PresetMetadata_t* metadata)
+{
+  uint16_t u16;
+  uint8_t u8;
+
+  switch (tag) {
+    case CODEC_TAG_NAME:
+      if (metadata != NULL) {
+        for (uint8_t i = 0; i < CODEC_NAME_MAX && GetU8(r, &u8); i++) {
+          metadata->name[i] = (char)u8;
+        }
+      }
+      break;
+
+    case CODEC_TAG_TIMESTAMP:
+      if (metadata != NULL) {
+        GetU32(r, &metadata->timestamp);
+      }
+      break;
+
+    case CODEC_TAG_CROSSOVER:
+      if (settings != NULL) {
+        CrossoverSettings_t* x = &settings->crossover;
+        if (GetU16(r, &u16)) x->lowCutoff = (float)u16;
+        if (GetU16(r, &u16)) x->midCutoff = (float)u16;
+        if (GetU16(r, &u16)) x->highCutoff = (float)u16;
+        if (GetU16(r, &u16)) x->subGain = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);
+        if (GetU16(r, &u16)) x->lowGain = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);
+        if (GetU16(r, &u16)) x->midGain = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);
+        if (GetU16(r, &u16)) x->highGain = DEQUANTIZE((int16_t)u16, CODEC_SCALE_DB);
+        if (GetU8(r, &u8)) {
+          x->filterType = u8 >> 4;
+          x->filterOrder = u8 & 0x0F;
+        }
+        if (GetU8(r, &u8)) {
+          x->subMute = (u8 & 0x01) ? 1 : 0;
+          x->lowMute = (u8 & 0x02) ? 1 : 0;
+          x->midMute = (u8 & 0x04) ? 1 : 0;
+          x->highMute = (u8 & 0x08) ? 1 : 0;
+        }
+      }
+      break;
+
+    case CODEC_TAG_COMPRESSOR:
+      if (settings != NULL) {
+        CompressorSettings_t* c = &settings->compressor;
+        DECODE_COMPRESSOR_BAND(r, c, sub);
+        DECODE_COMPRESSOR_BAND(r, c, low);
+        DECODE_COMPRESSOR_BAND(r, c, mid);
+        DECODE_COMPRESSOR_BAND(r, c, high);
+        if (GetU8(r, &u8)) {
+          c->sub.enabled = (u8 & 0x01) ? 1 : 0;
+          c->low.enabled = (u8 & 0x02) ? 1 : 0;
+          c->mid.enabled = (u8 & 0x04) ? 1 : 0;
+          c->high.enabled = (u8 & 0x08) ? 1 : 0;
+        }
+      }
+      break;
+
+    case CODEC_TAG_LIMITER:
+      if (settings != NULL) {
+        LimiterSettings_t* l = &settings->limiter;
+        DECODE_LIMITER_BAND(r, l, sub);
+        DECODE_LIMITER_BAND(r, l, low);
+        DECODE_LIMITER_BAND(r, l, mid);
+        DECODE_LIMITER_BAND(r, l, high);
+        if (GetU8(r, &u8)) {
+          l->sub.enabled = (u8 & 0x01) ? 1 : 0;
+          l->low.enabled = (u8 & 0x02) ? 1 : 0;
+          l->mid.enabled = (u8 & 0x04) ? 1 : 0;
+          l->high.enabled = (u8 & 0x08) ? 1 : 0;
+        }
+      }
+      break;
+
+    case CODEC_TAG_DELAY:
+      if (settings != NULL) {
+        DelaySettings_t* d = &settings->delay;
+        if (GetU16(r, &u16)) d->subDelay = DEQUANTIZE(u16, CODEC_SCALE_DELAY_MS);
+        if (GetU16(r, &u16)) d->lowDelay = DEQUANTIZE(u16, CODEC_SCALE_DELAY_MS);
+        if (GetU16(r, &u16)) d->midDelay = DEQUANTIZE(u16, CODEC_SCALE_DELAY_MS);
+        if (GetU16(r, &u16)) d->highDelay = DEQUANTIZE(u16, CODEC_SCALE_DELAY_MS);
+        if (GetU8(r, &u8)) {
+          d->subPhaseInvert = (u8 & 0x01) ? 1 : 0;
+          d->lowPhaseInvert = (u8 & 0x02) ? 1 : 0;
+          d->midPhaseInvert = (u8 & 0x04) ? 1 : 0;
+          d->highPhaseInvert = (u8 & 0x08) ? 1 : 0;
+        }
+      }
+      break;
+
+    default:
+      /* Group added by a later layout; skip it */
+      break;
+  }
+}
+
+/**
+  * @brief  Start a group
+  * @param  w   Output cursor
+  * @param  tag Group tag
+  * @retval Position of the group length byte
+  */
+static uint16_t BeginGroup(CodecWriter_t* w, uint8_t tag)
+{
+  PutU8(w, tag);
+  uint16_t lengthPosition = w->position;
+  PutU8(w, 0);
+  return lengthPosition;
+}
+
+/**
+  * @brief  Finish a group by filling in its length
+  * @param  w              Output cursor
+  * @param  lengthPosition Value returned by BeginGroup()
+  * @retval None
+  */
+static void EndGroup(CodecWriter_t* w, uint16_t lengthPosition)
+{
+  if (lengthPosition < w->size) {
+    w->buffer[lengthPosition] = (uint8_t)(w->position - lengthPosition - 1);
+  }
+}
+
+static void PutU8(CodecWriter_t* w, uint8_t value)
+{
+  if (w->position < w->size) {
+    w->buffer[w->position] = value;
+  }
+  w->position++;
+}
+
+static void PutU16(CodecWriter_t* w, uint16_t value)
+{
+  PutU8(w, (uint8_t)value);
+  PutU8(w, (uint8_t)(value >> 8));
+}
+
+static void PutU32(CodecWriter_t* w, uint32_t value)
+{
+  PutU16(w, (uint16_t)value);
+  PutU16(w, (uint16_t)(value >> 16));
+}
+
+static uint8_t GetU8(CodecReader_t* r, uint8_t* value)
+{
+  if (r->remaining < 1) {
+    return 0;
+  }
+  *value = r->data[0];
+  r->data++;
+  r->remaining--;
+  return 1;
+}
+
+static uint8_t GetU16(CodecReader_t* r, uint16_t* value)
+{
+  if (r->remaining < 2) {
+    return 0;
+  }
+  *value = (uint16_t)(r->data[0] | (r->data[1] << 8));
+  r->data += 2;
+  r->remaining -= 2;
+  return 1;
+}
+
+static uint8_t GetU32(CodecReader_t* r, uint32_t* value)
+{
+  if (r->remaining < 4) {
+    return 0;
+  }
+  *value = ReadU32(r->data);
+  r->data += 4;
+  r->remaining -= 4;
+  return 1;
+}
+
+/**
+  * @brief  Quantize a signed value to the nearest step, saturating to int16
+  * @param  value Value to quantize
+  * @param  scale Steps per unit
+  * @retval Quantized value
+  */
+static int16_t QuantizeSigned(float value, float scale)
+{
+  float scaled = value * scale;
+  scaled += (scaled >= 0.0f) ? 0.5f : -0.5f;
+
+  if (scaled >= 32767.0f) {
+    return 32767;
+  }
+  if (scaled <= -32768.0f) {
+    return -32768;
+  }
+  return (int16_t)scaled;
+}
+
+/**
+  * @brief  Quantize a non-negative value to the nearest step, saturating
+  * @param  value Value to quantize
+  * @param  scale Steps per unit
+  * @param  max   Largest value the field can hold
+  * @retval Quantized value
+  */
+static uint16_t QuantizeUnsigned(float value, float scale, uint16_t max)
+{
+  float scaled = value * scale + 0.5f;
+
+  if (scaled <= 0.0f) {
+    return 0;
+  }
+  if (scaled >= (float)max) {
+    return max;
+  }
+  return (uint16_t)scaled;
+}
+
+static uint32_t ReadU32(const uint8_t* data)
+{
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+         ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
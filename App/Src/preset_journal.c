@@ -0,0 +1,999 @@
+ /**
+  ******************************************************************************
+  * @file           : preset_journal.c
+  * @brief          : Append-only, wear-leveled preset record store
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Layout of each sector:
+  *
+  *   [sector header][record][record]...[erased]
+  *
+  * A record is a header followed by its payload, padded to 4 bytes. Records
+  * are only ever appended; the newest record (highest sequence) for a key
+  * wins. A delete appends a tombstone. When the active sector is full, the
+  * live records are copied to the other sector (compaction), so each save
+  * costs a program operation and sectors are erased in turn.
+  *
+  * Power-loss safety:
+  *  - A record's commit word is programmed last. Records without it, or with
+  *    a bad CRC, are ignored at boot.
+  *  - A header whose length check fails cannot be skipped safely, so the rest
+  *    of the sector is treated as full and the next write compacts.
+  *  - The space of a record is taken only once its header reads back intact.
+  *    A header write that fails leaves the space erased for the next record,
+  *    or, if it programmed part of the header, the sector is treated as full
+  *    as at boot. Nothing is ever appended behind a header the boot scan
+  *    would stop at.
+  *  - The sector header of a compaction target is programmed last, so an
+  *    interrupted compaction leaves the old sector active.
+  *
+  * Writes run as a job advanced by PresetJournal_Step(), each step programming
+  * at most JOURNAL_STEP_BYTES so the main loop can keep servicing audio
+  * between steps. The spare sector is erased at boot (before audio starts),
+  * so a compaction during operation only programs. Only a second compaction
+  * in the same session has to erase at runtime; that erase is started in one
+  * step and polled in the following ones, so no step waits for it.
+  *
+  * Storage without a valid sector header is never erased at mount: it may
+  * hold the fixed preset slots of older firmware. The caller starts a journal
+  * with PresetJournal_BeginFormat() in the sector clear of those slots, copies
+  * them over, and PresetJournal_EndFormat() programs the sector header and
+  * only then erases the old slots.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "preset_journal.h"
+#include "flash_storage.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Sector header (programmed last when a sector is activated)
+  */
+typedef struct {
+    uint32_t magic;        /* JOURNAL_SECTOR_MAGIC */
+    uint32_t generation;   /* Higher generation is newer */
+    uint32_t eraseCount;   /* Lifetime erase count of this sector */
+    uint32_t check;        /* Integrity check of the fields above */
+} JournalSectorHeader_t;
+
+/**
+  * @brief  Record header
+  */
+typedef struct {
+    uint16_t magic;        /* JOURNAL_RECORD_MAGIC */
+    uint8_t key;           /* Record key (preset ID) */
+    uint8_t flags;         /* JOURNAL_FLAG_* */
+    uint16_t length;       /* Payload length in bytes */
+    uint16_t lengthInv;    /* ~length, validates the header before skipping */
+    uint32_t sequence;     /* Global write sequence number */
+    uint32_t crc;          /* CRC32 of key, flags, length, sequence and payload */
+    uint32_t commit;       /* JOURNAL_COMMIT_MARK once the record is complete */
+} JournalRecordHeader_t;
+
+/**
+  * @brief  Write job states
+  */
+typedef enum {
+    JOB_IDLE = 0,
+    JOB_ERASE_SPARE,
+    JOB_ERASE_WAIT,
+    JOB_COMPACT_COPY,
+    JOB_COMPACT_ACTIVATE,
+    JOB_APPEND_HEADER,
+    JOB_APPEND_PAYLOAD,
+    JOB_APPEND_COMMIT
+} JournalJobState_t;
+
+/**
+  * @brief  Write job (one record append, with compaction if needed)
+  */
+typedef struct {
+    JournalJobState_t state;
+    JournalRecordHeader_t header;   /* Header of the record being appended */
+    const uint8_t* data;            /* Payload owned by the caller until done */
+    uint32_t address;               /* Flash address of the record */
+    uint32_t done;                  /* Bytes programmed in the current phase */
+    uint8_t compactKey;             /* Key being copied during compaction */
+    uint32_t compactOffset;         /* Write offset in the compaction target */
+    uint32_t newAddress[JOURNAL_MAX_KEYS];  /* Record addresses in the target */
+} JournalJob_t;
+
+/**
+  * @brief  Index entry for the latest record of a key
+  */
+typedef struct {
+    uint32_t address;      /* Flash address of the record header, 0 if none */
+    uint32_t sequence;     /* Sequence number of that record */
+    uint8_t deleted;       /* 1 if the latest record is a tombstone */
+} JournalIndexEntry_t;
+
+/* Private define ------------------------------------------------------------*/
+#define JOURNAL_SECTOR_MAGIC       0x4A524E4CUL  /* "JRNL" */
+#define JOURNAL_RECORD_MAGIC       0x5052U       /* "PR" */
+#define JOURNAL_COMMIT_MARK        0x00000000UL  /* Programmed over erased 0xFFFFFFFF */
+#define JOURNAL_ERASED_WORD        0xFFFFFFFFUL
+
+#define JOURNAL_FLAG_DELETED       0x01
+
+#define JOURNAL_COPY_CHUNK         64
+
+/* Bytes programmed per PresetJournal_Step() call (~8 words, ~0.15 ms) */
+#define JOURNAL_STEP_BYTES         32
+
+/* Private macro -------------------------------------------------------------*/
+#define ALIGN4(x)                  (((x) + 3U) & ~3U)
+#define SECTOR_ADDR(sector)        (JOURNAL_BASE_ADDR + (uint32_t)(sector) * JOURNAL_SECTOR_SIZE)
+#define RECORD_SIZE(length)        ALIGN4(sizeof(JournalRecordHeader_t) + (length))
+#define SECTOR_CHECK(h)            (~((h)->magic ^ (h)->generation ^ (h)->eraseCount))
+
+/* Private variables ---------------------------------------------------------*/
+static JournalIndexEntry_t journalIndex[JOURNAL_MAX_KEYS];
+static uint8_t activeSector = 0;
+static uint32_t activeGeneration = 0;
+static uint32_t writeOffset = 0;
+static uint32_t nextSequence = 1;
+static uint32_t compactionCount = 0;
+static uint32_t sectorEraseCount[JOURNAL_NUM_SECTORS];
+static uint8_t recoveredAtBoot = 0;
+static uint8_t spareErased = 0;
+static uint8_t mounted = 0;
+static uint8_t formatting = 0;
+static JournalJob_t job;
+
+/* Scratch for copying and CRC checking of payloads */
+static uint8_t copyBuffer[JOURNAL_COPY_CHUNK];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t ReadSectorHeader(uint8_t sector, JournalSectorHeader_t* header);
+static uint8_t WriteSectorHeader(uint8_t sector, uint32_t generation);
+static void ScanActiveSector(void);
+static uint8_t IsSectorErased(uint8_t sector);
+static void PrepareSpare(void);
+static uint8_t BeginJob(uint8_t key, uint8_t flags, const void* data, uint16_t length);
+static uint8_t RunJob(void);
+static uint8_t StepCompactCopy(void);
+static uint8_t StepCompactActivate(void);
+static uint8_t HeaderWritten(void);
+static void DiscardFailedHeader(void);
+static uint32_t RecordCrc(const JournalRecordHeader_t* header, uint32_t payloadAddress);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Mount the journal: select the active sector and rebuild the index
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_Init(void)
+{
+  JournalSectorHeader_t header[JOURNAL_NUM_SECTORS];
+  uint8_t valid[JOURNAL_NUM_SECTORS];
+
+  memset(journalIndex, 0, sizeof(journalIndex));
+  memset(&job, 0, sizeof(job));
+  nextSequence = 1;
+  compactionCount = 0;
+  recoveredAtBoot = 0;
+  mounted = 0;
+  formatting = 0;
+
+  for (uint8_t s = 0; s < JOURNAL_NUM_SECTORS; s++) {
+    valid[s] = ReadSectorHeader(s, &header[s]);
+    sectorEraseCount[s] = valid[s] ? header[s].eraseCount : 0;
+  }
+
+  /* Sectors are erased alternately, so a sector whose header was lost
+     (interrupted compaction) has about the same wear as its peer */
+  if (valid[0] != valid[1]) {
+    uint8_t lost = valid[0] ? 1 : 0;
+    sectorEraseCount[lost] = sectorEraseCount[1 - lost];
+  }
+
+  /* Pick the newest valid sector */
+  if (valid[0] && valid[1]) {
+    activeSector = (header[1].generation > header[0].generation) ? 1 : 0;
+  } else if (valid[0] || valid[1]) {
+    activeSector = valid[0] ? 0 : 1;
+  } else {
+    /* Blank storage, or presets of an older layout: leave it to the caller */
+    #ifdef DEBUG
+    printf("Preset journal: storage not formatted\r\n");
+    #endif
+    return JOURNAL_STATUS_UNFORMATTED;
+  }
+
+  activeGeneration = header[activeSector].generation;
+  ScanActiveSector();
+  mounted = 1;
+
+  PrepareSpare();
+
+  #ifdef DEBUG
+  printf("Preset journal: sector %d gen %lu, %lu/%u bytes used%s\r\n",
+         activeSector, activeGeneration, writeOffset, JOURNAL_SECTOR_SIZE,
+         recoveredAtBoot ? " (recovered)" : "");
+  #endif
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Start a new, empty journal on unformatted storage
+  * @param  keepAddress Start of a range that must not be erased yet
+  * @param  keepLength  Length of the range in bytes, 0 for none
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_BeginFormat(uint32_t keepAddress, uint32_t keepLength)
+{
+  uint8_t target;
+
+  if (mounted || job.state != JOB_IDLE) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  /* First sector that does not overlap the kept range */
+  for (target = 0; target < JOURNAL_NUM_SECTORS; target++) {
+    uint32_t base = SECTOR_ADDR(target);
+    if (keepLength == 0 || keepAddress >= base + JOURNAL_SECTOR_SIZE ||
+        keepAddress + keepLength <= base) {
+      break;
+    }
+  }
+  if (target >= JOURNAL_NUM_SECTORS) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  #ifdef DEBUG
+  printf("Preset journal: formatting sector %d\r\n", target);
+  #endif
+
+  /* Left without a header until PresetJournal_EndFormat() */
+  if (Flash_EraseSector(SECTOR_ADDR(target)) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+  sectorEraseCount[target]++;
+
+  memset(journalIndex, 0, sizeof(journalIndex));
+  activeSector = target;
+  activeGeneration = 1;
+  writeOffset = sizeof(JournalSectorHeader_t);
+  nextSequence = 1;
+  spareErased = 0;
+  formatting = 1;
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Activate the journal started by PresetJournal_BeginFormat()
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_EndFormat(void)
+{
+  if (!formatting || job.state != JOB_IDLE) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  if (WriteSectorHeader(activeSector, activeGeneration) != JOURNAL_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+  formatting = 0;
+  mounted = 1;
+
+  /* The other sector may hold what the caller has just copied over */
+  PrepareSpare();
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Append a new version of a record
+  * @param  key    Record key (0 to JOURNAL_MAX_KEYS-1)
+  * @param  data   Payload to store
+  * @param  length Payload length in bytes (at most JOURNAL_MAX_PAYLOAD)
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_Write(uint8_t key, const void* data, uint16_t length)
+{
+  uint8_t status = PresetJournal_BeginWrite(key, data, length);
+  if (status != JOURNAL_STATUS_OK) {
+    return status;
+  }
+
+  return RunJob();
+}
+
+/**
+  * @brief  Start appending a new version of a record without blocking
+  * @param  key    Record key (0 to JOURNAL_MAX_KEYS-1)
+  * @param  data   Payload to store; must stay valid until the job completes
+  * @param  length Payload length in bytes (at most JOURNAL_MAX_PAYLOAD)
+  * @retval JOURNAL_STATUS_OK if the job was started, or error code
+  */
+uint8_t PresetJournal_BeginWrite(uint8_t key, const void* data, uint16_t length)
+{
+  if (key >= JOURNAL_MAX_KEYS || data == NULL || length == 0 || length > JOURNAL_MAX_PAYLOAD) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  return BeginJob(key, 0, data, length);
+}
+
+/**
+  * @brief  Advance the current write job by one bounded step
+  * @retval JOURNAL_STATUS_BUSY while the job runs, JOURNAL_STATUS_OK when it
+  *         has completed (or no job is active), or error code
+  */
+uint8_t PresetJournal_Step(void)
+{
+  uint8_t status = JOURNAL_STATUS_BUSY;
+
+  switch (job.state) {
+    case JOB_IDLE:
+      return JOURNAL_STATUS_OK;
+
+    case JOB_ERASE_SPARE:
+      /* Runtime erase: only reached on a second compaction since boot */
+      if (Flash_BeginErase(SECTOR_ADDR((activeSector + 1) % JOURNAL_NUM_SECTORS)) != FLASH_STATUS_OK) {
+        status = JOURNAL_STATUS_ERROR;
+        break;
+      }
+      job.state = JOB_ERASE_WAIT;
+      break;
+
+    case JOB_ERASE_WAIT:
+      {
+        uint8_t target = (activeSector + 1) % JOURNAL_NUM_SECTORS;
+        uint8_t eraseStatus = Flash_PollErase();
+        if (eraseStatus == FLASH_STATUS_BUSY) {
+          break;
+        }
+        if (eraseStatus != FLASH_STATUS_OK) {
+          status = JOURNAL_STATUS_ERROR;
+          break;
+        }
+        sectorEraseCount[target]++;
+        spareErased = 1;
+        job.compactKey = 0;
+        job.compactOffset = sizeof(JournalSectorHeader_t);
+        job.done = 0;
+        job.state = JOB_COMPACT_COPY;
+      }
+      break;
+
+    case JOB_COMPACT_COPY:
+      status = StepCompactCopy();
+      break;
+
+    case JOB_COMPACT_ACTIVATE:
+      status = StepCompactActivate();
+      break;
+
+    case JOB_APPEND_HEADER:
+      /* Header (commit word left erased) */
+      if (Flash_Write(job.address, (uint8_t*)&job.header, sizeof(job.header)) != FLASH_STATUS_OK ||
+          !HeaderWritten()) {
+        DiscardFailedHeader();
+        status = JOURNAL_STATUS_ERROR;
+        break;
+      }
+      writeOffset = job.address - SECTOR_ADDR(activeSector) + RECORD_SIZE(job.header.length);
+      job.done = 0;
+      job.state = (job.header.length > 0) ? JOB_APPEND_PAYLOAD : JOB_APPEND_COMMIT;
+      break;
+
+    case JOB_APPEND_PAYLOAD:
+      {
+        uint32_t chunk = MIN((uint32_t)job.header.length - job.done, (uint32_t)JOURNAL_STEP_BYTES);
+        if (Flash_Write(job.address + sizeof(job.header) + job.done,
+                        job.data + job.done, chunk) != FLASH_STATUS_OK) {
+          status = JOURNAL_STATUS_ERROR;
+          break;
+        }
+        job.done += chunk;
+        if (job.done >= job.header.length) {
+          job.state = JOB_APPEND_COMMIT;
+        }
+      }
+      break;
+
+    case JOB_APPEND_COMMIT:
+      {
+        uint32_t commit = JOURNAL_COMMIT_MARK;
+        if (Flash_Write(job.address + offsetof(JournalRecordHeader_t, commit),
+                        (uint8_t*)&commit, sizeof(commit)) != FLASH_STATUS_OK) {
+          status = JOURNAL_STATUS_ERROR;
+          break;
+        }
+
+        /* Record is durable; update the index */
+        JournalIndexEntry_t *entry = &journalIndex[job.header.key];
+        entry->address = job.address;
+        entry->sequence = job.header.sequence;
+        entry->deleted = (job.header.flags & JOURNAL_FLAG_DELETED) ? 1 : 0;
+        nextSequence = job.header.sequence + 1;
+
+        job.state = JOB_IDLE;
+        status = JOURNAL_STATUS_OK;
+      }
+      break;
+
+    default:
+      status = JOURNAL_STATUS_ERROR;
+      break;
+  }
+
+  if (status != JOURNAL_STATUS_BUSY && status != JOURNAL_STATUS_OK) {
+    /* Abandon the job; a partial record is discarded at the next boot */
+    job.state = JOB_IDLE;
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Check whether a write job is in progress
+  * @retval 1 if busy, 0 otherwise
+  */
+uint8_t PresetJournal_IsBusy(void)
+{
+  return (job.state != JOB_IDLE) ? 1 : 0;
+}
+
+/**
+  * @brief  Read the latest version of a record
+  * @param  key    Record key
+  * @param  data   Buffer to fill
+  * @param  length Number of bytes to read from the start of the payload
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_NOT_FOUND or error code
+  */
+uint8_t PresetJournal_Read(uint8_t key, void* data, uint16_t length)
+{
+  JournalRecordHeader_t header;
+
+  if (key >= JOURNAL_MAX_KEYS || data == NULL) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  if (journalIndex[key].address == 0 || journalIndex[key].deleted) {
+    return JOURNAL_STATUS_NOT_FOUND;
+  }
+
+  uint32_t address = journalIndex[key].address;
+  if (Flash_Read(address, (uint8_t*)&header, sizeof(header)) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  if (length > header.length) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  /* Re-verify the record; flash content may have degraded since boot */
+  uint32_t payloadAddress = address + sizeof(header);
+  if (RecordCrc(&header, payloadAddress) != header.crc) {
+    return JOURNAL_STATUS_CORRUPT;
+  }
+
+  if (Flash_Read(payloadAddress, (uint8_t*)data, length) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Read part of the latest version of a record without re-verifying it
+  * @param  key    Record key
+  * @param  offset Offset into the payload
+  * @param  data   Buffer to fill
+  * @param  length Number of bytes to read
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_NOT_FOUND or error code
+  */
+uint8_t PresetJournal_ReadRange(uint8_t key, uint16_t offset, void* data, uint16_t length)
+{
+  JournalRecordHeader_t header;
+
+  if (key >= JOURNAL_MAX_KEYS || data == NULL) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  if (journalIndex[key].address == 0 || journalIndex[key].deleted) {
+    return JOURNAL_STATUS_NOT_FOUND;
+  }
+
+  uint32_t address = journalIndex[key].address;
+  if (Flash_Read(address, (uint8_t*)&header, sizeof(header)) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  if ((uint32_t)offset + length > header.length) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  if (Flash_Read(address + sizeof(header) + offset, (uint8_t*)data, length) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Get the payload length of the latest version of a record
+  * @param  key    Record key
+  * @param  length Receives the payload length in bytes
+  * @retval JOURNAL_STATUS_OK, JOURNAL_STATUS_NOT_FOUND or error code
+  */
+uint8_t PresetJournal_GetLength(uint8_t key, uint16_t* length)
+{
+  JournalRecordHeader_t header;
+
+  if (key >= JOURNAL_MAX_KEYS || length == NULL) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  if (journalIndex[key].address == 0 || journalIndex[key].deleted) {
+    return JOURNAL_STATUS_NOT_FOUND;
+  }
+
+  if (Flash_Read(journalIndex[key].address, (uint8_t*)&header, sizeof(header)) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  *length = header.length;
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Delete a record by appending a tombstone
+  * @param  key Record key
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+uint8_t PresetJournal_Delete(uint8_t key)
+{
+  uint8_t status = PresetJournal_BeginDelete(key);
+  if (status != JOURNAL_STATUS_OK) {
+    return status;
+  }
+
+  return RunJob();
+}
+
+/**
+  * @brief  Start appending a tombstone without blocking
+  * @param  key Record key
+  * @retval JOURNAL_STATUS_OK if started (or nothing to delete), or error code
+  */
+uint8_t PresetJournal_BeginDelete(uint8_t key)
+{
+  if (key >= JOURNAL_MAX_KEYS) {
+    return JOURNAL_STATUS_INVALID;
+  }
+
+  if (journalIndex[key].address == 0 || journalIndex[key].deleted) {
+    return JOURNAL_STATUS_OK;
+  }
+
+  return BeginJob(key, JOURNAL_FLAG_DELETED, NULL, 0);
+}
+
+/**
+  * @brief  Check whether a live record exists for a key
+  * @param  key Record key
+  * @retval 1 if the record exists, 0 otherwise
+  */
+uint8_t PresetJournal_Exists(uint8_t key)
+{
+  if (key >= JOURNAL_MAX_KEYS) {
+    return 0;
+  }
+
+  return (journalIndex[key].address != 0 && !journalIndex[key].deleted) ? 1 : 0;
+}
+
+/**
+  * @brief  Get journal statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void PresetJournal_GetStats(JournalStats_t* stats)
+{
+  if (stats == NULL) {
+    return;
+  }
+
+  stats->activeSector = activeSector;
+  stats->generation = activeGeneration;
+  stats->usedBytes = writeOffset;
+  stats->freeBytes = JOURNAL_SECTOR_SIZE - writeOffset;
+  stats->compactions = compactionCount;
+  stats->recovered = recoveredAtBoot;
+  stats->liveRecords = 0;
+
+  for (uint8_t key = 0; key < JOURNAL_MAX_KEYS; key++) {
+    if (PresetJournal_Exists(key)) {
+      stats->liveRecords++;
+    }
+  }
+
+  for (uint8_t s = 0; s < JOURNAL_NUM_SECTORS; s++) {
+    stats->eraseCount[s] = sectorEraseCount[s];
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Read and validate a sector header
+  * @param  sector Sector index
+  * @param  header Pointer to header structure to fill
+  * @retval 1 if the header is valid, 0 otherwise
+  */
+static uint8_t ReadSectorHeader(uint8_t sector, JournalSectorHeader_t* header)
+{
+  if (Flash_Read(SECTOR_ADDR(sector), (uint8_t*)header, sizeof(JournalSectorHeader_t)) != FLASH_STATUS_OK) {
+    return 0;
+  }
+
+  return (header->magic == JOURNAL_SECTOR_MAGIC && header->check == SECTOR_CHECK(header)) ? 1 : 0;
+}
+
+/**
+  * @brief  Program the header that makes a sector the active journal sector
+  * @param  sector     Sector index
+  * @param  generation Generation number to assign
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+static uint8_t WriteSectorHeader(uint8_t sector, uint32_t generation)
+{
+  JournalSectorHeader_t header;
+
+  header.magic = JOURNAL_SECTOR_MAGIC;
+  header.generation = generation;
+  header.eraseCount = sectorEraseCount[sector];
+  header.check = SECTOR_CHECK(&header);
+
+  if (Flash_Write(SECTOR_ADDR(sector), (uint8_t*)&header, sizeof(header)) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Walk the records of the active sector and rebuild the index
+  * @retval None
+  */
+static void ScanActiveSector(void)
+{
+  JournalRecordHeader_t header;
+  uint32_t base = SECTOR_ADDR(activeSector);
+  uint32_t offset = sizeof(JournalSectorHeader_t);
+
+  while (offset + sizeof(header) <= JOURNAL_SECTOR_SIZE) {
+    if (Flash_Read(base + offset, (uint8_t*)&header, sizeof(header)) != FLASH_STATUS_OK) {
+      break;
+    }
+
+    /* Erased header: end of the log */
+    if (header.magic == 0xFFFFU && header.lengthInv == 0xFFFFU) {
+      break;
+    }
+
+    /* Damaged header: the record size cannot be trusted, stop appending here */
+    if (header.magic != JOURNAL_RECORD_MAGIC ||
+        (uint16_t)(header.length ^ header.lengthInv) != 0xFFFFU ||
+        offset + RECORD_SIZE(header.length) > JOURNAL_SECTOR_SIZE) {
+      offset = JOURNAL_SECTOR_SIZE;
+      recoveredAtBoot = 1;
+      break;
+    }
+
+    uint8_t complete = (header.commit == JOURNAL_COMMIT_MARK) &&
+                       (header.key < JOURNAL_MAX_KEYS) &&
+                       (RecordCrc(&header, base + offset + sizeof(header)) == header.crc);
+
+    if (complete) {
+      JournalIndexEntry_t *entry = &journalIndex[header.key];
+      if (entry->address == 0 || header.sequence > entry->sequence) {
+        entry->address = base + offset;
+        entry->sequence = header.sequence;
+        entry->deleted = (header.flags & JOURNAL_FLAG_DELETED) ? 1 : 0;
+      }
+      if (header.sequence >= nextSequence) {
+        nextSequence = header.sequence + 1;
+      }
+    } else {
+      /* Interrupted write; skip it */
+      recoveredAtBoot = 1;
+    }
+
+    offset += RECORD_SIZE(header.length);
+  }
+
+  writeOffset = offset;
+}
+
+/**
+  * @brief  Check whether a sector is fully erased
+  * @param  sector Sector index
+  * @retval 1 if erased, 0 otherwise
+  */
+static uint8_t IsSectorErased(uint8_t sector)
+{
+  uint32_t base = SECTOR_ADDR(sector);
+
+  for (uint32_t offset = 0; offset < JOURNAL_SECTOR_SIZE; offset += JOURNAL_COPY_CHUNK) {
+    if (Flash_Read(base + offset, copyBuffer, JOURNAL_COPY_CHUNK) != FLASH_STATUS_OK) {
+      return 0;
+    }
+    for (uint8_t i = 0; i < JOURNAL_COPY_CHUNK; i++) {
+      if (copyBuffer[i] != 0xFF) {
+        return 0;
+      }
+    }
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Erase the spare sector unless it is already erased
+  * @note   Called at boot, while an erase cannot disturb audio
+  * @retval None
+  */
+static void PrepareSpare(void)
+{
+  uint8_t spare = (activeSector + 1) % JOURNAL_NUM_SECTORS;
+
+  spareErased = IsSectorErased(spare);
+  if (!spareErased) {
+    if (Flash_EraseSector(SECTOR_ADDR(spare)) == FLASH_STATUS_OK) {
+      sectorEraseCount[spare]++;
+      spareErased = 1;
+    }
+  }
+}
+
+/**
+  * @brief  Set up a job appending one record, compacting first if needed
+  * @param  key    Record key
+  * @param  flags  Record flags
+  * @param  data   Payload (NULL for tombstones)
+  * @param  length Payload length
+  * @retval JOURNAL_STATUS_OK if the job was started, or error code
+  */
+static uint8_t BeginJob(uint8_t key, uint8_t flags, const void* data, uint16_t length)
+{
+  JournalRecordHeader_t *header = &job.header;
+
+  if (!mounted && !formatting) {
+    return JOURNAL_STATUS_UNFORMATTED;
+  }
+
+  if (job.state != JOB_IDLE) {
+    return JOURNAL_STATUS_BUSY;
+  }
+
+  /* A format must not compact into the sector it keeps */
+  if (formatting && writeOffset + RECORD_SIZE(length) > JOURNAL_SECTOR_SIZE) {
+    return JOURNAL_STATUS_FULL;
+  }
+
+  header->magic = JOURNAL_RECORD_MAGIC;
+  header->key = key;
+  header->flags = flags;
+  header->length = length;
+  header->lengthInv = (uint16_t)~length;
+  header->sequence = nextSequence;
+  header->commit = JOURNAL_ERASED_WORD;
+
+  /* CRC over the header fields and the payload in RAM */
+  header->crc = Crc32_Update(CRC32_INIT_VALUE, (const uint8_t*)&header->key, 2);
+  header->crc = Crc32_Update(header->crc, (const uint8_t*)&header->length, 2);
+  header->crc = Crc32_Update(header->crc, (const uint8_t*)&header->sequence, 4);
+  if (length > 0) {
+    header->crc = Crc32_Update(header->crc, (const uint8_t*)data, length);
+  }
+  header->crc = ~header->crc;
+
+  job.data = (const uint8_t*)data;
+  job.done = 0;
+
+  if (writeOffset + RECORD_SIZE(length) > JOURNAL_SECTOR_SIZE) {
+    /* Active sector full: move the live records to the spare sector first */
+    job.compactKey = 0;
+    job.compactOffset = sizeof(JournalSectorHeader_t);
+    job.state = spareErased ? JOB_COMPACT_COPY : JOB_ERASE_SPARE;
+  } else {
+    /* The space is taken when the header is in place */
+    job.address = SECTOR_ADDR(activeSector) + writeOffset;
+    job.state = JOB_APPEND_HEADER;
+  }
+
+  return JOURNAL_STATUS_OK;
+}
+
+/**
+  * @brief  Run the current job to completion (blocking)
+  * @retval JOURNAL_STATUS_OK or error code
+  */
+static uint8_t RunJob(void)
+{
+  uint8_t status;
+
+  do {
+    status = PresetJournal_Step();
+  } while (status == JOURNAL_STATUS_BUSY);
+
+  return status;
+}
+
+/**
+  * @brief  Compaction step: copy one chunk of the next live record
+  * @retval JOURNAL_STATUS_BUSY or error code
+  */
+static uint8_t StepCompactCopy(void)
+{
+  JournalRecordHeader_t record;
+  uint8_t target = (activeSector + 1) % JOURNAL_NUM_SECTORS;
+  uint32_t targetBase = SECTOR_ADDR(target);
+
+  /* Skip keys without a live record, dropping tombstones */
+  while (job.compactKey < JOURNAL_MAX_KEYS &&
+         (journalIndex[job.compactKey].address == 0 || journalIndex[job.compactKey].deleted)) {
+    job.newAddress[job.compactKey] = 0;
+    job.compactKey++;
+  }
+
+  if (job.compactKey >= JOURNAL_MAX_KEYS) {
+    job.state = JOB_COMPACT_ACTIVATE;
+    return JOURNAL_STATUS_BUSY;
+  }
+
+  uint32_t source = journalIndex[job.compactKey].address;
+  if (Flash_Read(source, (uint8_t*)&record, sizeof(record)) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  uint32_t size = RECORD_SIZE(record.length);
+  uint32_t chunk = MIN(size - job.done, (uint32_t)JOURNAL_STEP_BYTES);
+
+  if (Flash_Read(source + job.done, copyBuffer, chunk) != FLASH_STATUS_OK ||
+      Flash_Write(targetBase + job.compactOffset + job.done, copyBuffer, chunk) != FLASH_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  job.done += chunk;
+  if (job.done >= size) {
+    job.newAddress[job.compactKey] = targetBase + job.compactOffset;
+    job.compactOffset += size;
+    job.compactKey++;
+    job.done = 0;
+  }
+
+  return JOURNAL_STATUS_BUSY;
+}
+
+/**
+  * @brief  Compaction step: activate the target sector and queue the append
+  * @retval JOURNAL_STATUS_BUSY or error code
+  */
+static uint8_t StepCompactActivate(void)
+{
+  uint8_t target = (activeSector + 1) % JOURNAL_NUM_SECTORS;
+
+  /* Until this header is written the old sector wins */
+  if (WriteSectorHeader(target, activeGeneration + 1) != JOURNAL_STATUS_OK) {
+    return JOURNAL_STATUS_ERROR;
+  }
+
+  for (uint8_t key = 0; key < JOURNAL_MAX_KEYS; key++) {
+    journalIndex[key].address = job.newAddress[key];
+    journalIndex[key].deleted = 0;
+  }
+
+  activeSector = target;
+  activeGeneration++;
+  writeOffset = job.compactOffset;
+  spareErased = 0;
+  compactionCount++;
+
+  #ifdef DEBUG
+  printf("Preset journal compacted to sector %d (%lu bytes live)\r\n", target, writeOffset);
+  #endif
+
+  /* Now append the pending record */
+  if (writeOffset + RECORD_SIZE(job.header.length) > JOURNAL_SECTOR_SIZE) {
+    return JOURNAL_STATUS_FULL;
+  }
+
+  job.address = SECTOR_ADDR(activeSector) + writeOffset;
+  job.done = 0;
+  job.state = JOB_APPEND_HEADER;
+
+  return JOURNAL_STATUS_BUSY;
+}
+
+/**
+  * @brief  Check that the header of the job's record reads back as written
+  * @retval 1 if intact, 0 otherwise
+  */
+static uint8_t HeaderWritten(void)
+{
+  JournalRecordHeader_t written;
+
+  if (Flash_Read(job.address, (uint8_t*)&written, sizeof(written)) != FLASH_STATUS_OK) {
+    return 0;
+  }
+
+  return (memcmp(&written, &job.header, sizeof(written)) == 0) ? 1 : 0;
+}
+
+/**
+  * @brief  Decide what a failed header write leaves of the active sector
+  * @note   Still erased: the next record goes in the same place. Partly
+  *         programmed: the boot scan stops there, so no record may follow
+  *         it; the sector counts as full and the next write compacts.
+  * @retval None
+  */
+static void DiscardFailedHeader(void)
+{
+  uint8_t erased = 1;
+
+  if (Flash_Read(job.address, copyBuffer, sizeof(JournalRecordHeader_t)) != FLASH_STATUS_OK) {
+    erased = 0;
+  } else {
+    for (uint8_t i = 0; i < sizeof(JournalRecordHeader_t); i++) {
+      if (copyBuffer[i] != 0xFF) {
+        erased = 0;
+        break;
+      }
+    }
+  }
+
+  if (!erased) {
+    writeOffset = JOURNAL_SECTOR_SIZE;
+  }
+}
+
+/**
+  * @brief  Calculate the CRC of a record stored in flash
+  * @param  header         Record header (already read)
+  * @param  payloadAddress Flash address of the payload
+  * @retval CRC32 value
+  */
+static uint32_t RecordCrc(const JournalRecordHeader_t* header, uint32_t payloadAddress)
+{
+  uint32_t crc = CRC32_INIT_VALUE;
+
+  crc = Crc32_Update(crc, (const uint8_t*)&header->key, 2);
+  crc = Crc32_Update(crc, (const uint8_t*)&header->length, 2);
+  crc = Crc32_Update(crc, (const uint8_t*)&header->sequence, 4);
+
+  for (uint32_t done = 0; done < header->length; done += JOURNAL_COPY_CHUNK) {
+    uint32_t chunk = MIN(header->length - done, (uint32_t)JOURNAL_COPY_CHUNK);
+    if (Flash_Read(payloadAddress + done, copyBuffer, chunk) != FLASH_STATUS_OK) {
+      return ~header->crc;  /* Guaranteed mismatch */
+    }
+    crc = Crc32_Update(crc, copyBuffer, chunk);
+  }
+
+  return ~crc;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -20,29 +20,88 @@
 #include "preset_manager.h"
 #include <string.h>
 #include "flash_storage.h"
+#include "preset_journal.h"
+#include "preset_codec.h"
 #include "factory_presets.h"
 #include "audio_preset.h"
+#include "fixed_format.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 #define PRESET_VALID_MARKER           0xABCD1234
 #define STRING_MAX_LENGTH             15
-#define PRESET_STORAGE_BASE_ADDR      0x0800C000  // Starting address in Flash for preset storage
-#define PRESET_STORAGE_SECTOR_SIZE    0x4000      // Size of flash sector (16KB for STM32F411)
-#define PRESET_STORAGE_MAX_SIZE       (PRESET_STORAGE_SECTOR_SIZE * 2) // Use 2 sectors for storage
+
+/* Presets of older firmware: raw Preset_t structures in fixed slots, one per
+   user preset ID, from the start of internal flash sector 3 */
+#ifndef PRESET_LEGACY_BASE_ADDR
+#define PRESET_LEGACY_BASE_ADDR       0x0800C000
+#endif
+#define PRESET_LEGACY_SLOTS           10
+#define PRESET_LEGACY_SIZE            (PRESET_LEGACY_SLOTS * sizeof(Preset_t))
+
+/* Background saves: one being written plus one waiting */
+#define SAVE_QUEUE_DEPTH              2
+
+/* Presets are stored in the journal keyed by preset ID */
+#if TOTAL_PRESET_COUNT > JOURNAL_MAX_KEYS
+#error "Preset journal cannot index all preset IDs"
+#endif
+
+/**
+  * @brief  Background save slot
+  * @note   A delete is queued like a save, as a slot that writes a tombstone
+  */
+typedef struct {
+    uint8_t used;
+    uint8_t deleted;                        /* Tombstone instead of a record */
+    PresetMetadata_t metadata;
+    uint8_t record[PRESET_CODEC_MAX_SIZE];  /* Encoded preset owned by the journal while written */
+    uint16_t length;
+    PresetSaveCallback_t callback;
+} PresetSaveSlot_t;
+
+/**
+  * @brief  Index entry for a stored user preset
+  * @note   Flash locations are tracked by the journal, which also moves them
+  *         on compaction; names and settings stay in flash until needed
+  */
+typedef struct {
+    uint8_t presetId;                /* PRESET_ID_INVALID if the slot is empty */
+    uint8_t version;                 /* Format version of the stored record */
+    uint16_t nameHash;               /* Hash of the name, for lookup by name */
+    uint32_t checksum;               /* Record CRC */
+    uint32_t timestamp;              /* Creation/modification timestamp */
+} PresetIndexEntry_t;
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static uint8_t currentPresetId = 0; // Default preset
-static PresetMetadata_t presetMetadata[MAX_USER_PRESETS];
-static uint8_t presetInfoInitialized = 0;
+static PresetIndexEntry_t presetIndex[MAX_USER_PRESETS];
+static uint8_t presetIndexInitialized = 0;
+
+/* Slot 0 is being written to flash, slot 1 is waiting */
+static PresetSaveSlot_t saveQueue[SAVE_QUEUE_DEPTH];
+static uint8_t saveInProgress = 0;
 
 /* Private function prototypes -----------------------------------------------*/
 static uint32_t CalculateChecksum(const PresetSettings_t* settings);
-static uint32_t GetPresetAddress(uint8_t presetId);
 static void SanitizePresetName(char* name);
 static uint8_t IsPresetValid(const Preset_t* preset);
-static void InitPresetMetadataCache(void);
+static void BuildPresetIndex(void);
+static void UpdatePresetIndex(const PresetMetadata_t* metadata);
+static void RemoveFromIndex(uint8_t presetId);
+static uint8_t ReadPresetName(uint8_t presetId, char* name);
+static uint16_t HashPresetName(const char* name);
+static uint8_t MigrateLegacyPresets(void);
+static uint8_t ReadLegacyPreset(uint8_t presetId, Preset_t* preset);
+static void FormatStorage(void);
+static void BuildMetadata(uint8_t presetId, PresetMetadata_t* metadata);
+static uint8_t ReadPreset(uint8_t presetId, PresetSettings_t* settings, PresetMetadata_t* metadata);
+static PresetSaveSlot_t* ReserveSaveSlot(uint8_t presetId);
+static PresetSaveSlot_t* FindQueuedSave(uint8_t presetId);
+static void QueueSave(PresetSaveSlot_t* slot, PresetSaveCallback_t callback);
+static void StartNextSave(void);
+static void FlushPendingSaves(void);
 
 /**
   * @brief  Initialize the preset manager
@@ -54,8 +113,19 @@ void PresetManager_Init(void)
   // Initialize the flash storage subsystem
   Flash_Init();
   
-  // Initialize metadata cache
-  InitPresetMetadataCache();
+  // Mount the preset journal (recovers from interrupted writes)
+  uint8_t status = PresetJournal_Init();
+  if (status == JOURNAL_STATUS_UNFORMATTED) {
+    // First start, or presets left in the fixed slots of older firmware
+    FormatStorage();
+  } else if (status != JOURNAL_STATUS_OK) {
+    #ifdef DEBUG
+    printf("Preset journal mount failed\r\n");
+    #endif
+  }
+  
+  // Build the preset index
+  BuildPresetIndex();
   
   // Set current preset to default
   currentPresetId = 0;
@@ -66,46 +136,65 @@ void PresetManager_Init(void)
 }
 
 /**
-  * @brief  Initialize the preset metadata cache from flash
+  * @brief  Build the preset index from the journal
+  * @note   Only the start and the CRC trailer of each record are read; the
+  *         journal has already verified every record while mounting
   * @param  None
   * @retval None
   */
-static void InitPresetMetadataCache(void)
+static void BuildPresetIndex(void)
 {
   // If already initialized, skip
-  if (presetInfoInitialized)
+  if (presetIndexInitialized)
     return;
   
-  // Initialize all metadata as invalid
+  // Initialize all entries as empty
   for (uint8_t i = 0; i < MAX_USER_PRESETS; i++) {
-    presetMetadata[i].presetId = PRESET_ID_INVALID;
-    memset(presetMetadata[i].name, 0, sizeof(presetMetadata[i].name));
-    presetMetadata[i].checksum = 0;
-    presetMetadata[i].timestamp = 0;
+    memset(&presetIndex[i], 0, sizeof(PresetIndexEntry_t));
+    presetIndex[i].presetId = PRESET_ID_INVALID;
   }
   
-  // Load metadata for each potential user preset
   for (uint8_t i = 0; i < MAX_USER_PRESETS; i++) {
     uint8_t presetId = USER_PRESET_START_ID + i;
-    Preset_t tempPreset;
+    uint8_t prefix[PRESET_CODEC_PREFIX_SIZE];
+    uint8_t trailer[4];
+    uint16_t length;
+    PresetMetadata_t metadata;
+    uint8_t version;
     
-    // Read preset header from flash
-    uint32_t address = GetPresetAddress(presetId);
-    if (address != 0) {
-      Flash_Read(address, (uint8_t*)&tempPreset, sizeof(PresetMetadata_t));
-      
-      // If preset is valid, cache its metadata
-      if (tempPreset.metadata.presetId == presetId) {
-        memcpy(&presetMetadata[i], &tempPreset.metadata, sizeof(PresetMetadata_t));
-      }
+    if (PresetJournal_GetLength(presetId, &length) != JOURNAL_STATUS_OK ||
+        length < sizeof(trailer)) {
+      continue;
     }
+    
+    // Decode name and timestamp from the record start
+    uint16_t prefixLength = MIN(length, (uint16_t)sizeof(prefix));
+    if (PresetJournal_ReadRange(presetId, 0, prefix, prefixLength) != JOURNAL_STATUS_OK ||
+        PresetCodec_DecodePrefix(prefix, prefixLength, &metadata, &version) != PRESET_CODEC_OK) {
+      continue;
+    }
+    
+    // The record CRC is the last word of the record
+    if (PresetJournal_ReadRange(presetId, length - sizeof(trailer), trailer,
+                                sizeof(trailer)) != JOURNAL_STATUS_OK) {
+      continue;
+    }
+    
+    metadata.presetId = presetId;
+    metadata.checksum = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) |
+                        ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+    UpdatePresetIndex(&metadata);
+    presetIndex[i].version = version;
   }
   
-  presetInfoInitialized = 1;
+  presetIndexInitialized = 1;
 }
 
 /**
-  * @brief  Save a preset to flash memory
+  * @brief  Save a preset to flash memory (blocking)
+  * @note   Waits for background saves and for a compaction with its sector
+  *         erase, if one is due. For start-up and host tools only; at run
+  *         time use PresetManager_SavePresetAsync().
   * @param  presetId: ID of the preset to save
   * @param  settings: Pointer to the settings structure to save
   * @retval Status code (PRESET_STATUS_OK if successful)
@@ -117,54 +206,206 @@ uint8_t PresetManager_SavePreset(uint8_t presetId, const PresetSettings_t* setti
     return PRESET_STATUS_INVALID;
   }
   
-  // Create a complete preset structure with metadata
-  Preset_t preset;
+  // Let background saves finish so this one is not overtaken by them
+  FlushPendingSaves();
   
-  // Set preset ID
-  preset.metadata.presetId = presetId;
+  // Encode the preset with its metadata
+  PresetMetadata_t metadata;
+  uint8_t record[PRESET_CODEC_MAX_SIZE];
+  uint16_t length;
+  BuildMetadata(presetId, &metadata);
+  if (PresetCodec_Encode(settings, &metadata, record, sizeof(record), &length) != PRESET_CODEC_OK) {
+    return PRESET_STATUS_ERROR;
+  }
   
-  // Set default name if this is a new preset
-  uint8_t metadataIndex = presetId - USER_PRESET_START_ID;
-  if (presetMetadata[metadataIndex].presetId == PRESET_ID_INVALID) {
-    snprintf(preset.metadata.name, STRING_MAX_LENGTH + 1, "User Preset %d", presetId);
-  } else {
-    // Keep existing name
-    strncpy(preset.metadata.name, presetMetadata[metadataIndex].name, STRING_MAX_LENGTH + 1);
+  // Append to the journal (no erase unless the active sector is full)
+  uint8_t status = PresetJournal_Write(presetId, record, length);
+  if (status != JOURNAL_STATUS_OK) {
+    return PRESET_STATUS_ERROR;
   }
   
-  // Copy the settings
-  memcpy(&preset.settings, settings, sizeof(PresetSettings_t));
+  // Update index
+  UpdatePresetIndex(&metadata);
   
-  // Calculate checksum
-  preset.metadata.checksum = CalculateChecksum(settings);
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Queue a preset save that runs in the background
+  * @note   The settings are copied, so the caller may reuse them immediately.
+  *         Flash is programmed a few words at a time by PresetManager_Task(),
+  *         which must be called from the main loop. A save queued for a
+  *         preset that is already waiting replaces the waiting one.
+  * @param  presetId: ID of the preset to save
+  * @param  settings: Pointer to the settings structure to save
+  * @param  callback: Called from PresetManager_Task() when done (may be NULL)
+  * @retval PRESET_STATUS_OK if queued, PRESET_STATUS_BUSY if the queue is full
+  */
+uint8_t PresetManager_SavePresetAsync(uint8_t presetId, const PresetSettings_t* settings,
+                                      PresetSaveCallback_t callback)
+{
+  // Check if presetId is valid for user presets
+  if (presetId < USER_PRESET_START_ID || presetId >= TOTAL_PRESET_COUNT) {
+    return PRESET_STATUS_INVALID;
+  }
   
-  // Set timestamp (system tick count or RTC if available)
-  preset.metadata.timestamp = HAL_GetTick();
+  PresetSaveSlot_t *slot = ReserveSaveSlot(presetId);
+  if (slot == NULL) {
+    return PRESET_STATUS_BUSY;
+  }
   
-  // Calculate storage address
-  uint32_t address = GetPresetAddress(presetId);
-  if (address == 0) {
+  slot->deleted = 0;
+  BuildMetadata(presetId, &slot->metadata);
+  if (PresetCodec_Encode(settings, &slot->metadata, slot->record,
+                         sizeof(slot->record), &slot->length) != PRESET_CODEC_OK) {
     return PRESET_STATUS_ERROR;
   }
   
-  // Erase flash sector if needed (simplified - actual implementation might need
-  // to handle sector management more carefully to avoid wearing out the flash)
-  if ((presetId - USER_PRESET_START_ID) % (PRESET_STORAGE_SECTOR_SIZE / sizeof(Preset_t)) == 0) {
-    Flash_EraseSector(address);
+  QueueSave(slot, callback);
+  
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Queue an encoded preset record received from outside (import)
+  * @note   The record is checked and stored as it is, keeping its name and
+  *         timestamp. Written in the background like PresetManager_SavePresetAsync().
+  * @param  presetId: ID of the user preset to replace
+  * @param  record: Encoded preset (preset_codec format)
+  * @param  length: Record length
+  * @param  callback: Called from PresetManager_Task() when done (may be NULL)
+  * @retval PRESET_STATUS_OK if queued, PRESET_STATUS_BUSY if the queue is full,
+  *         PRESET_STATUS_INVALID if the record does not decode
+  */
+uint8_t PresetManager_ImportPresetAsync(uint8_t presetId, const uint8_t* record, uint16_t length,
+                                        PresetSaveCallback_t callback)
+{
+  // Check if presetId is valid for user presets
+  if (presetId < USER_PRESET_START_ID || presetId >= TOTAL_PRESET_COUNT) {
+    return PRESET_STATUS_INVALID;
   }
   
-  // Write to flash
-  uint8_t status = Flash_Write(address, (uint8_t*)&preset, sizeof(Preset_t));
-  if (status != FLASH_STATUS_OK) {
-    return PRESET_STATUS_ERROR;
+  // Reject records that are damaged or written by a newer format version
+  PresetMetadata_t metadata;
+  if (length > PRESET_CODEC_MAX_SIZE ||
+      PresetCodec_Decode(record, length, NULL, &metadata) != PRESET_CODEC_OK) {
+    return PRESET_STATUS_INVALID;
+  }
+  
+  PresetSaveSlot_t *slot = ReserveSaveSlot(presetId);
+  if (slot == NULL) {
+    return PRESET_STATUS_BUSY;
   }
   
-  // Update metadata cache
-  memcpy(&presetMetadata[metadataIndex], &preset.metadata, sizeof(PresetMetadata_t));
+  metadata.presetId = presetId;
+  slot->deleted = 0;
+  memcpy(&slot->metadata, &metadata, sizeof(PresetMetadata_t));
+  memcpy(slot->record, record, length);
+  slot->length = length;
+  
+  QueueSave(slot, callback);
   
   return PRESET_STATUS_OK;
 }
 
+/**
+  * @brief  Get a preset as an encoded record (export)
+  * @note   User presets are copied from flash as stored; factory presets are
+  *         encoded on the fly with a zero timestamp
+  * @param  presetId: ID of the preset
+  * @param  buffer: Output buffer (PRESET_CODEC_MAX_SIZE is always enough)
+  * @param  size: Output buffer size
+  * @param  length: Receives the record length
+  * @retval Status code (PRESET_STATUS_OK if successful)
+  */
+uint8_t PresetManager_ExportPreset(uint8_t presetId, uint8_t* buffer, uint16_t size, uint16_t* length)
+{
+  // Factory presets are not stored; encode them
+  if (presetId < USER_PRESET_START_ID) {
+    PresetSettings_t settings;
+    PresetMetadata_t metadata;
+    if (FactoryPresets_GetPreset(presetId, &settings) != 0 ||
+        PresetManager_GetPresetInfo(presetId, &metadata) != PRESET_STATUS_OK) {
+      return PRESET_STATUS_INVALID;
+    }
+    if (PresetCodec_Encode(&settings, &metadata, buffer, size, length) != PRESET_CODEC_OK) {
+      return PRESET_STATUS_ERROR;
+    }
+    return PRESET_STATUS_OK;
+  }
+  
+  if (presetId >= TOTAL_PRESET_COUNT) {
+    return PRESET_STATUS_INVALID;
+  }
+  
+  uint8_t status = PresetJournal_GetLength(presetId, length);
+  if (status == JOURNAL_STATUS_NOT_FOUND) {
+    return PRESET_STATUS_EMPTY;
+  }
+  if (status != JOURNAL_STATUS_OK || *length > size ||
+      PresetJournal_Read(presetId, buffer, *length) != JOURNAL_STATUS_OK) {
+    return PRESET_STATUS_ERROR;
+  }
+  
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Advance background saves by one bounded step
+  * @note   Called by the storage task while PresetManager_IsBusy(); each
+  *         call returns after one journal step so more urgent tasks run in
+  *         between
+  * @param  None
+  * @retval None
+  */
+void PresetManager_Task(void)
+{
+  if (!saveInProgress) {
+    return;
+  }
+  
+  uint8_t status = PresetJournal_Step();
+  if (status == JOURNAL_STATUS_BUSY) {
+    return;
+  }
+  
+  PresetSaveSlot_t *done = &saveQueue[0];
+  uint8_t presetId = done->metadata.presetId;
+  PresetSaveCallback_t callback = done->callback;
+  
+  if (status == JOURNAL_STATUS_OK) {
+    // Update index
+    if (done->deleted) {
+      RemoveFromIndex(presetId);
+    } else {
+      UpdatePresetIndex(&done->metadata);
+    }
+  }
+  
+  // Promote the waiting save, if any
+  done->used = 0;
+  saveInProgress = 0;
+  if (saveQueue[1].used) {
+    memcpy(&saveQueue[0], &saveQueue[1], sizeof(PresetSaveSlot_t));
+    saveQueue[1].used = 0;
+    StartNextSave();
+  }
+  
+  if (callback != NULL) {
+    callback(presetId, (status == JOURNAL_STATUS_OK) ? PRESET_STATUS_OK : PRESET_STATUS_ERROR);
+  }
+}
+
+/**
+  * @brief  Check whether a background save is pending
+  * @param  None
+  * @retval 1 if busy, 0 otherwise
+  */
+uint8_t PresetManager_IsBusy(void)
+{
+  return (saveInProgress || saveQueue[0].used || saveQueue[1].used) ? 1 : 0;
+}
+
 /**
   * @brief  Load a preset from flash memory or factory presets
   * @param  presetId: ID of the preset to load
@@ -186,27 +427,12 @@ uint8_t PresetManager_LoadPreset(uint8_t presetId, PresetSettings_t* settings)
   
   // Handle user presets
   if (presetId < TOTAL_PRESET_COUNT) {
-    // Calculate storage address
-    uint32_t address = GetPresetAddress(presetId);
-    if (address == 0) {
-      return PRESET_STATUS_ERROR;
-    }
-    
-    // Read preset from flash
-    Preset_t preset;
-    uint8_t status = Flash_Read(address, (uint8_t*)&preset, sizeof(Preset_t));
-    if (status != FLASH_STATUS_OK) {
-      return PRESET_STATUS_ERROR;
+    // Read and decode preset from the journal
+    uint8_t status = ReadPreset(presetId, settings, NULL);
+    if (status != PRESET_STATUS_OK) {
+      return status;
     }
     
-    // Validate preset
-    if (!IsPresetValid(&preset) || preset.metadata.presetId != presetId) {
-      return PRESET_STATUS_INVALID;
-    }
-    
-    // Copy settings
-    memcpy(settings, &preset.settings, sizeof(PresetSettings_t));
-    
     // Set this as current preset
     currentPresetId = presetId;
     
@@ -217,7 +443,9 @@ uint8_t PresetManager_LoadPreset(uint8_t presetId, PresetSettings_t* settings)
 }
 
 /**
-  * @brief  Delete a user preset
+  * @brief  Delete a user preset (blocking)
+  * @note   Waits like PresetManager_SavePreset(). For start-up and host tools
+  *         only; at run time use PresetManager_DeletePresetAsync().
   * @param  presetId: ID of the preset to delete
   * @retval Status code (PRESET_STATUS_OK if successful)
   */
@@ -228,35 +456,50 @@ uint8_t PresetManager_DeletePreset(uint8_t presetId)
     return PRESET_STATUS_INVALID;
   }
   
-  // Calculate storage address
-  uint32_t address = GetPresetAddress(presetId);
-  if (address == 0) {
+  // Let background saves finish first
+  FlushPendingSaves();
+  
+  // Append a tombstone to the journal
+  uint8_t status = PresetJournal_Delete(presetId);
+  if (status != JOURNAL_STATUS_OK) {
     return PRESET_STATUS_ERROR;
   }
   
-  // Create an invalid preset marker to overwrite the existing one
-  Preset_t emptyPreset;
-  memset(&emptyPreset, 0xFF, sizeof(Preset_t));  // 0xFF is the erased state for flash
-  emptyPreset.metadata.presetId = PRESET_ID_INVALID;
+  // Update index
+  RemoveFromIndex(presetId);
   
-  // Write the invalid marker
-  uint8_t status = Flash_Write(address, (uint8_t*)&emptyPreset, sizeof(PresetMetadata_t));
-  if (status != FLASH_STATUS_OK) {
-    return PRESET_STATUS_ERROR;
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Queue a preset delete that runs in the background
+  * @note   The tombstone goes through the save queue, so it is written after
+  *         the saves queued before it and may wait for a compaction, one
+  *         PresetManager_Task() step at a time. The index is updated when
+  *         it is written.
+  * @param  presetId: ID of the preset to delete
+  * @param  callback: Called from PresetManager_Task() when done (may be NULL)
+  * @retval PRESET_STATUS_OK if queued, PRESET_STATUS_BUSY if the queue is full
+  */
+uint8_t PresetManager_DeletePresetAsync(uint8_t presetId, PresetSaveCallback_t callback)
+{
+  // Only user presets can be deleted
+  if (presetId < USER_PRESET_START_ID || presetId >= TOTAL_PRESET_COUNT) {
+    return PRESET_STATUS_INVALID;
   }
   
-  // Update metadata cache
-  uint8_t metadataIndex = presetId - USER_PRESET_START_ID;
-  presetMetadata[metadataIndex].presetId = PRESET_ID_INVALID;
-  memset(presetMetadata[metadataIndex].name, 0, sizeof(presetMetadata[metadataIndex].name));
-  presetMetadata[metadataIndex].checksum = 0;
-  presetMetadata[metadataIndex].timestamp = 0;
-  
-  // If this was the current preset, switch to default
-  if (currentPresetId == presetId) {
-    currentPresetId = 0;
+  PresetSaveSlot_t *slot = ReserveSaveSlot(presetId);
+  if (slot == NULL) {
+    return PRESET_STATUS_BUSY;
   }
   
+  slot->deleted = 1;
+  memset(&slot->metadata, 0, sizeof(PresetMetadata_t));
+  slot->metadata.presetId = presetId;
+  slot->length = 0;
+  
+  QueueSave(slot, callback);
+  
   return PRESET_STATUS_OK;
 }
 
@@ -291,12 +534,18 @@ uint8_t PresetManager_GetPresetInfo(uint8_t presetId, PresetMetadata_t* metadata
     uint8_t metadataIndex = presetId - USER_PRESET_START_ID;
     
     // Check if preset exists
-    if (presetMetadata[metadataIndex].presetId == PRESET_ID_INVALID) {
+    const PresetIndexEntry_t* entry = &presetIndex[metadataIndex];
+    if (entry->presetId == PRESET_ID_INVALID) {
       return PRESET_STATUS_EMPTY;
     }
     
-    // Copy metadata
-    memcpy(metadata, &presetMetadata[metadataIndex], sizeof(PresetMetadata_t));
+    // Fill metadata from the index; the name is read from flash
+    metadata->presetId = presetId;
+    metadata->checksum = entry->checksum;
+    metadata->timestamp = entry->timestamp;
+    if (ReadPresetName(presetId, metadata->name) != PRESET_STATUS_OK) {
+      return PRESET_STATUS_ERROR;
+    }
     
     return PRESET_STATUS_OK;
   }
@@ -305,7 +554,9 @@ uint8_t PresetManager_GetPresetInfo(uint8_t presetId, PresetMetadata_t* metadata
 }
 
 /**
-  * @brief  Rename a user preset
+  * @brief  Rename a user preset (blocking)
+  * @note   Waits like PresetManager_SavePreset(). For start-up and host tools
+  *         only; at run time use PresetManager_RenamePresetAsync().
   * @param  presetId: ID of the preset to rename
   * @param  newName: New name for the preset
   * @retval Status code (PRESET_STATUS_OK if successful)
@@ -320,20 +571,17 @@ uint8_t PresetManager_RenamePreset(uint8_t presetId, const char* newName)
   uint8_t metadataIndex = presetId - USER_PRESET_START_ID;
   
   // Check if preset exists
-  if (presetMetadata[metadataIndex].presetId == PRESET_ID_INVALID) {
+  if (presetIndex[metadataIndex].presetId == PRESET_ID_INVALID) {
     return PRESET_STATUS_EMPTY;
   }
   
-  // Calculate storage address
-  uint32_t address = GetPresetAddress(presetId);
-  if (address == 0) {
-    return PRESET_STATUS_ERROR;
-  }
+  // Let background saves finish first
+  FlushPendingSaves();
   
-  // Read full preset from flash
-  Preset_t preset;
-  uint8_t status = Flash_Read(address, (uint8_t*)&preset, sizeof(Preset_t));
-  if (status != FLASH_STATUS_OK) {
+  // Read and decode the preset from the journal
+  PresetSettings_t settings;
+  PresetMetadata_t metadata;
+  if (ReadPreset(presetId, &settings, &metadata) != PRESET_STATUS_OK) {
     return PRESET_STATUS_ERROR;
   }
   
@@ -343,20 +591,81 @@ uint8_t PresetManager_RenamePreset(uint8_t presetId, const char* newName)
   sanitizedName[STRING_MAX_LENGTH] = '\0';
   SanitizePresetName(sanitizedName);
   
-  strncpy(preset.metadata.name, sanitizedName, STRING_MAX_LENGTH + 1);
+  strncpy(metadata.name, sanitizedName, STRING_MAX_LENGTH + 1);
   
-  // Erase and write back to flash
-  if ((presetId - USER_PRESET_START_ID) % (PRESET_STORAGE_SECTOR_SIZE / sizeof(Preset_t)) == 0) {
-    Flash_EraseSector(address);
+  // Re-encode and append the renamed preset as a new record
+  uint8_t record[PRESET_CODEC_MAX_SIZE];
+  uint16_t length;
+  if (PresetCodec_Encode(&settings, &metadata, record, sizeof(record), &length) != PRESET_CODEC_OK) {
+    return PRESET_STATUS_ERROR;
+  }
+  if (PresetJournal_Write(presetId, record, length) != JOURNAL_STATUS_OK) {
+    return PRESET_STATUS_ERROR;
   }
   
-  status = Flash_Write(address, (uint8_t*)&preset, sizeof(Preset_t));
-  if (status != FLASH_STATUS_OK) {
+  // Update index (name hash and record CRC)
+  UpdatePresetIndex(&metadata);
+  
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Queue a preset rename that runs in the background
+  * @note   The preset is re-encoded with the new name now, from a save of it
+  *         still in the queue if there is one, and written like
+  *         PresetManager_SavePresetAsync()
+  * @param  presetId: ID of the preset to rename
+  * @param  newName: New name for the preset
+  * @param  callback: Called from PresetManager_Task() when done (may be NULL)
+  * @retval PRESET_STATUS_OK if queued, PRESET_STATUS_BUSY if the queue is full,
+  *         PRESET_STATUS_EMPTY if the preset does not exist
+  */
+uint8_t PresetManager_RenamePresetAsync(uint8_t presetId, const char* newName,
+                                        PresetSaveCallback_t callback)
+{
+  // Only user presets can be renamed
+  if (presetId < USER_PRESET_START_ID || presetId >= TOTAL_PRESET_COUNT) {
+    return PRESET_STATUS_INVALID;
+  }
+  
+  // A queued save or delete is newer than what the journal holds
+  PresetSettings_t settings;
+  PresetMetadata_t metadata;
+  PresetSaveSlot_t *queued = FindQueuedSave(presetId);
+  if (queued != NULL) {
+    if (queued->deleted) {
+      return PRESET_STATUS_EMPTY;
+    }
+    FactoryPresets_GetPreset(0, &settings);
+    if (PresetCodec_Decode(queued->record, queued->length, &settings, &metadata) != PRESET_CODEC_OK) {
+      return PRESET_STATUS_ERROR;
+    }
+    metadata.presetId = presetId;
+  } else {
+    uint8_t status = ReadPreset(presetId, &settings, &metadata);
+    if (status != PRESET_STATUS_OK) {
+      return status;
+    }
+  }
+  
+  PresetSaveSlot_t *slot = ReserveSaveSlot(presetId);
+  if (slot == NULL) {
+    return PRESET_STATUS_BUSY;
+  }
+  
+  // Update name
+  strncpy(metadata.name, newName, STRING_MAX_LENGTH);
+  metadata.name[STRING_MAX_LENGTH] = '\0';
+  SanitizePresetName(metadata.name);
+  
+  slot->deleted = 0;
+  memcpy(&slot->metadata, &metadata, sizeof(PresetMetadata_t));
+  if (PresetCodec_Encode(&settings, &slot->metadata, slot->record,
+                         sizeof(slot->record), &slot->length) != PRESET_CODEC_OK) {
     return PRESET_STATUS_ERROR;
   }
   
-  // Update metadata cache
-  strncpy(presetMetadata[metadataIndex].name, sanitizedName, STRING_MAX_LENGTH + 1);
+  QueueSave(slot, callback);
   
   return PRESET_STATUS_OK;
 }
@@ -372,7 +681,7 @@ uint8_t PresetManager_GetPresetCount(void)
   
   // Count user presets
   for (uint8_t i = 0; i < MAX_USER_PRESETS; i++) {
-    if (presetMetadata[i].presetId != PRESET_ID_INVALID) {
+    if (presetIndex[i].presetId != PRESET_ID_INVALID) {
       count++;
     }
   }
@@ -388,7 +697,7 @@ uint8_t PresetManager_GetPresetCount(void)
 uint8_t PresetManager_GetNextEmptySlot(void)
 {
   for (uint8_t i = 0; i < MAX_USER_PRESETS; i++) {
-    if (presetMetadata[i].presetId == PRESET_ID_INVALID) {
+    if (presetIndex[i].presetId == PRESET_ID_INVALID) {
       return USER_PRESET_START_ID + i;
     }
   }
@@ -396,6 +705,37 @@ uint8_t PresetManager_GetNextEmptySlot(void)
   return PRESET_ID_INVALID;
 }
 
+/**
+  * @brief  Find a user preset by name
+  * @note   Candidates are picked from the index by name hash, so only their
+  *         names are read from flash
+  * @param  name: Preset name (compared after sanitizing, as names are stored)
+  * @retval Preset ID or PRESET_ID_INVALID if not found
+  */
+uint8_t PresetManager_FindPreset(const char* name)
+{
+  char sanitizedName[STRING_MAX_LENGTH + 1];
+  strncpy(sanitizedName, name, STRING_MAX_LENGTH);
+  sanitizedName[STRING_MAX_LENGTH] = '\0';
+  SanitizePresetName(sanitizedName);
+  
+  uint16_t hash = HashPresetName(sanitizedName);
+  
+  for (uint8_t i = 0; i < MAX_USER_PRESETS; i++) {
+    if (presetIndex[i].presetId == PRESET_ID_INVALID || presetIndex[i].nameHash != hash) {
+      continue;
+    }
+    
+    char storedName[STRING_MAX_LENGTH + 1];
+    if (ReadPresetName(presetIndex[i].presetId, storedName) == PRESET_STATUS_OK &&
+        strcmp(storedName, sanitizedName) == 0) {
+      return presetIndex[i].presetId;
+    }
+  }
+  
+  return PRESET_ID_INVALID;
+}
+
 /**
   * @brief  Set the current active preset ID
   * @param  presetId: ID to set as current
@@ -419,44 +759,339 @@ uint8_t PresetManager_GetCurrentPreset(void)
 }
 
 /**
-  * @brief  Calculate a simple checksum for preset validation
-  * @param  settings: Pointer to settings structure
-  * @retval Calculated checksum
+  * @brief  Fill the metadata of a preset about to be saved
+  * @note   The checksum is set to the record CRC when the preset is encoded
+  * @param  presetId: ID of the preset
+  * @param  metadata: Metadata structure to fill
+  * @retval None
   */
-static uint32_t CalculateChecksum(const PresetSettings_t* settings)
+static void BuildMetadata(uint8_t presetId, PresetMetadata_t* metadata)
 {
-  uint32_t checksum = PRESET_VALID_MARKER;
-  uint8_t* data = (uint8_t*)settings;
-  uint32_t size = sizeof(PresetSettings_t);
+  // Set preset ID
+  metadata->presetId = presetId;
   
-  for (uint32_t i = 0; i < size; i++) {
-    checksum += data[i];
+  // Keep the existing name, or set a default name if this is a new preset
+  if (ReadPresetName(presetId, metadata->name) != PRESET_STATUS_OK) {
+    FixedFormat_Label(metadata->name, STRING_MAX_LENGTH + 1, "User Preset ", presetId);
   }
   
-  return checksum;
+  metadata->checksum = 0;
+  
+  // Set timestamp (system tick count or RTC if available)
+  metadata->timestamp = HAL_GetTick();
+}
+
+/**
+  * @brief  Record a saved or renamed preset in the index
+  * @param  metadata: Metadata of the preset as stored
+  * @retval None
+  */
+static void UpdatePresetIndex(const PresetMetadata_t* metadata)
+{
+  PresetIndexEntry_t* entry = &presetIndex[metadata->presetId - USER_PRESET_START_ID];
+  
+  entry->presetId = metadata->presetId;
+  entry->version = PRESET_FORMAT_VERSION;
+  entry->nameHash = HashPresetName(metadata->name);
+  entry->checksum = metadata->checksum;
+  entry->timestamp = metadata->timestamp;
+}
+
+/**
+  * @brief  Drop a deleted preset from the index
+  * @param  presetId: ID of the preset
+  * @retval None
+  */
+static void RemoveFromIndex(uint8_t presetId)
+{
+  uint8_t metadataIndex = presetId - USER_PRESET_START_ID;
+  
+  memset(&presetIndex[metadataIndex], 0, sizeof(PresetIndexEntry_t));
+  presetIndex[metadataIndex].presetId = PRESET_ID_INVALID;
+  
+  // If this was the current preset, switch to default
+  if (currentPresetId == presetId) {
+    currentPresetId = 0;
+  }
 }
 
 /**
-  * @brief  Calculate the flash storage address for a preset
+  * @brief  Read the name of a stored user preset from flash
   * @param  presetId: ID of the preset
-  * @retval Flash address or 0 if invalid
+  * @param  name: Buffer of STRING_MAX_LENGTH + 1 characters to fill
+  * @retval Status code (PRESET_STATUS_OK if successful)
   */
-static uint32_t GetPresetAddress(uint8_t presetId)
+static uint8_t ReadPresetName(uint8_t presetId, char* name)
 {
-  // Only calculate for user presets
-  if (presetId < USER_PRESET_START_ID || presetId >= TOTAL_PRESET_COUNT) {
-    return 0;
+  uint8_t prefix[PRESET_CODEC_PREFIX_SIZE];
+  uint16_t length;
+  PresetMetadata_t metadata;
+  
+  if (presetIndex[presetId - USER_PRESET_START_ID].presetId == PRESET_ID_INVALID) {
+    return PRESET_STATUS_EMPTY;
   }
   
-  uint8_t userPresetIndex = presetId - USER_PRESET_START_ID;
-  uint32_t offset = userPresetIndex * sizeof(Preset_t);
+  if (PresetJournal_GetLength(presetId, &length) != JOURNAL_STATUS_OK) {
+    return PRESET_STATUS_ERROR;
+  }
+  
+  length = MIN(length, (uint16_t)sizeof(prefix));
+  if (PresetJournal_ReadRange(presetId, 0, prefix, length) != JOURNAL_STATUS_OK ||
+      PresetCodec_DecodePrefix(prefix, length, &metadata, NULL) != PRESET_CODEC_OK) {
+    return PRESET_STATUS_ERROR;
+  }
   
-  // Make sure we don't exceed the allocated storage
-  if (offset >= PRESET_STORAGE_MAX_SIZE) {
+  strncpy(name, metadata.name, STRING_MAX_LENGTH + 1);
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Hash a preset name (FNV-1a folded to 16 bits)
+  * @param  name: Preset name
+  * @retval Hash value
+  */
+static uint16_t HashPresetName(const char* name)
+{
+  uint32_t hash = 2166136261UL;
+  
+  for (uint8_t i = 0; i < STRING_MAX_LENGTH && name[i] != '\0'; i++) {
+    hash ^= (uint8_t)name[i];
+    hash *= 16777619UL;
+  }
+  
+  return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/**
+  * @brief  Read and decode a user preset from the journal
+  * @param  presetId: ID of the preset
+  * @param  settings: Settings to fill (may be NULL for metadata only)
+  * @param  metadata: Metadata to fill (may be NULL)
+  * @retval Status code (PRESET_STATUS_OK if successful)
+  */
+static uint8_t ReadPreset(uint8_t presetId, PresetSettings_t* settings, PresetMetadata_t* metadata)
+{
+  uint8_t record[PRESET_CODEC_MAX_SIZE];
+  uint16_t length;
+  
+  uint8_t status = PresetJournal_GetLength(presetId, &length);
+  if (status == JOURNAL_STATUS_NOT_FOUND) {
+    return PRESET_STATUS_EMPTY;
+  }
+  if (status != JOURNAL_STATUS_OK) {
+    return PRESET_STATUS_ERROR;
+  }
+  
+  // Records that do not fit are not in the current format
+  if (length > sizeof(record)) {
+    return PRESET_STATUS_INVALID;
+  }
+  
+  if (PresetJournal_Read(presetId, record, length) != JOURNAL_STATUS_OK) {
+    return PRESET_STATUS_ERROR;
+  }
+  
+  // Validate (and read the metadata) before touching the caller's settings
+  if (PresetCodec_Decode(record, length, NULL, metadata) != PRESET_CODEC_OK) {
+    return PRESET_STATUS_INVALID;
+  }
+  if (metadata != NULL) {
+    metadata->presetId = presetId;
+  }
+  
+  if (settings != NULL) {
+    // Fields an older layout did not store keep the default preset's values
+    FactoryPresets_GetPreset(0, settings);
+    PresetCodec_Decode(record, length, settings, NULL);
+  }
+  
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Read a preset from its fixed slot of the old raw layout
+  * @param  presetId: ID of the preset (slot)
+  * @param  preset: Preset to fill
+  * @retval 1 if the slot holds a valid preset, 0 otherwise
+  */
+static uint8_t ReadLegacyPreset(uint8_t presetId, Preset_t* preset)
+{
+  uint32_t address = PRESET_LEGACY_BASE_ADDR + (uint32_t)(presetId - USER_PRESET_START_ID) * sizeof(Preset_t);
+  
+  if (Flash_Read(address, (uint8_t*)preset, sizeof(Preset_t)) != FLASH_STATUS_OK) {
     return 0;
   }
   
-  return PRESET_STORAGE_BASE_ADDR + offset;
+  return (IsPresetValid(preset) && preset->metadata.presetId == presetId) ? 1 : 0;
+}
+
+/**
+  * @brief  Start the preset journal on storage that has none
+  * @note   Blocking; called from PresetManager_Init() before audio starts.
+  *         Presets in the fixed slots of older firmware are copied into the
+  *         new journal first. The slots are only erased once the journal is
+  *         activated, so an interrupted upgrade starts over at the next boot.
+  * @param  None
+  * @retval None
+  */
+static void FormatStorage(void)
+{
+  if (PresetJournal_BeginFormat(PRESET_LEGACY_BASE_ADDR, PRESET_LEGACY_SIZE) != JOURNAL_STATUS_OK) {
+    #ifdef DEBUG
+    printf("Preset journal format failed\r\n");
+    #endif
+    return;
+  }
+  
+  // Leave the journal inactive (and the old slots alone) if a copy failed
+  if (MigrateLegacyPresets() != PRESET_STATUS_OK ||
+      PresetJournal_EndFormat() != JOURNAL_STATUS_OK) {
+    #ifdef DEBUG
+    printf("Preset migration failed, old presets kept\r\n");
+    #endif
+  }
+}
+
+/**
+  * @brief  Copy presets from the fixed slots of older firmware into the journal
+  * @note   Called while the journal is being formatted. Slots that are empty,
+  *         deleted or fail their checksum are skipped.
+  * @param  None
+  * @retval PRESET_STATUS_OK, or PRESET_STATUS_ERROR if a preset was not copied
+  */
+static uint8_t MigrateLegacyPresets(void)
+{
+  Preset_t preset;
+  uint8_t record[PRESET_CODEC_MAX_SIZE];
+  uint16_t length;
+  
+  for (uint8_t presetId = USER_PRESET_START_ID;
+       presetId < USER_PRESET_START_ID + PRESET_LEGACY_SLOTS; presetId++) {
+    if (!ReadLegacyPreset(presetId, &preset)) {
+      continue;
+    }
+    
+    preset.metadata.name[STRING_MAX_LENGTH] = '\0';
+    if (PresetCodec_Encode(&preset.settings, &preset.metadata, record, sizeof(record),
+                           &length) != PRESET_CODEC_OK ||
+        PresetJournal_Write(presetId, record, length) != JOURNAL_STATUS_OK) {
+      return PRESET_STATUS_ERROR;
+    }
+    
+    #ifdef DEBUG
+    printf("Preset %d migrated (%lu -> %u bytes)\r\n", presetId,
+           (unsigned long)sizeof(Preset_t), length);
+    #endif
+  }
+  
+  return PRESET_STATUS_OK;
+}
+
+/**
+  * @brief  Find the save slot for a new background save
+  * @note   The waiting slot is used if the writer is busy, unless it already
+  *         holds another preset
+  * @param  presetId: ID of the preset to save
+  * @retval Slot to fill, or NULL if the queue is full
+  */
+static PresetSaveSlot_t* ReserveSaveSlot(uint8_t presetId)
+{
+  PresetSaveSlot_t *slot = &saveQueue[saveInProgress ? 1 : 0];
+  
+  if (slot->used && slot->metadata.presetId != presetId) {
+    return NULL;
+  }
+  
+  return slot;
+}
+
+/**
+  * @brief  Find the newest queued save or delete of a preset
+  * @param  presetId: ID of the preset
+  * @retval Slot, or NULL if none is queued
+  */
+static PresetSaveSlot_t* FindQueuedSave(uint8_t presetId)
+{
+  for (int8_t i = SAVE_QUEUE_DEPTH - 1; i >= 0; i--) {
+    if (saveQueue[i].used && saveQueue[i].metadata.presetId == presetId) {
+      return &saveQueue[i];
+    }
+  }
+  
+  return NULL;
+}
+
+/**
+  * @brief  Mark a filled save slot as queued and start writing if idle
+  * @param  slot: Slot returned by ReserveSaveSlot()
+  * @param  callback: Completion callback (may be NULL)
+  * @retval None
+  */
+static void QueueSave(PresetSaveSlot_t* slot, PresetSaveCallback_t callback)
+{
+  slot->callback = callback;
+  slot->used = 1;
+  
+  if (!saveInProgress) {
+    StartNextSave();
+  }
+}
+
+/**
+  * @brief  Start writing the save in slot 0
+  * @param  None
+  * @retval None
+  */
+static void StartNextSave(void)
+{
+  PresetSaveSlot_t *slot = &saveQueue[0];
+  uint8_t status;
+  
+  if (slot->deleted) {
+    status = PresetJournal_BeginDelete(slot->metadata.presetId);
+  } else {
+    status = PresetJournal_BeginWrite(slot->metadata.presetId, slot->record, slot->length);
+  }
+  if (status == JOURNAL_STATUS_OK) {
+    saveInProgress = 1;
+    return;
+  }
+  
+  // Could not start: report the failure and drop the save
+  slot->used = 0;
+  if (slot->callback != NULL) {
+    slot->callback(slot->metadata.presetId, PRESET_STATUS_ERROR);
+  }
+}
+
+/**
+  * @brief  Complete all background saves (blocking)
+  * @param  None
+  * @retval None
+  */
+static void FlushPendingSaves(void)
+{
+  while (saveInProgress) {
+    PresetManager_Task();
+  }
+}
+
+/**
+  * @brief  Calculate the checksum of the old raw preset layout
+  * @param  settings: Pointer to settings structure
+  * @retval Calculated checksum
+  */
+static uint32_t CalculateChecksum(const PresetSettings_t* settings)
+{
+  uint32_t checksum = PRESET_VALID_MARKER;
+  uint8_t* data = (uint8_t*)settings;
+  uint32_t size = sizeof(PresetSettings_t);
+  
+  for (uint32_t i = 0; i < size; i++) {
+    checksum += data[i];
+  }
+  
+  return checksum;
 }
 
 /**
@@ -484,7 +1119,7 @@ static void SanitizePresetName(char* name)
 }
 
 /**
-  * @brief  Check if a preset is valid
+  * @brief  Check if a preset in the old raw layout is valid
   * @param  preset: Pointer to preset to validate
   * @retval 1 if valid, 0 if invalid
   */
@@ -0,0 +1,335 @@
+ /**
+  ******************************************************************************
+  * @file           : preset_morph.c
+  * @brief          : Gradual morphing between two presets
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Parameters are not recomputed per sample. Every MORPH_CONTROL_BLOCKS audio
+  * blocks one control update runs, split into stages so that each block pays
+  * for at most one of them:
+  *
+  *   stage 0  interpolate all parameters for the current position
+  *   stage 1  recompute crossover coefficients (filter history kept)
+  *   stage 2  apply compressor and limiter parameters
+  *   stage 3  apply band gains and delays to the processing chain
+  *
+  * The cycles spent in each stage are recorded, so the worst case can be
+  * checked against the block period.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "preset_morph.h"
+#include "crossover.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "delay.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Control update stages */
+#define MORPH_STAGE_INTERPOLATE    0
+#define MORPH_STAGE_CROSSOVER      1
+#define MORPH_STAGE_DYNAMICS       2
+#define MORPH_STAGE_DELAY          3
+
+#if MORPH_CONTROL_BLOCKS != 4
+#error "MORPH_CONTROL_BLOCKS must match the number of morph stages"
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+#define LERP(a, b, t)              ((a) + ((b) - (a)) * (t))
+#define LERP_LOG(a, b, t)          (expf(LERP(logf(MAX((a), 0.01f)), logf(MAX((b), 0.01f)), (t))))
+#define PICK(a, b, t)              (((t) < 0.5f) ? (a) : (b))
+
+/* Interpolate one band of the compressor and limiter settings */
+#define MORPH_COMPRESSOR_BAND(out, a, b, t, band)                                         \
+  do {                                                                                    \
+    (out)->band.threshold = LERP((a)->band.threshold, (b)->band.threshold, (t));          \
+    (out)->band.ratio = MorphRatio((a)->band.ratio, (b)->band.ratio, (t));                \
+    (out)->band.attack = LERP_LOG((a)->band.attack, (b)->band.attack, (t));               \
+    (out)->band.release = LERP_LOG((a)->band.release, (b)->band.release, (t));            \
+    (out)->band.makeupGain = LERP((a)->band.makeupGain, (b)->band.makeupGain, (t));       \
+    (out)->band.enabled = PICK((a)->band.enabled, (b)->band.enabled, (t));                \
+  } while (0)
+
+#define MORPH_LIMITER_BAND(out, a, b, t, band)                                            \
+  do {                                                                                    \
+    (out)->band.threshold = LERP((a)->band.threshold, (b)->band.threshold, (t));          \
+    (out)->band.release = LERP_LOG((a)->band.release, (b)->band.release, (t));            \
+    (out)->band.enabled = PICK((a)->band.enabled, (b)->band.enabled, (t));                \
+  } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static SystemSettings_t morphFrom;
+static SystemSettings_t morphTo;
+static SystemSettings_t morphNow;
+
+static uint8_t morphActive = 0;
+static uint8_t morphStage = MORPH_STAGE_INTERPOLATE;
+static uint32_t morphFramesTotal = 0;
+static uint32_t morphFramesDone = 0;
+static float morphPosition = 0.0f;
+
+static MorphStats_t morphStats;
+
+/* Private function prototypes -----------------------------------------------*/
+static void InterpolateSettings(float t);
+static float MorphGain(float gainA, uint8_t muteA, float gainB, uint8_t muteB, float t);
+static float MorphRatio(float ratioA, float ratioB, float t);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Start morphing from one set of settings to another
+  * @param  from       Settings at the start of the morph (copied)
+  * @param  to         Settings at the end of the morph (copied)
+  * @param  durationMs Morph time in milliseconds
+  * @retval None
+  */
+void PresetMorph_Start(const SystemSettings_t *from, const SystemSettings_t *to, uint32_t durationMs)
+{
+  if (from == NULL || to == NULL) {
+    return;
+  }
+
+  memcpy(&morphFrom, from, sizeof(SystemSettings_t));
+  memcpy(&morphTo, to, sizeof(SystemSettings_t));
+  memcpy(&morphNow, from, sizeof(SystemSettings_t));
+
+  morphFramesTotal = (durationMs * AUDIO_SAMPLE_RATE_HZ) / 1000;
+  if (morphFramesTotal == 0) {
+    morphFramesTotal = 1;
+  }
+  morphFramesDone = 0;
+  morphPosition = 0.0f;
+  morphStage = MORPH_STAGE_INTERPOLATE;
+
+  memset(&morphStats, 0, sizeof(MorphStats_t));
+
+  morphActive = 1;
+
+  #ifdef DEBUG
+  printf("Preset morph started (%lu ms)\r\n", durationMs);
+  #endif
+}
+
+/**
+  * @brief  Stop the morph, leaving the current intermediate settings in place
+  * @retval None
+  */
+void PresetMorph_Stop(void)
+{
+  morphActive = 0;
+}
+
+/**
+  * @brief  Advance the morph (call once per processed audio block)
+  * @param  pSettings Settings used by the processing chain (updated)
+  * @param  frames    Number of frames in the block just processed
+  * @retval None
+  */
+void PresetMorph_Tick(SystemSettings_t *pSettings, uint16_t frames)
+{
+  if (!morphActive || pSettings == NULL) {
+    return;
+  }
+
+  uint32_t start = DWT->CYCCNT;
+
+  morphFramesDone += frames;
+  if (morphFramesDone > morphFramesTotal) {
+    morphFramesDone = morphFramesTotal;
+  }
+
+  switch (morphStage) {
+    case MORPH_STAGE_INTERPOLATE:
+      morphPosition = (float)morphFramesDone / (float)morphFramesTotal;
+      InterpolateSettings(morphPosition);
+      break;
+
+    case MORPH_STAGE_CROSSOVER:
+      Crossover_UpdateCoefficients(&morphNow.crossover);
+      break;
+
+    case MORPH_STAGE_DYNAMICS:
+      memcpy(&pSettings->compressor, &morphNow.compressor, sizeof(morphNow.compressor));
+      memcpy(&pSettings->limiter, &morphNow.limiter, sizeof(morphNow.limiter));
+      Compressor_SetSettings(&morphNow.compressor);
+      Limiter_SetSettings(&morphNow.limiter);
+      break;
+
+    case MORPH_STAGE_DELAY:
+      memcpy(&pSettings->crossover, &morphNow.crossover, sizeof(morphNow.crossover));
+      memcpy(&pSettings->delay, &morphNow.delay, sizeof(morphNow.delay));
+      Delay_SetSettings(&morphNow.delay);
+      morphStats.controlUpdates++;
+
+      /* The last update applied the exact target settings */
+      if (morphPosition >= 1.0f) {
+        memcpy(pSettings, &morphTo, sizeof(SystemSettings_t));
+        morphActive = 0;
+
+        #ifdef DEBUG
+        printf("Preset morph complete (%lu updates, worst stage %lu cycles)\r\n",
+               morphStats.controlUpdates, morphStats.worstCycles);
+        #endif
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  uint32_t cycles = DWT->CYCCNT - start;
+  if (cycles > morphStats.worstStageCycles[morphStage]) {
+    morphStats.worstStageCycles[morphStage] = cycles;
+  }
+  if (cycles > morphStats.worstCycles) {
+    morphStats.worstCycles = cycles;
+  }
+
+  morphStage = (morphStage + 1) % MORPH_CONTROL_BLOCKS;
+}
+
+/**
+  * @brief  Check whether a morph is in progress
+  * @retval 1 if morphing, 0 otherwise
+  */
+uint8_t PresetMorph_IsActive(void)
+{
+  return morphActive;
+}
+
+/**
+  * @brief  Get the morph position
+  * @retval Progress from 0 to 100 percent
+  */
+uint8_t PresetMorph_GetProgress(void)
+{
+  if (!morphActive) {
+    return 100;
+  }
+
+  return (uint8_t)((morphFramesDone * 100UL) / morphFramesTotal);
+}
+
+/**
+  * @brief  Get the morph statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void PresetMorph_GetStats(MorphStats_t *stats)
+{
+  if (stats != NULL) {
+    memcpy(stats, &morphStats, sizeof(MorphStats_t));
+  }
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Compute the settings for a morph position
+  * @param  t Position from 0 (start) to 1 (target)
+  * @retval None
+  */
+static void InterpolateSettings(float t)
+{
+  const SystemSettings_t *a = &morphFrom;
+  const SystemSettings_t *b = &morphTo;
+  SystemSettings_t *out = &morphNow;
+
+  if (t >= 1.0f) {
+    memcpy(out, b, sizeof(SystemSettings_t));
+    return;
+  }
+
+  /* Crossover: cutoffs on a log-frequency scale, gains in dB */
+  out->crossover.lowCutoff = LERP_LOG(a->crossover.lowCutoff, b->crossover.lowCutoff, t);
+  out->crossover.midCutoff = LERP_LOG(a->crossover.midCutoff, b->crossover.midCutoff, t);
+  out->crossover.highCutoff = LERP_LOG(a->crossover.highCutoff, b->crossover.highCutoff, t);
+  out->crossover.subGain = MorphGain(a->crossover.subGain, a->crossover.subMute,
+                                     b->crossover.subGain, b->crossover.subMute, t);
+  out->crossover.lowGain = MorphGain(a->crossover.lowGain, a->crossover.lowMute,
+                                     b->crossover.lowGain, b->crossover.lowMute, t);
+  out->crossover.midGain = MorphGain(a->crossover.midGain, a->crossover.midMute,
+                                     b->crossover.midGain, b->crossover.midMute, t);
+  out->crossover.highGain = MorphGain(a->crossover.highGain, a->crossover.highMute,
+                                      b->crossover.highGain, b->crossover.highMute, t);
+  out->crossover.filterType = PICK(a->crossover.filterType, b->crossover.filterType, t);
+  out->crossover.filterOrder = PICK(a->crossover.filterOrder, b->crossover.filterOrder, t);
+
+  /* Muted bands are faded through MORPH_MUTE_GAIN_DB instead */
+  out->crossover.subMute = 0;
+  out->crossover.lowMute = 0;
+  out->crossover.midMute = 0;
+  out->crossover.highMute = 0;
+
+  /* Dynamics: thresholds and makeup in dB, time constants on a log scale */
+  MORPH_COMPRESSOR_BAND(&out->compressor, &a->compressor, &b->compressor, t, sub);
+  MORPH_COMPRESSOR_BAND(&out->compressor, &a->compressor, &b->compressor, t, low);
+  MORPH_COMPRESSOR_BAND(&out->compressor, &a->compressor, &b->compressor, t, mid);
+  MORPH_COMPRESSOR_BAND(&out->compressor, &a->compressor, &b->compressor, t, high);
+
+  MORPH_LIMITER_BAND(&out->limiter, &a->limiter, &b->limiter, t, sub);
+  MORPH_LIMITER_BAND(&out->limiter, &a->limiter, &b->limiter, t, low);
+  MORPH_LIMITER_BAND(&out->limiter, &a->limiter, &b->limiter, t, mid);
+  MORPH_LIMITER_BAND(&out->limiter, &a->limiter, &b->limiter, t, high);
+
+  /* Delay: linear in time */
+  out->delay.subDelay = LERP(a->delay.subDelay, b->delay.subDelay, t);
+  out->delay.lowDelay = LERP(a->delay.lowDelay, b->delay.lowDelay, t);
+  out->delay.midDelay = LERP(a->delay.midDelay, b->delay.midDelay, t);
+  out->delay.highDelay = LERP(a->delay.highDelay, b->delay.highDelay, t);
+  out->delay.subPhaseInvert = PICK(a->delay.subPhaseInvert, b->delay.subPhaseInvert, t);
+  out->delay.lowPhaseInvert = PICK(a->delay.lowPhaseInvert, b->delay.lowPhaseInvert, t);
+  out->delay.midPhaseInvert = PICK(a->delay.midPhaseInvert, b->delay.midPhaseInvert, t);
+  out->delay.highPhaseInvert = PICK(a->delay.highPhaseInvert, b->delay.highPhaseInvert, t);
+}
+
+/**
+  * @brief  Interpolate a band gain in dB, treating a muted band as very quiet
+  * @param  gainA Start gain in dB
+  * @param  muteA Start mute flag
+  * @param  gainB Target gain in dB
+  * @param  muteB Target mute flag
+  * @param  t Position from 0 to 1
+  * @retval Gain in dB
+  */
+static float MorphGain(float gainA, uint8_t muteA, float gainB, uint8_t muteB, float t)
+{
+  float from = muteA ? MORPH_MUTE_GAIN_DB : gainA;
+  float to = muteB ? MORPH_MUTE_GAIN_DB : gainB;
+
+  return LERP(from, to, t);
+}
+
+/**
+  * @brief  Interpolate a compression ratio
+  * @note   The slope above threshold (1 - 1/ratio) is interpolated, so the
+  *         change in gain reduction is even across the morph
+  * @param  ratioA Start ratio
+  * @param  ratioB Target ratio
+  * @param  t Position from 0 to 1
+  * @retval Ratio
+  */
+static float MorphRatio(float ratioA, float ratioB, float t)
+{
+  float slope = LERP(1.0f - 1.0f / MAX(ratioA, 1.0f), 1.0f - 1.0f / MAX(ratioB, 1.0f), t);
+
+  return 1.0f / (1.0f - MIN(slope, 0.99f));
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -14,12 +14,22 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "rotary_encoder.h"
+#include "input_queue.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define ROTARY_DEBOUNCE_TIME     5     /* Debounce time in ms */
-#define ROTARY_LONGPRESS_TIME    1000  /* Long press time in ms */
-#define ROTARY_QUEUE_SIZE        8     /* Event queue size */
+/* Quadrature counts (edges of A and B) per mechanical detent */
+#define ROTARY_COUNTS_PER_DETENT 4
+
+/* Acceleration: detents closer together than ROTARY_ACCEL_SLOW_MS give more
+   than one step, rising linearly to ROTARY_ACCEL_MAX steps per detent at
+   ROTARY_ACCEL_FAST_MS and faster */
+#define ROTARY_ACCEL_SLOW_MS     80
+#define ROTARY_ACCEL_FAST_MS     10
+#define ROTARY_ACCEL_MAX         10
+#define ROTARY_COARSE_FACTOR     5     /* Steps per detent in coarse mode */
+#define ROTARY_MAX_STEPS         100   /* Limit for a single event */
+#define ROTARY_MAX_PENDING       1000  /* Steps kept while the input queue is full */
 
 /* Encoder pin definitions - must match with GPIO configuration */
 #define ENCODER_CLK_PIN          GPIO_PIN_0  /* Clock pin (A) */
@@ -28,33 +38,54 @@
 
 #define ENCODER_GPIO_PORT        GPIOB      /* GPIO port for all encoder pins */
 
+/* Timer backend: TIM4 channels 1/2 on PB6/PB7 (see HAL_TIM_Encoder_MspInit) */
+#define ENCODER_TIMER            TIM4
+#define ENCODER_TIMER_FILTER     0x0F       /* fDTS/32, N=8: about 10us at fDTS = 25MHz */
+
 /* Private macro -------------------------------------------------------------*/
 #define READ_ENCODER_CLK()   HAL_GPIO_ReadPin(ENCODER_GPIO_PORT, ENCODER_CLK_PIN)
 #define READ_ENCODER_DATA()  HAL_GPIO_ReadPin(ENCODER_GPIO_PORT, ENCODER_DATA_PIN)
 #define READ_ENCODER_BUTTON() HAL_GPIO_ReadPin(ENCODER_GPIO_PORT, ENCODER_BUTTON_PIN)
 
 /* Private variables ---------------------------------------------------------*/
-static volatile uint8_t lastClk = 0;
-static volatile uint8_t lastData = 0;
-static volatile uint8_t lastButtonState = 0;
-static volatile uint32_t buttonPressTime = 0;
-static volatile uint32_t lastDebounceTime = 0;
-static volatile uint8_t isButtonLongPress = 0;
 static volatile uint8_t isEnabled = 1;
-static RotaryMode_t currentMode = ROTARY_MODE_NORMAL;
+static volatile RotaryMode_t currentMode = ROTARY_MODE_NORMAL;
+
+/* Quadrature position (only the low 16 bits are used) */
+#if ROTARY_USE_TIMER
+static TIM_HandleTypeDef htimEncoder;
+#else
+static volatile uint16_t polledCount = 0;
+static uint8_t lastPinState = 0;
+static int8_t lastEdgeDirection = 0;      /* Direction of the last single edge */
 
-/* Event queue */
-static RotaryEvent_t eventQueue[ROTARY_QUEUE_SIZE];
-static volatile uint8_t queueHead = 0;
-static volatile uint8_t queueTail = 0;
-static volatile uint8_t queueCount = 0;
+/* Count change for each (previous AB, current AB) pair. QUADRATURE_SKIP marks
+   both pins changing between samples: two edges went by unseen, and they are
+   counted in the direction of the last edge that was seen. */
+#define QUADRATURE_SKIP          2
+static const int8_t quadratureTable[16] = {
+   0,  1, -1,  2,
+  -1,  0,  2,  1,
+   1,  2,  0, -1,
+   2, -1,  1,  0
+};
+#endif
+
+/* Rotation collected by the sampling interrupt */
+static uint16_t lastCount = 0;
+static int16_t residualCount = 0;         /* Counts not yet making up a detent */
+static int8_t lastDirection = 0;
+static uint32_t lastDetentTime = 0;
+static int16_t pendingSteps = 0;          /* Steps not yet queued (queue full) */
+static volatile uint8_t resyncRequested = 0;
 
 /* External variables --------------------------------------------------------*/
 extern volatile uint32_t systemTick;  /* System tick counter from main.c */
 
 /* Private function prototypes -----------------------------------------------*/
-static void EnqueueEvent(int8_t direction, uint8_t buttonPressed, uint8_t buttonReleased, uint8_t buttonHeld);
-static uint8_t ApplySensitivity(int8_t direction);
+static uint16_t ReadCount(void);
+static int16_t CollectRotation(void);
+static uint8_t AccelerationFactor(uint32_t msPerDetent);
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -64,15 +95,45 @@ static uint8_t ApplySensitivity(int8_t direction);
   */
 void RotaryEncoder_Init(void)
 {
+#if ROTARY_USE_TIMER
+  TIM_Encoder_InitTypeDef encoderConfig = {0};
+  
+  /* Count both edges of both channels, 16-bit wrap */
+  htimEncoder.Instance = ENCODER_TIMER;
+  htimEncoder.Init.Prescaler = 0;
+  htimEncoder.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htimEncoder.Init.Period = 0xFFFF;
+  htimEncoder.Init.ClockDivision = TIM_CLOCKDIVISION_DIV4;
+  htimEncoder.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  
+  encoderConfig.EncoderMode = TIM_ENCODERMODE_TI12;
+  encoderConfig.IC1Polarity = TIM_ICPOLARITY_RISING;
+  encoderConfig.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+  encoderConfig.IC1Prescaler = TIM_ICPSC_DIV1;
+  encoderConfig.IC1Filter = ENCODER_TIMER_FILTER;
+  encoderConfig.IC2Polarity = TIM_ICPOLARITY_RISING;
+  encoderConfig.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+  encoderConfig.IC2Prescaler = TIM_ICPSC_DIV1;
+  encoderConfig.IC2Filter = ENCODER_TIMER_FILTER;
+  
+  if (HAL_TIM_Encoder_Init(&htimEncoder, &encoderConfig) != HAL_OK) {
+    Error_Handler();
+  }
+  HAL_TIM_Encoder_Start(&htimEncoder, TIM_CHANNEL_ALL);
+#else
   /* Read initial state of encoder pins */
-  lastClk = READ_ENCODER_CLK();
-  lastData = READ_ENCODER_DATA();
-  lastButtonState = READ_ENCODER_BUTTON();
+  lastPinState = (READ_ENCODER_CLK() << 1) | READ_ENCODER_DATA();
+  lastEdgeDirection = 0;
+  polledCount = 0;
+#endif
   
-  /* Clear event queue */
-  queueHead = 0;
-  queueTail = 0;
-  queueCount = 0;
+  /* Start counting from the current position */
+  lastCount = ReadCount();
+  residualCount = 0;
+  lastDirection = 0;
+  lastDetentTime = systemTick;
+  pendingSteps = 0;
+  resyncRequested = 0;
   
   /* Set default mode */
   currentMode = ROTARY_MODE_NORMAL;
@@ -82,107 +143,62 @@ void RotaryEncoder_Init(void)
 }
 
 /**
-  * @brief  Sample the rotary encoder pins for state changes
-  * @note   This should be called from a timer ISR or similar at ~1kHz rate
+  * @brief  Read the encoder pins and count their edges (polled backend)
+  * @note   Called from the TIM3 ISR at ROTARY_SAMPLE_HZ
   * @retval None
   */
-void RotaryEncoder_Sample(void)
+void RotaryEncoder_SamplePins(void)
 {
-  uint8_t currentClk, currentData, currentButton;
-  int8_t direction = 0;
-  uint8_t buttonPressed = 0;
-  uint8_t buttonReleased = 0;
-  uint8_t buttonHeld = 0;
+#if !ROTARY_USE_TIMER
+  uint8_t pinState = (READ_ENCODER_CLK() << 1) | READ_ENCODER_DATA();
+  int8_t change;
   
-  /* If encoder processing is disabled, do nothing */
-  if (!isEnabled) {
+  if (pinState == lastPinState) {
     return;
   }
   
-  /* Read current pin states */
-  currentClk = READ_ENCODER_CLK();
-  currentData = READ_ENCODER_DATA();
-  currentButton = READ_ENCODER_BUTTON();
-  
-  /* Process rotary encoder rotation */
-  if (currentClk != lastClk) {
-    /* Falling edge detected on clock pin */
-    if (currentClk == 0) {
-      /* Determine direction based on data pin state */
-      direction = (currentData != 0) ? -1 : 1;
-      
-      /* Apply sensitivity based on current mode */
-      if (ApplySensitivity(direction)) {
-        /* Enqueue the event if it passes sensitivity filter */
-        EnqueueEvent(direction, 0, 0, 0);
-      }
-    }
-    lastClk = currentClk;
-  }
-  
-  /* Process button state with debouncing */
-  if (currentButton != lastButtonState) {
-    lastDebounceTime = systemTick;
-  }
-  
-  /* If debounce time has passed, process button state change */
-  if ((systemTick - lastDebounceTime) > ROTARY_DEBOUNCE_TIME) {
-    /* Button press detected */
-    if (lastButtonState && !currentButton) {
-      buttonPressed = 1;
-      buttonPressTime = systemTick;
-      isButtonLongPress = 0;
-    }
-    /* Button release detected */
-    else if (!lastButtonState && currentButton) {
-      buttonReleased = 1;
-      /* If it wasn't a long press, it's a short press */
-      if (!isButtonLongPress) {
-        /* Enqueue button press + release as a single event */
-        EnqueueEvent(0, 1, 1, 0);
-      } else {
-        /* Just enqueue the release event for long press */
-        EnqueueEvent(0, 0, 1, 0);
-      }
-    }
-  }
-  
-  /* Check for long press */
-  if (!currentButton && !isButtonLongPress) {
-    if ((systemTick - buttonPressTime) > ROTARY_LONGPRESS_TIME) {
-      isButtonLongPress = 1;
-      buttonHeld = 1;
-      /* Enqueue long press event */
-      EnqueueEvent(0, 0, 0, 1);
-    }
+  change = quadratureTable[(lastPinState << 2) | pinState];
+  if (change == QUADRATURE_SKIP) {
+    change = 2 * lastEdgeDirection;
+  } else {
+    lastEdgeDirection = change;
   }
-  
-  /* Update last button state */
-  lastButtonState = currentButton;
+  polledCount += change;
+  lastPinState = pinState;
+#endif
 }
 
 /**
-  * @brief  Get the latest rotary encoder event if available
-  * @param  event Pointer to event structure to fill
-  * @retval 1 if event available, 0 if no event
+  * @brief  Sample the rotary encoder and queue the rotation
+  * @note   Called from the TIM3 ISR every 1 ms
+  * @retval None
   */
-uint8_t RotaryEncoder_GetEvent(RotaryEvent_t* event)
+void RotaryEncoder_Sample(void)
 {
-  /* Check if queue is empty */
-  if (queueCount == 0) {
-    return 0;
-  }
-  
-  /* Get event from queue */
-  *event = eventQueue[queueTail];
+  int32_t steps;
   
-  /* Update queue tail with atomic operation */
-  __disable_irq();
-  queueTail = (queueTail + 1) % ROTARY_QUEUE_SIZE;
-  queueCount--;
-  __enable_irq();
+  /* Drop rotation turned while disabled or before a reset */
+  if (!isEnabled || resyncRequested) {
+    lastCount = ReadCount();
+    residualCount = 0;
+    lastDirection = 0;
+    pendingSteps = 0;
+    resyncRequested = 0;
+    return;
+  }
   
-  return 1;
+  /* Queue whole detents; steps refused by a full queue are kept for later */
+  steps = pendingSteps + CollectRotation();
+  if (steps > ROTARY_MAX_PENDING) {
+    steps = ROTARY_MAX_PENDING;
+  } else if (steps < -ROTARY_MAX_PENDING) {
+    steps = -ROTARY_MAX_PENDING;
+  }
+  if (steps != 0 && !InputQueue_Push(INPUT_SOURCE_ENCODER, 0, 0, steps)) {
+    pendingSteps = steps;
+  } else {
+    pendingSteps = 0;
+  }
 }
 
 /**
@@ -211,12 +227,8 @@ uint8_t RotaryEncoder_GetButtonState(void)
   */
 void RotaryEncoder_Reset(void)
 {
-  /* Clear event queue */
-  __disable_irq();
-  queueHead = 0;
-  queueTail = 0;
-  queueCount = 0;
-  __enable_irq();
+  /* The sampling interrupt owns the counters; it resyncs on its next run */
+  resyncRequested = 1;
 }
 
 /**
@@ -228,88 +240,85 @@ void RotaryEncoder_SetEnabled(uint8_t state)
 {
   isEnabled = state;
   if (!state) {
-    RotaryEncoder_Reset();  /* Clear queue when disabling */
+    RotaryEncoder_Reset();  /* Drop partial detents when disabling */
   }
 }
 
 /* Private functions ---------------------------------------------------------*/
 
 /**
-  * @brief  Add an event to the event queue
-  * @param  direction Rotation direction (-1, 0, 1)
-  * @param  buttonPressed Button press flag
-  * @param  buttonReleased Button release flag
-  * @param  buttonHeld Button long press flag
-  * @retval None
+  * @brief  Read the quadrature position
+  * @retval Position in counts (clockwise counts up), wraps at 16 bits
   */
-static void EnqueueEvent(int8_t direction, uint8_t buttonPressed, uint8_t buttonReleased, uint8_t buttonHeld)
+static uint16_t ReadCount(void)
 {
-  /* If queue is full, oldest event is dropped */
-  if (queueCount == ROTARY_QUEUE_SIZE) {
-    queueTail = (queueTail + 1) % ROTARY_QUEUE_SIZE;
-    queueCount--;
-  }
-  
-  /* Fill event structure */
-  eventQueue[queueHead].direction = direction;
-  eventQueue[queueHead].buttonPressed = buttonPressed;
-  eventQueue[queueHead].buttonReleased = buttonReleased;
-  eventQueue[queueHead].buttonHeld = buttonHeld;
-  
-  /* Update queue head with atomic operation */
-  __disable_irq();
-  queueHead = (queueHead + 1) % ROTARY_QUEUE_SIZE;
-  queueCount++;
-  __enable_irq();
+#if ROTARY_USE_TIMER
+  /* The timer counts down for clockwise turns with A on CH1 */
+  return (uint16_t)(0 - __HAL_TIM_GET_COUNTER(&htimEncoder));
+#else
+  return polledCount;
+#endif
 }
 
 /**
-  * @brief  Apply sensitivity settings to encoder movement
-  * @param  direction Raw direction from encoder (-1 or 1)
-  * @retval 1 if event should be processed, 0 if filtered out
+  * @brief  Turn the counts since the last call into steps
+  * @retval Signed steps (clockwise positive), 0 if no whole detent was turned
   */
-static void ApplySensitivity(int8_t direction)
+static int16_t CollectRotation(void)
 {
-  static int8_t accumulator = 0;
-  static uint8_t counter = 0;
+  uint16_t count = ReadCount();
+  int16_t detents;
+  uint16_t magnitude;
+  uint32_t steps;
+  uint32_t elapsed;
+  int8_t direction;
   
-  /* Apply sensitivity based on mode */
-  switch (currentMode) {
-    case ROTARY_MODE_FINE:
-      /* Fine mode - require multiple steps for one event */
-      accumulator += direction;
-      if (accumulator >= 4) {
-        accumulator -= 4;
-        return 1;  /* Generate a positive event */
-      } else if (accumulator <= -4) {
-        accumulator += 4;
-        return -1;  /* Generate a negative event */
-      }
-      return 0;  /* No event yet */
-      
-    case ROTARY_MODE_COARSE:
-      /* Coarse mode - amplify movement */
-      return direction * 5;  /* Multiply effect by 5 */
-      
-    case ROTARY_MODE_NORMAL:
-    default:
-      /* Normal mode - pass through but stabilize */
-      counter++;
-      if (counter >= 2) {  /* Process every 2nd event to reduce jitter */
-        counter = 0;
-        return direction;
-      }
-      return 0;
+  residualCount += (int16_t)(count - lastCount);
+  lastCount = count;
+  
+  /* Whole detents only; the remainder waits for the next call */
+  detents = residualCount / ROTARY_COUNTS_PER_DETENT;
+  if (detents == 0) {
+    return 0;
+  }
+  residualCount -= detents * ROTARY_COUNTS_PER_DETENT;
+  
+  direction = (detents > 0) ? ROTARY_CW : ROTARY_CCW;
+  magnitude = (detents > 0) ? detents : -detents;
+  elapsed = systemTick - lastDetentTime;
+  lastDetentTime = systemTick;
+  
+  /* Accelerate from the time per detent; a change of direction starts slow */
+  steps = magnitude;
+  if (currentMode != ROTARY_MODE_FINE && direction == lastDirection) {
+    steps *= AccelerationFactor(elapsed / magnitude);
   }
+  if (currentMode == ROTARY_MODE_COARSE) {
+    steps *= ROTARY_COARSE_FACTOR;
+  }
+  if (steps > ROTARY_MAX_STEPS) {
+    steps = ROTARY_MAX_STEPS;
+  }
+  lastDirection = direction;
+  
+  return direction * (int16_t)steps;
 }
 
 /**
-  * @brief  Get the number of events in the queue
-  * @retval Number of events waiting
+  * @brief  Steps per detent for a given turning speed
+  * @param  msPerDetent Time per detent in ms
+  * @retval Multiplier (1 to ROTARY_ACCEL_MAX)
   */
-uint8_t RotaryEncoder_GetQueueCount(void)
+static uint8_t AccelerationFactor(uint32_t msPerDetent)
 {
-  return queueCount;
+  if (msPerDetent >= ROTARY_ACCEL_SLOW_MS) {
+    return 1;
+  }
+  if (msPerDetent <= ROTARY_ACCEL_FAST_MS) {
+    return ROTARY_ACCEL_MAX;
+  }
+  return 1 + ((ROTARY_ACCEL_MAX - 1) * (ROTARY_ACCEL_SLOW_MS - msPerDetent)) /
+             (ROTARY_ACCEL_SLOW_MS - ROTARY_ACCEL_FAST_MS);
 }
 
 /************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
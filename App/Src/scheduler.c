@@ -0,0 +1,208 @@
+ /**
+  ******************************************************************************
+  * @file           : scheduler.c
+  * @brief          : Cooperative task scheduler with deadline accounting
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The main loop work is a fixed table of tasks in priority order. A task
+  * becomes ready when one of its events is taken from the event loop, and
+  * stays ready until its function returns SCHEDULER_DONE. Each call runs the
+  * highest priority ready task once and then looks at the events again, so
+  * a long job (a preset save) that returns SCHEDULER_YIELD after each chunk
+  * lets a new audio block in between chunks. Nothing is preempted: the
+  * worst case wait of a task is the longest single call of any other.
+  *
+  * Every call is timed on the cycle counter. The response of a job is the
+  * time from the post of the event that made the task ready to its last
+  * call, so the wait behind a long call of another task counts; a job slower
+  * than the task deadline is counted as a miss. An event that arrives while
+  * a task is still ready joins the job in progress.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scheduler.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const SchedulerTask_t *taskTable = NULL;
+static uint8_t taskCount = 0;
+static uint32_t triggerEvents = 0;      /* Events of all tasks */
+
+static uint32_t readyTasks = 0;         /* Bit per task */
+static uint32_t readySince[SCHEDULER_MAX_TASKS];
+static SchedulerTaskStats_t taskStats[SCHEDULER_MAX_TASKS];
+
+/* Private function prototypes -----------------------------------------------*/
+static void RunTask(uint8_t index);
+static uint32_t FirstPostTime(uint32_t events, uint32_t now);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Set the task table and clear the statistics
+  * @param  tasks Task table, highest priority first
+  * @param  count Number of tasks
+  * @retval None
+  */
+void Scheduler_Init(const SchedulerTask_t *tasks, uint8_t count)
+{
+  uint8_t i;
+
+  taskTable = tasks;
+  taskCount = MIN(count, SCHEDULER_MAX_TASKS);
+
+  triggerEvents = 0;
+  for (i = 0; i < taskCount; i++) {
+    triggerEvents |= taskTable[i].events;
+  }
+
+  readyTasks = 0;
+  memset(taskStats, 0, sizeof(taskStats));
+}
+
+/**
+  * @brief  Run the highest priority ready task once, or sleep if none is ready
+  * @retval None
+  */
+void Scheduler_RunNext(void)
+{
+  uint32_t events = EventLoop_Take(triggerEvents);
+  uint32_t now = SCHEDULER_CYCLES();
+  uint8_t i;
+
+  for (i = 0; i < taskCount; i++) {
+    if ((events & taskTable[i].events) && !(readyTasks & (1U << i))) {
+      readyTasks |= 1U << i;
+      readySince[i] = FirstPostTime(events & taskTable[i].events, now);
+    }
+  }
+
+  if (readyTasks == 0) {
+    EventLoop_Sleep();
+    return;
+  }
+
+  for (i = 0; !(readyTasks & (1U << i)); i++) {
+  }
+  RunTask(i);
+}
+
+/**
+  * @brief  Get the number of tasks
+  * @retval Task count
+  */
+uint8_t Scheduler_GetTaskCount(void)
+{
+  return taskCount;
+}
+
+/**
+  * @brief  Get a task name
+  * @param  index Task index (priority order)
+  * @retval Name, or NULL if there is no such task
+  */
+const char* Scheduler_GetTaskName(uint8_t index)
+{
+  if (index >= taskCount) {
+    return NULL;
+  }
+  return taskTable[index].name;
+}
+
+/**
+  * @brief  Get the statistics of a task
+  * @param  index Task index (priority order)
+  * @param  stats Pointer to structure to fill
+  * @retval 1 if filled, 0 if there is no such task
+  */
+uint8_t Scheduler_GetTaskStats(uint8_t index, SchedulerTaskStats_t *stats)
+{
+  if (index >= taskCount) {
+    return 0;
+  }
+  memcpy(stats, &taskStats[index], sizeof(SchedulerTaskStats_t));
+  return 1;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Call a task once and account for it
+  * @param  index Task index
+  * @retval None
+  */
+static void RunTask(uint8_t index)
+{
+  const SchedulerTask_t *task = &taskTable[index];
+  SchedulerTaskStats_t *stats = &taskStats[index];
+  uint32_t cyclesPerUs = SCHEDULER_CYCLES_PER_US;
+  uint32_t start = SCHEDULER_CYCLES();
+  uint8_t result = task->run();
+  uint32_t end = SCHEDULER_CYCLES();
+  uint32_t runUs = (end - start) / cyclesPerUs;
+  uint32_t responseUs;
+
+  stats->runs++;
+  stats->lastRunUs = runUs;
+  stats->totalRunUs += runUs;
+  if (runUs > stats->worstRunUs) {
+    stats->worstRunUs = runUs;
+  }
+
+  if (result == SCHEDULER_YIELD) {
+    stats->yields++;
+    return;
+  }
+
+  /* Job done: the task waits for its next event */
+  readyTasks &= ~(1U << index);
+
+  responseUs = (end - readySince[index]) / cyclesPerUs;
+  stats->lastResponseUs = responseUs;
+  if (responseUs > stats->worstResponseUs) {
+    stats->worstResponseUs = responseUs;
+  }
+  if (task->deadlineUs != 0 && responseUs > task->deadlineUs) {
+    stats->deadlineMisses++;
+  }
+}
+
+/**
+  * @brief  Time of the earliest post among taken events
+  * @param  events Taken EVENT_* flags (not 0)
+  * @param  now Current cycle count
+  * @retval Cycle count
+  */
+static uint32_t FirstPostTime(uint32_t events, uint32_t now)
+{
+  uint32_t first = now;
+  uint32_t event;
+
+  for (event = 1; event != 0 && event <= events; event <<= 1) {
+    if (events & event) {
+      uint32_t posted = EventLoop_PostTime(event);
+      if (now - posted > now - first) {
+        first = posted;
+      }
+    }
+  }
+  return first;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
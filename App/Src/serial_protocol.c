@@ -0,0 +1,854 @@
+ /**
+  ******************************************************************************
+  * @file           : serial_protocol.c
+  * @brief          : Framed binary protocol on USART1
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Reception runs continuously into a circular DMA buffer. The main loop
+  * drains it in SerialProtocol_Task(), which follows the DMA write position,
+  * so no interrupt is taken per byte or per frame. A complete frame is held
+  * until the previous response has left the TX DMA, which also throttles a
+  * host that does not wait for answers.
+  *
+  * Requests are handled in the main loop between audio blocks, so live
+  * parameters are written straight into the settings used by the chain;
+  * the affected module is recomputed by the next control update
+  * (param_update.c), however many writes arrive before it.
+  * Preset writes and deletes are queued to the background writer of the
+  * preset manager; nothing here waits on flash. A delete is answered BUSY
+  * until its tombstone is written, and its result goes to the repeated
+  * request.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "serial_protocol.h"
+#include <stddef.h>
+#include <string.h>
+#include "crc32.h"
+#include "audio_processing.h"
+#include "param_update.h"
+#include "delay.h"
+#include "preset_morph.h"
+#include "preset_manager.h"
+#include "telemetry.h"
+#include "lcd_driver.h"
+#include "ui_probe.h"
+#include "scheduler.h"
+#include "dsp_watchdog.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Live parameter exposed to the host
+  */
+typedef struct {
+    const char* name;
+    uint16_t offset;     /* Field offset in SystemSettings_t */
+    uint16_t dirty;      /* PARAM_DIRTY_* flags to mark after a write */
+    uint8_t type;        /* SERIAL_PARAM_FLOAT or SERIAL_PARAM_BOOL */
+    float min;
+    float max;
+} SerialParam_t;
+
+/* Private define ------------------------------------------------------------*/
+/* Preset list entries per response (ID and 16-byte name each) */
+#define SERIAL_LIST_ENTRIES        8
+#define SERIAL_LIST_NAME_SIZE      16
+
+/* Private macro -------------------------------------------------------------*/
+#define PARAM_FLOAT(name, field, dirty, min, max) \
+    { name, offsetof(SystemSettings_t, field), dirty, SERIAL_PARAM_FLOAT, min, max }
+#define PARAM_BOOL(name, field, dirty) \
+    { name, offsetof(SystemSettings_t, field), dirty, SERIAL_PARAM_BOOL, 0.0f, 1.0f }
+
+#define PARAM_COMPRESSOR_BAND(band)                                                           \
+    PARAM_FLOAT("comp." #band ".threshold", compressor.band.threshold,                       \
+                PARAM_DIRTY_COMPRESSOR, -60.0f, 0.0f),                                       \
+    PARAM_FLOAT("comp." #band ".ratio", compressor.band.ratio,                               \
+                PARAM_DIRTY_COMPRESSOR, 1.0f, 20.0f),                                        \
+    PARAM_FLOAT("comp." #band ".attack", compressor.band.attack,                             \
+                PARAM_DIRTY_COMPRESSOR, 0.1f, 100.0f),                                       \
+    PARAM_FLOAT("comp." #band ".release", compressor.band.release,                           \
+                PARAM_DIRTY_COMPRESSOR, 10.0f, 1000.0f),                                     \
+    PARAM_FLOAT("comp." #band ".makeup", compressor.band.makeupGain,                         \
+                PARAM_DIRTY_COMPRESSOR, 0.0f, 20.0f),                                        \
+    PARAM_BOOL("comp." #band ".enabled", compressor.band.enabled, PARAM_DIRTY_COMPRESSOR)
+
+#define PARAM_LIMITER_BAND(band)                                                              \
+    PARAM_FLOAT("lim." #band ".threshold", limiter.band.threshold,                           \
+                PARAM_DIRTY_LIMITER, -20.0f, 0.0f),                                          \
+    PARAM_FLOAT("lim." #band ".release", limiter.band.release,                               \
+                PARAM_DIRTY_LIMITER, 10.0f, 1000.0f),                                        \
+    PARAM_BOOL("lim." #band ".enabled", limiter.band.enabled, PARAM_DIRTY_LIMITER)
+
+/* Private variables ---------------------------------------------------------*/
+/* USART1 DMA handles, linked to huart1 in HAL_UART_MspInit() */
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
+
+/* Parameter IDs are indices into this table; append only */
+static const SerialParam_t paramTable[] = {
+    PARAM_FLOAT("xo.lowCutoff", crossover.lowCutoff, PARAM_DIRTY_CUTOFF_LOW, 20.0f, 20000.0f),
+    PARAM_FLOAT("xo.midCutoff", crossover.midCutoff, PARAM_DIRTY_CUTOFF_MID, 20.0f, 20000.0f),
+    PARAM_FLOAT("xo.highCutoff", crossover.highCutoff, PARAM_DIRTY_CUTOFF_HIGH, 20.0f, 20000.0f),
+    PARAM_FLOAT("xo.subGain", crossover.subGain, PARAM_DIRTY_BAND_LEVELS, -24.0f, 12.0f),
+    PARAM_FLOAT("xo.lowGain", crossover.lowGain, PARAM_DIRTY_BAND_LEVELS, -24.0f, 12.0f),
+    PARAM_FLOAT("xo.midGain", crossover.midGain, PARAM_DIRTY_BAND_LEVELS, -24.0f, 12.0f),
+    PARAM_FLOAT("xo.highGain", crossover.highGain, PARAM_DIRTY_BAND_LEVELS, -24.0f, 12.0f),
+    PARAM_BOOL("xo.subMute", crossover.subMute, PARAM_DIRTY_BAND_LEVELS),
+    PARAM_BOOL("xo.lowMute", crossover.lowMute, PARAM_DIRTY_BAND_LEVELS),
+    PARAM_BOOL("xo.midMute", crossover.midMute, PARAM_DIRTY_BAND_LEVELS),
+    PARAM_BOOL("xo.highMute", crossover.highMute, PARAM_DIRTY_BAND_LEVELS),
+    PARAM_COMPRESSOR_BAND(sub),
+    PARAM_COMPRESSOR_BAND(low),
+    PARAM_COMPRESSOR_BAND(mid),
+    PARAM_COMPRESSOR_BAND(high),
+    PARAM_LIMITER_BAND(sub),
+    PARAM_LIMITER_BAND(low),
+    PARAM_LIMITER_BAND(mid),
+    PARAM_LIMITER_BAND(high),
+    PARAM_FLOAT("delay.sub", delay.subDelay, PARAM_DIRTY_DELAY, 0.0f, MAX_DELAY_MS),
+    PARAM_FLOAT("delay.low", delay.lowDelay, PARAM_DIRTY_DELAY, 0.0f, MAX_DELAY_MS),
+    PARAM_FLOAT("delay.mid", delay.midDelay, PARAM_DIRTY_DELAY, 0.0f, MAX_DELAY_MS),
+    PARAM_FLOAT("delay.high", delay.highDelay, PARAM_DIRTY_DELAY, 0.0f, MAX_DELAY_MS),
+    PARAM_BOOL("delay.subInvert", delay.subPhaseInvert, PARAM_DIRTY_DELAY),
+    PARAM_BOOL("delay.lowInvert", delay.lowPhaseInvert, PARAM_DIRTY_DELAY),
+    PARAM_BOOL("delay.midInvert", delay.midPhaseInvert, PARAM_DIRTY_DELAY),
+    PARAM_BOOL("delay.highInvert", delay.highPhaseInvert, PARAM_DIRTY_DELAY),
+};
+
+#define PARAM_COUNT (sizeof(paramTable) / sizeof(paramTable[0]))
+
+static SystemSettings_t *settings = NULL;
+static SerialProtocolStats_t protocolStats;
+
+/* Reception: DMA writes rxBuffer, the task reads it from rxTail */
+static uint8_t rxBuffer[SERIAL_RX_BUFFER_SIZE];
+static uint16_t rxTail = 0;
+static uint32_t rxLastByteTick = 0;
+
+/* Frame being assembled; complete and checked when frameReady is set */
+static uint8_t rxFrame[SERIAL_MAX_FRAME];
+static uint16_t rxCount = 0;
+static uint16_t rxExpected = SERIAL_HEADER_SIZE;
+static uint8_t frameReady = 0;
+
+/* Response being sent by DMA */
+static uint8_t txFrame[SERIAL_MAX_FRAME];
+
+/* Delete queued by PRESET_DELETE; the result is kept for the repeat */
+static uint8_t deleteId = PRESET_ID_INVALID;
+static uint8_t deletePending = 0;
+static uint8_t deleteStatus = PRESET_STATUS_OK;
+
+/* Private function prototypes -----------------------------------------------*/
+static void StartReception(void);
+static void ParseByte(uint8_t byte);
+static void ResetParser(void);
+static void HandleFrame(void);
+static uint16_t HandleRequest(uint8_t type, const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandlePing(uint8_t* response);
+static uint16_t HandleGetStats(uint8_t* response);
+static uint16_t HandleTaskStats(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandleTestLoad(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandleParamGet(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandleParamSet(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandlePresetList(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandlePresetRead(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandlePresetWrite(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandlePresetDelete(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandleTelemetryRate(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandleUiInput(const uint8_t* request, uint16_t length, uint8_t* response);
+static uint16_t HandleUiScreen(uint8_t* response);
+static float GetParamValue(const SerialParam_t* param);
+static void DeleteDone(uint8_t presetId, uint8_t status);
+static uint8_t MapPresetStatus(uint8_t status);
+static void PutU16(uint8_t* buffer, uint16_t value);
+static void PutU32(uint8_t* buffer, uint32_t value);
+static void PutFloat(uint8_t* buffer, float value);
+static uint32_t GetU32(const uint8_t* buffer);
+
+/**
+  * @brief  Initialize the protocol and start DMA reception on USART1
+  * @param  pSettings Settings used by the processing chain (live parameters)
+  * @retval None
+  */
+void SerialProtocol_Init(SystemSettings_t *pSettings)
+{
+  settings = pSettings;
+  memset(&protocolStats, 0, sizeof(protocolStats));
+  deleteId = PRESET_ID_INVALID;
+  deletePending = 0;
+
+  StartReception();
+
+  #ifdef DEBUG
+  printf("Serial protocol v%d on USART1 (%u parameters)\r\n",
+         SERIAL_PROTOCOL_VERSION, (unsigned int)PARAM_COUNT);
+  #endif
+}
+
+/**
+  * @brief  Parse received bytes and answer at most one request
+  * @retval None
+  */
+void SerialProtocol_Task(void)
+{
+  if (settings == NULL) {
+    return;
+  }
+
+  /* A UART error (e.g. overrun) stops DMA reception; start it again */
+  if (huart1.RxState == HAL_UART_STATE_READY) {
+    protocolStats.rxRestarts++;
+    StartReception();
+  }
+
+  /* Consume what the DMA has written since the last call */
+  uint16_t head = SERIAL_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart1.hdmarx);
+  if (head >= SERIAL_RX_BUFFER_SIZE) {
+    head = 0;
+  }
+
+  if (rxTail != head) {
+    rxLastByteTick = HAL_GetTick();
+  } else if (rxCount > 0 && !frameReady &&
+             HAL_GetTick() - rxLastByteTick > SERIAL_FRAME_TIMEOUT_MS) {
+    /* The rest of the frame is not coming; look for the next one */
+    protocolStats.framingErrors++;
+    ResetParser();
+  }
+
+  while (!frameReady && rxTail != head) {
+    ParseByte(rxBuffer[rxTail]);
+    rxTail = (rxTail + 1) % SERIAL_RX_BUFFER_SIZE;
+  }
+
+  /* Answer once the previous frame has gone out */
+  if (frameReady && huart1.gState == HAL_UART_STATE_READY) {
+    HandleFrame();
+    ResetParser();
+  }
+}
+
+/**
+  * @brief  Get protocol link statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void SerialProtocol_GetStats(SerialProtocolStats_t *stats)
+{
+  if (stats != NULL) {
+    memcpy(stats, &protocolStats, sizeof(SerialProtocolStats_t));
+  }
+}
+
+/**
+  * @brief  Send a frame that was not requested by the host
+  * @param  type     Message type
+  * @param  sequence Sequence number
+  * @param  frame    Frame buffer with the payload in place
+  * @param  length   Payload length
+  * @retval SERIAL_STATUS_OK if sent, SERIAL_STATUS_BUSY if the UART is busy
+  */
+uint8_t SerialProtocol_SendFrame(uint8_t type, uint8_t sequence, uint8_t *frame, uint16_t length)
+{
+  if (huart1.gState != HAL_UART_STATE_READY) {
+    return SERIAL_STATUS_BUSY;
+  }
+
+  frame[0] = SERIAL_FRAME_SOF;
+  PutU16(&frame[1], length);
+  frame[3] = type;
+  frame[4] = sequence;
+  PutU32(&frame[SERIAL_HEADER_SIZE + length], Crc32_Compute(&frame[1], length + 4));
+
+  if (HAL_UART_Transmit_DMA(&huart1, frame,
+                            SERIAL_HEADER_SIZE + length + SERIAL_CRC_SIZE) != HAL_OK) {
+    return SERIAL_STATUS_BUSY;
+  }
+
+  protocolStats.framesSent++;
+  return SERIAL_STATUS_OK;
+}
+
+/**
+  * @brief  Start circular DMA reception from the beginning of the buffer
+  * @retval None
+  */
+static void StartReception(void)
+{
+  rxTail = 0;
+  ResetParser();
+
+  HAL_UART_Receive_DMA(&huart1, rxBuffer, SERIAL_RX_BUFFER_SIZE);
+}
+
+/**
+  * @brief  Add one received byte to the frame being assembled
+  * @param  byte Received byte
+  * @retval None
+  */
+static void ParseByte(uint8_t byte)
+{
+  /* Skip anything before a start of frame */
+  if (rxCount == 0 && byte != SERIAL_FRAME_SOF) {
+    protocolStats.framingErrors++;
+    return;
+  }
+
+  rxFrame[rxCount++] = byte;
+  if (rxCount < rxExpected) {
+    return;
+  }
+
+  /* Header complete: the length gives the rest of the frame */
+  if (rxCount == SERIAL_HEADER_SIZE) {
+    uint16_t length = rxFrame[1] | ((uint16_t)rxFrame[2] << 8);
+    if (length > SERIAL_MAX_PAYLOAD) {
+      protocolStats.framingErrors++;
+      ResetParser();
+      return;
+    }
+    rxExpected = SERIAL_HEADER_SIZE + length + SERIAL_CRC_SIZE;
+    return;
+  }
+
+  /* Frame complete: check the CRC */
+  uint16_t covered = rxCount - 1 - SERIAL_CRC_SIZE;
+  if (Crc32_Compute(&rxFrame[1], covered) != GetU32(&rxFrame[1 + covered])) {
+    protocolStats.crcErrors++;
+    ResetParser();
+    return;
+  }
+
+  protocolStats.framesReceived++;
+  frameReady = 1;
+}
+
+/**
+  * @brief  Drop the frame being assembled and wait for a start of frame
+  * @retval None
+  */
+static void ResetParser(void)
+{
+  rxCount = 0;
+  rxExpected = SERIAL_HEADER_SIZE;
+  frameReady = 0;
+}
+
+/**
+  * @brief  Answer the received frame and start sending the response
+  * @retval None
+  */
+static void HandleFrame(void)
+{
+  uint16_t requestLength = rxFrame[1] | ((uint16_t)rxFrame[2] << 8);
+  uint8_t type = rxFrame[3];
+  uint8_t sequence = rxFrame[4];
+
+  uint16_t length = HandleRequest(type, &rxFrame[SERIAL_HEADER_SIZE], requestLength,
+                                  &txFrame[SERIAL_HEADER_SIZE]);
+
+  SerialProtocol_SendFrame(type | SERIAL_MSG_RESPONSE, sequence, txFrame, length);
+}
+
+/**
+  * @brief  Handle a request
+  * @param  type     Message type
+  * @param  request  Request payload
+  * @param  length   Request payload length
+  * @param  response Response payload to fill (SERIAL_MAX_PAYLOAD bytes)
+  * @retval Response payload length
+  */
+static uint16_t HandleRequest(uint8_t type, const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  switch (type) {
+    case SERIAL_MSG_PING:
+      return HandlePing(response);
+
+    case SERIAL_MSG_GET_STATS:
+      return HandleGetStats(response);
+
+    case SERIAL_MSG_TASK_STATS:
+      return HandleTaskStats(request, length, response);
+
+    case SERIAL_MSG_TEST_LOAD:
+      return HandleTestLoad(request, length, response);
+
+    case SERIAL_MSG_PARAM_GET:
+      return HandleParamGet(request, length, response);
+
+    case SERIAL_MSG_PARAM_SET:
+      return HandleParamSet(request, length, response);
+
+    case SERIAL_MSG_PRESET_LIST:
+      return HandlePresetList(request, length, response);
+
+    case SERIAL_MSG_PRESET_READ:
+      return HandlePresetRead(request, length, response);
+
+    case SERIAL_MSG_PRESET_WRITE:
+      return HandlePresetWrite(request, length, response);
+
+    case SERIAL_MSG_PRESET_DELETE:
+      return HandlePresetDelete(request, length, response);
+
+    case SERIAL_MSG_TELEMETRY_RATE:
+      return HandleTelemetryRate(request, length, response);
+
+    case SERIAL_MSG_UI_INPUT:
+      return HandleUiInput(request, length, response);
+
+    case SERIAL_MSG_UI_SCREEN:
+      return HandleUiScreen(response);
+
+    default:
+      response[0] = SERIAL_STATUS_UNKNOWN;
+      return 1;
+  }
+}
+
+/**
+  * @brief  PING: protocol version and limits
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandlePing(uint8_t* response)
+{
+  response[0] = SERIAL_STATUS_OK;
+  response[1] = SERIAL_PROTOCOL_VERSION;
+  PutU16(&response[2], SERIAL_MAX_PAYLOAD);
+  response[4] = USER_PRESET_START_ID;
+  response[5] = TOTAL_PRESET_COUNT;
+  response[6] = (uint8_t)PARAM_COUNT;
+  return 7;
+}
+
+/**
+  * @brief  GET_STATS: processing statistics
+  * @note   The structure holds only 32-bit fields and the core is
+  *         little-endian, so it is sent as it is
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleGetStats(uint8_t* response)
+{
+  AudioProcessingStats_t stats;
+  AudioProcessing_GetStats(&stats);
+
+  response[0] = SERIAL_STATUS_OK;
+  memcpy(&response[1], &stats, sizeof(stats));
+  return 1 + sizeof(stats);
+}
+
+/**
+  * @brief  TASK_STATS: runtime and deadline statistics of a main loop task
+  * @param  request  Request payload (task index, priority order)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleTaskStats(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  SchedulerTaskStats_t stats;
+
+  if (length != 1) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+  if (!Scheduler_GetTaskStats(request[0], &stats)) {
+    response[0] = SERIAL_STATUS_INVALID;
+    return 1;
+  }
+
+  const char* name = Scheduler_GetTaskName(request[0]);
+  uint16_t nameLength = strlen(name) + 1;
+
+  response[0] = SERIAL_STATUS_OK;
+  response[1] = request[0];
+  response[2] = Scheduler_GetTaskCount();
+  memcpy(&response[3], &stats, sizeof(stats));
+  memcpy(&response[3 + sizeof(stats)], name, nameLength);
+  return 3 + sizeof(stats) + nameLength;
+}
+
+/**
+  * @brief  TEST_LOAD: add busy time to every audio block
+  * @note   Exercises the DSP deadline monitor; GET_STATS shows the overruns
+  *         and the quality level it chose
+  * @param  request  Request payload (load in us, 0 to stop)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleTestLoad(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 4) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+
+  uint32_t loadUs = DspWatchdog_SetTestLoad(GetU32(request));
+
+  response[0] = SERIAL_STATUS_OK;
+  PutU32(&response[1], loadUs);
+  return 5;
+}
+
+/**
+  * @brief  PARAM_GET: value, range and name of a live parameter
+  * @param  request  Request payload (parameter ID)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleParamGet(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 1) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+  if (request[0] >= PARAM_COUNT) {
+    response[0] = SERIAL_STATUS_INVALID;
+    return 1;
+  }
+
+  const SerialParam_t* param = &paramTable[request[0]];
+  uint16_t nameLength = strlen(param->name) + 1;
+
+  response[0] = SERIAL_STATUS_OK;
+  response[1] = request[0];
+  response[2] = param->type;
+  PutFloat(&response[3], GetParamValue(param));
+  PutFloat(&response[7], param->min);
+  PutFloat(&response[11], param->max);
+  memcpy(&response[15], param->name, nameLength);
+  return 15 + nameLength;
+}
+
+/**
+  * @brief  PARAM_SET: change a live parameter
+  * @note   Values are clamped to the parameter range. Refused while a preset
+  *         morph is running, since the morph would overwrite the change.
+  * @param  request  Request payload (parameter ID, value)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleParamSet(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 5) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+  if (request[0] >= PARAM_COUNT) {
+    response[0] = SERIAL_STATUS_INVALID;
+    return 1;
+  }
+  if (PresetMorph_IsActive() || AudioProcessing_IsCrossfading()) {
+    response[0] = SERIAL_STATUS_BUSY;
+    return 1;
+  }
+
+  const SerialParam_t* param = &paramTable[request[0]];
+  uint8_t* field = (uint8_t*)settings + param->offset;
+  float value;
+  memcpy(&value, &request[1], sizeof(value));
+
+  /* NaN fails both comparisons; treat it as out of range */
+  if (!(value >= param->min && value <= param->max)) {
+    value = (value > param->max) ? param->max : param->min;
+  }
+
+  if (param->type == SERIAL_PARAM_BOOL) {
+    *field = (value >= 0.5f) ? 1 : 0;
+  } else {
+    memcpy(field, &value, sizeof(value));
+  }
+
+  /* The module picks the value up at the next control update */
+  ParamUpdate_Mark(param->dirty);
+
+  response[0] = SERIAL_STATUS_OK;
+  response[1] = request[0];
+  PutFloat(&response[2], GetParamValue(param));
+  return 6;
+}
+
+/**
+  * @brief  PRESET_LIST: IDs and names of the presets from a given ID on
+  * @note   Bounded to SERIAL_LIST_ENTRIES presets per request; the response
+  *         gives the ID to continue from (PRESET_ID_INVALID when done)
+  * @param  request  Request payload (first preset ID)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandlePresetList(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 1) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+
+  uint8_t presetId = request[0];
+  uint8_t count = 0;
+  uint16_t position = 3;
+
+  while (presetId < TOTAL_PRESET_COUNT && count < SERIAL_LIST_ENTRIES) {
+    PresetMetadata_t metadata;
+    if (PresetManager_GetPresetInfo(presetId, &metadata) == PRESET_STATUS_OK) {
+      response[position] = presetId;
+      memset(&response[position + 1], 0, SERIAL_LIST_NAME_SIZE);
+      strncpy((char*)&response[position + 1], metadata.name, SERIAL_LIST_NAME_SIZE - 1);
+      position += 1 + SERIAL_LIST_NAME_SIZE;
+      count++;
+    }
+    presetId++;
+  }
+
+  response[0] = SERIAL_STATUS_OK;
+  response[1] = (presetId < TOTAL_PRESET_COUNT) ? presetId : PRESET_ID_INVALID;
+  response[2] = count;
+  return position;
+}
+
+/**
+  * @brief  PRESET_READ: a preset as an encoded record (preset_codec format)
+  * @param  request  Request payload (preset ID)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandlePresetRead(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 1) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+
+  uint16_t recordLength = 0;
+  uint8_t status = PresetManager_ExportPreset(request[0], &response[2],
+                                              SERIAL_MAX_PAYLOAD - 2, &recordLength);
+
+  response[0] = MapPresetStatus(status);
+  response[1] = request[0];
+  return (status == PRESET_STATUS_OK) ? 2 + recordLength : 2;
+}
+
+/**
+  * @brief  PRESET_WRITE: store an encoded record as a user preset
+  * @note   Answered as soon as the record is queued; a storage failure
+  *         after that shows up when the preset is read back
+  * @param  request  Request payload (preset ID, encoded record)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandlePresetWrite(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length < 2) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+
+  uint8_t status = PresetManager_ImportPresetAsync(request[0], &request[1], length - 1, NULL);
+
+  /* A delete result kept for this preset no longer holds */
+  if (status == PRESET_STATUS_OK && !deletePending && deleteId == request[0]) {
+    deleteId = PRESET_ID_INVALID;
+  }
+
+  response[0] = MapPresetStatus(status);
+  response[1] = request[0];
+  return 2;
+}
+
+/**
+  * @brief  PRESET_DELETE: remove a user preset
+  * @note   The first request queues the tombstone behind any pending saves
+  *         and is answered BUSY, as is every request until it is written.
+  *         The request repeated after that gets the result.
+  * @param  request  Request payload (preset ID)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandlePresetDelete(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 1) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+
+  /* A queued delete replaced by a later save of the preset never completes */
+  if (deletePending && !PresetManager_IsBusy()) {
+    deletePending = 0;
+    deleteStatus = PRESET_STATUS_ERROR;
+  }
+
+  if (deletePending) {
+    response[0] = SERIAL_STATUS_BUSY;
+  } else if (deleteId == request[0]) {
+    response[0] = MapPresetStatus(deleteStatus);
+    deleteId = PRESET_ID_INVALID;
+  } else {
+    uint8_t status = PresetManager_DeletePresetAsync(request[0], DeleteDone);
+    if (status == PRESET_STATUS_OK) {
+      deleteId = request[0];
+      deletePending = 1;
+      status = PRESET_STATUS_BUSY;
+    }
+    response[0] = MapPresetStatus(status);
+  }
+  response[1] = request[0];
+  return 2;
+}
+
+/**
+  * @brief  Keep the result of a queued delete for the repeated request
+  * @param  presetId ID of the deleted preset
+  * @param  status   PRESET_STATUS_OK or error code
+  * @retval None
+  */
+static void DeleteDone(uint8_t presetId, uint8_t status)
+{
+  deleteStatus = status;
+  deletePending = 0;
+}
+
+/**
+  * @brief  TELEMETRY_RATE: start, stop or change the telemetry stream
+  * @param  request  Request payload (rate in Hz, 0 to stop)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleTelemetryRate(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 2) {
+    response[0] = SERIAL_STATUS_LENGTH;
+    return 1;
+  }
+
+  uint16_t rateHz = Telemetry_SetRate(request[0] | ((uint16_t)request[1] << 8));
+
+  response[0] = SERIAL_STATUS_OK;
+  PutU16(&response[1], rateHz);
+  return 3;
+}
+
+/**
+  * @brief  UI_INPUT: queue a front panel event
+  * @param  request  Request payload (source, code, state, value)
+  * @param  length   Request payload length
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleUiInput(const uint8_t* request, uint16_t length, uint8_t* response)
+{
+  if (length != 7) {
+    response[0] = SERIAL_STATUS_LENGTH;
+  } else if (request[0] >= INPUT_SOURCE_COUNT) {
+    response[0] = SERIAL_STATUS_INVALID;
+  } else if (!UiProbe_Inject(request[0], request[1], request[2], (int32_t)GetU32(&request[3]))) {
+    response[0] = SERIAL_STATUS_BUSY;
+  } else {
+    response[0] = SERIAL_STATUS_OK;
+  }
+  return 1;
+}
+
+/**
+  * @brief  UI_SCREEN: characters on the display and response statistics
+  * @note   The statistics hold only 32-bit fields and are sent as they are
+  * @param  response Response payload
+  * @retval Response payload length
+  */
+static uint16_t HandleUiScreen(uint8_t* response)
+{
+  UiProbeStats_t stats;
+  UiProbe_GetStats(&stats);
+
+  response[0] = SERIAL_STATUS_OK;
+  LCD_GetScreen(&response[1]);
+  memcpy(&response[1 + LCD_SCREEN_SIZE], &stats, sizeof(stats));
+  return 1 + LCD_SCREEN_SIZE + sizeof(stats);
+}
+
+/**
+  * @brief  Read a live parameter as a float
+  * @param  param Parameter
+  * @retval Current value
+  */
+static float GetParamValue(const SerialParam_t* param)
+{
+  const uint8_t* field = (const uint8_t*)settings + param->offset;
+
+  if (param->type == SERIAL_PARAM_BOOL) {
+    return (float)*field;
+  }
+
+  float value;
+  memcpy(&value, field, sizeof(value));
+  return value;
+}
+
+/**
+  * @brief  Translate a preset manager status into a protocol status
+  * @param  status PRESET_STATUS code
+  * @retval SERIAL_STATUS code
+  */
+static uint8_t MapPresetStatus(uint8_t status)
+{
+  switch (status) {
+    case PRESET_STATUS_OK:      return SERIAL_STATUS_OK;
+    case PRESET_STATUS_EMPTY:   return SERIAL_STATUS_EMPTY;
+    case PRESET_STATUS_INVALID: return SERIAL_STATUS_INVALID;
+    case PRESET_STATUS_BUSY:    return SERIAL_STATUS_BUSY;
+    default:                    return SERIAL_STATUS_ERROR;
+  }
+}
+
+/* Little-endian field access (floats as their IEEE 754 bit pattern) */
+static void PutU16(uint8_t* buffer, uint16_t value)
+{
+  buffer[0] = (uint8_t)value;
+  buffer[1] = (uint8_t)(value >> 8);
+}
+
+static void PutU32(uint8_t* buffer, uint32_t value)
+{
+  buffer[0] = (uint8_t)value;
+  buffer[1] = (uint8_t)(value >> 8);
+  buffer[2] = (uint8_t)(value >> 16);
+  buffer[3] = (uint8_t)(value >> 24);
+}
+
+static void PutFloat(uint8_t* buffer, float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  PutU32(buffer, bits);
+}
+
+static uint32_t GetU32(const uint8_t* buffer)
+{
+  return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+         ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
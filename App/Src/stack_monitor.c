@@ -0,0 +1,212 @@
+ /**
+  ******************************************************************************
+  * @file           : stack_monitor.c
+  * @brief          : Runtime stack watermark using stack painting
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The main loop and all interrupt callbacks share the MSP stack. The unused
+  * part of the stack is painted once at boot; the watermark is the lowest
+  * address whose paint has been overwritten. The watermark only moves down,
+  * so every time it moves the new depth is credited to the context that was
+  * running: the main loop (checked at each checkpoint and on ISR entry) or
+  * the outermost interrupt callback (checked on ISR exit, relative to the
+  * stack pointer at entry).
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stack_monitor.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Symbols provided by the linker script */
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+static uint32_t *stackTop = NULL;
+static uint32_t *stackLimit = NULL;
+static uint32_t *volatile watermark = NULL;
+
+static volatile uint32_t mainPeak = 0;
+static volatile uint32_t isrPeak = 0;
+static volatile uint32_t isrEntrySP = 0;
+static volatile uint8_t isrNesting = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t UpdateWatermark(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Paint the unused part of the stack and reset the watermarks
+  * @retval None
+  */
+void StackMonitor_Init(void)
+{
+  stackTop = &_estack;
+  stackLimit = (uint32_t *)((uint32_t)&_estack - (uint32_t)&_Min_Stack_Size);
+
+  /* Paint everything below the current frame, leaving a small margin */
+  uint32_t *paintEnd = (uint32_t *)__get_MSP() - STACK_PAINT_MARGIN_WORDS;
+  for (uint32_t *p = stackLimit; p < paintEnd; p++) {
+    *p = STACK_PAINT_PATTERN;
+  }
+
+  watermark = paintEnd;
+  mainPeak = (uint32_t)stackTop - (uint32_t)paintEnd;
+  isrPeak = 0;
+  isrEntrySP = 0;
+  isrNesting = 0;
+}
+
+/**
+  * @brief  Mark entry into an interrupt callback
+  * @retval None
+  */
+void StackMonitor_EnterISR(void)
+{
+  if (watermark == NULL) {
+    return;
+  }
+
+  if (isrNesting++ == 0) {
+    /* Anything the interrupted main loop touched belongs to the main loop */
+    if (UpdateWatermark()) {
+      mainPeak = (uint32_t)stackTop - (uint32_t)watermark;
+    }
+    isrEntrySP = __get_MSP();
+  }
+}
+
+/**
+  * @brief  Mark exit from an interrupt callback and update the ISR watermark
+  * @retval None
+  */
+void StackMonitor_ExitISR(void)
+{
+  if (watermark == NULL || isrNesting == 0) {
+    return;
+  }
+
+  if (--isrNesting == 0) {
+    if (UpdateWatermark() && isrEntrySP > (uint32_t)watermark) {
+      uint32_t depth = isrEntrySP - (uint32_t)watermark;
+      if (depth > isrPeak) {
+        isrPeak = depth;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Update the main loop watermark (call once per main loop iteration)
+  * @retval None
+  */
+void StackMonitor_Checkpoint(void)
+{
+  if (watermark == NULL) {
+    return;
+  }
+
+  /* Keep interrupts from crediting main loop usage to themselves */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
+  if (UpdateWatermark()) {
+    mainPeak = (uint32_t)stackTop - (uint32_t)watermark;
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Get the stack usage summary
+  * @param  usage Pointer to structure to fill
+  * @retval None
+  */
+void StackMonitor_GetUsage(StackUsage_t* usage)
+{
+  if (usage == NULL) {
+    return;
+  }
+
+  usage->stackSize = (uint32_t)&_Min_Stack_Size;
+
+  if (watermark == NULL) {
+    usage->peakUsage = 0;
+    usage->mainPeak = 0;
+    usage->isrPeak = 0;
+    usage->overflow = 0;
+    return;
+  }
+
+  usage->peakUsage = (uint32_t)stackTop - (uint32_t)watermark;
+  usage->mainPeak = mainPeak;
+  usage->isrPeak = isrPeak;
+  usage->overflow = (watermark <= stackLimit) ? 1 : 0;
+}
+
+/**
+  * @brief  Print the stack usage summary to the debug output
+  * @retval None
+  */
+void StackMonitor_PrintReport(void)
+{
+  #ifdef DEBUG
+  StackUsage_t usage;
+  StackMonitor_GetUsage(&usage);
+
+  printf("Stack: peak %lu/%lu bytes (main %lu, ISR +%lu)%s\r\n",
+         usage.peakUsage, usage.stackSize, usage.mainPeak, usage.isrPeak,
+         usage.overflow ? " OVERFLOW" : "");
+  #endif
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Move the watermark down past any overwritten paint
+  * @note   Normally only a few words are checked since the watermark is
+  *         incremental
+  * @retval 1 if the watermark moved, 0 otherwise
+  */
+static uint8_t UpdateWatermark(void)
+{
+  uint32_t *p = watermark;
+  uint32_t *start = p;
+
+  while (p > stackLimit) {
+    /* Stop when the next few words below are still painted */
+    uint8_t painted = 1;
+    for (uint8_t i = 1; i <= STACK_SCAN_GUARD_WORDS && (p - i) >= stackLimit; i++) {
+      if (*(p - i) != STACK_PAINT_PATTERN) {
+        painted = 0;
+        break;
+      }
+    }
+
+    if (painted) {
+      break;
+    }
+    p--;
+  }
+
+  watermark = p;
+  return (p != start) ? 1 : 0;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
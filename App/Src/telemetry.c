@@ -0,0 +1,397 @@
+ /**
+  ******************************************************************************
+  * @file           : telemetry.c
+  * @brief          : Meter and DSP load streaming over USART1
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The audio path publishes its statistics with Telemetry_Snapshot(), a plain
+  * copy guarded by a sequence counter: the counter is odd while the copy is
+  * being written, and the reader repeats its copy if the counter moved. The
+  * writer never waits, so it may run from an interrupt as well.
+  *
+  * Telemetry_Task() samples the snapshot at the configured rate and packs
+  * the samples into delta coded frames. Two frame buffers are used: one is
+  * filled while the other is being sent by the UART DMA. Meters change
+  * slowly between samples, so most fields take one byte per sample.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "telemetry.h"
+#include <string.h>
+#include "audio_processing.h"
+#include "serial_protocol.h"
+#include "event_loop.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Largest coded sample: a 5-byte varint per field */
+#define TELEMETRY_MAX_SAMPLE_SIZE  (TELEMETRY_FIELD_COUNT * 5)
+
+/* Attempts to read a consistent snapshot before giving up on a sample */
+#define SNAPSHOT_READ_ATTEMPTS     3
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint16_t rateHz = 0;
+static uint16_t intervalMs = 0;
+static TelemetryStats_t telemetryStats;
+
+/* Snapshot written by the audio path */
+static volatile uint32_t snapshotSequence = 0;   /* Odd while being written */
+static AudioProcessingStats_t snapshot;
+static uint32_t snapshotWorstTime = 0;           /* Longest block since the last sample */
+static volatile uint8_t snapshotTaken = 0;       /* Set by the reader, restarts the worst time */
+
+/* Frame buffers: one filled, the other possibly being sent */
+static uint8_t frameBuffer[2][SERIAL_MAX_FRAME];
+static uint8_t fillBuffer = 0;
+static uint16_t fillLength = 0;                  /* Payload bytes in the fill buffer */
+static uint8_t fillSamples = 0;
+static uint8_t framePending = 0;                 /* Fill buffer complete, waiting for the UART */
+static uint8_t frameSequence = 0;
+static uint16_t sampleNumber = 0;
+static int32_t previousSample[TELEMETRY_FIELD_COUNT];
+static uint32_t lastSampleTime = 0;
+static uint32_t frameStartTime = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t ReadSnapshot(AudioProcessingStats_t *stats, uint32_t *worstTime);
+static void TakeSample(void);
+static void BuildSample(const AudioProcessingStats_t *stats, uint32_t worstTime, int32_t *sample);
+static uint16_t EncodeSample(const int32_t *sample, const int32_t *previous, uint8_t *buffer);
+static void StartFrame(void);
+static void SendFrame(void);
+static int32_t LevelToTenthsDb(float linear);
+static int32_t DbToTenths(float dB);
+
+/**
+  * @brief  Initialize telemetry (stopped)
+  * @retval None
+  */
+void Telemetry_Init(void)
+{
+  rateHz = 0;
+  intervalMs = 0;
+  memset(&telemetryStats, 0, sizeof(telemetryStats));
+  framePending = 0;
+  StartFrame();
+}
+
+/**
+  * @brief  Set the sample rate
+  * @param  newRateHz Samples per second, 0 to stop (limited to TELEMETRY_MAX_RATE_HZ)
+  * @retval Rate in effect
+  */
+uint16_t Telemetry_SetRate(uint16_t newRateHz)
+{
+  if (newRateHz > TELEMETRY_MAX_RATE_HZ) {
+    newRateHz = TELEMETRY_MAX_RATE_HZ;
+  }
+
+  /* Start over with a new frame, so each frame has a single interval */
+  framePending = 0;
+  StartFrame();
+
+  rateHz = newRateHz;
+  intervalMs = (newRateHz > 0) ? (1000 / newRateHz) : 0;
+  lastSampleTime = HAL_GetTick();
+
+  #ifdef DEBUG
+  printf("Telemetry %s (%u Hz)\r\n", newRateHz ? "started" : "stopped", newRateHz);
+  #endif
+
+  return rateHz;
+}
+
+/**
+  * @brief  Get the sample rate
+  * @retval Samples per second, 0 if stopped
+  */
+uint16_t Telemetry_GetRate(void)
+{
+  return rateHz;
+}
+
+/**
+  * @brief  Publish the statistics of the block just processed
+  * @retval None
+  */
+void Telemetry_Snapshot(void)
+{
+  if (rateHz == 0) {
+    return;
+  }
+
+  snapshotSequence++;
+  __DMB();
+
+  AudioProcessing_GetStats(&snapshot);
+  if (snapshotTaken) {
+    snapshotWorstTime = 0;
+    snapshotTaken = 0;
+  }
+  if (snapshot.processingTime > snapshotWorstTime) {
+    snapshotWorstTime = snapshot.processingTime;
+  }
+
+  __DMB();
+  snapshotSequence++;
+}
+
+/**
+  * @brief  Take samples, pack frames and send them when the UART is free
+  * @retval None
+  */
+void Telemetry_Task(void)
+{
+  if (rateHz == 0) {
+    return;
+  }
+
+  uint32_t now = HAL_GetTick();
+
+  if (now - lastSampleTime >= intervalMs) {
+    /* Do not try to catch up after a long main loop stall */
+    lastSampleTime = (now - lastSampleTime >= 2 * intervalMs) ? now : lastSampleTime + intervalMs;
+    TakeSample();
+  }
+
+  /* Close a frame that has waited long enough */
+  if (!framePending && fillSamples > 0 && now - frameStartTime >= TELEMETRY_MAX_LATENCY_MS) {
+    framePending = 1;
+  }
+
+  if (framePending) {
+    SendFrame();
+  }
+}
+
+/**
+  * @brief  Get telemetry statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void Telemetry_GetStats(TelemetryStats_t *stats)
+{
+  if (stats != NULL) {
+    memcpy(stats, &telemetryStats, sizeof(TelemetryStats_t));
+  }
+}
+
+/**
+  * @brief  Copy a consistent snapshot
+  * @param  stats     Statistics to fill
+  * @param  worstTime Receives the longest block time since the last sample
+  * @retval 1 if a snapshot was read, 0 if none is available
+  */
+static uint8_t ReadSnapshot(AudioProcessingStats_t *stats, uint32_t *worstTime)
+{
+  for (uint8_t attempt = 0; attempt < SNAPSHOT_READ_ATTEMPTS; attempt++) {
+    uint32_t sequence = snapshotSequence;
+
+    /* Nothing published yet (audio not running) */
+    if (sequence == 0) {
+      return 0;
+    }
+
+    if ((sequence & 1) == 0) {
+      __DMB();
+      memcpy(stats, &snapshot, sizeof(AudioProcessingStats_t));
+      *worstTime = snapshotWorstTime;
+      __DMB();
+
+      if (snapshotSequence == sequence) {
+        snapshotTaken = 1;
+        return 1;
+      }
+    }
+
+    telemetryStats.snapshotRetries++;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Sample the snapshot and add it to the fill buffer
+  * @retval None
+  */
+static void TakeSample(void)
+{
+  AudioProcessingStats_t stats;
+  uint32_t worstTime;
+  int32_t sample[TELEMETRY_FIELD_COUNT];
+  uint8_t coded[TELEMETRY_MAX_SAMPLE_SIZE];
+
+  if (!ReadSnapshot(&stats, &worstTime)) {
+    return;
+  }
+  telemetryStats.samples++;
+  sampleNumber++;
+
+  /* Both buffers are taken until the UART finishes */
+  if (framePending) {
+    telemetryStats.samplesDropped++;
+    return;
+  }
+
+  BuildSample(&stats, worstTime, sample);
+  uint16_t length = EncodeSample(sample, previousSample, coded);
+
+  /* Full: close this frame and start the next one with the sample */
+  if (fillSamples > 0 && TELEMETRY_HEADER_SIZE + fillLength + length > SERIAL_MAX_PAYLOAD) {
+    framePending = 1;
+    SendFrame();
+    if (framePending) {
+      telemetryStats.samplesDropped++;
+      return;
+    }
+    length = EncodeSample(sample, previousSample, coded);
+  }
+
+  uint8_t *payload = &frameBuffer[fillBuffer][SERIAL_HEADER_SIZE];
+  if (fillSamples == 0) {
+    frameStartTime = HAL_GetTick();
+    payload[0] = TELEMETRY_FORMAT_VERSION;
+    payload[1] = (uint8_t)sampleNumber;
+    payload[2] = (uint8_t)(sampleNumber >> 8);
+    payload[3] = (uint8_t)intervalMs;
+    payload[4] = (uint8_t)(intervalMs >> 8);
+    payload[5] = (uint8_t)AUDIO_BLOCK_PERIOD_US;
+    payload[6] = (uint8_t)(AUDIO_BLOCK_PERIOD_US >> 8);
+    payload[7] = TELEMETRY_FIELD_COUNT;
+  }
+
+  memcpy(&payload[TELEMETRY_HEADER_SIZE + fillLength], coded, length);
+  fillLength += length;
+  fillSamples++;
+  payload[8] = fillSamples;
+  memcpy(previousSample, sample, sizeof(previousSample));
+}
+
+/**
+  * @brief  Convert statistics to the integer fields of a sample
+  * @param  stats     Statistics
+  * @param  worstTime Longest block time since the last sample
+  * @param  sample    TELEMETRY_FIELD_COUNT values to fill
+  * @retval None
+  */
+static void BuildSample(const AudioProcessingStats_t *stats, uint32_t worstTime, int32_t *sample)
+{
+  for (uint8_t channel = 0; channel < 2; channel++) {
+    sample[TELEMETRY_FIELD_INPUT_PEAK + channel] = LevelToTenthsDb(stats->inputPeakLevel[channel]);
+    sample[TELEMETRY_FIELD_OUTPUT_PEAK + channel] = LevelToTenthsDb(stats->outputPeakLevel[channel]);
+  }
+
+  for (uint8_t band = 0; band < 4; band++) {
+    sample[TELEMETRY_FIELD_BAND_PEAK + 2 * band] = LevelToTenthsDb(stats->bandPeakLevel[band][0]);
+    sample[TELEMETRY_FIELD_BAND_PEAK + 2 * band + 1] = LevelToTenthsDb(stats->bandPeakLevel[band][1]);
+    sample[TELEMETRY_FIELD_COMPRESSION + band] = DbToTenths(stats->compressionAmount[band]);
+    sample[TELEMETRY_FIELD_LIMITER + band] = DbToTenths(stats->limiterActivity[band]);
+  }
+
+  sample[TELEMETRY_FIELD_CLIPPING] = (int32_t)stats->clippingCount;
+  sample[TELEMETRY_FIELD_BLOCK_TIME] = (int32_t)stats->processingTime;
+  sample[TELEMETRY_FIELD_WORST_TIME] = (int32_t)worstTime;
+  sample[TELEMETRY_FIELD_CROSSFADE_TIME] = (int32_t)stats->crossfadePeakTime;
+
+  EventLoopStats_t loopStats;
+  EventLoop_GetStats(&loopStats);
+  sample[TELEMETRY_FIELD_IDLE] = loopStats.idlePermille;
+}
+
+/**
+  * @brief  Code a sample as zigzag varint differences to the previous one
+  * @param  sample   Sample to code
+  * @param  previous Previous sample of the frame
+  * @param  buffer   Output (TELEMETRY_MAX_SAMPLE_SIZE bytes)
+  * @retval Coded length
+  */
+static uint16_t EncodeSample(const int32_t *sample, const int32_t *previous, uint8_t *buffer)
+{
+  uint16_t length = 0;
+
+  for (uint8_t field = 0; field < TELEMETRY_FIELD_COUNT; field++) {
+    int32_t delta = (int32_t)((uint32_t)sample[field] - (uint32_t)previous[field]);
+    uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+    while (zigzag >= 0x80) {
+      buffer[length++] = (uint8_t)(zigzag | 0x80);
+      zigzag >>= 7;
+    }
+    buffer[length++] = (uint8_t)zigzag;
+  }
+
+  return length;
+}
+
+/**
+  * @brief  Empty the fill buffer
+  * @retval None
+  */
+static void StartFrame(void)
+{
+  fillLength = 0;
+  fillSamples = 0;
+  memset(previousSample, 0, sizeof(previousSample));
+}
+
+/**
+  * @brief  Send the fill buffer if the UART is free and switch buffers
+  * @retval None
+  */
+static void SendFrame(void)
+{
+  if (SerialProtocol_SendFrame(SERIAL_MSG_TELEMETRY, frameSequence, frameBuffer[fillBuffer],
+                               TELEMETRY_HEADER_SIZE + fillLength) != SERIAL_STATUS_OK) {
+    return;
+  }
+
+  telemetryStats.framesSent++;
+  frameSequence++;
+  fillBuffer ^= 1;
+  framePending = 0;
+  StartFrame();
+}
+
+/**
+  * @brief  Convert a linear peak level to 0.1 dBFS, floored
+  * @param  linear Linear level (1.0 = full scale)
+  * @retval Level in 0.1 dB steps
+  */
+static int32_t LevelToTenthsDb(float linear)
+{
+  float dB = LINEAR_TO_DB(linear);
+
+  if (dB < TELEMETRY_LEVEL_FLOOR_DB) {
+    dB = TELEMETRY_LEVEL_FLOOR_DB;
+  }
+
+  return DbToTenths(dB);
+}
+
+/**
+  * @brief  Round a dB value to 0.1 dB steps
+  * @param  dB Value in dB
+  * @retval Value in 0.1 dB steps
+  */
+static int32_t DbToTenths(float dB)
+{
+  float tenths = dB * 10.0f;
+  return (int32_t)(tenths + ((tenths >= 0.0f) ? 0.5f : -0.5f));
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,185 @@
+ /**
+  ******************************************************************************
+  * @file           : ui_probe.c
+  * @brief          : Front panel response measurement
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * An interaction starts when the main loop takes an input event and ends
+  * when the screen has changed and the last byte of the change has left the
+  * LCD transport. Its latency is measured from the time the event was
+  * queued, so time spent waiting in the queue, in the UI and behind an
+  * audio block all count; the bus bytes are the LCD traffic in between.
+  *
+  * Events from the host (SERIAL_MSG_UI_INPUT) go through the same queue as
+  * the encoder and buttons, and SERIAL_MSG_UI_SCREEN returns the screen with
+  * these statistics. Tools/ui_replay.py plays a script of timed events this
+  * way and records every screen it produced.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ui_probe.h"
+#include <string.h>
+#include "lcd_driver.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static UiProbeStats_t probeStats;
+static uint8_t interactionOpen = 0;
+static uint8_t screenChanged = 0;
+static uint8_t passCompleted = 0;       /* A UI pass ended since the interaction started */
+static uint32_t eventTime = 0;
+static uint32_t startBusWrites = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t BusWrites(void);
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Initialize the probe and clear the statistics
+  * @retval None
+  */
+void UiProbe_Init(void)
+{
+  memset(&probeStats, 0, sizeof(probeStats));
+  interactionOpen = 0;
+  screenChanged = 0;
+  passCompleted = 0;
+}
+
+/**
+  * @brief  Queue an input event as if it came from the front panel
+  * @param  source INPUT_SOURCE_*
+  * @param  code Source specific code
+  * @param  state Source specific state
+  * @param  value Source specific value
+  * @retval 1 if queued, 0 if the queue was full
+  */
+uint8_t UiProbe_Inject(uint8_t source, uint8_t code, uint8_t state, int32_t value)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint8_t queued;
+
+  __disable_irq();
+  queued = InputQueue_Push(source, code, state, value);
+  __set_PRIMASK(primask);
+
+  if (queued) {
+    probeStats.injected++;
+  }
+  return queued;
+}
+
+/**
+  * @brief  Note an input event taken by the main loop
+  * @param  event Event taken from the input queue
+  * @retval None
+  */
+void UiProbe_EventTaken(const InputEvent_t *event)
+{
+  /* Events taken in one pass (a burst of encoder steps) are one
+     interaction; an earlier event that has drawn nothing is let go */
+  if (interactionOpen) {
+    if (screenChanged || !passCompleted) {
+      return;
+    }
+    probeStats.unchanged++;
+  }
+
+  interactionOpen = 1;
+  screenChanged = 0;
+  passCompleted = 0;
+  eventTime = event->time;
+  startBusWrites = BusWrites();
+}
+
+/**
+  * @brief  Note a frame buffer flush
+  * @param  sent Characters queued by the flush
+  * @retval None
+  */
+void UiProbe_Flushed(uint8_t sent)
+{
+  uint32_t latency;
+  uint32_t busBytes;
+
+  if (!interactionOpen) {
+    return;
+  }
+
+  passCompleted = 1;
+  if (sent > 0) {
+    screenChanged = 1;
+  }
+
+  latency = HAL_GetTick() - eventTime;
+
+  if (!screenChanged) {
+    if (latency >= UI_PROBE_WINDOW_MS) {
+      probeStats.unchanged++;
+      interactionOpen = 0;
+    }
+    return;
+  }
+
+  /* Wait for the change to be on the display */
+  if (!LCD_IsIdle()) {
+    return;
+  }
+
+  busBytes = BusWrites() - startBusWrites;
+
+  probeStats.interactions++;
+  probeStats.lastLatency = latency;
+  probeStats.totalLatency += latency;
+  if (latency > probeStats.worstLatency) {
+    probeStats.worstLatency = latency;
+  }
+  probeStats.lastBusBytes = busBytes;
+  if (busBytes > probeStats.worstBusBytes) {
+    probeStats.worstBusBytes = busBytes;
+  }
+
+  interactionOpen = 0;
+}
+
+/**
+  * @brief  Get the response statistics
+  * @param  stats Pointer to structure to fill
+  * @retval None
+  */
+void UiProbe_GetStats(UiProbeStats_t *stats)
+{
+  memcpy(stats, &probeStats, sizeof(UiProbeStats_t));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  LCD bus bytes sent so far
+  * @retval Byte count
+  */
+static uint32_t BusWrites(void)
+{
+  LCD_StatsTypeDef lcdStats;
+
+  LCD_GetStats(&lcdStats);
+  return lcdStats.BusWrites;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -30,6 +30,10 @@
 #include "factory_presets.h"
 #include "preset_manager.h"
 #include "flash_storage.h"
+#include "param_update.h"
+#include "fixed_format.h"
+#include "level_meter.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -38,10 +42,19 @@
 #define UI_STATE_EDIT_VALUE      1
 #define UI_STATE_CONFIRM_ACTION  2
 #define UI_STATE_MENU_SCROLLING  3
+#define UI_STATE_METER           4
 
 #define EDIT_TIMEOUT           5000  // 5 seconds timeout for edit mode
 #define REFRESH_INTERVAL       100   // UI refresh interval in ms
-#define BUTTON_HOLD_TIME       1500  // Time to hold button for alternative action
+#define HOLD_ACTION_TIME       1500  // Time to hold button for alternative action
+#define MESSAGE_QUEUE_SIZE     4     // Message shown plus those waiting behind it
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  char line1[17];
+  char line2[17];
+  uint16_t timeout;            // Display time in ms
+} UI_Message_t;
 
 /* Private variables ---------------------------------------------------------*/
 static uint8_t uiState = UI_STATE_NORMAL;
@@ -60,24 +73,30 @@ static uint8_t volumeAdjustMode = 0;
 static uint8_t currentBand = 0;
 static uint8_t currentPreset = 0;
 static uint32_t lastRefreshTime = 0;
+static UI_Message_t messageQueue[MESSAGE_QUEUE_SIZE];  // [0] is the message shown
+static uint8_t messageCount = 0;
+static uint32_t messageStartTime = 0;
+static const char* const bandNames[4] = {"Sub Band", "Low Band", "Mid Band", "High Band"};
 
 /* Private function prototypes -----------------------------------------------*/
 static void HandleNormalModeRotary(RotaryEvent_t *event);
 static void HandleEditModeRotary(RotaryEvent_t *event);
 static void HandleConfirmModeButton(ButtonEvent_t *event);
+static void SetMessage(UI_Message_t *message, const char* line1, const char* line2, uint16_t timeout);
+static void DrawMessage(void);
 static void HandleNormalModeButton(ButtonEvent_t *event);
 static void HandleEditModeButton(ButtonEvent_t *event);
 static void HandleMenuScrollingModeRotary(RotaryEvent_t *event);
 static void HandleMenuScrollingModeButton(ButtonEvent_t *event);
+static void HandleMeterModeButton(ButtonEvent_t *event);
 static void UpdateVolumeUI(void);
+static float* BandGain(uint8_t band);
+static uint8_t* BandMute(uint8_t band);
 static void RefreshUI(void);
 static void TimeoutEditMode(void);
 static void SaveCurrentPreset(void);
-static void ShowParameterEdit(const char* paramName, int32_t value, 
-                              int32_t min, int32_t max, int32_t step, 
-                              void (*callback)(int32_t));
-static void ShowConfirmDialog(const char* message, void (*callback)(uint8_t));
-static void FormatValue(char* buffer, int32_t value, uint8_t valueType);
+static void PresetSaved(uint8_t presetId, uint8_t status);
+static void FormatValue(char* buffer, uint8_t size, int32_t value, uint8_t valueType);
 
 /* Value type formatting constants */
 #define VALUE_TYPE_INTEGER     0
@@ -89,6 +108,18 @@ static void FormatValue(char* buffer, int32_t value, uint8_t valueType);
 #define VALUE_TYPE_RATIO       6
 #define VALUE_TYPE_DEGREE      7
 
+/* Display format per value type (values are scaled integers, see FormatValue) */
+static const FixedFormat_t valueFormats[] = {
+  [VALUE_TYPE_INTEGER]   = {NULL,   NULL,   0, 0},
+  [VALUE_TYPE_DECIMAL]   = {NULL,   NULL,   1, 0},
+  [VALUE_TYPE_FREQUENCY] = {" Hz",  " kHz", 0, 0},
+  [VALUE_TYPE_DB]        = {" dB",  NULL,   1, 0},
+  [VALUE_TYPE_MS]        = {" ms",  NULL,   0, 0},
+  [VALUE_TYPE_PERCENT]   = {"%",    NULL,   0, 0},
+  [VALUE_TYPE_RATIO]     = {":1",   NULL,   1, 0},
+  [VALUE_TYPE_DEGREE]    = {"\xDF", NULL,   0, 0},  /* Degree sign in the HD44780 ROM */
+};
+
 /**
   * @brief  Initialize the UI manager
   * @retval None
@@ -150,6 +181,10 @@ void UI_HandleRotaryEvent(RotaryEvent_t *event)
       /* Rotary events not used in confirm mode */
       break;
       
+    case UI_STATE_METER:
+      LevelMeter_ChangePage(event->direction == ROTARY_CW ? 1 : -1);
+      break;
+      
     default:
       break;
   }
@@ -195,6 +230,10 @@ void UI_HandleButtonEvent(ButtonEvent_t *event)
       HandleMenuScrollingModeButton(event);
       break;
       
+    case UI_STATE_METER:
+      HandleMeterModeButton(event);
+      break;
+      
     default:
       break;
   }
@@ -211,6 +250,33 @@ void UI_Update(void)
 {
   uint32_t currentTime = HAL_GetTick();
   
+  /* Time out the message shown, then show the next one or restore the screen */
+  if (messageCount > 0) {
+    if ((currentTime - messageStartTime) >= messageQueue[0].timeout) {
+      messageCount--;
+      memmove(&messageQueue[0], &messageQueue[1], messageCount * sizeof(UI_Message_t));
+      messageStartTime = currentTime;
+      
+      if (messageCount == 0) {
+        if (uiState == UI_STATE_METER) {
+          LevelMeter_Start(LevelMeter_GetPage());
+        } else {
+          Menu_RefreshCurrent();
+        }
+      }
+    }
+    
+    /* Keep the message on top of anything drawn since the last update */
+    if (messageCount > 0) {
+      DrawMessage();
+    }
+  }
+  
+  /* Meters run at their own rate (held off while a message is shown) */
+  if (uiState == UI_STATE_METER && messageCount == 0) {
+    LevelMeter_Task();
+  }
+  
   /* Check for edit mode timeout */
   if (uiState == UI_STATE_EDIT_VALUE) {
     if ((currentTime - lastInteractionTime) > EDIT_TIMEOUT) {
@@ -224,7 +290,7 @@ void UI_Update(void)
       buttonHoldCounter[i]++;
       
       /* Trigger hold action after hold threshold */
-      if (buttonHoldCounter[i] >= (BUTTON_HOLD_TIME / REFRESH_INTERVAL)) {
+      if (buttonHoldCounter[i] >= (HOLD_ACTION_TIME / REFRESH_INTERVAL)) {
         /* Process hold action based on button */
         ButtonEvent_t holdEvent;
         holdEvent.button = i;
@@ -237,14 +303,98 @@ void UI_Update(void)
     }
   }
   
-  /* Update UI at refresh interval */
-  if ((currentTime - lastRefreshTime >= REFRESH_INTERVAL) && needsRefresh) {
+  /* Update UI at refresh interval (held off while a message is shown) */
+  if ((currentTime - lastRefreshTime >= REFRESH_INTERVAL) && needsRefresh && messageCount == 0) {
     RefreshUI();
     lastRefreshTime = currentTime;
     needsRefresh = 0;
   }
 }
 
+/**
+  * @brief  Show a two-line message without blocking
+  * @note   Replaces the message shown, if any. The message stays until the
+  *         timeout expires, then the next queued message or the current menu
+  *         is shown from UI_Update(). The text is copied.
+  * @param  line1 First line text
+  * @param  line2 Second line text (may be NULL)
+  * @param  timeout Display time in ms
+  * @retval None
+  */
+void UI_ShowMessage(const char* line1, const char* line2, uint16_t timeout)
+{
+  SetMessage(&messageQueue[0], line1, line2, timeout);
+  if (messageCount == 0) {
+    messageCount = 1;
+  }
+  
+  messageStartTime = HAL_GetTick();
+  DrawMessage();
+}
+
+/**
+  * @brief  Show a two-line message after those already shown or waiting
+  * @note   When the queue is full the newest waiting message is replaced
+  * @param  line1 First line text
+  * @param  line2 Second line text (may be NULL)
+  * @param  timeout Display time in ms
+  * @retval None
+  */
+void UI_QueueMessage(const char* line1, const char* line2, uint16_t timeout)
+{
+  if (messageCount == 0) {
+    UI_ShowMessage(line1, line2, timeout);
+    return;
+  }
+  
+  if (messageCount < MESSAGE_QUEUE_SIZE) {
+    messageCount++;
+  }
+  SetMessage(&messageQueue[messageCount - 1], line1, line2, timeout);
+}
+
+/**
+  * @brief  Show the level meters
+  * @note   The encoder changes the meter page, any button returns to the menu
+  * @retval None
+  */
+void UI_ShowMeters(void)
+{
+  uiState = UI_STATE_METER;
+  volumeAdjustMode = 0;
+  LevelMeter_Start(LevelMeter_GetPage());
+}
+
+/**
+  * @brief  Fill a message entry
+  * @param  message Entry to fill
+  * @param  line1 First line text
+  * @param  line2 Second line text (may be NULL)
+  * @param  timeout Display time in ms
+  * @retval None
+  */
+static void SetMessage(UI_Message_t *message, const char* line1, const char* line2, uint16_t timeout)
+{
+  strncpy(message->line1, line1, sizeof(message->line1) - 1);
+  message->line1[sizeof(message->line1) - 1] = '\0';
+  strncpy(message->line2, (line2 != NULL) ? line2 : "", sizeof(message->line2) - 1);
+  message->line2[sizeof(message->line2) - 1] = '\0';
+  message->timeout = timeout;
+}
+
+/**
+  * @brief  Draw the message shown into the LCD frame buffer
+  * @retval None
+  */
+static void DrawMessage(void)
+{
+  LCD_Clear();
+  LCD_SetCursor(0, 0);
+  LCD_Print(messageQueue[0].line1);
+  LCD_SetCursor(0, 1);
+  LCD_Print(messageQueue[0].line2);
+}
+
 /**
   * @brief  Set the active audio band for editing (Sub, Low, Mid, High)
   * @param  band Band index to set active
@@ -274,24 +424,23 @@ static void HandleNormalModeRotary(RotaryEvent_t *event)
 {
   /* In normal mode, rotary adjusts volume if in volume adjust mode */
   if (volumeAdjustMode) {
-    CrossoverSettings_t settings;
-    Crossover_GetSettings(&settings);
+    float *gain = BandGain(currentBand);
     
     /* Adjust gain for current band */
     if (event->direction == ROTARY_CW) {
-      settings.bandGain[currentBand] += 0.5f;
-      if (settings.bandGain[currentBand] > 12.0f) {
-        settings.bandGain[currentBand] = 12.0f;
+      *gain += 0.5f * event->steps;
+      if (*gain > 12.0f) {
+        *gain = 12.0f;
       }
     } else {
-      settings.bandGain[currentBand] -= 0.5f;
-      if (settings.bandGain[currentBand] < -60.0f) {
-        settings.bandGain[currentBand] = -60.0f;
+      *gain -= 0.5f * event->steps;
+      if (*gain < -60.0f) {
+        *gain = -60.0f;
       }
     }
     
-    /* Apply new settings */
-    Crossover_SetSettings(&settings);
+    /* Applied with the next control update (a gain needs no filter math) */
+    ParamUpdate_Mark(PARAM_DIRTY_BAND_LEVELS);
     
     /* Update volume display */
     UpdateVolumeUI();
@@ -312,14 +461,14 @@ static void HandleNormalModeRotary(RotaryEvent_t *event)
   */
 static void HandleEditModeRotary(RotaryEvent_t *event)
 {
-  /* Adjust the value being edited */
+  /* Adjust the value being edited (steps grow on fast turns) */
   if (event->direction == ROTARY_CW) {
-    editValue += editValueStep;
+    editValue += editValueStep * event->steps;
     if (editValue > editValueMax) {
       editValue = editValueMax;
     }
   } else {
-    editValue -= editValueStep;
+    editValue -= editValueStep * event->steps;
     if (editValue < editValueMin) {
       editValue = editValueMin;
     }
@@ -331,7 +480,7 @@ static void HandleEditModeRotary(RotaryEvent_t *event)
   LCD_PrintChar('>');
   
   /* Format the value appropriately */
-  FormatValue(valueStr, editValue, VALUE_TYPE_INTEGER);
+  FormatValue(valueStr, sizeof(valueStr), editValue, VALUE_TYPE_INTEGER);
   LCD_Print(valueStr);
   
   /* Clear the rest of the line */
@@ -369,64 +518,22 @@ static void HandleNormalModeButton(ButtonEvent_t *event)
         /* Cycle through bands */
         currentBand = (currentBand + 1) % 4;  // 4 bands: Sub, Low, Mid, High
         
-        /* Show band selection UI */
-        LCD_Clear();
-        LCD_SetCursor(0, 0);
-        LCD_Print("Band Selected:");
-        LCD_SetCursor(0, 1);
-        
-        switch (currentBand) {
-          case 0:
-            LCD_Print("Sub Band");
-            break;
-          case 1:
-            LCD_Print("Low Band");
-            break;
-          case 2:
-            LCD_Print("Mid Band");
-            break;
-          case 3:
-            LCD_Print("High Band");
-            break;
-        }
-        
-        /* Return to previous menu after a brief delay */
-        HAL_Delay(1000);
-        Menu_RefreshCurrent();
+        /* Show band selection; the menu returns when the message times out */
+        UI_ShowMessage("Band Selected:", bandNames[currentBand], 1000);
         break;
         
       case BUTTON_MUTE:
         /* Toggle mute for current band */
-        CrossoverSettings_t settings;
-        Crossover_GetSettings(&settings);
-        settings.bandMute[currentBand] = !settings.bandMute[currentBand];
-        Crossover_SetSettings(&settings);
+        uint8_t *mute = BandMute(currentBand);
+        *mute = !*mute;
+        ParamUpdate_Mark(PARAM_DIRTY_BAND_LEVELS);
         
-        /* Show mute status UI */
-        LCD_Clear();
-        LCD_SetCursor(0, 0);
-        
-        switch (currentBand) {
-          case 0:
-            LCD_Print("Sub Band:");
-            break;
-          case 1:
-            LCD_Print("Low Band:");
-            break;
-          case 2:
-            LCD_Print("Mid Band:");
-            break;
-          case 3:
-            LCD_Print("High Band:");
-            break;
-        }
-        
-        LCD_SetCursor(0, 1);
-        LCD_Print(settings.bandMute[currentBand] ? "MUTED" : "UNMUTED");
-        
-        /* Return to previous menu after a brief delay */
-        HAL_Delay(1000);
-        Menu_RefreshCurrent();
+        /* Show mute status; the menu returns when the message times out */
+        char bandLabel[17];
+        strncpy(bandLabel, bandNames[currentBand], sizeof(bandLabel) - 2);
+        bandLabel[sizeof(bandLabel) - 2] = '\0';
+        strcat(bandLabel, ":");
+        UI_ShowMessage(bandLabel, *mute ? "MUTED" : "UNMUTED", 1000);
         break;
         
       case BUTTON_VOLUME:
@@ -455,10 +562,8 @@ static void HandleNormalModeButton(ButtonEvent_t *event)
         
       case BUTTON_VOLUME:
         /* Reset gain of current band to 0 dB */
-        CrossoverSettings_t settings;
-        Crossover_GetSettings(&settings);
-        settings.bandGain[currentBand] = 0.0f;
-        Crossover_SetSettings(&settings);
+        *BandGain(currentBand) = 0.0f;
+        ParamUpdate_Mark(PARAM_DIRTY_BAND_LEVELS);
         
         if (volumeAdjustMode) {
           UpdateVolumeUI();
@@ -601,15 +706,26 @@ static void HandleMenuScrollingModeButton(ButtonEvent_t *event)
   }
 }
 
+/**
+  * @brief Handle button events while the meters are shown
+  * @param event Pointer to button event
+  * @retval None
+  */
+static void HandleMeterModeButton(ButtonEvent_t *event)
+{
+  /* Any button leaves the meters */
+  if (event->state == BUTTON_PRESSED) {
+    uiState = UI_STATE_NORMAL;
+    Menu_RefreshCurrent();
+  }
+}
+
 /**
   * @brief Update the volume adjustment UI
   * @retval None
   */
 static void UpdateVolumeUI(void)
 {
-  CrossoverSettings_t settings;
-  Crossover_GetSettings(&settings);
-  
   LCD_Clear();
   LCD_SetCursor(0, 0);
   
@@ -633,16 +749,50 @@ static void UpdateVolumeUI(void)
   LCD_SetCursor(0, 1);
   
   char valueStr[17];
-  int32_t gainValue = (int32_t)(settings.bandGain[currentBand] * 10);
-  FormatValue(valueStr, gainValue, VALUE_TYPE_DB);
+  int32_t gainValue = (int32_t)(*BandGain(currentBand) * 10);
+  FormatValue(valueStr, sizeof(valueStr), gainValue, VALUE_TYPE_DB);
   LCD_Print(valueStr);
   
   /* Show mute status if applicable */
-  if (settings.bandMute[currentBand]) {
+  if (*BandMute(currentBand)) {
     LCD_Print(" (MUTED)");
   }
 }
 
+/**
+  * @brief Gain of a band in the live settings (edits are applied later)
+  * @param band Band index (0: sub, 1: low, 2: mid, 3: high)
+  * @retval Pointer to the gain in dB
+  */
+static float* BandGain(uint8_t band)
+{
+  struct CrossoverSettings_t *xo = &ParamUpdate_GetSettings()->crossover;
+  
+  switch (band) {
+    case 0:  return &xo->subGain;
+    case 1:  return &xo->lowGain;
+    case 2:  return &xo->midGain;
+    default: return &xo->highGain;
+  }
+}
+
+/**
+  * @brief Mute flag of a band in the live settings (edits are applied later)
+  * @param band Band index (0: sub, 1: low, 2: mid, 3: high)
+  * @retval Pointer to the mute flag
+  */
+static uint8_t* BandMute(uint8_t band)
+{
+  struct CrossoverSettings_t *xo = &ParamUpdate_GetSettings()->crossover;
+  
+  switch (band) {
+    case 0:  return &xo->subMute;
+    case 1:  return &xo->lowMute;
+    case 2:  return &xo->midMute;
+    default: return &xo->highMute;
+  }
+}
+
 /**
   * @brief Refresh the UI based on current state
   * @retval None
@@ -705,7 +855,7 @@ void UI_ShowParameterEdit(const char* paramName, int32_t value,
   
   /* Format and show the value */
   char valueStr[17];
-  FormatValue(valueStr, value, VALUE_TYPE_INTEGER);
+  FormatValue(valueStr, sizeof(valueStr), value, VALUE_TYPE_INTEGER);
   LCD_Print(valueStr);
   
   /* Record current time for timeout handling */
@@ -760,57 +910,20 @@ void UI_EnterMenuScrolling(void)
 
 /**
   * @brief Format value for display based on type
+  * @note  Integer only (no printf): decimal types take the value scaled by 10
+  *        (e.g. dB x10), frequencies switch to kHz from 1000 Hz
   * @param buffer Output string buffer
+  * @param size Buffer size in bytes
   * @param value Value to format
   * @param valueType Type of value (determines formatting)
   * @retval None
   */
-static void FormatValue(char* buffer, int32_t value, uint8_t valueType)
+static void FormatValue(char* buffer, uint8_t size, int32_t value, uint8_t valueType)
 {
-  switch (valueType) {
-    case VALUE_TYPE_INTEGER:
-      sprintf(buffer, "%ld", value);
-      break;
-      
-    case VALUE_TYPE_DECIMAL:
-      /* Assuming value is scaled by 10 */
-      sprintf(buffer, "%ld.%ld", value / 10, abs(value % 10));
-      break;
-      
-    case VALUE_TYPE_FREQUENCY:
-      if (value < 1000) {
-        sprintf(buffer, "%ld Hz", value);
-      } else {
-        sprintf(buffer, "%.1f kHz", value / 1000.0f);
-      }
-      break;
-      
-    case VALUE_TYPE_DB:
-      /* Assuming value is scaled by 10 */
-      sprintf(buffer, "%ld.%ld dB", value / 10, abs(value % 10));
-      break;
-      
-    case VALUE_TYPE_MS:
-      sprintf(buffer, "%ld ms", value);
-      break;
-      
-    case VALUE_TYPE_PERCENT:
-      sprintf(buffer, "%ld%%", value);
-      break;
-      
-    case VALUE_TYPE_RATIO:
-      /* Assuming value is ratio * 10 */
-      sprintf(buffer, "%ld.%ld:1", value / 10, value % 10);
-      break;
-      
-    case VALUE_TYPE_DEGREE:
-      sprintf(buffer, "%ld°", value);
-      break;
-      
-    default:
-      sprintf(buffer, "%ld", value);
-      break;
+  if (valueType >= sizeof(valueFormats) / sizeof(valueFormats[0])) {
+    valueType = VALUE_TYPE_INTEGER;
   }
+  FixedFormat_Print(buffer, size, value, &valueFormats[valueType]);
 }
 
 /**
@@ -827,8 +940,8 @@ static void SaveCurrentPreset(void)
   LCD_Print("Preset ");
   LCD_PrintNumber(currentPreset);
   
-  /* Create system settings structure */
-  SystemSettings_t settings;
+  /* Create preset settings structure */
+  PresetSettings_t settings;
   
   /* Get settings from all audio modules */
   Crossover_GetSettings(&settings.crossover);
@@ -836,17 +949,27 @@ static void SaveCurrentPreset(void)
   Limiter_GetSettings(&settings.limiter);
   Delay_GetSettings(&settings.delay);
   
-  /* Save settings to preset */
-  PresetManager_SavePreset(currentPreset, &settings);
-  
-  /* Success indicator */
-  LCD_Clear();
-  LCD_SetCursor(0, 0);
-  LCD_Print("Preset saved!");
-  HAL_Delay(1000);
+  /* Save settings to preset in the background; the result is shown by PresetSaved() */
+  if (PresetManager_SavePresetAsync(currentPreset, &settings, PresetSaved) != PRESET_STATUS_OK) {
+    UI_ShowMessage("Save failed", "Storage busy", 1000);
+  }
+}
+
+/**
+  * @brief Completion callback for background preset saves
+  * @param presetId The preset that was saved
+  * @param status PRESET_STATUS_OK or error code
+  * @retval None
+  */
+static void PresetSaved(uint8_t presetId, uint8_t status)
+{
+  (void)presetId;
   
-  /* Return to previous screen */
-  Menu_RefreshCurrent();
+  if (status == PRESET_STATUS_OK) {
+    UI_ShowMessage("Preset saved!", NULL, 1000);
+  } else {
+    UI_ShowMessage("Save failed", NULL, 1000);
+  }
 }
 
 /**
@@ -896,12 +1019,4 @@ void UI_Confirm(const char* message, void (*callback)(uint8_t))
   UI_ShowConfirmDialog(message, callback);
 }
 
-/* Typedefs needed for implementation but not in header files */
-typedef struct {
-    CrossoverSettings_t crossover;
-    CompressorSettings_t compressor;
-    LimiterSettings_t limiter;
-    DelaySettings_t delay;
-} SystemSettings_t;
-
 /************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
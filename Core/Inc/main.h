@@ -73,7 +73,7 @@ typedef struct {
     
     struct CompressorSettings_t {
         /* Settings for each band */
-        struct {
+        struct CompressorBandSettings_t {
             float threshold;  /* dB, typically -60 to 0 */
             float ratio;      /* ratio, typically 1 to 20 */
             float attack;     /* ms, typically 0.1 to 100 */
@@ -85,7 +85,7 @@ typedef struct {
     
     struct LimiterSettings_t {
         /* Settings for each band */
-        struct {
+        struct LimiterBandSettings_t {
             float threshold;  /* dB, typically -20 to 0 */
             float release;    /* ms, typically 10 to 1000 */
             uint8_t enabled;  /* 1: enabled, 0: bypassed */
@@ -115,6 +115,7 @@ typedef struct {
 #define SYSTEM_STATE_INITIALIZING    1
 #define SYSTEM_STATE_SAVE_SETTINGS   2
 #define SYSTEM_STATE_LOAD_PRESET     3
+#define SYSTEM_STATE_MORPH_PRESET    4
 
 /* Preset indices */
 #define PRESET_DEFAULT    0
@@ -124,20 +125,32 @@ typedef struct {
 #define PRESET_POP        4
 #define NUM_FACTORY_PRESETS 5
 
-/* User preset starting index */
-#define USER_PRESET_START  10
-#define MAX_USER_PRESETS   10
-
 /* UI constants */
 #define UI_REFRESH_INTERVAL 10  /* refresh UI every 10 ticks */
 
 /* Audio buffer size */
 #define AUDIO_BUFFER_SIZE 256  /* Must be a multiple of 2 and 4 for stereo processing */
 
+/* Audio sample rate (DEFAULT_AUDIO_SAMPLE_RATE of i2s_config.h) and the time
+   one block of AUDIO_BUFFER_SIZE / 2 frames lasts */
+#define AUDIO_SAMPLE_RATE_HZ 48000
+#define AUDIO_BLOCK_PERIOD_US ((AUDIO_BUFFER_SIZE / 2) * 1000000UL / AUDIO_SAMPLE_RATE_HZ)
+
 /* Error LED */
 #define ERROR_LED_Pin GPIO_PIN_13
 #define ERROR_LED_GPIO_Port GPIOC
 
+/* LCD I2C1 pins; PB6/PB7 carry the TIM4 encoder channels on boards built
+   with ROTARY_USE_TIMER (see rotary_encoder.h) */
+#if defined(ROTARY_USE_TIMER) && ROTARY_USE_TIMER
+#define LCD_SCL_Pin GPIO_PIN_8
+#define LCD_SDA_Pin GPIO_PIN_9
+#else
+#define LCD_SCL_Pin GPIO_PIN_6
+#define LCD_SDA_Pin GPIO_PIN_7
+#endif
+#define LCD_I2C_GPIO_Port GPIOB
+
 /* Debug output control */
 #ifdef DEBUG
 #define DEBUG_PRINT(x) printf(x)
@@ -171,6 +184,8 @@ extern TIM_HandleTypeDef htim3;
 extern UART_HandleTypeDef huart1;
 extern DMA_HandleTypeDef hdma_spi2_rx;
 extern DMA_HandleTypeDef hdma_spi3_tx;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
 
 #ifdef __cplusplus
 }
@@ -65,6 +65,12 @@ void DMA1_Stream3_IRQHandler(void);
 /* DMA1 Stream5 interrupt handler - used for SPI3_TX (I2S3_TX) */
 void DMA1_Stream5_IRQHandler(void);
 
+/* DMA2 Stream2 interrupt handler - used for USART1_RX (serial protocol) */
+void DMA2_Stream2_IRQHandler(void);
+
+/* DMA2 Stream7 interrupt handler - used for USART1_TX (serial protocol) */
+void DMA2_Stream7_IRQHandler(void);
+
 /* I2C1 event interrupt handler */
 void I2C1_EV_IRQHandler(void);
 
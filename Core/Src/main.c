@@ -34,9 +34,17 @@
 #include "limiter.h"
 #include "delay.h"
 #include "audio_preset.h"
+#include "memory_manager.h"
+#include "stack_monitor.h"
+#include "preset_morph.h"
+#include "param_update.h"
 
 /* Interface Includes */
 #include "lcd_driver.h"
+#include "input_queue.h"
+#include "ui_probe.h"
+#include "event_loop.h"
+#include "scheduler.h"
 #include "rotary_encoder.h"
 #include "button_handler.h"
 #include "menu_system.h"
@@ -44,14 +52,25 @@
 
 /* Storage Includes */
 #include "flash_storage.h"
+#include "crc32.h"
 #include "preset_manager.h"
 #include "factory_presets.h"
 
+/* Communication Includes */
+#include "serial_protocol.h"
+#include "telemetry.h"
+#include "fixed_format.h"
+
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 #define SYSTEM_VERSION "v1.0.0"
 #define AUDIO_BUFFER_SIZE 256  // Must be a multiple of 2 and 4 for stereo processing
 
+/* Task deadlines in us, from the task becoming ready to its job done */
+#define AUDIO_DEADLINE_US AUDIO_BLOCK_PERIOD_US
+#define HOST_DEADLINE_US 10000      /* Well inside the 44 ms serial DMA buffer */
+#define UI_DEADLINE_US 20000        /* Front panel response still felt as immediate */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static volatile uint8_t systemState = 0;
@@ -60,17 +79,42 @@ static AudioBuffer_t inputBuffer;
 static AudioBuffer_t outputBuffer;
 static SystemSettings_t systemSettings;
 static uint8_t activePreset = 0;
+static uint8_t inputSampleCount = 0;  /* TIM3 periods since the last 1 ms input tick */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void InitSystem(void);
+static void SetInputSampleRate(void);
 static void InitAudio(void);
 static void ProcessAudio(void);
 static void HandleUserInterface(void);
+static void HandleSystemState(void);
+static uint8_t AudioTask(void);
+static uint8_t ControlTask(void);
+static uint8_t HostTask(void);
+static uint8_t UiTask(void);
+static uint8_t LcdTask(void);
+static uint8_t TelemetryTask(void);
+static uint8_t StorageTask(void);
+static void DispatchEncoderSteps(int32_t steps);
 static void SaveCurrentSettings(void);
+static void SettingsSaved(uint8_t presetId, uint8_t status);
 static void LoadSettings(uint8_t presetIndex);
+static void MorphToPreset(uint8_t presetIndex);
+static void ReadPreset(uint8_t presetIndex, SystemSettings_t *settings);
 static void Error_Handler(void);
 
+/* Main loop tasks, highest priority first */
+static const SchedulerTask_t taskTable[] = {
+  { "audio",     AudioTask,     EVENT_AUDIO,               AUDIO_DEADLINE_US },
+  { "control",   ControlTask,   EVENT_CONTROL,             AUDIO_DEADLINE_US },
+  { "host",      HostTask,      EVENT_TICK,                HOST_DEADLINE_US },
+  { "ui",        UiTask,        EVENT_INPUT | EVENT_UI,    UI_DEADLINE_US },
+  { "lcd",       LcdTask,       EVENT_INPUT | EVENT_UI,    UI_DEADLINE_US },
+  { "telemetry", TelemetryTask, EVENT_TICK,                HOST_DEADLINE_US },
+  { "storage",   StorageTask,   EVENT_TICK,                0 },
+};
+
 /**
   * @brief  The application entry point.
   * @retval int
@@ -79,62 +123,156 @@ int main(void)
 {
   /* MCU Configuration--------------------------------------------------------*/
   
+  /* Paint the stack before anything else runs so peak usage can be measured */
+  StackMonitor_Init();
+  
   /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
   HAL_Init();
 
   /* Configure the system clock */
   SystemClock_Config();
 
+  /* Start the DWT cycle counter; the scheduler, audio, morph and parameter
+     update timing all read it */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
   /* Initialize all configured peripherals */
   InitSystem();
   
   /* Initialize audio subsystem */
   InitAudio();
   
-  /* Show welcome screen */
-  LCD_Clear();
-  LCD_SetCursor(0, 0);
-  LCD_Print("Audio Crossover");
-  LCD_SetCursor(0, 1);
-  LCD_Print(SYSTEM_VERSION);
-  HAL_Delay(2000);
+  /* Show welcome screen (times out from the main loop while audio runs) */
+  UI_ShowMessage("Audio Crossover", SYSTEM_VERSION, 2000);
   
   /* Load default preset */
   LoadSettings(PRESET_DEFAULT);
   
   /* Display main menu */
   Menu_ShowMain();
+  
+  /* Report stack usage of the boot sequence */
+  StackMonitor_PrintReport();
 
-  /* Infinite loop */
+  /* Interrupts post events; the scheduler runs the tasks they trigger in
+     priority order and sleeps when none is ready */
   while (1)
   {
-    /* Process audio if new samples are available */
-    ProcessAudio();
-    
-    /* Handle user interface (buttons, encoder, menu) */
-    HandleUserInterface();
-    
-    /* Check for system state changes */
-    switch (systemState) {
-      case SYSTEM_STATE_SAVE_SETTINGS:
-        SaveCurrentSettings();
-        systemState = SYSTEM_STATE_NORMAL;
-        break;
-      
-      case SYSTEM_STATE_LOAD_PRESET:
-        LoadSettings(activePreset);
-        systemState = SYSTEM_STATE_NORMAL;
-        break;
-        
-      default:
-        /* Normal operation, nothing special to do */
-        break;
-    }
-    
     /* Feed the watchdog if enabled */
     #ifdef USE_IWDG
     HAL_IWDG_Refresh(&hiwdg);
     #endif
+    
+    Scheduler_RunNext();
+  }
+}
+
+/**
+  * @brief Audio task: process a received block
+  * @retval SCHEDULER_DONE
+  */
+static uint8_t AudioTask(void)
+{
+  ProcessAudio();
+  return SCHEDULER_DONE;
+}
+
+/**
+  * @brief Control task: control-rate updates after each processed block
+  * @retval SCHEDULER_DONE
+  */
+static uint8_t ControlTask(void)
+{
+  /* Advance a preset morph by one control stage */
+  PresetMorph_Tick(&systemSettings, AUDIO_BUFFER_SIZE / 2);
+  
+  /* Apply parameter edits made since the last control update */
+  ParamUpdate_Tick(AUDIO_BUFFER_SIZE / 2);
+  return SCHEDULER_DONE;
+}
+
+/**
+  * @brief Host task: answer host requests received on USART1
+  * @retval SCHEDULER_DONE
+  */
+static uint8_t HostTask(void)
+{
+  SerialProtocol_Task();
+  return SCHEDULER_DONE;
+}
+
+/**
+  * @brief UI task: buttons, encoder, menu and requested state changes
+  * @retval SCHEDULER_DONE
+  */
+static uint8_t UiTask(void)
+{
+  HandleUserInterface();
+  
+  /* Track main loop stack depth */
+  StackMonitor_Checkpoint();
+  
+  HandleSystemState();
+  return SCHEDULER_DONE;
+}
+
+/**
+  * @brief LCD task: send what changed on screen to the display
+  * @retval SCHEDULER_DONE
+  */
+static uint8_t LcdTask(void)
+{
+  UiProbe_Flushed(LCD_Flush());
+  return SCHEDULER_DONE;
+}
+
+/**
+  * @brief Telemetry task: stream meters to the host when enabled
+  * @retval SCHEDULER_DONE
+  */
+static uint8_t TelemetryTask(void)
+{
+  Telemetry_Task();
+  return SCHEDULER_DONE;
+}
+
+/**
+  * @brief Storage task: program pending preset saves one journal step at a time
+  * @retval SCHEDULER_YIELD while a save is in progress, else SCHEDULER_DONE
+  */
+static uint8_t StorageTask(void)
+{
+  PresetManager_Task();
+  return PresetManager_IsBusy() ? SCHEDULER_YIELD : SCHEDULER_DONE;
+}
+
+/**
+  * @brief Carry out a system state change requested by the UI
+  * @retval None
+  */
+static void HandleSystemState(void)
+{
+  /* Check for system state changes */
+  switch (systemState) {
+    case SYSTEM_STATE_SAVE_SETTINGS:
+      SaveCurrentSettings();
+      systemState = SYSTEM_STATE_NORMAL;
+      break;
+    
+    case SYSTEM_STATE_LOAD_PRESET:
+      LoadSettings(activePreset);
+      systemState = SYSTEM_STATE_NORMAL;
+      break;
+    
+    case SYSTEM_STATE_MORPH_PRESET:
+      MorphToPreset(activePreset);
+      systemState = SYSTEM_STATE_NORMAL;
+      break;
+      
+    default:
+      /* Normal operation, nothing special to do */
+      break;
   }
 }
 
@@ -209,23 +347,41 @@ static void InitSystem(void)
   MX_SPI1_Init();
   MX_TIM2_Init();
   MX_TIM3_Init();
+  SetInputSampleRate();
   MX_USART1_UART_Init();
   
   /* Initialize display */
   LCD_Init();
   
-  /* Initialize user input devices */
+  /* Initialize user input devices (both queue events from the TIM3 interrupt) */
+  InputQueue_Init();
   RotaryEncoder_Init();
   ButtonHandler_Init();
+  UiProbe_Init();
+  
+  /* Menu, front panel and host edits are applied through one pipeline */
+  ParamUpdate_Init(&systemSettings);
   
   /* Initialize menu system */
   Menu_Init();
   UI_Init();
   
+  /* Initialize CRC service (stored preset integrity) */
+  Crc32_Init();
+  
   /* Initialize storage */
   Flash_Init();
   PresetManager_Init();
   
+  /* Start the host protocol on USART1 (presets, live parameters, statistics);
+     telemetry streaming stays off until the host asks for it */
+  Telemetry_Init();
+  SerialProtocol_Init(&systemSettings);
+  
+  /* Interrupts post main loop work from here on */
+  EventLoop_Init();
+  Scheduler_Init(taskTable, sizeof(taskTable) / sizeof(taskTable[0]));
+  
   /* Start timers */
   HAL_TIM_Base_Start_IT(&htim2); // System tick for UI refresh
   HAL_TIM_Base_Start_IT(&htim3); // Used for encoder sampling
@@ -236,6 +392,30 @@ static void InitSystem(void)
   #endif
 }
 
+/**
+  * @brief Run the TIM3 input interrupt at ROTARY_SAMPLE_HZ
+  * @note  The polled encoder decoder reads the pins on every period; buttons
+  *        and input events keep their 1 ms tick (HAL_TIM_PeriodElapsedCallback)
+  * @retval None
+  */
+static void SetInputSampleRate(void)
+{
+  uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+  
+  /* APB1 timers run at twice PCLK1 when APB1 is divided */
+  if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1) {
+    timerClock *= 2;
+  }
+  
+  /* Count at 1 MHz */
+  __HAL_TIM_SET_PRESCALER(&htim3, timerClock / 1000000U - 1);
+  __HAL_TIM_SET_AUTORELOAD(&htim3, 1000000U / ROTARY_SAMPLE_HZ - 1);
+  
+  /* Load the prescaler now; the update this raises is not an input tick */
+  htim3.Instance->EGR = TIM_EGR_UG;
+  __HAL_TIM_CLEAR_FLAG(&htim3, TIM_FLAG_UPDATE);
+}
+
 /**
   * @brief Initialize audio subsystem and prepare buffers
   * @retval None
@@ -251,6 +431,9 @@ static void InitAudio(void)
   /* Initialize audio driver and codec */
   AudioDriver_Init();
   
+  /* Prepare the static arena used by the DSP modules for state and scratch */
+  MemoryManager_Init();
+  
   /* Initialize DSP modules */
   AudioProcessing_Init();
   Crossover_Init();
@@ -261,6 +444,10 @@ static void InitAudio(void)
   /* Initialize audio preset system */
   AudioPreset_Init();
   
+  /* Memory layout is fixed from here on */
+  MemoryManager_Lock();
+  MemoryManager_PrintReport();
+  
   /* Start audio streaming */
   AudioDriver_Start();
   
@@ -283,8 +470,14 @@ static void ProcessAudio(void)
     /* Apply audio processing chain */
     AudioProcessing_Process(&inputBuffer, &outputBuffer, &systemSettings);
     
+    /* Publish meters and block time for telemetry */
+    Telemetry_Snapshot();
+    
     /* Send processed samples to output */
     AudioDriver_SendSamples(&outputBuffer);
+    
+    /* Control-rate updates for the next block */
+    EventLoop_Post(EVENT_CONTROL);
   }
 }
 
@@ -294,51 +487,102 @@ static void ProcessAudio(void)
   */
 static void HandleUserInterface(void)
 {
+  InputEvent_t inputEvent;
   ButtonEvent_t buttonEvent;
-  RotaryEvent_t rotaryEvent;
+  int32_t encoderSteps = 0;
   
-  /* Check for button events */
-  if (ButtonHandler_GetEvent(&buttonEvent)) {
+  /* Take every pending input event; consecutive encoder steps are combined
+     so a fast turn becomes one parameter update */
+  while (InputQueue_Pop(&inputEvent)) {
+    UiProbe_EventTaken(&inputEvent);
+    
+    if (inputEvent.source == INPUT_SOURCE_ENCODER) {
+      encoderSteps += inputEvent.value;
+      continue;
+    }
+    
+    /* Apply the rotation before the button that followed it */
+    DispatchEncoderSteps(encoderSteps);
+    encoderSteps = 0;
+    
+    buttonEvent.button = (ButtonID_t)inputEvent.code;
+    buttonEvent.state = (ButtonState_t)inputEvent.state;
+    buttonEvent.holdTime = inputEvent.value;
     UI_HandleButtonEvent(&buttonEvent);
   }
-  
-  /* Check for rotary encoder events */
-  if (RotaryEncoder_GetEvent(&rotaryEvent)) {
-    UI_HandleRotaryEvent(&rotaryEvent);
-  }
+  DispatchEncoderSteps(encoderSteps);
   
   /* Update UI as needed */
   UI_Update();
 }
 
+/**
+  * @brief Pass combined encoder steps to the UI as one rotary event
+  * @param steps Signed steps (clockwise positive), nothing is done for 0
+  * @retval None
+  */
+static void DispatchEncoderSteps(int32_t steps)
+{
+  RotaryEvent_t rotaryEvent;
+  
+  if (steps == 0) {
+    return;
+  }
+  
+  rotaryEvent.direction = (steps > 0) ? ROTARY_CW : ROTARY_CCW;
+  if (steps < 0) {
+    steps = -steps;
+  }
+  rotaryEvent.steps = (steps > 255) ? 255 : steps;
+  UI_HandleRotaryEvent(&rotaryEvent);
+}
+
 /**
   * @brief Save current system settings to flash memory
   * @retval None
   */
 static void SaveCurrentSettings(void)
 {
+  /* Edits still waiting for a control update would be read back stale */
+  ParamUpdate_Flush();
+  
   /* Get current settings from audio modules */
   Crossover_GetSettings(&systemSettings.crossover);
   Compressor_GetSettings(&systemSettings.compressor);
   Limiter_GetSettings(&systemSettings.limiter);
   Delay_GetSettings(&systemSettings.delay);
   
-  /* Save settings to selected preset slot */
-  PresetManager_SavePreset(activePreset, &systemSettings);
-  
-  /* Display confirmation message */
-  LCD_Clear();
-  LCD_SetCursor(0, 0);
-  LCD_Print("Settings saved");
-  LCD_SetCursor(0, 1);
-  LCD_Print("to preset ");
-  LCD_PrintNumber(activePreset);
-  HAL_Delay(1000);
+  /* Save settings to selected preset slot in the background */
+  if (PresetManager_SavePresetAsync(activePreset, &systemSettings, SettingsSaved) != PRESET_STATUS_OK) {
+    UI_ShowMessage("Save failed", "Storage busy", 1000);
+    Menu_ReturnToPrevious();
+    return;
+  }
   
-  /* Return to previous menu */
+  /* Return to previous menu; the confirmation follows when the save completes */
   Menu_ReturnToPrevious();
 }
 
+/**
+  * @brief Completion callback for background settings saves
+  * @param presetId The preset that was saved
+  * @param status PRESET_STATUS_OK or error code
+  * @retval None
+  */
+static void SettingsSaved(uint8_t presetId, uint8_t status)
+{
+  char line2[17];
+  
+  if (status != PRESET_STATUS_OK) {
+    UI_ShowMessage("Save failed", "", 1000);
+    return;
+  }
+  
+  /* Display confirmation message */
+  FixedFormat_Label(line2, sizeof(line2), "to preset ", presetId);
+  UI_ShowMessage("Settings saved", line2, 1000);
+}
+
 /**
   * @brief Load settings from a preset
   * @param presetIndex The preset index to load
@@ -346,54 +590,51 @@ static void SaveCurrentSettings(void)
   */
 static void LoadSettings(uint8_t presetIndex)
 {
-  /* Check if preset is a factory preset or user preset */
-  if (presetIndex < NUM_FACTORY_PRESETS) {
-    /* Load factory preset */
-    FactoryPresets_GetPreset(presetIndex, &systemSettings);
-  } else {
-    /* Load user preset from storage */
-    PresetManager_LoadPreset(presetIndex, &systemSettings);
-  }
+  /* Start from the current settings so fields a preset does not cover are kept */
+  SystemSettings_t newSettings;
+  memcpy(&newSettings, &systemSettings, sizeof(SystemSettings_t));
+  ReadPreset(presetIndex, &newSettings);
+  
+  /* A direct load ends any morph in progress */
+  PresetMorph_Stop();
   
-  /* Apply loaded settings to all audio modules */
-  Crossover_SetSettings(&systemSettings.crossover);
-  Compressor_SetSettings(&systemSettings.compressor);
-  Limiter_SetSettings(&systemSettings.limiter);
-  Delay_SetSettings(&systemSettings.delay);
+  /* Apply loaded settings to the dynamics and delay modules */
+  Compressor_SetSettings(&newSettings.compressor);
+  Limiter_SetSettings(&newSettings.limiter);
+  Delay_SetSettings(&newSettings.delay);
+  
+  /* The crossover state is built on the standby instance and crossfaded in;
+     systemSettings is replaced by the audio chain when the fade completes */
+  AudioProcessing_StartCrossfade(&newSettings, AUDIO_CROSSFADE_DEFAULT_MS);
   
   /* Store active preset index */
   activePreset = presetIndex;
   
-  /* Display confirmation message */
-  LCD_Clear();
-  LCD_SetCursor(0, 0);
-  LCD_Print("Preset loaded:");
-  LCD_SetCursor(0, 1);
-  
   /* Show preset name based on index */
+  char presetName[17];
   switch (presetIndex) {
     case PRESET_DEFAULT:
-      LCD_Print("Default (Flat)");
+      strcpy(presetName, "Default (Flat)");
       break;
     case PRESET_ROCK:
-      LCD_Print("Rock");
+      strcpy(presetName, "Rock");
       break;
     case PRESET_JAZZ:
-      LCD_Print("Jazz");
+      strcpy(presetName, "Jazz");
       break;
     case PRESET_DANGDUT:
-      LCD_Print("Dangdut");
+      strcpy(presetName, "Dangdut");
       break;
     case PRESET_POP:
-      LCD_Print("Pop");
+      strcpy(presetName, "Pop");
       break;
     default:
-      LCD_Print("User preset ");
-      LCD_PrintNumber(presetIndex);
+      FixedFormat_Label(presetName, sizeof(presetName), "User preset ", presetIndex);
       break;
   }
   
-  HAL_Delay(1000);
+  /* Display confirmation message */
+  UI_QueueMessage("Preset loaded:", presetName, 1000);
   
   /* Return to previous menu if not during init */
   if (systemState != SYSTEM_STATE_INITIALIZING) {
@@ -401,6 +642,51 @@ static void LoadSettings(uint8_t presetIndex)
   }
 }
 
+/**
+  * @brief Glide from the current settings to a preset over MORPH_DEFAULT_TIME_MS
+  * @param presetIndex The preset index to morph to
+  * @retval None
+  */
+static void MorphToPreset(uint8_t presetIndex)
+{
+  /* The morph works on the active crossover instance; finish a crossfade first */
+  if (AudioProcessing_IsCrossfading()) {
+    LoadSettings(presetIndex);
+    return;
+  }
+  
+  SystemSettings_t targetSettings;
+  memcpy(&targetSettings, &systemSettings, sizeof(SystemSettings_t));
+  ReadPreset(presetIndex, &targetSettings);
+  
+  PresetMorph_Start(&systemSettings, &targetSettings, MORPH_DEFAULT_TIME_MS);
+  activePreset = presetIndex;
+  
+  UI_ShowMessage("Morphing to", "selected preset", 1000);
+  
+  if (systemState != SYSTEM_STATE_INITIALIZING) {
+    Menu_ReturnToPrevious();
+  }
+}
+
+/**
+  * @brief Read the settings of a factory or user preset
+  * @param presetIndex The preset index to read
+  * @param settings Settings structure to fill
+  * @retval None
+  */
+static void ReadPreset(uint8_t presetIndex, SystemSettings_t *settings)
+{
+  /* Check if preset is a factory preset or user preset */
+  if (presetIndex < NUM_FACTORY_PRESETS) {
+    /* Load factory preset */
+    FactoryPresets_GetPreset(presetIndex, settings);
+  } else {
+    /* Load user preset from storage */
+    PresetManager_LoadPreset(presetIndex, settings);
+  }
+}
+
 /**
   * @brief  This function is executed in case of error occurrence.
   * @retval None
@@ -413,6 +699,7 @@ void Error_Handler(void)
   LCD_Print("System Error!");
   LCD_SetCursor(0, 1);
   LCD_Print("Please restart");
+  LCD_Flush();
   
   /* Turn on error LED if available */
   HAL_GPIO_WritePin(ERROR_LED_GPIO_Port, ERROR_LED_Pin, GPIO_PIN_SET);
@@ -436,20 +723,40 @@ void Error_Handler(void)
   */
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
+  StackMonitor_EnterISR();
+  
   /* Timer for system tick */
   if (htim->Instance == TIM2) {
     systemTick++;
+    EventLoop_Post(EVENT_TICK);
     
     /* Update UI refresh at appropriate rate */
     if (systemTick % UI_REFRESH_INTERVAL == 0) {
       UI_NeedsRefresh();
+      EventLoop_Post(EVENT_UI);
     }
+    
+    /* Resume the LCD transport after a slow command */
+    LCD_TimerTick();
   }
   /* Timer for encoder sampling */
   else if (htim->Instance == TIM3) {
-    RotaryEncoder_Sample();
-    ButtonHandler_Sample();
+    RotaryEncoder_SamplePins();
+    
+    /* Collect and queue the input every 1 ms */
+    if (++inputSampleCount >= ROTARY_SAMPLE_HZ / 1000) {
+      inputSampleCount = 0;
+      RotaryEncoder_Sample();
+      ButtonHandler_Sample();
+      
+      /* Wake the main loop only when there is input to handle */
+      if (!InputQueue_IsEmpty()) {
+        EventLoop_Post(EVENT_INPUT);
+      }
+    }
   }
+  
+  StackMonitor_ExitISR();
 }
 
 /**
@@ -459,9 +766,14 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
   */
 void HAL_I2S_RxCpltCallback(I2S_HandleTypeDef *hi2s)
 {
+  StackMonitor_EnterISR();
+  
   if (hi2s->Instance == I2S2) {
     AudioDriver_NotifyInputReady();
+    EventLoop_Post(EVENT_AUDIO);
   }
+  
+  StackMonitor_ExitISR();
 }
 
 /**
@@ -471,9 +783,48 @@ void HAL_I2S_RxCpltCallback(I2S_HandleTypeDef *hi2s)
   */
 void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s)
 {
+  StackMonitor_EnterISR();
+  
   if (hi2s->Instance == I2S3) {
     AudioDriver_NotifyOutputComplete();
   }
+  
+  StackMonitor_ExitISR();
+}
+
+/**
+  * @brief  I2C master TX Transfer completed callback
+  * @param  hi2c I2C handle
+  * @retval None
+  */
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  StackMonitor_EnterISR();
+  
+  if (hi2c->Instance == I2C1) {
+    LCD_TransferComplete();
+    
+    /* Queue space freed: cells that did not fit go out with the next flush */
+    EventLoop_Post(EVENT_UI);
+  }
+  
+  StackMonitor_ExitISR();
+}
+
+/**
+  * @brief  I2C error callback
+  * @param  hi2c I2C handle
+  * @retval None
+  */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  StackMonitor_EnterISR();
+  
+  if (hi2c->Instance == I2C1) {
+    LCD_TransferError();
+  }
+  
+  StackMonitor_ExitISR();
 }
 
 /* Define the system state constants used in the above code */
@@ -192,17 +192,17 @@ void GPIO_ConfigurePeripherals(void)
   HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
   
   /*--------------------- I2C1 GPIO Configuration --------------------------*/
-  /* I2C1_SCL pin configuration : PB6 */
-  GPIO_InitStruct.Pin = GPIO_PIN_6;
+  /* I2C1_SCL pin configuration : PB6 (PB8 with ROTARY_USE_TIMER) */
+  GPIO_InitStruct.Pin = LCD_SCL_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
   GPIO_InitStruct.Pull = GPIO_PULLUP;
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
   GPIO_InitStruct.Alternate = GPIO_AF4_I2C1;
-  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+  HAL_GPIO_Init(LCD_I2C_GPIO_Port, &GPIO_InitStruct);
   
-  /* I2C1_SDA pin configuration : PB7 */
-  GPIO_InitStruct.Pin = GPIO_PIN_7;
-  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+  /* I2C1_SDA pin configuration : PB7 (PB9 with ROTARY_USE_TIMER) */
+  GPIO_InitStruct.Pin = LCD_SDA_Pin;
+  HAL_GPIO_Init(LCD_I2C_GPIO_Port, &GPIO_InitStruct);
   
   /*--------------------- SPI1 GPIO Configuration --------------------------*/
   /* SPI1_SCK pin configuration : PA5 */
@@ -0,0 +1,91 @@
+ /**
+  ******************************************************************************
+  * @file           : flash_sim.h
+  * @brief          : Header for flash_sim.c file.
+  *                   Simulated preset flash with power-cut injection, linked
+  *                   by the tests in place of flash_storage.c.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FLASH_SIM_H
+#define __FLASH_SIM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_storage.h"
+#include "preset_journal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The simulated range covers both journal sectors */
+#define FLASH_SIM_BASE             JOURNAL_BASE_ADDR
+#define FLASH_SIM_SIZE             (JOURNAL_NUM_SECTORS * JOURNAL_SECTOR_SIZE)
+
+/* Flash_PollErase() calls until a started erase ends */
+#define FLASH_SIM_ERASE_POLLS      5
+
+/* Exported variables --------------------------------------------------------*/
+extern uint8_t flashSim[FLASH_SIM_SIZE];
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Fill the whole simulated flash and restore power
+  * @param  value Byte value (0xFF for erased)
+  * @retval None
+  */
+void FlashSim_Reset(uint8_t value);
+
+/**
+  * @brief  Cut the power after a number of programmed bytes
+  * @note   An erase started with no bytes left is cut halfway through
+  * @param  bytes Bytes that still get programmed, -1 for no cut
+  * @retval None
+  */
+void FlashSim_CutPowerAfter(long bytes);
+
+/**
+  * @brief  Fail one write after a number of programmed bytes, with power kept
+  * @note   The write returns an error with the bytes before the failure
+  *         programmed; later accesses work again
+  * @param  bytes Bytes that still get programmed, -1 for no failure
+  * @retval None
+  */
+void FlashSim_FailWriteAfter(long bytes);
+
+/**
+  * @brief  Restore power after a cut (the next mount sees the flash as it was left)
+  * @retval None
+  */
+void FlashSim_PowerOn(void);
+
+/**
+  * @brief  Check whether the power was cut
+  * @retval 1 if cut, 0 otherwise
+  */
+uint8_t FlashSim_PowerLost(void);
+
+/**
+  * @brief  Get the number of erases since the last reset
+  * @retval Erase count
+  */
+uint32_t FlashSim_GetEraseCount(void);
+
+/**
+  * @brief  Check whether an erase was started and has not ended yet
+  * @retval 1 if an erase is running, 0 otherwise
+  */
+uint8_t FlashSim_ErasePending(void);
+
+#endif /* __FLASH_SIM_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
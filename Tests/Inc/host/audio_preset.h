@@ -0,0 +1,28 @@
+ /**
+  ******************************************************************************
+  * @file           : audio_preset.h
+  * @brief          : Host stand-in: nothing of it is used by the tested modules
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __AUDIO_PRESET_H
+#define __AUDIO_PRESET_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+#endif /* __AUDIO_PRESET_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,35 @@
+ /**
+  ******************************************************************************
+  * @file           : compressor.h
+  * @brief          : Host stand-in for compressor.h with the interface that
+  *                   audio_processing.c calls (see crossover.h here)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __COMPRESSOR_H
+#define __COMPRESSOR_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Compressor_Process(float* left, float* right, uint16_t size,
+                        float threshold, float ratio, float attack, float release,
+                        float makeupGain, int band, float* compressionAmount);
+void Compressor_Reset(void);
+
+#endif /* __COMPRESSOR_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,56 @@
+ /**
+  ******************************************************************************
+  * @file           : crossover.h
+  * @brief          : Host stand-in for crossover.h with the interface that
+  *                   audio_processing.c calls
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * audio_processing.c splits both channels in one Crossover_Process call and
+  * passes the band settings along, an interface that neither App/Inc nor the
+  * DSP modules match yet. The same holds for the compressor, limiter and
+  * delay, whose stand-ins sit next to this file. The audio processing test
+  * builds against these declarations and implements them itself; only that
+  * test puts this directory on the include path.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CROSSOVER_H
+#define __CROSSOVER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define FILTER_ORDER_12DB          2
+#define FILTER_ORDER_24DB          4
+#define FILTER_ORDER_48DB          8
+
+#define CROSSOVER_NUM_INSTANCES    2
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Crossover_SelectInstance(uint8_t instance);
+uint8_t Crossover_GetInstance(void);
+void Crossover_Process(float* inputL, float* inputR, uint16_t size,
+                       float* subL, float* subR, float* lowL, float* lowR,
+                       float* midL, float* midR, float* highL, float* highR,
+                       CrossoverSettings_t* settings);
+void Crossover_SetSettings(CrossoverSettings_t* settings);
+void Crossover_SetOrderLimit(uint8_t maxOrder);
+void Crossover_Reset(void);
+
+#endif /* __CROSSOVER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
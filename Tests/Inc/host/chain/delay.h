@@ -0,0 +1,47 @@
+ /**
+  ******************************************************************************
+  * @file           : delay.h
+  * @brief          : Host stand-in for delay.h with the interface that
+  *                   audio_processing.c calls (see crossover.h here)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DELAY_H
+#define __DELAY_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* As in App/Inc/delay.h; main.h takes the type from here */
+typedef struct DelaySettings_t {
+    float subDelay;
+    float lowDelay;
+    float midDelay;
+    float highDelay;
+    uint8_t subPhaseInvert;
+    uint8_t lowPhaseInvert;
+    uint8_t midPhaseInvert;
+    uint8_t highPhaseInvert;
+} DelaySettings_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Delay_Process(float* left, float* right, uint16_t size,
+                   float delayMs, uint8_t phaseInvert, int band);
+void Delay_Reset(void);
+
+#endif /* __DELAY_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,34 @@
+ /**
+  ******************************************************************************
+  * @file           : limiter.h
+  * @brief          : Host stand-in for limiter.h with the interface that
+  *                   audio_processing.c calls (see crossover.h here)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LIMITER_H
+#define __LIMITER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Limiter_Process(float* left, float* right, uint16_t size,
+                     float threshold, float release, int band, float* gainReduction);
+void Limiter_Reset(void);
+
+#endif /* __LIMITER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
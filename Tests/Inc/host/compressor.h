@@ -0,0 +1,35 @@
+ /**
+  ******************************************************************************
+  * @file           : compressor.h
+  * @brief          : Host stand-in: the compressor settings type (main.h)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __COMPRESSOR_H
+#define __COMPRESSOR_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct CompressorSettings_t CompressorSettings_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Compressor_SetSettings(const CompressorSettings_t* settings);
+void Compressor_GetSettings(CompressorSettings_t* settings);
+
+#endif /* __COMPRESSOR_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,67 @@
+ /**
+  ******************************************************************************
+  * @file           : crossover.h
+  * @brief          : Host stand-in for crossover.h with the interface that
+  *                   crossover.c implements
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * App/Inc/crossover.h declares an older interface (its own biquad layout, a
+  * five-buffer Crossover_Process) that crossover.c no longer matches, so the
+  * crossover test builds against these declarations instead. Only that test
+  * puts this directory on the include path.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CROSSOVER_H
+#define __CROSSOVER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define FILTER_TYPE_BUTTERWORTH    0
+#define FILTER_TYPE_LINKWITZ_RILEY 1
+
+#define FILTER_ORDER_12DB          2
+#define FILTER_ORDER_24DB          4
+#define FILTER_ORDER_48DB          8
+
+#define CROSSOVER_POINT_LOW        0
+#define CROSSOVER_POINT_MID        1
+#define CROSSOVER_POINT_HIGH       2
+#define CROSSOVER_NUM_POINTS       3
+
+#define CROSSOVER_NUM_INSTANCES    2
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Crossover_Init(void);
+void Crossover_SelectInstance(uint8_t instance);
+uint8_t Crossover_GetInstance(void);
+void Crossover_Process(float* input, float* subOut, float* lowOut, float* midOut, float* highOut,
+                       float* output, uint16_t size);
+void Crossover_ProcessI16(int16_t* input, int16_t* output, uint16_t size);
+void Crossover_SetSettings(CrossoverSettings_t* settings);
+void Crossover_UpdateCoefficients(CrossoverSettings_t* settings);
+void Crossover_SetCutoff(uint8_t point, float frequency);
+void Crossover_SetGain(uint8_t band, float gainDB);
+void Crossover_SetMute(uint8_t band, uint8_t mute);
+void Crossover_GetSettings(CrossoverSettings_t* settings);
+void Crossover_SetSampleRate(float sampleRate);
+void Crossover_SetOrderLimit(uint8_t maxOrder);
+
+#endif /* __CROSSOVER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,34 @@
+ /**
+  ******************************************************************************
+  * @file           : factory_presets.h
+  * @brief          : Host stand-in: factory preset lookups, implemented by each test
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FACTORY_PRESETS_H
+#define __FACTORY_PRESETS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "preset_manager.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint8_t FactoryPresets_GetPreset(uint8_t presetId, PresetSettings_t* settings);
+const char* FactoryPresets_GetName(uint8_t presetId);
+void FactoryPresets_Load(uint8_t presetId);
+
+#endif /* __FACTORY_PRESETS_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,29 @@
+ /**
+  ******************************************************************************
+  * @file           : gpio.h
+  * @brief          : Host stand-in: the CubeMX GPIO init header (nothing the
+  *                   tests call)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GPIO_H__
+#define __GPIO_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+#endif /* __GPIO_H__ */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,31 @@
+ /**
+  ******************************************************************************
+  * @file           : i2c.h
+  * @brief          : Host stand-in: the CubeMX I2C init header (the LCD handle)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __I2C_H__
+#define __I2C_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported variables --------------------------------------------------------*/
+extern I2C_HandleTypeDef hi2c1;
+
+#endif /* __I2C_H__ */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
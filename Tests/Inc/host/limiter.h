@@ -0,0 +1,35 @@
+ /**
+  ******************************************************************************
+  * @file           : limiter.h
+  * @brief          : Host stand-in: the limiter settings type (main.h)
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LIMITER_H
+#define __LIMITER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct LimiterSettings_t LimiterSettings_t;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Limiter_SetSettings(const LimiterSettings_t* settings);
+void Limiter_GetSettings(LimiterSettings_t* settings);
+
+#endif /* __LIMITER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,193 @@
+ /**
+  ******************************************************************************
+  * @file           : main.h
+  * @brief          : Host stand-in for Core/Inc/main.h used by the tests.
+  *                   Same contents, except that the delay settings come from
+  *                   delay.h (the device header defines them in both places,
+  *                   so the two cannot be included together) and the settings
+  *                   types get the typedef names preset_manager.h uses.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Audio buffer structure
+  */
+typedef struct {
+    int16_t data[256]; /* Size defined by AUDIO_BUFFER_SIZE in main.c */
+} AudioBuffer_t;
+
+#include "delay.h"
+
+/**
+  * @brief  System settings structure that contains all DSP settings
+  */
+typedef struct {
+    struct CrossoverSettings_t {
+        /* Crossover frequency points */
+        float lowCutoff;   /* Frequency between Sub and Low bands */
+        float midCutoff;   /* Frequency between Low and Mid bands */
+        float highCutoff;  /* Frequency between Mid and High bands */
+        
+        /* Gain for each band in dB */
+        float subGain;
+        float lowGain;
+        float midGain;
+        float highGain;
+        
+        /* Filter types (0: Butterworth, 1: Linkwitz-Riley) */
+        uint8_t filterType;
+        
+        /* Filter orders */
+        uint8_t filterOrder;
+        
+        /* Band mute status (1: muted, 0: active) */
+        uint8_t subMute;
+        uint8_t lowMute;
+        uint8_t midMute;
+        uint8_t highMute;
+    } crossover;
+    
+    struct CompressorSettings_t {
+        /* Settings for each band */
+        struct CompressorBandSettings_t {
+            float threshold;  /* dB, typically -60 to 0 */
+            float ratio;      /* ratio, typically 1 to 20 */
+            float attack;     /* ms, typically 0.1 to 100 */
+            float release;    /* ms, typically 10 to 1000 */
+            float makeupGain; /* dB, typically 0 to 20 */
+            uint8_t enabled;  /* 1: enabled, 0: bypassed */
+        } sub, low, mid, high;
+    } compressor;
+    
+    struct LimiterSettings_t {
+        /* Settings for each band */
+        struct LimiterBandSettings_t {
+            float threshold;  /* dB, typically -20 to 0 */
+            float release;    /* ms, typically 10 to 1000 */
+            uint8_t enabled;  /* 1: enabled, 0: bypassed */
+        } sub, low, mid, high;
+    } limiter;
+    
+    DelaySettings_t delay;
+    
+    /* Add any additional module settings here */
+} SystemSettings_t;
+
+typedef struct CrossoverSettings_t CrossoverSettings_t;
+
+/* Exported constants --------------------------------------------------------*/
+/* System state definitions */
+#define SYSTEM_STATE_NORMAL          0
+#define SYSTEM_STATE_INITIALIZING    1
+#define SYSTEM_STATE_SAVE_SETTINGS   2
+#define SYSTEM_STATE_LOAD_PRESET     3
+#define SYSTEM_STATE_MORPH_PRESET    4
+
+/* Preset indices */
+#define PRESET_DEFAULT    0
+#define PRESET_ROCK       1
+#define PRESET_JAZZ       2
+#define PRESET_DANGDUT    3
+#define PRESET_POP        4
+#define NUM_FACTORY_PRESETS 5
+
+/* UI constants */
+#define UI_REFRESH_INTERVAL 10  /* refresh UI every 10 ticks */
+
+/* Audio buffer size */
+#define AUDIO_BUFFER_SIZE 256  /* Must be a multiple of 2 and 4 for stereo processing */
+
+/* Audio sample rate (DEFAULT_AUDIO_SAMPLE_RATE of i2s_config.h) and the time
+   one block of AUDIO_BUFFER_SIZE / 2 frames lasts */
+#define AUDIO_SAMPLE_RATE_HZ 48000
+#define AUDIO_BLOCK_PERIOD_US ((AUDIO_BUFFER_SIZE / 2) * 1000000UL / AUDIO_SAMPLE_RATE_HZ)
+
+/* Error LED */
+#define ERROR_LED_Pin GPIO_PIN_13
+#define ERROR_LED_GPIO_Port GPIOC
+
+/* Front panel buttons, active low (Hardware/Src/gpio_config.c) */
+#define MENU_BTN_Pin GPIO_PIN_0
+#define MENU_BTN_GPIO_Port GPIOA
+#define BACK_BTN_Pin GPIO_PIN_1
+#define BACK_BTN_GPIO_Port GPIOA
+#define ENC_BTN_Pin GPIO_PIN_2
+#define ENC_BTN_GPIO_Port GPIOA
+#define PRESET1_BTN_Pin GPIO_PIN_3
+#define PRESET1_BTN_GPIO_Port GPIOA
+#define PRESET2_BTN_Pin GPIO_PIN_4
+#define PRESET2_BTN_GPIO_Port GPIOA
+#define PRESET3_BTN_Pin GPIO_PIN_5
+#define PRESET3_BTN_GPIO_Port GPIOA
+
+/* Debug output control */
+#ifdef DEBUG
+#define DEBUG_PRINT(x) printf(x)
+#define DEBUG_PRINTF(format, ...) printf(format, ##__VA_ARGS__)
+#else
+#define DEBUG_PRINT(x)
+#define DEBUG_PRINTF(format, ...)
+#endif
+
+/* Exported macros -----------------------------------------------------------*/
+/* Safe min and max macros */
+#define MIN(a,b) (((a)<(b))?(a):(b))
+#define MAX(a,b) (((a)>(b))?(a):(b))
+#define CLAMP(x, low, high) (((x) > (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
+
+/* dB to linear and linear to dB conversion */
+#define DB_TO_LINEAR(x) (powf(10.0f, (x) / 20.0f))
+#define LINEAR_TO_DB(x) (20.0f * log10f(MAX((x), 0.00001f)))
+
+/* Exported functions prototypes ---------------------------------------------*/
+void Error_Handler(void);
+
+/* External variables --------------------------------------------------------*/
+/* HAL handlers declared in their respective files */
+extern I2C_HandleTypeDef hi2c1;
+extern I2S_HandleTypeDef hi2s2;
+extern I2S_HandleTypeDef hi2s3;
+extern SPI_HandleTypeDef hspi1;
+extern TIM_HandleTypeDef htim2;
+extern TIM_HandleTypeDef htim3;
+extern UART_HandleTypeDef huart1;
+extern DMA_HandleTypeDef hdma_spi2_rx;
+extern DMA_HandleTypeDef hdma_spi3_tx;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
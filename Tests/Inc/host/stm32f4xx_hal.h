@@ -0,0 +1,151 @@
+ /**
+  ******************************************************************************
+  * @file           : stm32f4xx_hal.h
+  * @brief          : Host stand-in for the STM32F4 HAL used by the tests.
+  *                   Declares the handles, registers and calls the
+  *                   application modules use; host_hal.c implements them.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STM32F4XX_HAL_H
+#define __STM32F4XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+  HAL_OK = 0,
+  HAL_ERROR,
+  HAL_BUSY,
+  HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum {
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct { uint32_t IDR; uint32_t ODR; } GPIO_TypeDef;
+typedef struct { uint32_t dummy; } I2C_HandleTypeDef;
+typedef struct { uint32_t dummy; } I2S_HandleTypeDef;
+typedef struct { uint32_t dummy; } SPI_HandleTypeDef;
+typedef struct { uint32_t dummy; } TIM_HandleTypeDef;
+typedef enum {
+  HAL_UART_STATE_RESET = 0,
+  HAL_UART_STATE_READY,
+  HAL_UART_STATE_BUSY_TX,
+  HAL_UART_STATE_BUSY_RX
+} HAL_UART_StateTypeDef;
+
+/* Circular DMA stream: remaining counts down to 1 and reloads with size */
+typedef struct {
+  uint8_t* buffer;
+  uint32_t size;
+  volatile uint32_t remaining;
+} DMA_HandleTypeDef;
+
+typedef struct {
+  DMA_HandleTypeDef* hdmarx;
+  volatile HAL_UART_StateTypeDef gState;    /* Transmit side */
+  volatile HAL_UART_StateTypeDef RxState;
+} UART_HandleTypeDef;
+
+/* Cycle counter, advanced by the tests */
+typedef struct { volatile uint32_t CTRL; volatile uint32_t CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+
+/* Exported constants --------------------------------------------------------*/
+#define GPIO_PIN_0                 ((uint16_t)0x0001)
+#define GPIO_PIN_1                 ((uint16_t)0x0002)
+#define GPIO_PIN_2                 ((uint16_t)0x0004)
+#define GPIO_PIN_3                 ((uint16_t)0x0008)
+#define GPIO_PIN_4                 ((uint16_t)0x0010)
+#define GPIO_PIN_5                 ((uint16_t)0x0020)
+#define GPIO_PIN_13                ((uint16_t)0x2000)
+
+#define __HAL_DMA_GET_COUNTER(h)  ((h)->remaining)
+
+#define CoreDebug_DEMCR_TRCENA_Msk 0x01000000UL
+#define DWT_CTRL_CYCCNTENA_Msk     0x00000001UL
+
+/* Exported variables --------------------------------------------------------*/
+extern GPIO_TypeDef hostGpioA;
+extern GPIO_TypeDef hostGpioB;
+extern GPIO_TypeDef hostGpioC;
+extern DWT_Type hostDwt;
+extern CoreDebug_Type hostCoreDebug;
+extern uint32_t SystemCoreClock;
+
+/* Called by __WFI(): a test with simulated time lets it pass until the next
+   interrupt */
+extern void (*Host_WfiHook)(void);
+
+/* Called with each frame HAL_UART_Transmit_DMA() sends; the transfer is
+   complete on return */
+extern void (*Host_UartTxHook)(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size);
+
+#define GPIOA                      (&hostGpioA)
+#define GPIOB                      (&hostGpioB)
+#define GPIOC                      (&hostGpioC)
+#define DWT                        (&hostDwt)
+#define CoreDebug                  (&hostCoreDebug)
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* port, uint16_t pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+void __DSB(void);
+void __DMB(void);
+void __WFI(void);
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size);
+
+/**
+  * @brief  Advance the HAL tick (and the cycle counter with it)
+  * @param  ms Milliseconds to advance
+  * @retval None
+  */
+void Host_AdvanceTick(uint32_t ms);
+
+/**
+  * @brief  Receive bytes on a UART as its circular DMA would
+  * @note   Bytes arriving with reception stopped are lost
+  * @param  huart UART handle
+  * @param  data  Received bytes
+  * @param  size  Number of bytes
+  * @retval None
+  */
+void Host_UartReceive(UART_HandleTypeDef* huart, const uint8_t* data, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F4XX_HAL_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,70 @@
+ /**
+  ******************************************************************************
+  * @file           : ui_manager.h
+  * @brief          : Host stand-in for the UI coordinator (ui_manager.h is not
+  *                   part of this source tree): the button roles and menu
+  *                   calls user_interface.c and menu_system.c use
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __UI_MANAGER_H
+#define __UI_MANAGER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "button_handler.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define NUM_BUTTONS                MAX_BUTTONS
+
+/* Button states */
+#define BUTTON_PRESSED             BUTTON_STATE_PRESSED
+#define BUTTON_RELEASED            BUTTON_STATE_RELEASED
+#define BUTTON_HELD                BUTTON_STATE_HELD
+
+/* Button roles on the six front panel keys */
+#define BUTTON_OK                  BUTTON_ENCODER
+#define BUTTON_HOME                BUTTON_MENU
+#define BUTTON_VOLUME              BUTTON_MENU
+#define BUTTON_PRESET              BUTTON_PRESET_1
+#define BUTTON_BAND                BUTTON_PRESET_2
+#define BUTTON_MUTE                BUTTON_PRESET_3
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* Implemented by menu_system.c */
+void Menu_HandleRotary(int8_t direction);
+void Menu_HandleButton(uint8_t buttonId);
+
+/* Implemented by ui_manager_host.c on top of the calls above */
+void Menu_Next(void);
+void Menu_Previous(void);
+void Menu_Select(void);
+void Menu_Back(void);
+void Menu_Refresh(void);
+void Menu_RefreshCurrent(void);
+void Menu_ShowPresetMenu(void);
+uint8_t Menu_GetItemCount(void);
+const char* Menu_GetItemText(uint8_t index);
+void Menu_SelectItem(uint8_t index);
+
+/* Preset calls of menu_system.c that preset_manager.h does not declare
+   (defined by the program that links the menus) */
+uint8_t PresetManager_GetNumUserPresets(void);
+void PresetManager_SaveUserPreset(uint8_t index);
+void PresetManager_LoadUserPreset(uint8_t index);
+
+#endif /* __UI_MANAGER_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
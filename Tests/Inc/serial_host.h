@@ -0,0 +1,50 @@
+ /**
+  ******************************************************************************
+  * @file           : serial_host.h
+  * @brief          : Host stand-ins for the modules the serial protocol calls
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SERIAL_HOST_H
+#define __SERIAL_HOST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "audio_processing.h"
+
+/* Exported variables --------------------------------------------------------*/
+/* Returned by AudioProcessing_GetStats() */
+extern AudioProcessingStats_t serialHostAudioStats;
+
+/* PresetMorph_IsActive() result */
+extern uint8_t serialHostMorphActive;
+
+/* PARAM_DIRTY_* flags passed to ParamUpdate_Mark() since the last reset */
+extern uint16_t serialHostDirty;
+
+/* Last values set through the protocol */
+extern uint32_t serialHostTestLoadUs;
+extern uint16_t serialHostTelemetryRate;
+
+/* Exported functions prototypes ---------------------------------------------*/
+/**
+  * @brief  Clear the recorded calls and statistics
+  * @retval None
+  */
+void SerialHost_Reset(void);
+
+#endif /* __SERIAL_HOST_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -1 +1,71 @@
- 
+ /**
+  ******************************************************************************
+  * @file           : test_framework.h
+  * @brief          : Minimal assertion and test runner macros for the host
+  *                   tests. Each test program includes this header once.
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TEST_FRAMEWORK_H
+#define __TEST_FRAMEWORK_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Private variables ---------------------------------------------------------*/
+static int testsRun = 0;
+static int testsFailed = 0;
+static int testFailedNow = 0;
+
+/* Exported macro ------------------------------------------------------------*/
+/* Fail the current test and leave it */
+#define TEST_ASSERT(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("  %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      testFailedNow = 1; \
+      return; \
+    } \
+  } while (0)
+
+/* Fail the current test with a formatted message and leave it */
+#define TEST_FAIL(...) \
+  do { \
+    printf("  %s:%d: ", __FILE__, __LINE__); \
+    printf(__VA_ARGS__); \
+    printf("\n"); \
+    testFailedNow = 1; \
+    return; \
+  } while (0)
+
+/* Run one test function (void name(void)) */
+#define RUN_TEST(test) \
+  do { \
+    testFailedNow = 0; \
+    testsRun++; \
+    test(); \
+    if (testFailedNow) { \
+      testsFailed++; \
+    } \
+    printf("%s %s\n", testFailedNow ? "FAIL" : "ok  ", #test); \
+  } while (0)
+
+/* Print the summary; use as the return value of main() */
+#define TEST_REPORT() \
+  (printf("%d tests, %d failed\n", testsRun, testsFailed), (testsFailed != 0) ? 1 : 0)
+
+#endif /* __TEST_FRAMEWORK_H */
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
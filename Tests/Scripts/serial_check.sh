@@ -0,0 +1,59 @@
+#!/bin/sh
+# Runs Tools/serial_client.py against the serial protocol simulator on a pty:
+# parameters, statistics and a preset export/import round trip, once on a
+# clean line and once with every Nth received byte damaged, where the
+# client has to retry.
+#
+#   serial_check.sh SIM CLIENT WORKDIR [N]
+set -e
+
+SIM=$1
+CLIENT=$2
+WORK=$3
+CORRUPT=${4:-211}     # Longer than any request frame, so a retry gets through
+
+check_run() {
+    rm -rf "$WORK"
+    mkdir -p "$WORK"
+    "$SIM" "$@" > "$WORK/sim.log" &
+    pid=$!
+    trap 'kill $pid 2>/dev/null' EXIT
+    while [ ! -s "$WORK/sim.log" ]; do sleep 0.05; done
+    pty=$(head -n 1 "$WORK/sim.log")
+    client() { python3 "$CLIENT" "$pty" "$@"; }
+
+    client ping
+    test "$(client set xo.midCutoff 1200)" = "1200.000"
+    test "$(client get xo.midCutoff)" = "1200.000"
+    client stats > /dev/null
+    client tasks > /dev/null
+
+    # Factory preset 3 exported, imported as user preset 7, read back
+    client export "$WORK/factory" --id 3
+    client import "$WORK/factory/preset_3.bin" --id 7
+    tries=0
+    until client list | grep -q "^  7  Studio$"; do
+        tries=$((tries + 1)); test $tries -lt 20; sleep 0.1
+    done
+    client export "$WORK/user" --id 7
+    cmp "$WORK/factory/preset_3.bin" "$WORK/user/preset_7.bin"
+    client delete 7
+    if client list | grep -q "^  7 "; then
+        echo "preset 7 still listed after delete"; exit 1
+    fi
+
+    kill $pid
+    wait $pid || true
+    trap - EXIT
+    tail -n 1 "$WORK/sim.log"
+}
+
+echo "-- clean line"
+check_run
+grep -q "CRC errors 0," "$WORK/sim.log"
+
+echo "-- every ${CORRUPT}th byte damaged"
+check_run --corrupt "$CORRUPT"
+if grep -q "CRC errors 0, framing errors 0$" "$WORK/sim.log"; then
+    echo "no damaged frame seen"; exit 1
+fi
@@ -0,0 +1,196 @@
+ /**
+  ******************************************************************************
+  * @file           : flash_sim.c
+  * @brief          : Simulated preset flash with power-cut injection
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Implements the flash_storage.h calls over a RAM image of the two journal
+  * sectors with NOR semantics: programming only clears bits, an erase sets
+  * the whole sector to 0xFF. An erase started with Flash_BeginErase() stays
+  * busy for FLASH_SIM_ERASE_POLLS calls of Flash_PollErase(). After a power
+  * cut every access fails until FlashSim_PowerOn(), like a device that has
+  * lost its supply.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_sim.h"
+
+/* Private variables ---------------------------------------------------------*/
+uint8_t flashSim[FLASH_SIM_SIZE];
+
+static long powerBudget = -1;
+static long writeFailBudget = -1;
+static uint8_t powerLost = 0;
+static uint32_t eraseCount = 0;
+static long erasePending = -1;          /* Offset of the sector being erased */
+static uint32_t erasePolls = 0;         /* Polls left until it ends */
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t InRange(uint32_t address, uint32_t length)
+{
+  return address >= FLASH_SIM_BASE && address - FLASH_SIM_BASE + length <= FLASH_SIM_SIZE;
+}
+
+/* Accesses during an erase wait for it, like the SPI-NOR backend */
+static void FinishErase(void)
+{
+  if (erasePending >= 0) {
+    memset(&flashSim[erasePending], 0xFF, JOURNAL_SECTOR_SIZE);
+    erasePending = -1;
+  }
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+void FlashSim_Reset(uint8_t value)
+{
+  memset(flashSim, value, sizeof(flashSim));
+  FlashSim_PowerOn();
+  eraseCount = 0;
+  erasePending = -1;
+}
+
+void FlashSim_CutPowerAfter(long bytes)
+{
+  powerBudget = bytes;
+}
+
+void FlashSim_FailWriteAfter(long bytes)
+{
+  writeFailBudget = bytes;
+}
+
+void FlashSim_PowerOn(void)
+{
+  powerBudget = -1;
+  writeFailBudget = -1;
+  powerLost = 0;
+  erasePending = -1;
+}
+
+uint8_t FlashSim_PowerLost(void)
+{
+  return powerLost;
+}
+
+uint32_t FlashSim_GetEraseCount(void)
+{
+  return eraseCount;
+}
+
+uint8_t FlashSim_ErasePending(void)
+{
+  return (erasePending >= 0) ? 1 : 0;
+}
+
+uint8_t Flash_Init(void)
+{
+  return FLASH_STATUS_OK;
+}
+
+uint8_t Flash_Read(uint32_t address, uint8_t* data, uint32_t length)
+{
+  if (powerLost || !InRange(address, length)) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  FinishErase();
+  memcpy(data, &flashSim[address - FLASH_SIM_BASE], length);
+  return FLASH_STATUS_OK;
+}
+
+uint8_t Flash_Write(uint32_t address, const uint8_t* data, uint32_t length)
+{
+  if (powerLost || !InRange(address, length)) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  FinishErase();
+  for (uint32_t i = 0; i < length; i++) {
+    if (powerBudget == 0) {
+      powerLost = 1;
+      return FLASH_STATUS_ERROR;
+    }
+    if (writeFailBudget == 0) {
+      writeFailBudget = -1;
+      return FLASH_STATUS_ERROR;
+    }
+    if (powerBudget > 0) {
+      powerBudget--;
+    }
+    if (writeFailBudget > 0) {
+      writeFailBudget--;
+    }
+    flashSim[address - FLASH_SIM_BASE + i] &= data[i];
+  }
+
+  return FLASH_STATUS_OK;
+}
+
+uint8_t Flash_EraseSector(uint32_t address)
+{
+  uint8_t status = Flash_BeginErase(address);
+  if (status != FLASH_STATUS_OK) {
+    return status;
+  }
+
+  do {
+    status = Flash_PollErase();
+  } while (status == FLASH_STATUS_BUSY);
+  return status;
+}
+
+uint8_t Flash_BeginErase(uint32_t address)
+{
+  if (powerLost || !InRange(address, 1)) {
+    return FLASH_STATUS_ERROR;
+  }
+
+  FinishErase();
+  uint32_t start = (address - FLASH_SIM_BASE) / JOURNAL_SECTOR_SIZE * JOURNAL_SECTOR_SIZE;
+  eraseCount++;
+
+  if (powerBudget == 0) {
+    memset(&flashSim[start], 0xFF, JOURNAL_SECTOR_SIZE / 2);
+    powerLost = 1;
+    return FLASH_STATUS_ERROR;
+  }
+
+  erasePending = (long)start;
+  erasePolls = FLASH_SIM_ERASE_POLLS;
+  return FLASH_STATUS_OK;
+}
+
+uint8_t Flash_PollErase(void)
+{
+  if (powerLost) {
+    return FLASH_STATUS_ERROR;
+  }
+  if (erasePending >= 0 && --erasePolls > 0) {
+    return FLASH_STATUS_BUSY;
+  }
+
+  FinishErase();
+  return FLASH_STATUS_OK;
+}
+
+void Flash_GetStats(FlashStats_t* stats)
+{
+  memset(stats, 0, sizeof(FlashStats_t));
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
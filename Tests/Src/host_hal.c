@@ -0,0 +1,164 @@
+ /**
+  ******************************************************************************
+  * @file           : host_hal.c
+  * @brief          : Host stand-in for the STM32F4 HAL used by the tests
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Time only moves when a test advances it: HAL_GetTick() returns a counter
+  * that Host_AdvanceTick() and HAL_Delay() move, and the DWT cycle counter
+  * follows it at SystemCoreClock. Interrupt masking is a flag, as the tests
+  * run application code on one thread unless they say otherwise.
+  *
+  * A UART receives what Host_UartReceive() gives it into its circular DMA
+  * buffer, and a DMA transmission completes at once, handing the bytes to
+  * Host_UartTxHook.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private variables ---------------------------------------------------------*/
+GPIO_TypeDef hostGpioA;
+GPIO_TypeDef hostGpioB;
+GPIO_TypeDef hostGpioC;
+DWT_Type hostDwt;
+CoreDebug_Type hostCoreDebug;
+uint32_t SystemCoreClock = 100000000U;
+
+void (*Host_WfiHook)(void) = NULL;
+void (*Host_UartTxHook)(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size) = NULL;
+
+static uint32_t hostTick = 0;
+static uint32_t hostPrimask = 0;
+
+/* Exported functions --------------------------------------------------------*/
+
+uint32_t HAL_GetTick(void)
+{
+  return hostTick;
+}
+
+void HAL_Delay(uint32_t delay)
+{
+  Host_AdvanceTick(delay);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* port, uint16_t pin)
+{
+  return (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state)
+{
+  if (state == GPIO_PIN_SET) {
+    port->ODR |= pin;
+  } else {
+    port->ODR &= ~(uint32_t)pin;
+  }
+}
+
+void Host_AdvanceTick(uint32_t ms)
+{
+  hostTick += ms;
+  hostDwt.CYCCNT += ms * (SystemCoreClock / 1000U);
+}
+
+uint32_t __get_PRIMASK(void)
+{
+  return hostPrimask;
+}
+
+void __set_PRIMASK(uint32_t primask)
+{
+  hostPrimask = primask;
+}
+
+void __disable_irq(void)
+{
+  hostPrimask = 1;
+}
+
+void __enable_irq(void)
+{
+  hostPrimask = 0;
+}
+
+void __DSB(void)
+{
+}
+
+void __DMB(void)
+{
+  /* A real barrier: the input queue test runs producer and consumer on
+     two threads */
+  __sync_synchronize();
+}
+
+void __WFI(void)
+{
+  if (Host_WfiHook != NULL) {
+    Host_WfiHook();
+  }
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size)
+{
+  /* hdmarx is linked by HAL_UART_MspInit() in the firmware */
+  if (huart->hdmarx == NULL || size == 0) {
+    return HAL_ERROR;
+  }
+  if (huart->RxState == HAL_UART_STATE_BUSY_RX) {
+    return HAL_BUSY;
+  }
+
+  huart->hdmarx->buffer = data;
+  huart->hdmarx->size = size;
+  huart->hdmarx->remaining = size;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size)
+{
+  if (huart->gState != HAL_UART_STATE_READY) {
+    return HAL_BUSY;
+  }
+
+  if (Host_UartTxHook != NULL) {
+    Host_UartTxHook(huart, data, size);
+  }
+  return HAL_OK;
+}
+
+void Host_UartReceive(UART_HandleTypeDef* huart, const uint8_t* data, uint32_t size)
+{
+  DMA_HandleTypeDef* dma = huart->hdmarx;
+
+  if (huart->RxState != HAL_UART_STATE_BUSY_RX) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < size; i++) {
+    dma->buffer[dma->size - dma->remaining] = data[i];
+    dma->remaining = (dma->remaining > 1) ? dma->remaining - 1 : dma->size;
+  }
+}
+
+void Error_Handler(void)
+{
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,158 @@
+ /**
+  ******************************************************************************
+  * @file           : serial_host.c
+  * @brief          : Host stand-ins for the modules the serial protocol calls
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * serial_protocol.c runs with the real preset manager, journal and codec on
+  * the simulated flash; the audio chain, scheduler, telemetry and UI it
+  * reports on are replaced by the calls below, which record what the
+  * protocol asked of them. The factory presets are five named presets with
+  * distinct cutoffs.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "serial_host.h"
+#include "preset_manager.h"
+#include "factory_presets.h"
+#include "param_update.h"
+#include "preset_morph.h"
+#include "dsp_watchdog.h"
+#include "telemetry.h"
+#include "scheduler.h"
+#include "lcd_driver.h"
+#include "ui_probe.h"
+
+/* Private variables ---------------------------------------------------------*/
+AudioProcessingStats_t serialHostAudioStats;
+uint8_t serialHostMorphActive;
+uint16_t serialHostDirty;
+uint32_t serialHostTestLoadUs;
+uint16_t serialHostTelemetryRate;
+
+static const char* const factoryNames[USER_PRESET_START_ID] = {
+  "Flat", "Club", "Live", "Studio", "Outdoor"
+};
+
+static uint32_t uiInjected;
+
+/* Exported functions --------------------------------------------------------*/
+
+void SerialHost_Reset(void)
+{
+  memset(&serialHostAudioStats, 0, sizeof(serialHostAudioStats));
+  serialHostMorphActive = 0;
+  serialHostDirty = 0;
+  serialHostTestLoadUs = 0;
+  serialHostTelemetryRate = 0;
+  uiInjected = 0;
+}
+
+/* Factory presets -----------------------------------------------------------*/
+
+uint8_t FactoryPresets_GetPreset(uint8_t presetId, PresetSettings_t* settings)
+{
+  if (presetId >= USER_PRESET_START_ID) {
+    return 1;
+  }
+
+  memset(settings, 0, sizeof(PresetSettings_t));
+  settings->crossover.lowCutoff = 80.0f + 10.0f * presetId;
+  settings->crossover.midCutoff = 800.0f;
+  settings->crossover.highCutoff = 5000.0f;
+  return 0;
+}
+
+const char* FactoryPresets_GetName(uint8_t presetId)
+{
+  return (presetId < USER_PRESET_START_ID) ? factoryNames[presetId] : NULL;
+}
+
+/* Processing chain ----------------------------------------------------------*/
+
+void AudioProcessing_GetStats(AudioProcessingStats_t *pStats)
+{
+  memcpy(pStats, &serialHostAudioStats, sizeof(AudioProcessingStats_t));
+}
+
+uint8_t AudioProcessing_IsCrossfading(void)
+{
+  return 0;
+}
+
+uint8_t PresetMorph_IsActive(void)
+{
+  return serialHostMorphActive;
+}
+
+void ParamUpdate_Mark(uint16_t dirty)
+{
+  serialHostDirty |= dirty;
+}
+
+uint32_t DspWatchdog_SetTestLoad(uint32_t loadUs)
+{
+  serialHostTestLoadUs = loadUs;
+  return loadUs;
+}
+
+uint16_t Telemetry_SetRate(uint16_t newRateHz)
+{
+  serialHostTelemetryRate = newRateHz;
+  return newRateHz;
+}
+
+/* Main loop: one task, "host" ----------------------------------------------*/
+
+uint8_t Scheduler_GetTaskCount(void)
+{
+  return 1;
+}
+
+const char* Scheduler_GetTaskName(uint8_t index)
+{
+  return (index == 0) ? "host" : NULL;
+}
+
+uint8_t Scheduler_GetTaskStats(uint8_t index, SchedulerTaskStats_t *stats)
+{
+  if (index != 0) {
+    return 0;
+  }
+  memset(stats, 0, sizeof(SchedulerTaskStats_t));
+  return 1;
+}
+
+/* Front panel ---------------------------------------------------------------*/
+
+void LCD_GetScreen(uint8_t* text)
+{
+  memcpy(text, "Serial host     Protocol test   ", LCD_SCREEN_SIZE);
+}
+
+uint8_t UiProbe_Inject(uint8_t source, uint8_t code, uint8_t state, int32_t value)
+{
+  uiInjected++;
+  return 1;
+}
+
+void UiProbe_GetStats(UiProbeStats_t *stats)
+{
+  memset(stats, 0, sizeof(UiProbeStats_t));
+  stats->injected = uiInjected;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,165 @@
+ /**
+  ******************************************************************************
+  * @file           : serial_sim.c
+  * @brief          : Serial protocol on a pseudo-terminal, for the host client
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * serial_protocol.c and the preset storage behind it (serial_host.c) answer
+  * on a pty as the board does on USART1, so Tools/serial_client.py can be run
+  * against them:
+  *
+  *   serial_sim [--corrupt N]
+  *
+  * The pty path is printed on the first line. --corrupt N flips a bit in
+  * every Nth received byte, which the client must get through by retrying.
+  * The HAL tick follows the wall clock. On SIGINT or SIGTERM the link
+  * statistics are printed and the program ends.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include "serial_protocol.h"
+#include "serial_host.h"
+#include "preset_manager.h"
+#include "flash_sim.h"
+#include "crc32.h"
+
+/* Private define ------------------------------------------------------------*/
+#define READ_CHUNK                 64
+#define IDLE_SLEEP_US              100
+
+/* Private variables ---------------------------------------------------------*/
+UART_HandleTypeDef huart1;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+
+static SystemSettings_t sys;
+static int ptyFd = -1;
+static volatile sig_atomic_t stopRequested = 0;
+
+/* Helpers -------------------------------------------------------------------*/
+
+static void Stop(int signal)
+{
+  stopRequested = 1;
+}
+
+static void WritePty(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size)
+{
+  while (size > 0) {
+    ssize_t written = write(ptyFd, data, size);
+    if (written <= 0) {
+      usleep(IDLE_SLEEP_US);
+      continue;
+    }
+    data += written;
+    size -= (uint16_t)written;
+  }
+}
+
+static uint32_t WallClockMs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(now.tv_sec * 1000U + now.tv_nsec / 1000000U);
+}
+
+static int OpenPty(void)
+{
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+  if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+    return -1;
+  }
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  return fd;
+}
+
+int main(int argc, char** argv)
+{
+  SerialProtocolStats_t stats;
+  uint32_t corruptEvery = 0;
+  uint32_t received = 0;
+  uint32_t lastMs;
+
+  if (argc == 3 && strcmp(argv[1], "--corrupt") == 0) {
+    corruptEvery = (uint32_t)strtoul(argv[2], NULL, 10);
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [--corrupt N]\n", argv[0]);
+    return 2;
+  }
+
+  ptyFd = OpenPty();
+  if (ptyFd < 0) {
+    perror("posix_openpt");
+    return 1;
+  }
+  printf("%s\n", ptsname(ptyFd));
+  fflush(stdout);
+
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+
+  Crc32_Init();
+  FlashSim_Reset(0xFF);
+  PresetManager_Init();
+  SerialHost_Reset();
+
+  huart1.hdmarx = &hdma_usart1_rx;
+  huart1.gState = HAL_UART_STATE_READY;
+  huart1.RxState = HAL_UART_STATE_READY;
+  Host_UartTxHook = WritePty;
+  SerialProtocol_Init(&sys);
+
+  lastMs = WallClockMs();
+  while (!stopRequested) {
+    uint8_t chunk[READ_CHUNK];
+    ssize_t count = read(ptyFd, chunk, sizeof(chunk));
+
+    if (count > 0) {
+      for (ssize_t i = 0; i < count; i++) {
+        if (corruptEvery != 0 && ++received % corruptEvery == 0) {
+          chunk[i] ^= 0x40;
+        }
+      }
+      Host_UartReceive(&huart1, chunk, (uint32_t)count);
+    }
+
+    uint32_t nowMs = WallClockMs();
+    Host_AdvanceTick(nowMs - lastMs);
+    lastMs = nowMs;
+
+    SerialProtocol_Task();
+    PresetManager_Task();
+
+    if (count <= 0) {
+      usleep(IDLE_SLEEP_US);
+    }
+  }
+
+  SerialProtocol_GetStats(&stats);
+  printf("frames received %lu, sent %lu, CRC errors %lu, framing errors %lu\n",
+         (unsigned long)stats.framesReceived, (unsigned long)stats.framesSent,
+         (unsigned long)stats.crcErrors, (unsigned long)stats.framingErrors);
+  close(ptyFd);
+  return 0;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -1 +1,307 @@
- 
+ /**
+  ******************************************************************************
+  * @file           : test_audio_processing.c
+  * @brief          : Host test of the preset crossfade in the audio chain
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * audio_processing.c is built against the stand-ins in Inc/host/chain. The
+  * crossover below puts the whole input in the sub band of whichever
+  * instance is selected; the compressor and limiter are disabled and the
+  * delay passes through, so the output is the input times the sub band gain.
+  * Switching from a 0 dB to a -6 dB sub gain must then ramp the output
+  * linearly over the fade time, run the incoming preset on the standby
+  * crossover instance, and hand over the new settings at the end.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "audio_processing.h"
+#include "crossover.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "delay.h"
+#include "memory_manager.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FRAMES                     (AUDIO_BUFFER_SIZE / 2)
+#define INPUT_LEVEL                16384
+#define HALF_GAIN_DB               -6.0206f   /* Linear 0.5 */
+
+#define FADE_MS                    16         /* 768 frames, six blocks */
+#define FADE_FRAMES                (FADE_MS * AUDIO_SAMPLE_RATE_HZ / 1000)
+#define FADE_BLOCKS                (FADE_FRAMES / FRAMES)
+
+#define SAMPLE_TOLERANCE           2          /* Float round trip and truncation */
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t selectedInstance = 0;
+static uint8_t settingsInstance = 0xFF;
+static CrossoverSettings_t instanceSettings[CROSSOVER_NUM_INSTANCES];
+static uint32_t processCalls[CROSSOVER_NUM_INSTANCES];
+
+static SystemSettings_t settings;
+static AudioBuffer_t input;
+static AudioBuffer_t output;
+
+/* DSP modules (stand-ins) ---------------------------------------------------*/
+
+void Crossover_SelectInstance(uint8_t instance)
+{
+  selectedInstance = instance;
+}
+
+uint8_t Crossover_GetInstance(void)
+{
+  return selectedInstance;
+}
+
+void Crossover_Process(float* inputL, float* inputR, uint16_t size,
+                       float* subL, float* subR, float* lowL, float* lowR,
+                       float* midL, float* midR, float* highL, float* highR,
+                       CrossoverSettings_t* bandSettings)
+{
+  processCalls[selectedInstance]++;
+
+  for (uint16_t i = 0; i < size; i++) {
+    subL[i] = inputL[i];
+    subR[i] = inputR[i];
+    lowL[i] = lowR[i] = midL[i] = midR[i] = highL[i] = highR[i] = 0.0f;
+  }
+}
+
+void Crossover_SetSettings(CrossoverSettings_t* crossoverSettings)
+{
+  settingsInstance = selectedInstance;
+  instanceSettings[selectedInstance] = *crossoverSettings;
+}
+
+void Crossover_SetOrderLimit(uint8_t maxOrder) {}
+void Crossover_Reset(void) {}
+
+void Compressor_Process(float* left, float* right, uint16_t size,
+                        float threshold, float ratio, float attack, float release,
+                        float makeupGain, int band, float* compressionAmount) {}
+void Compressor_Reset(void) {}
+
+void Limiter_Process(float* left, float* right, uint16_t size,
+                     float threshold, float release, int band, float* gainReduction) {}
+void Limiter_Reset(void) {}
+
+void Delay_Process(float* left, float* right, uint16_t size,
+                   float delayMs, uint8_t phaseInvert, int band) {}
+void Delay_Reset(void) {}
+
+/* Helpers -------------------------------------------------------------------*/
+
+/* Settings passing the sub band only, at the given gain */
+static void MakeSettings(SystemSettings_t* target, float subGainDB)
+{
+  memset(target, 0, sizeof(SystemSettings_t));
+  target->crossover.lowCutoff = 80.0f;
+  target->crossover.midCutoff = 500.0f;
+  target->crossover.highCutoff = 4000.0f;
+  target->crossover.subGain = subGainDB;
+  target->crossover.filterOrder = FILTER_ORDER_24DB;
+}
+
+static void Restart(void)
+{
+  AudioProcessing_Init();
+  MakeSettings(&settings, 0.0f);
+  selectedInstance = 0;
+  settingsInstance = 0xFF;
+  memset(processCalls, 0, sizeof(processCalls));
+}
+
+static void Block(void)
+{
+  AudioProcessing_Process(&input, &output, &settings);
+}
+
+/* Expected output at a frame of the fade from gain 1 to 0.5 */
+static int32_t Expected(uint32_t frame)
+{
+  float mix = (frame >= FADE_FRAMES) ? 1.0f : (float)frame / FADE_FRAMES;
+  return (int32_t)(INPUT_LEVEL * (1.0f - 0.5f * mix));
+}
+
+static uint8_t Near(int32_t sample, int32_t expected)
+{
+  return (sample >= expected - SAMPLE_TOLERANCE) && (sample <= expected + SAMPLE_TOLERANCE);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* Without a fade the output is the input at the band gain */
+static void test_steady(void)
+{
+  Restart();
+  Block();
+
+  TEST_ASSERT(Near(output.data[0], INPUT_LEVEL));
+  TEST_ASSERT(Near(output.data[AUDIO_BUFFER_SIZE - 1], INPUT_LEVEL));
+  TEST_ASSERT(processCalls[0] == 1 && processCalls[1] == 0);
+  TEST_ASSERT(!AudioProcessing_IsCrossfading());
+}
+
+/* The gain ramps linearly from the old preset to the new over the fade time */
+static void test_ramp(void)
+{
+  SystemSettings_t target;
+  int32_t previous = INPUT_LEVEL + SAMPLE_TOLERANCE;
+
+  Restart();
+  MakeSettings(&target, HALF_GAIN_DB);
+  AudioProcessing_StartCrossfade(&target, FADE_MS);
+
+  /* The incoming preset is set up on the standby instance */
+  TEST_ASSERT(AudioProcessing_IsCrossfading());
+  TEST_ASSERT(settingsInstance == 1 && selectedInstance == 0);
+  TEST_ASSERT(instanceSettings[1].subGain == HALF_GAIN_DB);
+
+  for (uint32_t block = 0; block < FADE_BLOCKS; block++) {
+    Block();
+
+    for (uint32_t i = 0; i < FRAMES; i++) {
+      uint32_t frame = block * FRAMES + i;
+      int32_t left = output.data[2 * i];
+      int32_t right = output.data[2 * i + 1];
+      if (!Near(left, Expected(frame)) || !Near(right, Expected(frame)) || left > previous) {
+        TEST_FAIL("frame %lu: %ld, expected %ld", (unsigned long)frame,
+                  (long)left, (long)Expected(frame));
+        return;
+      }
+      previous = left;
+    }
+
+    /* Start, middle and end of the ramp */
+    if (block == 0) {
+      TEST_ASSERT(Near(output.data[0], INPUT_LEVEL));
+    } else if (block == FADE_BLOCKS / 2) {
+      TEST_ASSERT(Near(output.data[0], INPUT_LEVEL * 3 / 4));
+    }
+
+    /* Both instances run until the last block, the settings stay until then */
+    TEST_ASSERT(processCalls[0] == block + 1 && processCalls[1] == block + 1);
+    if (block + 1 < FADE_BLOCKS) {
+      TEST_ASSERT(AudioProcessing_IsCrossfading());
+      TEST_ASSERT(settings.crossover.subGain == 0.0f);
+    }
+  }
+  TEST_ASSERT(Near(output.data[AUDIO_BUFFER_SIZE - 1], Expected(FADE_FRAMES - 1)));
+
+  /* The new preset took over between blocks */
+  TEST_ASSERT(!AudioProcessing_IsCrossfading());
+  TEST_ASSERT(memcmp(&settings, &target, sizeof(SystemSettings_t)) == 0);
+  TEST_ASSERT(selectedInstance == 1);
+
+  Block();
+  TEST_ASSERT(Near(output.data[0], INPUT_LEVEL / 2));
+  TEST_ASSERT(Near(output.data[AUDIO_BUFFER_SIZE - 1], INPUT_LEVEL / 2));
+  TEST_ASSERT(processCalls[0] == FADE_BLOCKS && processCalls[1] == FADE_BLOCKS + 1);
+}
+
+/* An instant switch still fades over one block */
+static void test_instant_switch(void)
+{
+  SystemSettings_t target;
+
+  Restart();
+  MakeSettings(&target, HALF_GAIN_DB);
+  AudioProcessing_StartCrossfade(&target, 0);
+  Block();
+
+  TEST_ASSERT(Near(output.data[0], INPUT_LEVEL));
+  TEST_ASSERT(Near(output.data[2 * (FRAMES / 2)], INPUT_LEVEL * 3 / 4));
+  TEST_ASSERT(!AudioProcessing_IsCrossfading());
+  TEST_ASSERT(settings.crossover.subGain == HALF_GAIN_DB);
+}
+
+/* A request during a fade waits for it; only the latest is kept */
+static void test_pending(void)
+{
+  SystemSettings_t first;
+  SystemSettings_t skipped;
+  SystemSettings_t last;
+
+  Restart();
+  MakeSettings(&first, HALF_GAIN_DB);
+  MakeSettings(&skipped, -3.0f);
+  MakeSettings(&last, 0.0f);
+  last.crossover.midMute = 1;
+
+  AudioProcessing_StartCrossfade(&first, FADE_MS);
+  Block();
+  AudioProcessing_StartCrossfade(&skipped, FADE_MS);
+  AudioProcessing_StartCrossfade(&last, FADE_MS);
+
+  /* The first fade runs to its end undisturbed */
+  TEST_ASSERT(instanceSettings[1].subGain == HALF_GAIN_DB);
+  for (uint32_t block = 1; block < FADE_BLOCKS; block++) {
+    Block();
+  }
+  TEST_ASSERT(settings.crossover.subGain == HALF_GAIN_DB);
+  TEST_ASSERT(Near(output.data[AUDIO_BUFFER_SIZE - 1], Expected(FADE_FRAMES - 1)));
+
+  /* The latest request follows on the other instance, back up from 0.5 */
+  TEST_ASSERT(AudioProcessing_IsCrossfading());
+  TEST_ASSERT(settingsInstance == 0 && instanceSettings[0].midMute == 1);
+  Block();
+  TEST_ASSERT(Near(output.data[0], INPUT_LEVEL / 2));
+
+  for (uint32_t block = 1; block < FADE_BLOCKS; block++) {
+    Block();
+  }
+  TEST_ASSERT(!AudioProcessing_IsCrossfading());
+  TEST_ASSERT(memcmp(&settings, &last, sizeof(SystemSettings_t)) == 0);
+  TEST_ASSERT(selectedInstance == 0);
+}
+
+/* In bypass the switch happens at once */
+static void test_bypass(void)
+{
+  SystemSettings_t target;
+
+  Restart();
+  AudioProcessing_SetBypass(1);
+  MakeSettings(&target, HALF_GAIN_DB);
+  AudioProcessing_StartCrossfade(&target, FADE_MS);
+  Block();
+
+  TEST_ASSERT(output.data[0] == INPUT_LEVEL);
+  TEST_ASSERT(!AudioProcessing_IsCrossfading());
+  TEST_ASSERT(memcmp(&settings, &target, sizeof(SystemSettings_t)) == 0);
+  AudioProcessing_SetBypass(0);
+}
+
+int main(void)
+{
+  MemoryManager_Init();
+
+  for (uint32_t i = 0; i < AUDIO_BUFFER_SIZE; i++) {
+    input.data[i] = INPUT_LEVEL;
+  }
+
+  RUN_TEST(test_steady);
+  RUN_TEST(test_ramp);
+  RUN_TEST(test_instant_switch);
+  RUN_TEST(test_pending);
+  RUN_TEST(test_bypass);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,184 @@
+ /**
+  ******************************************************************************
+  * @file           : test_dsp_watchdog.c
+  * @brief          : Host test of the DSP deadline monitor
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Block times are fed to DspWatchdog_BlockDone() as the audio task reports
+  * them. A run of overruns must lower the quality one level at a time, down
+  * to the lowest; isolated overruns far apart must not. Blocks well below
+  * the budget must bring it back one level per restore wait, and a restored
+  * level that fails again soon must double the next wait.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dsp_watchdog.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BLOCK_US                   2666   /* 128 samples at 48 kHz */
+#define BUDGET_US                  (BLOCK_US * DSP_WATCHDOG_BUDGET_PERCENT / 100)
+
+#define OVER_US                    (BUDGET_US + 100)
+#define BUSY_US                    (BUDGET_US * 3 / 4)   /* In budget, no headroom */
+#define IDLE_US                    (BUDGET_US / 4)       /* Below the restore threshold */
+
+/* Helpers -------------------------------------------------------------------*/
+
+/* Feed blocks of one length; returns the level after the last */
+static uint8_t Blocks(uint32_t count, uint32_t blockUs)
+{
+  uint8_t level = DspWatchdog_GetLevel();
+
+  while (count--) {
+    level = DspWatchdog_BlockDone(blockUs);
+  }
+  return level;
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* A run of overruns steps down one level per DSP_WATCHDOG_MISS_LIMIT, to the lowest */
+static void test_step_down(void)
+{
+  DspWatchdog_Init(BLOCK_US);
+
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_MISS_LIMIT - 1, OVER_US) == DSP_QUALITY_FULL);
+  TEST_ASSERT(Blocks(1, OVER_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_MISS_LIMIT - 1, OVER_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(1, OVER_US) == DSP_QUALITY_MINIMAL);
+
+  /* Nothing below the lowest level */
+  TEST_ASSERT(Blocks(10 * DSP_WATCHDOG_MISS_LIMIT, OVER_US) == DSP_QUALITY_LOWEST);
+
+  /* A block exactly at the budget is not an overrun */
+  DspWatchdog_Init(BLOCK_US);
+  TEST_ASSERT(Blocks(10 * DSP_WATCHDOG_MISS_LIMIT, BUDGET_US) == DSP_QUALITY_FULL);
+}
+
+/* Overruns further apart than DSP_WATCHDOG_FORGIVE_BLOCKS do not add up */
+static void test_isolated_overruns(void)
+{
+  DspWatchdog_Init(BLOCK_US);
+
+  for (int i = 0; i < 10; i++) {
+    Blocks(1, OVER_US);
+    Blocks(DSP_WATCHDOG_FORGIVE_BLOCKS, BUSY_US);
+  }
+  TEST_ASSERT(DspWatchdog_GetLevel() == DSP_QUALITY_FULL);
+
+  /* One clean block short of that, they do */
+  for (int i = 0; i < DSP_WATCHDOG_MISS_LIMIT; i++) {
+    Blocks(1, OVER_US);
+    Blocks(DSP_WATCHDOG_FORGIVE_BLOCKS - 1, BUSY_US);
+  }
+  TEST_ASSERT(DspWatchdog_GetLevel() == DSP_QUALITY_REDUCED);
+}
+
+/* Headroom brings the quality back one level per restore wait */
+static void test_restore(void)
+{
+  DspWatchdog_Init(BLOCK_US);
+  TEST_ASSERT(Blocks(2 * DSP_WATCHDOG_MISS_LIMIT, OVER_US) == DSP_QUALITY_MINIMAL);
+
+  /* Blocks in budget but above the restore threshold do not count */
+  TEST_ASSERT(Blocks(4 * DSP_WATCHDOG_RESTORE_BLOCKS, BUSY_US) == DSP_QUALITY_MINIMAL);
+
+  /* Nor does headroom broken by one busy block */
+  Blocks(DSP_WATCHDOG_RESTORE_BLOCKS - 1, IDLE_US);
+  Blocks(1, BUSY_US);
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_RESTORE_BLOCKS - 1, IDLE_US) == DSP_QUALITY_MINIMAL);
+
+  TEST_ASSERT(Blocks(1, IDLE_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_RESTORE_BLOCKS - 1, IDLE_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(1, IDLE_US) == DSP_QUALITY_FULL);
+  TEST_ASSERT(Blocks(4 * DSP_WATCHDOG_RESTORE_BLOCKS, IDLE_US) == DSP_QUALITY_FULL);
+}
+
+/* A restored level that fails again within its wait waits twice as long */
+static void test_restore_backoff(void)
+{
+  uint32_t wait = DSP_WATCHDOG_RESTORE_BLOCKS;
+
+  DspWatchdog_Init(BLOCK_US);
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_MISS_LIMIT, OVER_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(wait, IDLE_US) == DSP_QUALITY_FULL);
+
+  while (wait < DSP_WATCHDOG_RESTORE_BLOCKS * DSP_WATCHDOG_MAX_BACKOFF) {
+    /* Fails again right away */
+    TEST_ASSERT(Blocks(DSP_WATCHDOG_MISS_LIMIT, OVER_US) == DSP_QUALITY_REDUCED);
+    wait *= 2;
+    if (Blocks(wait - 1, IDLE_US) != DSP_QUALITY_REDUCED || Blocks(1, IDLE_US) != DSP_QUALITY_FULL) {
+      TEST_FAIL("restore wait of %lu blocks not kept", (unsigned long)wait);
+      return;
+    }
+  }
+
+  /* The wait stops doubling at DSP_WATCHDOG_MAX_BACKOFF */
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_MISS_LIMIT, OVER_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(wait, IDLE_US) == DSP_QUALITY_FULL);
+
+  /* A level that holds for its wait resets the backoff */
+  Blocks(wait, IDLE_US);
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_MISS_LIMIT, OVER_US) == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(Blocks(DSP_WATCHDOG_RESTORE_BLOCKS, IDLE_US) == DSP_QUALITY_FULL);
+}
+
+/* The statistics count what happened */
+static void test_stats(void)
+{
+  DspWatchdogStats_t stats;
+
+  DspWatchdog_Init(BLOCK_US);
+  Blocks(10, IDLE_US);
+  Blocks(1, BUDGET_US + 500);
+  Blocks(2 * DSP_WATCHDOG_MISS_LIMIT - 1, OVER_US);
+  Blocks(DSP_WATCHDOG_RESTORE_BLOCKS, IDLE_US);
+
+  DspWatchdog_GetStats(&stats);
+  TEST_ASSERT(stats.overruns == 2 * DSP_WATCHDOG_MISS_LIMIT);
+  TEST_ASSERT(stats.worstUs == BUDGET_US + 500);
+  TEST_ASSERT(stats.stepDowns == 2);
+  TEST_ASSERT(stats.restores == 1);
+  TEST_ASSERT(stats.level == DSP_QUALITY_REDUCED);
+  TEST_ASSERT(stats.testLoadUs == 0);
+
+  /* The test load is limited and shows in the statistics */
+  TEST_ASSERT(DspWatchdog_SetTestLoad(500) == 500);
+  TEST_ASSERT(DspWatchdog_SetTestLoad(10 * DSP_WATCHDOG_MAX_TEST_LOAD_US) == DSP_WATCHDOG_MAX_TEST_LOAD_US);
+  DspWatchdog_GetStats(&stats);
+  TEST_ASSERT(stats.testLoadUs == DSP_WATCHDOG_MAX_TEST_LOAD_US);
+  TEST_ASSERT(DspWatchdog_SetTestLoad(0) == 0);
+
+  /* Init clears them */
+  DspWatchdog_Init(BLOCK_US);
+  DspWatchdog_GetStats(&stats);
+  TEST_ASSERT(stats.overruns == 0 && stats.worstUs == 0 && stats.stepDowns == 0 &&
+              stats.restores == 0 && stats.level == DSP_QUALITY_FULL);
+}
+
+int main(void)
+{
+  RUN_TEST(test_step_down);
+  RUN_TEST(test_isolated_overruns);
+  RUN_TEST(test_restore);
+  RUN_TEST(test_restore_backoff);
+  RUN_TEST(test_stats);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
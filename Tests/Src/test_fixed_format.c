@@ -0,0 +1,199 @@
+ /**
+  ******************************************************************************
+  * @file           : test_fixed_format.c
+  * @brief          : Host test and benchmark of the display number formatting
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The formats are checked for rounding, sign, units, field width and
+  * overflow, and the output is compared with snprintf over the whole range
+  * the UI shows. The benchmark times the two display values that were
+  * formatted with float printf before (a gain in dB, a frequency switching
+  * to kHz) against the same snprintf calls; the times are printed, and
+  * only FixedFormat_Print being the faster one is checked.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include "fixed_format.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_CALLS                2000000
+#define TEXT_SIZE                  17      /* One LCD row and the terminator */
+
+/* Private variables ---------------------------------------------------------*/
+static const FixedFormat_t gainFormat = { " dB", NULL, 1, 0 };
+static const FixedFormat_t frequencyFormat = { " Hz", " kHz", 0, 0 };
+static const FixedFormat_t timeFormat = { " ms", NULL, 2, 8 };
+static const FixedFormat_t fieldFormat = { NULL, NULL, 0, 3 };
+
+/* Helpers -------------------------------------------------------------------*/
+
+static double NowNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/* Format and compare, reporting the first mismatch */
+#define EXPECT_PRINT(format, value, expected) \
+  do { \
+    char text[TEXT_SIZE]; \
+    FixedFormat_Print(text, sizeof(text), (value), &(format)); \
+    if (strcmp(text, (expected)) != 0) { \
+      TEST_FAIL("%ld gives '%s', expected '%s'", (long)(value), text, (expected)); \
+    } \
+  } while (0)
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* Rounding, sign, units and field width */
+static void test_formats(void)
+{
+  EXPECT_PRINT(gainFormat, -35, "-3.5 dB");
+  EXPECT_PRINT(gainFormat, -5, "-0.5 dB");
+  EXPECT_PRINT(gainFormat, 0, "0.0 dB");
+  EXPECT_PRINT(gainFormat, 120, "12.0 dB");
+  EXPECT_PRINT(gainFormat, -600, "-60.0 dB");
+
+  EXPECT_PRINT(frequencyFormat, 950, "950 Hz");
+  EXPECT_PRINT(frequencyFormat, 1000, "1.0 kHz");
+  EXPECT_PRINT(frequencyFormat, 1250, "1.3 kHz");
+  EXPECT_PRINT(frequencyFormat, 19999, "20.0 kHz");
+  EXPECT_PRINT(frequencyFormat, -1500, "-1.5 kHz");
+
+  EXPECT_PRINT(timeFormat, 1234, "12.34 ms");
+  EXPECT_PRINT(timeFormat, 5, " 0.05 ms");
+  EXPECT_PRINT(fieldFormat, 7, "  7");
+}
+
+/* Values that do not fit fill the field or buffer with '*' */
+static void test_overflow(void)
+{
+  char text[TEXT_SIZE];
+  char small[5];
+
+  EXPECT_PRINT(fieldFormat, 1234, "***");
+
+  FixedFormat_Print(text, 5, INT32_MIN, &fieldFormat);
+  TEST_ASSERT(strcmp(text, "***") == 0);
+
+  FixedFormat_Print(small, sizeof(small), 123456, &gainFormat);
+  TEST_ASSERT(strcmp(small, "****") == 0);
+}
+
+/* Plain integers and labels */
+static void test_int_and_label(void)
+{
+  char text[TEXT_SIZE];
+
+  FixedFormat_Int(text, sizeof(text), INT32_MIN);
+  TEST_ASSERT(strcmp(text, "-2147483648") == 0);
+  FixedFormat_Int(text, sizeof(text), 0);
+  TEST_ASSERT(strcmp(text, "0") == 0);
+
+  FixedFormat_Label(text, sizeof(text), "Replace User ", 3);
+  TEST_ASSERT(strcmp(text, "Replace User 3") == 0);
+
+  /* The label gives way to the number */
+  FixedFormat_Label(text, 8, "User preset ", 123);
+  TEST_ASSERT(strcmp(text, "User123") == 0);
+}
+
+/* Same text as snprintf over the ranges the UI shows */
+static void test_matches_snprintf(void)
+{
+  char text[TEXT_SIZE];
+  char expected[TEXT_SIZE];
+
+  for (int32_t value = -600; value <= 600; value++) {
+    FixedFormat_Print(text, sizeof(text), value, &gainFormat);
+    snprintf(expected, sizeof(expected), "%s%ld.%ld dB", (value < 0) ? "-" : "",
+             (long)(labs(value) / 10), (long)(labs(value) % 10));
+    if (strcmp(text, expected) != 0) {
+      TEST_FAIL("gain %ld gives '%s', expected '%s'", (long)value, text, expected);
+    }
+  }
+
+  for (int32_t value = 20; value < 1000; value++) {
+    FixedFormat_Print(text, sizeof(text), value, &frequencyFormat);
+    snprintf(expected, sizeof(expected), "%ld Hz", (long)value);
+    if (strcmp(text, expected) != 0) {
+      TEST_FAIL("frequency %ld gives '%s', expected '%s'", (long)value, text, expected);
+    }
+  }
+}
+
+/* The former float printf calls against FixedFormat_Print */
+static void test_benchmark(void)
+{
+  char text[TEXT_SIZE];
+  volatile uint32_t sink = 0;
+  double start, gainFixed, gainPrintf, frequencyFixed, frequencyPrintf;
+
+  start = NowNs();
+  for (int32_t i = 0; i < BENCH_CALLS; i++) {
+    FixedFormat_Print(text, sizeof(text), (i % 1200) - 600, &gainFormat);
+    sink += text[0];
+  }
+  gainFixed = (NowNs() - start) / BENCH_CALLS;
+
+  start = NowNs();
+  for (int32_t i = 0; i < BENCH_CALLS; i++) {
+    snprintf(text, sizeof(text), "%.1f dB", ((i % 1200) - 600) / 10.0f);
+    sink += text[0];
+  }
+  gainPrintf = (NowNs() - start) / BENCH_CALLS;
+
+  start = NowNs();
+  for (int32_t i = 0; i < BENCH_CALLS; i++) {
+    FixedFormat_Print(text, sizeof(text), 20 + (i % 19980), &frequencyFormat);
+    sink += text[0];
+  }
+  frequencyFixed = (NowNs() - start) / BENCH_CALLS;
+
+  start = NowNs();
+  for (int32_t i = 0; i < BENCH_CALLS; i++) {
+    int32_t value = 20 + (i % 19980);
+    if (value < 1000) {
+      snprintf(text, sizeof(text), "%ld Hz", (long)value);
+    } else {
+      snprintf(text, sizeof(text), "%.1f kHz", value / 1000.0f);
+    }
+    sink += text[0];
+  }
+  frequencyPrintf = (NowNs() - start) / BENCH_CALLS;
+
+  printf("  gain: %.1f ns/call (snprintf %.1f ns), frequency: %.1f ns/call (snprintf %.1f ns)\n",
+         gainFixed, gainPrintf, frequencyFixed, frequencyPrintf);
+  TEST_ASSERT(gainFixed < gainPrintf);
+  TEST_ASSERT(frequencyFixed < frequencyPrintf);
+}
+
+int main(void)
+{
+  RUN_TEST(test_formats);
+  RUN_TEST(test_overflow);
+  RUN_TEST(test_int_and_label);
+  RUN_TEST(test_matches_snprintf);
+  RUN_TEST(test_benchmark);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,176 @@
+ /**
+  ******************************************************************************
+  * @file           : test_flash_file.c
+  * @brief          : Host test of the flash layer on its file backend
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Built with FLASH_USE_EXTERNAL=1 and FLASH_STORAGE_FILE, so flash_storage.c
+  * runs as on a board with the SPI-NOR chip, with a file in its place: page
+  * splitting, the read cache, polled erases and the preset journal with all
+  * 200 user presets on the external device.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_storage.h"
+#include "preset_journal.h"
+#include "crc32.h"
+#include "test_framework.h"
+#include <stdlib.h>
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_FIRST_KEY             5
+#define TEST_KEYS                  200
+#define TEST_ROUNDS                4
+#define TEST_PAYLOAD               120
+
+/* Scratch block past the journal */
+#define TEST_BLOCK                 (FLASH_EXTERNAL_BASE + JOURNAL_NUM_SECTORS * FLASH_EXTERNAL_BLOCK_SIZE)
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t expected[TEST_FIRST_KEY + TEST_KEYS][TEST_PAYLOAD];
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* An erase is only issued by Flash_BeginErase() and ends after a few polls */
+static void test_erase_is_polled(void)
+{
+  uint8_t data[16];
+  uint32_t polls = 0;
+  uint8_t status;
+
+  memset(data, 0x00, sizeof(data));
+  TEST_ASSERT(Flash_Write(TEST_BLOCK + 100, data, sizeof(data)) == FLASH_STATUS_OK);
+
+  TEST_ASSERT(Flash_BeginErase(TEST_BLOCK + 100) == FLASH_STATUS_OK);
+  while ((status = Flash_PollErase()) == FLASH_STATUS_BUSY) {
+    polls++;
+  }
+  TEST_ASSERT(status == FLASH_STATUS_OK);
+  TEST_ASSERT(polls > 0);
+
+  TEST_ASSERT(Flash_Read(TEST_BLOCK + 100, data, sizeof(data)) == FLASH_STATUS_OK);
+  for (uint32_t i = 0; i < sizeof(data); i++) {
+    TEST_ASSERT(data[i] == 0xFF);
+  }
+
+  /* A read of the device being erased waits for the erase */
+  memset(data, 0x00, sizeof(data));
+  TEST_ASSERT(Flash_Write(TEST_BLOCK, data, sizeof(data)) == FLASH_STATUS_OK);
+  TEST_ASSERT(Flash_BeginErase(TEST_BLOCK) == FLASH_STATUS_OK);
+  TEST_ASSERT(Flash_Read(TEST_BLOCK, data, sizeof(data)) == FLASH_STATUS_OK);
+  TEST_ASSERT(data[0] == 0xFF && data[sizeof(data) - 1] == 0xFF);
+  TEST_ASSERT(Flash_PollErase() == FLASH_STATUS_OK);
+}
+
+/* Writes across page boundaries, NOR semantics, reads through the cache */
+static void test_pages_and_cache(void)
+{
+  uint8_t data[600];
+  uint8_t readBack[600];
+  FlashStats_t before;
+  FlashStats_t after;
+
+  TEST_ASSERT(Flash_EraseSector(TEST_BLOCK) == FLASH_STATUS_OK);
+
+  for (uint32_t i = 0; i < sizeof(data); i++) {
+    data[i] = (uint8_t)(i * 7 + 3);
+  }
+
+  /* 600 bytes from offset 200: pages 0, 1, 2 and 3 */
+  Flash_GetStats(&before);
+  TEST_ASSERT(Flash_Write(TEST_BLOCK + 200, data, sizeof(data)) == FLASH_STATUS_OK);
+  Flash_GetStats(&after);
+  TEST_ASSERT(after.pagePrograms - before.pagePrograms == 4);
+
+  TEST_ASSERT(Flash_Read(TEST_BLOCK + 200, readBack, sizeof(readBack)) == FLASH_STATUS_OK);
+  TEST_ASSERT(memcmp(readBack, data, sizeof(data)) == 0);
+
+  /* Programming only clears bits; the cached line sees the new value */
+  uint8_t high = 0xF0;
+  uint8_t low = 0x0F;
+  TEST_ASSERT(Flash_Write(TEST_BLOCK + 1000, &high, 1) == FLASH_STATUS_OK);
+  TEST_ASSERT(Flash_Read(TEST_BLOCK + 1000, readBack, 1) == FLASH_STATUS_OK);
+  TEST_ASSERT(Flash_Write(TEST_BLOCK + 1000, &low, 1) == FLASH_STATUS_OK);
+  TEST_ASSERT(Flash_Read(TEST_BLOCK + 1000, readBack, 1) == FLASH_STATUS_OK);
+  TEST_ASSERT(readBack[0] == 0x00);
+
+  /* Past the end of the device */
+  TEST_ASSERT(Flash_Read(FLASH_EXTERNAL_BASE + after.externalSize - 4, readBack, 8) == FLASH_STATUS_INVALID);
+}
+
+/* All user presets written four times over, with compactions, then remounted */
+static void test_journal_on_file(void)
+{
+  uint8_t data[TEST_PAYLOAD];
+  JournalStats_t journalStats;
+  FlashStats_t flashStats;
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+  TEST_ASSERT(PresetJournal_BeginFormat(0, 0) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetJournal_EndFormat() == JOURNAL_STATUS_OK);
+
+  srand(1);
+  for (int round = 0; round < TEST_ROUNDS; round++) {
+    for (int key = TEST_FIRST_KEY; key < TEST_FIRST_KEY + TEST_KEYS; key++) {
+      for (int i = 0; i < TEST_PAYLOAD; i++) {
+        expected[key][i] = (uint8_t)rand();
+      }
+      if (PresetJournal_Write((uint8_t)key, expected[key], TEST_PAYLOAD) != JOURNAL_STATUS_OK) {
+        TEST_FAIL("round %d: write of key %d failed", round, key);
+      }
+    }
+  }
+
+  PresetJournal_GetStats(&journalStats);
+  uint32_t compactions = journalStats.compactions;
+  TEST_ASSERT(compactions > 0);
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  for (int key = TEST_FIRST_KEY; key < TEST_FIRST_KEY + TEST_KEYS; key++) {
+    if (PresetJournal_Read((uint8_t)key, data, TEST_PAYLOAD) != JOURNAL_STATUS_OK ||
+        memcmp(data, expected[key], TEST_PAYLOAD) != 0) {
+      TEST_FAIL("key %d differs after remount", key);
+    }
+  }
+
+  PresetJournal_GetStats(&journalStats);
+  Flash_GetStats(&flashStats);
+  TEST_ASSERT(journalStats.liveRecords == TEST_KEYS);
+  TEST_ASSERT(flashStats.cacheHits > flashStats.cacheMisses);
+  printf("  %lu compactions, %lu cache hits, %lu misses, %lu erases\n",
+         (unsigned long)compactions, (unsigned long)flashStats.cacheHits,
+         (unsigned long)flashStats.cacheMisses, (unsigned long)flashStats.erases);
+}
+
+int main(void)
+{
+  /* Start from a blank device */
+  remove(FLASH_STORAGE_FILE);
+
+  Crc32_Init();
+  if (Flash_Init() != FLASH_STATUS_OK) {
+    printf("cannot create %s\n", FLASH_STORAGE_FILE);
+    return 1;
+  }
+
+  RUN_TEST(test_erase_is_polled);
+  RUN_TEST(test_pages_and_cache);
+  RUN_TEST(test_journal_on_file);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
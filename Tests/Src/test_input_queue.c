@@ -0,0 +1,173 @@
+ /**
+  ******************************************************************************
+  * @file           : test_input_queue.c
+  * @brief          : Host test of the single-producer / single-consumer input
+  *                   queue
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Besides order, refusal when full and the statistics, the queue is run
+  * with the producer (the TIM3 interrupt on the target) and the consumer
+  * (the main loop) on two threads. Neither side takes a lock, so every
+  * event must come out once, in order and with the contents it was queued
+  * with, while the two sides race on every slot. The races only really
+  * overlap when the host has more than one core.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include "input_queue.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STRESS_EVENTS              2000000
+
+/* Helpers -------------------------------------------------------------------*/
+
+/* Contents derived from the sequence number, so a torn or stale slot shows */
+static void Expected(int32_t n, uint8_t* source, uint8_t* code, uint8_t* state)
+{
+  *source = (uint8_t)(n & 1);
+  *code = (uint8_t)(n * 7);
+  *state = (uint8_t)(n >> 8);
+}
+
+/* Producer thread: queue STRESS_EVENTS events, retrying refused ones */
+static void* Producer(void* arg)
+{
+  int32_t n = 0;
+
+  while (n < STRESS_EVENTS) {
+    uint8_t source, code, state;
+
+    Expected(n, &source, &code, &state);
+    if (InputQueue_Push(source, code, state, n)) {
+      n++;
+    } else {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* Events come out in the order and with the contents they went in */
+static void test_fifo_order(void)
+{
+  InputEvent_t event;
+
+  InputQueue_Init();
+  TEST_ASSERT(InputQueue_IsEmpty());
+  TEST_ASSERT(InputQueue_Pop(&event) == 0);
+
+  /* Several laps of the ring */
+  for (int32_t n = 0; n < 5 * INPUT_QUEUE_SIZE; n += 3) {
+    for (int32_t i = 0; i < 3; i++) {
+      TEST_ASSERT(InputQueue_Push(INPUT_SOURCE_BUTTON, (uint8_t)(n + i), 2, -(n + i)));
+    }
+    for (int32_t i = 0; i < 3; i++) {
+      TEST_ASSERT(InputQueue_Pop(&event));
+      TEST_ASSERT(event.source == INPUT_SOURCE_BUTTON);
+      TEST_ASSERT(event.code == (uint8_t)(n + i));
+      TEST_ASSERT(event.state == 2);
+      TEST_ASSERT(event.value == -(n + i));
+    }
+  }
+  TEST_ASSERT(InputQueue_IsEmpty());
+}
+
+/* A full queue refuses new events, keeps the old ones and counts the refusals */
+static void test_full_refuses(void)
+{
+  InputQueueStats_t stats;
+  InputEvent_t event;
+
+  InputQueue_Init();
+  for (int32_t n = 0; n < INPUT_QUEUE_SIZE; n++) {
+    TEST_ASSERT(InputQueue_Push(INPUT_SOURCE_ENCODER, 0, 0, n));
+  }
+  TEST_ASSERT(InputQueue_Push(INPUT_SOURCE_ENCODER, 0, 0, 100) == 0);
+  TEST_ASSERT(InputQueue_Push(INPUT_SOURCE_BUTTON, 1, 1, 0) == 0);
+  TEST_ASSERT(InputQueue_Push(INPUT_SOURCE_COUNT, 0, 0, 0) == 0);
+
+  InputQueue_GetStats(&stats);
+  TEST_ASSERT(stats.queued[INPUT_SOURCE_ENCODER] == INPUT_QUEUE_SIZE);
+  TEST_ASSERT(stats.dropped[INPUT_SOURCE_ENCODER] == 1);
+  TEST_ASSERT(stats.dropped[INPUT_SOURCE_BUTTON] == 1);
+  TEST_ASSERT(stats.maxDepth == INPUT_QUEUE_SIZE);
+
+  TEST_ASSERT(InputQueue_Pop(&event) && event.value == 0);
+  TEST_ASSERT(InputQueue_Push(INPUT_SOURCE_ENCODER, 0, 0, 100));
+  for (int32_t n = 1; n < INPUT_QUEUE_SIZE; n++) {
+    TEST_ASSERT(InputQueue_Pop(&event) && event.value == n);
+  }
+  TEST_ASSERT(InputQueue_Pop(&event) && event.value == 100);
+  TEST_ASSERT(InputQueue_IsEmpty());
+
+  /* Flush drops what is waiting */
+  InputQueue_Push(INPUT_SOURCE_ENCODER, 0, 0, 1);
+  InputQueue_Push(INPUT_SOURCE_ENCODER, 0, 0, 2);
+  InputQueue_Flush();
+  TEST_ASSERT(InputQueue_IsEmpty());
+  TEST_ASSERT(InputQueue_Pop(&event) == 0);
+}
+
+/* Producer and consumer on two threads without locks */
+static void test_two_threads(void)
+{
+  InputQueueStats_t stats;
+  InputEvent_t event;
+  pthread_t producer;
+  int32_t expected = 0;
+
+  InputQueue_Init();
+  TEST_ASSERT(pthread_create(&producer, NULL, Producer, NULL) == 0);
+
+  while (expected < STRESS_EVENTS) {
+    uint8_t source, code, state;
+
+    if (!InputQueue_Pop(&event)) {
+      sched_yield();
+      continue;
+    }
+    Expected(expected, &source, &code, &state);
+    if (event.value != expected || event.source != source || event.code != code ||
+        event.state != state) {
+      pthread_join(producer, NULL);
+      TEST_FAIL("event %ld came out as value %ld source %u code %u state %u", (long)expected,
+                (long)event.value, event.source, event.code, event.state);
+    }
+    expected++;
+  }
+  pthread_join(producer, NULL);
+
+  TEST_ASSERT(InputQueue_Pop(&event) == 0);
+  InputQueue_GetStats(&stats);
+  TEST_ASSERT(stats.queued[0] + stats.queued[1] == STRESS_EVENTS);
+  TEST_ASSERT(stats.maxDepth <= INPUT_QUEUE_SIZE);
+}
+
+int main(void)
+{
+  RUN_TEST(test_fifo_order);
+  RUN_TEST(test_full_refuses);
+  RUN_TEST(test_two_threads);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
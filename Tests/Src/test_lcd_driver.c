@@ -0,0 +1,421 @@
+ /**
+  ******************************************************************************
+  * @file           : test_lcd_driver.c
+  * @brief          : Host test of the LCD transfer queue on the mock backend
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * lcd_driver.c is built with LCD_MOCK_BACKEND. The test plays the I2C bus:
+  * it holds each transfer until it calls LCD_TransferComplete() and then
+  * feeds the PCF8574 bytes to a model of the HD44780, which latches a
+  * nibble on each falling enable edge and starts in 8-bit mode as after
+  * power-up. Only one transfer may be in flight. A completed transfer must
+  * start the next from the interrupt handler alone. Nothing may reach the
+  * controller during the pause after a slow command. A full queue must wait
+  * on the bus rather than drop writes, and what a flush cannot queue must
+  * stay dirty for the next one. In every case the model has to end up
+  * showing the frame buffer.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "lcd_driver.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TX_MAX_BYTES               64      /* LCD_TX_SIZE of lcd_driver.c */
+#define QUEUE_OPS                  127     /* LCD_QUEUE_SIZE of lcd_driver.c, less one */
+#define FILL_ROUNDS                12      /* Of 34 writes each: over three queues' worth */
+#define CLEAR_BUSY_MS              2       /* 1.52 ms, on the 1 ms tick */
+#define DRAIN_LIMIT                10000
+
+/* Private typedef -----------------------------------------------------------*/
+/* HD44780 as seen through the PCF8574 */
+typedef struct {
+    uint8_t fourBit;           /* Interface set to 4 bits */
+    uint8_t highNibble;        /* First nibble of a byte latched, waiting for the second */
+    uint8_t pending;           /* That nibble */
+    uint8_t pendingRs;
+    uint8_t lastPort;          /* Last byte on the expander, for the enable edge */
+    uint8_t cgram;             /* Address counter points into CGRAM */
+    uint8_t address;
+    uint8_t ddram[0x80];
+    uint8_t cgramData[64];
+    uint32_t busyUntil;        /* Tick before which the controller ignores writes */
+    uint32_t busyViolations;   /* Writes that arrived while busy */
+    uint32_t dataWrites;
+} ModelLcd_t;
+
+/* Private variables ---------------------------------------------------------*/
+I2C_HandleTypeDef hi2c1;
+
+static ModelLcd_t model;
+
+/* Transfer in flight */
+static uint8_t inFlight = 0;
+static uint8_t flightData[TX_MAX_BYTES];
+static uint16_t flightLength = 0;
+static uint32_t transfersStarted = 0;
+static uint32_t overlaps = 0;          /* Transfers started while one was in flight */
+static uint32_t oversized = 0;         /* Transfers longer than TX_MAX_BYTES */
+static uint32_t waits = 0;
+
+/* Helpers -------------------------------------------------------------------*/
+
+static void ModelReset(void)
+{
+  memset(&model, 0, sizeof(model));
+  memset(model.ddram, ' ', sizeof(model.ddram));
+}
+
+/* One byte (8-bit mode) or two nibbles (4-bit mode) reached the controller */
+static void ModelExecute(uint8_t value, uint8_t rs)
+{
+  if (HAL_GetTick() < model.busyUntil) {
+    model.busyViolations++;
+  }
+
+  if (rs) {
+    model.dataWrites++;
+    if (model.cgram) {
+      model.cgramData[model.address++ & 0x3F] = value;
+    } else {
+      model.ddram[model.address++ & 0x7F] = value;
+    }
+  } else if (value & LCD_CMD_SET_DDRAM_ADDR) {
+    model.cgram = 0;
+    model.address = value & 0x7F;
+  } else if (value & LCD_CMD_SET_CGRAM_ADDR) {
+    model.cgram = 1;
+    model.address = value & 0x3F;
+  } else if (value & LCD_CMD_FUNCTION_SET) {
+    model.fourBit = !(value & LCD_8BIT_MODE);
+    model.highNibble = 0;
+  } else if (value == LCD_CMD_CLEAR || (value & 0xFE) == LCD_CMD_HOME) {
+    if (value == LCD_CMD_CLEAR) {
+      memset(model.ddram, ' ', sizeof(model.ddram));
+    }
+    model.cgram = 0;
+    model.address = 0;
+    model.busyUntil = HAL_GetTick() + CLEAR_BUSY_MS;
+  }
+}
+
+static void ModelPort(uint8_t port)
+{
+  /* The controller latches on the falling edge of EN */
+  if ((model.lastPort & LCD_PIN_EN) && !(port & LCD_PIN_EN)) {
+    uint8_t nibble = model.lastPort & 0xF0;
+    uint8_t rs = (model.lastPort & LCD_PIN_RS) ? 1 : 0;
+
+    if (!model.fourBit) {
+      ModelExecute(nibble, rs);
+    } else if (!model.highNibble) {
+      model.pending = nibble;
+      model.pendingRs = rs;
+      model.highNibble = 1;
+    } else {
+      model.highNibble = 0;
+      ModelExecute(model.pending | (nibble >> 4), model.pendingRs);
+    }
+  }
+  model.lastPort = port;
+}
+
+/* End the transfer in flight: the bytes reach the expander, then the interrupt */
+static void CompleteTransfer(void)
+{
+  inFlight = 0;
+  for (uint16_t i = 0; i < flightLength; i++) {
+    ModelPort(flightData[i]);
+  }
+  LCD_TransferComplete();
+}
+
+/* Run the bus, the 1 ms timer and the main loop flush until the driver is idle */
+static uint8_t Drain(void)
+{
+  for (uint32_t steps = 0; steps < DRAIN_LIMIT; steps++) {
+    if (inFlight) {
+      CompleteTransfer();
+      continue;
+    }
+    LCD_Flush();
+    if (LCD_IsIdle()) {
+      return 1;
+    }
+    if (!inFlight) {
+      Host_AdvanceTick(1);
+      LCD_TimerTick();
+    }
+  }
+  return 0;
+}
+
+/* The model shows the given rows */
+static uint8_t ModelShows(const char* row0, const char* row1)
+{
+  return memcmp(&model.ddram[0x00], row0, 16) == 0 && memcmp(&model.ddram[0x40], row1, 16) == 0;
+}
+
+static void StartDisplay(void)
+{
+  ModelReset();
+  inFlight = 0;
+  transfersStarted = overlaps = oversized = waits = 0;
+  LCD_Init();
+}
+
+/* Host bus ------------------------------------------------------------------*/
+
+void LCD_MockTransmit(const uint8_t* data, uint16_t length)
+{
+  if (inFlight) {
+    overlaps++;
+  }
+  if (length > TX_MAX_BYTES) {
+    oversized++;
+    length = TX_MAX_BYTES;
+  }
+
+  memcpy(flightData, data, length);
+  flightLength = length;
+  inFlight = 1;
+  transfersStarted++;
+}
+
+void LCD_MockWait(void)
+{
+  waits++;
+  if (inFlight) {
+    CompleteTransfer();
+  } else {
+    Host_AdvanceTick(1);
+    LCD_TimerTick();
+  }
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* The reset sequence goes out one nibble at a time, each after its pause */
+static void test_init_sequence(void)
+{
+  LCD_StatsTypeDef stats;
+
+  StartDisplay();
+
+  /* Only the first 8-bit nibble, then the 5 ms pause */
+  TEST_ASSERT(inFlight && flightLength == 2);
+  TEST_ASSERT(flightData[0] == (0x30 | LCD_PIN_EN | LCD_PIN_BL) && flightData[1] == (0x30 | LCD_PIN_BL));
+  CompleteTransfer();
+  TEST_ASSERT(!inFlight);
+
+  for (int ms = 0; ms < 5; ms++) {
+    Host_AdvanceTick(1);
+    LCD_TimerTick();
+    TEST_ASSERT(!inFlight);
+  }
+  Host_AdvanceTick(1);
+  LCD_TimerTick();
+  TEST_ASSERT(inFlight && flightLength == 2);
+
+  TEST_ASSERT(Drain());
+  TEST_ASSERT(model.fourBit && !model.cgram && model.address == 0);
+  TEST_ASSERT(ModelShows("                ", "                "));
+  TEST_ASSERT(model.busyViolations == 0);
+  TEST_ASSERT(overlaps == 0 && oversized == 0);
+
+  LCD_GetStats(&stats);
+  TEST_ASSERT(stats.Transfers == transfersStarted && stats.BusErrors == 0);
+}
+
+/* Completing a transfer starts the next; the main loop is not needed */
+static void test_completion_chains(void)
+{
+  StartDisplay();
+  TEST_ASSERT(Drain());
+
+  LCD_SetCursor(0, 0);
+  LCD_Print("Crossover ready");
+  LCD_SetCursor(0, 1);
+  LCD_Print("Preset: Rock");
+  uint32_t started = transfersStarted;
+  LCD_Flush();
+
+  /* 27 characters and the move to row 1. The first write goes out at once;
+     the rest wait for it and are then packed 16 writes per transfer. */
+  TEST_ASSERT(inFlight && flightLength == 4);
+  CompleteTransfer();
+  TEST_ASSERT(inFlight && flightLength == TX_MAX_BYTES);
+  CompleteTransfer();
+  TEST_ASSERT(inFlight && flightLength == (27 + 1 - 1 - 16) * 4);
+  CompleteTransfer();
+  TEST_ASSERT(!inFlight && transfersStarted - started == 3);
+  TEST_ASSERT(LCD_IsIdle());
+
+  TEST_ASSERT(ModelShows("Crossover ready ", "Preset: Rock    "));
+  TEST_ASSERT(overlaps == 0 && oversized == 0 && waits == 0);
+}
+
+/* Writes after a clear wait out its busy time */
+static void test_slow_command_pause(void)
+{
+  StartDisplay();
+  TEST_ASSERT(Drain());
+
+  LCD_SendCommand(LCD_CMD_CLEAR);
+  LCD_SendCommand(LCD_CMD_SET_DDRAM_ADDR | 0x40);
+  LCD_SendData('X');
+
+  /* The clear goes alone, the rest after its pause */
+  TEST_ASSERT(inFlight && flightLength == 4);
+  CompleteTransfer();
+  TEST_ASSERT(!inFlight);
+  LCD_Flush();
+  TEST_ASSERT(!inFlight);
+
+  TEST_ASSERT(Drain());
+  TEST_ASSERT(model.busyViolations == 0);
+  TEST_ASSERT(model.ddram[0x40] == 'X');
+}
+
+/* A full queue waits on the bus; no write is lost */
+static void test_queue_full(void)
+{
+  char row[16];
+
+  StartDisplay();
+  TEST_ASSERT(Drain());
+  waits = 0;
+  model.dataWrites = 0;
+
+  /* Both rows, over and over, one letter per round */
+  for (uint8_t round = 0; round < FILL_ROUNDS; round++) {
+    LCD_SendCommand(LCD_CMD_SET_DDRAM_ADDR | 0x00);
+    for (uint8_t col = 0; col < 16; col++) {
+      LCD_SendData((uint8_t)('A' + round));
+    }
+    LCD_SendCommand(LCD_CMD_SET_DDRAM_ADDR | 0x40);
+    for (uint8_t col = 0; col < 16; col++) {
+      LCD_SendData((uint8_t)('a' + round));
+    }
+  }
+  TEST_ASSERT(waits > 0);
+  TEST_ASSERT(FILL_ROUNDS * 34 > 3 * QUEUE_OPS);
+
+  while (inFlight) {
+    CompleteTransfer();
+  }
+  TEST_ASSERT(model.dataWrites == FILL_ROUNDS * 32);
+  memset(row, 'A' + FILL_ROUNDS - 1, sizeof(row));
+  TEST_ASSERT(memcmp(&model.ddram[0x00], row, 16) == 0);
+  memset(row, 'a' + FILL_ROUNDS - 1, sizeof(row));
+  TEST_ASSERT(memcmp(&model.ddram[0x40], row, 16) == 0);
+  TEST_ASSERT(overlaps == 0 && oversized == 0);
+
+  /* Those writes bypassed the frame buffer */
+  LCD_Invalidate();
+  TEST_ASSERT(Drain());
+  TEST_ASSERT(ModelShows("                ", "                "));
+}
+
+/* What a flush cannot queue stays dirty for the next flush */
+static void test_flush_backpressure(void)
+{
+  uint8_t screen[LCD_SCREEN_SIZE];
+
+  StartDisplay();
+  TEST_ASSERT(Drain());
+
+  /* One write in flight and room for six more in the queue */
+  for (uint16_t i = 0; i < 1 + QUEUE_OPS - 6; i++) {
+    LCD_SendCommand(LCD_CMD_SET_DDRAM_ADDR | 0x10);
+  }
+  TEST_ASSERT(waits == 0);
+
+  /* Those moved the address behind the frame buffer's back */
+  LCD_Invalidate();
+  LCD_SetCursor(0, 0);
+  LCD_Print("Low  120 Hz");
+  LCD_SetCursor(0, 1);
+  LCD_Print("Mid 2.50 kHz");
+  uint8_t sent = LCD_Flush();
+  TEST_ASSERT(sent > 0 && sent < LCD_SCREEN_SIZE);
+  TEST_ASSERT(waits == 0);
+  TEST_ASSERT(!LCD_IsIdle());
+
+  /* The screen copy holds what was queued, not the whole frame */
+  LCD_GetScreen(screen);
+  TEST_ASSERT(memcmp(&screen[16], "Mid 2.50 kHz", 12) != 0);
+
+  TEST_ASSERT(Drain());
+  TEST_ASSERT(ModelShows("Low  120 Hz     ", "Mid 2.50 kHz    "));
+  LCD_GetScreen(screen);
+  TEST_ASSERT(memcmp(screen, model.ddram, 16) == 0 && memcmp(&screen[16], &model.ddram[0x40], 16) == 0);
+}
+
+/* A failed transfer resets the controller and redraws the screen */
+static void test_transfer_error(void)
+{
+  LCD_StatsTypeDef stats;
+
+  StartDisplay();
+  TEST_ASSERT(Drain());
+
+  LCD_SetCursor(0, 0);
+  LCD_Print("Sub   -3.0 dB");
+  LCD_SetCursor(0, 1);
+  LCD_Print("High  +1.5 dB");
+  LCD_Flush();
+
+  /* A write and a half of the second transfer reach the controller, which
+     is left waiting for a low nibble */
+  CompleteTransfer();
+  TEST_ASSERT(inFlight && flightLength > 8);
+  inFlight = 0;
+  for (uint16_t i = 0; i < 6; i++) {
+    ModelPort(flightData[i]);
+  }
+  TEST_ASSERT(model.highNibble);
+  LCD_TransferError();
+
+  /* The rest of the queue goes out, but the display has not caught up
+     until a flush has reset the controller and redrawn the screen */
+  while (inFlight) {
+    CompleteTransfer();
+  }
+  TEST_ASSERT(!LCD_IsIdle());
+
+  TEST_ASSERT(Drain());
+  TEST_ASSERT(model.fourBit);
+  TEST_ASSERT(ModelShows("Sub   -3.0 dB   ", "High  +1.5 dB   "));
+  TEST_ASSERT(model.busyViolations == 0);
+
+  LCD_GetStats(&stats);
+  TEST_ASSERT(stats.BusErrors == 1);
+}
+
+int main(void)
+{
+  RUN_TEST(test_init_sequence);
+  RUN_TEST(test_completion_chains);
+  RUN_TEST(test_slow_command_pause);
+  RUN_TEST(test_queue_full);
+  RUN_TEST(test_flush_backpressure);
+  RUN_TEST(test_transfer_error);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
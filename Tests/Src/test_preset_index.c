@@ -0,0 +1,230 @@
+ /**
+  ******************************************************************************
+  * @file           : test_preset_index.c
+  * @brief          : Host test of the preset index with 200 user presets
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Built like test_flash_file, with FLASH_USE_EXTERNAL=1 and the file
+  * backend. The journal is filled with all 200 user presets before the
+  * preset manager starts, as a device left by earlier sessions. Starting the
+  * manager must build the index from the header, name and CRC trailer of
+  * each record only; settings are read when a preset is loaded. Lookup by
+  * name and the menu listing are then timed against the index.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include "preset_manager.h"
+#include "preset_codec.h"
+#include "preset_journal.h"
+#include "flash_storage.h"
+#include "crc32.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_PRESETS               MAX_USER_PRESETS
+#define INDEX_READS_PER_PRESET     5       /* Length, name and CRC trailer, each after the header */
+#define LOOKUP_ROUNDS              20
+
+/* Factory presets (not under test) ------------------------------------------*/
+
+uint8_t FactoryPresets_GetPreset(uint8_t presetId, PresetSettings_t* settings)
+{
+  memset(settings, 0, sizeof(PresetSettings_t));
+  return (presetId < USER_PRESET_START_ID) ? 0 : 1;
+}
+
+const char* FactoryPresets_GetName(uint8_t presetId)
+{
+  return (presetId < USER_PRESET_START_ID) ? "Factory" : NULL;
+}
+
+/* Helpers -------------------------------------------------------------------*/
+
+static double NowNs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/* Settings on the codec's quantization grid, different for each preset */
+static void MakeSettings(uint8_t presetId, PresetSettings_t* settings)
+{
+  memset(settings, 0, sizeof(PresetSettings_t));
+
+  settings->crossover.lowCutoff = 40.0f + presetId;
+  settings->crossover.midCutoff = 300.0f + 5.0f * presetId;
+  settings->crossover.highCutoff = 3000.0f + 20.0f * presetId;
+  settings->crossover.filterType = 1;
+  settings->crossover.filterOrder = 4;
+  settings->crossover.midMute = presetId & 1;
+  settings->delay.midDelay = (presetId % 50) / 100.0f;
+}
+
+static void MakeName(uint8_t presetId, char* name)
+{
+  snprintf(name, 16, "Venue %03d", presetId);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* The journal holds every user preset before the manager starts */
+static void test_fill(void)
+{
+  PresetSettings_t settings;
+  PresetMetadata_t metadata;
+  uint8_t record[PRESET_CODEC_MAX_SIZE];
+  uint16_t length;
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+  TEST_ASSERT(PresetJournal_BeginFormat(0, 0) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetJournal_EndFormat() == JOURNAL_STATUS_OK);
+
+  for (uint8_t presetId = USER_PRESET_START_ID; presetId < TOTAL_PRESET_COUNT; presetId++) {
+    MakeSettings(presetId, &settings);
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.presetId = presetId;
+    MakeName(presetId, metadata.name);
+    metadata.timestamp = 1000U * presetId;
+
+    if (PresetCodec_Encode(&settings, &metadata, record, sizeof(record), &length) != PRESET_CODEC_OK ||
+        PresetJournal_Write(presetId, record, length) != JOURNAL_STATUS_OK) {
+      TEST_FAIL("preset %d not stored", presetId);
+    }
+  }
+}
+
+/* Starting the manager reads only what the index keeps */
+static void test_index_build(void)
+{
+  FlashStats_t before;
+  FlashStats_t mounted;
+  FlashStats_t after;
+  double start, mountNs, buildNs;
+
+  Flash_GetStats(&before);
+  start = NowNs();
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  mountNs = NowNs() - start;
+  Flash_GetStats(&mounted);
+
+  /* Mounts the journal again, then builds the index */
+  start = NowNs();
+  PresetManager_Init();
+  buildNs = NowNs() - start - mountNs;
+  Flash_GetStats(&after);
+
+  uint32_t mountReads = mounted.reads - before.reads;
+  uint32_t indexReads = after.reads - mounted.reads - mountReads;
+  printf("  %d presets: mount %.0f us (%lu reads), index %.0f us (%lu reads)\n",
+         TEST_PRESETS, mountNs / 1000.0, (unsigned long)mountReads,
+         buildNs / 1000.0, (unsigned long)indexReads);
+
+  TEST_ASSERT(PresetManager_GetPresetCount() == USER_PRESET_START_ID + TEST_PRESETS);
+  if (indexReads > TEST_PRESETS * INDEX_READS_PER_PRESET) {
+    TEST_FAIL("index build made %lu reads, at most %d expected",
+              (unsigned long)indexReads, TEST_PRESETS * INDEX_READS_PER_PRESET);
+  }
+}
+
+/* Lookup by name and the menu listing come from the index and the names */
+static void test_lookup_and_listing(void)
+{
+  PresetMetadata_t info;
+  FlashStats_t before;
+  FlashStats_t after;
+  char name[16];
+  double start, findNs, listNs;
+
+  /* Every preset by name, the last ones the worst case of a linear scan */
+  start = NowNs();
+  for (int round = 0; round < LOOKUP_ROUNDS; round++) {
+    for (uint8_t presetId = USER_PRESET_START_ID; presetId < TOTAL_PRESET_COUNT; presetId++) {
+      MakeName(presetId, name);
+      if (PresetManager_FindPreset(name) != presetId) {
+        TEST_FAIL("'%s' not found", name);
+        return;
+      }
+    }
+  }
+  findNs = (NowNs() - start) / (LOOKUP_ROUNDS * TEST_PRESETS);
+  TEST_ASSERT(PresetManager_FindPreset("Nowhere") == PRESET_ID_INVALID);
+
+  /* A lookup reads the names of hash matches only */
+  MakeName(TOTAL_PRESET_COUNT - 1, name);
+  Flash_GetStats(&before);
+  TEST_ASSERT(PresetManager_FindPreset(name) == TOTAL_PRESET_COUNT - 1);
+  Flash_GetStats(&after);
+  TEST_ASSERT(after.reads - before.reads <= 2 * INDEX_READS_PER_PRESET);
+
+  /* The menu lists every preset with its name */
+  start = NowNs();
+  for (int round = 0; round < LOOKUP_ROUNDS; round++) {
+    for (uint8_t presetId = USER_PRESET_START_ID; presetId < TOTAL_PRESET_COUNT; presetId++) {
+      MakeName(presetId, name);
+      if (PresetManager_GetPresetInfo(presetId, &info) != PRESET_STATUS_OK ||
+          strcmp(info.name, name) != 0 || info.timestamp != 1000U * presetId) {
+        TEST_FAIL("preset %d listed wrong", presetId);
+        return;
+      }
+    }
+  }
+  listNs = (NowNs() - start) / (LOOKUP_ROUNDS * TEST_PRESETS);
+
+  printf("  find by name %.2f us, list entry %.2f us\n", findNs / 1000.0, listNs / 1000.0);
+}
+
+/* Settings are read and decoded when a preset is loaded */
+static void test_load_on_demand(void)
+{
+  PresetSettings_t expected;
+  PresetSettings_t loaded;
+  FlashStats_t before;
+  FlashStats_t after;
+
+  for (uint8_t presetId = USER_PRESET_START_ID; presetId < TOTAL_PRESET_COUNT; presetId += 39) {
+    MakeSettings(presetId, &expected);
+    Flash_GetStats(&before);
+    TEST_ASSERT(PresetManager_LoadPreset(presetId, &loaded) == PRESET_STATUS_OK);
+    Flash_GetStats(&after);
+    TEST_ASSERT(memcmp(&loaded, &expected, sizeof(expected)) == 0);
+    TEST_ASSERT(after.reads > before.reads);
+    TEST_ASSERT(PresetManager_GetCurrentPreset() == presetId);
+  }
+}
+
+int main(void)
+{
+  /* Start from a blank device */
+  remove(FLASH_STORAGE_FILE);
+
+  Crc32_Init();
+  if (Flash_Init() != FLASH_STATUS_OK) {
+    printf("cannot create %s\n", FLASH_STORAGE_FILE);
+    return 1;
+  }
+
+  RUN_TEST(test_fill);
+  RUN_TEST(test_index_build);
+  RUN_TEST(test_lookup_and_listing);
+  RUN_TEST(test_load_on_demand);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,330 @@
+ /**
+  ******************************************************************************
+  * @file           : test_preset_journal.c
+  * @brief          : Host test of the preset journal with power-cut injection
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The journal runs on the simulated flash of flash_sim.c. A power cut is
+  * injected after a number of programmed bytes; an erase cut short leaves
+  * its sector half erased. After a cut the journal is mounted again and
+  * every key must read back its old or its new value. A write can also fail
+  * with the power kept; the records written after it must survive a mount.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "preset_journal.h"
+#include "flash_sim.h"
+#include "crc32.h"
+#include "test_framework.h"
+#include <stdlib.h>
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_KEYS                  JOURNAL_MAX_KEYS
+#define TEST_PAYLOAD               300
+#define TEST_ITERATIONS            20000
+#define RECORD_HEADER_SIZE         20          /* Journal record header in flash */
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t model[TEST_KEYS][TEST_PAYLOAD];
+static uint8_t modelExists[TEST_KEYS];
+
+/* Helpers -------------------------------------------------------------------*/
+
+static void FillRandom(uint8_t* data, uint32_t length)
+{
+  for (uint32_t i = 0; i < length; i++) {
+    data[i] = (uint8_t)rand();
+  }
+}
+
+/* Format blank storage and start with an empty model */
+static uint8_t StartBlank(void)
+{
+  FlashSim_Reset(0xFF);
+  memset(modelExists, 0, sizeof(modelExists));
+
+  if (PresetJournal_Init() != JOURNAL_STATUS_UNFORMATTED ||
+      PresetJournal_BeginFormat(0, 0) != JOURNAL_STATUS_OK ||
+      PresetJournal_EndFormat() != JOURNAL_STATUS_OK) {
+    return 0;
+  }
+  return PresetJournal_Init() == JOURNAL_STATUS_OK;
+}
+
+/* Compare every key with the model */
+static int CheckModel(void)
+{
+  uint8_t data[TEST_PAYLOAD];
+
+  for (int key = 0; key < TEST_KEYS; key++) {
+    uint8_t found = (PresetJournal_Read((uint8_t)key, data, TEST_PAYLOAD) == JOURNAL_STATUS_OK);
+    if (found != modelExists[key] || (found && memcmp(data, model[key], TEST_PAYLOAD) != 0)) {
+      return key;
+    }
+  }
+  return -1;
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* Blank or foreign storage is left alone at mount */
+static void test_mount_does_not_format(void)
+{
+  uint8_t data[16] = {0};
+
+  FlashSim_Reset(0xFF);
+  memcpy(flashSim, "OLD PRESET DATA", 16);
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+  TEST_ASSERT(FlashSim_GetEraseCount() == 0);
+  TEST_ASSERT(memcmp(flashSim, "OLD PRESET DATA", 16) == 0);
+  TEST_ASSERT(PresetJournal_Write(5, data, sizeof(data)) == JOURNAL_STATUS_UNFORMATTED);
+}
+
+/* A format keeps the given range until it is activated */
+static void test_format_keeps_range(void)
+{
+  uint8_t old[64];
+  uint8_t data[64];
+
+  FlashSim_Reset(0xFF);
+  FillRandom(old, sizeof(old));
+  memcpy(flashSim, old, sizeof(old));
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+  TEST_ASSERT(PresetJournal_BeginFormat(JOURNAL_BASE_ADDR, sizeof(old)) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetJournal_Write(5, old, sizeof(old)) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(memcmp(flashSim, old, sizeof(old)) == 0);
+
+  /* Not activated: still unformatted after a restart, old data intact */
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+  TEST_ASSERT(memcmp(flashSim, old, sizeof(old)) == 0);
+
+  TEST_ASSERT(PresetJournal_BeginFormat(JOURNAL_BASE_ADDR, sizeof(old)) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetJournal_Write(5, old, sizeof(old)) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetJournal_EndFormat() == JOURNAL_STATUS_OK);
+  TEST_ASSERT(flashSim[0] == 0xFF);
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetJournal_Read(5, data, sizeof(data)) == JOURNAL_STATUS_OK);
+  TEST_ASSERT(memcmp(data, old, sizeof(old)) == 0);
+
+  /* A range over both sectors cannot be kept */
+  FlashSim_Reset(0x00);
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+  TEST_ASSERT(PresetJournal_BeginFormat(JOURNAL_BASE_ADDR, FLASH_SIM_SIZE) == JOURNAL_STATUS_INVALID);
+}
+
+/* A power cut at any point of a format loses neither the kept data nor the journal */
+static void test_power_cut_during_format(void)
+{
+  uint8_t old[TEST_PAYLOAD];
+  uint8_t data[TEST_PAYLOAD];
+
+  FillRandom(old, sizeof(old));
+
+  for (long budget = 0; ; budget += 7) {
+    FlashSim_Reset(0xFF);
+    memcpy(flashSim, old, sizeof(old));
+    TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_UNFORMATTED);
+
+    FlashSim_CutPowerAfter(budget);
+    uint8_t ok = (PresetJournal_BeginFormat(JOURNAL_BASE_ADDR, sizeof(old)) == JOURNAL_STATUS_OK) &&
+                 (PresetJournal_Write(5, old, sizeof(old)) == JOURNAL_STATUS_OK) &&
+                 (PresetJournal_Write(6, old, sizeof(old)) == JOURNAL_STATUS_OK) &&
+                 (PresetJournal_EndFormat() == JOURNAL_STATUS_OK);
+    uint8_t cut = FlashSim_PowerLost();
+    FlashSim_PowerOn();
+
+    uint8_t status = PresetJournal_Init();
+    if (status == JOURNAL_STATUS_UNFORMATTED) {
+      TEST_ASSERT(cut);
+      if (memcmp(flashSim, old, sizeof(old)) != 0) {
+        TEST_FAIL("kept data lost by a cut after %ld bytes", budget);
+      }
+    } else {
+      TEST_ASSERT(status == JOURNAL_STATUS_OK);
+      if (PresetJournal_Read(5, data, sizeof(data)) != JOURNAL_STATUS_OK ||
+          memcmp(data, old, sizeof(old)) != 0 ||
+          PresetJournal_Read(6, data, sizeof(data)) != JOURNAL_STATUS_OK) {
+        TEST_FAIL("journal incomplete after a cut after %ld bytes", budget);
+      }
+    }
+
+    if (ok && !cut) {
+      break;
+    }
+  }
+}
+
+/* A runtime erase of the spare sector is polled across steps, not waited for */
+static void test_erase_spread_over_steps(void)
+{
+  uint8_t data[TEST_PAYLOAD];
+  JournalStats_t stats;
+  uint32_t erasingSteps = 0;
+  uint8_t key = 0;
+
+  srand(2);
+  TEST_ASSERT(StartBlank());
+
+  /* The first compaction uses the spare erased at format; the rest erase */
+  do {
+    FillRandom(data, sizeof(data));
+    TEST_ASSERT(PresetJournal_BeginWrite(key, data, sizeof(data)) == JOURNAL_STATUS_OK);
+
+    uint8_t status;
+    do {
+      status = PresetJournal_Step();
+      if (FlashSim_ErasePending()) {
+        erasingSteps++;
+      }
+    } while (status == JOURNAL_STATUS_BUSY);
+    TEST_ASSERT(status == JOURNAL_STATUS_OK);
+
+    memcpy(model[key], data, sizeof(data));
+    modelExists[key] = 1;
+    key = (uint8_t)((key + 1) % 8);
+
+    PresetJournal_GetStats(&stats);
+  } while (stats.compactions < 4);
+
+  TEST_ASSERT(erasingSteps == (stats.compactions - 1) * FLASH_SIM_ERASE_POLLS);
+  TEST_ASSERT(CheckModel() < 0);
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  TEST_ASSERT(CheckModel() < 0);
+}
+
+/* A failed write, in its header or later, hides no record written after it */
+static void test_failed_write(void)
+{
+  uint8_t data[TEST_PAYLOAD];
+  int bad;
+
+  srand(3);
+
+  for (long fail = 0; fail < RECORD_HEADER_SIZE + 16; fail++) {
+    TEST_ASSERT(StartBlank());
+
+    for (uint8_t key = 0; key < 4; key++) {
+      FillRandom(model[key], TEST_PAYLOAD);
+      modelExists[key] = 1;
+      TEST_ASSERT(PresetJournal_Write(key, model[key], TEST_PAYLOAD) == JOURNAL_STATUS_OK);
+    }
+
+    /* Key 1 keeps its old value */
+    FillRandom(data, sizeof(data));
+    FlashSim_FailWriteAfter(fail);
+    TEST_ASSERT(PresetJournal_Write(1, data, sizeof(data)) == JOURNAL_STATUS_ERROR);
+    TEST_ASSERT(!FlashSim_PowerLost());
+
+    for (uint8_t key = 4; key < 8; key++) {
+      FillRandom(model[key], TEST_PAYLOAD);
+      modelExists[key] = 1;
+      TEST_ASSERT(PresetJournal_Write(key, model[key], TEST_PAYLOAD) == JOURNAL_STATUS_OK);
+    }
+    TEST_ASSERT(CheckModel() < 0);
+
+    TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+    if ((bad = CheckModel()) >= 0) {
+      TEST_FAIL("write failed after %ld bytes: key %d lost at mount", fail, bad);
+    }
+
+    /* The journal goes on from there */
+    FillRandom(model[1], TEST_PAYLOAD);
+    TEST_ASSERT(PresetJournal_Write(1, model[1], TEST_PAYLOAD) == JOURNAL_STATUS_OK);
+    TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+    if ((bad = CheckModel()) >= 0) {
+      TEST_FAIL("write failed after %ld bytes: key %d lost after a rewrite", fail, bad);
+    }
+  }
+}
+
+/* Random writes and deletes with random power cuts, checked against a model */
+static void test_random_power_cuts(void)
+{
+  uint8_t data[TEST_PAYLOAD];
+  uint8_t readBack[TEST_PAYLOAD];
+  JournalStats_t stats;
+  int bad;
+
+  srand(1);
+  TEST_ASSERT(StartBlank());
+
+  for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+    uint8_t key = (uint8_t)(rand() % TEST_KEYS);
+    uint8_t remove = (rand() % 10 == 0);
+    FillRandom(data, sizeof(data));
+
+    FlashSim_CutPowerAfter((rand() % 20 == 0) ? rand() % 400 : -1);
+    uint8_t status = remove ? PresetJournal_Delete(key)
+                            : PresetJournal_Write(key, data, sizeof(data));
+
+    if (FlashSim_PowerLost()) {
+      /* Mount again: the key holds its old or its new value */
+      FlashSim_PowerOn();
+      TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+
+      uint8_t found = (PresetJournal_Read(key, readBack, sizeof(readBack)) == JOURNAL_STATUS_OK);
+      uint8_t isNew = remove ? !found : (found && memcmp(readBack, data, sizeof(data)) == 0);
+      uint8_t isOld = modelExists[key] ? (found && memcmp(readBack, model[key], sizeof(data)) == 0)
+                                       : !found;
+      if (!isNew && !isOld) {
+        TEST_FAIL("iteration %d: key %d is neither old nor new", iter, key);
+      }
+      if (!isNew) {
+        continue;
+      }
+    } else if (status != JOURNAL_STATUS_OK) {
+      TEST_FAIL("iteration %d: status %d", iter, status);
+    }
+
+    modelExists[key] = !remove;
+    if (!remove) {
+      memcpy(model[key], data, sizeof(data));
+    }
+
+    FlashSim_PowerOn();
+    if (iter % 97 == 0) {
+      TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+    }
+    if ((bad = CheckModel()) >= 0) {
+      TEST_FAIL("iteration %d: key %d differs from the model", iter, bad);
+    }
+  }
+
+  /* Both sectors took turns */
+  PresetJournal_GetStats(&stats);
+  TEST_ASSERT(stats.eraseCount[0] > 10 && stats.eraseCount[1] > 10);
+  printf("  sector erase counts %lu/%lu\n",
+         (unsigned long)stats.eraseCount[0], (unsigned long)stats.eraseCount[1]);
+}
+
+int main(void)
+{
+  Crc32_Init();
+
+  RUN_TEST(test_mount_does_not_format);
+  RUN_TEST(test_format_keeps_range);
+  RUN_TEST(test_power_cut_during_format);
+  RUN_TEST(test_erase_spread_over_steps);
+  RUN_TEST(test_failed_write);
+  RUN_TEST(test_random_power_cuts);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
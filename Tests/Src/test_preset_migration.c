@@ -0,0 +1,346 @@
+ /**
+  ******************************************************************************
+  * @file           : test_preset_migration.c
+  * @brief          : Host test of the upgrade from the fixed preset slots of
+  *                   older firmware to the preset journal
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The simulated flash is set up as older firmware left it: raw Preset_t
+  * structures at 0x0800C000 + (presetId - USER_PRESET_START_ID) *
+  * sizeof(Preset_t), validated by PRESET_VALID_MARKER plus the byte sum of the
+  * settings. PresetManager_Init() must bring every valid preset over to the
+  * journal with its name, timestamp and settings, also when the power is cut
+  * at any point of the upgrade. Deletes and renames at run time go through
+  * the background save queue, one journal step per PresetManager_Task().
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "preset_manager.h"
+#include "preset_codec.h"
+#include "preset_journal.h"
+#include "factory_presets.h"
+#include "flash_sim.h"
+#include "crc32.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+/* Layout of the older firmware */
+#define LEGACY_BASE_ADDR           0x0800C000
+#define LEGACY_VALID_MARKER        0xABCD1234
+
+/* Private variables ---------------------------------------------------------*/
+static const uint8_t legacyIds[] = { 5, 7, 14 };
+static uint8_t doneCount;
+static uint8_t doneStatus;
+
+/* Factory presets (not under test) ------------------------------------------*/
+
+uint8_t FactoryPresets_GetPreset(uint8_t presetId, PresetSettings_t* settings)
+{
+  memset(settings, 0, sizeof(PresetSettings_t));
+  return (presetId < USER_PRESET_START_ID) ? 0 : 1;
+}
+
+const char* FactoryPresets_GetName(uint8_t presetId)
+{
+  return (presetId < USER_PRESET_START_ID) ? "Factory" : NULL;
+}
+
+/* Helpers -------------------------------------------------------------------*/
+
+/* Settings on the codec's quantization grid, different for each preset */
+static void MakeSettings(uint8_t presetId, PresetSettings_t* settings)
+{
+  memset(settings, 0, sizeof(PresetSettings_t));
+
+  settings->crossover.lowCutoff = 60.0f + presetId;
+  settings->crossover.midCutoff = 500.0f + 10.0f * presetId;
+  settings->crossover.highCutoff = 4000.0f + 100.0f * presetId;
+  settings->crossover.subGain = -0.5f * presetId;
+  settings->crossover.highGain = 1.5f;
+  settings->crossover.filterType = 1;
+  settings->crossover.filterOrder = 4;
+  settings->crossover.midMute = presetId & 1;
+
+  settings->compressor.low.threshold = -20.5f;
+  settings->compressor.low.ratio = 4.0f;
+  settings->compressor.low.attack = 0.25f;
+  settings->compressor.low.release = 250.0f;
+  settings->compressor.low.enabled = 1;
+
+  settings->limiter.sub.threshold = -1.0f;
+  settings->limiter.sub.release = 50.0f;
+  settings->limiter.sub.enabled = 1;
+
+  settings->delay.midDelay = 0.01f * presetId;
+  settings->delay.highPhaseInvert = 1;
+}
+
+/* Write a preset to its fixed slot, as older firmware stored it */
+static void WriteLegacySlot(uint8_t presetId, const PresetSettings_t* settings, uint32_t timestamp)
+{
+  Preset_t preset;
+  const uint8_t* bytes = (const uint8_t*)&preset.settings;
+
+  memset(&preset, 0, sizeof(preset));
+  preset.metadata.presetId = presetId;
+  snprintf(preset.metadata.name, sizeof(preset.metadata.name), "Stage %d", presetId);
+  preset.metadata.timestamp = timestamp;
+  preset.settings = *settings;
+
+  preset.metadata.checksum = LEGACY_VALID_MARKER;
+  for (uint32_t i = 0; i < sizeof(PresetSettings_t); i++) {
+    preset.metadata.checksum += bytes[i];
+  }
+
+  uint32_t offset = LEGACY_BASE_ADDR - FLASH_SIM_BASE +
+                    (uint32_t)(presetId - USER_PRESET_START_ID) * sizeof(Preset_t);
+  memcpy(&flashSim[offset], &preset, sizeof(preset));
+}
+
+static void CountDone(uint8_t presetId, uint8_t status)
+{
+  doneCount++;
+  doneStatus = status;
+}
+
+/* Run the queue to the end; returns the number of steps it took */
+static uint32_t RunQueue(void)
+{
+  uint32_t steps = 0;
+
+  doneCount = 0;
+  while (PresetManager_IsBusy() && steps < 100000) {
+    PresetManager_Task();
+    steps++;
+  }
+  return steps;
+}
+
+/* Lay out flash as older firmware left it; returns the image of the slots */
+static void WriteLegacyFlash(uint8_t* image)
+{
+  PresetSettings_t settings;
+
+  FlashSim_Reset(0xFF);
+  for (uint8_t i = 0; i < sizeof(legacyIds); i++) {
+    MakeSettings(legacyIds[i], &settings);
+    WriteLegacySlot(legacyIds[i], &settings, 1000U * legacyIds[i]);
+  }
+
+  /* A slot that fails its checksum is not a preset */
+  MakeSettings(6, &settings);
+  WriteLegacySlot(6, &settings, 6000U);
+  flashSim[LEGACY_BASE_ADDR - FLASH_SIM_BASE + sizeof(Preset_t) + sizeof(PresetMetadata_t)] ^= 0x40;
+
+  memcpy(image, flashSim, 10 * sizeof(Preset_t));
+}
+
+/* Check a migrated preset against the one that was in its slot */
+static int CheckMigrated(uint8_t presetId)
+{
+  PresetSettings_t expected;
+  PresetSettings_t loaded;
+  PresetMetadata_t metadata;
+  PresetMetadata_t scratch;
+  uint8_t record[PRESET_CODEC_MAX_SIZE];
+  uint8_t expectedRecord[PRESET_CODEC_MAX_SIZE];
+  uint16_t length;
+  uint16_t expectedLength;
+  char name[16];
+
+  MakeSettings(presetId, &expected);
+  snprintf(name, sizeof(name), "Stage %d", presetId);
+
+  if (PresetManager_LoadPreset(presetId, &loaded) != PRESET_STATUS_OK ||
+      PresetManager_ExportPreset(presetId, record, sizeof(record), &length) != PRESET_STATUS_OK ||
+      PresetCodec_Decode(record, length, NULL, &metadata) != PRESET_CODEC_OK) {
+    return 0;
+  }
+
+  if (strcmp(metadata.name, name) != 0 || metadata.timestamp != 1000U * presetId) {
+    return 0;
+  }
+
+  /* The stored record is what the codec makes of the old settings */
+  scratch = metadata;
+  if (PresetCodec_Encode(&expected, &scratch, expectedRecord, sizeof(expectedRecord),
+                         &expectedLength) != PRESET_CODEC_OK ||
+      expectedLength != length || memcmp(expectedRecord, record, length) != 0) {
+    return 0;
+  }
+
+  return loaded.crossover.midCutoff == expected.crossover.midCutoff &&
+         loaded.compressor.low.threshold == expected.compressor.low.threshold &&
+         loaded.crossover.midMute == expected.crossover.midMute;
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* Every valid fixed slot ends up in the journal, then the slots are erased */
+static void test_migrates_fixed_slots(void)
+{
+  uint8_t image[10 * sizeof(Preset_t)];
+  PresetSettings_t settings;
+
+  WriteLegacyFlash(image);
+  PresetManager_Init();
+
+  for (uint8_t i = 0; i < sizeof(legacyIds); i++) {
+    if (!CheckMigrated(legacyIds[i])) {
+      TEST_FAIL("preset %d not migrated", legacyIds[i]);
+    }
+  }
+  TEST_ASSERT(PresetManager_LoadPreset(6, &settings) == PRESET_STATUS_EMPTY);
+  TEST_ASSERT(PresetManager_GetPresetCount() == USER_PRESET_START_ID + sizeof(legacyIds));
+
+  /* The slots are gone, the presets stay after a restart */
+  TEST_ASSERT(memcmp(flashSim, image, sizeof(image)) != 0);
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  for (uint8_t i = 0; i < sizeof(legacyIds); i++) {
+    TEST_ASSERT(CheckMigrated(legacyIds[i]));
+  }
+}
+
+/* A power cut at any point of the upgrade loses no preset */
+static void test_power_cut_during_migration(void)
+{
+  uint8_t image[10 * sizeof(Preset_t)];
+  long budget;
+
+  for (budget = 0; ; budget += 5) {
+    WriteLegacyFlash(image);
+    FlashSim_CutPowerAfter(budget);
+    PresetManager_Init();
+    uint8_t cut = FlashSim_PowerLost();
+    FlashSim_PowerOn();
+
+    /* Either the slots are untouched or the journal has every preset */
+    uint8_t status = PresetJournal_Init();
+    if (status == JOURNAL_STATUS_UNFORMATTED) {
+      if (memcmp(flashSim, image, sizeof(image)) != 0) {
+        TEST_FAIL("fixed slots damaged by a cut after %ld bytes", budget);
+      }
+    } else {
+      TEST_ASSERT(status == JOURNAL_STATUS_OK);
+      for (uint8_t i = 0; i < sizeof(legacyIds); i++) {
+        if (!CheckMigrated(legacyIds[i])) {
+          TEST_FAIL("preset %d lost by a cut after %ld bytes", legacyIds[i], budget);
+        }
+      }
+    }
+
+    /* The next boot completes the upgrade */
+    PresetManager_Init();
+    for (uint8_t i = 0; i < sizeof(legacyIds); i++) {
+      if (!CheckMigrated(legacyIds[i])) {
+        TEST_FAIL("preset %d not migrated after a cut after %ld bytes", legacyIds[i], budget);
+      }
+    }
+
+    if (!cut) {
+      break;
+    }
+  }
+
+  printf("  %ld cut points\n", budget / 5);
+}
+
+/* Blank flash gets an empty journal */
+static void test_blank_flash(void)
+{
+  PresetSettings_t settings;
+
+  FlashSim_Reset(0xFF);
+  PresetManager_Init();
+
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  for (uint8_t presetId = USER_PRESET_START_ID; presetId < TOTAL_PRESET_COUNT; presetId++) {
+    TEST_ASSERT(PresetManager_LoadPreset(presetId, &settings) == PRESET_STATUS_EMPTY);
+  }
+
+  MakeSettings(9, &settings);
+  TEST_ASSERT(PresetManager_SavePreset(9, &settings) == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetManager_LoadPreset(9, &settings) == PRESET_STATUS_OK);
+}
+
+/* Deletes and renames are queued and written one step at a time */
+static void test_background_delete_and_rename(void)
+{
+  PresetSettings_t settings;
+  PresetSettings_t loaded;
+  PresetMetadata_t info;
+
+  FlashSim_Reset(0xFF);
+  PresetManager_Init();
+  for (uint8_t presetId = 10; presetId <= 12; presetId++) {
+    MakeSettings(presetId, &settings);
+    TEST_ASSERT(PresetManager_SavePreset(presetId, &settings) == PRESET_STATUS_OK);
+  }
+
+  /* Delete: the preset stays until the tombstone is written */
+  TEST_ASSERT(PresetManager_DeletePresetAsync(10, CountDone) == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetManager_IsBusy());
+  TEST_ASSERT(PresetManager_GetPresetInfo(10, &info) == PRESET_STATUS_OK);
+  TEST_ASSERT(RunQueue() > 1);
+  TEST_ASSERT(doneCount == 1 && doneStatus == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetManager_GetPresetInfo(10, &info) == PRESET_STATUS_EMPTY);
+  TEST_ASSERT(PresetManager_LoadPreset(10, &loaded) == PRESET_STATUS_EMPTY);
+
+  /* Rename keeps the settings */
+  TEST_ASSERT(PresetManager_RenamePresetAsync(11, "Hall", CountDone) == PRESET_STATUS_OK);
+  TEST_ASSERT(RunQueue() > 1);
+  TEST_ASSERT(doneCount == 1 && doneStatus == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetManager_FindPreset("Hall") == 11);
+  MakeSettings(11, &settings);
+  TEST_ASSERT(PresetManager_LoadPreset(11, &loaded) == PRESET_STATUS_OK);
+  TEST_ASSERT(memcmp(&loaded, &settings, sizeof(settings)) == 0);
+
+  /* A rename of a save still queued renames the new settings */
+  MakeSettings(13, &settings);
+  TEST_ASSERT(PresetManager_SavePresetAsync(12, &settings, NULL) == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetManager_RenamePresetAsync(12, "Club", NULL) == PRESET_STATUS_OK);
+  RunQueue();
+  TEST_ASSERT(PresetManager_FindPreset("Club") == 12);
+  TEST_ASSERT(PresetManager_LoadPreset(12, &loaded) == PRESET_STATUS_OK);
+  TEST_ASSERT(memcmp(&loaded, &settings, sizeof(settings)) == 0);
+
+  /* A queued delete hides the preset from a rename */
+  TEST_ASSERT(PresetManager_DeletePresetAsync(12, NULL) == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetManager_RenamePresetAsync(12, "Gone", NULL) == PRESET_STATUS_EMPTY);
+  RunQueue();
+
+  /* All of it survives a restart */
+  TEST_ASSERT(PresetJournal_Init() == JOURNAL_STATUS_OK);
+  TEST_ASSERT(PresetManager_LoadPreset(10, &loaded) == PRESET_STATUS_EMPTY);
+  TEST_ASSERT(PresetManager_LoadPreset(11, &loaded) == PRESET_STATUS_OK);
+  TEST_ASSERT(PresetManager_LoadPreset(12, &loaded) == PRESET_STATUS_EMPTY);
+}
+
+int main(void)
+{
+  Crc32_Init();
+
+  RUN_TEST(test_migrates_fixed_slots);
+  RUN_TEST(test_power_cut_during_migration);
+  RUN_TEST(test_blank_flash);
+  RUN_TEST(test_background_delete_and_rename);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,385 @@
+ /**
+  ******************************************************************************
+  * @file           : test_preset_morph.c
+  * @brief          : Host test of the preset morph interpolation
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The DSP modules below record what each morph stage hands them. A control
+  * update is driven as four PresetMorph_Tick() calls, the first carrying the
+  * frames that set the position, so the morph can be stopped exactly at
+  * t = 0, 0.5 and 1. The settings there must follow the interpolation rules
+  * of preset_morph.h: gains, thresholds and delays linear, cutoffs and time
+  * constants geometric, the ratio through its slope, switches at the
+  * midpoint and a muted band faded through MORPH_MUTE_GAIN_DB. A new morph
+  * started from the settings in use, as MorphToPreset() in main.c does, must
+  * carry on from where the first one was without a jump.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "preset_morph.h"
+#include "crossover.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "delay.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MORPH_MS                   48
+#define MORPH_FRAMES               (MORPH_MS * AUDIO_SAMPLE_RATE_HZ / 1000)
+#define HALF_FRAMES                (MORPH_FRAMES / 2)
+
+#define RELATIVE_TOLERANCE         1e-4f
+
+/* Compare one field, failing the test with its name */
+#define CHECK_FLOAT(actual, expected, field)                                              \
+  do {                                                                                    \
+    if (!Near((actual)->field, (expected)->field)) {                                      \
+      TEST_FAIL("%s: %s = %g, expected %g", label, #field,                                \
+                (double)(actual)->field, (double)(expected)->field);                      \
+    }                                                                                     \
+  } while (0)
+
+#define CHECK_INT(actual, expected, field)                                                \
+  do {                                                                                    \
+    if ((actual)->field != (expected)->field) {                                           \
+      TEST_FAIL("%s: %s = %d, expected %d", label, #field,                                \
+                (int)(actual)->field, (int)(expected)->field);                            \
+    }                                                                                     \
+  } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static SystemSettings_t settings;
+static SystemSettings_t presetA;
+static SystemSettings_t presetB;
+static SystemSettings_t midpoint;
+
+/* What the stages last handed to the DSP modules */
+static CrossoverSettings_t coefficientSettings;
+static CompressorSettings_t compressorSettings;
+static LimiterSettings_t limiterSettings;
+static DelaySettings_t delaySettings;
+static uint32_t coefficientUpdates;
+
+/* DSP modules (stand-ins) ---------------------------------------------------*/
+
+void Crossover_UpdateCoefficients(struct CrossoverSettings_t *crossover)
+{
+  coefficientSettings = *crossover;
+  coefficientUpdates++;
+}
+
+void Compressor_SetSettings(const CompressorSettings_t* compressor)
+{
+  compressorSettings = *compressor;
+}
+
+void Limiter_SetSettings(const LimiterSettings_t* limiter)
+{
+  limiterSettings = *limiter;
+}
+
+void Delay_SetSettings(const DelaySettings_t *delay)
+{
+  delaySettings = *delay;
+}
+
+/* Helpers -------------------------------------------------------------------*/
+
+static uint8_t Near(float actual, float expected)
+{
+  return fabsf(actual - expected) <= RELATIVE_TOLERANCE * MAX(1.0f, fabsf(expected));
+}
+
+/* Field by field, so a mismatch names the parameter */
+static void CheckSettings(const SystemSettings_t* actual, const SystemSettings_t* expected,
+                          const char* label)
+{
+  CHECK_FLOAT(actual, expected, crossover.lowCutoff);
+  CHECK_FLOAT(actual, expected, crossover.midCutoff);
+  CHECK_FLOAT(actual, expected, crossover.highCutoff);
+  CHECK_FLOAT(actual, expected, crossover.subGain);
+  CHECK_FLOAT(actual, expected, crossover.lowGain);
+  CHECK_FLOAT(actual, expected, crossover.midGain);
+  CHECK_FLOAT(actual, expected, crossover.highGain);
+  CHECK_INT(actual, expected, crossover.filterType);
+  CHECK_INT(actual, expected, crossover.filterOrder);
+  CHECK_INT(actual, expected, crossover.subMute);
+  CHECK_INT(actual, expected, crossover.lowMute);
+  CHECK_INT(actual, expected, crossover.midMute);
+  CHECK_INT(actual, expected, crossover.highMute);
+
+  CHECK_FLOAT(actual, expected, compressor.sub.threshold);
+  CHECK_FLOAT(actual, expected, compressor.sub.ratio);
+  CHECK_FLOAT(actual, expected, compressor.sub.attack);
+  CHECK_FLOAT(actual, expected, compressor.sub.release);
+  CHECK_FLOAT(actual, expected, compressor.sub.makeupGain);
+  CHECK_INT(actual, expected, compressor.sub.enabled);
+  CHECK_FLOAT(actual, expected, limiter.mid.threshold);
+  CHECK_FLOAT(actual, expected, limiter.mid.release);
+  CHECK_INT(actual, expected, limiter.mid.enabled);
+
+  CHECK_FLOAT(actual, expected, delay.midDelay);
+  CHECK_FLOAT(actual, expected, delay.highDelay);
+  CHECK_INT(actual, expected, delay.subPhaseInvert);
+}
+
+/* Unit time constants and ratios elsewhere, so the log scale stays defined */
+static void MakeBase(SystemSettings_t* preset)
+{
+  memset(preset, 0, sizeof(SystemSettings_t));
+  preset->compressor.sub.ratio = preset->compressor.low.ratio = 1.0f;
+  preset->compressor.mid.ratio = preset->compressor.high.ratio = 1.0f;
+  preset->compressor.sub.attack = preset->compressor.sub.release = 1.0f;
+  preset->limiter.mid.release = 1.0f;
+}
+
+static void MakePresets(void)
+{
+  MakeBase(&presetA);
+  presetA.crossover.lowCutoff = 100.0f;
+  presetA.crossover.midCutoff = 1000.0f;
+  presetA.crossover.highCutoff = 5000.0f;
+  presetA.crossover.subGain = 0.0f;
+  presetA.crossover.lowGain = -6.0f;
+  presetA.crossover.highGain = 6.0f;
+  presetA.crossover.filterType = 0;
+  presetA.crossover.filterOrder = 2;
+  presetA.compressor.sub.threshold = -20.0f;
+  presetA.compressor.sub.ratio = 2.0f;
+  presetA.compressor.sub.attack = 10.0f;
+  presetA.compressor.sub.release = 100.0f;
+  presetA.compressor.sub.enabled = 1;
+  presetA.limiter.mid.threshold = -6.0f;
+  presetA.limiter.mid.release = 50.0f;
+  presetA.delay.midDelay = 2.0f;
+
+  /* The low band is muted in B */
+  MakeBase(&presetB);
+  presetB.crossover.lowCutoff = 400.0f;
+  presetB.crossover.midCutoff = 4000.0f;
+  presetB.crossover.highCutoff = 5000.0f;
+  presetB.crossover.subGain = -12.0f;
+  presetB.crossover.lowGain = 3.0f;
+  presetB.crossover.lowMute = 1;
+  presetB.crossover.highGain = 6.0f;
+  presetB.crossover.filterType = 1;
+  presetB.crossover.filterOrder = 4;
+  presetB.compressor.sub.threshold = -40.0f;
+  presetB.compressor.sub.ratio = 4.0f;
+  presetB.compressor.sub.attack = 40.0f;
+  presetB.compressor.sub.release = 400.0f;
+  presetB.compressor.sub.makeupGain = 6.0f;
+  presetB.limiter.mid.threshold = -2.0f;
+  presetB.limiter.mid.release = 200.0f;
+  presetB.limiter.mid.enabled = 1;
+  presetB.delay.midDelay = 4.0f;
+  presetB.delay.highDelay = 1.0f;
+  presetB.delay.subPhaseInvert = 1;
+
+  /* Halfway from A to B */
+  midpoint = presetA;
+  midpoint.crossover.lowCutoff = 200.0f;
+  midpoint.crossover.midCutoff = 2000.0f;
+  midpoint.crossover.subGain = -6.0f;
+  midpoint.crossover.lowGain = (-6.0f + MORPH_MUTE_GAIN_DB) / 2.0f;
+  midpoint.crossover.filterType = 1;
+  midpoint.crossover.filterOrder = 4;
+  midpoint.compressor.sub.threshold = -30.0f;
+  midpoint.compressor.sub.ratio = 1.0f / (1.0f - 0.625f);   /* Slopes 0.5 and 0.75 */
+  midpoint.compressor.sub.attack = 20.0f;
+  midpoint.compressor.sub.release = 200.0f;
+  midpoint.compressor.sub.makeupGain = 3.0f;
+  midpoint.compressor.sub.enabled = 0;
+  midpoint.limiter.mid.threshold = -4.0f;
+  midpoint.limiter.mid.release = 100.0f;
+  midpoint.limiter.mid.enabled = 1;
+  midpoint.delay.midDelay = 3.0f;
+  midpoint.delay.highDelay = 0.5f;
+  midpoint.delay.subPhaseInvert = 1;
+}
+
+/* One control update: the position moves by frames, then the other stages run */
+static void Update(uint16_t frames)
+{
+  PresetMorph_Tick(&settings, frames);
+  for (int stage = 1; stage < MORPH_CONTROL_BLOCKS; stage++) {
+    PresetMorph_Tick(&settings, 0);
+  }
+}
+
+static void StartAtoB(void)
+{
+  settings = presetA;
+  coefficientUpdates = 0;
+  PresetMorph_Start(&settings, &presetB, MORPH_MS);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* At t = 0 the settings are those of the start */
+static void test_start(void)
+{
+  StartAtoB();
+  TEST_ASSERT(PresetMorph_IsActive());
+  TEST_ASSERT(PresetMorph_GetProgress() == 0);
+
+  Update(0);
+  CheckSettings(&settings, &presetA, "t=0");
+  TEST_ASSERT(PresetMorph_IsActive());
+}
+
+/* At t = 0.5 every parameter follows its interpolation rule */
+static void test_midpoint(void)
+{
+  MorphStats_t stats;
+
+  StartAtoB();
+  Update(HALF_FRAMES);
+
+  CheckSettings(&settings, &midpoint, "t=0.5");
+  TEST_ASSERT(PresetMorph_GetProgress() == 50);
+
+  /* The modules were given the same values */
+  TEST_ASSERT(Near(coefficientSettings.lowCutoff, midpoint.crossover.lowCutoff));
+  TEST_ASSERT(Near(coefficientSettings.lowGain, midpoint.crossover.lowGain));
+  TEST_ASSERT(Near(compressorSettings.sub.ratio, midpoint.compressor.sub.ratio));
+  TEST_ASSERT(Near(limiterSettings.mid.release, midpoint.limiter.mid.release));
+  TEST_ASSERT(Near(delaySettings.midDelay, midpoint.delay.midDelay));
+
+  PresetMorph_GetStats(&stats);
+  TEST_ASSERT(stats.controlUpdates == 1 && coefficientUpdates == 1);
+}
+
+/* Each block runs one stage; the chain takes the values in two steps */
+static void test_stages(void)
+{
+  StartAtoB();
+
+  /* Interpolation only */
+  PresetMorph_Tick(&settings, HALF_FRAMES);
+  TEST_ASSERT(coefficientUpdates == 0);
+  TEST_ASSERT(memcmp(&settings, &presetA, sizeof(SystemSettings_t)) == 0);
+
+  /* Crossover coefficients */
+  PresetMorph_Tick(&settings, 0);
+  TEST_ASSERT(coefficientUpdates == 1);
+  TEST_ASSERT(Near(coefficientSettings.midCutoff, midpoint.crossover.midCutoff));
+  TEST_ASSERT(memcmp(&settings, &presetA, sizeof(SystemSettings_t)) == 0);
+
+  /* Dynamics */
+  PresetMorph_Tick(&settings, 0);
+  TEST_ASSERT(Near(settings.compressor.sub.threshold, midpoint.compressor.sub.threshold));
+  TEST_ASSERT(settings.crossover.subGain == presetA.crossover.subGain);
+
+  /* Band gains and delays */
+  PresetMorph_Tick(&settings, 0);
+  CheckSettings(&settings, &midpoint, "stage 3");
+}
+
+/* At t = 1 the target is applied exactly, mute flags included */
+static void test_end(void)
+{
+  MorphStats_t stats;
+
+  StartAtoB();
+  Update(HALF_FRAMES);
+  Update(HALF_FRAMES);
+
+  TEST_ASSERT(!PresetMorph_IsActive());
+  TEST_ASSERT(PresetMorph_GetProgress() == 100);
+  TEST_ASSERT(memcmp(&settings, &presetB, sizeof(SystemSettings_t)) == 0);
+
+  PresetMorph_GetStats(&stats);
+  TEST_ASSERT(stats.controlUpdates == 2);
+
+  /* Nothing moves once done */
+  Update(HALF_FRAMES);
+  TEST_ASSERT(memcmp(&settings, &presetB, sizeof(SystemSettings_t)) == 0);
+  TEST_ASSERT(coefficientUpdates == 2);
+}
+
+/* A new target mid-morph starts from the settings in use, without a jump */
+static void test_retarget(void)
+{
+  SystemSettings_t inUse;
+  SystemSettings_t expected;
+
+  StartAtoB();
+  Update(HALF_FRAMES);
+  inUse = settings;
+
+  /* Back to A, as MorphToPreset() does: from the settings in use */
+  PresetMorph_Start(&settings, &presetA, MORPH_MS);
+  TEST_ASSERT(PresetMorph_GetProgress() == 0);
+
+  Update(0);
+  CheckSettings(&settings, &inUse, "retarget t=0");
+  TEST_ASSERT(Near(coefficientSettings.lowCutoff, inUse.crossover.lowCutoff));
+
+  /* Halfway from the midpoint back to A */
+  expected = presetA;
+  expected.crossover.lowCutoff = sqrtf(200.0f * 100.0f);
+  expected.crossover.midCutoff = sqrtf(2000.0f * 1000.0f);
+  expected.crossover.subGain = -3.0f;
+  expected.crossover.lowGain = (midpoint.crossover.lowGain - 6.0f) / 2.0f;
+  expected.compressor.sub.threshold = -25.0f;
+  expected.compressor.sub.ratio = 1.0f / (1.0f - 0.5625f);   /* Slopes 0.625 and 0.5 */
+  expected.compressor.sub.attack = sqrtf(20.0f * 10.0f);
+  expected.compressor.sub.release = sqrtf(200.0f * 100.0f);
+  expected.compressor.sub.makeupGain = 1.5f;
+  expected.limiter.mid.threshold = -5.0f;
+  expected.limiter.mid.release = sqrtf(100.0f * 50.0f);
+  expected.delay.midDelay = 2.5f;
+  expected.delay.highDelay = 0.25f;
+
+  Update(HALF_FRAMES);
+  CheckSettings(&settings, &expected, "retarget t=0.5");
+
+  Update(HALF_FRAMES);
+  TEST_ASSERT(!PresetMorph_IsActive());
+  TEST_ASSERT(memcmp(&settings, &presetA, sizeof(SystemSettings_t)) == 0);
+}
+
+/* Stopping keeps the intermediate settings */
+static void test_stop(void)
+{
+  SystemSettings_t stopped;
+
+  StartAtoB();
+  Update(HALF_FRAMES);
+  stopped = settings;
+
+  PresetMorph_Stop();
+  TEST_ASSERT(!PresetMorph_IsActive());
+  Update(HALF_FRAMES);
+  TEST_ASSERT(memcmp(&settings, &stopped, sizeof(SystemSettings_t)) == 0);
+}
+
+int main(void)
+{
+  MakePresets();
+
+  RUN_TEST(test_start);
+  RUN_TEST(test_midpoint);
+  RUN_TEST(test_stages);
+  RUN_TEST(test_end);
+  RUN_TEST(test_retarget);
+  RUN_TEST(test_stop);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,275 @@
+ /**
+  ******************************************************************************
+  * @file           : test_rotary_encoder.c
+  * @brief          : Host test of the polled rotary encoder decoder
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Quadrature traces are played on the GPIOB stand-in with 1 us resolution
+  * while the TIM3 interrupt is modelled as in main.c: the pins are read at
+  * ROTARY_SAMPLE_HZ and the rotation is queued every 1 ms. The steps taken
+  * from the input queue must match the detents turned, also when edges come
+  * faster than the pins are read or bounce.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rotary_encoder.h"
+#include "input_queue.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SAMPLE_US                  (1000000U / ROTARY_SAMPLE_HZ)
+#define SAMPLES_PER_MS             (ROTARY_SAMPLE_HZ / 1000)
+
+#define PIN_A                      GPIO_PIN_0
+#define PIN_B                      GPIO_PIN_1
+#define PIN_BUTTON                 GPIO_PIN_2
+
+/* Private variables ---------------------------------------------------------*/
+volatile uint32_t systemTick = 0;   /* Normally kept by TIM2 in main.c */
+
+/* AB pin states in clockwise order */
+static const uint8_t cwSequence[4] = { 0x0, 0x1, 0x3, 0x2 };
+
+static uint32_t nowUs;
+static uint32_t sampleCount;
+static uint8_t phase;
+
+/* Main loop model: takes the queued steps every 1 ms unless paused */
+static uint8_t mainLoopPaused;
+static int32_t takenSteps;
+static uint32_t takenEvents;
+
+/* Helpers -------------------------------------------------------------------*/
+
+/* Drive the pins for a quadrature phase; the button stays released (high) */
+static void SetPhase(uint8_t newPhase)
+{
+  uint8_t ab = cwSequence[newPhase & 3];
+
+  phase = newPhase & 3;
+  hostGpioB.IDR = PIN_BUTTON | ((ab & 0x2) ? PIN_A : 0) | ((ab & 0x1) ? PIN_B : 0);
+}
+
+/* Take the queued encoder steps */
+static void MainLoop(void)
+{
+  InputEvent_t event;
+
+  while (InputQueue_Pop(&event)) {
+    if (event.source == INPUT_SOURCE_ENCODER) {
+      takenSteps += event.value;
+      takenEvents++;
+    }
+  }
+}
+
+/* Let time pass, running the TIM3 interrupt as main.c does */
+static void Advance(uint32_t us)
+{
+  while (us--) {
+    nowUs++;
+    if (nowUs % SAMPLE_US != 0) {
+      continue;
+    }
+    RotaryEncoder_SamplePins();
+    if (++sampleCount >= SAMPLES_PER_MS) {
+      sampleCount = 0;
+      systemTick++;
+      RotaryEncoder_Sample();
+      if (!mainLoopPaused) {
+        MainLoop();
+      }
+    }
+  }
+}
+
+/* Turn by whole detents with edgeUs between edges; each edge bounces
+   'bounces' times for bounceUs before it settles */
+static void Turn(int32_t detents, uint32_t edgeUs, uint8_t bounces, uint32_t bounceUs)
+{
+  int8_t direction = (detents > 0) ? 1 : -1;
+  uint32_t edges = 4 * (uint32_t)((detents > 0) ? detents : -detents);
+
+  for (uint32_t i = 0; i < edges; i++) {
+    uint8_t from = phase;
+    uint8_t to = (uint8_t)(phase + direction);
+
+    for (uint8_t b = 0; b < bounces; b++) {
+      SetPhase(to);
+      Advance(bounceUs);
+      SetPhase(from);
+      Advance(bounceUs);
+    }
+    SetPhase(to);
+    Advance(edgeUs - 2 * bounces * bounceUs);
+  }
+}
+
+/* Steps taken by the main loop since the last call */
+static int32_t TakeSteps(uint32_t* events)
+{
+  int32_t steps;
+
+  MainLoop();
+  steps = takenSteps;
+  *events = takenEvents;
+  takenSteps = 0;
+  takenEvents = 0;
+  return steps;
+}
+
+/* Encoder at rest on a detent, empty queue */
+static void Start(RotaryMode_t mode)
+{
+  nowUs = 0;
+  sampleCount = 0;
+  mainLoopPaused = 0;
+  takenSteps = 0;
+  takenEvents = 0;
+  SetPhase(0);
+  InputQueue_Init();
+  RotaryEncoder_Init();
+  RotaryEncoder_SetMode(mode);
+  Advance(100000);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* One step per detent when turned slowly, both ways */
+static void test_slow_detents(void)
+{
+  uint32_t events;
+
+  Start(ROTARY_MODE_NORMAL);
+  Turn(10, 50000, 0, 0);
+  TEST_ASSERT(TakeSteps(&events) == 10);
+  TEST_ASSERT(events == 10);
+
+  Turn(-7, 50000, 0, 0);
+  TEST_ASSERT(TakeSteps(&events) == -7);
+
+  /* Half a detent is not a step */
+  Turn(1, 50000, 0, 0);
+  TakeSteps(&events);
+  SetPhase(phase + 1);
+  Advance(50000);
+  SetPhase(phase + 1);
+  Advance(50000);
+  TEST_ASSERT(TakeSteps(&events) == 0);
+}
+
+/* Edges closer together than the sample period: skipped states are counted.
+   A turn starts from rest, so its first detent is turned slowly. */
+static void test_fast_turn_keeps_every_detent(void)
+{
+  static const uint32_t edgeUs[] = { 400, 200, 150, 130, 100, 70 };
+  uint32_t events;
+
+  for (uint32_t i = 0; i < sizeof(edgeUs) / sizeof(edgeUs[0]); i++) {
+    Start(ROTARY_MODE_FINE);
+    Turn(1, 2000, 0, 0);
+    Turn(49, edgeUs[i], 0, 0);
+    Advance(10000);
+    int32_t steps = TakeSteps(&events);
+    if (steps != 50) {
+      TEST_FAIL("edges %lu us apart: %ld steps for 50 detents", (unsigned long)edgeUs[i], (long)steps);
+    }
+
+    Turn(-1, 2000, 0, 0);
+    Turn(-49, edgeUs[i], 0, 0);
+    Advance(10000);
+    steps = TakeSteps(&events);
+    if (steps != -50) {
+      TEST_FAIL("edges %lu us apart: %ld steps for -50 detents", (unsigned long)edgeUs[i], (long)steps);
+    }
+  }
+}
+
+/* Contact bounce on every edge does not add or lose detents */
+static void test_bounce(void)
+{
+  uint32_t events;
+
+  Start(ROTARY_MODE_FINE);
+  Turn(20, 2000, 3, 40);
+  Turn(-5, 2000, 3, 40);
+  Turn(12, 1000, 2, 60);
+  Advance(10000);
+  TEST_ASSERT(TakeSteps(&events) == 27);
+}
+
+/* Fast turns accelerate in normal mode, never in fine mode */
+static void test_acceleration(void)
+{
+  uint32_t events;
+  int32_t steps;
+
+  Start(ROTARY_MODE_NORMAL);
+  Turn(20, 1000, 0, 0);
+  steps = TakeSteps(&events);
+  TEST_ASSERT(steps > 20);
+
+  Start(ROTARY_MODE_COARSE);
+  Turn(4, 50000, 0, 0);
+  TEST_ASSERT(TakeSteps(&events) == 20);
+}
+
+/* Steps refused by a full queue are queued once there is room */
+static void test_queue_full_keeps_steps(void)
+{
+  InputQueueStats_t stats;
+  uint32_t events;
+
+  Start(ROTARY_MODE_FINE);
+  mainLoopPaused = 1;
+  Turn(100, 500, 0, 0);
+  InputQueue_GetStats(&stats);
+  TEST_ASSERT(stats.dropped[INPUT_SOURCE_ENCODER] > 0);
+
+  mainLoopPaused = 0;
+  Advance(2000);
+  TEST_ASSERT(TakeSteps(&events) == 100);
+}
+
+/* Rotation while disabled is dropped, turning after it counts again */
+static void test_disabled(void)
+{
+  uint32_t events;
+
+  Start(ROTARY_MODE_NORMAL);
+  RotaryEncoder_SetEnabled(0);
+  Turn(5, 50000, 0, 0);
+  RotaryEncoder_SetEnabled(1);
+  Advance(10000);
+  TEST_ASSERT(TakeSteps(&events) == 0);
+
+  Turn(-3, 50000, 0, 0);
+  TEST_ASSERT(TakeSteps(&events) == -3);
+}
+
+int main(void)
+{
+  RUN_TEST(test_slow_detents);
+  RUN_TEST(test_fast_turn_keeps_every_detent);
+  RUN_TEST(test_bounce);
+  RUN_TEST(test_acceleration);
+  RUN_TEST(test_queue_full_keeps_steps);
+  RUN_TEST(test_disabled);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,298 @@
+ /**
+  ******************************************************************************
+  * @file           : test_scheduler.c
+  * @brief          : Host test of the cooperative task scheduler
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * scheduler.c and event_loop.c run as in the firmware against a simulated
+  * clock: the DWT cycle counter stand-in advances only when a task spends
+  * time or the loop sleeps, and the interrupts of main.c are modelled on
+  * that clock (an I2S block every BLOCK_US, the 1 ms tick). The task table
+  * has the shape of the one in main.c, with fixed costs per call, so the
+  * response times and deadline misses are exact.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "scheduler.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CYCLES_PER_US              (SystemCoreClock / 1000000U)
+
+#define BLOCK_US                   2666   /* 128 samples at 48 kHz */
+#define TICK_US                    1000
+
+/* Task costs */
+#define AUDIO_US                   900
+#define CONTROL_US                 100
+#define HOST_US                    20
+#define STORAGE_IDLE_US            5
+#define STORAGE_CHUNK_US           500    /* One journal step */
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t nowUs;
+static uint32_t nextBlockUs;
+static uint32_t nextTickUs;
+static uint8_t ticksRunning;
+static uint8_t audioRunning;
+
+/* Preset save in progress: chunks left, and whether it yields between them */
+static uint32_t saveChunks;
+static uint8_t saveYields;
+
+/* Order of the calls, one letter per task */
+static char runLog[64];
+static uint32_t runLogLength;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t AudioTask(void);
+static uint8_t ControlTask(void);
+static uint8_t HostTask(void);
+static uint8_t StorageTask(void);
+
+/* Task table in priority order, as in main.c */
+static const SchedulerTask_t taskTable[] = {
+  { "audio",   AudioTask,   EVENT_AUDIO,   BLOCK_US },
+  { "control", ControlTask, EVENT_CONTROL, BLOCK_US },
+  { "host",    HostTask,    EVENT_TICK,    10000 },
+  { "storage", StorageTask, EVENT_TICK,    0 },
+};
+
+#define TASK_AUDIO                 0
+#define TASK_CONTROL               1
+#define TASK_HOST                  2
+#define TASK_STORAGE               3
+
+/* Simulated time ------------------------------------------------------------*/
+
+/* Let time pass, posting the events of the interrupts that fall due */
+static void Spend(uint32_t us)
+{
+  while (us--) {
+    nowUs++;
+    hostDwt.CYCCNT += CYCLES_PER_US;
+
+    if (audioRunning && nowUs >= nextBlockUs) {
+      nextBlockUs += BLOCK_US;
+      EventLoop_Post(EVENT_AUDIO);
+    }
+    if (ticksRunning && nowUs >= nextTickUs) {
+      nextTickUs += TICK_US;
+      EventLoop_Post(EVENT_TICK);
+    }
+  }
+}
+
+static void Log(char task)
+{
+  if (runLogLength < sizeof(runLog) - 1) {
+    runLog[runLogLength++] = task;
+    runLog[runLogLength] = '\0';
+  }
+}
+
+/* __WFI(): sleep until an interrupt posts */
+static void SleepUntilInterrupt(void)
+{
+  while (EventLoop_Pending(0xFFFFFFFFU) == 0) {
+    Spend(1);
+  }
+}
+
+static void RunFor(uint32_t us)
+{
+  uint32_t end = nowUs + us;
+
+  while (nowUs < end) {
+    Scheduler_RunNext();
+  }
+}
+
+/* Clock at 0, with or without the timer and I2S interrupts */
+static void Start(uint8_t ticks, uint8_t audio)
+{
+  nowUs = 0;
+  hostDwt.CYCCNT = 0;
+  nextBlockUs = BLOCK_US;
+  nextTickUs = TICK_US;
+  ticksRunning = ticks;
+  audioRunning = audio;
+  saveChunks = 0;
+  runLogLength = 0;
+  runLog[0] = '\0';
+
+  Host_WfiHook = SleepUntilInterrupt;
+  EventLoop_Init();
+  Scheduler_Init(taskTable, sizeof(taskTable) / sizeof(taskTable[0]));
+}
+
+/* Tasks ---------------------------------------------------------------------*/
+
+static uint8_t AudioTask(void)
+{
+  Log('a');
+  Spend(AUDIO_US);
+  EventLoop_Post(EVENT_CONTROL);
+  return SCHEDULER_DONE;
+}
+
+static uint8_t ControlTask(void)
+{
+  Log('c');
+  Spend(CONTROL_US);
+  return SCHEDULER_DONE;
+}
+
+static uint8_t HostTask(void)
+{
+  Log('h');
+  Spend(HOST_US);
+  return SCHEDULER_DONE;
+}
+
+static uint8_t StorageTask(void)
+{
+  if (saveChunks == 0) {
+    Spend(STORAGE_IDLE_US);
+    return SCHEDULER_DONE;
+  }
+
+  Log('s');
+  if (!saveYields) {
+    /* The whole save in one call */
+    Spend(saveChunks * STORAGE_CHUNK_US);
+    saveChunks = 0;
+    return SCHEDULER_DONE;
+  }
+
+  Spend(STORAGE_CHUNK_US);
+  return (--saveChunks > 0) ? SCHEDULER_YIELD : SCHEDULER_DONE;
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* Ready tasks run highest priority first; an event posted by a task is
+   seen before lower priorities run */
+static void test_priority_order(void)
+{
+  Start(0, 0);
+  saveChunks = 1;
+  saveYields = 1;
+  EventLoop_Post(EVENT_TICK | EVENT_AUDIO);
+
+  Scheduler_RunNext();
+  Scheduler_RunNext();
+  Scheduler_RunNext();
+  Scheduler_RunNext();
+  TEST_ASSERT(strcmp(runLog, "achs") == 0);
+}
+
+/* Run time, yields and response (post to done) are accounted exactly */
+static void test_statistics(void)
+{
+  SchedulerTaskStats_t stats;
+
+  Start(0, 0);
+  saveChunks = 3;
+  saveYields = 1;
+  EventLoop_Post(EVENT_TICK);
+
+  /* host, storage chunk 1, then an audio block arrives */
+  Scheduler_RunNext();
+  Scheduler_RunNext();
+  EventLoop_Post(EVENT_AUDIO);
+  while (saveChunks > 0) {
+    Scheduler_RunNext();
+  }
+  TEST_ASSERT(strcmp(runLog, "hsacss") == 0);
+
+  TEST_ASSERT(Scheduler_GetTaskStats(TASK_AUDIO, &stats));
+  TEST_ASSERT(stats.runs == 1 && stats.lastRunUs == AUDIO_US);
+  TEST_ASSERT(stats.lastResponseUs == AUDIO_US);
+
+  TEST_ASSERT(Scheduler_GetTaskStats(TASK_CONTROL, &stats));
+  TEST_ASSERT(stats.lastResponseUs == CONTROL_US);
+
+  TEST_ASSERT(Scheduler_GetTaskStats(TASK_STORAGE, &stats));
+  TEST_ASSERT(stats.runs == 3 && stats.yields == 2);
+  TEST_ASSERT(stats.worstRunUs == STORAGE_CHUNK_US);
+  TEST_ASSERT(stats.lastResponseUs == HOST_US + 3 * STORAGE_CHUNK_US + AUDIO_US + CONTROL_US);
+  TEST_ASSERT(stats.deadlineMisses == 0);
+
+  TEST_ASSERT(Scheduler_GetTaskStats(sizeof(taskTable) / sizeof(taskTable[0]), &stats) == 0);
+  TEST_ASSERT(Scheduler_GetTaskName(TASK_HOST) != NULL && strcmp(Scheduler_GetTaskName(TASK_HOST), "host") == 0);
+}
+
+/* A save that yields per journal step keeps every audio block in time;
+   the same work in one call makes blocks miss their deadline */
+static void test_yield_keeps_audio_deadline(void)
+{
+  SchedulerTaskStats_t audio;
+  SchedulerTaskStats_t storage;
+
+  Start(1, 1);
+  RunFor(20000);
+  saveChunks = 40;
+  saveYields = 1;
+  RunFor(100000);
+  TEST_ASSERT(saveChunks == 0);
+  Scheduler_GetTaskStats(TASK_AUDIO, &audio);
+  Scheduler_GetTaskStats(TASK_STORAGE, &storage);
+  TEST_ASSERT(storage.yields == 39);
+  if (audio.deadlineMisses != 0 || audio.worstResponseUs > AUDIO_US + STORAGE_CHUNK_US + CONTROL_US) {
+    TEST_FAIL("yielding save: %lu audio misses, worst response %lu us",
+              (unsigned long)audio.deadlineMisses, (unsigned long)audio.worstResponseUs);
+  }
+  TEST_ASSERT(audio.runs >= 120000 / BLOCK_US - 1);
+
+  Start(1, 1);
+  RunFor(20000);
+  saveChunks = 40;
+  saveYields = 0;
+  RunFor(100000);
+  Scheduler_GetTaskStats(TASK_AUDIO, &audio);
+  TEST_ASSERT(audio.deadlineMisses > 0);
+  TEST_ASSERT(audio.worstResponseUs > BLOCK_US);
+}
+
+/* With nothing ready the loop sleeps until the next interrupt */
+static void test_idle_sleeps(void)
+{
+  EventLoopStats_t loop;
+  SchedulerTaskStats_t host;
+
+  Start(1, 0);
+  RunFor(2500000);
+  EventLoop_GetStats(&loop);
+  Scheduler_GetTaskStats(TASK_HOST, &host);
+
+  TEST_ASSERT(host.runs >= 2499 && host.runs <= 2500);
+  TEST_ASSERT(loop.wakeups >= 2499);
+  /* 25 us of work per 1 ms tick */
+  TEST_ASSERT(loop.idlePermille >= 970 && loop.idlePermille <= 980);
+}
+
+int main(void)
+{
+  RUN_TEST(test_priority_order);
+  RUN_TEST(test_statistics);
+  RUN_TEST(test_yield_keeps_audio_deadline);
+  RUN_TEST(test_idle_sleeps);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
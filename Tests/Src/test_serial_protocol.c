@@ -0,0 +1,459 @@
+ /**
+  ******************************************************************************
+  * @file           : test_serial_protocol.c
+  * @brief          : Host test of the USART1 serial protocol
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * Request frames go in through the UART stand-in, byte for byte as the
+  * circular DMA would write them, and the responses are taken from the
+  * transmit hook and checked field by field, CRC included. Presets go
+  * through the real preset manager and journal on the simulated flash, so
+  * an exported preset imported under another ID must load back with the
+  * same settings once the background save has run. A delete is answered
+  * BUSY until the background writer has written it.
+  *
+  * Frames damaged on the line must be dropped without an answer and the
+  * retry answered, also when the damage is in the length field. Frames that
+  * straddle the end of the DMA buffer, and reception stopped by a UART
+  * error, must not lose a request.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "serial_protocol.h"
+#include "serial_host.h"
+#include "preset_manager.h"
+#include "factory_presets.h"
+#include "param_update.h"
+#include "scheduler.h"
+#include "flash_sim.h"
+#include "crc32.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TX_LOG_SIZE                4096
+#define TASK_CALLS                 4       /* Task calls allowed per answer */
+
+/* Parameter IDs (index into the table of serial_protocol.c) */
+#define PARAM_MID_CUTOFF           1
+#define PARAM_SUB_MUTE             7
+#define PARAM_COUNT_MIN            50
+
+/* Private variables ---------------------------------------------------------*/
+UART_HandleTypeDef huart1;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+
+static SystemSettings_t sys;
+
+/* Everything transmitted since the last Request() */
+static uint8_t txLog[TX_LOG_SIZE];
+static uint32_t txLength;
+
+/* Last response */
+static uint8_t response[SERIAL_MAX_PAYLOAD];
+static uint16_t responseLength;
+
+static uint8_t sequence;
+
+/* Helpers -------------------------------------------------------------------*/
+
+static void CaptureTx(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size)
+{
+  if (txLength + size <= TX_LOG_SIZE) {
+    memcpy(&txLog[txLength], data, size);
+    txLength += size;
+  }
+}
+
+static void PutU32(uint8_t* buffer, uint32_t value)
+{
+  for (uint8_t i = 0; i < 4; i++) {
+    buffer[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static uint32_t GetU32(const uint8_t* buffer)
+{
+  return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+         ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+static float GetFloat(const uint8_t* buffer)
+{
+  uint32_t bits = GetU32(buffer);
+  float value;
+
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* Build a request frame as the host does; returns its length */
+static uint16_t BuildFrame(uint8_t* frame, uint8_t type, uint8_t seq, const uint8_t* payload, uint16_t length)
+{
+  frame[0] = SERIAL_FRAME_SOF;
+  frame[1] = (uint8_t)length;
+  frame[2] = (uint8_t)(length >> 8);
+  frame[3] = type;
+  frame[4] = seq;
+  if (length > 0) {
+    memcpy(&frame[SERIAL_HEADER_SIZE], payload, length);
+  }
+  PutU32(&frame[SERIAL_HEADER_SIZE + length], Crc32_Compute(&frame[1], length + 4));
+  return SERIAL_HEADER_SIZE + length + SERIAL_CRC_SIZE;
+}
+
+/* Run the protocol task until one more frame has gone out */
+static uint8_t RunUntilAnswer(void)
+{
+  uint32_t before = txLength;
+
+  for (uint8_t i = 0; i < TASK_CALLS; i++) {
+    SerialProtocol_Task();
+    if (txLength != before) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Check the response frame at txLog[offset] and keep its payload */
+static uint8_t ParseResponse(uint32_t offset, uint8_t type, uint8_t seq)
+{
+  const uint8_t* frame = &txLog[offset];
+  uint16_t length;
+
+  if (txLength - offset < SERIAL_HEADER_SIZE + SERIAL_CRC_SIZE || frame[0] != SERIAL_FRAME_SOF) {
+    return 0;
+  }
+  length = frame[1] | ((uint16_t)frame[2] << 8);
+  if (txLength - offset != (uint32_t)(SERIAL_HEADER_SIZE + length + SERIAL_CRC_SIZE) ||
+      length == 0 || length > SERIAL_MAX_PAYLOAD) {
+    return 0;
+  }
+  if (frame[3] != (type | SERIAL_MSG_RESPONSE) || frame[4] != seq ||
+      Crc32_Compute(&frame[1], length + 4) != GetU32(&frame[SERIAL_HEADER_SIZE + length])) {
+    return 0;
+  }
+
+  memcpy(response, &frame[SERIAL_HEADER_SIZE], length);
+  responseLength = length;
+  return 1;
+}
+
+/* Send a request and take its answer; returns the status byte, or 0xFF if
+   no valid answer came */
+static uint8_t Request(uint8_t type, const uint8_t* payload, uint16_t length)
+{
+  uint8_t frame[SERIAL_MAX_FRAME];
+  uint16_t frameLength = BuildFrame(frame, type, ++sequence, payload, length);
+
+  txLength = 0;
+  Host_UartReceive(&huart1, frame, frameLength);
+  if (!RunUntilAnswer() || !ParseResponse(0, type, sequence)) {
+    return 0xFF;
+  }
+  return response[0];
+}
+
+static uint8_t RequestId(uint8_t type, uint8_t id)
+{
+  return Request(type, &id, 1);
+}
+
+static uint8_t SetParam(uint8_t id, float value)
+{
+  uint8_t payload[5];
+
+  payload[0] = id;
+  memcpy(&payload[1], &value, sizeof(value));
+  return Request(SERIAL_MSG_PARAM_SET, payload, sizeof(payload));
+}
+
+/* Run the background saves to the end */
+static void FinishSaves(void)
+{
+  for (uint32_t i = 0; i < 10000 && PresetManager_IsBusy(); i++) {
+    PresetManager_Task();
+  }
+}
+
+/* Fresh flash, settings and link; the factory preset 0 is in effect */
+static void Start(void)
+{
+  PresetSettings_t factory;
+
+  FlashSim_Reset(0xFF);
+  PresetManager_Init();
+  SerialHost_Reset();
+
+  memset(&sys, 0, sizeof(sys));
+  FactoryPresets_GetPreset(0, &factory);
+  memcpy(&sys.crossover, &factory.crossover, sizeof(factory.crossover));
+
+  memset(&huart1, 0, sizeof(huart1));
+  huart1.hdmarx = &hdma_usart1_rx;
+  huart1.gState = HAL_UART_STATE_READY;
+  huart1.RxState = HAL_UART_STATE_READY;
+  Host_UartTxHook = CaptureTx;
+  SerialProtocol_Init(&sys);
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* PING gives the protocol version and limits; unknown types are refused */
+static void test_ping(void)
+{
+  Start();
+
+  TEST_ASSERT(Request(SERIAL_MSG_PING, NULL, 0) == SERIAL_STATUS_OK);
+  TEST_ASSERT(responseLength == 7);
+  TEST_ASSERT(response[1] == SERIAL_PROTOCOL_VERSION);
+  TEST_ASSERT((response[2] | (response[3] << 8)) == SERIAL_MAX_PAYLOAD);
+  TEST_ASSERT(response[4] == USER_PRESET_START_ID && response[5] == TOTAL_PRESET_COUNT);
+  TEST_ASSERT(response[6] >= PARAM_COUNT_MIN);
+
+  TEST_ASSERT(Request(0x7F, NULL, 0) == SERIAL_STATUS_UNKNOWN);
+  TEST_ASSERT(RequestId(SERIAL_MSG_PARAM_GET, 0xF0) == SERIAL_STATUS_INVALID);
+  TEST_ASSERT(Request(SERIAL_MSG_PARAM_GET, NULL, 0) == SERIAL_STATUS_LENGTH);
+}
+
+/* Parameters are read, clamped to their range and marked for the control task */
+static void test_params(void)
+{
+  Start();
+
+  TEST_ASSERT(RequestId(SERIAL_MSG_PARAM_GET, PARAM_MID_CUTOFF) == SERIAL_STATUS_OK);
+  TEST_ASSERT(response[1] == PARAM_MID_CUTOFF && response[2] == SERIAL_PARAM_FLOAT);
+  TEST_ASSERT(GetFloat(&response[3]) == sys.crossover.midCutoff);
+  TEST_ASSERT(GetFloat(&response[7]) == 20.0f && GetFloat(&response[11]) == 20000.0f);
+  TEST_ASSERT(strcmp((const char*)&response[15], "xo.midCutoff") == 0);
+
+  TEST_ASSERT(SetParam(PARAM_MID_CUTOFF, 1200.0f) == SERIAL_STATUS_OK);
+  TEST_ASSERT(GetFloat(&response[2]) == 1200.0f && sys.crossover.midCutoff == 1200.0f);
+  TEST_ASSERT(serialHostDirty == PARAM_DIRTY_CUTOFF_MID);
+
+  /* Out of range and NaN are clamped */
+  TEST_ASSERT(SetParam(PARAM_MID_CUTOFF, 50000.0f) == SERIAL_STATUS_OK);
+  TEST_ASSERT(sys.crossover.midCutoff == 20000.0f);
+  TEST_ASSERT(SetParam(PARAM_MID_CUTOFF, NAN) == SERIAL_STATUS_OK);
+  TEST_ASSERT(sys.crossover.midCutoff == 20.0f);
+
+  /* Switches take 0 or 1 */
+  TEST_ASSERT(SetParam(PARAM_SUB_MUTE, 0.7f) == SERIAL_STATUS_OK);
+  TEST_ASSERT(sys.crossover.subMute == 1 && GetFloat(&response[2]) == 1.0f);
+  TEST_ASSERT(serialHostDirty == (PARAM_DIRTY_CUTOFF_MID | PARAM_DIRTY_BAND_LEVELS));
+
+  /* A running morph would overwrite the change */
+  serialHostMorphActive = 1;
+  TEST_ASSERT(SetParam(PARAM_MID_CUTOFF, 1000.0f) == SERIAL_STATUS_BUSY);
+  TEST_ASSERT(sys.crossover.midCutoff == 20.0f);
+}
+
+/* Statistics are sent as the structures are */
+static void test_stats(void)
+{
+  uint8_t loadUs[4];
+  uint8_t rate[2] = { 25, 0 };
+
+  Start();
+  serialHostAudioStats.processingTime = 420;
+  serialHostAudioStats.deadlineMisses = 3;
+
+  TEST_ASSERT(Request(SERIAL_MSG_GET_STATS, NULL, 0) == SERIAL_STATUS_OK);
+  TEST_ASSERT(responseLength == 1 + sizeof(AudioProcessingStats_t));
+  TEST_ASSERT(memcmp(&response[1], &serialHostAudioStats, sizeof(AudioProcessingStats_t)) == 0);
+
+  TEST_ASSERT(RequestId(SERIAL_MSG_TASK_STATS, 0) == SERIAL_STATUS_OK);
+  TEST_ASSERT(response[2] == 1 && strcmp((const char*)&response[3 + sizeof(SchedulerTaskStats_t)], "host") == 0);
+  TEST_ASSERT(RequestId(SERIAL_MSG_TASK_STATS, 1) == SERIAL_STATUS_INVALID);
+
+  PutU32(loadUs, 1500);
+  TEST_ASSERT(Request(SERIAL_MSG_TEST_LOAD, loadUs, sizeof(loadUs)) == SERIAL_STATUS_OK);
+  TEST_ASSERT(serialHostTestLoadUs == 1500 && GetU32(&response[1]) == 1500);
+  TEST_ASSERT(Request(SERIAL_MSG_TELEMETRY_RATE, rate, sizeof(rate)) == SERIAL_STATUS_OK);
+  TEST_ASSERT(serialHostTelemetryRate == 25);
+}
+
+/* A factory preset exported and imported as a user preset loads back the same */
+static void test_preset_transfer(void)
+{
+  uint8_t record[SERIAL_MAX_PAYLOAD];
+  uint16_t recordLength;
+  PresetSettings_t expected;
+  PresetSettings_t loaded;
+  const uint8_t userId = USER_PRESET_START_ID + 2;
+
+  Start();
+
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_READ, 3) == SERIAL_STATUS_OK);
+  TEST_ASSERT(response[1] == 3 && responseLength > 2);
+  recordLength = responseLength - 2;
+  record[0] = userId;
+  memcpy(&record[1], &response[2], recordLength);
+
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_READ, userId) == SERIAL_STATUS_EMPTY);
+  TEST_ASSERT(Request(SERIAL_MSG_PRESET_WRITE, record, 1 + recordLength) == SERIAL_STATUS_OK);
+  TEST_ASSERT(response[1] == userId);
+
+  FinishSaves();
+  TEST_ASSERT(!PresetManager_IsBusy());
+
+  FactoryPresets_GetPreset(3, &expected);
+  TEST_ASSERT(PresetManager_LoadPreset(userId, &loaded) == PRESET_STATUS_OK);
+  TEST_ASSERT(memcmp(&loaded.crossover, &expected.crossover, sizeof(expected.crossover)) == 0);
+
+  /* Listed after the factory presets, under the factory name */
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_LIST, USER_PRESET_START_ID) == SERIAL_STATUS_OK);
+  TEST_ASSERT(response[1] == PRESET_ID_INVALID && response[2] == 1);
+  TEST_ASSERT(response[3] == userId && strcmp((const char*)&response[4], "Studio") == 0);
+
+  /* A damaged record is refused; a factory ID cannot be written */
+  record[1 + recordLength / 2] ^= 0x10;
+  TEST_ASSERT(Request(SERIAL_MSG_PRESET_WRITE, record, 1 + recordLength) == SERIAL_STATUS_INVALID);
+  record[1 + recordLength / 2] ^= 0x10;
+  record[0] = 1;
+  TEST_ASSERT(Request(SERIAL_MSG_PRESET_WRITE, record, 1 + recordLength) == SERIAL_STATUS_INVALID);
+
+  /* A delete is queued behind the save before it and answered BUSY until written */
+  record[0] = userId;
+  TEST_ASSERT(Request(SERIAL_MSG_PRESET_WRITE, record, 1 + recordLength) == SERIAL_STATUS_OK);
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_DELETE, userId) == SERIAL_STATUS_BUSY);
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_DELETE, userId) == SERIAL_STATUS_BUSY);
+  TEST_ASSERT(PresetManager_IsBusy());
+  FinishSaves();
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_DELETE, userId) == SERIAL_STATUS_OK);
+  TEST_ASSERT(response[1] == userId);
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_READ, userId) == SERIAL_STATUS_EMPTY);
+
+  /* Deleting an empty preset goes through the queue as well */
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_DELETE, userId) == SERIAL_STATUS_BUSY);
+  FinishSaves();
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_DELETE, userId) == SERIAL_STATUS_OK);
+  TEST_ASSERT(RequestId(SERIAL_MSG_PRESET_DELETE, 1) == SERIAL_STATUS_INVALID);
+}
+
+/* A frame damaged on the line gets no answer; the host's retry does */
+static void test_corrupt_frame_retry(void)
+{
+  uint8_t frame[SERIAL_MAX_FRAME];
+  uint8_t id = PARAM_MID_CUTOFF;
+  uint16_t length;
+  SerialProtocolStats_t stats;
+
+  Start();
+
+  /* Every byte of the frame in turn */
+  length = BuildFrame(frame, SERIAL_MSG_PARAM_GET, ++sequence, &id, 1);
+  for (uint16_t i = 0; i < length; i++) {
+    frame[i] ^= 0x40;
+    txLength = 0;
+    Host_UartReceive(&huart1, frame, length);
+    frame[i] ^= 0x40;
+
+    /* A damaged length leaves the parser waiting for more bytes; the host
+       retries after its response timeout, by when the frame is dropped */
+    SerialProtocol_Task();
+    Host_AdvanceTick(SERIAL_FRAME_TIMEOUT_MS);
+    SerialProtocol_Task();
+    if (txLength != 0) {
+      TEST_FAIL("byte %u damaged: answered", i);
+    }
+    Host_AdvanceTick(1);
+    SerialProtocol_Task();
+
+    txLength = 0;
+    Host_UartReceive(&huart1, frame, length);
+    if (!RunUntilAnswer() || !ParseResponse(0, SERIAL_MSG_PARAM_GET, sequence) ||
+        response[0] != SERIAL_STATUS_OK) {
+      TEST_FAIL("byte %u damaged: retry not answered", i);
+    }
+  }
+
+  SerialProtocol_GetStats(&stats);
+  TEST_ASSERT(stats.crcErrors > 0 && stats.framingErrors > 0);
+  TEST_ASSERT(stats.framesReceived == length);
+  TEST_ASSERT(stats.framesSent == length);
+}
+
+/* Frames that straddle the end of the DMA buffer, several at once */
+static void test_dma_wrap(void)
+{
+  uint8_t frames[4 * SERIAL_MAX_FRAME];
+  uint16_t length;
+
+  Start();
+
+  /* 9 bytes per PING: the buffer end falls inside some frame */
+  for (uint32_t round = 0; round < 2 * SERIAL_RX_BUFFER_SIZE / 27; round++) {
+    length = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+      length += BuildFrame(&frames[length], SERIAL_MSG_PING, ++sequence, NULL, 0);
+    }
+    txLength = 0;
+    Host_UartReceive(&huart1, frames, length);
+
+    /* One answer per task call */
+    for (uint8_t i = 0; i < 3; i++) {
+      uint32_t offset = txLength;
+      uint8_t expectedSeq = sequence - 2 + i;
+      if (!RunUntilAnswer() || !ParseResponse(offset, SERIAL_MSG_PING, expectedSeq)) {
+        TEST_FAIL("round %lu: frame %u (sequence %u) not answered",
+                  (unsigned long)round, i, expectedSeq);
+        return;
+      }
+    }
+  }
+}
+
+/* Reception stopped by a UART error is started again */
+static void test_rx_restart(void)
+{
+  SerialProtocolStats_t stats;
+  uint8_t half[SERIAL_MAX_FRAME];
+  uint16_t length;
+
+  Start();
+
+  /* Half a frame, then an overrun stops the DMA */
+  length = BuildFrame(half, SERIAL_MSG_PING, ++sequence, NULL, 0);
+  Host_UartReceive(&huart1, half, length / 2);
+  SerialProtocol_Task();
+  huart1.RxState = HAL_UART_STATE_READY;
+
+  /* Bytes arriving before the task restarts reception are lost */
+  Host_UartReceive(&huart1, &half[length / 2], length - length / 2);
+  SerialProtocol_Task();
+  TEST_ASSERT(Request(SERIAL_MSG_PING, NULL, 0) == SERIAL_STATUS_OK);
+  SerialProtocol_GetStats(&stats);
+  TEST_ASSERT(stats.rxRestarts == 1);
+  TEST_ASSERT(huart1.RxState == HAL_UART_STATE_BUSY_RX);
+}
+
+int main(void)
+{
+  Crc32_Init();
+
+  RUN_TEST(test_ping);
+  RUN_TEST(test_params);
+  RUN_TEST(test_stats);
+  RUN_TEST(test_preset_transfer);
+  RUN_TEST(test_corrupt_frame_retry);
+  RUN_TEST(test_dma_wrap);
+  RUN_TEST(test_rx_restart);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
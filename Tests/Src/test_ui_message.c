@@ -0,0 +1,368 @@
+ /**
+  ******************************************************************************
+  * @file           : test_ui_message.c
+  * @brief          : Host test of the non-blocking UI messages
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * user_interface.c and the menus run on the mock LCD backend, with the
+  * transfers completed as soon as they start. Time moves in 1 ms steps with
+  * a UI_Update() and a flush per step, and the screen is read back from the
+  * frame buffer. A message must stay on the screen for exactly its timeout,
+  * queued messages must follow in order, and the menu must come back after
+  * the last one. A background preset save must show its result when the
+  * save completes.
+  *
+  * The host tick only moves between the steps or inside HAL_Delay(), so any
+  * tick change across a UI call is time the main loop was blocked for. None
+  * is allowed: a call of one audio block (128 samples, 2.7 ms) would miss a
+  * block.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "user_interface.h"
+#include "ui_manager.h"
+#include "lcd_driver.h"
+#include "menu_system.h"
+#include "button_handler.h"
+#include "param_update.h"
+#include "preset_manager.h"
+#include "factory_presets.h"
+#include "audio_processing.h"
+#include "crossover.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "delay.h"
+#include "test_framework.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ROW_SIZE                   (LCD_SCREEN_SIZE / 2)
+#define MESSAGE_MS                 1000
+#define BOOT_MS                    100
+
+/* Run a UI call and note the time it blocked for */
+#define UI_CALL(call)                                     \
+  do {                                                    \
+    uint32_t callStart = HAL_GetTick();                   \
+    call;                                                 \
+    NoteBlocked(HAL_GetTick() - callStart);               \
+    Flush();                                              \
+  } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+volatile uint32_t systemTick = 0;
+I2C_HandleTypeDef hi2c1;
+
+static SystemSettings_t settings;
+static uint8_t busBusy = 0;
+static uint32_t blockedMs = 0;             /* Longest UI call */
+static uint8_t menuScreen[LCD_SCREEN_SIZE];
+
+/* Background save */
+static uint8_t saveStatus = PRESET_STATUS_OK;
+static uint8_t savePresetId = 0;
+static PresetSaveCallback_t saveCallback = NULL;
+
+/* Helpers -------------------------------------------------------------------*/
+
+static void NoteBlocked(uint32_t ms)
+{
+  if (ms > blockedMs) {
+    blockedMs = ms;
+  }
+}
+
+/* The lcd task: queue the changed cells and run the bus */
+static void Flush(void)
+{
+  LCD_Flush();
+  while (busBusy) {
+    busBusy = 0;
+    LCD_TransferComplete();
+  }
+}
+
+/* Let time pass in 1 ms steps, with a UI pass in each */
+static void Step(uint32_t ms)
+{
+  while (ms--) {
+    systemTick++;
+    Host_AdvanceTick(1);
+    LCD_TimerTick();
+    UI_CALL(UI_Update());
+  }
+}
+
+/* Whether the screen shows the lines, padded with spaces */
+static uint8_t Shows(const char* line1, const char* line2)
+{
+  uint8_t expected[LCD_SCREEN_SIZE];
+  uint8_t text[LCD_SCREEN_SIZE];
+
+  memset(expected, ' ', sizeof(expected));
+  memcpy(expected, line1, strlen(line1));
+  memcpy(&expected[ROW_SIZE], line2, strlen(line2));
+  LCD_GetScreen(text);
+  return memcmp(text, expected, sizeof(text)) == 0;
+}
+
+static uint8_t ShowsMenu(void)
+{
+  uint8_t text[LCD_SCREEN_SIZE];
+
+  LCD_GetScreen(text);
+  return memcmp(text, menuScreen, sizeof(text)) == 0;
+}
+
+/* Steps until the screen changes from the lines; returns the steps taken */
+static uint32_t ShownFor(const char* line1, const char* line2)
+{
+  uint32_t ms = 0;
+
+  while (Shows(line1, line2) && ms <= 10 * MESSAGE_MS) {
+    Step(1);
+    ms++;
+  }
+  return ms;
+}
+
+static void PressHeld(ButtonID_t button)
+{
+  ButtonEvent_t event = { .button = button, .state = BUTTON_HELD, .holdTime = BUTTON_HOLD_TIME };
+
+  UI_CALL(UI_HandleButtonEvent(&event));
+}
+
+/* Tests ---------------------------------------------------------------------*/
+
+/* A message stays for its timeout, then the menu comes back */
+static void test_timeout(void)
+{
+  UI_CALL(UI_ShowMessage("Band Selected:", "Low", MESSAGE_MS));
+  TEST_ASSERT(Shows("Band Selected:", "Low"));
+
+  Step(MESSAGE_MS - 1);
+  TEST_ASSERT(Shows("Band Selected:", "Low"));
+  Step(1);
+  TEST_ASSERT(ShowsMenu());
+
+  Step(MESSAGE_MS);
+  TEST_ASSERT(ShowsMenu());
+  TEST_ASSERT(blockedMs == 0);
+}
+
+/* Queued messages follow in order, each for its own timeout */
+static void test_queue_order(void)
+{
+  UI_CALL(UI_QueueMessage("Settings saved", "to preset 6", MESSAGE_MS));
+  UI_CALL(UI_QueueMessage("Preset loaded:", "Rock", 500));
+  UI_CALL(UI_QueueMessage("Morphing to", "selected preset", 300));
+
+  /* The first one shows at once */
+  TEST_ASSERT(Shows("Settings saved", "to preset 6"));
+  TEST_ASSERT(ShownFor("Settings saved", "to preset 6") == MESSAGE_MS);
+  TEST_ASSERT(ShownFor("Preset loaded:", "Rock") == 500);
+  TEST_ASSERT(ShownFor("Morphing to", "selected preset") == 300);
+  TEST_ASSERT(ShowsMenu());
+  TEST_ASSERT(blockedMs == 0);
+}
+
+/* A shown message is replaced with its timer restarted; waiting ones stay */
+static void test_show_replaces(void)
+{
+  UI_CALL(UI_ShowMessage("Band Selected:", "Sub", MESSAGE_MS));
+  UI_CALL(UI_QueueMessage("Preset loaded:", "Jazz", 200));
+  Step(600);
+
+  UI_CALL(UI_ShowMessage("Sub:", "MUTED", 500));
+  TEST_ASSERT(Shows("Sub:", "MUTED"));
+  TEST_ASSERT(ShownFor("Sub:", "MUTED") == 500);
+  TEST_ASSERT(ShownFor("Preset loaded:", "Jazz") == 200);
+  TEST_ASSERT(ShowsMenu());
+}
+
+/* A full queue replaces the newest waiting message */
+static void test_queue_full(void)
+{
+  UI_CALL(UI_QueueMessage("First", NULL, 100));
+  UI_CALL(UI_QueueMessage("Second", NULL, 100));
+  UI_CALL(UI_QueueMessage("Third", NULL, 100));
+  UI_CALL(UI_QueueMessage("Dropped", NULL, 100));
+  UI_CALL(UI_QueueMessage("Last", NULL, 100));
+
+  TEST_ASSERT(ShownFor("First", "") == 100);
+  TEST_ASSERT(ShownFor("Second", "") == 100);
+  TEST_ASSERT(ShownFor("Third", "") == 100);
+  TEST_ASSERT(ShownFor("Last", "") == 100);
+  TEST_ASSERT(ShowsMenu());
+}
+
+/* A menu drawn while a message is shown does not replace it */
+static void test_menu_held_off(void)
+{
+  UI_CALL(UI_ShowMessage("Preset loaded:", "Pop", MESSAGE_MS));
+  Step(100);
+
+  UI_NeedsRefresh();
+  Menu_Display();
+  Step(1);
+  TEST_ASSERT(Shows("Preset loaded:", "Pop"));
+
+  /* The timeout still counts from the start of the message */
+  TEST_ASSERT(ShownFor("Preset loaded:", "Pop") == MESSAGE_MS - 101);
+  TEST_ASSERT(ShowsMenu());
+}
+
+/* A quick save runs in the background and shows its result when it completes */
+static void test_background_save(void)
+{
+  saveCallback = NULL;
+  saveStatus = PRESET_STATUS_OK;
+  PressHeld(BUTTON_PRESET);
+  TEST_ASSERT(Shows("Saving to", "Preset 0"));
+  TEST_ASSERT(saveCallback != NULL);
+
+  /* The UI keeps running while the flash is written */
+  Step(200);
+  TEST_ASSERT(ShowsMenu());
+
+  UI_CALL(saveCallback(savePresetId, PRESET_STATUS_OK));
+  saveCallback = NULL;
+  TEST_ASSERT(ShownFor("Preset saved!", "") == MESSAGE_MS);
+  TEST_ASSERT(ShowsMenu());
+
+  /* Storage busy: the failure shows at once, nothing is pending */
+  saveStatus = PRESET_STATUS_BUSY;
+  PressHeld(BUTTON_PRESET);
+  TEST_ASSERT(saveCallback == NULL);
+  TEST_ASSERT(ShownFor("Save failed", "Storage busy") == MESSAGE_MS);
+  TEST_ASSERT(ShowsMenu());
+  TEST_ASSERT(blockedMs == 0);
+}
+
+/* LCD bus (stand-in) --------------------------------------------------------*/
+
+void LCD_MockTransmit(const uint8_t* data, uint16_t length)
+{
+  busBusy = 1;
+}
+
+void LCD_MockWait(void)
+{
+  if (busBusy) {
+    busBusy = 0;
+    LCD_TransferComplete();
+  } else {
+    /* A pause after a slow command: let the tick move on */
+    systemTick++;
+    Host_AdvanceTick(1);
+    LCD_TimerTick();
+  }
+}
+
+/* Stand-ins for the audio and preset modules --------------------------------*/
+
+SystemSettings_t* ParamUpdate_GetSettings(void)
+{
+  return &settings;
+}
+
+void ParamUpdate_Mark(uint16_t dirty)
+{
+}
+
+void AudioProcessing_GetStats(AudioProcessingStats_t* pStats)
+{
+  memset(pStats, 0, sizeof(AudioProcessingStats_t));
+}
+
+void Crossover_GetSettings(struct CrossoverSettings_t* crossover)
+{
+  *crossover = settings.crossover;
+}
+
+void Compressor_GetSettings(CompressorSettings_t* compressor)
+{
+  *compressor = settings.compressor;
+}
+
+void Limiter_GetSettings(LimiterSettings_t* limiter)
+{
+  *limiter = settings.limiter;
+}
+
+void Delay_GetSettings(DelaySettings_t* delay)
+{
+  *delay = settings.delay;
+}
+
+uint8_t PresetManager_GetPresetInfo(uint8_t presetId, PresetMetadata_t* metadata)
+{
+  return PRESET_STATUS_EMPTY;
+}
+
+/* The save completes when the test calls the callback */
+uint8_t PresetManager_SavePresetAsync(uint8_t presetId, const PresetSettings_t* presetSettings,
+                                      PresetSaveCallback_t callback)
+{
+  if (saveStatus != PRESET_STATUS_OK) {
+    return saveStatus;
+  }
+  savePresetId = presetId;
+  saveCallback = callback;
+  return PRESET_STATUS_OK;
+}
+
+uint8_t PresetManager_GetNumUserPresets(void)
+{
+  return 0;
+}
+
+void PresetManager_SaveUserPreset(uint8_t index)
+{
+}
+
+void PresetManager_LoadUserPreset(uint8_t index)
+{
+}
+
+void FactoryPresets_Load(uint8_t presetId)
+{
+}
+
+int main(void)
+{
+  settings.crossover.lowCutoff = 80.0f;
+  settings.crossover.midCutoff = 500.0f;
+  settings.crossover.highCutoff = 4000.0f;
+
+  /* Start up as InitSystem() does, the menu is drawn by the first passes */
+  LCD_Init();
+  Menu_Init();
+  UI_Init();
+  Step(BOOT_MS);
+  LCD_GetScreen(menuScreen);
+
+  RUN_TEST(test_timeout);
+  RUN_TEST(test_queue_order);
+  RUN_TEST(test_show_replaces);
+  RUN_TEST(test_queue_full);
+  RUN_TEST(test_menu_held_off);
+  RUN_TEST(test_background_save);
+
+  return TEST_REPORT();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
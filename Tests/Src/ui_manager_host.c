@@ -0,0 +1,81 @@
+ /**
+  ******************************************************************************
+  * @file           : ui_manager_host.c
+  * @brief          : Host stand-in for the UI coordinator menu calls
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The calls user_interface.c makes are passed to the menu tree of
+  * menu_system.c as an encoder turn or a key. The flat item list used by the
+  * menu scrolling mode is not reached from the menus and stays empty.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ui_manager.h"
+#include "menu_system.h"
+
+/* Exported functions --------------------------------------------------------*/
+
+void Menu_Next(void)
+{
+  Menu_HandleRotary(1);
+}
+
+void Menu_Previous(void)
+{
+  Menu_HandleRotary(-1);
+}
+
+void Menu_Select(void)
+{
+  Menu_HandleButton(BUTTON_ENCODER);
+}
+
+void Menu_Back(void)
+{
+  Menu_HandleButton(BUTTON_BACK);
+}
+
+void Menu_Refresh(void)
+{
+  Menu_Display();
+}
+
+void Menu_RefreshCurrent(void)
+{
+  Menu_Display();
+}
+
+void Menu_ShowPresetMenu(void)
+{
+  Menu_ShowMain();
+}
+
+uint8_t Menu_GetItemCount(void)
+{
+  return 0;
+}
+
+const char* Menu_GetItemText(uint8_t index)
+{
+  return "";
+}
+
+void Menu_SelectItem(uint8_t index)
+{
+  Menu_Display();
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
@@ -0,0 +1,822 @@
+ /**
+  ******************************************************************************
+  * @file           : ui_sim.c
+  * @brief          : Host simulator of the front panel: scripted replay of
+  *                   encoder and button input with LCD capture
+  * @author         : Audio Crossover Project
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 Audio Crossover Project.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  *
+  * The UI modules (user_interface.c, menu_system.c, button_handler.c,
+  * rotary_encoder.c, level_meter.c, ui_probe.c) run as in the firmware, with
+  * lcd_driver.c built with LCD_MOCK_BACKEND. The input source is the GPIO
+  * stand-in: a script turns the encoder (quadrature on PB0/PB1) and presses
+  * the buttons (PA0-PA5), so debouncing, hold detection and the encoder
+  * decoder are part of what is measured. Time is simulated in 1 ms steps
+  * with the interrupts and main loop tasks of main.c: TIM3 samples the
+  * input, TIM2 keeps the tick and posts a UI pass every 10 ms, and the ui
+  * and lcd tasks run when input is waiting or a UI pass is due. Between the
+  * steps the LCD transfers run on a 100 kHz I2C bus timed in microseconds,
+  * with the pauses after slow commands, and end with the transfer complete
+  * interrupt as on the board. The UI work itself takes no simulated time.
+  *
+  * The latency of a response runs from the TIM3 tick that queued the input
+  * to the end of the last LCD transfer of the screen change it drew, if it
+  * drew one within UI_PROBE_WINDOW_MS. Each screen is compared with the one
+  * captured after the event before: a change that no input drew in time (a
+  * message timing out) is reported as drawn by the timer.
+  *
+  * The script format, output and recordings are those of Tools/ui_replay.py,
+  * so a recording made on the board can be compared here and the other way
+  * round:
+  *     0      turn 1            encoder detents, clockwise positive
+  *     300    press encoder     button: menu, back, encoder, preset1-3
+  *     360    release encoder
+  *     1000   hold menu 1500    pressed for 1500 ms, then released
+  *     2000   double back       two clicks
+  * Events are given in time order. An event starts at its time or when the one before it has finished
+  * (turning and holding take time).
+  *
+  * Usage: ui_sim SCRIPT [--record FILE] [--compare FILE] [--max-latency MS]
+  *
+  * --max-latency fails the run when a response took longer (fractions of a
+  * ms allowed).
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "user_interface.h"
+#include "ui_manager.h"
+#include "ui_probe.h"
+#include "input_queue.h"
+#include "param_update.h"
+#include "preset_manager.h"
+#include "factory_presets.h"
+#include "audio_processing.h"
+#include "crossover.h"
+#include "compressor.h"
+#include "limiter.h"
+#include "delay.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SIM_MAX_EVENTS             256
+#define SIM_TEXT_SIZE              48
+#define SIM_LINE_SIZE              128
+
+/* Turning speed: 4 edges per detent, 80 ms per detent (not accelerated) */
+#define SIM_EDGE_MS                20
+#define SIM_CLICK_MS               60     /* Press and release of a double click */
+#define SIM_SETTLE_MS              600    /* Response time allowed for the last event */
+#define SIM_BOOT_MS                100
+
+#define UI_REFRESH_INTERVAL        10     /* ms, as in main.c */
+
+/* I2C at 100 kHz (the PCF8574 limit): 9 clocks per byte, and start, address
+   and stop around each transfer */
+#define SIM_I2C_BYTE_US            90
+#define SIM_I2C_FRAME_US           110
+
+/* Script actions: the button states of Tools/ui_replay.py, then the encoder */
+#define SIM_RELEASE                0
+#define SIM_PRESS                  1
+#define SIM_HOLD                   2
+#define SIM_DOUBLE                 3
+#define SIM_TURN                   4
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+  uint32_t at;               /* ms from the start */
+  uint8_t action;            /* SIM_* */
+  uint8_t button;            /* ButtonID_t */
+  int32_t value;             /* Detents or hold time */
+  char text[SIM_TEXT_SIZE];  /* Script text without the time */
+} SimEvent_t;
+
+typedef struct {
+  char line[2][SIM_LINE_SIZE];
+} SimScreen_t;
+
+/* Screen change drawn for an input, from the tick that queued it */
+typedef struct {
+  uint8_t open;              /* Input taken, its change not on the display yet */
+  uint8_t drawn;             /* Something was drawn for it */
+  uint32_t inputUs;          /* When the input was queued */
+} SimResponse_t;
+
+/* Responses that ended since the last event */
+typedef struct {
+  uint32_t count;
+  uint32_t worstUs;
+} SimWindow_t;
+
+/* Private variables ---------------------------------------------------------*/
+volatile uint32_t systemTick = 0;
+I2C_HandleTypeDef hi2c1;
+
+static const char* const buttonNames[MAX_BUTTONS] = {
+  "menu", "back", "encoder", "preset1", "preset2", "preset3"
+};
+static const char* const actionNames[SIM_TURN + 1] = {
+  "release", "press", "hold", "double", "turn"
+};
+static GPIO_TypeDef* const buttonPorts[MAX_BUTTONS] = {
+  MENU_BTN_GPIO_Port, BACK_BTN_GPIO_Port, ENC_BTN_GPIO_Port,
+  PRESET1_BTN_GPIO_Port, PRESET2_BTN_GPIO_Port, PRESET3_BTN_GPIO_Port
+};
+static const uint16_t buttonPins[MAX_BUTTONS] = {
+  MENU_BTN_Pin, BACK_BTN_Pin, ENC_BTN_Pin,
+  PRESET1_BTN_Pin, PRESET2_BTN_Pin, PRESET3_BTN_Pin
+};
+
+/* AB states of the encoder in clockwise order (A on PB0, B on PB1) */
+static const uint8_t quadrature[4] = { 0x0, 0x1, 0x3, 0x2 };
+static uint8_t encoderPhase = 0;
+
+static SimEvent_t events[SIM_MAX_EVENTS];
+static SimScreen_t screens[SIM_MAX_EVENTS];
+static uint32_t eventCount = 0;
+
+static SystemSettings_t settings;
+static uint32_t paramChanges = 0;
+
+/* Clock within the current tick, and the LCD transfer in flight */
+static uint32_t tickUs = 0;
+static uint8_t busBusy = 0;
+static uint32_t busEndUs = 0;
+
+static SimResponse_t response;
+static SimWindow_t window;
+static uint32_t responses = 0;
+static uint64_t totalLatencyUs = 0;
+static uint32_t worstLatencyUs = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void RunMs(uint32_t ms);
+static uint32_t NowUs(void);
+static void RunBus(uint32_t untilUs);
+static void NoteFlush(uint8_t sent);
+static uint32_t HandleUserInterface(void);
+static void DispatchEncoderSteps(int32_t steps);
+static void SetButton(uint8_t button, uint8_t pressed);
+static void StepEncoder(int8_t direction);
+static void Play(const SimEvent_t* event);
+static int ReadScript(const char* path);
+static void ReadScreen(SimScreen_t* screen);
+static int Compare(const char* path);
+static void InitSettings(void);
+
+/* Simulation ----------------------------------------------------------------*/
+
+/**
+  * @brief  Let time pass in 1 ms steps
+  * @param  ms Milliseconds
+  * @retval None
+  */
+static void RunMs(uint32_t ms)
+{
+  while (ms--) {
+    uint8_t uiDue;
+    uint8_t inputDue;
+
+    /* TIM3: encoder pins at ROTARY_SAMPLE_HZ */
+    for (uint32_t i = 0; i < ROTARY_SAMPLE_HZ / 1000; i++) {
+      RotaryEncoder_SamplePins();
+    }
+
+    /* TIM2: system tick, UI pass every UI_REFRESH_INTERVAL */
+    systemTick++;
+    Host_AdvanceTick(1);
+    uiDue = (systemTick % UI_REFRESH_INTERVAL == 0);
+    if (uiDue) {
+      UI_NeedsRefresh();
+    }
+    LCD_TimerTick();
+
+    /* TIM3: 1 ms input tick */
+    RotaryEncoder_Sample();
+    ButtonHandler_Sample();
+    inputDue = !InputQueue_IsEmpty();
+
+    /* Main loop: ui and lcd tasks */
+    if (uiDue || inputDue) {
+      uint8_t sent;
+
+      if (HandleUserInterface() > 0 && !(response.open && response.drawn)) {
+        response.open = 1;
+        response.drawn = 0;
+      }
+      sent = LCD_Flush();
+      UiProbe_Flushed(sent);
+      NoteFlush(sent);
+    }
+
+    /* I2C: the transfers that end before the next tick */
+    RunBus(HAL_GetTick() * 1000U + 1000U);
+    tickUs = 0;
+  }
+}
+
+/**
+  * @brief  Simulated time
+  * @retval Microseconds since the start
+  */
+static uint32_t NowUs(void)
+{
+  return HAL_GetTick() * 1000U + tickUs;
+}
+
+/**
+  * @brief  Run the LCD bus: end the transfers due by a time, as the I2C
+  *         interrupt does, and close the response whose change is then shown
+  * @param  untilUs Simulated time to run to
+  * @retval None
+  */
+static void RunBus(uint32_t untilUs)
+{
+  while (busBusy && (int32_t)(busEndUs - untilUs) <= 0) {
+    if ((int32_t)(busEndUs - NowUs()) > 0) {
+      tickUs = busEndUs - HAL_GetTick() * 1000U;
+    }
+    busBusy = 0;
+    LCD_TransferComplete();
+
+    if (response.open && response.drawn && LCD_IsIdle()) {
+      uint32_t latency = NowUs() - response.inputUs;
+
+      response.open = 0;
+      responses++;
+      totalLatencyUs += latency;
+      if (latency > worstLatencyUs) {
+        worstLatencyUs = latency;
+      }
+      window.count++;
+      if (latency > window.worstUs) {
+        window.worstUs = latency;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Follow the open response after a flush
+  * @param  sent Characters queued by the flush
+  * @retval None
+  */
+static void NoteFlush(uint8_t sent)
+{
+  if (!response.open || response.drawn) {
+    return;
+  }
+
+  if (sent > 0) {
+    response.drawn = 1;
+  } else if (NowUs() - response.inputUs >= UI_PROBE_WINDOW_MS * 1000U) {
+    /* Drew nothing; a later change is not its response */
+    response.open = 0;
+  }
+}
+
+/**
+  * @brief  Start a transfer on the simulated I2C bus
+  * @param  data PCF8574 bytes
+  * @param  length Number of bytes
+  * @retval None
+  */
+void LCD_MockTransmit(const uint8_t* data, uint16_t length)
+{
+  busBusy = 1;
+  busEndUs = NowUs() + SIM_I2C_FRAME_US + length * SIM_I2C_BYTE_US;
+}
+
+/**
+  * @brief  Transport queue full: the main loop waits for the bus
+  * @retval None
+  */
+void LCD_MockWait(void)
+{
+  if (busBusy) {
+    RunBus(busEndUs);
+  } else {
+    /* A pause after a slow command: let the tick move on */
+    systemTick++;
+    Host_AdvanceTick(1);
+    tickUs = 0;
+    LCD_TimerTick();
+  }
+}
+
+/**
+  * @brief  Take the input events as the ui task of main.c does
+  * @retval Number of events taken
+  */
+static uint32_t HandleUserInterface(void)
+{
+  InputEvent_t inputEvent;
+  ButtonEvent_t buttonEvent;
+  int32_t encoderSteps = 0;
+  uint32_t taken = 0;
+
+  while (InputQueue_Pop(&inputEvent)) {
+    UiProbe_EventTaken(&inputEvent);
+    taken++;
+
+    /* The change drawn next answers the latest input */
+    if (!(response.open && response.drawn)) {
+      response.inputUs = inputEvent.time * 1000U;
+    }
+
+    if (inputEvent.source == INPUT_SOURCE_ENCODER) {
+      encoderSteps += inputEvent.value;
+      continue;
+    }
+
+    DispatchEncoderSteps(encoderSteps);
+    encoderSteps = 0;
+
+    buttonEvent.button = (ButtonID_t)inputEvent.code;
+    buttonEvent.state = (ButtonState_t)inputEvent.state;
+    buttonEvent.holdTime = inputEvent.value;
+    UI_HandleButtonEvent(&buttonEvent);
+  }
+  DispatchEncoderSteps(encoderSteps);
+
+  UI_Update();
+  return taken;
+}
+
+/**
+  * @brief  Pass combined encoder steps to the UI as one rotary event
+  * @param  steps Signed steps, nothing is done for 0
+  * @retval None
+  */
+static void DispatchEncoderSteps(int32_t steps)
+{
+  RotaryEvent_t rotaryEvent;
+
+  if (steps == 0) {
+    return;
+  }
+
+  rotaryEvent.direction = (steps > 0) ? ROTARY_CW : ROTARY_CCW;
+  if (steps < 0) {
+    steps = -steps;
+  }
+  rotaryEvent.steps = (steps > 255) ? 255 : steps;
+  UI_HandleRotaryEvent(&rotaryEvent);
+}
+
+/* Mock input source ---------------------------------------------------------*/
+
+/**
+  * @brief  Drive a button pin (active low)
+  * @param  button ButtonID_t
+  * @param  pressed 1 to press, 0 to release
+  * @retval None
+  */
+static void SetButton(uint8_t button, uint8_t pressed)
+{
+  if (pressed) {
+    buttonPorts[button]->IDR &= ~(uint32_t)buttonPins[button];
+  } else {
+    buttonPorts[button]->IDR |= buttonPins[button];
+  }
+}
+
+/**
+  * @brief  Move the encoder by one quadrature edge
+  * @param  direction 1 clockwise, -1 counter-clockwise
+  * @retval None
+  */
+static void StepEncoder(int8_t direction)
+{
+  uint8_t ab;
+
+  encoderPhase = (uint8_t)(encoderPhase + direction) & 3;
+  ab = quadrature[encoderPhase];
+  GPIOB->IDR = (GPIOB->IDR & ~(uint32_t)(GPIO_PIN_0 | GPIO_PIN_1)) |
+               ((ab & 0x2) ? GPIO_PIN_0 : 0) | ((ab & 0x1) ? GPIO_PIN_1 : 0);
+}
+
+/**
+  * @brief  Play one script event on the pins
+  * @param  event Script event
+  * @retval None
+  */
+static void Play(const SimEvent_t* event)
+{
+  switch (event->action) {
+    case SIM_TURN: {
+      int8_t direction = (event->value > 0) ? 1 : -1;
+      int32_t edges = 4 * ((event->value > 0) ? event->value : -event->value);
+
+      while (edges-- > 0) {
+        StepEncoder(direction);
+        RunMs(SIM_EDGE_MS);
+      }
+      break;
+    }
+
+    case SIM_PRESS:
+      SetButton(event->button, 1);
+      break;
+
+    case SIM_RELEASE:
+      SetButton(event->button, 0);
+      break;
+
+    case SIM_HOLD:
+      SetButton(event->button, 1);
+      RunMs(event->value);
+      SetButton(event->button, 0);
+      break;
+
+    case SIM_DOUBLE:
+      for (uint8_t click = 0; click < 2; click++) {
+        SetButton(event->button, 1);
+        RunMs(SIM_CLICK_MS);
+        SetButton(event->button, 0);
+        RunMs(SIM_CLICK_MS);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/* Script and screens --------------------------------------------------------*/
+
+/**
+  * @brief  Read the event script
+  * @param  path Script file
+  * @retval 0 on success, 1 on error (reported)
+  */
+static int ReadScript(const char* path)
+{
+  char line[SIM_LINE_SIZE];
+  uint32_t number = 0;
+  FILE* script = fopen(path, "r");
+
+  if (script == NULL) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+
+  while (fgets(line, sizeof(line), script) != NULL) {
+    char action[16];
+    char argument[16] = "";
+    long value = 0;
+    unsigned long at;
+    int fields;
+    SimEvent_t* event = &events[eventCount];
+
+    number++;
+    line[strcspn(line, "#\r\n")] = '\0';
+    fields = sscanf(line, "%lu %15s %15s %ld", &at, action, argument, &value);
+    if (fields <= 0) {
+      continue;
+    }
+
+    event->at = at;
+    event->action = SIM_TURN + 1;
+    for (uint8_t i = 0; i <= SIM_TURN; i++) {
+      if (strcmp(action, actionNames[i]) == 0) {
+        event->action = i;
+      }
+    }
+
+    if (event->action == SIM_TURN) {
+      event->value = strtol(argument, NULL, 10);
+      event->button = 0;
+      snprintf(event->text, sizeof(event->text), "turn %ld", (long)event->value);
+    } else {
+      event->button = MAX_BUTTONS;
+      for (uint8_t i = 0; i < MAX_BUTTONS; i++) {
+        if (strcmp(argument, buttonNames[i]) == 0) {
+          event->button = i;
+        }
+      }
+      event->value = (fields > 3) ? value : 0;
+      if (fields > 3) {
+        snprintf(event->text, sizeof(event->text), "%s %s %ld", action, argument, value);
+      } else {
+        snprintf(event->text, sizeof(event->text), "%s %s", action, argument);
+      }
+    }
+
+    if (fields < 3 || event->action > SIM_TURN || event->button >= MAX_BUTTONS ||
+        eventCount + 1 >= SIM_MAX_EVENTS) {
+      fprintf(stderr, "%s:%lu: cannot read '%s'\n", path, (unsigned long)number, line);
+      fclose(script);
+      return 1;
+    }
+    eventCount++;
+  }
+
+  fclose(script);
+  return 0;
+}
+
+/**
+  * @brief  Read the 16x2 screen as text (HD44780 characters as in ui_replay.py)
+  * @param  screen Screen to fill
+  * @retval None
+  */
+static void ReadScreen(SimScreen_t* screen)
+{
+  static const char* const customGlyphs[8] = {
+    "⓪", "①", "②", "③", "④", "⑤", "⑥", "⑦"
+  };
+  uint8_t text[LCD_SCREEN_SIZE];
+
+  LCD_GetScreen(text);
+  for (uint8_t row = 0; row < 2; row++) {
+    char* out = screen->line[row];
+
+    *out = '\0';
+    for (uint8_t col = 0; col < LCD_SCREEN_SIZE / 2; col++) {
+      uint8_t code = text[row * (LCD_SCREEN_SIZE / 2) + col];
+
+      if (code < 8) {
+        strcat(out, customGlyphs[code]);
+      } else if (code == 0xDF) {
+        strcat(out, "°");
+      } else if (code >= 0x20 && code < 0x7F) {
+        char c[2] = { (char)code, '\0' };
+        strcat(out, c);
+      } else {
+        strcat(out, "?");
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Compare the screens with a recording
+  * @param  path Recording file
+  * @retval Number of differences
+  */
+static int Compare(const char* path)
+{
+  char header[SIM_LINE_SIZE];
+  char line[2][SIM_LINE_SIZE];
+  uint32_t step = 0;
+  int failures = 0;
+  FILE* recording = fopen(path, "r");
+
+  if (recording == NULL) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+
+  while (fgets(header, sizeof(header), recording) != NULL &&
+         fgets(line[0], sizeof(line[0]), recording) != NULL &&
+         fgets(line[1], sizeof(line[1]), recording) != NULL) {
+    if (step < eventCount) {
+      char got[2][SIM_LINE_SIZE];
+
+      for (uint8_t row = 0; row < 2; row++) {
+        line[row][strcspn(line[row], "\r\n")] = '\0';
+        snprintf(got[row], sizeof(got[row]), "|%s|", screens[step].line[row]);
+      }
+      if (strcmp(line[0], got[0]) != 0 || strcmp(line[1], got[1]) != 0) {
+        fprintf(stderr, "%lu %s: %s%s expected %s%s\n", (unsigned long)events[step].at,
+                events[step].text, got[0], got[1] + 1, line[0], line[1] + 1);
+        failures++;
+      }
+    }
+    step++;
+  }
+  fclose(recording);
+
+  if (step != eventCount) {
+    fprintf(stderr, "recording has %lu steps, script %lu\n", (unsigned long)step,
+            (unsigned long)eventCount);
+    failures++;
+  }
+  return failures;
+}
+
+/* Stand-ins for the audio and preset modules --------------------------------*/
+
+/**
+  * @brief  Settings the menus edit (the audio chain does not run)
+  * @retval None
+  */
+static void InitSettings(void)
+{
+  memset(&settings, 0, sizeof(settings));
+  settings.crossover.lowCutoff = 80.0f;
+  settings.crossover.midCutoff = 500.0f;
+  settings.crossover.highCutoff = 4000.0f;
+  settings.crossover.filterType = 1;
+  settings.crossover.filterOrder = 4;
+}
+
+SystemSettings_t* ParamUpdate_GetSettings(void)
+{
+  return &settings;
+}
+
+void ParamUpdate_Mark(uint16_t dirty)
+{
+  paramChanges++;
+}
+
+void AudioProcessing_GetStats(AudioProcessingStats_t* pStats)
+{
+  memset(pStats, 0, sizeof(AudioProcessingStats_t));
+}
+
+void Crossover_GetSettings(struct CrossoverSettings_t* crossover)
+{
+  *crossover = settings.crossover;
+}
+
+void Compressor_GetSettings(CompressorSettings_t* compressor)
+{
+  *compressor = settings.compressor;
+}
+
+void Limiter_GetSettings(LimiterSettings_t* limiter)
+{
+  *limiter = settings.limiter;
+}
+
+void Delay_GetSettings(DelaySettings_t* delay)
+{
+  *delay = settings.delay;
+}
+
+uint8_t PresetManager_GetPresetInfo(uint8_t presetId, PresetMetadata_t* metadata)
+{
+  return PRESET_STATUS_EMPTY;
+}
+
+uint8_t PresetManager_SavePresetAsync(uint8_t presetId, const PresetSettings_t* presetSettings,
+                                      PresetSaveCallback_t callback)
+{
+  if (callback != NULL) {
+    callback(presetId, PRESET_STATUS_OK);
+  }
+  return PRESET_STATUS_OK;
+}
+
+uint8_t PresetManager_GetNumUserPresets(void)
+{
+  return 0;
+}
+
+void PresetManager_SaveUserPreset(uint8_t index)
+{
+}
+
+void PresetManager_LoadUserPreset(uint8_t index)
+{
+}
+
+void FactoryPresets_Load(uint8_t presetId)
+{
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+  const char* scriptPath = NULL;
+  const char* recordPath = NULL;
+  const char* comparePath = NULL;
+  double maxLatency = -1.0;
+  SimScreen_t previous;
+  LCD_StatsTypeDef lcdStats;
+  uint32_t busBefore;
+  uint32_t worstBusBytes = 0;
+  uint32_t changed = 0;
+  uint32_t timed = 0;
+  int status = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      recordPath = argv[++i];
+    } else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+      comparePath = argv[++i];
+    } else if (strcmp(argv[i], "--max-latency") == 0 && i + 1 < argc) {
+      maxLatency = strtod(argv[++i], NULL);
+    } else if (scriptPath == NULL && argv[i][0] != '-') {
+      scriptPath = argv[i];
+    } else {
+      scriptPath = NULL;
+      break;
+    }
+  }
+  if (scriptPath == NULL) {
+    fprintf(stderr, "usage: %s SCRIPT [--record FILE] [--compare FILE] [--max-latency MS]\n", argv[0]);
+    return 2;
+  }
+  if (ReadScript(scriptPath) != 0) {
+    return 2;
+  }
+
+  /* Buttons released, encoder on a detent */
+  GPIOA->IDR = MENU_BTN_Pin | BACK_BTN_Pin | ENC_BTN_Pin |
+               PRESET1_BTN_Pin | PRESET2_BTN_Pin | PRESET3_BTN_Pin;
+  GPIOB->IDR = GPIO_PIN_2;
+
+  /* Start up as InitSystem() does */
+  InitSettings();
+  LCD_Init();
+  InputQueue_Init();
+  RotaryEncoder_Init();
+  ButtonHandler_Init();
+  UiProbe_Init();
+  Menu_Init();
+  UI_Init();
+  RunMs(SIM_BOOT_MS);
+
+  uint32_t start = HAL_GetTick();
+  ReadScreen(&previous);
+
+  for (uint32_t i = 0; i < eventCount; i++) {
+    const SimEvent_t* event = &events[i];
+    uint32_t until;
+    char result[40];
+
+    if (HAL_GetTick() - start < event->at) {
+      RunMs(event->at - (HAL_GetTick() - start));
+    }
+    memset(&window, 0, sizeof(window));
+    LCD_GetStats(&lcdStats);
+    busBefore = lcdStats.BusWrites;
+    Play(event);
+
+    /* Give the UI until the next event to respond */
+    until = (i + 1 < eventCount) ? start + events[i + 1].at : HAL_GetTick() + SIM_SETTLE_MS;
+    if ((int32_t)(until - HAL_GetTick()) > 0) {
+      RunMs(until - HAL_GetTick());
+    }
+
+    /* Compare with the screen after the event before */
+    ReadScreen(&screens[i]);
+    LCD_GetStats(&lcdStats);
+    uint32_t busBytes = lcdStats.BusWrites - busBefore;
+    if (busBytes > worstBusBytes) {
+      worstBusBytes = busBytes;
+    }
+
+    if (memcmp(&screens[i], &previous, sizeof(previous)) == 0) {
+      snprintf(result, sizeof(result), "%-18s", "   no change");
+    } else if (window.count > 0) {
+      snprintf(result, sizeof(result), "%7.2f ms %5lu B", window.worstUs / 1000.0,
+               (unsigned long)busBytes);
+      changed++;
+    } else {
+      snprintf(result, sizeof(result), "%7s    %5lu B", "timer", (unsigned long)busBytes);
+      changed++;
+      timed++;
+    }
+    previous = screens[i];
+
+    printf("%6lu  %-20s %s |%s|%s|\n", (unsigned long)event->at, event->text, result,
+           screens[i].line[0], screens[i].line[1]);
+  }
+
+  fprintf(stderr, "%lu events, %lu changed the screen (%lu by the timer); %lu responses, "
+          "latency avg %.2f ms, worst %.2f ms; worst %lu LCD bytes; %lu parameter edits\n",
+          (unsigned long)eventCount, (unsigned long)changed, (unsigned long)timed,
+          (unsigned long)responses, responses ? totalLatencyUs / 1000.0 / responses : 0.0,
+          worstLatencyUs / 1000.0, (unsigned long)worstBusBytes, (unsigned long)paramChanges);
+
+  if (recordPath != NULL) {
+    FILE* out = fopen(recordPath, "w");
+    if (out == NULL) {
+      fprintf(stderr, "cannot write %s\n", recordPath);
+      return 1;
+    }
+    for (uint32_t i = 0; i < eventCount; i++) {
+      fprintf(out, "@ %lu %s\n|%s|\n|%s|\n", (unsigned long)events[i].at, events[i].text,
+              screens[i].line[0], screens[i].line[1]);
+    }
+    fclose(out);
+  }
+  if (comparePath != NULL && Compare(comparePath) != 0) {
+    status = 1;
+  }
+  if (maxLatency >= 0.0 && worstLatencyUs > maxLatency * 1000.0) {
+    fprintf(stderr, "worst latency %.2f ms over the limit of %.2f ms\n",
+            worstLatencyUs / 1000.0, maxLatency);
+    status = 1;
+  }
+  return status;
+}
+
+/************************ (C) COPYRIGHT Audio Crossover Project *****END OF FILE****/
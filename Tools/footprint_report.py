@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""
+Per-module RAM/flash footprint report for the Audio Crossover firmware.
+
+Parses the GNU ld map file (-Wl,-Map=...) and, optionally, the *.su files
+produced by -fstack-usage, then prints .text/.rodata/.data/.bss and the
+largest stack frame for every object file. When a budget file is given the
+script exits with status 1 if any module exceeds its budget, so it can be
+used as a post-build step to fail the build.
+
+Usage:
+    footprint_report.py AudioCrossover.map [--su-dir DIR] [--budget FILE]
+
+Budget file format (one module per line, '-' = not checked, sizes in bytes):
+    # module          text    rodata  data  bss    stack
+    crossover         6000    256     0     2048   256
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import OrderedDict
+
+SECTIONS = ("text", "rodata", "data", "bss", "stack")
+
+# " .bss.delayInstance  0x20000100   0x60 ./App/Src/delay.o" (may be split on two lines)
+SECTION_RE = re.compile(r"^ (\.text|\.rodata|\.data|\.bss|COMMON)(\.\S+)?\s*$")
+ENTRY_RE = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S+\.o)\)?\s*$")
+INLINE_RE = re.compile(r"^ (\.text|\.rodata|\.data|\.bss|COMMON)(\.\S+)?\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S+\.o)\)?\s*$")
+
+# "crossover.c:217:6:Crossover_Process	48	static"
+SU_RE = re.compile(r"^(?P<file>[^:]+):\d+:\d+:(?P<func>\S+)\s+(?P<size>\d+)\s+(?P<kind>\S+)")
+
+
+def module_name(path):
+    """Map an object path (possibly inside an archive) to a module name."""
+    base = os.path.basename(path.rstrip(")"))
+    if "(" in base:
+        base = base.split("(")[-1]
+    return os.path.splitext(base)[0]
+
+
+def section_kind(name):
+    if name == "COMMON":
+        return "bss"
+    return name.lstrip(".")
+
+
+def parse_map(path):
+    usage = OrderedDict()
+    in_map = False
+    pending = None
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+
+            if line.startswith("Linker script and memory map"):
+                in_map = True
+                continue
+            if not in_map:
+                continue
+
+            match = INLINE_RE.match(line)
+            if match:
+                kind = section_kind(match.group(1))
+                size = int(match.group(4), 16)
+                add_usage(usage, module_name(match.group(5)), kind, size)
+                pending = None
+                continue
+
+            match = SECTION_RE.match(line)
+            if match:
+                pending = section_kind(match.group(1))
+                continue
+
+            if pending is not None:
+                match = ENTRY_RE.match(line)
+                if match:
+                    add_usage(usage, module_name(match.group(3)), pending, int(match.group(2), 16))
+                pending = None
+
+    return usage
+
+
+def parse_stack_usage(su_dir, usage):
+    for root, _dirs, files in os.walk(su_dir):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(root, name), "r", errors="replace") as f:
+                for line in f:
+                    match = SU_RE.match(line)
+                    if not match:
+                        continue
+                    module = os.path.splitext(os.path.basename(match.group("file")))[0]
+                    entry = usage.setdefault(module, dict.fromkeys(SECTIONS, 0))
+                    # Worst single frame; call-graph depth is measured at runtime
+                    entry["stack"] = max(entry["stack"], int(match.group("size")))
+
+
+def add_usage(usage, module, kind, size):
+    if kind not in SECTIONS or size == 0:
+        return
+    entry = usage.setdefault(module, dict.fromkeys(SECTIONS, 0))
+    entry[kind] += size
+
+
+def parse_budget(path):
+    budget = OrderedDict()
+    with open(path, "r") as f:
+        for number, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != len(SECTIONS) + 1:
+                sys.exit("%s:%d: expected module and %d limits" % (path, number, len(SECTIONS)))
+            limits = {}
+            for kind, value in zip(SECTIONS, fields[1:]):
+                limits[kind] = None if value == "-" else int(value, 0)
+            budget[fields[0]] = limits
+    return budget
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-module footprint report")
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("--su-dir", help="directory containing -fstack-usage .su files")
+    parser.add_argument("--budget", help="budget file; exit 1 when a budget is exceeded")
+    args = parser.parse_args()
+
+    usage = parse_map(args.map)
+    if args.su_dir:
+        parse_stack_usage(args.su_dir, usage)
+
+    print("%-24s %8s %8s %8s %8s %8s" % ("module", "text", "rodata", "data", "bss", "stack"))
+    totals = dict.fromkeys(SECTIONS, 0)
+    for module in sorted(usage, key=lambda m: -(usage[m]["bss"] + usage[m]["data"])):
+        entry = usage[module]
+        print("%-24s %8d %8d %8d %8d %8d" % ((module,) + tuple(entry[k] for k in SECTIONS)))
+        for kind in SECTIONS:
+            if kind != "stack":
+                totals[kind] += entry[kind]
+    print("%-24s %8d %8d %8d %8d %8s" % ("TOTAL", totals["text"], totals["rodata"],
+                                          totals["data"], totals["bss"], "-"))
+    print("RAM (data+bss): %d bytes, flash (text+rodata+data): %d bytes" %
+          (totals["data"] + totals["bss"], totals["text"] + totals["rodata"] + totals["data"]))
+
+    if not args.budget:
+        return 0
+
+    failures = []
+    for module, limits in parse_budget(args.budget).items():
+        entry = usage.get(module, dict.fromkeys(SECTIONS, 0))
+        for kind in SECTIONS:
+            limit = limits[kind]
+            if limit is not None and entry[kind] > limit:
+                failures.append("%s: %s %d > budget %d" % (module, kind, entry[kind], limit))
+
+    for failure in failures:
+        print("FOOTPRINT BUDGET EXCEEDED: " + failure, file=sys.stderr)
+
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
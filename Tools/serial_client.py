@@ -0,0 +1,381 @@
+#!/usr/bin/env python3
+"""
+Reference client for the USART1 serial protocol of the Audio Crossover firmware.
+
+Talks to the board through a USB-serial adapter, or to anything else that
+speaks the protocol on a tty (e.g. a simulator behind a pty). Linux only; uses
+termios directly, no extra packages needed.
+
+Frame (little-endian), see App/Inc/serial_protocol.h:
+    SOF 0xA5 | length u16 | type u8 | sequence u8 | payload | CRC32 u32
+The CRC (IEEE 802.3, same as zlib.crc32) covers length..payload.
+
+Usage:
+    serial_client.py PORT [--baud N] ping
+    serial_client.py PORT stats
+    serial_client.py PORT tasks
+    serial_client.py PORT load US
+    serial_client.py PORT params
+    serial_client.py PORT get NAME|ID
+    serial_client.py PORT set NAME|ID VALUE
+    serial_client.py PORT list
+    serial_client.py PORT export DIR [--id N ...]
+    serial_client.py PORT import FILE... [--id N]
+    serial_client.py PORT delete ID
+    serial_client.py PORT bench [--bauds 115200,460800,921600] [--seconds S]
+
+Exported presets are the encoded records as stored in flash (preset_codec
+format), one file per preset named preset_<id>.bin.
+"""
+
+import argparse
+import glob
+import os
+import re
+import struct
+import sys
+import termios
+import time
+import zlib
+
+SOF = 0xA5
+HEADER = struct.Struct("<BHBB")
+RESPONSE = 0x80
+
+MSG_PING = 0x01
+MSG_GET_STATS = 0x02
+MSG_TASK_STATS = 0x03
+MSG_TEST_LOAD = 0x04
+MSG_PARAM_GET = 0x10
+MSG_PARAM_SET = 0x11
+MSG_PRESET_LIST = 0x20
+MSG_PRESET_READ = 0x21
+MSG_PRESET_WRITE = 0x22
+MSG_PRESET_DELETE = 0x23
+MSG_TELEMETRY_RATE = 0x30
+MSG_UI_INPUT = 0x40
+MSG_UI_SCREEN = 0x41
+MSG_TELEMETRY = 0xC0
+
+STATUS_NAMES = {
+    0: "ok",
+    1: "unknown message",
+    2: "bad length",
+    3: "invalid",
+    4: "busy",
+    5: "empty",
+    6: "storage error",
+}
+STATUS_OK = 0
+STATUS_BUSY = 4
+STATUS_EMPTY = 5
+
+PRESET_ID_INVALID = 0xFF
+
+# AudioProcessingStats_t (App/Inc/audio_processing.h)
+STATS = struct.Struct("<2f2f8f4f4f6I")
+# DSP_QUALITY_* (App/Inc/dsp_watchdog.h)
+QUALITY_NAMES = {0: "full", 1: "crossover 24 dB/oct", 2: "minimal"}
+# SchedulerTaskStats_t (App/Inc/scheduler.h)
+TASK_STATS = struct.Struct("<8I")
+
+BAUD_RATES = {
+    9600: termios.B9600, 19200: termios.B19200, 38400: termios.B38400,
+    57600: termios.B57600, 115200: termios.B115200, 230400: termios.B230400,
+    460800: termios.B460800, 921600: termios.B921600,
+}
+
+
+class ProtocolError(Exception):
+    pass
+
+
+class Link:
+    """One request at a time over a raw tty."""
+
+    def __init__(self, path, baud, timeout):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        self.timeout = timeout
+        self.sequence = 0
+        self.retries = 0
+        self.set_baud(baud)
+
+    def close(self):
+        os.close(self.fd)
+
+    def set_baud(self, baud):
+        if baud not in BAUD_RATES:
+            raise ProtocolError("unsupported baud rate %d" % baud)
+        attrs = termios.tcgetattr(self.fd)
+        attrs[0] = 0                                          # iflag: raw
+        attrs[1] = 0                                          # oflag: raw
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                          # lflag: raw
+        attrs[4] = attrs[5] = BAUD_RATES[baud]
+        attrs[6][termios.VMIN] = 0
+        attrs[6][termios.VTIME] = 1
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+        self.baud = baud
+
+    def _read_exact(self, count, deadline):
+        data = b""
+        while len(data) < count:
+            if time.monotonic() > deadline:
+                return None
+            chunk = os.read(self.fd, count - len(data))
+            data += chunk
+        return data
+
+    def receive(self, deadline):
+        """Next frame with a good CRC as (type, sequence, payload), or None at the deadline."""
+        while True:
+            byte = self._read_exact(1, deadline)
+            if byte is None:
+                return None
+            if byte[0] != SOF:
+                continue
+            header = self._read_exact(HEADER.size - 1, deadline)
+            if header is None:
+                return None
+            _, length, msg_type, sequence = HEADER.unpack(byte + header)
+            rest = self._read_exact(length + 4, deadline)
+            if rest is None:
+                return None
+            payload, crc = rest[:length], struct.unpack("<I", rest[length:])[0]
+            if zlib.crc32(header + payload) != crc:
+                continue
+            return msg_type, sequence, payload
+
+    def request(self, msg_type, payload=b"", attempts=3):
+        """Send a request and return the response payload (status byte first)."""
+        for _ in range(attempts):
+            self.sequence = (self.sequence + 1) & 0xFF
+            body = struct.pack("<HBB", len(payload), msg_type, self.sequence) + payload
+            os.write(self.fd, bytes([SOF]) + body + struct.pack("<I", zlib.crc32(body)))
+
+            deadline = time.monotonic() + self.timeout
+            while True:
+                frame = self.receive(deadline)
+                if frame is None:
+                    break
+                if frame[0] == msg_type | RESPONSE and frame[1] == self.sequence:
+                    return frame[2]
+            self.retries += 1
+        raise ProtocolError("no response to message 0x%02x" % msg_type)
+
+    def request_ok(self, msg_type, payload=b"", busy_wait=2.0):
+        """Like request(), retrying while busy; raises on any other error status."""
+        deadline = time.monotonic() + busy_wait
+        while True:
+            response = self.request(msg_type, payload)
+            if response[0] != STATUS_BUSY or time.monotonic() > deadline:
+                break
+            time.sleep(0.01)
+        if response[0] != STATUS_OK:
+            raise ProtocolError(STATUS_NAMES.get(response[0], "status %d" % response[0]))
+        return response[1:]
+
+
+def read_params(link):
+    info = link.request_ok(MSG_PING)
+    count = info[5]
+    params = []
+    for param_id in range(count):
+        data = link.request_ok(MSG_PARAM_GET, bytes([param_id]))
+        _, ptype, value, low, high = struct.unpack("<BBfff", data[:14])
+        name = data[14:].split(b"\0")[0].decode()
+        params.append((param_id, name, ptype, value, low, high))
+    return params
+
+
+def resolve_param(link, key):
+    if key.isdigit():
+        return int(key)
+    for param_id, name, *_ in read_params(link):
+        if name == key:
+            return param_id
+    raise ProtocolError("unknown parameter %s" % key)
+
+
+def list_presets(link):
+    presets = []
+    preset_id = 0
+    while preset_id != PRESET_ID_INVALID:
+        data = link.request_ok(MSG_PRESET_LIST, bytes([preset_id]))
+        preset_id, count = data[0], data[1]
+        for i in range(count):
+            entry = data[2 + 17 * i:2 + 17 * (i + 1)]
+            presets.append((entry[0], entry[1:].split(b"\0")[0].decode(errors="replace")))
+    return presets
+
+
+def cmd_ping(link, args):
+    info = link.request_ok(MSG_PING)
+    version, max_payload, user_start, total, params = struct.unpack("<BHBBB", info[:6])
+    print("protocol v%d, max payload %d, user presets %d-%d, %d parameters"
+          % (version, max_payload, user_start, total - 1, params))
+
+
+def cmd_stats(link, args):
+    values = STATS.unpack(link.request_ok(MSG_GET_STATS)[:STATS.size])
+    print("input peak      L %.3f  R %.3f" % values[0:2])
+    print("output peak     L %.3f  R %.3f" % values[2:4])
+    for band, name in enumerate(("sub", "low", "mid", "high")):
+        print("%-4s peak       L %.3f  R %.3f  comp %.1f dB  lim %.1f dB"
+              % (name, values[4 + 2 * band], values[5 + 2 * band],
+                 values[12 + band], values[16 + band]))
+    print("clipping        %d" % values[20])
+    print("block time      %d us (crossfade peak %d us)" % (values[21], values[22]))
+    print("deadline misses %d, quality level %d (%s), lowered %d times"
+          % (values[23], values[24], QUALITY_NAMES.get(values[24], "?"), values[25]))
+
+
+def cmd_tasks(link, args):
+    print("%-10s %8s %7s %8s %8s %10s %7s" % ("task", "runs", "yields", "last us", "worst us",
+                                              "worst resp", "misses"))
+    index, count = 0, 1
+    while index < count:
+        data = link.request_ok(MSG_TASK_STATS, bytes([index]))
+        count = data[1]
+        runs, yields, last, worst, _, _, response, misses = TASK_STATS.unpack_from(data, 2)
+        name = data[2 + TASK_STATS.size:].split(b"\0")[0].decode(errors="replace")
+        print("%-10s %8d %7d %8d %8d %10d %7d" % (name, runs, yields, last, worst, response, misses))
+        index += 1
+
+
+def cmd_load(link, args):
+    data = link.request_ok(MSG_TEST_LOAD, struct.pack("<I", args.us))
+    print("test load %d us per block" % struct.unpack("<I", data[:4])[0])
+
+
+def cmd_params(link, args):
+    for param_id, name, ptype, value, low, high in read_params(link):
+        print("%3d  %-22s %10.3f  [%g .. %g]%s"
+              % (param_id, name, value, low, high, " bool" if ptype else ""))
+
+
+def cmd_get(link, args):
+    param_id = resolve_param(link, args.param)
+    data = link.request_ok(MSG_PARAM_GET, bytes([param_id]))
+    print("%.3f" % struct.unpack("<f", data[2:6])[0])
+
+
+def cmd_set(link, args):
+    param_id = resolve_param(link, args.param)
+    data = link.request_ok(MSG_PARAM_SET, struct.pack("<Bf", param_id, args.value))
+    print("%.3f" % struct.unpack("<f", data[1:5])[0])
+
+
+def cmd_list(link, args):
+    for preset_id, name in list_presets(link):
+        print("%3d  %s" % (preset_id, name))
+
+
+def cmd_export(link, args):
+    os.makedirs(args.dir, exist_ok=True)
+    ids = args.id or [preset_id for preset_id, _ in list_presets(link)]
+    total = 0
+    start = time.monotonic()
+    for preset_id in ids:
+        data = link.request_ok(MSG_PRESET_READ, bytes([preset_id]))
+        with open(os.path.join(args.dir, "preset_%d.bin" % preset_id), "wb") as f:
+            f.write(data[1:])
+        total += len(data) - 1
+    elapsed = time.monotonic() - start
+    print("exported %d presets (%d bytes) in %.2fs" % (len(ids), total, elapsed))
+
+
+def cmd_import(link, args):
+    files = [path for pattern in args.files for path in sorted(glob.glob(pattern))]
+    start = time.monotonic()
+    for path in files:
+        if args.id is not None:
+            preset_id = args.id
+        else:
+            match = re.search(r"preset_(\d+)\.bin$", path)
+            if not match:
+                raise ProtocolError("%s: use --id to give the preset ID" % path)
+            preset_id = int(match.group(1))
+        with open(path, "rb") as f:
+            record = f.read()
+        link.request_ok(MSG_PRESET_WRITE, bytes([preset_id]) + record)
+        print("%s -> preset %d" % (path, preset_id))
+    elapsed = time.monotonic() - start
+    print("imported %d presets in %.2fs" % (len(files), elapsed))
+
+
+def cmd_delete(link, args):
+    link.request_ok(MSG_PRESET_DELETE, bytes([args.preset_id]))
+
+
+def cmd_bench(link, args):
+    """Round trips of the largest response (a preset record) per baud rate."""
+    print("%8s %10s %10s %10s %8s" % ("baud", "frames/s", "bytes/s", "line max", "retries"))
+    for baud in [int(b) for b in args.bauds.split(",")]:
+        link.set_baud(baud)
+        link.retries = 0
+        frames = 0
+        wire_bytes = 0
+        start = time.monotonic()
+        while time.monotonic() - start < args.seconds:
+            data = link.request_ok(MSG_PRESET_READ, bytes([0]))
+            frames += 1
+            wire_bytes += 2 * 9 + 1 + len(data) + 1
+        elapsed = time.monotonic() - start
+        print("%8d %10.1f %10.0f %10.0f %8d"
+              % (baud, frames / elapsed, wire_bytes / elapsed, baud / 10.0, link.retries))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("port", help="serial device or pty, e.g. /dev/ttyUSB0")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=0.5, help="response timeout in seconds")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    commands.add_parser("ping").set_defaults(func=cmd_ping)
+    commands.add_parser("stats").set_defaults(func=cmd_stats)
+    commands.add_parser("tasks").set_defaults(func=cmd_tasks)
+    p = commands.add_parser("load")
+    p.add_argument("us", type=int)
+    p.set_defaults(func=cmd_load)
+    commands.add_parser("params").set_defaults(func=cmd_params)
+    p = commands.add_parser("get")
+    p.add_argument("param")
+    p.set_defaults(func=cmd_get)
+    p = commands.add_parser("set")
+    p.add_argument("param")
+    p.add_argument("value", type=float)
+    p.set_defaults(func=cmd_set)
+    commands.add_parser("list").set_defaults(func=cmd_list)
+    p = commands.add_parser("export")
+    p.add_argument("dir")
+    p.add_argument("--id", type=int, action="append")
+    p.set_defaults(func=cmd_export)
+    p = commands.add_parser("import")
+    p.add_argument("files", nargs="+")
+    p.add_argument("--id", type=int)
+    p.set_defaults(func=cmd_import)
+    p = commands.add_parser("delete")
+    p.add_argument("preset_id", type=int)
+    p.set_defaults(func=cmd_delete)
+    p = commands.add_parser("bench")
+    p.add_argument("--bauds", default="115200,230400,460800,921600")
+    p.add_argument("--seconds", type=float, default=3.0)
+    p.set_defaults(func=cmd_bench)
+
+    args = parser.parse_args()
+    link = Link(args.port, args.baud, args.timeout)
+    try:
+        args.func(link, args)
+    except ProtocolError as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+    finally:
+        link.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""
+Telemetry stream decoder for the Audio Crossover firmware.
+
+Starts the telemetry stream over the USART1 serial protocol, decodes the
+delta coded frames (see App/Inc/telemetry.h) and writes one CSV row per
+sample, or plots input/output peaks and DSP load live (needs matplotlib).
+The stream is stopped again on exit.
+
+Usage:
+    telemetry_decoder.py PORT [--baud N] [--rate HZ] [--csv FILE] [--seconds S]
+    telemetry_decoder.py PORT --plot [--rate HZ]
+"""
+
+import argparse
+import collections
+import csv
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from serial_client import Link, ProtocolError, MSG_TELEMETRY, MSG_TELEMETRY_RATE  # noqa: E402
+
+FORMAT_VERSION = 1
+HEADER = struct.Struct("<BHHHBB")
+
+BANDS = ("sub", "low", "mid", "high")
+LEVEL_FIELDS = (["in_l", "in_r", "out_l", "out_r"]
+                + ["%s_%s" % (band, ch) for band in BANDS for ch in ("l", "r")]
+                + ["comp_%s" % band for band in BANDS]
+                + ["lim_%s" % band for band in BANDS])
+TIME_FIELDS = ["clipping", "block_us", "worst_us", "crossfade_us", "idle_pct"]
+FIELDS = LEVEL_FIELDS + TIME_FIELDS
+
+
+def read_varint(data, position):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, position
+
+
+def decode_frame(payload):
+    """Return (first sample number, interval ms, block period us, samples)."""
+    version, first, interval, block_us, field_count, count = HEADER.unpack_from(payload)
+    if version != FORMAT_VERSION:
+        raise ProtocolError("telemetry format %d not supported" % version)
+    position = HEADER.size
+    previous = [0] * field_count
+    samples = []
+    for _ in range(count):
+        sample = []
+        for field in range(field_count):
+            zigzag, position = read_varint(payload, position)
+            delta = (zigzag >> 1) ^ -(zigzag & 1)
+            value = (previous[field] + delta) & 0xFFFFFFFF
+            if value & 0x80000000:
+                value -= 1 << 32
+            sample.append(value)
+        previous = sample
+        samples.append(sample)
+    return first, interval, block_us, samples
+
+
+def to_row(number, interval, block_us, sample):
+    row = {"sample": number, "time_s": "%.3f" % (number * interval / 1000.0)}
+    for name, value in zip(LEVEL_FIELDS, sample):
+        row[name] = "%.1f" % (value / 10.0)
+    for name, value in zip(TIME_FIELDS, sample[len(LEVEL_FIELDS):]):
+        row[name] = value
+    if "idle_pct" in row:
+        row["idle_pct"] = "%.1f" % (row["idle_pct"] / 10.0)
+    row["dsp_load_pct"] = "%.1f" % (100.0 * sample[FIELDS.index("worst_us")] / block_us)
+    return row
+
+
+def stream(link, seconds):
+    """Yield CSV rows until the time is up (or forever); reports lost samples."""
+    expected = None
+    end = time.monotonic() + seconds if seconds else None
+    while end is None or time.monotonic() < end:
+        frame = link.receive(time.monotonic() + 1.0)
+        if frame is None or frame[0] != MSG_TELEMETRY:
+            continue
+        first, interval, block_us, samples = decode_frame(frame[2])
+        if expected is not None and first != expected:
+            print("lost %d samples" % ((first - expected) & 0xFFFF), file=sys.stderr)
+        expected = (first + len(samples)) & 0xFFFF
+        for i, sample in enumerate(samples):
+            yield to_row((first + i) & 0xFFFF, interval, block_us, sample)
+
+
+def write_csv(link, args):
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.DictWriter(out, fieldnames=["sample", "time_s"] + FIELDS + ["dsp_load_pct"])
+    writer.writeheader()
+    rows = 0
+    start = time.monotonic()
+    for row in stream(link, args.seconds):
+        writer.writerow(row)
+        rows += 1
+    if out is not sys.stdout:
+        out.close()
+    elapsed = time.monotonic() - start
+    print("%d samples in %.1fs" % (rows, elapsed), file=sys.stderr)
+
+
+def plot(link, args):
+    import matplotlib.pyplot as plt
+    from matplotlib.animation import FuncAnimation
+
+    window = args.rate * 10
+    history = {name: collections.deque(maxlen=window)
+               for name in ("in_l", "in_r", "out_l", "out_r", "dsp_load_pct", "idle_pct")}
+    rows = stream(link, 0)
+
+    figure, (levels, load) = plt.subplots(2, 1, sharex=True)
+    lines = {name: levels.plot([], [], label=name)[0] for name in ("in_l", "in_r", "out_l", "out_r")}
+    lines["dsp_load_pct"] = load.plot([], [], label="DSP load")[0]
+    lines["idle_pct"] = load.plot([], [], label="CPU idle")[0]
+    levels.set_ylim(-100, 0)
+    levels.set_ylabel("dBFS")
+    levels.legend(loc="lower left")
+    load.set_ylim(0, 100)
+    load.set_ylabel("% of block")
+    load.legend(loc="lower left")
+
+    def update(_):
+        # Take what has arrived since the last redraw
+        deadline = time.monotonic() + 0.05
+        while time.monotonic() < deadline:
+            row = next(rows)
+            for name in history:
+                history[name].append(float(row[name]))
+        for name, line in lines.items():
+            line.set_data(range(len(history[name])), list(history[name]))
+        levels.set_xlim(0, window)
+        return list(lines.values())
+
+    FuncAnimation(figure, update, interval=100, cache_frame_data=False)
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("port", help="serial device or pty, e.g. /dev/ttyUSB0")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--rate", type=int, default=20, help="samples per second")
+    parser.add_argument("--csv", help="output file (default: stdout)")
+    parser.add_argument("--seconds", type=float, default=0, help="stop after S seconds (0: Ctrl-C)")
+    parser.add_argument("--plot", action="store_true", help="plot live instead of writing CSV")
+    args = parser.parse_args()
+
+    link = Link(args.port, args.baud, 0.5)
+    try:
+        rate = struct.unpack("<H", link.request_ok(MSG_TELEMETRY_RATE, struct.pack("<H", args.rate))[:2])[0]
+        print("telemetry at %d Hz" % rate, file=sys.stderr)
+        args.rate = rate
+        if args.plot:
+            plot(link, args)
+        else:
+            write_csv(link, args)
+    except KeyboardInterrupt:
+        pass
+    except ProtocolError as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+    finally:
+        try:
+            link.request_ok(MSG_TELEMETRY_RATE, struct.pack("<H", 0))
+        except ProtocolError:
+            pass
+        link.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""
+Scripted front panel replay for the Audio Crossover firmware.
+
+Plays a script of timed encoder and button events into the input queue over
+the USART1 serial protocol, and after each one reads back the 16x2 screen and
+the response measured on the device (App/Inc/ui_probe.h): time from the event
+to the last byte on the display, and LCD bus bytes sent for it. Screens can be
+recorded and compared with an earlier recording, and a latency limit makes
+the run fail when the UI blocks for too long.
+
+Script, one event per line (times in ms from the start, '#' comments):
+    0      turn 1            encoder steps, clockwise positive
+    300    press encoder     button: menu, back, encoder, preset1-3
+    360    release encoder
+    1000   hold menu 1500    held, with the hold time in ms
+
+Usage:
+    ui_replay.py PORT SCRIPT [--record FILE] [--compare FILE] [--max-latency MS]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from serial_client import Link, ProtocolError, MSG_UI_INPUT, MSG_UI_SCREEN, STATUS_BUSY, STATUS_OK  # noqa: E402
+
+# App/Inc/input_queue.h, App/Inc/button_handler.h
+SOURCE_ENCODER = 0
+SOURCE_BUTTON = 1
+BUTTONS = {"menu": 0, "back": 1, "encoder": 2, "preset1": 3, "preset2": 4, "preset3": 5}
+BUTTON_STATES = {"release": 0, "press": 1, "hold": 2, "double": 3}
+
+INPUT = struct.Struct("<BBBi")
+SCREEN_SIZE = 32
+# UiProbeStats_t
+PROBE = struct.Struct("<8I")
+
+# Custom characters (0-7) and the HD44780 degree sign
+CUSTOM_GLYPHS = "⓪①②③④⑤⑥⑦"
+DEGREE = 0xDF
+
+# Time to wait for a last event that has not been accounted for (s)
+SETTLE_TIME = 0.6
+
+
+def parse_script(path):
+    """Return [(time ms, text, INPUT payload)]."""
+    events = []
+    with open(path) as script:
+        for number, line in enumerate(script, 1):
+            words = line.split("#")[0].split()
+            if not words:
+                continue
+            try:
+                at, action = int(words[0]), words[1]
+                if action == "turn":
+                    payload = INPUT.pack(SOURCE_ENCODER, 0, 0, int(words[2]))
+                elif action in BUTTON_STATES:
+                    hold = int(words[3]) if len(words) > 3 else 0
+                    payload = INPUT.pack(SOURCE_BUTTON, BUTTONS[words[2]], BUTTON_STATES[action], hold)
+                else:
+                    raise ValueError(action)
+            except (IndexError, KeyError, ValueError):
+                raise SystemExit("%s:%d: cannot read '%s'" % (path, number, line.strip()))
+            events.append((at, " ".join(words[1:]), payload))
+    return sorted(events, key=lambda event: event[0])
+
+
+def render(screen):
+    lines = []
+    for row in (screen[:16], screen[16:]):
+        text = ""
+        for code in row:
+            if code < len(CUSTOM_GLYPHS):
+                text += CUSTOM_GLYPHS[code]
+            elif code == DEGREE:
+                text += "°"
+            elif 0x20 <= code < 0x7F:
+                text += chr(code)
+            else:
+                text += "?"
+        lines.append(text)
+    return lines
+
+
+def read_screen(link):
+    data = link.request_ok(MSG_UI_SCREEN)
+    return render(data[:SCREEN_SIZE]), PROBE.unpack_from(data, SCREEN_SIZE)
+
+
+def wait_response(link, before, deadline):
+    """Poll until the device has accounted for the event or the deadline passes.
+
+    Returns the screen, the statistics and (latency ms, bus bytes), which is
+    None when the screen did not change (yet)."""
+    while True:
+        screen, probe = read_screen(link)
+        interactions, unchanged = probe[0], probe[1]
+        if interactions != before[0]:
+            return screen, probe, (probe[3], probe[6])
+        if unchanged != before[1] or time.monotonic() >= deadline:
+            return screen, probe, None
+        time.sleep(0.005)
+
+
+def replay(link, events):
+    """Play the events; return [(time, text, screen lines, response)]."""
+    steps = []
+    _, probe = read_screen(link)
+    start = time.monotonic()
+    for index, (at, text, payload) in enumerate(events):
+        delay = start + at / 1000.0 - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        status = link.request(MSG_UI_INPUT, payload)[0]
+        while status == STATUS_BUSY:
+            time.sleep(0.01)
+            status = link.request(MSG_UI_INPUT, payload)[0]
+        if status != STATUS_OK:
+            raise ProtocolError("event '%s' refused (status %d)" % (text, status))
+
+        if index + 1 < len(events):
+            deadline = start + events[index + 1][0] / 1000.0
+        else:
+            deadline = time.monotonic() + SETTLE_TIME
+        screen, probe, response = wait_response(link, probe, deadline)
+        result = "%4d ms %5d B" % response if response else "  no change   "
+        print("%6d  %-20s %s |%s|%s|" % (at, text, result, screen[0], screen[1]))
+        steps.append((at, text, screen, response))
+    return steps
+
+
+def write_recording(path, steps):
+    with open(path, "w", encoding="utf-8") as out:
+        for at, text, screen, _ in steps:
+            out.write("@ %d %s\n|%s|\n|%s|\n" % (at, text, screen[0], screen[1]))
+
+
+def read_recording(path):
+    steps = []
+    with open(path, encoding="utf-8") as recording:
+        lines = [line.rstrip("\n") for line in recording]
+    for i in range(0, len(lines) - 2, 3):
+        header = lines[i].split(" ", 2)
+        steps.append((int(header[1]), header[2], [lines[i + 1][1:-1], lines[i + 2][1:-1]]))
+    return steps
+
+
+def compare(steps, expected):
+    failures = 0
+    if len(steps) != len(expected):
+        print("recording has %d steps, script %d" % (len(expected), len(steps)), file=sys.stderr)
+        failures += 1
+    for (at, text, screen, _), (_, _, want) in zip(steps, expected):
+        if screen != want:
+            print("%d %s: |%s|%s| expected |%s|%s|" % (at, text, screen[0], screen[1], want[0], want[1]),
+                  file=sys.stderr)
+            failures += 1
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("port", help="serial device or pty, e.g. /dev/ttyUSB0")
+    parser.add_argument("script", help="event script")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--record", help="write the screens to FILE")
+    parser.add_argument("--compare", help="compare the screens with a recording")
+    parser.add_argument("--max-latency", type=int, help="fail if any response took longer (ms)")
+    args = parser.parse_args()
+
+    events = parse_script(args.script)
+    link = Link(args.port, args.baud, 0.5)
+    try:
+        steps = replay(link, events)
+    except ProtocolError as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+    finally:
+        link.close()
+
+    responses = [step[3] for step in steps if step[3]]
+    latencies = [latency for latency, _ in responses] or [0]
+    print("%d events, %d changed the screen; latency avg %.1f ms, worst %d ms; worst %d LCD bytes"
+          % (len(steps), len(responses), sum(latencies) / len(latencies), max(latencies),
+             max([size for _, size in responses] or [0])), file=sys.stderr)
+
+    status = 0
+    if args.record:
+        write_recording(args.record, steps)
+    if args.compare and compare(steps, read_recording(args.compare)):
+        status = 1
+    if args.max_latency is not None and max(latencies) > args.max_latency:
+        print("worst latency %d ms over the limit of %d ms" % (max(latencies), args.max_latency),
+              file=sys.stderr)
+        status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())